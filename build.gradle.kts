@@ -275,10 +275,10 @@ kotlin {
         dependencies {
             implementation(libs.kotlinx.coroutines.core)
             implementation(npm("@webgpu/types", "0.1.40"))
+            implementation(npm("draco3d", "1.5.7"))
 
             // Future Phase 3+ dependencies (see CLAUDE.md - Advanced Features):
             // Physics: Rapier physics engine integration (Phase 2-13, Physics section)
-            // Asset loading: DRACO mesh compression support
             // Font loading: OpenType.js for text rendering
             // XR: WebXR polyfill for broad browser support
         }
@@ -0,0 +1,88 @@
+plugins {
+    kotlin("multiplatform")
+    kotlin("plugin.serialization")
+}
+
+kotlin {
+    jvm {
+        compilerOptions {
+            jvmTarget.set(org.jetbrains.kotlin.gradle.dsl.JvmTarget.JVM_11)
+        }
+        testRuns["test"].executionTask.configure {
+            useJUnitPlatform()
+        }
+    }
+
+    sourceSets {
+        val commonMain by getting {
+            dependencies {
+                implementation(project(":"))
+                implementation(libs.kotlinx.coroutines.core)
+                implementation(libs.kotlinx.serialization.json)
+            }
+        }
+
+        val commonTest by getting {
+            dependencies {
+                implementation(libs.kotlin.test)
+                implementation(libs.kotlinx.coroutines.test)
+            }
+        }
+
+        val jvmMain by getting {
+            dependencies {
+                implementation(libs.lwjgl.core)
+                implementation(libs.lwjgl.glfw)
+                implementation(libs.lwjgl.vulkan)
+
+                val osName = System.getProperty("os.name").lowercase()
+                val lwjglNatives = when {
+                    osName.contains("win") -> "natives-windows"
+                    osName.contains("linux") -> "natives-linux"
+                    osName.contains("mac") || osName.contains("darwin") -> "natives-macos"
+                    else -> "natives-linux"
+                }
+
+                runtimeOnly("org.lwjgl:lwjgl::$lwjglNatives")
+                runtimeOnly("org.lwjgl:lwjgl-glfw::$lwjglNatives")
+            }
+        }
+    }
+}
+
+val benchmarkResults = layout.buildDirectory.file("benchmarks/results.json")
+val benchmarkBaseline = layout.projectDirectory.file("baselines/baseline.json")
+
+fun JavaExec.configureBenchmarkRun() {
+    group = "benchmark"
+    val jvmMain = kotlin.targets.getByName("jvm").compilations.getByName("main")
+    dependsOn(jvmMain.compileKotlinTaskName)
+
+    mainClass.set("io.materia.benchmarks.MainKt")
+    jvmArgs(
+        "-Dorg.lwjgl.system.stackSize=8192",
+        "-Xms4G",
+        "-Xmx4G",
+        "-XX:+UseG1GC"
+    )
+    classpath = files(
+        jvmMain.output.allOutputs,
+        configurations.named("jvmRuntimeClasspath")
+    )
+    // -Pbenchmarks=unique-meshes,instances runs a subset; -PbenchmarkScale=0.1 shrinks workloads
+    project.findProperty("benchmarks")?.let { args("--only", it.toString()) }
+    project.findProperty("benchmarkScale")?.let { args("--scale", it.toString()) }
+}
+
+tasks.register<JavaExec>("benchmark") {
+    description = "Run the renderer benchmarks and fail if a metric regressed against the stored baseline"
+    configureBenchmarkRun()
+    args("--output", benchmarkResults.get().asFile.absolutePath)
+    args("--baseline", benchmarkBaseline.asFile.absolutePath)
+}
+
+tasks.register<JavaExec>("benchmarkBaseline") {
+    description = "Run the renderer benchmarks and store the results as the new baseline"
+    configureBenchmarkRun()
+    args("--output", benchmarkBaseline.asFile.absolutePath)
+}
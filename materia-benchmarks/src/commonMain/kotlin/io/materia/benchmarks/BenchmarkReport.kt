@@ -0,0 +1,98 @@
+package io.materia.benchmarks
+
+import kotlinx.serialization.Serializable
+import kotlinx.serialization.json.Json
+import kotlin.math.ceil
+
+/**
+ * Summary of per-frame samples in milliseconds.
+ *
+ * @property median 50th percentile, the value regressions are judged on.
+ * @property p95 95th percentile, which catches hitches the median hides.
+ */
+@Serializable
+data class FrameTimeStats(
+    val mean: Double,
+    val median: Double,
+    val p95: Double,
+    val min: Double,
+    val max: Double
+) {
+    companion object {
+        val EMPTY = FrameTimeStats(0.0, 0.0, 0.0, 0.0, 0.0)
+
+        fun of(samples: DoubleArray): FrameTimeStats {
+            if (samples.isEmpty()) return EMPTY
+            val sorted = samples.sortedArray()
+            return FrameTimeStats(
+                mean = sorted.average(),
+                median = percentile(sorted, 0.5),
+                p95 = percentile(sorted, 0.95),
+                min = sorted.first(),
+                max = sorted.last()
+            )
+        }
+
+        // Nearest-rank percentile of an ascending array
+        private fun percentile(sorted: DoubleArray, fraction: Double): Double {
+            val rank = ceil(fraction * sorted.size).toInt().coerceIn(1, sorted.size)
+            return sorted[rank - 1]
+        }
+    }
+}
+
+/**
+ * Measurements of one benchmark workload.
+ *
+ * @property name Workload name, the key baselines are matched on.
+ * @property frames Number of measured frames, after warm-up.
+ * @property cpuFrameTimeMs Time the CPU spent updating and submitting each frame.
+ * @property gpuFrameTimeMs GPU time per frame from timestamp queries; null when the
+ *   device cannot write them.
+ * @property drawCalls Draw calls of the last measured frame.
+ * @property triangles Triangles of the last measured frame.
+ * @property allocatedBytesPerFrame Average bytes the render thread allocated per frame;
+ *   null on runtimes that cannot count them.
+ * @property loadTimeMs Time to build or load the workload before the first frame.
+ */
+@Serializable
+data class BenchmarkResult(
+    val name: String,
+    val frames: Int,
+    val cpuFrameTimeMs: FrameTimeStats,
+    val gpuFrameTimeMs: FrameTimeStats? = null,
+    val drawCalls: Int,
+    val triangles: Int,
+    val allocatedBytesPerFrame: Long? = null,
+    val loadTimeMs: Double
+)
+
+/**
+ * Results of a benchmark run, written as JSON and stored as a baseline.
+ *
+ * @property device GPU the run measured; comparing against a baseline from another
+ *   device is reported but not gated.
+ * @property scale Workload scale relative to the canonical sizes.
+ */
+@Serializable
+data class BenchmarkReport(
+    val device: String,
+    val backend: String,
+    val width: Int,
+    val height: Int,
+    val scale: Double,
+    val results: List<BenchmarkResult>
+) {
+    fun result(name: String): BenchmarkResult? = results.firstOrNull { it.name == name }
+
+    fun toJson(): String = json.encodeToString(serializer(), this)
+
+    companion object {
+        private val json = Json {
+            prettyPrint = true
+            ignoreUnknownKeys = true
+        }
+
+        fun fromJson(text: String): BenchmarkReport = json.decodeFromString(serializer(), text)
+    }
+}
@@ -0,0 +1,294 @@
+package io.materia.benchmarks
+
+import io.materia.animation.Skeleton
+import io.materia.animation.skeleton.Bone
+import io.materia.camera.PerspectiveCamera
+import io.materia.core.math.Color
+import io.materia.core.math.Matrix4
+import io.materia.core.math.Quaternion
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.Scene
+import io.materia.core.scene.SkinnedMesh
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.primitives.BoxGeometry
+import io.materia.loader.AssetResolver
+import io.materia.loader.GLTFLoader
+import io.materia.material.MeshBasicMaterial
+import io.materia.physics.DefaultBoxShape
+import io.materia.physics.DefaultPhysicsWorld
+import io.materia.physics.DefaultRigidBody
+import io.materia.physics.RigidBodyType
+import kotlin.math.PI
+import kotlin.math.cos
+import kotlin.math.max
+import kotlin.math.roundToInt
+import kotlin.math.sin
+import kotlin.math.sqrt
+import kotlin.random.Random
+
+/**
+ * A fixed scene driven the same way on every run.
+ *
+ * [load] builds the scene and is timed as the workload's load time; [update] advances it
+ * before each frame and may depend only on the frame index, so every run renders the same
+ * frames. Randomised layouts use [SEED].
+ */
+abstract class BenchmarkWorkload(val name: String) {
+    val scene = Scene()
+    val camera = PerspectiveCamera(fov = 60f, aspect = 16f / 9f, near = 0.1f, far = 5000f)
+
+    abstract suspend fun load()
+
+    open fun update(frame: Int) {
+        orbit(frame)
+    }
+
+    /** Radius and height of the camera orbit around [orbitTarget]. */
+    protected var orbitRadius = 10f
+    protected var orbitHeight = 5f
+    protected val orbitTarget = Vector3()
+
+    // One revolution every ORBIT_FRAMES frames, so culling sees the scene from every side
+    protected fun orbit(frame: Int) {
+        val angle = frame * 2.0 * PI / ORBIT_FRAMES
+        camera.position.set(
+            orbitTarget.x + orbitRadius * cos(angle).toFloat(),
+            orbitTarget.y + orbitHeight,
+            orbitTarget.z + orbitRadius * sin(angle).toFloat()
+        )
+        camera.lookAt(orbitTarget.x, orbitTarget.y, orbitTarget.z)
+    }
+
+    override fun toString(): String = name
+
+    companion object {
+        const val SEED = 0x6D617465
+        const val ORBIT_FRAMES = 600
+    }
+}
+
+/**
+ * The canonical workloads, each stressing one hot path. [scale] shrinks the object counts
+ * for quick local runs; baselines are only comparable at the same scale.
+ */
+object BenchmarkWorkloads {
+    const val UNIQUE_MESHES = 10_000
+    const val INSTANCES = 1_000_000
+    const val SKINNED_CHARACTERS = 200
+    const val PHYSICS_BODIES = 2_000
+    const val GLTF_MESHES = 64
+    const val GLTF_GRID = 128
+
+    val names: List<String> = listOf("unique-meshes", "instances", "skinned-characters", "physics-pile", "gltf-load")
+
+    fun canonical(scale: Double = 1.0): List<BenchmarkWorkload> {
+        require(scale > 0.0 && scale <= 1.0) { "scale must be within (0, 1] (was $scale)" }
+        fun scaled(count: Int) = max(1, (count * scale).roundToInt())
+        return listOf(
+            UniqueMeshesWorkload(scaled(UNIQUE_MESHES)),
+            InstancesWorkload(scaled(INSTANCES)),
+            SkinnedCharactersWorkload(scaled(SKINNED_CHARACTERS)),
+            PhysicsPileWorkload(scaled(PHYSICS_BODIES)),
+            GltfLoadWorkload(scaled(GLTF_MESHES), GLTF_GRID)
+        )
+    }
+}
+
+/** [count] meshes, each with its own geometry and material: one draw and one upload per object. */
+class UniqueMeshesWorkload(val count: Int) : BenchmarkWorkload("unique-meshes") {
+    override suspend fun load() {
+        val random = Random(SEED)
+        val side = sqrt(count.toDouble()).toInt() + 1
+        for (i in 0 until count) {
+            val size = 0.3f + random.nextFloat() * 0.4f
+            val material = MeshBasicMaterial().apply {
+                color = Color(random.nextFloat(), random.nextFloat(), random.nextFloat())
+            }
+            val mesh = Mesh(BoxGeometry(size, size, size), material)
+            mesh.position.set((i % side - side / 2).toFloat(), random.nextFloat(), (i / side - side / 2).toFloat())
+            scene.add(mesh)
+        }
+        orbitRadius = side * 0.6f
+        orbitHeight = side * 0.4f
+    }
+}
+
+/** [count] instances of one box in a single instanced draw. */
+class InstancesWorkload(val count: Int) : BenchmarkWorkload("instances") {
+    override suspend fun load() {
+        val random = Random(SEED)
+        val side = sqrt(count.toDouble()).toInt() + 1
+        val spacing = 1.5f
+        val matrices = FloatArray(count * 16)
+        val matrix = Matrix4()
+        val position = Vector3()
+        val rotation = Quaternion()
+        val scale = Vector3()
+        val axis = Vector3(0f, 1f, 0f)
+        for (i in 0 until count) {
+            position.set((i % side - side / 2) * spacing, random.nextFloat() * 2f, (i / side - side / 2) * spacing)
+            rotation.setFromAxisAngle(axis, random.nextFloat() * 2f * PI.toFloat())
+            val s = 0.5f + random.nextFloat() * 0.5f
+            scale.set(s, s, s)
+            matrix.compose(position, rotation, scale)
+            matrix.elements.copyInto(matrices, i * 16)
+        }
+        val geometry = BoxGeometry(1f, 1f, 1f).apply {
+            setInstancedAttribute("instanceMatrix", BufferAttribute(matrices, 16))
+            instanceCount = count
+        }
+        scene.add(Mesh(geometry, MeshBasicMaterial().apply { color = Color(0.8f, 0.6f, 0.3f) }))
+        orbitRadius = side * spacing * 0.6f
+        orbitHeight = side * spacing * 0.3f
+    }
+}
+
+/** [count] characters with [bonesPerCharacter]-bone skeletons posed every frame. */
+class SkinnedCharactersWorkload(
+    val count: Int,
+    val bonesPerCharacter: Int = 24
+) : BenchmarkWorkload("skinned-characters") {
+    private val rigs = ArrayList<List<Bone>>()
+    private val phases = ArrayList<Float>()
+    private val bendAxis = Vector3(0f, 0f, 1f)
+
+    override suspend fun load() {
+        val random = Random(SEED)
+        val height = 2f
+        val geometry = BoxGeometry(0.4f, height, 0.4f, 2, bonesPerCharacter * 2, 2)
+        val positions = requireNotNull(geometry.getAttribute("position"))
+        val skinIndex = FloatArray(positions.count * 4)
+        val skinWeight = FloatArray(positions.count * 4)
+        val segment = height / bonesPerCharacter
+        for (v in 0 until positions.count) {
+            // Blend each vertex between the two bones nearest to its height
+            val t = ((positions.getY(v) + height / 2) / segment - 0.5f).coerceIn(0f, bonesPerCharacter - 1f)
+            val lower = t.toInt().coerceAtMost(bonesPerCharacter - 1)
+            val upper = (lower + 1).coerceAtMost(bonesPerCharacter - 1)
+            val blend = t - lower
+            skinIndex[v * 4] = lower.toFloat()
+            skinIndex[v * 4 + 1] = upper.toFloat()
+            skinWeight[v * 4] = 1f - blend
+            skinWeight[v * 4 + 1] = blend
+        }
+        geometry.setAttribute("skinIndex", BufferAttribute(skinIndex, 4))
+        geometry.setAttribute("skinWeight", BufferAttribute(skinWeight, 4))
+
+        val material = MeshBasicMaterial().apply { color = Color(0.3f, 0.7f, 0.9f) }
+        val side = sqrt(count.toDouble()).toInt() + 1
+        for (i in 0 until count) {
+            val bones = List(bonesPerCharacter) { b ->
+                Bone(
+                    "bone-$b",
+                    position = Vector3(0f, if (b == 0) -height / 2 else segment, 0f),
+                    parentIndex = b - 1
+                )
+            }
+            for (b in 1 until bonesPerCharacter) bones[b - 1].add(bones[b])
+            bones[0].updateMatrixWorld(true)
+            bones.forEach { it.inverseBindMatrix.copy(it.matrixWorld).invert() }
+
+            val mesh = SkinnedMesh(geometry, material)
+            mesh.position.set((i % side - side / 2) * 1.5f, height / 2, (i / side - side / 2) * 1.5f)
+            mesh.bind(Skeleton(bones))
+            scene.add(mesh)
+            rigs += bones
+            phases += random.nextFloat() * 2f * PI.toFloat()
+        }
+        orbitRadius = side * 1.2f
+        orbitHeight = side * 0.5f
+    }
+
+    override fun update(frame: Int) {
+        super.update(frame)
+        val time = frame / 60f
+        for (i in rigs.indices) {
+            val bones = rigs[i]
+            val angle = sin(time * 3f + phases[i]) * 0.15f
+            for (b in 1 until bones.size) bones[b].rotation.setFromAxisAngle(bendAxis, angle)
+            bones[0].updateMatrixWorld(true)
+        }
+    }
+}
+
+/** [count] boxes dropped onto a static floor and stepped at 60 Hz. */
+class PhysicsPileWorkload(val count: Int) : BenchmarkWorkload("physics-pile") {
+    private val world = DefaultPhysicsWorld()
+    private val bodies = ArrayList<DefaultRigidBody>()
+    private val meshes = ArrayList<Mesh>()
+    private val scratchScale = Vector3()
+
+    override suspend fun load() {
+        val random = Random(SEED)
+        val columns = max(1, sqrt(count / 10.0).toInt())
+        val floorSize = columns * 1.5f + 4f
+        val floor = DefaultRigidBody("floor", DefaultBoxShape(Vector3(floorSize, 0.5f, floorSize)), 0f).apply {
+            bodyType = RigidBodyType.STATIC
+            setTransform(Vector3(0f, -0.5f, 0f), Quaternion())
+        }
+        world.addRigidBody(floor)
+        scene.add(Mesh(BoxGeometry(floorSize * 2, 1f, floorSize * 2), MeshBasicMaterial()).apply {
+            position.set(0f, -0.5f, 0f)
+        })
+
+        val material = MeshBasicMaterial().apply { color = Color(0.9f, 0.4f, 0.3f) }
+        val geometry = BoxGeometry(1f, 1f, 1f)
+        for (i in 0 until count) {
+            val column = i % (columns * columns)
+            val layer = i / (columns * columns)
+            val position = Vector3(
+                (column % columns - columns / 2) * 1.5f + random.nextFloat() * 0.2f,
+                1f + layer * 1.2f,
+                (column / columns - columns / 2) * 1.5f + random.nextFloat() * 0.2f
+            )
+            val body = DefaultRigidBody("box-$i", DefaultBoxShape(Vector3(0.5f, 0.5f, 0.5f)), 1f).apply {
+                setTransform(position, Quaternion())
+            }
+            world.addRigidBody(body)
+            bodies += body
+            meshes += Mesh(geometry, material).also { scene.add(it) }
+        }
+        syncMeshes()
+        orbitRadius = floorSize * 1.5f
+        orbitHeight = floorSize
+    }
+
+    override fun update(frame: Int) {
+        super.update(frame)
+        world.step(1f / 60f)
+        syncMeshes()
+    }
+
+    private fun syncMeshes() {
+        for (i in bodies.indices) {
+            val mesh = meshes[i]
+            bodies[i].getWorldTransform().decompose(mesh.position, mesh.quaternion, scratchScale)
+        }
+    }
+}
+
+/**
+ * Loads a GLB of [meshCount] `gridSize` x `gridSize` grids from memory, so load time
+ * measures parsing and decoding rather than the disk. Meshes are drawn unlit; the
+ * benchmark has no environment map for the loader's PBR materials.
+ */
+class GltfLoadWorkload(val meshCount: Int, val gridSize: Int) : BenchmarkWorkload("gltf-load") {
+    private val bytes by lazy { SyntheticGlb.build(meshCount, gridSize) }
+
+    /** Builds the GLB up front so [load] doesn't time its generation. */
+    fun prepare(): Int = bytes.size
+
+    override suspend fun load() {
+        val resolver = object : AssetResolver {
+            override suspend fun load(uri: String, basePath: String?): ByteArray = bytes
+        }
+        val asset = GLTFLoader(resolver = resolver).load("benchmark.glb")
+        val material = MeshBasicMaterial().apply { color = Color(0.6f, 0.8f, 0.4f) }
+        asset.scene.traverse { node -> (node as? Mesh)?.material = material }
+        scene.add(asset.scene)
+        orbitTarget.set(meshCount * 0.75f, 0.5f, 0f)
+        orbitRadius = meshCount * 0.9f
+        orbitHeight = meshCount * 0.3f
+    }
+}
@@ -0,0 +1,115 @@
+package io.materia.benchmarks
+
+/**
+ * How far a metric may move past its baseline before it counts as a regression.
+ *
+ * Timings must exceed the baseline both by [timeTolerance] (relative) and by
+ * [minimumTimeDeltaMs], so sub-millisecond workloads don't fail on scheduler noise.
+ * Draw calls are deterministic and may not grow at all.
+ */
+data class RegressionThresholds(
+    val timeTolerance: Double = 0.10,
+    val minimumTimeDeltaMs: Double = 0.25,
+    val loadTimeTolerance: Double = 0.20,
+    val allocationTolerance: Double = 0.25,
+    val minimumAllocationDelta: Long = 4096L
+) {
+    init {
+        require(timeTolerance >= 0.0) { "timeTolerance must be >= 0 (was $timeTolerance)" }
+        require(loadTimeTolerance >= 0.0) { "loadTimeTolerance must be >= 0 (was $loadTimeTolerance)" }
+        require(allocationTolerance >= 0.0) { "allocationTolerance must be >= 0 (was $allocationTolerance)" }
+    }
+}
+
+/** A metric of [benchmark] that got worse than its baseline allows. */
+data class BenchmarkRegression(
+    val benchmark: String,
+    val metric: String,
+    val baseline: Double,
+    val current: Double
+) {
+    override fun toString(): String = if (current.isNaN()) {
+        "$benchmark: $metric missing from this run"
+    } else {
+        "$benchmark: $metric ${format(baseline)} -> ${format(current)}"
+    }
+
+    private fun format(value: Double): String {
+        val rounded = kotlin.math.round(value * 1000) / 1000
+        return rounded.toString()
+    }
+}
+
+/** Outcome of comparing a run against a baseline. */
+data class RegressionCheck(
+    val regressions: List<BenchmarkRegression>,
+    val comparable: Boolean
+) {
+    /** Whether the run should fail: regressions against a baseline from the same setup. */
+    val failed: Boolean get() = comparable && regressions.isNotEmpty()
+}
+
+/**
+ * Compares benchmark runs against a stored baseline.
+ */
+class RegressionGate(private val thresholds: RegressionThresholds = RegressionThresholds()) {
+
+    /**
+     * Returns every metric of [current] that regressed against [baseline]. Baselines from
+     * another device, resolution or scale are compared but marked not [RegressionCheck.comparable].
+     * Benchmarks new in [current] pass; benchmarks dropped from it are regressions.
+     */
+    fun check(baseline: BenchmarkReport, current: BenchmarkReport): RegressionCheck {
+        val comparable = baseline.device == current.device &&
+            baseline.width == current.width &&
+            baseline.height == current.height &&
+            baseline.scale == current.scale
+
+        val regressions = ArrayList<BenchmarkRegression>()
+        for (reference in baseline.results) {
+            val result = current.result(reference.name)
+            if (result == null) {
+                regressions += BenchmarkRegression(reference.name, "result", 0.0, Double.NaN)
+                continue
+            }
+            compare(reference, result, regressions)
+        }
+        return RegressionCheck(regressions, comparable)
+    }
+
+    private fun compare(baseline: BenchmarkResult, current: BenchmarkResult, out: MutableList<BenchmarkRegression>) {
+        val name = current.name
+        fun time(metric: String, before: Double, after: Double) {
+            if (after > before * (1 + thresholds.timeTolerance) && after - before > thresholds.minimumTimeDeltaMs) {
+                out += BenchmarkRegression(name, metric, before, after)
+            }
+        }
+
+        time("cpu median ms", baseline.cpuFrameTimeMs.median, current.cpuFrameTimeMs.median)
+        time("cpu p95 ms", baseline.cpuFrameTimeMs.p95, current.cpuFrameTimeMs.p95)
+        val gpuBefore = baseline.gpuFrameTimeMs
+        val gpuAfter = current.gpuFrameTimeMs
+        if (gpuBefore != null && gpuAfter != null) {
+            time("gpu median ms", gpuBefore.median, gpuAfter.median)
+        }
+
+        if (current.drawCalls > baseline.drawCalls) {
+            out += BenchmarkRegression(name, "draw calls", baseline.drawCalls.toDouble(), current.drawCalls.toDouble())
+        }
+
+        val allocBefore = baseline.allocatedBytesPerFrame
+        val allocAfter = current.allocatedBytesPerFrame
+        if (allocBefore != null && allocAfter != null &&
+            allocAfter > allocBefore * (1 + thresholds.allocationTolerance) &&
+            allocAfter - allocBefore > thresholds.minimumAllocationDelta
+        ) {
+            out += BenchmarkRegression(name, "allocated bytes/frame", allocBefore.toDouble(), allocAfter.toDouble())
+        }
+
+        if (current.loadTimeMs > baseline.loadTimeMs * (1 + thresholds.loadTimeTolerance) &&
+            current.loadTimeMs - baseline.loadTimeMs > thresholds.minimumTimeDeltaMs
+        ) {
+            out += BenchmarkRegression(name, "load ms", baseline.loadTimeMs, current.loadTimeMs)
+        }
+    }
+}
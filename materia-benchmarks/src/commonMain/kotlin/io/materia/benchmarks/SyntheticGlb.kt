@@ -0,0 +1,116 @@
+package io.materia.benchmarks
+
+/**
+ * Builds binary glTF files of tessellated grids, so the load benchmark needs no checked-in
+ * asset and reads the same bytes on every machine.
+ *
+ * Each mesh is a `gridSize` x `gridSize` quad grid with positions, normals and 32-bit
+ * indices, offset along X so the meshes don't overlap.
+ */
+object SyntheticGlb {
+    private const val GLB_MAGIC = 0x46546C67
+    private const val CHUNK_JSON = 0x4E4F534A
+    private const val CHUNK_BIN = 0x004E4942
+    private const val FLOAT = 5126
+    private const val UNSIGNED_INT = 5125
+    private const val ARRAY_BUFFER = 34962
+    private const val ELEMENT_ARRAY_BUFFER = 34963
+
+    fun triangleCount(meshCount: Int, gridSize: Int): Long = meshCount.toLong() * gridSize * gridSize * 2
+
+    fun build(meshCount: Int, gridSize: Int): ByteArray {
+        require(meshCount > 0) { "meshCount must be > 0 (was $meshCount)" }
+        require(gridSize > 0) { "gridSize must be > 0 (was $gridSize)" }
+
+        val side = gridSize + 1
+        val vertexCount = side * side
+        val indexCount = gridSize * gridSize * 6
+        val attributeBytes = vertexCount * 3 * Float.SIZE_BYTES
+        val indexBytes = indexCount * Int.SIZE_BYTES
+        val meshBytes = attributeBytes * 2 + indexBytes
+        val bin = ByteArray(meshBytes * meshCount)
+
+        val bufferViews = StringBuilder()
+        val accessors = StringBuilder()
+        val meshes = StringBuilder()
+        val nodes = StringBuilder()
+        for (mesh in 0 until meshCount) {
+            val base = mesh * meshBytes
+            var offset = base
+            for (y in 0 until side) {
+                for (x in 0 until side) {
+                    offset = writeFloat(bin, offset, mesh * 1.5f + x.toFloat() / gridSize)
+                    offset = writeFloat(bin, offset, y.toFloat() / gridSize)
+                    offset = writeFloat(bin, offset, 0f)
+                }
+            }
+            repeat(vertexCount) {
+                offset = writeFloat(bin, offset, 0f)
+                offset = writeFloat(bin, offset, 0f)
+                offset = writeFloat(bin, offset, 1f)
+            }
+            for (y in 0 until gridSize) {
+                for (x in 0 until gridSize) {
+                    val a = y * side + x
+                    val b = a + 1
+                    val c = a + side
+                    val d = c + 1
+                    for (index in intArrayOf(a, c, b, b, c, d)) offset = writeInt(bin, offset, index)
+                }
+            }
+
+            val view = mesh * 3
+            if (mesh > 0) {
+                bufferViews.append(',')
+                accessors.append(',')
+                meshes.append(',')
+                nodes.append(',')
+            }
+            bufferViews.append(
+                """{"buffer":0,"byteOffset":$base,"byteLength":$attributeBytes,"target":$ARRAY_BUFFER},""" +
+                    """{"buffer":0,"byteOffset":${base + attributeBytes},"byteLength":$attributeBytes,"target":$ARRAY_BUFFER},""" +
+                    """{"buffer":0,"byteOffset":${base + attributeBytes * 2},"byteLength":$indexBytes,"target":$ELEMENT_ARRAY_BUFFER}"""
+            )
+            accessors.append(
+                """{"bufferView":$view,"componentType":$FLOAT,"count":$vertexCount,"type":"VEC3",""" +
+                    """"min":[${mesh * 1.5f},0,0],"max":[${mesh * 1.5f + 1f},1,0]},""" +
+                    """{"bufferView":${view + 1},"componentType":$FLOAT,"count":$vertexCount,"type":"VEC3"},""" +
+                    """{"bufferView":${view + 2},"componentType":$UNSIGNED_INT,"count":$indexCount,"type":"SCALAR"}"""
+            )
+            meshes.append("""{"primitives":[{"attributes":{"POSITION":$view,"NORMAL":${view + 1}},"indices":${view + 2}}]}""")
+            nodes.append("""{"mesh":$mesh}""")
+        }
+
+        val json = """{"asset":{"version":"2.0"},"buffers":[{"byteLength":${bin.size}}],""" +
+            """"bufferViews":[$bufferViews],"accessors":[$accessors],"meshes":[$meshes],"nodes":[$nodes],""" +
+            """"scenes":[{"nodes":[${(0 until meshCount).joinToString(",")}]}],"scene":0}"""
+        return container(json.encodeToByteArray(), bin)
+    }
+
+    private fun container(json: ByteArray, bin: ByteArray): ByteArray {
+        val jsonLength = (json.size + 3) / 4 * 4
+        val out = ByteArray(12 + 8 + jsonLength + 8 + bin.size)
+        writeInt(out, 0, GLB_MAGIC)
+        writeInt(out, 4, 2)
+        writeInt(out, 8, out.size)
+        writeInt(out, 12, jsonLength)
+        writeInt(out, 16, CHUNK_JSON)
+        json.copyInto(out, 20)
+        for (i in 20 + json.size until 20 + jsonLength) out[i] = ' '.code.toByte()
+        val binStart = 20 + jsonLength
+        writeInt(out, binStart, bin.size)
+        writeInt(out, binStart + 4, CHUNK_BIN)
+        bin.copyInto(out, binStart + 8)
+        return out
+    }
+
+    private fun writeFloat(out: ByteArray, offset: Int, value: Float): Int = writeInt(out, offset, value.toRawBits())
+
+    private fun writeInt(out: ByteArray, offset: Int, value: Int): Int {
+        out[offset] = value.toByte()
+        out[offset + 1] = (value shr 8).toByte()
+        out[offset + 2] = (value shr 16).toByte()
+        out[offset + 3] = (value shr 24).toByte()
+        return offset + 4
+    }
+}
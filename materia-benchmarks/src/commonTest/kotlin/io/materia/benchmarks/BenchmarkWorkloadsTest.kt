@@ -0,0 +1,100 @@
+package io.materia.benchmarks
+
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.SkinnedMesh
+import io.materia.material.MeshBasicMaterial
+import kotlinx.coroutines.test.runTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNotEquals
+import kotlin.test.assertTrue
+
+/**
+ * Workloads build the scenes they advertise, deterministically, without a renderer
+ */
+class BenchmarkWorkloadsTest {
+
+    private fun BenchmarkWorkload.meshes(): List<Mesh> {
+        val meshes = ArrayList<Mesh>()
+        scene.traverse { (it as? Mesh)?.let(meshes::add) }
+        return meshes
+    }
+
+    @Test
+    fun testCanonicalNamesAreStableAcrossScales() {
+        assertEquals(BenchmarkWorkloads.names, BenchmarkWorkloads.canonical().map { it.name })
+        assertEquals(BenchmarkWorkloads.names, BenchmarkWorkloads.canonical(0.001).map { it.name })
+        assertFailsWith<IllegalArgumentException> { BenchmarkWorkloads.canonical(0.0) }
+        assertFailsWith<IllegalArgumentException> { BenchmarkWorkloads.canonical(2.0) }
+    }
+
+    @Test
+    fun testEveryCanonicalWorkloadLoadsAndSteps() = runTest {
+        // The benchmark's CPU side end to end, at a size a unit test can afford
+        for (workload in BenchmarkWorkloads.canonical(0.01)) {
+            workload.load()
+            repeat(120) { workload.update(it) }
+
+            assertTrue(workload.meshes().isNotEmpty(), "${workload.name} has nothing to draw")
+        }
+    }
+
+    @Test
+    fun testUniqueMeshesAreIndependentAndDeterministic() = runTest {
+        val first = UniqueMeshesWorkload(50).apply { load() }
+        val second = UniqueMeshesWorkload(50).apply { load() }
+
+        val meshes = first.meshes()
+        assertEquals(50, meshes.size)
+        assertEquals(50, meshes.map { it.geometry }.toSet().size)
+        assertEquals(meshes.map { it.position.y }, second.meshes().map { it.position.y })
+    }
+
+    @Test
+    fun testInstancesShareOneDraw() = runTest {
+        val workload = InstancesWorkload(1_000).apply { load() }
+
+        val mesh = workload.meshes().single()
+        assertEquals(1_000, mesh.geometry.instanceCount)
+    }
+
+    @Test
+    fun testSkinnedCharactersPoseEveryFrame() = runTest {
+        val workload = SkinnedCharactersWorkload(count = 3, bonesPerCharacter = 8).apply { load() }
+        val characters = workload.meshes().filterIsInstance<SkinnedMesh>()
+        assertEquals(3, characters.size)
+
+        val tip = characters.first().skeleton!!.bones.last()
+        workload.update(0)
+        val before = tip.getWorldPosition(Vector3()).x
+        workload.update(20)
+        assertNotEquals(before, tip.getWorldPosition(Vector3()).x)
+    }
+
+    @Test
+    fun testPhysicsPileFallsOntoFloor() = runTest {
+        val workload = PhysicsPileWorkload(20).apply { load() }
+        // Floor plus one mesh per body
+        val boxes = workload.meshes().drop(1)
+        assertEquals(20, boxes.size)
+
+        val start = boxes.map { it.position.y }
+        repeat(30) { workload.update(it) }
+        assertTrue(boxes.indices.any { boxes[it].position.y < start[it] }, "Bodies should fall under gravity")
+    }
+
+    @Test
+    fun testGltfLoadDecodesSyntheticGlb() = runTest {
+        val workload = GltfLoadWorkload(meshCount = 3, gridSize = 4)
+        assertTrue(workload.prepare() > 0)
+        workload.load()
+
+        val meshes = workload.meshes()
+        assertEquals(3, meshes.size)
+        assertTrue(meshes.all { it.material is MeshBasicMaterial })
+        val triangles = meshes.sumOf { (it.geometry.index?.count ?: 0) / 3 }
+        assertEquals(SyntheticGlb.triangleCount(3, 4), triangles.toLong())
+    }
+}
@@ -0,0 +1,131 @@
+package io.materia.benchmarks
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+/**
+ * Regression gate: thresholds, missing benchmarks, comparability and report round-trips
+ */
+class RegressionGateTest {
+
+    private fun result(
+        name: String = "unique-meshes",
+        cpuMedian: Double = 10.0,
+        cpuP95: Double = 12.0,
+        gpuMedian: Double? = 5.0,
+        drawCalls: Int = 100,
+        allocated: Long? = 100_000,
+        loadTime: Double = 50.0
+    ) = BenchmarkResult(
+        name = name,
+        frames = 300,
+        cpuFrameTimeMs = FrameTimeStats(cpuMedian, cpuMedian, cpuP95, cpuMedian, cpuP95),
+        gpuFrameTimeMs = gpuMedian?.let { FrameTimeStats(it, it, it, it, it) },
+        drawCalls = drawCalls,
+        triangles = 1_000,
+        allocatedBytesPerFrame = allocated,
+        loadTimeMs = loadTime
+    )
+
+    private fun report(vararg results: BenchmarkResult, device: String = "Test GPU") =
+        BenchmarkReport(device, "VULKAN", 1280, 720, 1.0, results.toList())
+
+    @Test
+    fun testIdenticalRunPasses() {
+        val check = RegressionGate().check(report(result()), report(result()))
+
+        assertTrue(check.comparable)
+        assertTrue(check.regressions.isEmpty())
+        assertFalse(check.failed)
+    }
+
+    @Test
+    fun testChangesWithinToleranceAndNoisePass() {
+        // +9% CPU, +8% GPU, fewer draws, +3% allocations; "tiny" is +20% but only 0.2 ms
+        val current = result(cpuMedian = 10.9, gpuMedian = 5.4, drawCalls = 90, allocated = 103_000, loadTime = 59.0)
+        val small = result(name = "tiny", cpuMedian = 1.2, cpuP95 = 1.2)
+        val check = RegressionGate().check(
+            report(result(), result(name = "tiny", cpuMedian = 1.0, cpuP95 = 1.0)),
+            report(current, small)
+        )
+
+        assertEquals(emptyList(), check.regressions)
+    }
+
+    @Test
+    fun testEachMetricRegresses() {
+        val current = result(
+            cpuMedian = 11.5,
+            cpuP95 = 14.0,
+            gpuMedian = 6.0,
+            drawCalls = 101,
+            allocated = 200_000,
+            loadTime = 70.0
+        )
+        val check = RegressionGate().check(report(result()), report(current))
+
+        assertEquals(
+            listOf("cpu median ms", "cpu p95 ms", "gpu median ms", "draw calls", "allocated bytes/frame", "load ms"),
+            check.regressions.map { it.metric }
+        )
+        assertTrue(check.failed)
+        assertEquals("unique-meshes: draw calls 100.0 -> 101.0", check.regressions[3].toString())
+    }
+
+    @Test
+    fun testUnmeasuredMetricsAreSkipped() {
+        val check = RegressionGate().check(
+            report(result(gpuMedian = 1.0, allocated = 1)),
+            report(result(gpuMedian = null, allocated = null))
+        )
+
+        assertTrue(check.regressions.isEmpty())
+    }
+
+    @Test
+    fun testMissingBenchmarkRegressesAndNewOnePasses() {
+        val check = RegressionGate().check(
+            report(result(), result(name = "instances")),
+            report(result(), result(name = "physics-pile", cpuMedian = 999.0))
+        )
+
+        assertEquals(1, check.regressions.size)
+        assertEquals("instances: result missing from this run", check.regressions.single().toString())
+    }
+
+    @Test
+    fun testOtherDeviceIsReportedButNotEnforced() {
+        val check = RegressionGate().check(
+            report(result(), device = "Fast GPU"),
+            report(result(cpuMedian = 20.0), device = "Slow GPU")
+        )
+
+        assertFalse(check.comparable)
+        assertEquals(1, check.regressions.size)
+        assertFalse(check.failed)
+    }
+
+    @Test
+    fun testReportJsonRoundTrip() {
+        val original = report(result(), result(name = "gltf-load", gpuMedian = null, allocated = null))
+        val restored = BenchmarkReport.fromJson(original.toJson())
+
+        assertEquals(original, restored)
+        assertNull(restored.result("gltf-load")?.gpuFrameTimeMs)
+    }
+
+    @Test
+    fun testFrameTimeStatsUseNearestRank() {
+        val stats = FrameTimeStats.of(DoubleArray(20) { (20 - it).toDouble() })
+
+        assertEquals(1.0, stats.min)
+        assertEquals(20.0, stats.max)
+        assertEquals(10.5, stats.mean)
+        assertEquals(10.0, stats.median)
+        assertEquals(19.0, stats.p95)
+        assertEquals(FrameTimeStats.EMPTY, FrameTimeStats.of(DoubleArray(0)))
+    }
+}
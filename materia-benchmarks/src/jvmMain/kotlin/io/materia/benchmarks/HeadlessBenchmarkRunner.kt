@@ -0,0 +1,141 @@
+package io.materia.benchmarks
+
+import io.materia.renderer.Renderer
+import io.materia.renderer.RendererConfig
+import io.materia.renderer.RendererFactory
+import io.materia.renderer.SurfaceFactory
+import io.materia.renderer.vulkan.VulkanRenderer
+import org.lwjgl.glfw.GLFW.*
+import org.lwjgl.glfw.GLFWErrorCallback
+import org.lwjgl.system.MemoryUtil
+import java.lang.management.ManagementFactory
+
+/**
+ * Renders [BenchmarkWorkload]s through the Vulkan renderer into a hidden window and
+ * collects a [BenchmarkReport].
+ *
+ * Vsync is off so CPU timings aren't capped by presentation. CI machines without a display
+ * need a virtual one (e.g. `xvfb-run`) for GLFW to create the window.
+ */
+class HeadlessBenchmarkRunner(
+    private val width: Int = 1280,
+    private val height: Int = 720,
+    private val warmupFrames: Int = 60,
+    private val measuredFrames: Int = 300,
+    private val capturePath: String? = null
+) {
+    init {
+        require(width > 0 && height > 0) { "Resolution must be positive (was ${width}x$height)" }
+        require(warmupFrames >= 0) { "warmupFrames must be >= 0 (was $warmupFrames)" }
+        require(measuredFrames > 0) { "measuredFrames must be > 0 (was $measuredFrames)" }
+    }
+
+    // HotSpot's bean counts allocations per thread; other runtimes report no allocations
+    private val threads = ManagementFactory.getThreadMXBean() as? com.sun.management.ThreadMXBean
+
+    suspend fun run(workloads: List<BenchmarkWorkload>, scale: Double): BenchmarkReport {
+        val errorCallback = GLFWErrorCallback.createPrint(System.err).set()
+        check(glfwInit()) {
+            errorCallback.free()
+            "Failed to initialise GLFW"
+        }
+        glfwDefaultWindowHints()
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE)
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE)
+        val window = glfwCreateWindow(width, height, "Materia Benchmarks", MemoryUtil.NULL, MemoryUtil.NULL)
+        if (window == MemoryUtil.NULL) {
+            glfwTerminate()
+            errorCallback.free()
+            error("Failed to create GLFW window")
+        }
+
+        var renderer: Renderer? = null
+        try {
+            val config = RendererConfig(
+                enableValidation = false,
+                vsync = false,
+                persistPipelineCache = false
+            )
+            val active = RendererFactory.create(SurfaceFactory.create(window), config).getOrThrow()
+            renderer = active
+
+            val results = workloads.map { workload ->
+                println("[Benchmarks] ${workload.name}")
+                measure(active, workload).also { println("[Benchmarks]   ${summary(it)}") }
+            }
+            return BenchmarkReport(
+                device = active.capabilities.deviceName,
+                backend = active.backend.name,
+                width = width,
+                height = height,
+                scale = scale,
+                results = results
+            )
+        } finally {
+            renderer?.dispose()
+            glfwDestroyWindow(window)
+            glfwTerminate()
+            errorCallback.free()
+        }
+    }
+
+    private suspend fun measure(renderer: Renderer, workload: BenchmarkWorkload): BenchmarkResult {
+        if (workload is GltfLoadWorkload) workload.prepare()
+
+        val loadStart = System.nanoTime()
+        workload.load()
+        val loadTimeMs = (System.nanoTime() - loadStart) / 1_000_000.0
+        workload.camera.aspect = width.toFloat() / height
+        workload.camera.updateProjectionMatrix()
+
+        var frame = 0
+        repeat(warmupFrames) {
+            glfwPollEvents()
+            workload.update(frame++)
+            renderer.render(workload.scene, workload.camera)
+        }
+
+        val cpu = DoubleArray(measuredFrames)
+        val gpu = DoubleArray(measuredFrames)
+        val thread = Thread.currentThread().id
+        val counter = threads?.takeIf { it.isThreadAllocatedMemorySupported && it.isThreadAllocatedMemoryEnabled }
+        val allocatedBefore = counter?.getThreadAllocatedBytes(thread) ?: 0L
+        for (i in 0 until measuredFrames) {
+            glfwPollEvents()
+            val start = System.nanoTime()
+            workload.update(frame++)
+            renderer.render(workload.scene, workload.camera)
+            cpu[i] = (System.nanoTime() - start) / 1_000_000.0
+            // Timestamps resolve once the frame's fence signals, so this trails by the frames in flight
+            gpu[i] = renderer.stats.gpuFrameTime
+        }
+        val allocated = counter?.let { (it.getThreadAllocatedBytes(thread) - allocatedBefore) / measuredFrames }
+
+        if (capturePath != null && renderer is VulkanRenderer) {
+            renderer.requestFrameCapture("$capturePath/${workload.name}.png")
+            renderer.render(workload.scene, workload.camera)
+        }
+
+        val stats = renderer.stats
+        return BenchmarkResult(
+            name = workload.name,
+            frames = measuredFrames,
+            cpuFrameTimeMs = FrameTimeStats.of(cpu),
+            gpuFrameTimeMs = gpu.filter { it > 0.0 }.takeIf { it.isNotEmpty() }?.let {
+                FrameTimeStats.of(it.toDoubleArray())
+            },
+            drawCalls = stats.drawCalls,
+            triangles = stats.triangles,
+            allocatedBytesPerFrame = allocated,
+            loadTimeMs = loadTimeMs
+        )
+    }
+
+    private fun summary(result: BenchmarkResult): String {
+        val cpu = result.cpuFrameTimeMs
+        val gpu = result.gpuFrameTimeMs?.let { "gpu median %.3f ms, ".format(it.median) } ?: ""
+        return "cpu median %.3f ms, p95 %.3f ms, ".format(cpu.median, cpu.p95) + gpu +
+            "${result.drawCalls} draws, ${result.triangles} triangles, load %.1f ms".format(result.loadTimeMs)
+    }
+}
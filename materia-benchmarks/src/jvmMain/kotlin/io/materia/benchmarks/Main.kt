@@ -0,0 +1,78 @@
+package io.materia.benchmarks
+
+import kotlinx.coroutines.runBlocking
+import java.io.File
+import kotlin.system.exitProcess
+
+/**
+ * Runs the benchmark suite.
+ *
+ * ```
+ * --output <file>      write the report as JSON
+ * --baseline <file>    compare against a stored report; exits with 1 on regressions
+ * --only <a,b>         run only the named workloads
+ * --scale <0..1]       shrink workload sizes (default 1.0)
+ * --frames <n>         measured frames per workload (default 300)
+ * --warmup <n>         frames rendered before measuring (default 60)
+ * --capture <dir>      save the last frame of each workload as PNG
+ * ```
+ */
+fun main(args: Array<String>) {
+    val options = parseOptions(args)
+    val scale = options["scale"]?.toDouble() ?: 1.0
+    val only = options["only"]?.split(',')?.map { it.trim() }?.filter { it.isNotEmpty() }?.toSet()
+    only?.let { names ->
+        val unknown = names - BenchmarkWorkloads.names.toSet()
+        require(unknown.isEmpty()) { "Unknown benchmarks $unknown; available: ${BenchmarkWorkloads.names}" }
+    }
+
+    val workloads = BenchmarkWorkloads.canonical(scale).filter { only == null || it.name in only }
+    val runner = HeadlessBenchmarkRunner(
+        measuredFrames = options["frames"]?.toInt() ?: 300,
+        warmupFrames = options["warmup"]?.toInt() ?: 60,
+        capturePath = options["capture"]?.also { File(it).mkdirs() }
+    )
+    val report = runBlocking { runner.run(workloads, scale) }
+
+    options["output"]?.let { path ->
+        val file = File(path)
+        file.absoluteFile.parentFile?.mkdirs()
+        file.writeText(report.toJson())
+        println("[Benchmarks] Wrote ${file.path}")
+    }
+
+    val baselineFile = options["baseline"]?.let(::File) ?: return
+    if (!baselineFile.exists()) {
+        println("[Benchmarks] No baseline at ${baselineFile.path}; run benchmarkBaseline to record one")
+        return
+    }
+
+    val baseline = BenchmarkReport.fromJson(baselineFile.readText())
+    // A subset run is only judged on the workloads it ran
+    val reference = if (only == null) baseline else baseline.copy(results = baseline.results.filter { it.name in only })
+    val check = RegressionGate().check(reference, report)
+    if (!check.comparable) {
+        println(
+            "[Benchmarks] Baseline was recorded on ${baseline.device} at ${baseline.width}x${baseline.height}, " +
+                "scale ${baseline.scale}; regressions are reported but not enforced"
+        )
+    }
+    if (check.regressions.isEmpty()) {
+        println("[Benchmarks] No regressions against ${baselineFile.path}")
+        return
+    }
+    check.regressions.forEach { println("[Benchmarks] REGRESSION $it") }
+    if (check.failed) exitProcess(1)
+}
+
+private fun parseOptions(args: Array<String>): Map<String, String> {
+    val options = HashMap<String, String>()
+    var i = 0
+    while (i < args.size) {
+        val arg = args[i]
+        require(arg.startsWith("--") && i + 1 < args.size) { "Expected --option value, got '$arg'" }
+        options[arg.removePrefix("--")] = args[i + 1]
+        i += 2
+    }
+    return options
+}
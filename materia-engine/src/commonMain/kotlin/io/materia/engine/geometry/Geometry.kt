@@ -47,12 +47,46 @@ enum class AttributeSemantic {
 /**
  * Encapsulates vertex and optional index data for GPU rendering.
  *
+ * Indices come either as [indexBuffer] (16-bit, read unsigned) or as [indexBuffer32] for
+ * meshes past 65,535 vertices; at most one may be set. Code reading indices should go
+ * through [indexCount] and [indexAt] rather than either array.
+ *
  * @property vertexBuffer Interleaved vertex attribute data.
  * @property layout Describes how to interpret the vertex buffer.
  * @property indexBuffer Optional 16-bit indices for indexed drawing.
+ * @property indexBuffer32 Optional 32-bit indices for indexed drawing.
  */
 class Geometry(
     val vertexBuffer: VertexBuffer,
     val layout: GeometryLayout,
-    val indexBuffer: ShortArray? = null
-)
+    val indexBuffer: ShortArray? = null,
+    val indexBuffer32: IntArray? = null
+) {
+    init {
+        require(indexBuffer == null || indexBuffer32 == null) { "Geometry takes 16-bit or 32-bit indices, not both" }
+    }
+
+    /** Whether the geometry is drawn indexed. */
+    val isIndexed: Boolean
+        get() = indexBuffer != null || indexBuffer32 != null
+
+    /** Number of indices, or 0 when not indexed. */
+    val indexCount: Int
+        get() = indexBuffer?.size ?: indexBuffer32?.size ?: 0
+
+    /**
+     * Whether any index exceeds the 16-bit range, so the indices must be uploaded as
+     * UINT32. 32-bit indices that all fit are uploaded as UINT16.
+     */
+    val requires32BitIndices: Boolean by lazy {
+        indexBuffer32?.any { it < 0 || it > MAX_UINT16_INDEX } ?: false
+    }
+
+    /** Index [i] as an unsigned vertex number. */
+    fun indexAt(i: Int): Int = indexBuffer?.let { it[i].toInt() and 0xFFFF } ?: requireNotNull(indexBuffer32)[i]
+
+    companion object {
+        /** Largest vertex a UINT16 index can address. */
+        const val MAX_UINT16_INDEX = 0xFFFF
+    }
+}
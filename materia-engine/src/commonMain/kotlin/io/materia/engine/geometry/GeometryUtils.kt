@@ -20,14 +20,16 @@ fun Geometry.vertexCount(): Int {
  * @property normals Optional flat XYZ normal array.
  * @property uvs Optional flat UV coordinate array.
  * @property colors Optional flat RGB color array.
- * @property indices Optional index array for indexed drawing.
+ * @property indices Optional 16-bit index array for indexed drawing.
+ * @property indices32 Optional 32-bit index array, for meshes past 65,535 vertices.
  */
 data class InterleavedGeometrySource(
     val positions: FloatArray,
     val normals: FloatArray? = null,
     val uvs: FloatArray? = null,
     val colors: FloatArray? = null,
-    val indices: ShortArray? = null
+    val indices: ShortArray? = null,
+    val indices32: IntArray? = null
 )
 
 /**
@@ -112,7 +114,8 @@ fun buildInterleavedGeometry(source: InterleavedGeometrySource): Geometry {
     return Geometry(
         vertexBuffer = VertexBuffer(interleaved, layout.stride),
         layout = layout,
-        indexBuffer = source.indices
+        indexBuffer = source.indices,
+        indexBuffer32 = source.indices32
     )
 }
 
@@ -55,6 +55,21 @@ class Aabb(
         max.z = max(max.z, point.z)
     }
 
+    /**
+     * Expands this box to include the point (x, y, z) without a [Vec3].
+     *
+     * @return This box for chaining.
+     */
+    fun include(x: Float, y: Float, z: Float): Aabb = apply {
+        min.x = min(min.x, x)
+        min.y = min(min.y, y)
+        min.z = min(min.z, z)
+
+        max.x = max(max.x, x)
+        max.y = max(max.y, y)
+        max.z = max(max.z, z)
+    }
+
     /**
      * Expands this box to include another bounding box.
      *
@@ -23,6 +23,9 @@ class Transform {
     private val matrixCache = mat4()
     private var dirty = true
 
+    // position, rotation and scale the cached matrix was built from
+    private val composed = FloatArray(9)
+
     /**
      * Optional callback invoked whenever the transform is marked dirty.
      * Useful for propagating invalidation through a scene hierarchy.
@@ -95,10 +98,31 @@ class Transform {
         matrix[14] = position.z
         matrix[15] = 1f
 
+        recordComposed()
         dirty = false
         return matrix
     }
 
+    /**
+     * Marks the transform dirty if [position], [rotationEuler] or [scale] was written
+     * directly (for example `position.set(...)`) since the matrix was last built.
+     *
+     * Costs nine float comparisons; the setters mark the transform dirty on their own.
+     *
+     * @return True if the matrix needs recomputation.
+     */
+    fun detectChanges(): Boolean {
+        if (dirty) return true
+        val c = composed
+        if (c[0] != position.x || c[1] != position.y || c[2] != position.z ||
+            c[3] != rotationEuler.x || c[4] != rotationEuler.y || c[5] != rotationEuler.z ||
+            c[6] != scale.x || c[7] != scale.y || c[8] != scale.z
+        ) {
+            markDirty()
+        }
+        return dirty
+    }
+
     /**
      * Indicates whether the matrix needs recomputation.
      *
@@ -106,6 +130,19 @@ class Transform {
      */
     fun isDirty(): Boolean = dirty
 
+    private fun recordComposed() {
+        val c = composed
+        c[0] = position.x
+        c[1] = position.y
+        c[2] = position.z
+        c[3] = rotationEuler.x
+        c[4] = rotationEuler.y
+        c[5] = rotationEuler.z
+        c[6] = scale.x
+        c[7] = scale.y
+        c[8] = scale.z
+    }
+
     /**
      * Sets the position and marks the transform dirty.
      *
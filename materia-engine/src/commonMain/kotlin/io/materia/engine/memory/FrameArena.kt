@@ -99,6 +99,22 @@ class FloatSlice internal constructor(
         }
     }
 
+    /**
+     * Copies [count] floats from [source] into the start of this slice.
+     *
+     * @param source Source array.
+     * @param sourceOffset Starting index in the source array.
+     * @param count Number of floats to copy (defaults to the rest of [source]).
+     * @throws IllegalArgumentException If the range exceeds [source] or this slice.
+     */
+    fun copyFrom(source: FloatArray, sourceOffset: Int = 0, count: Int = source.size - sourceOffset) {
+        require(sourceOffset >= 0 && count >= 0 && sourceOffset + count <= source.size) {
+            "Source range out of bounds (sourceOffset=$sourceOffset count=$count capacity=${source.size})"
+        }
+        require(count <= length) { "Slice too small (count=$count length=$length)" }
+        source.copyInto(data, offset, sourceOffset, sourceOffset + count)
+    }
+
     /**
      * Copies this slice's contents into a target array.
      *
@@ -0,0 +1,88 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.Mat4
+import io.materia.engine.memory.UniformRingBuffer
+
+/**
+ * CPU-side packing of per-draw uniforms for dynamic-offset binding.
+ *
+ * Every draw gets one slot of [SLOT_FLOATS] floats in a [UniformRingBuffer] bucket;
+ * the slot size matches WebGPU's default `minUniformBufferOffsetAlignment` (256 bytes),
+ * so a slot's byte offset can be passed straight to `setBindGroup`. The GPU buffer
+ * mirrors the whole ring, and each frame uploads only its bucket's used range.
+ *
+ * Capacity grows geometrically when a frame needs more slots; [storageVersion]
+ * changes on growth so the owner knows to recreate the GPU buffer and bind groups.
+ *
+ * @param initialSlots Slots available per frame before the first growth.
+ * @param frameCount Number of ring buckets.
+ */
+internal class DrawUniformRing(
+    initialSlots: Int = DEFAULT_INITIAL_SLOTS,
+    private val frameCount: Int = DEFAULT_FRAME_COUNT
+) {
+    init {
+        require(initialSlots > 0) { "initialSlots must be positive (was $initialSlots)" }
+    }
+
+    private var ring = UniformRingBuffer(initialSlots * SLOT_FLOATS, frameCount)
+    private var frame: UniformRingBuffer.FrameContext? = null
+
+    /** Draw slots available per frame. */
+    var slotCapacity: Int = initialSlots
+        private set
+
+    /** Incremented whenever the backing storage is reallocated. */
+    var storageVersion: Int = 0
+        private set
+
+    /** Size in bytes of the GPU buffer mirroring the ring. */
+    val sizeBytes: Long
+        get() = ring.totalCapacity.toLong() * Float.SIZE_BYTES
+
+    /** Index of the first float of the current frame's bucket. */
+    val frameStart: Int
+        get() = frame?.frameOffset ?: 0
+
+    /** Floats written in the current frame. */
+    val frameUsed: Int
+        get() = frame?.let { ring.frameCapacity - it.remaining } ?: 0
+
+    /**
+     * Starts a frame that will push at most [drawCount] slots.
+     */
+    fun beginFrame(drawCount: Int) {
+        if (drawCount > slotCapacity) {
+            var slots = slotCapacity
+            while (slots < drawCount) {
+                slots *= 2
+            }
+            ring = UniformRingBuffer(slots * SLOT_FLOATS, frameCount)
+            slotCapacity = slots
+            storageVersion++
+        }
+        frame = ring.beginFrame()
+    }
+
+    /**
+     * Writes [matrix] into the next slot.
+     *
+     * @return Byte offset of the slot from the start of the GPU buffer.
+     */
+    fun push(matrix: Mat4): Int {
+        val context = checkNotNull(frame) { "Call beginFrame() before pushing draw uniforms" }
+        val slice = context.allocate(SLOT_FLOATS)
+        slice.copyFrom(matrix.toFloatArray())
+        return slice.offset * Float.SIZE_BYTES
+    }
+
+    /** Backing array for the upload of `[frameStart, frameStart + frameUsed)`. */
+    fun backingArray(): FloatArray = ring.backingArray()
+
+    companion object {
+        /** 256-byte slots: WebGPU's default minimum dynamic uniform offset alignment. */
+        const val SLOT_FLOATS = 64
+        const val DEFAULT_INITIAL_SLOTS = 256
+        const val DEFAULT_FRAME_COUNT = 2
+    }
+}
@@ -2,19 +2,19 @@ package io.materia.engine.render
 
 import io.materia.engine.camera.PerspectiveCamera
 import io.materia.engine.math.mat4
-import io.materia.engine.scene.InstancedPoints
-import io.materia.engine.scene.Mesh
 import io.materia.engine.scene.Scene
 import io.materia.gpu.GpuAdapter
 import io.materia.gpu.GpuAdapterInfo
 import io.materia.gpu.GpuBackend
 import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuCommandEncoder
 import io.materia.gpu.GpuCommandEncoderDescriptor
 import io.materia.gpu.GpuDevice
 import io.materia.gpu.GpuDeviceDescriptor
 import io.materia.gpu.GpuFilterMode
 import io.materia.gpu.GpuInstance
 import io.materia.gpu.GpuInstanceDescriptor
+import io.materia.gpu.GpuPassTimer
 import io.materia.gpu.GpuLoadOp
 import io.materia.gpu.GpuPowerPreference
 import io.materia.gpu.GpuRenderPassColorAttachment
@@ -30,6 +30,7 @@ import io.materia.gpu.GpuTexture
 import io.materia.gpu.GpuTextureDescriptor
 import io.materia.gpu.GpuTextureDimension
 import io.materia.gpu.GpuTextureFormat
+import io.materia.optimization.ResidencyManager
 import io.materia.gpu.GpuTextureUsage
 import io.materia.gpu.GpuTextureView
 import io.materia.gpu.createGpuInstance
@@ -41,16 +42,25 @@ import io.materia.renderer.RendererFactory
 import io.materia.renderer.RendererInitializationException
 import io.materia.renderer.PowerPreference
 import io.materia.core.Result
+import io.materia.core.platform.Platform
+import io.materia.profiling.PerformanceProfiler
+import io.materia.profiling.ProfileCategory
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import kotlin.math.max
+import kotlin.time.TimeSource
 
 /**
  * High-level renderer interface for the Materia engine.
  *
  * Provides a minimal, engine-focused render loop that bypasses the legacy
  * renderer stack and speaks directly to the multiplatform GPU layer. Handles
- * initialization, frame rendering, resize, and optional FXAA post-processing.
+ * initialization, frame rendering, resize, and optional FXAA and [PixelEffect]
+ * post-processing, scheduled each frame through a [RenderGraph].
  *
  * Obtain an instance via [RendererFactory.createEngineRenderer].
  */
@@ -99,6 +109,12 @@ interface EngineRenderer {
 
     /** Whether FXAA anti-aliasing is enabled. */
     var fxaaEnabled: Boolean
+
+    /**
+     * Per-pixel effects applied after the scene and FXAA, in order. Consecutive effects
+     * are fused into one full-screen pass; their params are read every frame.
+     */
+    var postEffects: List<PixelEffect>
 }
 
 /**
@@ -108,12 +124,30 @@ interface EngineRenderer {
  * @property powerPreference GPU selection preference (performance vs battery).
  * @property clearColor Default RGBA clear color for the background.
  * @property enableFxaa Whether to enable FXAA anti-aliasing by default.
+ * @property enableFrustumCulling Skip meshes and point clouds whose bounds are outside the view.
+ * @property enableOcclusionCulling Test indexed meshes against a GPU depth pyramid of the
+ *   previous frame and skip hidden ones through indirect draws. Needs depth; objects
+ *   revealed by fast camera motion may appear one frame late.
+ * @property enableStaticBatching Pack opaque indexed meshes marked
+ *   [io.materia.engine.scene.Node.isStatic] into shared buffers per pipeline and draw
+ *   each group with one multi-draw. Changing a group's membership rebuilds its buffers.
+ * @property residency Keep uploaded geometry within this manager's GPU memory budget,
+ *   evicting the least recently drawn. The renderer advances the manager's frames.
+ * @property postEffects Initial value of [EngineRenderer.postEffects].
+ * @property enableGpuTiming Time every pass on the GPU with timestamp queries and report
+ *   the results to [PerformanceProfiler]. Ignored when the device lacks timestamp queries.
  */
 data class EngineRendererOptions(
     val preferredBackends: List<GpuBackend> = listOf(GpuBackend.WEBGPU),
     val powerPreference: GpuPowerPreference = GpuPowerPreference.HIGH_PERFORMANCE,
     val clearColor: FloatArray = floatArrayOf(0.05f, 0.05f, 0.1f, 1f),
-    val enableFxaa: Boolean = false
+    val enableFxaa: Boolean = false,
+    val enableFrustumCulling: Boolean = true,
+    val enableOcclusionCulling: Boolean = false,
+    val enableStaticBatching: Boolean = false,
+    val residency: ResidencyManager? = null,
+    val postEffects: List<PixelEffect> = emptyList(),
+    val enableGpuTiming: Boolean = false
 )
 
 /**
@@ -159,17 +193,27 @@ private class EngineRendererImpl(
     private var fxaaResources: PostProcessPipelineFactory.PipelineResources? = null
     private var fxaaSampler: GpuSampler? = null
     private var fxaaBindGroup: GpuBindGroup? = null
-    private var fxaaBindGroupTexture: GpuTexture? = null
-    private var offscreenTexture: GpuTexture? = null
-    private var offscreenView: GpuTextureView? = null
-    private var fxaaWidth: Int = 0
-    private var fxaaHeight: Int = 0
+    private var fxaaBindGroupView: GpuTextureView? = null
+
+    private var texturePool: TransientTexturePool? = null
+    private var pixelEffectPass: FusedPixelEffectPass? = null
+    private var frameGraph: CompiledRenderGraph? = null
+    private var surfaceTarget: RenderGraphTexture? = null
+    private val frameContext = FrameContext()
+    private val startTime = TimeSource.Monotonic.markNow()
+    private var frameClearColor: FloatArray = options.clearColor
 
     private var depthTexture: GpuTexture? = null
     private var depthView: GpuTextureView? = null
     private var depthWidth: Int = 0
     private var depthHeight: Int = 0
     private var depthEnabled: Boolean = true
+    private var hiZPyramid: HiZPyramid? = null
+    private var timingScope: CoroutineScope? = null
+    private var passTimer: GpuPassTimer? = null
+
+    private val culler = FrustumCuller()
+    private val viewProjection = mat4()
 
     private var width: Int = max(surface.width, 1)
     private var height: Int = max(surface.height, 1)
@@ -187,12 +231,16 @@ private class EngineRendererImpl(
         set(value) {
             if (field == value) return
             field = value
-            if (!initialized) return
-            if (value) {
-                recreateOffscreenTargets(width, height)
-            } else {
-                releaseFxaaTargets()
+            frameGraph = null
+        }
+
+    override var postEffects: List<PixelEffect> = options.postEffects
+        set(value) {
+            require(value.size <= PixelEffectShader.MAX_EFFECTS) {
+                "At most ${PixelEffectShader.MAX_EFFECTS} post effects are supported (was ${value.size})"
             }
+            field = value.toList()
+            frameGraph = null
         }
 
     override suspend fun initialize(): Result<Unit> = initMutex.withLock {
@@ -232,20 +280,31 @@ private class EngineRendererImpl(
                 label = "engine-surface"
             )
             surfaceFormat = gpuSurface.getPreferredFormat(adapter)
-            
+
             // Depth attachments are disabled on Vulkan backend due to current implementation constraints
             depthEnabled = backendType != BackendType.VULKAN
             val depthFormat = if (depthEnabled) GpuTextureFormat.DEPTH24_PLUS else null
-            sceneRenderer = SceneRenderer(device, surfaceFormat, depthFormat)
-            
-            setupFxaaResources()
+            sceneRenderer = SceneRenderer(
+                device,
+                surfaceFormat,
+                depthFormat,
+                options.enableStaticBatching,
+                options.residency
+            )
+            if (depthEnabled && options.enableOcclusionCulling) {
+                hiZPyramid = HiZPyramid(device)
+            }
+
+            setupPostProcessResources()
+            if (options.enableGpuTiming) {
+                val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+                timingScope = scope
+                passTimer = GpuPassTimer.install(device, scope)
+            }
             initialized = true
             if (depthEnabled) {
                 recreateDepthTexture(width, height)
             }
-            if (fxaaEnabled) {
-                recreateOffscreenTargets(width, height)
-            }
             Result.Success(Unit)
         } catch (error: RendererInitializationException) {
             Result.Error(error.message ?: "Failed to initialize engine renderer", error)
@@ -257,98 +316,57 @@ private class EngineRendererImpl(
     override fun render(scene: Scene, camera: PerspectiveCamera) {
         check(initialized) { "EngineRenderer not initialized. Call initialize() first." }
 
-        scene.updateWorldMatrix(force = true)
+        scene.updateWorldMatrix()
         camera.updateProjection()
-        camera.updateWorldMatrix(force = true)
+        camera.updateWorldMatrix()
 
-        val (meshes, points) = collectRenderables(scene)
-        sceneRenderer.prepareBlocking(meshes, points)
+        options.residency?.beginFrame()
 
-        var useFxaa = fxaaEnabled && fxaaResources != null
-        if (useFxaa) {
-            if (width != fxaaWidth || height != fxaaHeight || offscreenTexture == null || offscreenView == null) {
-                if (width > 0 && height > 0) {
-                    recreateOffscreenTargets(width, height)
-                }
-            }
-            if (offscreenView == null) {
-                useFxaa = false
-            }
+        // Prepare every renderable so culled objects keep their GPU resources; under a
+        // residency budget only cached ones are refreshed and the rest upload when drawn
+        PerformanceProfiler.measure("engine.prepare", ProfileCategory.RENDERING) {
+            culler.collect(scene)
+            sceneRenderer.prepareBlocking(culler.meshes, culler.points)
         }
 
+        val graph = frameGraph ?: buildFrameGraph().also { frameGraph = it }
+
         val frame = try {
             gpuSurface.acquireFrame()
         } catch (error: Exception) {
             gpuSurface.resize(width, height)
             return
         }
+        passTimer?.beginFrame()
         val encoder = device.createCommandEncoder(
             GpuCommandEncoderDescriptor(label = "engine-renderer-encoder")
         )
 
-        val clearColor = if (scene.backgroundColor.size >= 4) {
+        frameClearColor = if (scene.backgroundColor.size >= 4) {
             scene.backgroundColor
         } else {
             options.clearColor
         }
 
-        val targetView = if (useFxaa) offscreenView ?: frame.view else frame.view
-
-        val pass = encoder.beginRenderPass(
-            GpuRenderPassDescriptor(
-                colorAttachments = listOf(
-                    GpuRenderPassColorAttachment(
-                        view = targetView,
-                        loadOp = GpuLoadOp.CLEAR,
-                        clearColor = clearColor
-                    )
-                ),
-                depthStencilAttachment = depthView?.let {
-                    GpuRenderPassDepthStencilAttachment(
-                        view = it,
-                        depthLoadOp = GpuLoadOp.CLEAR,
-                        depthStoreOp = GpuStoreOp.DISCARD,
-                        depthClearValue = 1.0f
-                    )
-                },
-                label = "engine-renderer-pass"
-            )
-        )
-
         // Compute view-projection matrix (no Y-flip needed for Vulkan)
         val projectionMatrix = camera.projectionMatrix()
-        val viewProjection = mat4().multiply(projectionMatrix, camera.viewMatrix())
-
-        sceneRenderer.record(pass, meshes, points, viewProjection)
-        pass.end()
-
-        if (useFxaa) {
-            ensureFxaaBindGroup()
-            val resources = fxaaResources
-            val bindGroup = fxaaBindGroup
-            if (resources != null && bindGroup != null) {
-                val fxaaPass = encoder.beginRenderPass(
-                    GpuRenderPassDescriptor(
-                        colorAttachments = listOf(
-                            GpuRenderPassColorAttachment(
-                                view = frame.view,
-                                loadOp = GpuLoadOp.CLEAR,
-                                clearColor = clearColor
-                            )
-                        ),
-                        label = "engine-renderer-fxaa-pass"
-                    )
-                )
-                fxaaPass.setPipeline(resources.pipeline)
-                fxaaPass.setBindGroup(0, bindGroup)
-                fxaaPass.draw(3)
-                fxaaPass.end()
-            }
+        viewProjection.multiply(projectionMatrix, camera.viewMatrix())
+        culler.cull(viewProjection, options.enableFrustumCulling)
+
+        val pool = checkNotNull(texturePool)
+        pixelEffectPass?.beginFrame()
+        PerformanceProfiler.measure("engine.record", ProfileCategory.RENDERING) {
+            frameContext.begin(encoder, frame.view, pool.acquire(graph), graph)
+            graph.execute(frameContext)
         }
 
         val commandBuffer = encoder.finish()
+        val submittedAt = Platform.currentTimeNanos()
         device.queue.submit(listOf(commandBuffer))
+        passTimer?.endFrame(submittedAt)
         gpuSurface.present(frame)
+        pool.endFrame()
+        options.residency?.endFrame()
     }
 
     override fun resize(width: Int, height: Int) {
@@ -359,76 +377,156 @@ private class EngineRendererImpl(
         if (depthEnabled) {
             recreateDepthTexture(this.width, this.height)
         }
-        if (fxaaEnabled) {
-            recreateOffscreenTargets(this.width, this.height)
-        }
+        hiZPyramid?.invalidate()
+        frameGraph = null
     }
 
     override fun dispose() {
         if (!initialized) return
         sceneRenderer.dispose()
+        hiZPyramid?.dispose()
+        hiZPyramid = null
+        texturePool?.dispose()
+        texturePool = null
+        pixelEffectPass?.dispose()
+        pixelEffectPass = null
+        frameGraph = null
+        timingScope?.cancel()
+        timingScope = null
+        passTimer?.dispose()
+        passTimer = null
         device.destroy()
         gpuInstance.dispose()
-        releaseFxaaTargets()
         depthTexture?.destroy()
         depthTexture = null
         depthView = null
         fxaaSampler = null
         fxaaBindGroup = null
-        fxaaBindGroupTexture = null
+        fxaaBindGroupView = null
         initialized = false
     }
 
-    private suspend fun setupFxaaResources() {
+    private suspend fun setupPostProcessResources() {
         fxaaResources = PostProcessPipelineFactory.createFxaaPipeline(device, surfaceFormat)
-        fxaaSampler = device.createSampler(
+        val sampler = device.createSampler(
             GpuSamplerDescriptor(
                 label = "engine-fxaa-sampler",
                 magFilter = GpuFilterMode.LINEAR,
                 minFilter = GpuFilterMode.LINEAR
             )
         )
+        fxaaSampler = sampler
+        texturePool = TransientTexturePool(device)
+        pixelEffectPass = FusedPixelEffectPass(device, sampler)
     }
 
-    private fun recreateOffscreenTargets(width: Int, height: Int) {
-        if (!fxaaEnabled) return
-        releaseFxaaTargets()
-        if (width <= 0 || height <= 0) return
-        val texture = device.createTexture(
-            GpuTextureDescriptor(
-                label = "engine-fxaa-offscreen",
-                size = Triple(width, height, 1),
-                mipLevelCount = 1,
-                sampleCount = 1,
-                dimension = GpuTextureDimension.D2,
-                format = surfaceFormat,
-                usage = gpuTextureUsage(
-                    GpuTextureUsage.RENDER_ATTACHMENT,
-                    GpuTextureUsage.TEXTURE_BINDING,
-                    GpuTextureUsage.COPY_SRC
-                )
+    /**
+     * Declares the frame: the scene pass renders straight into the surface unless FXAA or
+     * post effects follow, in which case it renders into a pooled texture. Consecutive post
+     * effects are fused into one pass by the graph, and the intermediate colour targets
+     * share memory wherever their lifetimes allow.
+     */
+    private fun buildFrameGraph(): CompiledRenderGraph {
+        val graph = RenderGraph()
+        val surfaceTexture = graph.importTexture("surface", surfaceFormat, width, height)
+        graph.output(surfaceTexture)
+        surfaceTarget = surfaceTexture
+
+        val effects = postEffects
+        val useFxaa = fxaaEnabled && fxaaResources != null
+        fun colorTarget(name: String, last: Boolean) =
+            if (last) surfaceTexture else graph.createTexture(name, RenderGraphTextureDesc(surfaceFormat))
+
+        val sceneColor = colorTarget("scene-color", last = !useFxaa && effects.isEmpty())
+        graph.addPass("scene") {
+            write(sceneColor)
+            execute { recordScene(it.encoder, it.view(sceneColor)) }
+        }
+
+        var color = sceneColor
+        if (useFxaa) {
+            val input = color
+            val output = colorTarget("fxaa-color", last = effects.isEmpty())
+            graph.addPass("fxaa") {
+                read(input)
+                write(output)
+                execute { recordFxaa(it.encoder, it.view(input), it.view(output)) }
+            }
+            color = output
+        }
+        effects.forEachIndexed { index, effect ->
+            val output = colorTarget("${effect.name}-color", last = index == effects.lastIndex)
+            graph.addPixelPass(effect.name, effect, color, output)
+            color = output
+        }
+        return graph.compile(width, height)
+    }
+
+    private fun recordScene(encoder: GpuCommandEncoder, target: GpuTextureView) {
+        val pyramid = hiZPyramid
+        if (pyramid != null) {
+            sceneRenderer.cullOcclusion(encoder, culler.visibleMeshes, culler, pyramid)
+        }
+
+        val pass = encoder.beginRenderPass(
+            GpuRenderPassDescriptor(
+                colorAttachments = listOf(
+                    GpuRenderPassColorAttachment(
+                        view = target,
+                        loadOp = GpuLoadOp.CLEAR,
+                        clearColor = frameClearColor
+                    )
+                ),
+                depthStencilAttachment = depthView?.let {
+                    GpuRenderPassDepthStencilAttachment(
+                        view = it,
+                        depthLoadOp = GpuLoadOp.CLEAR,
+                        depthStoreOp = if (pyramid != null) GpuStoreOp.STORE else GpuStoreOp.DISCARD,
+                        depthClearValue = 1.0f
+                    )
+                },
+                label = "engine-renderer-pass"
             )
         )
-        offscreenTexture = texture
-        offscreenView = texture.createView()
-        fxaaBindGroupTexture = null
-        fxaaWidth = width
-        fxaaHeight = height
+
+        sceneRenderer.record(pass, culler.visibleMeshes, culler.visiblePoints, viewProjection)
+        pass.end()
+
+        val depth = depthView
+        if (pyramid != null && depth != null) {
+            pyramid.build(encoder, depth, depthWidth, depthHeight, viewProjection)
+        }
     }
 
-    private fun ensureFxaaBindGroup() {
+    private fun recordFxaa(encoder: GpuCommandEncoder, input: GpuTextureView, output: GpuTextureView) {
         val resources = fxaaResources ?: return
         val sampler = fxaaSampler ?: return
-        val texture = offscreenTexture ?: return
-        val view = offscreenView ?: return
-        if (fxaaBindGroupTexture === texture && fxaaBindGroup != null) return
-        fxaaBindGroup = PostProcessPipelineFactory.createFxaaBindGroup(
-            device,
-            resources.bindGroupLayout,
-            view,
-            sampler
+        // Pooled textures persist across frames, so the bind group only changes on resize
+        if (fxaaBindGroupView !== input || fxaaBindGroup == null) {
+            fxaaBindGroup = PostProcessPipelineFactory.createFxaaBindGroup(
+                device,
+                resources.bindGroupLayout,
+                input,
+                sampler
+            )
+            fxaaBindGroupView = input
+        }
+        val fxaaPass = encoder.beginRenderPass(
+            GpuRenderPassDescriptor(
+                colorAttachments = listOf(
+                    GpuRenderPassColorAttachment(
+                        view = output,
+                        loadOp = GpuLoadOp.CLEAR,
+                        clearColor = frameClearColor
+                    )
+                ),
+                label = "engine-renderer-fxaa-pass"
+            )
         )
-        fxaaBindGroupTexture = texture
+        fxaaPass.setPipeline(resources.pipeline)
+        fxaaPass.setBindGroup(0, fxaaBindGroup!!)
+        fxaaPass.draw(3)
+        fxaaPass.end()
     }
 
     private fun recreateDepthTexture(width: Int, height: Int) {
@@ -445,7 +543,12 @@ private class EngineRendererImpl(
                 sampleCount = 1,
                 dimension = GpuTextureDimension.D2,
                 format = GpuTextureFormat.DEPTH24_PLUS,
-                usage = gpuTextureUsage(GpuTextureUsage.RENDER_ATTACHMENT)
+                usage = if (options.enableOcclusionCulling) {
+                    // The Hi-Z pyramid is seeded by reading this texture in a compute pass
+                    gpuTextureUsage(GpuTextureUsage.RENDER_ATTACHMENT, GpuTextureUsage.TEXTURE_BINDING)
+                } else {
+                    gpuTextureUsage(GpuTextureUsage.RENDER_ATTACHMENT)
+                }
             )
         )
         depthTexture = texture
@@ -454,29 +557,44 @@ private class EngineRendererImpl(
         depthHeight = height
     }
 
-    private fun releaseFxaaTargets() {
-        offscreenTexture?.destroy()
-        offscreenTexture = null
-        offscreenView = null
-        fxaaBindGroup = null
-        fxaaBindGroupTexture = null
-        fxaaWidth = 0
-        fxaaHeight = 0
-    }
+    /** Resolves graph textures to this frame's surface image and pooled slots. */
+    private inner class FrameContext : RenderGraphContext {
+        private lateinit var frameEncoder: GpuCommandEncoder
+        private lateinit var surfaceView: GpuTextureView
+        private lateinit var graph: CompiledRenderGraph
+        private var slotViews: List<GpuTextureView> = emptyList()
+
+        override val encoder: GpuCommandEncoder
+            get() = frameEncoder
+
+        fun begin(
+            encoder: GpuCommandEncoder,
+            surfaceView: GpuTextureView,
+            slotViews: List<GpuTextureView>,
+            graph: CompiledRenderGraph
+        ) {
+            frameEncoder = encoder
+            this.surfaceView = surfaceView
+            this.slotViews = slotViews
+            this.graph = graph
+        }
 
-    private fun collectRenderables(scene: Scene): Pair<List<Mesh>, List<InstancedPoints>> {
-        val meshes = mutableListOf<Mesh>()
-        val points = mutableListOf<InstancedPoints>()
-        scene.traverse { node ->
-            if (node is Mesh) {
-                meshes += node
-            } else if (node is InstancedPoints) {
-                points += node
-            }
+        override fun view(texture: RenderGraphTexture): GpuTextureView {
+            if (texture === surfaceTarget) return surfaceView
+            val slot = checkNotNull(graph.slot(texture)) { "$texture has no backing texture" }
+            return slotViews[slot]
         }
-        return meshes to points
-    }
 
+        override fun drawPixelEffects(
+            effects: List<PixelEffect>,
+            input: RenderGraphTexture,
+            output: RenderGraphTexture
+        ) {
+            val pass = pixelEffectPass ?: return
+            val time = startTime.elapsedNow().inWholeMicroseconds / 1_000_000f
+            pass.draw(frameEncoder, effects, view(input), view(output), width, height, time)
+        }
+    }
 }
 
 private fun BackendType.toGpuBackend(): GpuBackend = when (this) {
@@ -0,0 +1,180 @@
+package io.materia.engine.render
+
+import io.materia.engine.geometry.AttributeSemantic
+import io.materia.engine.geometry.Geometry
+import io.materia.engine.math.Aabb
+import io.materia.engine.math.Frustum
+import io.materia.engine.math.Mat4
+import io.materia.engine.scene.InstancedPoints
+import io.materia.engine.scene.Mesh
+import io.materia.engine.scene.Node
+import io.materia.engine.scene.Scene
+
+/**
+ * Collects renderables from a scene and keeps those whose bounds intersect the view frustum.
+ *
+ * Each renderable gets a cached local-space and world-space [Aabb]. The local box is
+ * rebuilt only when the mesh's geometry (or the points' [InstancedPoints.instanceVersion])
+ * changes, and the world box only when [Node.worldMatrixVersion] changes, so static
+ * objects cost one plane test per frame. All lists are reused across frames.
+ *
+ * [meshes] / [points] hold every renderable found by [collect] (pass these to
+ * `SceneRenderer.prepare` so culled objects keep their GPU resources);
+ * [visibleMeshes] / [visiblePoints] hold the survivors of [cull].
+ */
+internal class FrustumCuller {
+    private class CachedBounds {
+        val local = Aabb()
+        val world = Aabb()
+        var localSource: Any? = null
+        var localVersion = -1
+        var worldVersion = -1L
+        var lastSeenFrame = 0L
+    }
+
+    val meshes = ArrayList<Mesh>()
+    val points = ArrayList<InstancedPoints>()
+    val visibleMeshes = ArrayList<Mesh>()
+    val visiblePoints = ArrayList<InstancedPoints>()
+
+    /** Renderables rejected by the last [cull]. */
+    var culledCount: Int = 0
+        private set
+
+    private val frustum = Frustum()
+    private val bounds = HashMap<Node, CachedBounds>()
+    private var frame = 0L
+
+    private val collector: (Node) -> Unit = { node ->
+        if (node is Mesh) {
+            meshes.add(node)
+        } else if (node is InstancedPoints) {
+            points.add(node)
+        }
+    }
+
+    /**
+     * Gathers every [Mesh] and [InstancedPoints] under [scene] into [meshes] and [points].
+     */
+    fun collect(scene: Scene) {
+        meshes.clear()
+        points.clear()
+        scene.traverse(collector)
+    }
+
+    /**
+     * Fills [visibleMeshes] and [visiblePoints] with the collected renderables whose
+     * world bounds intersect the frustum of [viewProjection].
+     *
+     * When [enabled] is false everything is passed through unchanged.
+     */
+    fun cull(viewProjection: Mat4, enabled: Boolean = true) {
+        visibleMeshes.clear()
+        visiblePoints.clear()
+        culledCount = 0
+        if (!enabled) {
+            visibleMeshes.addAll(meshes)
+            visiblePoints.addAll(points)
+            return
+        }
+
+        frame++
+        Frustum.fromMatrix(viewProjection, frustum)
+
+        for (i in meshes.indices) {
+            val mesh = meshes[i]
+            if (isVisible(worldBounds(mesh))) {
+                visibleMeshes.add(mesh)
+            } else {
+                culledCount++
+            }
+        }
+        for (i in points.indices) {
+            val node = points[i]
+            if (isVisible(worldBounds(node))) {
+                visiblePoints.add(node)
+            } else {
+                culledCount++
+            }
+        }
+
+        if (bounds.size > meshes.size + points.size) {
+            evictStaleBounds()
+        }
+    }
+
+    /**
+     * Returns the cached world-space bounds of [node], refreshing them if stale.
+     */
+    fun worldBounds(node: Node): Aabb {
+        val cached = bounds.getOrPut(node) { CachedBounds() }
+        cached.lastSeenFrame = frame
+
+        var localChanged = false
+        when (node) {
+            is Mesh -> if (cached.localSource !== node.geometry) {
+                computeGeometryBounds(node.geometry, cached.local)
+                cached.localSource = node.geometry
+                localChanged = true
+            }
+
+            is InstancedPoints -> if (cached.localSource !== node ||
+                cached.localVersion != node.instanceVersion
+            ) {
+                computePointsBounds(node, cached.local)
+                cached.localSource = node
+                cached.localVersion = node.instanceVersion
+                localChanged = true
+            }
+
+            else -> Unit
+        }
+
+        if (localChanged || cached.worldVersion != node.worldMatrixVersion) {
+            cached.local.transform(node.getWorldMatrix(), cached.world)
+            cached.worldVersion = node.worldMatrixVersion
+        }
+        return cached.world
+    }
+
+    // Objects without usable position data are never culled
+    private fun isVisible(box: Aabb): Boolean = box.isEmpty() || frustum.intersects(box)
+
+    private fun evictStaleBounds() {
+        val iterator = bounds.values.iterator()
+        while (iterator.hasNext()) {
+            if (iterator.next().lastSeenFrame != frame) {
+                iterator.remove()
+            }
+        }
+    }
+
+    private fun computeGeometryBounds(geometry: Geometry, out: Aabb) {
+        out.reset()
+        val position = geometry.layout.attributes[AttributeSemantic.POSITION] ?: return
+        val data = geometry.vertexBuffer.data
+        val strideBytes = when {
+            geometry.vertexBuffer.strideBytes > 0 -> geometry.vertexBuffer.strideBytes
+            else -> geometry.layout.stride
+        }
+        if (strideBytes <= 0 || position.components < 3) return
+
+        val stride = strideBytes / Float.SIZE_BYTES
+        var base = position.offset / Float.SIZE_BYTES
+        while (base + 2 < data.size) {
+            out.include(data[base], data[base + 1], data[base + 2])
+            base += stride
+        }
+    }
+
+    private fun computePointsBounds(node: InstancedPoints, out: Aabb) {
+        out.reset()
+        val data = node.instanceData
+        val stride = node.componentsPerInstance
+        var base = 0
+        while (base + 2 < data.size) {
+            out.include(data[base], data[base + 1], data[base + 2])
+            base += stride
+        }
+    }
+}
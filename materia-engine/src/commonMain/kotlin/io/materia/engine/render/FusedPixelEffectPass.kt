@@ -0,0 +1,143 @@
+package io.materia.engine.render
+
+import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuBindGroupDescriptor
+import io.materia.gpu.GpuBindGroupEntry
+import io.materia.gpu.GpuBindGroupLayoutDescriptor
+import io.materia.gpu.GpuBindGroupLayoutEntry
+import io.materia.gpu.GpuBindingResource
+import io.materia.gpu.GpuBindingResourceType
+import io.materia.gpu.GpuBuffer
+import io.materia.gpu.GpuBufferDescriptor
+import io.materia.gpu.GpuBufferUsage
+import io.materia.gpu.GpuCommandEncoder
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuLoadOp
+import io.materia.gpu.GpuRenderPassColorAttachment
+import io.materia.gpu.GpuRenderPassDescriptor
+import io.materia.gpu.GpuRenderPipeline
+import io.materia.gpu.GpuRenderPipelineDescriptor
+import io.materia.gpu.GpuSampler
+import io.materia.gpu.GpuShaderModuleDescriptor
+import io.materia.gpu.GpuShaderStage
+import io.materia.gpu.GpuTextureFormat
+import io.materia.gpu.GpuTextureView
+import io.materia.gpu.gpuBufferUsage
+
+/**
+ * Draws runs of [PixelEffect]s as one full-screen pass each.
+ *
+ * Pipelines are built on first use per effect sequence and output format. Every draw in a
+ * frame gets its own uniform buffer because all writes land before the frame is
+ * submitted; call [beginFrame] before recording a frame's draws.
+ */
+internal class FusedPixelEffectPass(
+    private val device: GpuDevice,
+    private val sampler: GpuSampler
+) {
+    private class DrawSlot(val buffer: GpuBuffer) {
+        var input: GpuTextureView? = null
+        var bindGroup: GpuBindGroup? = null
+    }
+
+    private val layout = device.createBindGroupLayout(
+        GpuBindGroupLayoutDescriptor(
+            label = "pixel-effect-layout",
+            entries = listOf(
+                GpuBindGroupLayoutEntry(0, setOf(GpuShaderStage.FRAGMENT), GpuBindingResourceType.TEXTURE),
+                GpuBindGroupLayoutEntry(1, setOf(GpuShaderStage.FRAGMENT), GpuBindingResourceType.SAMPLER),
+                GpuBindGroupLayoutEntry(2, setOf(GpuShaderStage.FRAGMENT), GpuBindingResourceType.UNIFORM_BUFFER)
+            )
+        )
+    )
+    private val vertex = device.createShaderModule(
+        GpuShaderModuleDescriptor(
+            label = "pixel-effect.vert",
+            code = PostProcessPipelineFactory.FULLSCREEN_VERT_SHADER
+        )
+    )
+    private val pipelines = HashMap<Pair<String, GpuTextureFormat>, GpuRenderPipeline>()
+    private val slots = ArrayList<DrawSlot>()
+    private val uniforms = FloatArray(PixelEffectShader.UNIFORM_FLOATS)
+    private var drawIndex = 0
+
+    fun beginFrame() {
+        drawIndex = 0
+    }
+
+    fun draw(
+        encoder: GpuCommandEncoder,
+        effects: List<PixelEffect>,
+        input: GpuTextureView,
+        output: GpuTextureView,
+        width: Int,
+        height: Int,
+        time: Float
+    ) {
+        val format = output.texture.descriptor.format
+        val pipeline = pipelines.getOrPut(PixelEffectShader.key(effects) to format) {
+            createPipeline(effects, format)
+        }
+        val slot = slots.getOrNull(drawIndex) ?: DrawSlot(
+            device.createBuffer(
+                GpuBufferDescriptor(
+                    label = "pixel-effect-uniforms-$drawIndex",
+                    size = PixelEffectShader.UNIFORM_FLOATS * Float.SIZE_BYTES.toLong(),
+                    usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
+                )
+            )
+        ).also(slots::add)
+        drawIndex++
+
+        PixelEffectShader.writeUniforms(uniforms, effects, width, height, time)
+        slot.buffer.writeFloats(uniforms)
+        if (slot.input !== input || slot.bindGroup == null) {
+            slot.bindGroup = device.createBindGroup(
+                GpuBindGroupDescriptor(
+                    label = "pixel-effect-bind-group",
+                    layout = layout,
+                    entries = listOf(
+                        GpuBindGroupEntry(0, GpuBindingResource.Texture(input)),
+                        GpuBindGroupEntry(1, GpuBindingResource.Sampler(sampler)),
+                        GpuBindGroupEntry(2, GpuBindingResource.Buffer(slot.buffer))
+                    )
+                )
+            )
+            slot.input = input
+        }
+
+        val pass = encoder.beginRenderPass(
+            GpuRenderPassDescriptor(
+                colorAttachments = listOf(GpuRenderPassColorAttachment(view = output, loadOp = GpuLoadOp.CLEAR)),
+                label = "pixel-effect-pass"
+            )
+        )
+        pass.setPipeline(pipeline)
+        pass.setBindGroup(0, slot.bindGroup!!)
+        pass.draw(3)
+        pass.end()
+    }
+
+    fun dispose() {
+        slots.forEach { it.buffer.destroy() }
+        slots.clear()
+        pipelines.clear()
+    }
+
+    private fun createPipeline(effects: List<PixelEffect>, format: GpuTextureFormat): GpuRenderPipeline {
+        val key = PixelEffectShader.key(effects)
+        val fragment = device.createShaderModule(
+            GpuShaderModuleDescriptor(label = "pixel-effect[$key].frag", code = PixelEffectShader.fragment(effects))
+        )
+        return device.createRenderPipeline(
+            GpuRenderPipelineDescriptor(
+                label = "pixel-effect[$key]",
+                vertexShader = vertex,
+                fragmentShader = fragment,
+                colorFormats = listOf(format),
+                bindGroupLayouts = listOf(layout),
+                depthState = null
+            )
+        )
+    }
+}
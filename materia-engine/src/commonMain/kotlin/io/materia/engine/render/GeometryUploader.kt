@@ -31,24 +31,28 @@ internal class GeometryUploader(
         vertexBuffer.writeFloats(vertexData)
 
         var indexFormat: GpuIndexFormat? = null
-        val indexBuffer = geometry.indexBuffer?.let { indices ->
+        val indexBuffer = if (geometry.isIndexed) {
+            val format = indexFormatFor(geometry)
+            val bytes = indexBytes(geometry, format)
             val buffer = device.createBuffer(
                 GpuBufferDescriptor(
                     label = (label ?: "geometry") + "-index-buffer",
-                    size = indices.size * Short.SIZE_BYTES.toLong(),
+                    size = bytes.size.toLong(),
                     usage = gpuBufferUsage(GpuBufferUsage.INDEX, GpuBufferUsage.COPY_DST)
                 )
             )
-            buffer.write(indices.toLittleEndianBytes())
-            indexFormat = GpuIndexFormat.UINT16
+            buffer.write(bytes)
+            indexFormat = format
             buffer
+        } else {
+            null
         }
 
         return UploadedGeometry(
             vertexBuffer = vertexBuffer,
             indexBuffer = indexBuffer,
             vertexCount = vertexCount,
-            indexCount = geometry.indexBuffer?.size,
+            indexCount = if (geometry.isIndexed) geometry.indexCount else null,
             indexFormat = indexFormat
         )
     }
@@ -73,18 +77,45 @@ internal data class UploadedGeometry(
     val indexCount: Int?,
     val indexFormat: GpuIndexFormat?
 ) {
+    /** GPU memory held by the vertex and index buffers. */
+    val sizeBytes: Long get() = vertexBuffer.descriptor.size + (indexBuffer?.descriptor?.size ?: 0L)
+
     fun destroy() {
         vertexBuffer.destroy()
         indexBuffer?.destroy()
     }
 }
 
-private fun ShortArray.toLittleEndianBytes(): ByteArray {
-    val result = ByteArray(size * Short.SIZE_BYTES)
-    var i = 0
-    for (value in this) {
-        result[i++] = (value.toInt() and 0xFF).toByte()
-        result[i++] = ((value.toInt() shr 8) and 0xFF).toByte()
-    }
+/** Narrowest index format that addresses every vertex [geometry] indexes. */
+internal fun indexFormatFor(geometry: Geometry): GpuIndexFormat =
+    if (geometry.requires32BitIndices) GpuIndexFormat.UINT32 else GpuIndexFormat.UINT16
+
+/**
+ * Little-endian index data of [geometry] in [format], padded to the four-byte multiple
+ * buffer writes require.
+ */
+internal fun indexBytes(geometry: Geometry, format: GpuIndexFormat): ByteArray {
+    val count = geometry.indexCount
+    val width = if (format == GpuIndexFormat.UINT32) Int.SIZE_BYTES else Short.SIZE_BYTES
+    val result = ByteArray(((count * width) + 3) and 3.inv())
+    writeIndices(geometry, format, result, 0)
     return result
 }
+
+/**
+ * Writes the indices of [geometry] into [out] at byte [offset] in [format] and returns
+ * the offset after the last one.
+ */
+internal fun writeIndices(geometry: Geometry, format: GpuIndexFormat, out: ByteArray, offset: Int): Int {
+    var byte = offset
+    for (i in 0 until geometry.indexCount) {
+        val value = geometry.indexAt(i)
+        out[byte++] = (value and 0xFF).toByte()
+        out[byte++] = ((value shr 8) and 0xFF).toByte()
+        if (format == GpuIndexFormat.UINT32) {
+            out[byte++] = ((value shr 16) and 0xFF).toByte()
+            out[byte++] = ((value shr 24) and 0xFF).toByte()
+        }
+    }
+    return byte
+}
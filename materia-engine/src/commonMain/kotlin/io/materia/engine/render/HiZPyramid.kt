@@ -0,0 +1,264 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.Mat4
+import io.materia.engine.math.mat4
+import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuBindGroupDescriptor
+import io.materia.gpu.GpuBindGroupEntry
+import io.materia.gpu.GpuBindGroupLayout
+import io.materia.gpu.GpuBindGroupLayoutDescriptor
+import io.materia.gpu.GpuBindGroupLayoutEntry
+import io.materia.gpu.GpuBindingResource
+import io.materia.gpu.GpuBindingResourceType
+import io.materia.gpu.GpuCommandEncoder
+import io.materia.gpu.GpuComputePassDescriptor
+import io.materia.gpu.GpuComputePipeline
+import io.materia.gpu.GpuComputePipelineDescriptor
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuShaderModuleDescriptor
+import io.materia.gpu.GpuShaderStage
+import io.materia.gpu.GpuTexture
+import io.materia.gpu.GpuTextureDescriptor
+import io.materia.gpu.GpuTextureFormat
+import io.materia.gpu.GpuTextureUsage
+import io.materia.gpu.GpuTextureView
+import io.materia.gpu.GpuTextureViewDescriptor
+import io.materia.gpu.gpuTextureUsage
+
+/**
+ * Hierarchical depth (Hi-Z) pyramid built on the GPU from the frame's depth buffer.
+ *
+ * Mip 0 is the largest power-of-two size not exceeding the depth buffer; each texel
+ * stores the farthest depth of the source texels it covers, and every further mip
+ * takes the maximum of a 2x2 block. A box whose nearest depth is farther than the
+ * pyramid value over its screen rectangle is hidden. See [OcclusionCullPass].
+ *
+ * [viewProjection] is the matrix the depth was rendered with; the pyramid is one frame
+ * old when it is tested, so boxes are projected with the matrix that produced it.
+ */
+internal class HiZPyramid(private val device: GpuDevice) {
+    private val seedLayout = device.createBindGroupLayout(
+        GpuBindGroupLayoutDescriptor(
+            label = "hiz-seed-layout",
+            entries = listOf(
+                GpuBindGroupLayoutEntry(0, setOf(GpuShaderStage.COMPUTE), GpuBindingResourceType.DEPTH_TEXTURE),
+                storageEntry(1)
+            )
+        )
+    )
+    private val downsampleLayout = device.createBindGroupLayout(
+        GpuBindGroupLayoutDescriptor(
+            label = "hiz-downsample-layout",
+            entries = listOf(
+                GpuBindGroupLayoutEntry(0, setOf(GpuShaderStage.COMPUTE), GpuBindingResourceType.UNFILTERABLE_TEXTURE),
+                storageEntry(1)
+            )
+        )
+    )
+    private val seedPipeline = createPipeline("hiz-seed", SEED_SHADER, seedLayout)
+    private val downsamplePipeline = createPipeline("hiz-downsample", DOWNSAMPLE_SHADER, downsampleLayout)
+
+    private var texture: GpuTexture? = null
+    private var mipViews: List<GpuTextureView> = emptyList()
+    private var downsampleGroups: List<GpuBindGroup> = emptyList()
+    private var seedGroup: GpuBindGroup? = null
+    private var seedSource: GpuTextureView? = null
+
+    /** View over every mip, bound by the occlusion test. Null until the first [build]. */
+    var view: GpuTextureView? = null
+        private set
+
+    /** Mip 0 width in texels. */
+    var width: Int = 0
+        private set
+
+    /** Mip 0 height in texels. */
+    var height: Int = 0
+        private set
+
+    var levelCount: Int = 0
+        private set
+
+    /** True once [build] has run; the first frame has nothing to test against. */
+    var isValid: Boolean = false
+        private set
+
+    /** View-projection the pyramid's depth was rendered with. */
+    val viewProjection: Mat4 = mat4()
+
+    /**
+     * Records the compute passes that rebuild the pyramid from [depthView].
+     *
+     * Call after the pass that wrote the depth buffer, in the same encoder.
+     */
+    fun build(
+        encoder: GpuCommandEncoder,
+        depthView: GpuTextureView,
+        depthWidth: Int,
+        depthHeight: Int,
+        renderedWith: Mat4
+    ) {
+        ensureTexture(baseSize(depthWidth), baseSize(depthHeight))
+        val seed = seedGroup.takeIf { seedSource === depthView }
+            ?: bindGroup(seedLayout, depthView, mipViews[0], "hiz-seed-bind-group").also {
+                seedGroup = it
+                seedSource = depthView
+            }
+
+        val pass = encoder.beginComputePass(GpuComputePassDescriptor(label = "hiz-build"))
+        pass.setPipeline(seedPipeline)
+        pass.setBindGroup(0, seed)
+        pass.dispatchWorkgroups(workgroups(width), workgroups(height))
+
+        pass.setPipeline(downsamplePipeline)
+        for (level in 1 until levelCount) {
+            pass.setBindGroup(0, downsampleGroups[level - 1])
+            pass.dispatchWorkgroups(workgroups(mipSize(width, level)), workgroups(mipSize(height, level)))
+        }
+        pass.end()
+
+        viewProjection.copyFrom(renderedWith)
+        isValid = true
+    }
+
+    /** Drops the pyramid, e.g. after a resize; the next frame is not occlusion tested. */
+    fun invalidate() {
+        isValid = false
+    }
+
+    fun dispose() {
+        texture?.destroy()
+        texture = null
+        view = null
+        mipViews = emptyList()
+        downsampleGroups = emptyList()
+        seedGroup = null
+        seedSource = null
+        isValid = false
+    }
+
+    private fun ensureTexture(baseWidth: Int, baseHeight: Int) {
+        if (texture != null && baseWidth == width && baseHeight == height) return
+        texture?.destroy()
+
+        width = baseWidth
+        height = baseHeight
+        levelCount = levelCount(baseWidth, baseHeight)
+        val created = device.createTexture(
+            GpuTextureDescriptor(
+                label = "hiz-pyramid",
+                size = Triple(baseWidth, baseHeight, 1),
+                mipLevelCount = levelCount,
+                format = GpuTextureFormat.R32_FLOAT,
+                usage = gpuTextureUsage(GpuTextureUsage.STORAGE_BINDING, GpuTextureUsage.TEXTURE_BINDING)
+            )
+        )
+        texture = created
+        view = created.createView()
+        mipViews = List(levelCount) { level ->
+            created.createView(GpuTextureViewDescriptor(baseMipLevel = level, mipLevelCount = 1))
+        }
+        downsampleGroups = List(levelCount - 1) { level ->
+            bindGroup(downsampleLayout, mipViews[level], mipViews[level + 1], "hiz-downsample-bind-group")
+        }
+        seedGroup = null
+        seedSource = null
+        isValid = false
+    }
+
+    private fun bindGroup(
+        layout: GpuBindGroupLayout,
+        source: GpuTextureView,
+        destination: GpuTextureView,
+        label: String
+    ): GpuBindGroup = device.createBindGroup(
+        GpuBindGroupDescriptor(
+            label = label,
+            layout = layout,
+            entries = listOf(
+                GpuBindGroupEntry(0, GpuBindingResource.Texture(source)),
+                GpuBindGroupEntry(1, GpuBindingResource.Texture(destination))
+            )
+        )
+    )
+
+    private fun createPipeline(label: String, code: String, layout: GpuBindGroupLayout): GpuComputePipeline {
+        val module = device.createShaderModule(GpuShaderModuleDescriptor(label = "$label.comp", code = code))
+        return device.createComputePipeline(
+            GpuComputePipelineDescriptor(label = label, shader = module, bindGroupLayouts = listOf(layout))
+        )
+    }
+
+    companion object {
+        private const val WORKGROUP_SIZE = 8
+
+        /** Largest power of two not exceeding [size] (at least 1). */
+        fun baseSize(size: Int): Int {
+            require(size > 0) { "Depth size must be positive (was $size)" }
+            return size.takeHighestOneBit()
+        }
+
+        /** Number of mips down to 1x1 for a power-of-two base. */
+        fun levelCount(width: Int, height: Int): Int =
+            32 - maxOf(width, height).countLeadingZeroBits()
+
+        fun mipSize(size: Int, level: Int): Int = maxOf(1, size shr level)
+
+        private fun workgroups(size: Int): Int = (size + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE
+
+        private fun storageEntry(binding: Int) = GpuBindGroupLayoutEntry(
+            binding = binding,
+            visibility = setOf(GpuShaderStage.COMPUTE),
+            resourceType = GpuBindingResourceType.STORAGE_TEXTURE,
+            storageTextureFormat = GpuTextureFormat.R32_FLOAT
+        )
+
+        // Non-power-of-two depth buffers map 1 to 2 source texels per axis onto each
+        // mip 0 texel, so the footprint is rounded outwards and may cover 3.
+        private val SEED_SHADER = """
+            @group(0) @binding(0) var depthTexture : texture_depth_2d;
+            @group(0) @binding(1) var destination : texture_storage_2d<r32float, write>;
+
+            @compute @workgroup_size(8, 8)
+            fn main(@builtin(global_invocation_id) id : vec3<u32>) {
+                let dst = textureDimensions(destination);
+                if (id.x >= dst.x || id.y >= dst.y) {
+                    return;
+                }
+                let src = textureDimensions(depthTexture);
+                let x0 = (id.x * src.x) / dst.x;
+                let y0 = (id.y * src.y) / dst.y;
+                let x1 = min(max(x0 + 1u, ((id.x + 1u) * src.x + dst.x - 1u) / dst.x), src.x);
+                let y1 = min(max(y0 + 1u, ((id.y + 1u) * src.y + dst.y - 1u) / dst.y), src.y);
+
+                var farthest = 0.0;
+                for (var y = y0; y < y1; y = y + 1u) {
+                    for (var x = x0; x < x1; x = x + 1u) {
+                        farthest = max(farthest, textureLoad(depthTexture, vec2<u32>(x, y), 0));
+                    }
+                }
+                textureStore(destination, id.xy, vec4<f32>(farthest, 0.0, 0.0, 0.0));
+            }
+        """.trimIndent()
+
+        private val DOWNSAMPLE_SHADER = """
+            @group(0) @binding(0) var source : texture_2d<f32>;
+            @group(0) @binding(1) var destination : texture_storage_2d<r32float, write>;
+
+            @compute @workgroup_size(8, 8)
+            fn main(@builtin(global_invocation_id) id : vec3<u32>) {
+                let dst = textureDimensions(destination);
+                if (id.x >= dst.x || id.y >= dst.y) {
+                    return;
+                }
+                let last = textureDimensions(source) - vec2<u32>(1u, 1u);
+                let base = id.xy * 2u;
+                let a = textureLoad(source, min(base, last), 0).r;
+                let b = textureLoad(source, min(base + vec2<u32>(1u, 0u), last), 0).r;
+                let c = textureLoad(source, min(base + vec2<u32>(0u, 1u), last), 0).r;
+                let d = textureLoad(source, min(base + vec2<u32>(1u, 1u), last), 0).r;
+                textureStore(destination, id.xy, vec4<f32>(max(max(a, b), max(c, d)), 0.0, 0.0, 0.0));
+            }
+        """.trimIndent()
+    }
+}
@@ -0,0 +1,421 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.Aabb
+import io.materia.engine.math.Frustum
+import io.materia.engine.math.Mat4
+import io.materia.engine.math.Vec3
+import io.materia.gpu.GpuBindGroupDescriptor
+import io.materia.gpu.GpuBindGroupEntry
+import io.materia.gpu.GpuBindGroupLayoutDescriptor
+import io.materia.gpu.GpuBindGroupLayoutEntry
+import io.materia.gpu.GpuBindingResource
+import io.materia.gpu.GpuBindingResourceType
+import io.materia.gpu.GpuBuffer
+import io.materia.gpu.GpuBufferDescriptor
+import io.materia.gpu.GpuBufferUsage
+import io.materia.gpu.GpuCommandEncoder
+import io.materia.gpu.GpuComputePassDescriptor
+import io.materia.gpu.GpuComputePipelineDescriptor
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuRenderPassEncoder
+import io.materia.gpu.GpuShaderModuleDescriptor
+import io.materia.gpu.GpuShaderStage
+import io.materia.gpu.INDEXED_INDIRECT_STRIDE
+import io.materia.gpu.gpuBufferUsage
+import io.materia.optimization.InstanceUploadSink
+import io.materia.optimization.LODUtils
+import kotlin.math.abs
+import kotlin.math.max
+import kotlin.math.sqrt
+
+/**
+ * GPU frustum culling and LOD selection for one instanced batch.
+ *
+ * The pass is the batch's [InstanceUploadSink]: attach it as
+ * [io.materia.optimization.InstancedBatch.uploadSink] and flushed instance ranges land in
+ * [matrixBuffer] and [colorBuffer] directly. Each frame [dispatch] runs one invocation per
+ * instance that transforms the shared local bounds by the instance matrix, tests them
+ * against the frustum, and picks an LOD by screen-space error with the expression
+ * [LODUtils.projectedSize] defines, so the GPU selects what
+ * [io.materia.optimization.LODGroup] would. Survivors are appended to their level's
+ * segment of [visibleBuffer] (`level * capacity + n`) and counted, atomically, into that
+ * level's indexed-indirect record in [argsBuffer]. Nothing is read back.
+ *
+ * Draw level `l` with [drawLevel]; its vertex shader reads the instance as
+ * `visible[visibleOffset(l) + instance_index]`. The offset is passed by the caller rather
+ * than as `firstInstance` because a non-zero first instance in indirect draws needs the
+ * optional `indirect-first-instance` feature.
+ *
+ * The radius used for LOD is [Lod]-independent and scaled by the instance's largest
+ * axis scale, which for unscaled instances is exactly the [io.materia.optimization.LODGroup]
+ * metric.
+ */
+class InstanceCullPass(
+    private val device: GpuDevice,
+    val capacity: Int,
+    lods: List<Lod>
+) : InstanceUploadSink {
+    /**
+     * One detail level of the batch.
+     *
+     * @property indexCount Indices drawn for this level.
+     * @property firstIndex First index of the level in the shared index buffer.
+     * @property baseVertex Vertex offset of the level in the shared vertex buffer.
+     * @property screenSpaceError Smallest projected size, in pixels, that selects this level.
+     */
+    data class Lod(
+        val indexCount: Int,
+        val firstIndex: Int = 0,
+        val baseVertex: Int = 0,
+        val screenSpaceError: Float = 0f
+    )
+
+    val lods: List<Lod> = lods.toList()
+
+    init {
+        require(capacity > 0) { "capacity must be positive (was $capacity)" }
+        require(this.lods.size in 1..MAX_LODS) { "Between 1 and $MAX_LODS LOD levels are supported (was ${this.lods.size})" }
+    }
+
+    private val layout = device.createBindGroupLayout(
+        GpuBindGroupLayoutDescriptor(
+            label = "instance-cull-layout",
+            entries = listOf(
+                GpuBindGroupLayoutEntry(0, COMPUTE, GpuBindingResourceType.UNIFORM_BUFFER),
+                GpuBindGroupLayoutEntry(1, COMPUTE, GpuBindingResourceType.STORAGE_BUFFER),
+                GpuBindGroupLayoutEntry(2, COMPUTE, GpuBindingResourceType.STORAGE_BUFFER),
+                GpuBindGroupLayoutEntry(3, COMPUTE, GpuBindingResourceType.STORAGE_BUFFER)
+            )
+        )
+    )
+    private val pipeline = device.createComputePipeline(
+        GpuComputePipelineDescriptor(
+            label = "instance-cull",
+            shader = device.createShaderModule(
+                GpuShaderModuleDescriptor(label = "instance_cull.comp", code = CULL_SHADER)
+            ),
+            bindGroupLayouts = listOf(layout)
+        )
+    )
+    private val paramsBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "instance-cull-params",
+            size = PARAMS_FLOATS * Float.SIZE_BYTES.toLong(),
+            usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
+        )
+    )
+    private val params = FloatArray(PARAMS_FLOATS)
+    private val errors = FloatArray(MAX_LODS) { this.lods.getOrNull(it)?.screenSpaceError ?: 0f }
+    private val resetArgs = FloatArray(this.lods.size * ARGS_FLOATS).also { writeResetArgs(it, this.lods) }
+    private val frustum = Frustum()
+
+    /** Instance matrices, 16 floats each, column-major as [io.materia.core.math.Matrix4] stores them. */
+    val matrixBuffer: GpuBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "instance-cull-matrices",
+            size = capacity.toLong() * MATRIX_FLOATS * Float.SIZE_BYTES,
+            usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.COPY_DST)
+        )
+    )
+
+    /** Instance colors, 4 floats each. */
+    val colorBuffer: GpuBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "instance-cull-colors",
+            size = capacity.toLong() * COLOR_FLOATS * Float.SIZE_BYTES,
+            usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.COPY_DST)
+        )
+    )
+
+    /** Surviving instance indices, one [capacity]-sized segment per level. */
+    val visibleBuffer: GpuBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "instance-cull-visible",
+            size = capacity.toLong() * this.lods.size * Int.SIZE_BYTES,
+            usage = gpuBufferUsage(GpuBufferUsage.STORAGE)
+        )
+    )
+
+    /** One indexed-indirect record per level, [INDEXED_INDIRECT_STRIDE] bytes apart. */
+    val argsBuffer: GpuBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "instance-cull-args",
+            size = this.lods.size * INDEXED_INDIRECT_STRIDE,
+            usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.INDIRECT, GpuBufferUsage.COPY_DST)
+        )
+    )
+
+    private val bindGroup = device.createBindGroup(
+        GpuBindGroupDescriptor(
+            label = "instance-cull-bind-group",
+            layout = layout,
+            entries = listOf(
+                GpuBindGroupEntry(0, GpuBindingResource.Buffer(paramsBuffer)),
+                GpuBindGroupEntry(1, GpuBindingResource.Buffer(matrixBuffer)),
+                GpuBindGroupEntry(2, GpuBindingResource.Buffer(visibleBuffer)),
+                GpuBindGroupEntry(3, GpuBindingResource.Buffer(argsBuffer))
+            )
+        )
+    )
+
+    override fun writeInstances(firstInstance: Int, instanceCount: Int, matrices: FloatArray, colors: FloatArray) {
+        require(firstInstance >= 0 && firstInstance + instanceCount <= capacity) {
+            "Instances [$firstInstance, ${firstInstance + instanceCount}) exceed capacity $capacity"
+        }
+        matrixBuffer.writeFloats(
+            matrices,
+            offset = firstInstance * MATRIX_FLOATS * Float.SIZE_BYTES,
+            dataOffset = firstInstance * MATRIX_FLOATS,
+            count = instanceCount * MATRIX_FLOATS
+        )
+        colorBuffer.writeFloats(
+            colors,
+            offset = firstInstance * COLOR_FLOATS * Float.SIZE_BYTES,
+            dataOffset = firstInstance * COLOR_FLOATS,
+            count = instanceCount * COLOR_FLOATS
+        )
+    }
+
+    // The CPU draw list is not used: the shader builds the per-level lists itself
+    override fun writeDrawIndices(indices: IntArray, drawCount: Int) = Unit
+
+    /** First [visibleBuffer] element of [level]'s surviving instances. */
+    fun visibleOffset(level: Int): Int = level * capacity
+
+    /**
+     * Resets the per-level counts and records culling of the first [instanceCount]
+     * instances into [encoder], before the render pass that draws them.
+     *
+     * @param viewProjection Camera view-projection the frustum is extracted from.
+     * @param cameraPosition World-space camera position, for LOD distances.
+     * @param projectionScale Pixels per unit of `radius / distance`, see [LODUtils.projectionScale].
+     * @param localBounds Bounds shared by every instance, in instance space.
+     * @param boundingRadius Bounding sphere radius of the most detailed level.
+     * @return false when there was nothing to cull; the levels then draw nothing.
+     */
+    fun dispatch(
+        encoder: GpuCommandEncoder,
+        viewProjection: Mat4,
+        cameraPosition: Vec3,
+        projectionScale: Float,
+        localBounds: Aabb,
+        boundingRadius: Float,
+        instanceCount: Int
+    ): Boolean {
+        require(instanceCount in 0..capacity) { "instanceCount $instanceCount exceeds capacity $capacity" }
+        argsBuffer.writeFloats(resetArgs)
+        if (instanceCount == 0 || localBounds.isEmpty()) return false
+
+        Frustum.fromMatrix(viewProjection, frustum)
+        writeParams(
+            params, frustum, cameraPosition, projectionScale, localBounds, boundingRadius,
+            errors, instanceCount, lods.size, capacity
+        )
+        paramsBuffer.writeFloats(params)
+
+        val pass = encoder.beginComputePass(GpuComputePassDescriptor(label = "instance-cull"))
+        pass.setPipeline(pipeline)
+        pass.setBindGroup(0, bindGroup)
+        pass.dispatchWorkgroups((instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE)
+        pass.end()
+        return true
+    }
+
+    /** Draws [level] from its indirect record; the caller binds pipeline, geometry and [visibleOffset]. */
+    fun drawLevel(pass: GpuRenderPassEncoder, level: Int) {
+        require(level in lods.indices) { "Unknown LOD level $level" }
+        pass.drawIndexedIndirect(argsBuffer, level * INDEXED_INDIRECT_STRIDE)
+    }
+
+    fun dispose() {
+        paramsBuffer.destroy()
+        matrixBuffer.destroy()
+        colorBuffer.destroy()
+        visibleBuffer.destroy()
+        argsBuffer.destroy()
+    }
+
+    companion object {
+        /** Levels one pass selects between; the uniform block holds this many thresholds. */
+        const val MAX_LODS = 8
+
+        const val MATRIX_FLOATS = 16
+        const val COLOR_FLOATS = 4
+
+        /** Words per indirect record: indexCount, instanceCount, firstIndex, baseVertex, firstInstance. */
+        const val ARGS_FLOATS = 5
+
+        internal const val PARAMS_FLOATS = 48
+        private const val WORKGROUP_SIZE = 64
+        private val COMPUTE = setOf(GpuShaderStage.COMPUTE)
+
+        /**
+         * Packs the uniform block the way the shader reads it: six planes, the camera with
+         * the projection scale in w, local min with the radius in w, local max, the
+         * [MAX_LODS] thresholds, then instance count, level count and capacity as raw bits.
+         */
+        internal fun writeParams(
+            out: FloatArray,
+            frustum: Frustum,
+            cameraPosition: Vec3,
+            projectionScale: Float,
+            localBounds: Aabb,
+            boundingRadius: Float,
+            errors: FloatArray,
+            instanceCount: Int,
+            lodCount: Int,
+            capacity: Int
+        ) {
+            for (i in 0 until 6) {
+                val plane = frustum.plane(i)
+                out[i * 4] = plane.normal.x
+                out[i * 4 + 1] = plane.normal.y
+                out[i * 4 + 2] = plane.normal.z
+                out[i * 4 + 3] = plane.distance
+            }
+            out[24] = cameraPosition.x
+            out[25] = cameraPosition.y
+            out[26] = cameraPosition.z
+            out[27] = projectionScale
+            out[28] = localBounds.min.x
+            out[29] = localBounds.min.y
+            out[30] = localBounds.min.z
+            out[31] = boundingRadius
+            out[32] = localBounds.max.x
+            out[33] = localBounds.max.y
+            out[34] = localBounds.max.z
+            out[35] = 0f
+            for (i in 0 until MAX_LODS) out[36 + i] = errors.getOrElse(i) { 0f }
+            out[44] = Float.fromBits(instanceCount)
+            out[45] = Float.fromBits(lodCount)
+            out[46] = Float.fromBits(capacity)
+            out[47] = 0f
+        }
+
+        /** Indirect records with every instance count zeroed, written before each dispatch. */
+        internal fun writeResetArgs(out: FloatArray, lods: List<Lod>) {
+            lods.forEachIndexed { level, lod ->
+                val base = level * ARGS_FLOATS
+                out[base] = Float.fromBits(lod.indexCount)
+                out[base + 1] = Float.fromBits(0)
+                out[base + 2] = Float.fromBits(lod.firstIndex)
+                out[base + 3] = Float.fromBits(lod.baseVertex)
+                out[base + 4] = Float.fromBits(0)
+            }
+        }
+
+        /**
+         * CPU mirror of the shader for one instance: the level it is appended to, or -1
+         * when culled. Reads the matrix of [instance] from [matrices].
+         */
+        fun classify(
+            matrices: FloatArray,
+            instance: Int,
+            frustum: Frustum,
+            localBounds: Aabb,
+            boundingRadius: Float,
+            cameraPosition: Vec3,
+            projectionScale: Float,
+            errors: FloatArray,
+            lodCount: Int
+        ): Int {
+            val m = instance * MATRIX_FLOATS
+            val cx = (localBounds.min.x + localBounds.max.x) * 0.5f
+            val cy = (localBounds.min.y + localBounds.max.y) * 0.5f
+            val cz = (localBounds.min.z + localBounds.max.z) * 0.5f
+            val ex = (localBounds.max.x - localBounds.min.x) * 0.5f
+            val ey = (localBounds.max.y - localBounds.min.y) * 0.5f
+            val ez = (localBounds.max.z - localBounds.min.z) * 0.5f
+
+            // Arvo: world center plus the extent of the transformed half-axes
+            val wx = matrices[m] * cx + matrices[m + 4] * cy + matrices[m + 8] * cz + matrices[m + 12]
+            val wy = matrices[m + 1] * cx + matrices[m + 5] * cy + matrices[m + 9] * cz + matrices[m + 13]
+            val wz = matrices[m + 2] * cx + matrices[m + 6] * cy + matrices[m + 10] * cz + matrices[m + 14]
+            val hx = abs(matrices[m]) * ex + abs(matrices[m + 4]) * ey + abs(matrices[m + 8]) * ez
+            val hy = abs(matrices[m + 1]) * ex + abs(matrices[m + 5]) * ey + abs(matrices[m + 9]) * ez
+            val hz = abs(matrices[m + 2]) * ex + abs(matrices[m + 6]) * ey + abs(matrices[m + 10]) * ez
+
+            for (i in 0 until 6) {
+                val plane = frustum.plane(i)
+                val n = plane.normal
+                val reach = abs(n.x) * hx + abs(n.y) * hy + abs(n.z) * hz
+                if (n.x * wx + n.y * wy + n.z * wz + plane.distance + reach < 0f) return -1
+            }
+
+            val scale = sqrt(
+                max(
+                    max(axisLengthSquared(matrices, m), axisLengthSquared(matrices, m + 4)),
+                    axisLengthSquared(matrices, m + 8)
+                )
+            )
+            val dx = matrices[m + 12] - cameraPosition.x
+            val dy = matrices[m + 13] - cameraPosition.y
+            val dz = matrices[m + 14] - cameraPosition.z
+            val size = LODUtils.projectedSize(boundingRadius * scale, sqrt(dx * dx + dy * dy + dz * dz), projectionScale)
+            return LODUtils.levelForScreenSize(size, lodCount) { errors[it] }
+        }
+
+        private fun axisLengthSquared(m: FloatArray, at: Int): Float =
+            m[at] * m[at] + m[at + 1] * m[at + 1] + m[at + 2] * m[at + 2]
+
+        private val CULL_SHADER = """
+            struct Params {
+                planes : array<vec4<f32>, 6>,
+                cameraAndScale : vec4<f32>,
+                minAndRadius : vec4<f32>,
+                maxBound : vec4<f32>,
+                errors : array<vec4<f32>, 2>,
+                instanceCount : u32,
+                lodCount : u32,
+                capacity : u32,
+                pad : u32,
+            };
+
+            @group(0) @binding(0) var<uniform> params : Params;
+            @group(0) @binding(1) var<storage, read> matrices : array<mat4x4<f32>>;
+            @group(0) @binding(2) var<storage, read_write> visible : array<u32>;
+            @group(0) @binding(3) var<storage, read_write> args : array<atomic<u32>>;
+
+            // LODUtils.projectedSize treats closer than this as at the camera
+            const EPSILON : f32 = 1e-6;
+
+            @compute @workgroup_size(64)
+            fn main(@builtin(global_invocation_id) id : vec3<u32>) {
+                let instance = id.x;
+                if (instance >= params.instanceCount) {
+                    return;
+                }
+                let m = matrices[instance];
+                let lo = params.minAndRadius.xyz;
+                let hi = params.maxBound.xyz;
+                let center = (m * vec4<f32>((lo + hi) * 0.5, 1.0)).xyz;
+                let half = (hi - lo) * 0.5;
+                let extent = abs(m[0].xyz) * half.x + abs(m[1].xyz) * half.y + abs(m[2].xyz) * half.z;
+
+                for (var i = 0u; i < 6u; i = i + 1u) {
+                    let plane = params.planes[i];
+                    if (dot(plane.xyz, center) + plane.w + dot(abs(plane.xyz), extent) < 0.0) {
+                        return;
+                    }
+                }
+
+                let scale = sqrt(max(max(dot(m[0].xyz, m[0].xyz), dot(m[1].xyz, m[1].xyz)), dot(m[2].xyz, m[2].xyz)));
+                let distance = length(m[3].xyz - params.cameraAndScale.xyz);
+                var size = 3.4028235e38;
+                if (distance >= EPSILON) {
+                    size = (params.minAndRadius.w * scale / distance) * params.cameraAndScale.w;
+                }
+                var level = params.lodCount - 1u;
+                for (var l = 0u; l < params.lodCount; l = l + 1u) {
+                    if (size >= params.errors[l / 4u][l % 4u]) {
+                        level = l;
+                        break;
+                    }
+                }
+
+                let slot = atomicAdd(&args[level * 5u + 1u], 1u);
+                visible[level * params.capacity + slot] = instance;
+            }
+        """.trimIndent()
+    }
+}
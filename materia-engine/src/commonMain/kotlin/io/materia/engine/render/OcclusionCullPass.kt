@@ -0,0 +1,293 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.Aabb
+import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuBindGroupDescriptor
+import io.materia.gpu.GpuBindGroupEntry
+import io.materia.gpu.GpuBindGroupLayoutDescriptor
+import io.materia.gpu.GpuBindGroupLayoutEntry
+import io.materia.gpu.GpuBindingResource
+import io.materia.gpu.GpuBindingResourceType
+import io.materia.gpu.GpuBuffer
+import io.materia.gpu.GpuBufferDescriptor
+import io.materia.gpu.GpuBufferUsage
+import io.materia.gpu.GpuCommandEncoder
+import io.materia.gpu.GpuComputePassDescriptor
+import io.materia.gpu.GpuComputePipelineDescriptor
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuShaderModuleDescriptor
+import io.materia.gpu.GpuShaderStage
+import io.materia.gpu.GpuTextureView
+import io.materia.gpu.gpuBufferUsage
+
+/**
+ * GPU occlusion test that turns per-draw world bounds into indirect draw arguments.
+ *
+ * Each frame the caller [begin]s, [add]s one record per indexed draw, then [dispatch]es
+ * before the render pass. A compute shader projects every box with the
+ * [HiZPyramid.viewProjection], picks the pyramid mip at which the box's screen
+ * rectangle spans at most 2x2 texels, and compares the box's nearest depth with the
+ * farthest depth stored there. The result is written to [argsBuffer] as a
+ * `drawIndexedIndirect` record with an instance count of 0 or 1, so hidden draws cost
+ * the GPU nothing and the CPU never reads the result back.
+ *
+ * Boxes crossing the near plane and empty boxes are always drawn.
+ */
+internal class OcclusionCullPass(private val device: GpuDevice) {
+    private val layout = device.createBindGroupLayout(
+        GpuBindGroupLayoutDescriptor(
+            label = "occlusion-cull-layout",
+            entries = listOf(
+                GpuBindGroupLayoutEntry(0, COMPUTE, GpuBindingResourceType.UNIFORM_BUFFER),
+                GpuBindGroupLayoutEntry(1, COMPUTE, GpuBindingResourceType.STORAGE_BUFFER),
+                GpuBindGroupLayoutEntry(2, COMPUTE, GpuBindingResourceType.STORAGE_BUFFER),
+                GpuBindGroupLayoutEntry(3, COMPUTE, GpuBindingResourceType.UNFILTERABLE_TEXTURE)
+            )
+        )
+    )
+    private val pipeline = device.createComputePipeline(
+        GpuComputePipelineDescriptor(
+            label = "occlusion-cull",
+            shader = device.createShaderModule(
+                GpuShaderModuleDescriptor(label = "occlusion_cull.comp", code = CULL_SHADER)
+            ),
+            bindGroupLayouts = listOf(layout)
+        )
+    )
+    private val paramsBuffer = device.createBuffer(
+        GpuBufferDescriptor(
+            label = "occlusion-cull-params",
+            size = PARAMS_FLOATS * Float.SIZE_BYTES.toLong(),
+            usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
+        )
+    )
+    private val params = FloatArray(PARAMS_FLOATS)
+
+    private var records = FloatArray(INITIAL_CAPACITY * RECORD_FLOATS)
+    private var capacity = 0
+    private var boundsBuffer: GpuBuffer? = null
+    private var bindGroup: GpuBindGroup? = null
+    private var bindGroupPyramid: GpuTextureView? = null
+
+    /** Indirect arguments, [ARGS_STRIDE_BYTES] per record. Valid after [dispatch]. */
+    var argsBuffer: GpuBuffer? = null
+        private set
+
+    /** Records added since [begin]. */
+    var count: Int = 0
+        private set
+
+    fun begin() {
+        count = 0
+    }
+
+    /**
+     * Queues one indexed draw for testing and returns its record slot.
+     *
+     * @param bounds World-space bounds of the draw.
+     * @param indexCount Index count written to the indirect record.
+     */
+    fun add(bounds: Aabb, indexCount: Int): Int {
+        val slot = count++
+        if (count * RECORD_FLOATS > records.size) {
+            records = records.copyOf(records.size * 2)
+        }
+        writeRecord(records, slot, bounds, indexCount)
+        return slot
+    }
+
+    /**
+     * Uploads this frame's records and records the test into [encoder].
+     *
+     * @return false when nothing was dispatched (no records, or no valid pyramid yet);
+     *   the caller must then draw directly instead of through [argsBuffer].
+     */
+    fun dispatch(encoder: GpuCommandEncoder, pyramid: HiZPyramid): Boolean {
+        val pyramidView = pyramid.view
+        if (count == 0 || !pyramid.isValid || pyramidView == null) return false
+
+        ensureCapacity(count)
+        val bounds = boundsBuffer ?: return false
+        bounds.writeFloats(records, count = count * RECORD_FLOATS)
+
+        pyramid.viewProjection.data.copyInto(params)
+        params[16] = pyramid.width.toFloat()
+        params[17] = pyramid.height.toFloat()
+        params[18] = Float.fromBits(pyramid.levelCount)
+        params[19] = Float.fromBits(count)
+        paramsBuffer.writeFloats(params)
+
+        val args = argsBuffer ?: return false
+        val group = bindGroup.takeIf { bindGroupPyramid === pyramidView }
+            ?: createBindGroup(bounds, args, pyramidView).also {
+                bindGroup = it
+                bindGroupPyramid = pyramidView
+            }
+
+        val pass = encoder.beginComputePass(GpuComputePassDescriptor(label = "occlusion-cull"))
+        pass.setPipeline(pipeline)
+        pass.setBindGroup(0, group)
+        pass.dispatchWorkgroups((count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE)
+        pass.end()
+        return true
+    }
+
+    fun dispose() {
+        boundsBuffer?.destroy()
+        argsBuffer?.destroy()
+        paramsBuffer.destroy()
+        boundsBuffer = null
+        argsBuffer = null
+        bindGroup = null
+        bindGroupPyramid = null
+        capacity = 0
+    }
+
+    private fun ensureCapacity(required: Int) {
+        if (required <= capacity) return
+        var newCapacity = maxOf(INITIAL_CAPACITY, capacity)
+        while (newCapacity < required) newCapacity *= 2
+
+        boundsBuffer?.destroy()
+        argsBuffer?.destroy()
+        boundsBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "occlusion-cull-bounds",
+                size = newCapacity.toLong() * RECORD_FLOATS * Float.SIZE_BYTES,
+                usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.COPY_DST)
+            )
+        )
+        argsBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "occlusion-cull-args",
+                size = newCapacity.toLong() * ARGS_STRIDE_BYTES,
+                usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.INDIRECT)
+            )
+        )
+        capacity = newCapacity
+        bindGroup = null
+    }
+
+    private fun createBindGroup(
+        bounds: GpuBuffer,
+        args: GpuBuffer,
+        pyramidView: GpuTextureView
+    ): GpuBindGroup = device.createBindGroup(
+        GpuBindGroupDescriptor(
+            label = "occlusion-cull-bind-group",
+            layout = layout,
+            entries = listOf(
+                GpuBindGroupEntry(0, GpuBindingResource.Buffer(paramsBuffer)),
+                GpuBindGroupEntry(1, GpuBindingResource.Buffer(bounds)),
+                GpuBindGroupEntry(2, GpuBindingResource.Buffer(args)),
+                GpuBindGroupEntry(3, GpuBindingResource.Texture(pyramidView))
+            )
+        )
+    )
+
+    companion object {
+        /** Floats per record: min.xyz + index count bits, max.xyz + padding. */
+        const val RECORD_FLOATS = 8
+
+        /** Bytes per indirect record: indexCount, instanceCount, firstIndex, baseVertex, firstInstance. */
+        const val ARGS_STRIDE_BYTES = 20
+
+        private const val PARAMS_FLOATS = 20
+        private const val INITIAL_CAPACITY = 256
+        private const val WORKGROUP_SIZE = 64
+        private val COMPUTE = setOf(GpuShaderStage.COMPUTE)
+
+        /**
+         * Packs one record the way the shader reads it. The index count travels as raw
+         * bits in the w lane of the min corner so the whole record is one float upload.
+         */
+        fun writeRecord(out: FloatArray, slot: Int, bounds: Aabb, indexCount: Int) {
+            val base = slot * RECORD_FLOATS
+            out[base] = bounds.min.x
+            out[base + 1] = bounds.min.y
+            out[base + 2] = bounds.min.z
+            out[base + 3] = Float.fromBits(indexCount)
+            out[base + 4] = bounds.max.x
+            out[base + 5] = bounds.max.y
+            out[base + 6] = bounds.max.z
+            out[base + 7] = 0f
+        }
+
+        private val CULL_SHADER = """
+            struct Params {
+                viewProjection : mat4x4<f32>,
+                pyramidSize : vec2<f32>,
+                levelCount : u32,
+                drawCount : u32,
+            };
+
+            struct DrawBounds {
+                minAndCount : vec4<f32>,
+                maxBound : vec4<f32>,
+            };
+
+            @group(0) @binding(0) var<uniform> params : Params;
+            @group(0) @binding(1) var<storage, read_write> bounds : array<DrawBounds>;
+            @group(0) @binding(2) var<storage, read_write> args : array<u32>;
+            @group(0) @binding(3) var pyramid : texture_2d<f32>;
+
+            fn isVisible(lo : vec3<f32>, hi : vec3<f32>) -> bool {
+                if (any(lo > hi)) {
+                    return true;
+                }
+                var uvMin = vec2<f32>(1.0, 1.0);
+                var uvMax = vec2<f32>(0.0, 0.0);
+                var nearest = 1.0;
+                for (var i = 0u; i < 8u; i = i + 1u) {
+                    let corner = vec3<f32>(
+                        select(lo.x, hi.x, (i & 1u) != 0u),
+                        select(lo.y, hi.y, (i & 2u) != 0u),
+                        select(lo.z, hi.z, (i & 4u) != 0u)
+                    );
+                    let clip = params.viewProjection * vec4<f32>(corner, 1.0);
+                    if (clip.w <= 1e-5) {
+                        return true;
+                    }
+                    let ndc = clip.xyz / clip.w;
+                    let uv = vec2<f32>(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+                    uvMin = min(uvMin, uv);
+                    uvMax = max(uvMax, uv);
+                    nearest = min(nearest, ndc.z);
+                }
+                uvMin = clamp(uvMin, vec2<f32>(0.0), vec2<f32>(1.0));
+                uvMax = clamp(uvMax, vec2<f32>(0.0), vec2<f32>(1.0));
+
+                // Coarsest mip at which the rectangle spans at most 2x2 texels
+                let extent = (uvMax - uvMin) * params.pyramidSize;
+                let wanted = u32(ceil(log2(max(max(extent.x, extent.y), 1.0))));
+                let level = min(wanted, params.levelCount - 1u);
+                let size = vec2<i32>(textureDimensions(pyramid, level));
+                let texMin = clamp(vec2<i32>(uvMin * vec2<f32>(size)), vec2<i32>(0), size - 1);
+                let texMax = clamp(vec2<i32>(uvMax * vec2<f32>(size)), vec2<i32>(0), size - 1);
+
+                var farthest = 0.0;
+                for (var y = texMin.y; y <= texMax.y; y = y + 1) {
+                    for (var x = texMin.x; x <= texMax.x; x = x + 1) {
+                        farthest = max(farthest, textureLoad(pyramid, vec2<i32>(x, y), i32(level)).r);
+                    }
+                }
+                return nearest <= farthest;
+            }
+
+            @compute @workgroup_size(64)
+            fn main(@builtin(global_invocation_id) id : vec3<u32>) {
+                let draw = id.x;
+                if (draw >= params.drawCount) {
+                    return;
+                }
+                let record = bounds[draw];
+                let base = draw * 5u;
+                args[base] = bitcast<u32>(record.minAndCount.w);
+                args[base + 1u] = select(0u, 1u, isVisible(record.minAndCount.xyz, record.maxBound.xyz));
+                args[base + 2u] = 0u;
+                args[base + 3u] = 0u;
+                args[base + 4u] = 0u;
+            }
+        """.trimIndent()
+    }
+}
@@ -0,0 +1,179 @@
+package io.materia.engine.render
+
+/**
+ * A per-pixel post-processing effect that can be fused with its neighbours.
+ *
+ * [function] is WGSL source defining `fn <name>(color: vec4<f32>, uv: vec2<f32>,
+ * params: vec4<f32>) -> vec4<f32>`. It may read `uEffects.resolution` and
+ * `uEffects.time` but must not sample textures, which is what lets a run of effects
+ * share one texture fetch.
+ *
+ * @property name WGSL identifier of the function; effects with the same name share its source.
+ * @property function WGSL source of the function.
+ * @property params Four values passed to the function; may be changed between frames.
+ */
+class PixelEffect(
+    val name: String,
+    val function: String,
+    val params: FloatArray = FloatArray(4)
+) {
+    init {
+        require(IDENTIFIER.matches(name)) { "Effect name '$name' is not a WGSL identifier" }
+        require(params.size == 4) { "params must hold 4 values (was ${params.size})" }
+    }
+
+    override fun toString(): String = "PixelEffect($name)"
+
+    companion object {
+        private val IDENTIFIER = Regex("[A-Za-z_][A-Za-z0-9_]*")
+
+        /** Film grain and scanlines, matching `FilmPass`. */
+        fun film(
+            noiseIntensity: Float = 0.5f,
+            scanlineIntensity: Float = 0.05f,
+            scanlineCount: Float = 4096f,
+            grayscale: Boolean = false
+        ) = PixelEffect(
+            "film",
+            """
+            fn film(color : vec4<f32>, uv : vec2<f32>, params : vec4<f32>) -> vec4<f32> {
+                let noise = fract(sin(dot(uv + vec2<f32>(uEffects.time), vec2<f32>(12.9898, 78.233))) * 43758.5453);
+                var rgb = color.rgb + color.rgb * clamp(0.1 + noise, 0.0, 1.0) * params.x;
+                let scan = vec2<f32>(sin(uv.y * params.z), cos(uv.y * params.z));
+                rgb = rgb + color.rgb * vec3<f32>(scan.x, scan.y, scan.x) * params.y;
+                if (params.w > 0.5) {
+                    rgb = vec3<f32>(dot(rgb, vec3<f32>(0.3, 0.59, 0.11)));
+                }
+                return vec4<f32>(rgb, color.a);
+            }
+            """.trimIndent(),
+            floatArrayOf(noiseIntensity, scanlineIntensity, scanlineCount, if (grayscale) 1f else 0f)
+        )
+
+        /** Halftone dot pattern, matching `DotScreenPass`. */
+        fun dotScreen(angle: Float = 1.57f, scale: Float = 1f, centerX: Float = 0.5f, centerY: Float = 0.5f) =
+            PixelEffect(
+                "dot_screen",
+                """
+                fn dot_screen(color : vec4<f32>, uv : vec2<f32>, params : vec4<f32>) -> vec4<f32> {
+                    let s = sin(params.x);
+                    let c = cos(params.x);
+                    let texel = uv * uEffects.resolution - vec2<f32>(params.z, params.w) * uEffects.resolution;
+                    let point = vec2<f32>(c * texel.x - s * texel.y, s * texel.x + c * texel.y) * params.y;
+                    let pattern = sin(point.x) * sin(point.y) * 4.0;
+                    let average = (color.r + color.g + color.b) / 3.0;
+                    return vec4<f32>(vec3<f32>(average * 10.0 - 5.0 + pattern), color.a);
+                }
+                """.trimIndent(),
+                floatArrayOf(angle, scale, centerX, centerY)
+            )
+
+        /** ACES filmic tone mapping after scaling by [exposure]. */
+        fun acesToneMapping(exposure: Float = 1f) = PixelEffect(
+            "aces_tone_mapping",
+            """
+            fn aces_tone_mapping(color : vec4<f32>, uv : vec2<f32>, params : vec4<f32>) -> vec4<f32> {
+                let x = color.rgb * params.x;
+                let mapped = clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), vec3<f32>(0.0), vec3<f32>(1.0));
+                return vec4<f32>(mapped, color.a);
+            }
+            """.trimIndent(),
+            floatArrayOf(exposure, 0f, 0f, 0f)
+        )
+
+        /** Reinhard tone mapping after scaling by [exposure]. */
+        fun reinhardToneMapping(exposure: Float = 1f) = PixelEffect(
+            "reinhard_tone_mapping",
+            """
+            fn reinhard_tone_mapping(color : vec4<f32>, uv : vec2<f32>, params : vec4<f32>) -> vec4<f32> {
+                let x = color.rgb * params.x;
+                return vec4<f32>(x / (vec3<f32>(1.0) + x), color.a);
+            }
+            """.trimIndent(),
+            floatArrayOf(exposure, 0f, 0f, 0f)
+        )
+
+        /** Linear to sRGB encoding, matching `OutputPass`. */
+        fun srgbOutput() = PixelEffect(
+            "srgb_output",
+            """
+            fn srgb_output(color : vec4<f32>, uv : vec2<f32>, params : vec4<f32>) -> vec4<f32> {
+                let c = max(color.rgb, vec3<f32>(0.0));
+                let low = c * 12.92;
+                let high = 1.055 * pow(c, vec3<f32>(1.0 / 2.4)) - 0.055;
+                return vec4<f32>(select(high, low, c <= vec3<f32>(0.0031308)), color.a);
+            }
+            """.trimIndent()
+        )
+    }
+}
+
+/**
+ * Generates the WGSL fragment shader that applies a run of [PixelEffect]s with one
+ * texture sample.
+ */
+object PixelEffectShader {
+
+    /** Largest number of effects one fused pass can apply. */
+    const val MAX_EFFECTS = 8
+
+    /** Floats in the uniform block: resolution, time, padding and one vec4 per effect. */
+    const val UNIFORM_FLOATS = 4 + MAX_EFFECTS * 4
+
+    /** Key identifying the shader generated for [effects]. */
+    fun key(effects: List<PixelEffect>): String = effects.joinToString("+") { it.name }
+
+    /** Writes resolution, [time] and every effect's params into [out]. */
+    fun writeUniforms(out: FloatArray, effects: List<PixelEffect>, width: Int, height: Int, time: Float) {
+        require(out.size >= UNIFORM_FLOATS) { "Uniform array needs $UNIFORM_FLOATS floats" }
+        out[0] = width.toFloat()
+        out[1] = height.toFloat()
+        out[2] = time
+        out[3] = 0f
+        effects.forEachIndexed { index, effect -> effect.params.copyInto(out, 4 + index * 4) }
+    }
+
+    /** Fragment shader source applying [effects] in order; pairs with the FXAA vertex shader. */
+    fun fragment(effects: List<PixelEffect>): String {
+        require(effects.isNotEmpty()) { "At least one effect is required" }
+        require(effects.size <= MAX_EFFECTS) { "At most $MAX_EFFECTS effects can be fused (was ${effects.size})" }
+        val functions = effects.distinctBy { it.name }.joinToString("\n\n") { it.function }
+        val calls = effects.withIndex().joinToString("\n") { (index, effect) ->
+            "    color = ${effect.name}(color, input.uv, uEffects.params[$index]);"
+        }
+        return buildString {
+            appendLine(
+                """
+                struct PixelEffectUniforms {
+                    resolution : vec2<f32>,
+                    time : f32,
+                    _pad : f32,
+                    params : array<vec4<f32>, $MAX_EFFECTS>,
+                };
+
+                struct FragmentInput {
+                    @location(0) uv : vec2<f32>,
+                };
+
+                @group(0) @binding(0)
+                var uColorTexture : texture_2d<f32>;
+
+                @group(0) @binding(1)
+                var uColorSampler : sampler;
+
+                @group(0) @binding(2)
+                var<uniform> uEffects : PixelEffectUniforms;
+                """.trimIndent()
+            )
+            appendLine()
+            appendLine(functions)
+            appendLine()
+            appendLine("@fragment")
+            appendLine("fn main(input : FragmentInput) -> @location(0) vec4<f32> {")
+            appendLine("    var color = textureSample(uColorTexture, uColorSampler, input.uv);")
+            appendLine(calls)
+            appendLine("    return color;")
+            append("}")
+        }
+    }
+}
@@ -47,7 +47,7 @@ object PostProcessPipelineFactory {
         val vertex = device.createShaderModule(
             GpuShaderModuleDescriptor(
                 label = "fullscreen_fxaa.vert",
-                code = FXAA_VERT_SHADER
+                code = FULLSCREEN_VERT_SHADER
             )
         )
         val fragment = device.createShaderModule(
@@ -93,7 +93,8 @@ object PostProcessPipelineFactory {
         )
     )
 
-    private val FXAA_VERT_SHADER = """
+    /** Full-screen triangle with a `uv` varying at location 0, shared by the post-processing passes. */
+    internal val FULLSCREEN_VERT_SHADER = """
         struct VertexOutput {
             @builtin(position) position : vec4<f32>,
             @location(0) uv : vec2<f32>,
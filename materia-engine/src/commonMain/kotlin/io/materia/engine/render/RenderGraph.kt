@@ -0,0 +1,375 @@
+package io.materia.engine.render
+
+import io.materia.gpu.GpuCommandEncoder
+import io.materia.gpu.GpuTextureFormat
+import io.materia.gpu.GpuTextureUsage
+import io.materia.gpu.GpuTextureUsageFlags
+import io.materia.gpu.GpuTextureView
+import io.materia.gpu.gpuTextureUsage
+import kotlin.math.max
+
+/**
+ * Description of a render graph texture.
+ *
+ * Transient textures are sized relative to the graph by [scale] unless [width] and
+ * [height] are given, so half-resolution SSAO or a bloom mip chain follows resizes
+ * without extra bookkeeping.
+ *
+ * @property format Pixel format.
+ * @property scale Size relative to the graph's width and height.
+ * @property width Absolute width in pixels, overriding [scale].
+ * @property height Absolute height in pixels, overriding [scale].
+ * @property mipLevelCount Number of mip levels.
+ * @property usage Texture usage flags of the physical texture.
+ */
+data class RenderGraphTextureDesc(
+    val format: GpuTextureFormat,
+    val scale: Float = 1f,
+    val width: Int? = null,
+    val height: Int? = null,
+    val mipLevelCount: Int = 1,
+    val usage: GpuTextureUsageFlags = gpuTextureUsage(
+        GpuTextureUsage.RENDER_ATTACHMENT,
+        GpuTextureUsage.TEXTURE_BINDING
+    )
+) {
+    init {
+        require(scale > 0f) { "scale must be > 0 (was $scale)" }
+        require((width == null) == (height == null)) { "width and height must be given together" }
+        require(width == null || width > 0 && height!! > 0) { "Absolute size must be positive" }
+        require(mipLevelCount >= 1) { "mipLevelCount must be >= 1 (was $mipLevelCount)" }
+    }
+
+    /** Resolves the physical size for a graph of [graphWidth] x [graphHeight]. */
+    fun resolve(graphWidth: Int, graphHeight: Int): RenderGraphResolvedDesc = RenderGraphResolvedDesc(
+        width = width ?: max(1, (graphWidth * scale).toInt()),
+        height = height ?: max(1, (graphHeight * scale).toInt()),
+        format = format,
+        mipLevelCount = mipLevelCount,
+        usage = usage
+    )
+}
+
+/**
+ * Physical texture a [RenderGraphTextureDesc] resolves to. Transient textures with equal
+ * resolved descriptions may share memory.
+ */
+data class RenderGraphResolvedDesc(
+    val width: Int,
+    val height: Int,
+    val format: GpuTextureFormat,
+    val mipLevelCount: Int,
+    val usage: GpuTextureUsageFlags
+)
+
+/**
+ * Handle to a texture used by render graph passes. Imported textures (such as the
+ * swap chain image) are owned outside the graph; the graph allocates the others.
+ */
+class RenderGraphTexture internal constructor(
+    val id: Int,
+    val name: String,
+    val desc: RenderGraphTextureDesc,
+    val imported: Boolean
+) {
+    override fun toString(): String = "RenderGraphTexture($name)"
+}
+
+/**
+ * Per-frame services available to executing passes.
+ */
+interface RenderGraphContext {
+    /** Encoder the frame is recorded into. */
+    val encoder: GpuCommandEncoder
+
+    /** Returns the view of [texture] for this frame. */
+    fun view(texture: RenderGraphTexture): GpuTextureView
+
+    /**
+     * Draws [effects] in order as a single full-screen pass that samples [input] once and
+     * writes [output]. Called for pixel passes and for runs of them the graph merged.
+     */
+    fun drawPixelEffects(effects: List<PixelEffect>, input: RenderGraphTexture, output: RenderGraphTexture)
+}
+
+/**
+ * A pass declared on a [RenderGraph].
+ *
+ * @property name Debug name.
+ * @property reads Textures sampled by the pass.
+ * @property writes Textures rendered by the pass.
+ * @property effect Per-pixel effect this pass applies, making it eligible for merging.
+ */
+class RenderGraphPass internal constructor(
+    val name: String,
+    val reads: List<RenderGraphTexture>,
+    val writes: List<RenderGraphTexture>,
+    val effect: PixelEffect?,
+    internal val execute: ((RenderGraphContext) -> Unit)?
+) {
+    override fun toString(): String = "RenderGraphPass($name)"
+}
+
+/**
+ * Declares the reads and writes of a pass. Passes that produce nothing an output
+ * depends on are culled, so declarations must be complete.
+ */
+class RenderGraphPassBuilder internal constructor(private val name: String) {
+    private val reads = mutableListOf<RenderGraphTexture>()
+    private val writes = mutableListOf<RenderGraphTexture>()
+    private var execute: ((RenderGraphContext) -> Unit)? = null
+
+    /** Declares that the pass samples [texture]. */
+    fun read(texture: RenderGraphTexture): RenderGraphTexture {
+        reads += texture
+        return texture
+    }
+
+    /** Declares that the pass renders into [texture]. */
+    fun write(texture: RenderGraphTexture): RenderGraphTexture {
+        writes += texture
+        return texture
+    }
+
+    /** Records the pass; called once per frame while the compiled graph executes. */
+    fun execute(block: (RenderGraphContext) -> Unit) {
+        execute = block
+    }
+
+    internal fun build(): RenderGraphPass {
+        require(writes.isNotEmpty()) { "Pass '$name' writes nothing" }
+        return RenderGraphPass(name, reads.toList(), writes.toList(), effect = null, execute = execute)
+    }
+}
+
+/**
+ * Frame render graph for the engine's post-processing chain.
+ *
+ * Passes declare the textures they read and write up front; [compile] then
+ * - culls passes whose results never reach an [output],
+ * - merges runs of [addPixelPass] passes that feed only each other at the same
+ *   resolution into one fused shader, removing the intermediate textures, and
+ * - assigns the remaining transient textures to physical slots, letting textures
+ *   with equal resolved descriptions share one slot when their lifetimes don't overlap.
+ *
+ * Compilation is independent of the GPU; [TransientTexturePool] backs the slots with
+ * textures that persist across frames.
+ */
+class RenderGraph {
+    private val textures = mutableListOf<RenderGraphTexture>()
+    private val passes = mutableListOf<RenderGraphPass>()
+    private val outputs = linkedSetOf<RenderGraphTexture>()
+
+    /** Creates a transient texture allocated by the graph. */
+    fun createTexture(name: String, desc: RenderGraphTextureDesc): RenderGraphTexture =
+        RenderGraphTexture(textures.size, name, desc, imported = false).also(textures::add)
+
+    /**
+     * Registers a texture owned outside the graph, such as the surface image. Its view
+     * is supplied by the [RenderGraphContext] at execution.
+     */
+    fun importTexture(name: String, format: GpuTextureFormat, width: Int, height: Int): RenderGraphTexture =
+        RenderGraphTexture(
+            textures.size,
+            name,
+            RenderGraphTextureDesc(format, width = width, height = height),
+            imported = true
+        ).also(textures::add)
+
+    /** Marks [texture] as a result of the frame; passes feeding it are kept. */
+    fun output(texture: RenderGraphTexture) {
+        outputs += texture
+    }
+
+    /** Adds a pass configured by [setup]. */
+    fun addPass(name: String, setup: RenderGraphPassBuilder.() -> Unit): RenderGraphPass {
+        val pass = RenderGraphPassBuilder(name).apply(setup).build()
+        passes += pass
+        return pass
+    }
+
+    /**
+     * Adds a full-screen pass applying [effect] to [input]. Consecutive pixel passes are
+     * fused at compile time.
+     */
+    fun addPixelPass(
+        name: String,
+        effect: PixelEffect,
+        input: RenderGraphTexture,
+        output: RenderGraphTexture
+    ): RenderGraphPass {
+        val pass = RenderGraphPass(name, listOf(input), listOf(output), effect, execute = null)
+        passes += pass
+        return pass
+    }
+
+    /** Compiles the graph for a frame of [width] x [height] pixels. */
+    fun compile(width: Int, height: Int): CompiledRenderGraph {
+        require(width > 0 && height > 0) { "Graph size must be positive (was ${width}x$height)" }
+        val writers = HashMap<RenderGraphTexture, RenderGraphPass>()
+        for (pass in passes) {
+            for (texture in pass.writes) {
+                if (texture.imported) continue
+                require(writers.put(texture, pass) == null) {
+                    "Transient texture '${texture.name}' is written by more than one pass"
+                }
+            }
+        }
+        for (pass in passes) {
+            for (texture in pass.reads) {
+                require(texture.imported || texture in writers) {
+                    "Pass '${pass.name}' reads '${texture.name}', which no pass writes"
+                }
+            }
+        }
+
+        // Walk backwards from the outputs, keeping every pass something live depends on
+        val needed = HashSet<RenderGraphTexture>(outputs)
+        val live = ArrayList<RenderGraphPass>()
+        for (pass in passes.asReversed()) {
+            if (pass.writes.none { it in needed }) continue
+            live += pass
+            needed += pass.reads
+        }
+        live.reverse()
+
+        val readers = HashMap<RenderGraphTexture, Int>()
+        for (pass in live) for (texture in pass.reads) readers[texture] = (readers[texture] ?: 0) + 1
+
+        val steps = mergePixelPasses(live, readers, width, height)
+        val slots = assignSlots(steps, width, height)
+        return CompiledRenderGraph(
+            width = width,
+            height = height,
+            steps = steps,
+            culledPasses = passes.filter { it !in live },
+            slotOf = slots.first,
+            slots = slots.second
+        )
+    }
+
+    private fun mergePixelPasses(
+        live: List<RenderGraphPass>,
+        readers: Map<RenderGraphTexture, Int>,
+        width: Int,
+        height: Int
+    ): List<RenderGraphStep> {
+        val steps = ArrayList<RenderGraphStep>()
+        var run = ArrayList<RenderGraphPass>()
+        fun flush() {
+            if (run.isEmpty()) return
+            steps += RenderGraphStep(run, run.first().reads, run.last().writes)
+            run = ArrayList()
+        }
+        for (pass in live) {
+            if (pass.effect == null) {
+                flush()
+                steps += RenderGraphStep(listOf(pass), pass.reads, pass.writes)
+                continue
+            }
+            val previous = run.lastOrNull()
+            val input = pass.reads.single()
+            val fusable = previous != null &&
+                previous.writes.single() === input &&
+                !input.imported &&
+                input !in outputs &&
+                readers[input] == 1 &&
+                input.desc.resolve(width, height).sameSize(pass.writes.single().desc.resolve(width, height))
+            if (!fusable) flush()
+            run += pass
+        }
+        flush()
+        return steps
+    }
+
+    private fun assignSlots(
+        steps: List<RenderGraphStep>,
+        width: Int,
+        height: Int
+    ): Pair<Map<RenderGraphTexture, Int>, List<RenderGraphResolvedDesc>> {
+        val first = LinkedHashMap<RenderGraphTexture, Int>()
+        val last = HashMap<RenderGraphTexture, Int>()
+        steps.forEachIndexed { index, step ->
+            for (texture in step.reads + step.writes) {
+                if (texture.imported) continue
+                first.getOrPut(texture) { index }
+                last[texture] = index
+            }
+        }
+
+        val slotDescs = ArrayList<RenderGraphResolvedDesc>()
+        val slotFreeAfter = ArrayList<Int>()
+        val slotOf = HashMap<RenderGraphTexture, Int>()
+        // first is in order of first use, so a greedy scan reuses the earliest-freed slot
+        for ((texture, start) in first) {
+            val desc = texture.desc.resolve(width, height)
+            val end = last.getValue(texture)
+            var slot = slotDescs.indices.firstOrNull { slotDescs[it] == desc && slotFreeAfter[it] < start }
+            if (slot == null) {
+                slot = slotDescs.size
+                slotDescs += desc
+                slotFreeAfter += end
+            } else {
+                slotFreeAfter[slot] = end
+            }
+            slotOf[texture] = slot
+        }
+        return slotOf to slotDescs
+    }
+
+    private fun RenderGraphResolvedDesc.sameSize(other: RenderGraphResolvedDesc) =
+        width == other.width && height == other.height
+}
+
+/**
+ * One unit of execution: a single pass or a run of merged pixel passes.
+ *
+ * @property passes Passes executed by this step; more than one only for merged pixel passes.
+ * @property reads Textures the step samples.
+ * @property writes Textures the step renders.
+ */
+class RenderGraphStep internal constructor(
+    val passes: List<RenderGraphPass>,
+    val reads: List<RenderGraphTexture>,
+    val writes: List<RenderGraphTexture>
+) {
+    /** Per-pixel effects of a pixel step, in order, or empty for ordinary passes. */
+    val effects: List<PixelEffect> = passes.mapNotNull { it.effect }
+
+    override fun toString(): String = passes.joinToString("+") { it.name }
+}
+
+/**
+ * Result of [RenderGraph.compile].
+ *
+ * @property steps Surviving passes in execution order, pixel runs merged.
+ * @property culledPasses Passes dropped because no output depends on them.
+ * @property slots Physical texture descriptions; transient textures map onto these
+ *   through [slotOf].
+ */
+class CompiledRenderGraph internal constructor(
+    val width: Int,
+    val height: Int,
+    val steps: List<RenderGraphStep>,
+    val culledPasses: List<RenderGraphPass>,
+    private val slotOf: Map<RenderGraphTexture, Int>,
+    val slots: List<RenderGraphResolvedDesc>
+) {
+    /**
+     * Physical slot backing [texture], or null for imported textures and intermediates
+     * removed by pass merging.
+     */
+    fun slot(texture: RenderGraphTexture): Int? = slotOf[texture]
+
+    /** Records every step into [context]. */
+    fun execute(context: RenderGraphContext) {
+        for (step in steps) {
+            val effects = step.effects
+            if (effects.isNotEmpty()) {
+                context.drawPixelEffects(effects, step.reads.single(), step.writes.single())
+            } else {
+                step.passes.single().execute?.invoke(context)
+            }
+        }
+    }
+}
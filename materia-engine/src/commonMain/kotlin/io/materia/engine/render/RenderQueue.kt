@@ -0,0 +1,187 @@
+package io.materia.engine.render
+
+/**
+ * Draw statistics for the last frame recorded by [SceneRenderer].
+ *
+ * Bind-group calls are not counted as avoidable: every draw selects its own
+ * uniform slot through a dynamic offset, so the bind group is always re-set.
+ * A static batch counts as one draw call; [batchedMeshes] counts the meshes it drew.
+ */
+data class SceneRenderStats(
+    var drawCalls: Int = 0,
+    var pipelineSwitches: Int = 0,
+    var vertexBufferBinds: Int = 0,
+    var indexBufferBinds: Int = 0,
+    var stateChangesSkipped: Int = 0,
+    var occlusionTested: Int = 0,
+    var batchedMeshes: Int = 0
+) {
+    internal fun reset() {
+        drawCalls = 0
+        pipelineSwitches = 0
+        vertexBufferBinds = 0
+        indexBufferBinds = 0
+        stateChangesSkipped = 0
+        occlusionTested = 0
+        batchedMeshes = 0
+    }
+}
+
+/**
+ * Sortable list of draws for one frame.
+ *
+ * Each draw is a 63-bit sort key plus an integer payload (the caller's draw index),
+ * kept in parallel arrays that are reused across frames, so building and sorting
+ * the queue does not allocate once capacity has settled.
+ *
+ * Key layout (most significant first, bit 63 unused so signed comparison works):
+ * - opaque: `0 | pipeline:12 | material:12 | geometry:14 | depth:24` — state changes
+ *   are grouped first and equal-state draws go front to back for early-z rejection.
+ * - transparent: `1 | inverse depth:24 | pipeline:12 | material:12 | geometry:14` —
+ *   drawn after every opaque draw, back to front as blending requires.
+ *
+ * Ids are masked to their field width; a collision only costs an extra state change.
+ */
+internal class RenderQueue(initialCapacity: Int = 64) {
+    private var keys = LongArray(initialCapacity)
+    private var items = IntArray(initialCapacity)
+
+    /** Number of queued draws. */
+    var size: Int = 0
+        private set
+
+    fun clear() {
+        size = 0
+    }
+
+    fun add(key: Long, item: Int) {
+        if (size == keys.size) {
+            keys = keys.copyOf(size * 2)
+            items = items.copyOf(size * 2)
+        }
+        keys[size] = key
+        items[size] = item
+        size++
+    }
+
+    fun keyAt(index: Int): Long = keys[index]
+
+    fun itemAt(index: Int): Int = items[index]
+
+    /**
+     * Sorts queued draws by key. Ties keep no particular order.
+     */
+    fun sort() {
+        quickSort(0, size - 1)
+    }
+
+    private fun quickSort(low: Int, high: Int) {
+        var lo = low
+        var hi = high
+        while (hi - lo > INSERTION_SORT_THRESHOLD) {
+            val pivot = medianOfThree(lo, lo + (hi - lo) / 2, hi)
+            var i = lo
+            var j = hi
+            while (i <= j) {
+                while (keys[i] < pivot) i++
+                while (keys[j] > pivot) j--
+                if (i <= j) {
+                    swap(i, j)
+                    i++
+                    j--
+                }
+            }
+            // Recurse into the smaller half to bound stack depth
+            if (j - lo < hi - i) {
+                quickSort(lo, j)
+                lo = i
+            } else {
+                quickSort(i, hi)
+                hi = j
+            }
+        }
+        insertionSort(lo, hi)
+    }
+
+    private fun insertionSort(low: Int, high: Int) {
+        for (i in low + 1..high) {
+            val key = keys[i]
+            val item = items[i]
+            var j = i - 1
+            while (j >= low && keys[j] > key) {
+                keys[j + 1] = keys[j]
+                items[j + 1] = items[j]
+                j--
+            }
+            keys[j + 1] = key
+            items[j + 1] = item
+        }
+    }
+
+    private fun medianOfThree(a: Int, b: Int, c: Int): Long {
+        val ka = keys[a]
+        val kb = keys[b]
+        val kc = keys[c]
+        return when {
+            ka < kb -> if (kb < kc) kb else if (ka < kc) kc else ka
+            else -> if (ka < kc) ka else if (kb < kc) kc else kb
+        }
+    }
+
+    private fun swap(i: Int, j: Int) {
+        val key = keys[i]
+        keys[i] = keys[j]
+        keys[j] = key
+        val item = items[i]
+        items[i] = items[j]
+        items[j] = item
+    }
+
+    companion object {
+        private const val INSERTION_SORT_THRESHOLD = 16
+
+        private const val PIPELINE_BITS = 12
+        private const val MATERIAL_BITS = 12
+        private const val GEOMETRY_BITS = 14
+        private const val DEPTH_BITS = 24
+        private const val TRANSPARENT_BIT = 1L shl 62
+
+        /**
+         * Sort key for an opaque draw.
+         *
+         * @param depth View depth of the draw (clip-space w); smaller is nearer.
+         */
+        fun opaqueKey(pipelineId: Int, materialId: Int, geometryId: Int, depth: Float): Long =
+            (field(pipelineId, PIPELINE_BITS) shl (MATERIAL_BITS + GEOMETRY_BITS + DEPTH_BITS)) or
+                (field(materialId, MATERIAL_BITS) shl (GEOMETRY_BITS + DEPTH_BITS)) or
+                (field(geometryId, GEOMETRY_BITS) shl DEPTH_BITS) or
+                quantizeDepth(depth)
+
+        /**
+         * Sort key for a blended draw; farther draws sort first.
+         */
+        fun transparentKey(pipelineId: Int, materialId: Int, geometryId: Int, depth: Float): Long {
+            val inverseDepth = DEPTH_MASK - quantizeDepth(depth)
+            return TRANSPARENT_BIT or
+                (inverseDepth shl (PIPELINE_BITS + MATERIAL_BITS + GEOMETRY_BITS)) or
+                (field(pipelineId, PIPELINE_BITS) shl (MATERIAL_BITS + GEOMETRY_BITS)) or
+                (field(materialId, MATERIAL_BITS) shl GEOMETRY_BITS) or
+                field(geometryId, GEOMETRY_BITS)
+        }
+
+        fun isTransparent(key: Long): Boolean = (key and TRANSPARENT_BIT) != 0L
+
+        private const val DEPTH_MASK = (1L shl DEPTH_BITS) - 1
+
+        /**
+         * Monotonic 24-bit depth: the bit pattern of a non-negative float orders like
+         * the float itself, so the top 24 of its 31 significant bits keep the order.
+         */
+        internal fun quantizeDepth(depth: Float): Long {
+            val clamped = if (depth > 0f) depth else 0f
+            return (clamped.toRawBits().toLong() ushr (31 - DEPTH_BITS)) and DEPTH_MASK
+        }
+
+        private fun field(value: Int, bits: Int): Long = value.toLong() and ((1L shl bits) - 1)
+    }
+}
@@ -7,17 +7,26 @@ import io.materia.engine.geometry.GeometryAttribute
 import io.materia.engine.geometry.GeometryLayout
 import io.materia.engine.math.Mat4
 import io.materia.engine.math.mat4
+import io.materia.engine.material.BlendMode
+import io.materia.engine.material.Material
 import io.materia.engine.material.RenderState
 import io.materia.engine.scene.InstancedPoints
 import io.materia.engine.scene.Mesh
 import io.materia.engine.scene.VertexBuffer
+import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuBindGroupLayout
+import io.materia.gpu.GpuBuffer
 import io.materia.gpu.GpuBufferDescriptor
 import io.materia.gpu.GpuBufferUsage
+import io.materia.gpu.GpuCommandEncoder
 import io.materia.gpu.GpuDevice
 import io.materia.gpu.GpuIndexFormat
 import io.materia.gpu.GpuRenderPassEncoder
+import io.materia.gpu.GpuRenderPipeline
 import io.materia.gpu.GpuTextureFormat
 import io.materia.gpu.gpuBufferUsage
+import io.materia.optimization.ResidencyManager
+import io.materia.profiling.MemoryAllocationType
 import kotlin.reflect.KClass
 
 /**
@@ -27,21 +36,70 @@ import kotlin.reflect.KClass
  * to update caches for the current frame's renderables, then [record] to emit draw
  * commands into a render pass.
  *
+ * Per-draw matrices are packed into one shared uniform buffer ([DrawUniformRing]) that is
+ * uploaded once per frame; draws select their slot with a dynamic bind-group offset, so
+ * there is one bind group per pipeline layout rather than one buffer per mesh.
+ *
+ * Draws go through a [RenderQueue] sorted by pipeline, material, geometry and depth, and
+ * pipeline / vertex / index bindings that repeat the previous draw's state are skipped.
+ * [stats] reports the counts for the last recorded frame.
+ *
+ * When the engine renderer runs GPU occlusion culling, [cullOcclusion] is called before
+ * the render pass; indexed meshes are then drawn with `drawIndexedIndirect` from the
+ * arguments it produced, so occluded meshes are skipped without a CPU readback.
+ *
+ * With [staticBatching], opaque indexed [io.materia.engine.scene.Node.isStatic] meshes
+ * that share a pipeline are packed into a [StaticBatch] and drawn with a single
+ * multi-draw instead of one draw each.
+ *
+ * With a [residency] manager, uploaded geometry counts against its GPU memory budget and
+ * the least recently drawn geometry is destroyed when the budget runs out. Resources are
+ * then created when a renderable is first drawn rather than when it is prepared, so
+ * culled objects no longer pin memory; evicted geometry is uploaded again on its next draw.
+ *
  * @param device The GPU device for resource creation.
  * @param colorFormat Texture format of the color attachment.
  * @param depthFormat Optional depth attachment format (null disables depth).
+ * @param staticBatching Pack static meshes into shared buffers drawn by one multi-draw.
+ * @param residency Optional GPU memory budget for geometry; static batches are not tracked.
  */
 class SceneRenderer(
     private val device: GpuDevice,
     private val colorFormat: GpuTextureFormat,
-    private val depthFormat: GpuTextureFormat? = GpuTextureFormat.DEPTH24_PLUS
+    private val depthFormat: GpuTextureFormat? = GpuTextureFormat.DEPTH24_PLUS,
+    private val staticBatching: Boolean = false,
+    private val residency: ResidencyManager? = null
 ) {
     private val geometryUploader = GeometryUploader(device)
     private val geometryCache = mutableMapOf<Any, UploadedGeometry>()
     private val pipelineCache = mutableMapOf<PipelineKey, UnlitPipelineFactory.PipelineResources>()
+    private val pipelineIds = mutableMapOf<UnlitPipelineFactory.PipelineResources, Int>()
     private val meshCache = mutableMapOf<Mesh, MeshResources>()
     private val pointsCache = mutableMapOf<InstancedPoints, PointsResources>()
 
+    private val drawUniforms = DrawUniformRing()
+    private var uniformBuffer: GpuBuffer? = null
+    private var uniformBufferVersion = -1
+    private val uniformBindGroups = mutableMapOf<GpuBindGroupLayout, GpuBindGroup>()
+    private val dynamicOffset = IntArray(1)
+
+    private val renderQueue = RenderQueue()
+    private val queuedDraws = ArrayList<DrawResources>()
+    private var queuedOffsets = IntArray(64)
+    private var queuedIndirect = IntArray(64)
+
+    private var occlusionPass: OcclusionCullPass? = null
+    private var occlusionSlots = IntArray(64)
+    private var occlusionMeshes: Collection<Mesh>? = null
+
+    private val staticBatches = mutableMapOf<PipelineKey, StaticBatch>()
+    private val batchOf = HashMap<Mesh, StaticBatch>()
+    private val groupedMeshes = ArrayList<GroupedMesh>()
+    private var batchViewBuffer: GpuBuffer? = null
+
+    /** Draw and state-change counts for the most recent [record] call. */
+    val stats = SceneRenderStats()
+
     /**
      * Updates resource caches for the given renderables.
      *
@@ -54,12 +112,14 @@ class SceneRenderer(
     fun prepare(meshes: Collection<Mesh>, points: Collection<InstancedPoints>) {
         val meshSet = meshes.toSet()
         val pointSet = points.toSet()
+        if (staticBatching) {
+            prepareStaticBatches(meshes)
+        }
 
         meshCache.keys.toList().forEach { mesh ->
-            if (mesh !in meshSet) {
+            if (mesh !in meshSet || mesh in batchOf) {
                 meshCache.remove(mesh)?.let { resources ->
-                    resources.dispose()
-                    geometryCache.remove(resources.sourceGeometry)?.destroy()
+                    releaseGeometry(resources.sourceGeometry)
                 }
             }
         }
@@ -68,13 +128,14 @@ class SceneRenderer(
             if (node !in pointSet) {
                 pointsCache.remove(node)?.let { resources ->
                     resources.dispose()
-                    geometryCache.remove(resources.sourceNode)?.destroy()
+                    releaseGeometry(resources.sourceNode)
                 }
             }
         }
 
-        meshes.forEach { ensureMeshResources(it) }
-        points.forEach { ensurePointsResources(it) }
+        // Under a residency budget, renderables that are not cached yet upload when drawn
+        meshes.forEach { if (it !in batchOf && (residency == null || it in meshCache)) ensureMeshResources(it) }
+        points.forEach { if (residency == null || it in pointsCache) ensurePointsResources(it) }
     }
 
     /**
@@ -84,11 +145,48 @@ class SceneRenderer(
         prepare(meshes, points)
     }
 
+    /**
+     * Records the GPU occlusion test for [meshes] into [encoder], ahead of the render pass.
+     *
+     * Pass the same collection to the following [record]; any other collection is drawn
+     * without occlusion culling. Does nothing until [pyramid] holds a previous frame.
+     */
+    internal fun cullOcclusion(
+        encoder: GpuCommandEncoder,
+        meshes: List<Mesh>,
+        culler: FrustumCuller,
+        pyramid: HiZPyramid
+    ) {
+        occlusionMeshes = null
+        if (!pyramid.isValid) return
+        val pass = occlusionPass ?: OcclusionCullPass(device).also { occlusionPass = it }
+
+        if (occlusionSlots.size < meshes.size) {
+            occlusionSlots = IntArray(maxOf(meshes.size, occlusionSlots.size * 2))
+        }
+        pass.begin()
+        for (i in meshes.indices) {
+            val mesh = meshes[i]
+            val geometry = meshCache[mesh]?.geometry
+            val indexCount = geometry?.indexCount ?: 0
+            occlusionSlots[i] = if (indexCount > 0 && geometry?.indexBuffer != null && geometry.indexFormat != null) {
+                pass.add(culler.worldBounds(mesh), indexCount)
+            } else {
+                -1
+            }
+        }
+        if (pass.dispatch(encoder, pyramid)) {
+            occlusionMeshes = meshes
+        }
+    }
+
     /**
      * Records draw commands for all prepared renderables.
      *
-     * Binds pipelines, sets uniforms with the view-projection matrix,
-     * and issues draw calls for each mesh and point cloud.
+     * Packs each draw's model-view-projection matrix into the shared uniform buffer,
+     * sorts the draws through the render queue, then issues them while skipping
+     * pipeline, vertex and index bindings that are already bound. The uniform data
+     * is uploaded with a single buffer write after recording.
      *
      * @param pass The render pass encoder to record into.
      * @param meshes Collection of meshes to draw.
@@ -101,62 +199,264 @@ class SceneRenderer(
         points: Collection<InstancedPoints>,
         viewProjection: Mat4
     ) {
+        stats.reset()
+        drawUniforms.beginFrame(meshes.size + points.size)
+        val uniforms = ensureUniformBuffer()
+
+        renderQueue.clear()
+        queuedDraws.clear()
+        val indirectArgs = if (occlusionMeshes === meshes) occlusionPass?.argsBuffer else null
+        occlusionMeshes = null
+        staticBatches.values.forEach { it.beginFrame() }
+        var meshIndex = 0
         meshes.forEach { mesh ->
-            val resources = meshCache[mesh] ?: return@forEach
-            val worldMatrix = mesh.getWorldMatrix()
-            val mvp = TMP_MAT.multiply(viewProjection, worldMatrix)
-            resources.uniformBuffer.writeFloats(mvp.toFloatArray(copy = true))
-
-            pass.setPipeline(resources.pipeline.pipeline)
-            pass.setBindGroup(0, resources.bindGroup)
-            pass.setVertexBuffer(0, resources.geometry.vertexBuffer)
-
-            val indexBuffer = resources.geometry.indexBuffer
-            val indexCount = resources.geometry.indexCount
-            val indexFormat = resources.geometry.indexFormat
-
-            if (indexBuffer != null && indexCount != null && indexCount > 0 && indexFormat != null) {
-                pass.setIndexBuffer(indexBuffer, indexFormat, 0L)
-                pass.drawIndexed(indexCount)
+            val slot = if (indirectArgs != null) occlusionSlots[meshIndex] else -1
+            meshIndex++
+            if (batchOf[mesh]?.markVisible(mesh) == true) return@forEach
+            val resources = meshCache[mesh] ?: residency?.let { ensureMeshResources(mesh) } ?: return@forEach
+            residency?.touch(resources.sourceGeometry)
+            val mvp = TMP_MAT.multiply(viewProjection, mesh.getWorldMatrix())
+            enqueue(resources, mesh.material, mvp, slot)
+        }
+        points.forEach { pointNode ->
+            val resources = pointsCache[pointNode] ?: residency?.let { ensurePointsResources(pointNode) } ?: return@forEach
+            residency?.touch(pointNode)
+            val mvp = TMP_MAT.multiply(viewProjection, pointNode.getWorldMatrix())
+            enqueue(resources, pointNode.material, mvp, -1)
+        }
+        renderQueue.sort()
+
+        if (staticBatches.isNotEmpty()) {
+            recordStaticBatches(pass, viewProjection)
+        }
+
+        var boundPipeline: GpuRenderPipeline? = null
+        var boundVertexBuffer: GpuBuffer? = null
+        var boundIndexBuffer: GpuBuffer? = null
+
+        for (i in 0 until renderQueue.size) {
+            val draw = renderQueue.itemAt(i)
+            val resources = queuedDraws[draw]
+            val geometry = resources.geometry
+
+            val pipeline = resources.pipeline.pipeline
+            if (pipeline !== boundPipeline) {
+                pass.setPipeline(pipeline)
+                boundPipeline = pipeline
+                stats.pipelineSwitches++
             } else {
-                pass.draw(resources.geometry.vertexCount)
+                stats.stateChangesSkipped++
             }
-        }
 
-        points.forEach { pointNode ->
-            val resources = pointsCache[pointNode] ?: return@forEach
-            val worldMatrix = pointNode.getWorldMatrix()
-            val mvp = TMP_MAT.multiply(viewProjection, worldMatrix)
-            resources.uniformBuffer.writeFloats(mvp.toFloatArray(copy = true))
-
-            pass.setPipeline(resources.pipeline.pipeline)
-            pass.setBindGroup(0, resources.bindGroup)
-            pass.setVertexBuffer(0, resources.geometry.vertexBuffer)
-            
-            // When using quad fallback, each point needs 6 vertices (2 triangles)
-            // Otherwise, use native point primitives with 1 vertex per point
-            val verticesPerPoint = if (UnlitPipelineFactory.useQuadPointsFallback) {
-                UnlitPipelineFactory.VERTICES_PER_QUAD_POINT
+            dynamicOffset[0] = queuedOffsets[draw]
+            pass.setBindGroup(0, uniformBindGroup(resources.pipeline, uniforms), dynamicOffset)
+
+            if (geometry.vertexBuffer !== boundVertexBuffer) {
+                pass.setVertexBuffer(0, geometry.vertexBuffer)
+                boundVertexBuffer = geometry.vertexBuffer
+                stats.vertexBufferBinds++
             } else {
-                1
+                stats.stateChangesSkipped++
             }
-            pass.draw(verticesPerPoint, resources.instanceCount)
+
+            when (resources) {
+                is MeshResources -> {
+                    val indexBuffer = geometry.indexBuffer
+                    val indexCount = geometry.indexCount
+                    val indexFormat = geometry.indexFormat
+
+                    if (indexBuffer != null && indexCount != null && indexCount > 0 && indexFormat != null) {
+                        if (indexBuffer !== boundIndexBuffer) {
+                            pass.setIndexBuffer(indexBuffer, indexFormat, 0L)
+                            boundIndexBuffer = indexBuffer
+                            stats.indexBufferBinds++
+                        } else {
+                            stats.stateChangesSkipped++
+                        }
+                        val slot = queuedIndirect[draw]
+                        if (indirectArgs != null && slot >= 0) {
+                            pass.drawIndexedIndirect(indirectArgs, slot * OcclusionCullPass.ARGS_STRIDE_BYTES.toLong())
+                            stats.occlusionTested++
+                        } else {
+                            pass.drawIndexed(indexCount)
+                        }
+                    } else {
+                        pass.draw(geometry.vertexCount)
+                    }
+                }
+
+                is PointsResources -> {
+                    // When using quad fallback, each point needs 6 vertices (2 triangles)
+                    // Otherwise, use native point primitives with 1 vertex per point
+                    val verticesPerPoint = if (UnlitPipelineFactory.useQuadPointsFallback) {
+                        UnlitPipelineFactory.VERTICES_PER_QUAD_POINT
+                    } else {
+                        1
+                    }
+                    pass.draw(verticesPerPoint, resources.instanceCount)
+                }
+            }
+            stats.drawCalls++
+        }
+
+        val used = drawUniforms.frameUsed
+        if (used > 0) {
+            val start = drawUniforms.frameStart
+            uniforms.writeFloats(
+                drawUniforms.backingArray(),
+                offset = start * Float.SIZE_BYTES,
+                dataOffset = start,
+                count = used
+            )
         }
     }
 
+    /**
+     * Groups batchable static meshes by pipeline and rebuilds every batch whose members
+     * changed. Groups below [MIN_BATCH_SIZE] are drawn individually.
+     */
+    private fun prepareStaticBatches(meshes: Collection<Mesh>) {
+        if (isGroupingCurrent(meshes)) return
+        groupedMeshes.clear()
+        meshes.forEach { groupedMeshes.add(GroupedMesh(it)) }
+
+        val groups = LinkedHashMap<PipelineKey, MutableList<Mesh>>()
+        meshes.forEach { mesh ->
+            if (!mesh.isStatic || !StaticBatch.isBatchable(mesh)) return@forEach
+            val blueprint = mesh.material.toBindingBlueprint()
+            if (blueprint is MaterialBindingBlueprint.UnlitPoints) return@forEach
+            if (blueprint.renderState.blendMode != BlendMode.Opaque) return@forEach
+            val key = PipelineKey(
+                blueprint::class,
+                blueprint.renderState,
+                colorFormat,
+                depthFormat,
+                batched = true
+            )
+            groups.getOrPut(key) { ArrayList() }.add(mesh)
+        }
+
+        val viewBuffer = if (groups.isNotEmpty()) ensureBatchViewBuffer() else null
+        staticBatches.keys.toList().forEach { key ->
+            val members = groups[key]
+            val existing = staticBatches.getValue(key)
+            if (members == null || members.size < MIN_BATCH_SIZE || !existing.matches(members)) {
+                existing.dispose()
+                staticBatches.remove(key)
+            }
+        }
+        batchOf.clear()
+        groups.forEach { (key, members) ->
+            if (members.size < MIN_BATCH_SIZE || viewBuffer == null) return@forEach
+            val batch = staticBatches.getOrPut(key) {
+                val pipeline = pipelineCache.getOrPut(key) {
+                    UnlitPipelineFactory.createBatchedUnlitColorPipeline(
+                        device,
+                        colorFormat,
+                        key.renderState,
+                        members.first().material.toBindingBlueprint().primitiveTopology,
+                        depthFormat
+                    ).also { created -> pipelineIds[created] = pipelineIds.size }
+                }
+                StaticBatch(device, pipeline, members.toList(), viewBuffer)
+            }
+            members.forEach { batchOf[it] = batch }
+        }
+    }
+
+    /** True when [meshes] are the meshes, materials and geometries the batches were grouped from. */
+    private fun isGroupingCurrent(meshes: Collection<Mesh>): Boolean {
+        if (meshes.size != groupedMeshes.size) return false
+        var index = 0
+        for (mesh in meshes) {
+            if (!groupedMeshes[index++].isCurrent(mesh)) return false
+        }
+        return true
+    }
+
+    /**
+     * Uploads the view-projection and changed member transforms, then draws every batch
+     * with a visible member. Batches are opaque, so they go ahead of the sorted queue.
+     */
+    private fun recordStaticBatches(pass: GpuRenderPassEncoder, viewProjection: Mat4) {
+        batchViewBuffer?.writeFloats(viewProjection.toFloatArray())
+        staticBatches.values.forEach { batch ->
+            batch.updateTransforms()
+            val drawn = batch.draw(pass)
+            if (drawn > 0) {
+                stats.drawCalls++
+                stats.pipelineSwitches++
+                stats.vertexBufferBinds++
+                stats.indexBufferBinds++
+                stats.batchedMeshes += drawn
+            }
+        }
+    }
+
+    private fun ensureBatchViewBuffer(): GpuBuffer = batchViewBuffer ?: device.createBuffer(
+        GpuBufferDescriptor(
+            label = "static-batch-view",
+            size = UnlitPipelineFactory.UNIFORM_BINDING_SIZE,
+            usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
+        )
+    ).also { batchViewBuffer = it }
+
+    /**
+     * Packs the draw's matrix into the uniform ring and queues it under its sort key.
+     * Depth is the clip-space w of the object's origin, i.e. its view-space distance.
+     * [indirectSlot] is the draw's occlusion record, or -1 to draw directly.
+     */
+    private fun enqueue(resources: DrawResources, material: Material, mvp: Mat4, indirectSlot: Int) {
+        val draw = queuedDraws.size
+        queuedDraws.add(resources)
+        if (draw == queuedOffsets.size) {
+            queuedOffsets = queuedOffsets.copyOf(draw * 2)
+            queuedIndirect = queuedIndirect.copyOf(draw * 2)
+        }
+        queuedOffsets[draw] = drawUniforms.push(mvp)
+        queuedIndirect[draw] = indirectSlot
+
+        val pipelineId = resources.pipelineId
+        val materialId = material.hashCode()
+        val geometryId = resources.geometry.vertexBuffer.hashCode()
+        val depth = mvp[15]
+        val key = if (resources.blueprint.renderState.blendMode == BlendMode.Opaque) {
+            RenderQueue.opaqueKey(pipelineId, materialId, geometryId, depth)
+        } else {
+            RenderQueue.transparentKey(pipelineId, materialId, geometryId, depth)
+        }
+        renderQueue.add(key, draw)
+    }
+
     /**
      * Releases all GPU resources held by this renderer.
      *
      * After calling dispose, the renderer should not be used.
      */
     fun dispose() {
-        meshCache.values.forEach { it.uniformBuffer.destroy() }
-        pointsCache.values.forEach { it.uniformBuffer.destroy() }
-        geometryCache.values.forEach { it.destroy() }
+        occlusionPass?.dispose()
+        occlusionPass = null
+        occlusionMeshes = null
+        staticBatches.values.forEach { it.dispose() }
+        staticBatches.clear()
+        batchOf.clear()
+        groupedMeshes.clear()
+        batchViewBuffer?.destroy()
+        batchViewBuffer = null
+        uniformBuffer?.destroy()
+        uniformBuffer = null
+        uniformBufferVersion = -1
+        uniformBindGroups.clear()
+        geometryCache.forEach { (key, geometry) ->
+            residency?.unregister(key)
+            geometry.destroy()
+        }
         pointsCache.clear()
         meshCache.clear()
         geometryCache.clear()
         pipelineCache.clear()
+        pipelineIds.clear()
+        queuedDraws.clear()
     }
 
     private fun ensureMeshResources(mesh: Mesh): MeshResources {
@@ -168,8 +468,7 @@ class SceneRenderer(
             ) {
                 return existing
             } else {
-                existing.dispose()
-                geometryCache.remove(existing.sourceGeometry)?.destroy()
+                releaseGeometry(existing.sourceGeometry)
                 meshCache.remove(mesh)
             }
         }
@@ -181,27 +480,21 @@ class SceneRenderer(
                 depthFormat
             )
         ) {
-            blueprint.createPipeline(device, colorFormat, depthFormat)
+            blueprint.createPipeline(device, colorFormat, depthFormat).also { created ->
+                pipelineIds[created] = pipelineIds.size
+            }
         }
-        val geometry = geometryCache.getOrPut(mesh.geometry) {
+        val geometry = residentGeometry(mesh.geometry) {
             geometryUploader.upload(mesh.geometry, mesh.name)
         }
-        val uniformBuffer = device.createBuffer(
-            GpuBufferDescriptor(
-                label = "${mesh.name}-uniforms",
-                size = Float.SIZE_BYTES * 16L,
-                usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
-            )
-        )
-        val bindGroup = UnlitPipelineFactory.createUniformBindGroup(
-            device = device,
-            layout = pipeline.bindGroupLayout,
-            uniformBuffer = uniformBuffer,
-            label = "${mesh.name}-bind-group"
-        )
 
-        val resources =
-            MeshResources(mesh.geometry, pipeline, geometry, uniformBuffer, bindGroup, blueprint)
+        val resources = MeshResources(
+            mesh.geometry,
+            pipeline,
+            pipelineIds.getValue(pipeline),
+            geometry,
+            blueprint
+        )
         meshCache[mesh] = resources
         return resources
     }
@@ -216,7 +509,7 @@ class SceneRenderer(
                 return existing
             } else {
                 existing.dispose()
-                geometryCache.remove(existing.sourceNode)?.destroy()
+                releaseGeometry(existing.sourceNode)
                 pointsCache.remove(node)
             }
         }
@@ -233,35 +526,22 @@ class SceneRenderer(
                 depthFormat
             )
         ) {
-            blueprint.createPipeline(device, colorFormat, depthFormat)
+            blueprint.createPipeline(device, colorFormat, depthFormat).also { created ->
+                pipelineIds[created] = pipelineIds.size
+            }
         }
 
-        val geometry = geometryCache.getOrPut(node) {
+        val geometry = residentGeometry(node) {
             val geometry = buildInstancedPointsGeometry(node)
             geometryUploader.upload(geometry, node.name)
         }
 
-        val uniformBuffer = device.createBuffer(
-            GpuBufferDescriptor(
-                label = "${node.name}-uniforms",
-                size = Float.SIZE_BYTES * 16L,
-                usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
-            )
-        )
-        val bindGroup = UnlitPipelineFactory.createUniformBindGroup(
-            device = device,
-            layout = pipeline.bindGroupLayout,
-            uniformBuffer = uniformBuffer,
-            label = "${node.name}-bind-group"
-        )
-
         val instanceCount = node.instanceData.size / node.componentsPerInstance
         val resources = PointsResources(
             node,
             pipeline,
+            pipelineIds.getValue(pipeline),
             geometry,
-            uniformBuffer,
-            bindGroup,
             blueprint,
             instanceCount
         )
@@ -269,43 +549,121 @@ class SceneRenderer(
         return resources
     }
 
-    private data class MeshResources(
-        val sourceGeometry: Geometry,
-        val pipeline: UnlitPipelineFactory.PipelineResources,
-        val geometry: UploadedGeometry,
-        val uniformBuffer: io.materia.gpu.GpuBuffer,
-        val bindGroup: io.materia.gpu.GpuBindGroup,
-        val blueprint: MaterialBindingBlueprint
-    ) {
-        fun dispose() {
-            uniformBuffer.destroy()
+    /** Cached upload for [key], uploading and registering it with [residency] on a miss. */
+    private inline fun residentGeometry(key: Any, upload: () -> UploadedGeometry): UploadedGeometry {
+        geometryCache[key]?.let { return it }
+        val uploaded = upload()
+        geometryCache[key] = uploaded
+        residency?.register(key, MemoryAllocationType.GEOMETRY, uploaded.sizeBytes) { evictGeometry(key) }
+        return uploaded
+    }
+
+    private fun releaseGeometry(key: Any) {
+        geometryCache.remove(key)?.let { geometry ->
+            residency?.unregister(key)
+            geometry.destroy()
         }
     }
 
+    /** Eviction callback: drops the buffers and every cached renderable drawing them. */
+    private fun evictGeometry(key: Any) {
+        geometryCache.remove(key)?.destroy()
+        meshCache.values.removeAll { it.sourceGeometry === key }
+        if (key is InstancedPoints) pointsCache.remove(key)
+    }
+
+    private sealed interface DrawResources {
+        val pipeline: UnlitPipelineFactory.PipelineResources
+        val pipelineId: Int
+        val geometry: UploadedGeometry
+        val blueprint: MaterialBindingBlueprint
+    }
+
+    private data class MeshResources(
+        val sourceGeometry: Geometry,
+        override val pipeline: UnlitPipelineFactory.PipelineResources,
+        override val pipelineId: Int,
+        override val geometry: UploadedGeometry,
+        override val blueprint: MaterialBindingBlueprint
+    ) : DrawResources
+
     private data class PointsResources(
         val sourceNode: InstancedPoints,
-        val pipeline: UnlitPipelineFactory.PipelineResources,
-        val geometry: UploadedGeometry,
-        val uniformBuffer: io.materia.gpu.GpuBuffer,
-        val bindGroup: io.materia.gpu.GpuBindGroup,
-        val blueprint: MaterialBindingBlueprint,
+        override val pipeline: UnlitPipelineFactory.PipelineResources,
+        override val pipelineId: Int,
+        override val geometry: UploadedGeometry,
+        override val blueprint: MaterialBindingBlueprint,
         val instanceCount: Int
-    ) {
+    ) : DrawResources {
         fun dispose() {
-            uniformBuffer.destroy()
             geometry.destroy()
         }
     }
 
+    /**
+     * Returns the shared uniform buffer, recreating it (and dropping bind groups that
+     * reference the old one) when [drawUniforms] has grown.
+     */
+    private fun ensureUniformBuffer(): GpuBuffer {
+        val current = uniformBuffer
+        if (current != null && uniformBufferVersion == drawUniforms.storageVersion) {
+            return current
+        }
+        current?.destroy()
+        uniformBindGroups.clear()
+        val buffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "scene-draw-uniforms",
+                size = drawUniforms.sizeBytes,
+                usage = gpuBufferUsage(GpuBufferUsage.UNIFORM, GpuBufferUsage.COPY_DST)
+            )
+        )
+        uniformBuffer = buffer
+        uniformBufferVersion = drawUniforms.storageVersion
+        return buffer
+    }
+
+    private fun uniformBindGroup(
+        pipeline: UnlitPipelineFactory.PipelineResources,
+        buffer: GpuBuffer
+    ): GpuBindGroup = uniformBindGroups.getOrPut(pipeline.bindGroupLayout) {
+        UnlitPipelineFactory.createUniformBindGroup(
+            device = device,
+            layout = pipeline.bindGroupLayout,
+            uniformBuffer = buffer,
+            label = "scene-draw-uniforms-bind-group"
+        )
+    }
+
+    /**
+     * What static grouping read from a mesh. Materials are immutable, so the same material
+     * instance always maps to the same pipeline key.
+     */
+    private class GroupedMesh(val mesh: Mesh) {
+        private val material = mesh.material
+        private val geometry = mesh.geometry
+        private val isStatic = mesh.isStatic
+
+        fun isCurrent(candidate: Mesh): Boolean =
+            candidate === mesh &&
+                candidate.material === material &&
+                candidate.geometry === geometry &&
+                candidate.isStatic == isStatic
+    }
+
     private data class PipelineKey(
         val type: KClass<out MaterialBindingBlueprint>,
         val renderState: RenderState,
         val colorFormat: GpuTextureFormat,
-        val depthFormat: GpuTextureFormat?
+        val depthFormat: GpuTextureFormat?,
+        val batched: Boolean = false
     )
 
     private companion object {
         private val TMP_MAT = mat4()
+
+        /** Fewer static meshes than this in a pipeline are cheaper to draw directly. */
+        private const val MIN_BATCH_SIZE = 2
     }
 
     private fun buildInstancedPointsGeometry(node: InstancedPoints): Geometry {
@@ -0,0 +1,275 @@
+package io.materia.engine.render
+
+import io.materia.engine.scene.Mesh
+import io.materia.gpu.GpuBindGroup
+import io.materia.gpu.GpuBindGroupDescriptor
+import io.materia.gpu.GpuBindGroupEntry
+import io.materia.gpu.GpuBindingResource
+import io.materia.gpu.GpuBuffer
+import io.materia.gpu.GpuBufferDescriptor
+import io.materia.gpu.GpuBufferUsage
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuIndexFormat
+import io.materia.gpu.GpuRenderPassEncoder
+import io.materia.gpu.INDEXED_INDIRECT_STRIDE
+import io.materia.gpu.gpuBufferUsage
+
+/**
+ * Static meshes sharing one pipeline, packed into shared buffers and drawn with one
+ * multi-draw.
+ *
+ * Every member's vertices are copied into one vertex buffer with the member index appended
+ * to each vertex as a u32, and its indices into one index buffer, 32-bit when any member
+ * needs them. The vertex shader
+ * reads the member's model matrix from a read-only storage buffer by that index, so the
+ * whole batch binds one pipeline, one bind group, one vertex and one index buffer. Each
+ * member owns a `drawIndexedIndirect` record locating its index range; [markVisible]
+ * decides the record's instance count, which keeps frustum culling per member.
+ *
+ * The member index travels in the vertex data rather than `instance_index` because a
+ * non-zero `firstInstance` in indirect draws needs the optional `indirect-first-instance`
+ * WebGPU feature.
+ *
+ * Membership is fixed; [SceneRenderer] builds a new batch when it changes. Member
+ * transforms may still change and are re-uploaded by [updateTransforms].
+ *
+ * @param viewBuffer Uniform buffer holding the frame's view-projection matrix.
+ */
+internal class StaticBatch(
+    device: GpuDevice,
+    val pipeline: UnlitPipelineFactory.PipelineResources,
+    val members: List<Mesh>,
+    viewBuffer: GpuBuffer
+) {
+    init {
+        require(members.isNotEmpty()) { "A static batch needs at least one member" }
+    }
+
+    private val memberIndex = HashMap<Mesh, Int>(members.size * 2)
+    private val geometries = members.map { it.geometry }
+    private val indexCounts = IntArray(members.size)
+    private val firstIndices = IntArray(members.size)
+    private val baseVertices = IntArray(members.size)
+
+    private val modelVersions = LongArray(members.size) { -1L }
+    private val args = FloatArray(members.size * ARGS_FLOATS)
+    private val visible = BooleanArray(members.size)
+    private val uploadedVisible = BooleanArray(members.size)
+    private var argsUploaded = false
+
+    private val vertexBuffer: GpuBuffer
+    private val indexBuffer: GpuBuffer
+    private val indexFormat: GpuIndexFormat
+    private val modelBuffer: GpuBuffer
+    private val argsBuffer: GpuBuffer
+    private val bindGroup: GpuBindGroup
+
+    /** Members marked visible since the last [beginFrame]. */
+    var visibleCount: Int = 0
+        private set
+
+    init {
+        var vertexCount = 0
+        var indexCount = 0
+        members.forEachIndexed { i, mesh ->
+            memberIndex[mesh] = i
+            val geometry = mesh.geometry
+            require(geometry.isIndexed) { "Static batch members must be indexed" }
+            require(isBatchable(mesh)) { "Mesh '${mesh.name}' cannot join a static batch" }
+            firstIndices[i] = indexCount
+            baseVertices[i] = vertexCount
+            indexCounts[i] = geometry.indexCount
+            indexCount += geometry.indexCount
+            vertexCount += geometry.vertexBuffer.data.size / SOURCE_VERTEX_FLOATS
+        }
+
+        val vertices = FloatArray(vertexCount * BATCH_VERTEX_FLOATS)
+        var writeOffset = 0
+        members.forEachIndexed { i, mesh ->
+            val source = mesh.geometry.vertexBuffer.data
+            val id = Float.fromBits(i)
+            var readOffset = 0
+            while (readOffset + SOURCE_VERTEX_FLOATS <= source.size) {
+                source.copyInto(vertices, writeOffset, readOffset, readOffset + SOURCE_VERTEX_FLOATS)
+                vertices[writeOffset + SOURCE_VERTEX_FLOATS] = id
+                readOffset += SOURCE_VERTEX_FLOATS
+                writeOffset += BATCH_VERTEX_FLOATS
+            }
+        }
+
+        // Members index their own vertices through baseVertex, so one wide member widens all
+        indexFormat = if (geometries.any { it.requires32BitIndices }) GpuIndexFormat.UINT32 else GpuIndexFormat.UINT16
+        val indexWidth = if (indexFormat == GpuIndexFormat.UINT32) Int.SIZE_BYTES else Short.SIZE_BYTES
+
+        // Index buffer writes must be a multiple of four bytes
+        val indexBytes = ByteArray(((indexCount * indexWidth) + 3) and 3.inv())
+        var byte = 0
+        for (geometry in geometries) {
+            byte = writeIndices(geometry, indexFormat, indexBytes, byte)
+        }
+
+        vertexBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "static-batch-vertices",
+                size = vertices.size * Float.SIZE_BYTES.toLong(),
+                usage = gpuBufferUsage(GpuBufferUsage.VERTEX, GpuBufferUsage.COPY_DST)
+            )
+        )
+        vertexBuffer.writeFloats(vertices)
+        indexBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "static-batch-indices",
+                size = indexBytes.size.toLong(),
+                usage = gpuBufferUsage(GpuBufferUsage.INDEX, GpuBufferUsage.COPY_DST)
+            )
+        )
+        indexBuffer.write(indexBytes)
+        modelBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "static-batch-models",
+                size = members.size * MATRIX_FLOATS * Float.SIZE_BYTES.toLong(),
+                usage = gpuBufferUsage(GpuBufferUsage.STORAGE, GpuBufferUsage.COPY_DST)
+            )
+        )
+        argsBuffer = device.createBuffer(
+            GpuBufferDescriptor(
+                label = "static-batch-args",
+                size = members.size * INDEXED_INDIRECT_STRIDE,
+                usage = gpuBufferUsage(GpuBufferUsage.INDIRECT, GpuBufferUsage.COPY_DST)
+            )
+        )
+        for (i in members.indices) {
+            writeArgs(args, i, indexCounts[i], firstIndices[i], baseVertices[i], visible = false)
+        }
+
+        bindGroup = device.createBindGroup(
+            GpuBindGroupDescriptor(
+                label = "static-batch-bind-group",
+                layout = pipeline.bindGroupLayout,
+                entries = listOf(
+                    GpuBindGroupEntry(0, GpuBindingResource.Buffer(viewBuffer)),
+                    GpuBindGroupEntry(1, GpuBindingResource.Buffer(modelBuffer))
+                )
+            )
+        )
+    }
+
+    /** True when [meshes] are exactly this batch's members with the same geometry. */
+    fun matches(meshes: List<Mesh>): Boolean {
+        if (meshes.size != members.size) return false
+        for (i in meshes.indices) {
+            if (meshes[i] !== members[i] || meshes[i].geometry !== geometries[i]) return false
+        }
+        return true
+    }
+
+    fun beginFrame() {
+        visible.fill(false)
+        visibleCount = 0
+    }
+
+    /** Draws [mesh] this frame. Returns false when it is not a member. */
+    fun markVisible(mesh: Mesh): Boolean {
+        val index = memberIndex[mesh] ?: return false
+        if (!visible[index]) {
+            visible[index] = true
+            visibleCount++
+        }
+        return true
+    }
+
+    /** Uploads the model matrices of members whose world matrix changed. */
+    fun updateTransforms() {
+        for (i in members.indices) {
+            val mesh = members[i]
+            if (modelVersions[i] == mesh.worldMatrixVersion) continue
+            modelVersions[i] = mesh.worldMatrixVersion
+            // Uploads straight from the world matrix's backing array
+            modelBuffer.writeFloats(
+                mesh.getWorldMatrix().toFloatArray(),
+                offset = i * MATRIX_FLOATS * Float.SIZE_BYTES,
+                count = MATRIX_FLOATS
+            )
+        }
+    }
+
+    /**
+     * Records the batch into [pass] when any member is visible.
+     *
+     * @return The number of members drawn.
+     */
+    fun draw(pass: GpuRenderPassEncoder): Int {
+        if (visibleCount == 0) return 0
+        uploadVisibility()
+        pass.setPipeline(pipeline.pipeline)
+        pass.setBindGroup(0, bindGroup)
+        pass.setVertexBuffer(0, vertexBuffer)
+        pass.setIndexBuffer(indexBuffer, indexFormat, 0L)
+        pass.multiDrawIndexedIndirect(argsBuffer, members.size)
+        return visibleCount
+    }
+
+    fun dispose() {
+        vertexBuffer.destroy()
+        indexBuffer.destroy()
+        modelBuffer.destroy()
+        argsBuffer.destroy()
+    }
+
+    // Rewrites the arguments only when visibility changed since the last upload
+    private fun uploadVisibility() {
+        if (argsUploaded && visible.contentEquals(uploadedVisible)) return
+        for (i in members.indices) {
+            args[i * ARGS_FLOATS + 1] = Float.fromBits(if (visible[i]) 1 else 0)
+        }
+        argsBuffer.writeFloats(args)
+        visible.copyInto(uploadedVisible)
+        argsUploaded = true
+    }
+
+    companion object {
+        private const val MATRIX_FLOATS = 16
+        const val ARGS_FLOATS = (INDEXED_INDIRECT_STRIDE / Float.SIZE_BYTES).toInt()
+
+        /** Floats per source vertex: position + color, the unlit vertex layout. */
+        const val SOURCE_VERTEX_FLOATS = 6
+
+        /** Floats per batched vertex: the source vertex plus the member index bits. */
+        const val BATCH_VERTEX_FLOATS = SOURCE_VERTEX_FLOATS + 1
+
+        /**
+         * Whether [mesh]'s geometry can be packed: indexed, in the unlit position + color
+         * layout the batched pipeline reads.
+         */
+        fun isBatchable(mesh: Mesh): Boolean {
+            val geometry = mesh.geometry
+            if (!geometry.isIndexed) return false
+            val stride = if (geometry.vertexBuffer.strideBytes > 0) {
+                geometry.vertexBuffer.strideBytes
+            } else {
+                geometry.layout.stride
+            }
+            return geometry.indexCount > 0 && stride == SOURCE_VERTEX_FLOATS * Float.SIZE_BYTES
+        }
+
+        /**
+         * Writes one `drawIndexedIndirect` record as raw bits, the same packing the
+         * occlusion pass uses, so the whole argument array is one float upload.
+         */
+        fun writeArgs(
+            out: FloatArray,
+            slot: Int,
+            indexCount: Int,
+            firstIndex: Int,
+            baseVertex: Int,
+            visible: Boolean
+        ) {
+            val base = slot * ARGS_FLOATS
+            out[base] = Float.fromBits(indexCount)
+            out[base + 1] = Float.fromBits(if (visible) 1 else 0)
+            out[base + 2] = Float.fromBits(firstIndex)
+            out[base + 3] = Float.fromBits(baseVertex)
+            out[base + 4] = 0f
+        }
+    }
+}
@@ -0,0 +1,77 @@
+package io.materia.engine.render
+
+import io.materia.gpu.GpuDevice
+import io.materia.gpu.GpuTexture
+import io.materia.gpu.GpuTextureDescriptor
+import io.materia.gpu.GpuTextureDimension
+import io.materia.gpu.GpuTextureView
+
+/**
+ * Backs the physical slots of a [CompiledRenderGraph] with GPU textures kept across frames.
+ *
+ * [acquire] hands out a texture matching the slot description, reusing one from earlier
+ * frames when available. Textures not acquired for [maxIdleFrames] frames, for example
+ * after a resize, are destroyed in [endFrame] so sizes that are gone stop holding memory.
+ */
+internal class TransientTexturePool(
+    private val device: GpuDevice,
+    private val maxIdleFrames: Int = 2
+) {
+    private class Entry(val texture: GpuTexture, val view: GpuTextureView) {
+        var lastUsedFrame = 0L
+        var inUse = false
+    }
+
+    private val entries = HashMap<RenderGraphResolvedDesc, MutableList<Entry>>()
+    private var frame = 0L
+
+    /** Number of textures currently owned by the pool. */
+    val size: Int get() = entries.values.sumOf { it.size }
+
+    /** Returns one view per slot of [graph], in slot order. */
+    fun acquire(graph: CompiledRenderGraph): List<GpuTextureView> = graph.slots.mapIndexed { index, desc ->
+        acquire(desc, "render-graph-slot-$index")
+    }
+
+    fun acquire(desc: RenderGraphResolvedDesc, label: String): GpuTextureView {
+        val candidates = entries.getOrPut(desc) { mutableListOf() }
+        val entry = candidates.firstOrNull { !it.inUse } ?: run {
+            val texture = device.createTexture(
+                GpuTextureDescriptor(
+                    label = label,
+                    size = Triple(desc.width, desc.height, 1),
+                    mipLevelCount = desc.mipLevelCount,
+                    sampleCount = 1,
+                    dimension = GpuTextureDimension.D2,
+                    format = desc.format,
+                    usage = desc.usage
+                )
+            )
+            Entry(texture, texture.createView()).also(candidates::add)
+        }
+        entry.inUse = true
+        entry.lastUsedFrame = frame
+        return entry.view
+    }
+
+    /** Returns every texture to the pool and destroys those idle for too long. */
+    fun endFrame() {
+        val iterator = entries.values.iterator()
+        while (iterator.hasNext()) {
+            val list = iterator.next()
+            list.removeAll { entry ->
+                entry.inUse = false
+                val stale = frame - entry.lastUsedFrame >= maxIdleFrames
+                if (stale) entry.texture.destroy()
+                stale
+            }
+            if (list.isEmpty()) iterator.remove()
+        }
+        frame++
+    }
+
+    fun dispose() {
+        entries.values.forEach { list -> list.forEach { it.texture.destroy() } }
+        entries.clear()
+    }
+}
@@ -96,6 +96,69 @@ object UnlitPipelineFactory {
         return PipelineResources(pipeline, layout)
     }
 
+    /**
+     * Create the unlit color pipeline that draws a [StaticBatch].
+     *
+     * Vertices carry their batch member index ([batchedVertexLayout]); the shader reads
+     * the member's model matrix from a read-only storage buffer and the view-projection
+     * from a plain uniform, both in one bind group shared by every member.
+     */
+    internal fun createBatchedUnlitColorPipeline(
+        device: GpuDevice,
+        colorFormat: GpuTextureFormat,
+        renderState: RenderState = RenderState(),
+        primitiveTopology: GpuPrimitiveTopology = GpuPrimitiveTopology.TRIANGLE_LIST,
+        depthFormat: GpuTextureFormat? = null
+    ): PipelineResources {
+        val layout = device.createBindGroupLayout(
+            GpuBindGroupLayoutDescriptor(
+                label = "unlit-color-batched-layout",
+                entries = listOf(
+                    GpuBindGroupLayoutEntry(
+                        binding = 0,
+                        visibility = setOf(GpuShaderStage.VERTEX),
+                        resourceType = GpuBindingResourceType.UNIFORM_BUFFER
+                    ),
+                    GpuBindGroupLayoutEntry(
+                        binding = 1,
+                        visibility = setOf(GpuShaderStage.VERTEX),
+                        resourceType = GpuBindingResourceType.READ_ONLY_STORAGE_BUFFER
+                    )
+                )
+            )
+        )
+        val vertexModule = device.createShaderModule(
+            GpuShaderModuleDescriptor(
+                label = "unlit_color_batched.vert",
+                code = ShaderSource.UNLIT_COLOR_BATCHED_VERT
+            )
+        )
+        val fragmentModule = device.createShaderModule(
+            GpuShaderModuleDescriptor(
+                label = "unlit_color.frag",
+                code = ShaderSource.UNLIT_COLOR_FRAG
+            )
+        )
+
+        val pipeline = device.createRenderPipeline(
+            GpuRenderPipelineDescriptor(
+                label = "unlit-color-batched-pipeline",
+                vertexShader = vertexModule,
+                fragmentShader = fragmentModule,
+                colorFormats = listOf(colorFormat),
+                depthStencilFormat = depthFormat,
+                vertexBuffers = listOf(batchedVertexLayout()),
+                primitiveTopology = primitiveTopology,
+                bindGroupLayouts = listOf(layout),
+                cullMode = renderState.toCullMode(),
+                depthState = renderState.toDepthState(depthFormat),
+                blendMode = renderState.toBlendMode()
+            )
+        )
+
+        return PipelineResources(pipeline, layout)
+    }
+
     /**
      * Create the pipeline used by [io.materia.engine.material.UnlitPointsMaterial].
      * 
@@ -153,9 +216,15 @@ object UnlitPipelineFactory {
         return PipelineResources(pipeline, layout)
     }
 
+    /** Bytes of uniform data each draw reads: one model-view-projection matrix. */
+    const val UNIFORM_BINDING_SIZE: Long = Float.SIZE_BYTES * 16L
+
     /**
-     * Convenience helper to create a bind group referencing a single uniform buffer
-     * that contains the model-view-projection matrix for the current draw.
+     * Convenience helper to create a bind group over a shared uniform buffer.
+     *
+     * The layout's uniform binding uses a dynamic offset, so a single bind group
+     * covers every draw: each draw selects its model-view-projection matrix by
+     * passing the matrix's byte offset to `setBindGroup`.
      */
     fun createUniformBindGroup(
         device: GpuDevice,
@@ -170,7 +239,10 @@ object UnlitPipelineFactory {
                 entries = listOf(
                     GpuBindGroupEntry(
                         binding = 0,
-                        resource = GpuBindingResource.Buffer(uniformBuffer)
+                        resource = GpuBindingResource.Buffer(
+                            buffer = uniformBuffer,
+                            size = UNIFORM_BINDING_SIZE
+                        )
                     )
                 )
             )
@@ -185,7 +257,8 @@ object UnlitPipelineFactory {
                     GpuBindGroupLayoutEntry(
                         binding = 0,
                         visibility = setOf(GpuShaderStage.VERTEX),
-                        resourceType = GpuBindingResourceType.UNIFORM_BUFFER
+                        resourceType = GpuBindingResourceType.UNIFORM_BUFFER,
+                        hasDynamicOffset = true
                     )
                 )
             )
@@ -209,6 +282,30 @@ object UnlitPipelineFactory {
             )
         )
 
+    /** [vertexLayoutWithColor] followed by the u32 batch member index. */
+    internal fun batchedVertexLayout(): GpuVertexBufferLayout =
+        GpuVertexBufferLayout(
+            arrayStride = Float.SIZE_BYTES * StaticBatch.BATCH_VERTEX_FLOATS,
+            stepMode = GpuVertexStepMode.VERTEX,
+            attributes = listOf(
+                GpuVertexAttribute(
+                    shaderLocation = 0,
+                    format = GpuVertexFormat.FLOAT32x3,
+                    offset = 0
+                ),
+                GpuVertexAttribute(
+                    shaderLocation = 1,
+                    format = GpuVertexFormat.FLOAT32x3,
+                    offset = Float.SIZE_BYTES * 3
+                ),
+                GpuVertexAttribute(
+                    shaderLocation = 2,
+                    format = GpuVertexFormat.UINT32,
+                    offset = Float.SIZE_BYTES * 6
+                )
+            )
+        )
+
     internal fun instancedPointsLayout(): GpuVertexBufferLayout =
         GpuVertexBufferLayout(
             arrayStride = Float.SIZE_BYTES * 11,
@@ -262,6 +359,34 @@ private object ShaderSource {
         }
     """.trimIndent()
 
+    val UNLIT_COLOR_BATCHED_VERT = """
+        struct VertexInput {
+            @location(0) position : vec3<f32>,
+            @location(1) color : vec3<f32>,
+            @location(2) memberIndex : u32,
+        };
+
+        struct VertexOutput {
+            @builtin(position) position : vec4<f32>,
+            @location(0) color : vec3<f32>,
+        };
+
+        @group(0) @binding(0)
+        var<uniform> uViewProjection : mat4x4<f32>;
+
+        @group(0) @binding(1)
+        var<storage, read> uModels : array<mat4x4<f32>>;
+
+        @vertex
+        fn main(input : VertexInput) -> VertexOutput {
+            var output : VertexOutput;
+            let world = uModels[input.memberIndex] * vec4<f32>(input.position, 1.0);
+            output.position = uViewProjection * world;
+            output.color = input.color;
+            return output;
+        }
+    """.trimIndent()
+
     val UNLIT_COLOR_FRAG = """
         struct FragmentInput {
             @location(0) color : vec3<f32>,
@@ -309,7 +309,7 @@ class WebGPURenderer(
         camera.updateProjectionMatrix()
 
         // Update scene matrices
-        scene.updateMatrixWorld(true)
+        scene.updateMatrixWorld()
 
         // Update frame uniforms
         updateCameraUniforms(camera)
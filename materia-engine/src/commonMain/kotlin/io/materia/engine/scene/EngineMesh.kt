@@ -58,6 +58,7 @@ class EngineMesh(
     // GPU buffers (created lazily)
     private var _vertexBuffer: GpuBuffer? = null
     private var _indexBuffer: GpuBuffer? = null
+    private var _indexFormat: GpuIndexFormat = GpuIndexFormat.UINT16
     private var _uniformBuffer: GpuBuffer? = null
     private var _bindGroup: GpuBindGroup? = null
 
@@ -247,7 +248,9 @@ class EngineMesh(
 
         // Convert to bytes (uint16 or uint32)
         val useUint32 = indexData.any { it > 65535 }
-        val byteSize = if (useUint32) indexCount * 4 else indexCount * 2
+        _indexFormat = if (useUint32) GpuIndexFormat.UINT32 else GpuIndexFormat.UINT16
+        // Buffer writes must be a multiple of four bytes
+        val byteSize = if (useUint32) indexCount * 4 else (indexCount * 2 + 3) and 3.inv()
 
         val bytes = ByteArray(byteSize)
         if (useUint32) {
@@ -350,11 +353,9 @@ class EngineMesh(
         get() = geometry.index != null
 
     /**
-     * Gets the index format for this mesh.
+     * Gets the index format for this mesh: UINT32 when an index exceeds 65535, as chosen
+     * when the index buffer was last created.
      */
     val indexFormat: GpuIndexFormat
-        get() {
-            val index = geometry.index ?: return GpuIndexFormat.UINT16
-            return if (index.count > 65535) GpuIndexFormat.UINT32 else GpuIndexFormat.UINT16
-        }
+        get() = _indexFormat
 }
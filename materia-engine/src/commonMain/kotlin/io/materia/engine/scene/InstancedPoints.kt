@@ -25,6 +25,20 @@ class InstancedPoints(
     var material: UnlitPointsMaterial
 ) : Node(name) {
 
+    /**
+     * Incremented by [updateInstance] and [markInstancesChanged]; caches derived from
+     * [instanceData] (bounds, GPU copies) compare it to detect edits.
+     */
+    var instanceVersion: Int = 0
+        private set
+
+    /**
+     * Records that [instanceData] was modified directly rather than via [updateInstance].
+     */
+    fun markInstancesChanged() {
+        instanceVersion++
+    }
+
     /**
      * Returns the number of point instances.
      */
@@ -63,6 +77,7 @@ class InstancedPoints(
         instanceData[base + 8] = extra.y
         instanceData[base + 9] = extra.z
         instanceData[base + 10] = extra.w
+        instanceVersion++
     }
 
     fun updateMaterial(newMaterial: UnlitPointsMaterial) {
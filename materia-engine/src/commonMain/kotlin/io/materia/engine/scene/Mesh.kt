@@ -71,7 +71,8 @@ open class Mesh(
          * @param normals Optional flat array of XYZ normals.
          * @param uvs Optional flat array of UV coordinates.
          * @param colors Optional flat array of RGB vertex colors.
-         * @param indices Optional index array for indexed drawing.
+         * @param indices Optional 16-bit index array for indexed drawing.
+         * @param indices32 Optional 32-bit index array, for meshes past 65,535 vertices.
          * @param material Material to apply, defaults to white unlit.
          * @return A new mesh with interleaved geometry.
          */
@@ -82,6 +83,7 @@ open class Mesh(
             uvs: FloatArray? = null,
             colors: FloatArray? = null,
             indices: ShortArray? = null,
+            indices32: IntArray? = null,
             material: Material = UnlitColorMaterial(
                 label = name,
                 color = Color.White
@@ -93,7 +95,8 @@ open class Mesh(
                     normals = normals,
                     uvs = uvs,
                     colors = colors,
-                    indices = indices
+                    indices = indices,
+                    indices32 = indices32
                 )
             )
             return Mesh(name, geometry, material)
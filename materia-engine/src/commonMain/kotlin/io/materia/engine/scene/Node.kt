@@ -23,9 +23,42 @@ open class Node(
     /** Local transformation relative to the parent node. */
     val transform: Transform = Transform()
     private val worldMatrix: Mat4 = mat4().setIdentity()
-    private val tmpMatrix: Mat4 = mat4()
     private var worldMatrixDirty: Boolean = true
 
+    // Parent's worldMatrixVersion when this node's world matrix was last computed
+    private var parentVersionSeen: Long = -1L
+
+    // Set on a node when it or a descendant was invalidated since the last update
+    private var subtreeDirty: Boolean = true
+
+    // Non-static nodes in this subtree, including this one
+    private var dynamicNodeCount: Int = 1
+
+    /**
+     * Incremented every time the world matrix is recomputed.
+     *
+     * Caches derived from the world matrix (such as world-space bounds) can store
+     * this value and compare it instead of the matrix itself.
+     */
+    var worldMatrixVersion: Long = 0L
+        private set
+
+    /**
+     * Declares the local transform as unchanging.
+     *
+     * Static nodes skip the per-frame check for direct writes to the transform's
+     * vectors; only [Transform.setPosition]-style setters and [Transform.markDirty]
+     * invalidate them. A subtree made only of static nodes is skipped entirely by
+     * [updateWorldMatrix] until something in it is invalidated or its parent moves.
+     */
+    var isStatic: Boolean = false
+        set(value) {
+            if (field == value) return
+            field = value
+            adjustDynamicCount(if (value) -1 else 1)
+            markWorldMatrixDirty()
+        }
+
     /**
      * The parent node in the scene hierarchy, or null for root nodes.
      * Set automatically when added to or removed from another node.
@@ -55,6 +88,8 @@ open class Node(
         child.parent?.remove(child)
         child.parent = this
         _children += child
+        adjustDynamicCount(child.dynamicNodeCount)
+        child.parentVersionSeen = -1L
         child.markWorldMatrixDirty()
     }
 
@@ -66,32 +101,46 @@ open class Node(
     fun remove(child: Node) {
         if (_children.remove(child)) {
             child.parent = null
+            adjustDynamicCount(-child.dynamicNodeCount)
+            child.parentVersionSeen = -1L
+            child.markWorldMatrixDirty()
         }
     }
 
     /**
-     * Recursively updates world matrices for this node and all descendants.
+     * Updates world matrices for this node and every descendant that needs it.
      *
-     * @param force If true, forces recalculation even if not marked dirty.
+     * A node is recomputed when its transform changed or its parent's world matrix
+     * did ([worldMatrixVersion] moved past the value the node last saw). Subtrees
+     * made only of [isStatic] nodes that have not been invalidated are not visited,
+     * so a mostly static scene costs time proportional to what actually moved.
+     *
+     * @param force If true, recomputes this node and all descendants unconditionally.
      */
     open fun updateWorldMatrix(force: Boolean = false) {
-        val parentMatrix = parent?.getWorldMatrix()
-        val localDirty = transform.isDirty()
-        val needsUpdate = force || worldMatrixDirty || localDirty
-        val localMatrix = transform.matrix()
-
-        if (needsUpdate) {
-            if (parentMatrix != null) {
-                tmpMatrix.multiply(parentMatrix, localMatrix)
-                worldMatrix.copyFrom(tmpMatrix)
+        val parentNode = parent
+        val parentVersion = parentNode?.worldMatrixVersion ?: 0L
+        val localDirty = if (isStatic) transform.isDirty() else transform.detectChanges()
+
+        if (force || worldMatrixDirty || localDirty || parentVersion != parentVersionSeen) {
+            val localMatrix = transform.matrix()
+            if (parentNode != null) {
+                worldMatrix.multiply(parentNode.worldMatrix, localMatrix)
             } else {
                 worldMatrix.copyFrom(localMatrix)
             }
             worldMatrixDirty = false
+            parentVersionSeen = parentVersion
+            worldMatrixVersion++
         }
 
-        val childForce = needsUpdate || parentMatrix != null
-        children.forEach { it.updateWorldMatrix(childForce) }
+        for (i in _children.indices) {
+            val child = _children[i]
+            if (force || child.needsUpdate(worldMatrixVersion)) {
+                child.updateWorldMatrix(force)
+            }
+        }
+        subtreeDirty = false
     }
 
     /**
@@ -133,10 +182,26 @@ open class Node(
         children.forEach { it.traverse(action) }
     }
 
+    private fun needsUpdate(parentVersion: Long): Boolean =
+        dynamicNodeCount > 0 || subtreeDirty || parentVersionSeen != parentVersion
+
+    // Descendants pick up the change through worldMatrixVersion, so only the
+    // ancestor chain is flagged; an already flagged ancestor has flagged the rest.
     private fun markWorldMatrixDirty() {
-        if (!worldMatrixDirty) {
-            worldMatrixDirty = true
-            children.forEach { it.markWorldMatrixDirty() }
+        worldMatrixDirty = true
+        subtreeDirty = true
+        var node = parent
+        while (node != null && !node.subtreeDirty) {
+            node.subtreeDirty = true
+            node = node.parent
+        }
+    }
+
+    private fun adjustDynamicCount(delta: Int) {
+        var node: Node? = this
+        while (node != null) {
+            node.dynamicNodeCount += delta
+            node = node.parent
         }
     }
 }
@@ -21,7 +21,8 @@ class Scene(
     /**
      * Updates all nodes in the scene for the current frame.
      *
-     * Invokes [Node.onUpdate] on each descendant and refreshes world matrices.
+     * Invokes [Node.onUpdate] on each descendant and refreshes the world matrices
+     * of nodes whose transforms changed.
      *
      * @param deltaTime Time elapsed since the last frame in seconds.
      */
@@ -31,6 +32,6 @@ class Scene(
                 node.onUpdate(deltaTime)
             }
         }
-        updateWorldMatrix(force = true)
+        updateWorldMatrix()
     }
 }
@@ -30,4 +30,19 @@ class FrameArenaTests {
             arena.allocate(1)
         }
     }
+
+    @Test
+    fun copyFromWritesIntoSlice() {
+        val arena = FrameArena(8)
+        arena.allocate(2)
+        val slice = arena.allocate(4)
+
+        slice.copyFrom(floatArrayOf(1f, 2f, 3f), sourceOffset = 1)
+
+        assertEquals(2f, slice[0])
+        assertEquals(3f, slice[1])
+        assertFailsWith<IllegalArgumentException> {
+            slice.copyFrom(FloatArray(5))
+        }
+    }
 }
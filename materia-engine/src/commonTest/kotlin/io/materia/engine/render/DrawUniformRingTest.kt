@@ -0,0 +1,51 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.mat4
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+
+class DrawUniformRingTest {
+    @Test
+    fun slotsAreAlignedForDynamicOffsets() {
+        val ring = DrawUniformRing(initialSlots = 4, frameCount = 2)
+        ring.beginFrame(drawCount = 3)
+
+        val offsets = List(3) { ring.push(mat4().setIdentity()) }
+
+        assertEquals(listOf(0, 256, 512), offsets)
+        assertEquals(3 * DrawUniformRing.SLOT_FLOATS, ring.frameUsed)
+        assertEquals(1f, ring.backingArray()[DrawUniformRing.SLOT_FLOATS + 15])
+    }
+
+    @Test
+    fun framesAlternateBuckets() {
+        val ring = DrawUniformRing(initialSlots = 2, frameCount = 2)
+
+        ring.beginFrame(drawCount = 1)
+        assertEquals(0, ring.push(mat4()))
+
+        ring.beginFrame(drawCount = 1)
+        assertEquals(2 * DrawUniformRing.SLOT_FLOATS, ring.frameStart)
+        assertEquals(2 * 256, ring.push(mat4()))
+    }
+
+    @Test
+    fun growsWhenAFrameNeedsMoreSlots() {
+        val ring = DrawUniformRing(initialSlots = 2, frameCount = 2)
+        ring.beginFrame(drawCount = 5)
+
+        assertEquals(8, ring.slotCapacity)
+        assertEquals(1, ring.storageVersion)
+        assertEquals(8L * 2 * 256, ring.sizeBytes)
+    }
+
+    @Test
+    fun pushRequiresBeginFrame() {
+        val ring = DrawUniformRing()
+
+        assertFailsWith<IllegalStateException> {
+            ring.push(mat4())
+        }
+    }
+}
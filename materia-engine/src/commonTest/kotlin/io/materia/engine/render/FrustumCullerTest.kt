@@ -0,0 +1,71 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.mat4
+import io.materia.engine.scene.InstancedPoints
+import io.materia.engine.scene.Mesh
+import io.materia.engine.scene.Scene
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class FrustumCullerTest {
+    private val viewProjection = mat4().setPerspective(60f, 1f, 0.1f, 100f)
+
+    private fun triangle(name: String) = Mesh.fromInterleaved(
+        name = name,
+        positions = floatArrayOf(-0.5f, 0f, 0f, 0.5f, 0f, 0f, 0f, 0.5f, 0f)
+    )
+
+    @Test
+    fun objectsOutsideTheFrustumAreCulled() {
+        val scene = Scene()
+        val front = triangle("front").also { it.transform.setPosition(0f, 0f, -10f) }
+        val behind = triangle("behind").also { it.transform.setPosition(0f, 0f, 10f) }
+        val farPoints = InstancedPoints.create("far", floatArrayOf(0f, 0f, -500f))
+        scene.add(front)
+        scene.add(behind)
+        scene.add(farPoints)
+        scene.updateWorldMatrix()
+
+        val culler = FrustumCuller()
+        culler.collect(scene)
+        culler.cull(viewProjection)
+
+        assertEquals(listOf(front, behind), culler.meshes)
+        assertEquals(listOf(front), culler.visibleMeshes)
+        assertEquals(0, culler.visiblePoints.size)
+        assertEquals(2, culler.culledCount)
+    }
+
+    @Test
+    fun worldBoundsAreCachedUntilTheTransformChanges() {
+        val scene = Scene()
+        val mesh = triangle("mesh").also { it.transform.setPosition(0f, 0f, -5f) }
+        scene.add(mesh)
+        scene.updateWorldMatrix()
+
+        val culler = FrustumCuller()
+        assertEquals(-5f, culler.worldBounds(mesh).min.z)
+        val version = mesh.worldMatrixVersion
+
+        mesh.transform.setPosition(0f, 0f, -20f)
+        scene.updateWorldMatrix()
+        assertTrue(mesh.worldMatrixVersion > version)
+        assertEquals(-20f, culler.worldBounds(mesh).min.z)
+    }
+
+    @Test
+    fun disabledCullingPassesEverythingThrough() {
+        val scene = Scene()
+        val behind = triangle("behind").also { it.transform.setPosition(0f, 0f, 10f) }
+        scene.add(behind)
+        scene.updateWorldMatrix()
+
+        val culler = FrustumCuller()
+        culler.collect(scene)
+        culler.cull(viewProjection, enabled = false)
+
+        assertEquals(listOf(behind), culler.visibleMeshes)
+        assertEquals(0, culler.culledCount)
+    }
+}
@@ -0,0 +1,56 @@
+package io.materia.engine.render
+
+import io.materia.engine.geometry.Geometry
+import io.materia.engine.geometry.GeometryLayout
+import io.materia.engine.scene.VertexBuffer
+import io.materia.gpu.GpuIndexFormat
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class GeometryUploaderTest {
+    private fun geometry(indices: ShortArray? = null, indices32: IntArray? = null) = Geometry(
+        vertexBuffer = VertexBuffer(FloatArray(3), 12),
+        layout = GeometryLayout(12, emptyMap()),
+        indexBuffer = indices,
+        indexBuffer32 = indices32
+    )
+
+    @Test
+    fun wideIndicesUploadAsUint32() {
+        val geometry = geometry(indices32 = intArrayOf(0, 70_000, 1))
+        assertTrue(geometry.requires32BitIndices)
+        assertEquals(GpuIndexFormat.UINT32, indexFormatFor(geometry))
+
+        val bytes = indexBytes(geometry, GpuIndexFormat.UINT32)
+        assertEquals(12, bytes.size)
+        val second = (bytes[4].toInt() and 0xFF) or ((bytes[5].toInt() and 0xFF) shl 8) or
+            ((bytes[6].toInt() and 0xFF) shl 16)
+        assertEquals(70_000, second)
+    }
+
+    @Test
+    fun narrowIndicesUploadAsPaddedUint16() {
+        val geometry = geometry(indices32 = intArrayOf(0, 65_535, 2))
+        assertFalse(geometry.requires32BitIndices)
+        assertEquals(GpuIndexFormat.UINT16, indexFormatFor(geometry))
+
+        val bytes = indexBytes(geometry, GpuIndexFormat.UINT16)
+        assertEquals(8, bytes.size, "Padded to a four-byte multiple")
+        assertEquals(0xFF.toByte(), bytes[2])
+        assertEquals(0xFF.toByte(), bytes[3])
+    }
+
+    @Test
+    fun shortIndicesReadUnsigned() {
+        val geometry = geometry(indices = shortArrayOf(0, 40_000.toShort(), 1))
+        assertEquals(40_000, geometry.indexAt(1))
+        assertEquals(3, geometry.indexCount)
+        assertEquals(GpuIndexFormat.UINT16, indexFormatFor(geometry))
+        assertFailsWith<IllegalArgumentException> {
+            geometry(indices = shortArrayOf(0), indices32 = intArrayOf(0))
+        }
+    }
+}
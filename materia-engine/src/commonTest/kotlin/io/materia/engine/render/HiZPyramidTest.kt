@@ -0,0 +1,42 @@
+package io.materia.engine.render
+
+import io.materia.engine.math.Aabb
+import io.materia.engine.math.vec3
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+
+class HiZPyramidTest {
+    @Test
+    fun baseSizeIsLargestPowerOfTwoNotAboveDepth() {
+        assertEquals(1024, HiZPyramid.baseSize(1920))
+        assertEquals(512, HiZPyramid.baseSize(1023))
+        assertEquals(512, HiZPyramid.baseSize(512))
+        assertEquals(1, HiZPyramid.baseSize(1))
+        assertFailsWith<IllegalArgumentException> { HiZPyramid.baseSize(0) }
+    }
+
+    @Test
+    fun mipChainReachesOneTexel() {
+        assertEquals(11, HiZPyramid.levelCount(1024, 512))
+        assertEquals(1, HiZPyramid.levelCount(1, 1))
+
+        assertEquals(1, HiZPyramid.mipSize(512, 10))
+        assertEquals(1, HiZPyramid.mipSize(512, 9))
+        assertEquals(256, HiZPyramid.mipSize(1024, 2))
+    }
+
+    @Test
+    fun occlusionRecordCarriesIndexCountBits() {
+        val records = FloatArray(2 * OcclusionCullPass.RECORD_FLOATS)
+        val bounds = Aabb(vec3(-1f, -2f, -3f), vec3(1f, 2f, 3f))
+
+        OcclusionCullPass.writeRecord(records, 1, bounds, indexCount = 36)
+
+        val base = OcclusionCullPass.RECORD_FLOATS
+        assertEquals(-3f, records[base + 2])
+        assertEquals(36, records[base + 3].toRawBits())
+        assertEquals(2f, records[base + 5])
+        assertEquals(0f, records[0])
+    }
+}
@@ -0,0 +1,124 @@
+package io.materia.engine.render
+
+import io.materia.camera.PerspectiveCamera
+import io.materia.core.math.Vector3
+import io.materia.engine.math.Aabb
+import io.materia.engine.math.Frustum
+import io.materia.engine.math.mat4
+import io.materia.engine.math.vec3
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import io.materia.optimization.LODGroup
+import io.materia.optimization.LODLevel
+import io.materia.optimization.LODStrategy
+import io.materia.optimization.LODUtils
+import kotlin.math.PI
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+class InstanceCullPassTest {
+    private val viewProjection = mat4().setPerspective(60f, 1f, 0.1f, 100f)
+    private val frustum = Frustum.fromMatrix(viewProjection)
+    private val localBounds = Aabb(vec3(-1f, -1f, -1f), vec3(1f, 1f, 1f))
+
+    private fun translations(vararg positions: Float): FloatArray {
+        val count = positions.size / 3
+        return FloatArray(count * InstanceCullPass.MATRIX_FLOATS).also { m ->
+            for (i in 0 until count) {
+                val base = i * InstanceCullPass.MATRIX_FLOATS
+                m[base] = 1f
+                m[base + 5] = 1f
+                m[base + 10] = 1f
+                m[base + 15] = 1f
+                m[base + 12] = positions[i * 3]
+                m[base + 13] = positions[i * 3 + 1]
+                m[base + 14] = positions[i * 3 + 2]
+            }
+        }
+    }
+
+    @Test
+    fun levelSelectionMatchesLodGroup() {
+        val geometry = BufferGeometry().apply {
+            setAttribute("position", BufferAttribute(floatArrayOf(-1f, 0f, 0f, 1f, 0f, 0f, 0f, 1f, 0f), itemSize = 3))
+            computeBoundingSphere()
+        }
+        val errors = floatArrayOf(200f, 60f, 15f)
+        val group = LODGroup(
+            levels = errors.map { LODLevel(geometry, distance = 0f, screenSpaceError = it) },
+            strategy = LODStrategy.SCREEN_SPACE_ERROR
+        )
+        val camera = PerspectiveCamera(fov = 60f, aspect = 1f, near = 0.1f, far = 100f)
+        val projectionScale = LODUtils.projectionScale(60f * (PI / 180.0).toFloat())
+        val radius = geometry.boundingSphere!!.radius
+
+        val depths = listOf(1f, 2f, 4f, 8f, 16f, 32f, 64f, 95f)
+        val matrices = translations(*depths.flatMap { listOf(0f, 0f, -it) }.toFloatArray())
+        depths.forEachIndexed { i, depth ->
+            val expected = group.update(camera, Vector3(0f, 0f, -depth), 0f)
+            val level = InstanceCullPass.classify(
+                matrices, i, frustum, localBounds, radius, vec3(0f, 0f, 0f), projectionScale, errors, errors.size
+            )
+            assertEquals(expected, level, "depth $depth")
+        }
+    }
+
+    @Test
+    fun boundsOutsideTheFrustumAreCulled() {
+        val matrices = translations(
+            0f, 0f, -10f,   // in front
+            0f, 0f, 10f,    // behind
+            30f, 0f, -10f,  // far to the right
+            6.5f, 0f, -10f, // straddles the right plane
+            0f, 0f, -150f   // past the far plane
+        )
+        val errors = floatArrayOf(0f)
+        val results = (0 until 5).map {
+            InstanceCullPass.classify(matrices, it, frustum, localBounds, 1f, vec3(0f, 0f, 0f), 1f, errors, 1)
+        }
+        assertEquals(listOf(0, -1, -1, 0, -1), results)
+    }
+
+    @Test
+    fun scaledInstancesProjectLarger() {
+        val matrices = translations(0f, 0f, -20f, 0f, 0f, -20f)
+        matrices[InstanceCullPass.MATRIX_FLOATS] = 4f
+        val errors = floatArrayOf(100f, 0f)
+        val scale = LODUtils.projectionScale(60f * (PI / 180.0).toFloat())
+
+        val levels = (0 until 2).map {
+            InstanceCullPass.classify(matrices, it, frustum, localBounds, 1f, vec3(0f, 0f, 0f), scale, errors, 2)
+        }
+        assertEquals(listOf(1, 0), levels)
+    }
+
+    @Test
+    fun resetArgsKeepGeometryAndZeroInstanceCounts() {
+        val lods = listOf(
+            InstanceCullPass.Lod(indexCount = 36, screenSpaceError = 50f),
+            InstanceCullPass.Lod(indexCount = 12, firstIndex = 36, baseVertex = 24)
+        )
+        val args = FloatArray(lods.size * InstanceCullPass.ARGS_FLOATS) { 1f }
+        InstanceCullPass.writeResetArgs(args, lods)
+
+        assertEquals(listOf(36, 0, 0, 0, 0, 12, 0, 36, 24, 0), args.map { it.toRawBits() })
+    }
+
+    @Test
+    fun paramsCarryCountsAsBits() {
+        val params = FloatArray(InstanceCullPass.PARAMS_FLOATS)
+        InstanceCullPass.writeParams(
+            params, frustum, vec3(1f, 2f, 3f), 935f, localBounds, 1.5f,
+            floatArrayOf(40f, 10f), instanceCount = 1_000_000, lodCount = 2, capacity = 1 shl 20
+        )
+
+        assertEquals(frustum.plane(4).distance, params[19])
+        assertEquals(935f, params[27])
+        assertEquals(1.5f, params[31])
+        assertEquals(10f, params[37])
+        assertEquals(0f, params[38])
+        assertEquals(1_000_000, params[44].toRawBits())
+        assertEquals(2, params[45].toRawBits())
+        assertEquals(1 shl 20, params[46].toRawBits())
+    }
+}
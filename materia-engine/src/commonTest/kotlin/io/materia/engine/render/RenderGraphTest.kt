@@ -0,0 +1,186 @@
+package io.materia.engine.render
+
+import io.materia.gpu.GpuTextureFormat
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNotEquals
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class RenderGraphTest {
+
+    private val color = RenderGraphTextureDesc(GpuTextureFormat.RGBA8_UNORM)
+
+    private fun RenderGraph.surface() =
+        importTexture("surface", GpuTextureFormat.BGRA8_UNORM, 3840, 2160).also { output(it) }
+
+    private fun RenderGraph.pass(name: String, reads: List<RenderGraphTexture>, output: RenderGraphTexture) =
+        addPass(name) {
+            reads.forEach { read(it) }
+            write(output)
+        }
+
+    @Test
+    fun passesNotReachingAnOutputAreCulled() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val scene = graph.createTexture("scene", color)
+        val debug = graph.createTexture("debug", color)
+        val debugInput = graph.createTexture("debug-input", color)
+        graph.pass("scene", emptyList(), scene)
+        graph.pass("debug-source", emptyList(), debugInput)
+        graph.pass("debug-view", listOf(debugInput), debug)
+        graph.pass("composite", listOf(scene), surface)
+
+        val compiled = graph.compile(3840, 2160)
+
+        assertEquals(listOf("scene", "composite"), compiled.steps.map { it.toString() })
+        assertEquals(setOf("debug-source", "debug-view"), compiled.culledPasses.map { it.name }.toSet())
+        assertNull(compiled.slot(debug))
+        assertEquals(1, compiled.slots.size)
+    }
+
+    @Test
+    fun transientTargetsWithDisjointLifetimesShareASlot() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val a = graph.createTexture("a", color)
+        val b = graph.createTexture("b", color)
+        val c = graph.createTexture("c", color)
+        graph.pass("first", emptyList(), a)
+        graph.pass("second", listOf(a), b)
+        graph.pass("third", listOf(b), c)
+        graph.pass("present", listOf(c), surface)
+
+        val compiled = graph.compile(3840, 2160)
+
+        // a dies when b is written, so c can take its memory; b overlaps both
+        assertEquals(2, compiled.slots.size)
+        assertEquals(compiled.slot(a), compiled.slot(c))
+        assertNotEquals(compiled.slot(a), compiled.slot(b))
+        assertNull(compiled.slot(surface))
+    }
+
+    @Test
+    fun aliasingRequiresMatchingDescriptions() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val a = graph.createTexture("a", color)
+        val b = graph.createTexture("b", color)
+        val hdr = graph.createTexture("hdr", RenderGraphTextureDesc(GpuTextureFormat.RGBA16_FLOAT))
+        graph.pass("first", emptyList(), a)
+        graph.pass("second", listOf(a), b)
+        graph.pass("third", listOf(b), hdr)
+        graph.pass("present", listOf(hdr), surface)
+
+        val compiled = graph.compile(3840, 2160)
+
+        assertEquals(3, compiled.slots.size)
+        assertNotEquals(compiled.slot(a), compiled.slot(hdr))
+    }
+
+    @Test
+    fun reducedResolutionTargetsFollowTheGraphSize() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val scene = graph.createTexture("scene", color)
+        val ssao = graph.createTexture("ssao", RenderGraphTextureDesc(GpuTextureFormat.R32_FLOAT, scale = 0.5f))
+        graph.pass("scene", emptyList(), scene)
+        graph.pass("ssao", listOf(scene), ssao)
+        var previous = scene
+        val mips = (1..3).map { level ->
+            graph.createTexture("bloom-$level", color.copy(scale = 1f / (1 shl level))).also {
+                graph.pass("bloom-down-$level", listOf(previous), it)
+                previous = it
+            }
+        }
+        graph.pass("composite", listOf(scene, ssao) + mips, surface)
+
+        val compiled = graph.compile(3840, 2160)
+        fun size(texture: RenderGraphTexture) = compiled.slots[compiled.slot(texture)!!].let { it.width to it.height }
+
+        assertEquals(1920 to 1080, size(ssao))
+        assertEquals(listOf(1920 to 1080, 960 to 540, 480 to 270), mips.map(::size))
+        assertEquals(5, compiled.slots.size)
+
+        val resized = graph.compile(1280, 720)
+        assertEquals(640, resized.slots[resized.slot(ssao)!!].width)
+    }
+
+    @Test
+    fun consecutivePixelPassesAreFused() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val scene = graph.createTexture("scene", color)
+        graph.pass("scene", emptyList(), scene)
+        val effects = listOf(
+            PixelEffect.film(),
+            PixelEffect.dotScreen(),
+            PixelEffect.acesToneMapping(exposure = 1.2f),
+            PixelEffect.srgbOutput()
+        )
+        var input = scene
+        val intermediates = effects.mapIndexed { index, effect ->
+            val output = if (index == effects.lastIndex) surface else graph.createTexture(effect.name, color)
+            graph.addPixelPass(effect.name, effect, input, output)
+            input = output
+            output
+        }
+
+        val compiled = graph.compile(3840, 2160)
+
+        assertEquals(2, compiled.steps.size)
+        val fused = compiled.steps[1]
+        assertEquals(effects, fused.effects)
+        assertEquals(listOf(scene), fused.reads)
+        assertEquals(listOf(surface), fused.writes)
+        intermediates.dropLast(1).forEach { assertNull(compiled.slot(it)) }
+        assertEquals(1, compiled.slots.size)
+    }
+
+    @Test
+    fun pixelPassesWithOtherReadersOrSizesAreNotFused() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val scene = graph.createTexture("scene", color)
+        val graded = graph.createTexture("graded", color)
+        val small = graph.createTexture("small", color.copy(scale = 0.5f))
+        val mapped = graph.createTexture("mapped", color)
+        graph.pass("scene", emptyList(), scene)
+        graph.addPixelPass("grade", PixelEffect.reinhardToneMapping(), scene, graded)
+        // graded also feeds the composite, so it must exist on its own
+        graph.addPixelPass("tonemap", PixelEffect.acesToneMapping(), graded, mapped)
+        graph.addPixelPass("downsample", PixelEffect.srgbOutput(), mapped, small)
+        graph.pass("composite", listOf(graded, small), surface)
+
+        val compiled = graph.compile(3840, 2160)
+
+        assertEquals(listOf("scene", "grade", "tonemap", "downsample", "composite"), compiled.steps.map { it.toString() })
+    }
+
+    @Test
+    fun readingATextureNobodyWritesIsRejected() {
+        val graph = RenderGraph()
+        val surface = graph.surface()
+        val missing = graph.createTexture("missing", color)
+        graph.pass("present", listOf(missing), surface)
+
+        assertFailsWith<IllegalArgumentException> { graph.compile(3840, 2160) }
+    }
+
+    @Test
+    fun fusedShaderSamplesOnceAndDefinesEachFunctionOnce() {
+        val film = PixelEffect.film()
+        val shader = PixelEffectShader.fragment(listOf(film, PixelEffect.srgbOutput(), film))
+
+        assertEquals(1, Regex("textureSample\\(").findAll(shader).count())
+        assertEquals(1, Regex("fn film\\(").findAll(shader).count())
+        assertTrue("color = film(color, input.uv, uEffects.params[2]);" in shader)
+
+        val uniforms = FloatArray(PixelEffectShader.UNIFORM_FLOATS)
+        PixelEffectShader.writeUniforms(uniforms, listOf(film, PixelEffect.acesToneMapping(exposure = 2f)), 800, 600, 1.5f)
+        assertEquals(listOf(800f, 600f, 1.5f), uniforms.take(3))
+        assertEquals(2f, uniforms[8])
+    }
+}
@@ -0,0 +1,57 @@
+package io.materia.engine.render
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class RenderQueueTest {
+    @Test
+    fun opaqueDrawsGroupByPipelineThenGoFrontToBack() {
+        val queue = RenderQueue(initialCapacity = 2)
+        queue.add(RenderQueue.opaqueKey(pipelineId = 1, materialId = 0, geometryId = 0, depth = 1f), 0)
+        queue.add(RenderQueue.opaqueKey(pipelineId = 0, materialId = 0, geometryId = 0, depth = 9f), 1)
+        queue.add(RenderQueue.opaqueKey(pipelineId = 0, materialId = 0, geometryId = 0, depth = 2f), 2)
+
+        queue.sort()
+
+        assertEquals(listOf(2, 1, 0), List(queue.size) { queue.itemAt(it) })
+    }
+
+    @Test
+    fun transparentDrawsFollowOpaqueBackToFront() {
+        val queue = RenderQueue()
+        queue.add(RenderQueue.transparentKey(0, 0, 0, depth = 1f), 0)
+        queue.add(RenderQueue.opaqueKey(5, 7, 9, depth = 100f), 1)
+        queue.add(RenderQueue.transparentKey(3, 0, 0, depth = 50f), 2)
+
+        queue.sort()
+
+        assertEquals(listOf(1, 2, 0), List(queue.size) { queue.itemAt(it) })
+        assertTrue(RenderQueue.isTransparent(queue.keyAt(2)))
+    }
+
+    @Test
+    fun sortHandlesLargeQueues() {
+        val queue = RenderQueue()
+        val count = 500
+        for (i in 0 until count) {
+            val depth = ((i * 7919) % count).toFloat()
+            queue.add(RenderQueue.opaqueKey(i % 3, 0, 0, depth), i)
+        }
+
+        queue.sort()
+
+        for (i in 1 until queue.size) {
+            assertTrue(queue.keyAt(i - 1) <= queue.keyAt(i))
+        }
+    }
+
+    @Test
+    fun depthQuantizationIsMonotonic() {
+        val depths = listOf(-1f, 0f, 0.001f, 0.5f, 1f, 10f, 1000f)
+        val quantized = depths.map { RenderQueue.quantizeDepth(it) }
+
+        assertEquals(quantized.sorted(), quantized)
+        assertEquals(0L, RenderQueue.quantizeDepth(Float.NaN))
+    }
+}
@@ -0,0 +1,55 @@
+package io.materia.engine.render
+
+import io.materia.engine.scene.Mesh
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class StaticBatchTest {
+    private val positions = floatArrayOf(0f, 0f, 0f, 1f, 0f, 0f, 0f, 1f, 0f)
+    private val colors = floatArrayOf(1f, 0f, 0f, 0f, 1f, 0f, 0f, 0f, 1f)
+
+    @Test
+    fun indexedColorMeshesAreBatchable() {
+        val mesh = Mesh.fromInterleaved(
+            "triangle",
+            positions = positions,
+            colors = colors,
+            indices = shortArrayOf(0, 1, 2)
+        )
+
+        assertTrue(StaticBatch.isBatchable(mesh))
+    }
+
+    @Test
+    fun unindexedOrOtherLayoutsAreNotBatchable() {
+        val unindexed = Mesh.fromInterleaved("unindexed", positions = positions, colors = colors)
+        val withNormals = Mesh.fromInterleaved(
+            "normals",
+            positions = positions,
+            normals = FloatArray(9),
+            colors = colors,
+            indices = shortArrayOf(0, 1, 2)
+        )
+
+        assertFalse(StaticBatch.isBatchable(unindexed))
+        assertFalse(StaticBatch.isBatchable(withNormals))
+    }
+
+    @Test
+    fun writeArgsPacksIndirectRecordBits() {
+        val out = FloatArray(StaticBatch.ARGS_FLOATS * 2)
+
+        StaticBatch.writeArgs(out, 1, indexCount = 36, firstIndex = 72, baseVertex = 48, visible = true)
+
+        val base = StaticBatch.ARGS_FLOATS
+        assertEquals(5, StaticBatch.ARGS_FLOATS)
+        assertEquals(36, out[base].toRawBits())
+        assertEquals(1, out[base + 1].toRawBits())
+        assertEquals(72, out[base + 2].toRawBits())
+        assertEquals(48, out[base + 3].toRawBits())
+        assertEquals(0, out[base + 4].toRawBits())
+        assertEquals(0, out[0].toRawBits())
+    }
+}
@@ -36,6 +36,17 @@ class UnlitPipelineFactoryTest {
         assertEquals(GpuVertexFormat.FLOAT32x4, extraAttr.format)
     }
 
+    @Test
+    fun batchedLayoutAppendsMemberIndex() {
+        val layout = UnlitPipelineFactory.batchedVertexLayout()
+
+        assertEquals(Float.SIZE_BYTES * 7, layout.arrayStride)
+        assertEquals(GpuVertexStepMode.VERTEX, layout.stepMode)
+        assertEquals(3, layout.attributes.size)
+        assertEquals(Float.SIZE_BYTES * 6, layout.attributes[2].offset)
+        assertEquals(GpuVertexFormat.UINT32, layout.attributes[2].format)
+    }
+
     @Test
     fun materialBlueprintsExposeExpectedLayouts() {
         val colorBlueprint =
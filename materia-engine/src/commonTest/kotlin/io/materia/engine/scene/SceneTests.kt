@@ -2,6 +2,7 @@ package io.materia.engine.scene
 
 import kotlin.test.Test
 import kotlin.test.assertEquals
+import kotlin.test.assertTrue
 
 private const val EPSILON = 1e-4f
 
@@ -37,4 +38,89 @@ class SceneTests {
 
         assertEquals(null, child.parent)
     }
+
+    @Test
+    fun directVectorWritesAreDetected() {
+        val scene = Scene()
+        val node = Node()
+        scene.add(node)
+        scene.update(0f)
+
+        node.transform.position.set(2f, 0f, 0f)
+        scene.update(0f)
+
+        assertEquals(2f, node.positionWorld().x, EPSILON)
+    }
+
+    @Test
+    fun unchangedNodesKeepTheirVersion() {
+        val scene = Scene()
+        val moving = Node()
+        val still = Node()
+        scene.add(moving)
+        scene.add(still)
+        scene.update(0f)
+        val stillVersion = still.worldMatrixVersion
+        val movingVersion = moving.worldMatrixVersion
+
+        moving.transform.setPosition(1f, 0f, 0f)
+        scene.update(0f)
+
+        assertEquals(stillVersion, still.worldMatrixVersion)
+        assertTrue(moving.worldMatrixVersion > movingVersion)
+    }
+
+    @Test
+    fun parentMovePropagatesThroughStaticSubtree() {
+        val scene = Scene()
+        val parent = Node()
+        val child = Node().apply {
+            transform.setPosition(0f, 1f, 0f)
+            isStatic = true
+        }
+        parent.add(child)
+        scene.add(parent)
+        scene.update(0f)
+        val childVersion = child.worldMatrixVersion
+
+        scene.update(0f)
+        assertEquals(childVersion, child.worldMatrixVersion)
+
+        parent.transform.setPosition(3f, 0f, 0f)
+        scene.update(0f)
+
+        assertTrue(child.worldMatrixVersion > childVersion)
+        assertEquals(3f, child.positionWorld().x, EPSILON)
+        assertEquals(1f, child.positionWorld().y, EPSILON)
+    }
+
+    @Test
+    fun staticNodeUpdatesThroughSetters() {
+        val scene = Scene()
+        val node = Node().apply { isStatic = true }
+        scene.add(node)
+        scene.update(0f)
+
+        node.transform.setPosition(0f, 0f, 4f)
+        scene.update(0f)
+
+        assertEquals(4f, node.positionWorld().z, EPSILON)
+    }
+
+    @Test
+    fun reparentedNodeUsesNewParent() {
+        val scene = Scene()
+        val first = Node().apply { transform.setPosition(1f, 0f, 0f) }
+        val second = Node().apply { transform.setPosition(5f, 0f, 0f) }
+        val child = Node().apply { isStatic = true }
+        scene.add(first)
+        scene.add(second)
+        first.add(child)
+        scene.update(0f)
+
+        second.add(child)
+        scene.update(0f)
+
+        assertEquals(5f, child.positionWorld().x, EPSILON)
+    }
 }
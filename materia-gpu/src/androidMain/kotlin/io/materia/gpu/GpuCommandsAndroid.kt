@@ -17,6 +17,7 @@ actual class GpuCommandEncoder actual constructor(
     }
 
     actual fun finish(label: String?): GpuCommandBuffer {
+        device.passTimer?.resolve(this)
         val wgpuBuffer = wgpuEncoder.finish()
         return GpuCommandBuffer(device, label, wgpuBuffer)
     }
@@ -51,15 +52,74 @@ actual class GpuCommandEncoder actual constructor(
             )
         }
 
+        val timestampWrites = descriptor.timestampWrites
+            ?: device.passTimer?.timestampWrites(descriptor.label, GpuPassKind.RENDER)
         val wgpuPass = wgpuEncoder.beginRenderPass(
             RenderPassDescriptor(
                 label = descriptor.label ?: "",
                 colorAttachments = colorAttachments,
-                depthStencilAttachment = depthStencil
+                depthStencilAttachment = depthStencil,
+                timestampWrites = timestampWrites?.let {
+                    RenderPassTimestampWrites(
+                        querySet = it.querySet.wgpuQuerySet,
+                        beginningOfPassWriteIndex = it.beginningOfPassWriteIndex?.toUInt(),
+                        endOfPassWriteIndex = it.endOfPassWriteIndex?.toUInt()
+                    )
+                }
             )
         )
         return GpuRenderPassEncoder(this, descriptor, wgpuPass)
     }
+
+    actual fun beginComputePass(descriptor: GpuComputePassDescriptor): GpuComputePassEncoder {
+        val timestampWrites = descriptor.timestampWrites
+            ?: device.passTimer?.timestampWrites(descriptor.label, GpuPassKind.COMPUTE)
+        val wgpuPass = wgpuEncoder.beginComputePass(
+            ComputePassDescriptor(
+                label = descriptor.label ?: "",
+                timestampWrites = timestampWrites?.let {
+                    ComputePassTimestampWrites(
+                        querySet = it.querySet.wgpuQuerySet,
+                        beginningOfPassWriteIndex = it.beginningOfPassWriteIndex?.toUInt(),
+                        endOfPassWriteIndex = it.endOfPassWriteIndex?.toUInt()
+                    )
+                }
+            )
+        )
+        return GpuComputePassEncoder(this, descriptor, wgpuPass)
+    }
+
+    actual fun resolveQuerySet(
+        querySet: GpuQuerySet,
+        firstQuery: Int,
+        queryCount: Int,
+        destination: GpuBuffer,
+        destinationOffset: Long
+    ) {
+        wgpuEncoder.resolveQuerySet(
+            querySet.wgpuQuerySet,
+            firstQuery.toUInt(),
+            queryCount.toUInt(),
+            destination.wgpuBuffer,
+            destinationOffset.toULong()
+        )
+    }
+
+    actual fun copyBufferToBuffer(
+        source: GpuBuffer,
+        sourceOffset: Long,
+        destination: GpuBuffer,
+        destinationOffset: Long,
+        size: Long
+    ) {
+        wgpuEncoder.copyBufferToBuffer(
+            source.wgpuBuffer,
+            sourceOffset.toULong(),
+            destination.wgpuBuffer,
+            destinationOffset.toULong(),
+            size.toULong()
+        )
+    }
 }
 
 actual class GpuCommandBuffer actual constructor(
@@ -103,6 +163,17 @@ actual class GpuRenderPassEncoder actual constructor(
         wgpuPass.setBindGroup(index.toUInt(), bindGroup.wgpuBindGroup)
     }
 
+    // Refilled on every dynamic-offset bind instead of mapping to a new list
+    private val dynamicOffsetList = DynamicOffsetList()
+
+    actual fun setBindGroup(index: Int, bindGroup: GpuBindGroup, dynamicOffsets: IntArray) {
+        wgpuPass.setBindGroup(
+            index.toUInt(),
+            bindGroup.wgpuBindGroup,
+            dynamicOffsetList.fill(dynamicOffsets)
+        )
+    }
+
     actual fun draw(vertexCount: Int, instanceCount: Int, firstVertex: Int, firstInstance: Int) {
         wgpuPass.draw(
             vertexCount.toUInt(),
@@ -128,6 +199,57 @@ actual class GpuRenderPassEncoder actual constructor(
         )
     }
 
+    actual fun drawIndirect(indirectBuffer: GpuBuffer, indirectOffset: Long) {
+        wgpuPass.drawIndirect(indirectBuffer.wgpuBuffer, indirectOffset.toULong())
+    }
+
+    actual fun drawIndexedIndirect(indirectBuffer: GpuBuffer, indirectOffset: Long) {
+        wgpuPass.drawIndexedIndirect(indirectBuffer.wgpuBuffer, indirectOffset.toULong())
+    }
+
+    // WebGPU has no core multi-draw; consecutive indirect draws keep all bound state
+    actual fun multiDrawIndexedIndirect(
+        indirectBuffer: GpuBuffer,
+        drawCount: Int,
+        indirectOffset: Long,
+        stride: Long
+    ) {
+        for (draw in 0 until drawCount) {
+            wgpuPass.drawIndexedIndirect(indirectBuffer.wgpuBuffer, (indirectOffset + draw * stride).toULong())
+        }
+    }
+
+    actual fun end() {
+        wgpuPass.end()
+    }
+}
+
+actual class GpuComputePassEncoder actual constructor(
+    actual val encoder: GpuCommandEncoder,
+    actual val descriptor: GpuComputePassDescriptor
+) {
+    internal lateinit var wgpuPass: GPUComputePassEncoder
+
+    internal constructor(encoder: GpuCommandEncoder, descriptor: GpuComputePassDescriptor, pass: GPUComputePassEncoder) : this(encoder, descriptor) {
+        wgpuPass = pass
+    }
+
+    actual fun setPipeline(pipeline: GpuComputePipeline) {
+        wgpuPass.setPipeline(pipeline.wgpuPipeline)
+    }
+
+    actual fun setBindGroup(index: Int, bindGroup: GpuBindGroup) {
+        wgpuPass.setBindGroup(index.toUInt(), bindGroup.wgpuBindGroup)
+    }
+
+    actual fun dispatchWorkgroups(workgroupCountX: Int, workgroupCountY: Int, workgroupCountZ: Int) {
+        wgpuPass.dispatchWorkgroups(
+            workgroupCountX.toUInt(),
+            workgroupCountY.toUInt(),
+            workgroupCountZ.toUInt()
+        )
+    }
+
     actual fun end() {
         wgpuPass.end()
     }
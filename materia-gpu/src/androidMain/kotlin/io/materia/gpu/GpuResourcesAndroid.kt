@@ -20,16 +20,35 @@ actual class GpuBuffer actual constructor(
         device.queue.writeBuffer(this, offset.toLong(), data)
     }
 
-    actual fun writeFloats(data: FloatArray, offset: Int) {
-        val byteBuffer = ByteArray(data.size * 4)
-        for (i in data.indices) {
-            val bits = data[i].toBits()
+    // Grow-only; writeBuffer copies the payload before returning, so per-frame uploads
+    // stop allocating once it has reached the largest upload size.
+    private var floatScratch = ByteArray(0)
+
+    actual fun writeFloats(data: FloatArray, offset: Int, dataOffset: Int, count: Int) {
+        require(dataOffset >= 0 && count >= 0 && dataOffset + count <= data.size) {
+            "Float range out of bounds (dataOffset=$dataOffset count=$count size=${data.size})"
+        }
+        if (floatScratch.size < count * 4) {
+            floatScratch = ByteArray(count * 4)
+        }
+        val byteBuffer = floatScratch
+        for (i in 0 until count) {
+            val bits = data[dataOffset + i].toBits()
             byteBuffer[i * 4] = (bits and 0xFF).toByte()
             byteBuffer[i * 4 + 1] = ((bits shr 8) and 0xFF).toByte()
             byteBuffer[i * 4 + 2] = ((bits shr 16) and 0xFF).toByte()
             byteBuffer[i * 4 + 3] = ((bits shr 24) and 0xFF).toByte()
         }
-        write(byteBuffer, offset)
+        device.queue.writeBuffer(this, offset.toLong(), byteBuffer, count * 4)
+    }
+
+    actual suspend fun mapRead(offset: Long, size: Long): ByteArray {
+        wgpuBuffer.mapAsync(setOf(GPUMapMode.Read), offset.toULong(), size.toULong()).getOrThrow()
+        return try {
+            wgpuBuffer.getMappedRange(offset.toULong(), size.toULong()).toByteArray()
+        } finally {
+            wgpuBuffer.unmap()
+        }
     }
 
     actual fun destroy() {
@@ -37,6 +56,21 @@ actual class GpuBuffer actual constructor(
     }
 }
 
+actual class GpuQuerySet actual constructor(
+    actual val device: GpuDevice,
+    actual val descriptor: GpuQuerySetDescriptor
+) {
+    internal lateinit var wgpuQuerySet: GPUQuerySet
+
+    internal constructor(device: GpuDevice, descriptor: GpuQuerySetDescriptor, querySet: GPUQuerySet) : this(device, descriptor) {
+        wgpuQuerySet = querySet
+    }
+
+    actual fun destroy() {
+        wgpuQuerySet.close()
+    }
+}
+
 actual class GpuTexture actual constructor(
     actual val device: GpuDevice,
     actual val descriptor: GpuTextureDescriptor
@@ -27,8 +27,44 @@ expect class GpuCommandEncoder internal constructor(
 
     fun finish(label: String? = descriptor?.label): GpuCommandBuffer
     fun beginRenderPass(descriptor: GpuRenderPassDescriptor): GpuRenderPassEncoder
+    fun beginComputePass(descriptor: GpuComputePassDescriptor = GpuComputePassDescriptor()): GpuComputePassEncoder
+
+    /**
+     * Writes [queryCount] results of [querySet] starting at [firstQuery] into [destination]
+     * as 64-bit values. [destinationOffset] must be a multiple of 256 and the buffer needs
+     * [GpuBufferUsage.QUERY_RESOLVE].
+     */
+    fun resolveQuerySet(
+        querySet: GpuQuerySet,
+        firstQuery: Int,
+        queryCount: Int,
+        destination: GpuBuffer,
+        destinationOffset: Long = 0L
+    )
+
+    /** Copies [size] bytes between buffers; offsets and size must be multiples of 4. */
+    fun copyBufferToBuffer(
+        source: GpuBuffer,
+        sourceOffset: Long,
+        destination: GpuBuffer,
+        destinationOffset: Long,
+        size: Long
+    )
 }
 
+/**
+ * Timestamp queries written at the start and end of a pass.
+ *
+ * @property querySet A [GpuQueryType.TIMESTAMP] query set.
+ * @property beginningOfPassWriteIndex Query written when the pass starts, or null.
+ * @property endOfPassWriteIndex Query written when the pass ends, or null.
+ */
+data class GpuPassTimestampWrites(
+    val querySet: GpuQuerySet,
+    val beginningOfPassWriteIndex: Int? = null,
+    val endOfPassWriteIndex: Int? = null
+)
+
 /**
  * Recorded GPU commands ready for queue submission.
  *
@@ -84,11 +120,14 @@ data class GpuRenderPassDepthStencilAttachment(
  * @property colorAttachments List of color render targets.
  * @property depthStencilAttachment Optional depth/stencil target.
  * @property label Optional debug label.
+ * @property timestampWrites Timestamps to write around the pass. When null and the device
+ *   has a [GpuPassTimer], the timer supplies them.
  */
 data class GpuRenderPassDescriptor(
     val colorAttachments: List<GpuRenderPassColorAttachment>,
     val depthStencilAttachment: GpuRenderPassDepthStencilAttachment? = null,
-    val label: String? = null
+    val label: String? = null,
+    val timestampWrites: GpuPassTimestampWrites? = null
 )
 
 /** Index buffer element size. */
@@ -116,6 +155,12 @@ expect class GpuRenderPassEncoder internal constructor(
     fun setVertexBuffer(slot: Int, buffer: GpuBuffer)
     fun setIndexBuffer(buffer: GpuBuffer, format: GpuIndexFormat, offset: Long = 0L)
     fun setBindGroup(index: Int, bindGroup: GpuBindGroup)
+
+    /**
+     * Binds [bindGroup] with one byte offset per dynamic-offset binding, in binding order.
+     * Offsets must be multiples of the device's uniform/storage offset alignment (256 by default).
+     */
+    fun setBindGroup(index: Int, bindGroup: GpuBindGroup, dynamicOffsets: IntArray)
     fun draw(vertexCount: Int, instanceCount: Int = 1, firstVertex: Int = 0, firstInstance: Int = 0)
     fun drawIndexed(
         indexCount: Int,
@@ -125,5 +170,89 @@ expect class GpuRenderPassEncoder internal constructor(
         firstInstance: Int = 0
     )
 
+    /**
+     * Draws with arguments read from [indirectBuffer] at [indirectOffset]:
+     * four u32 values (vertexCount, instanceCount, firstVertex, firstInstance).
+     */
+    fun drawIndirect(indirectBuffer: GpuBuffer, indirectOffset: Long = 0L)
+
+    /**
+     * Indexed draw with arguments read from [indirectBuffer] at [indirectOffset]:
+     * five 32-bit values (indexCount, instanceCount, firstIndex, baseVertex, firstInstance).
+     * The buffer needs [GpuBufferUsage.INDIRECT].
+     */
+    fun drawIndexedIndirect(indirectBuffer: GpuBuffer, indirectOffset: Long = 0L)
+
+    /**
+     * Issues [drawCount] indexed indirect draws from consecutive records starting at
+     * [indirectOffset], [stride] bytes apart. Backends without native multi-draw issue
+     * one [drawIndexedIndirect] per record; bound state is shared either way.
+     */
+    fun multiDrawIndexedIndirect(
+        indirectBuffer: GpuBuffer,
+        drawCount: Int,
+        indirectOffset: Long = 0L,
+        stride: Long = INDEXED_INDIRECT_STRIDE
+    )
+
+    fun end()
+}
+
+/** Bytes in one `drawIndexedIndirect` argument record (five 32-bit values). */
+const val INDEXED_INDIRECT_STRIDE: Long = 20L
+
+/**
+ * Configuration for beginning a compute pass.
+ *
+ * @property label Optional debug label.
+ * @property timestampWrites Timestamps to write around the pass. When null and the device
+ *   has a [GpuPassTimer], the timer supplies them.
+ */
+data class GpuComputePassDescriptor(
+    val label: String? = null,
+    val timestampWrites: GpuPassTimestampWrites? = null
+)
+
+/**
+ * Records compute dispatches.
+ *
+ * Obtained from [GpuCommandEncoder.beginComputePass]. Set a pipeline and bind groups,
+ * dispatch workgroups, then call [end]. Writes are visible to later passes in the
+ * same command encoder.
+ */
+expect class GpuComputePassEncoder internal constructor(
+    encoder: GpuCommandEncoder,
+    descriptor: GpuComputePassDescriptor
+) {
+    val encoder: GpuCommandEncoder
+    val descriptor: GpuComputePassDescriptor
+
+    fun setPipeline(pipeline: GpuComputePipeline)
+    fun setBindGroup(index: Int, bindGroup: GpuBindGroup)
+    fun dispatchWorkgroups(workgroupCountX: Int, workgroupCountY: Int = 1, workgroupCountZ: Int = 1)
     fun end()
 }
+
+/**
+ * Reusable unsigned view of bind-group dynamic offsets, refilled in place per bind so
+ * render passes don't map every offset array to a new list.
+ */
+internal class DynamicOffsetList : AbstractList<UInt>() {
+    private var offsets = IntArray(4)
+    private var count = 0
+
+    override val size: Int get() = count
+
+    override fun get(index: Int): UInt {
+        if (index !in 0 until count) throw IndexOutOfBoundsException("index $index, size $count")
+        return offsets[index].toUInt()
+    }
+
+    /** Replaces the contents with [values]; the backing array only grows. */
+    fun fill(values: IntArray): DynamicOffsetList {
+        if (offsets.size < values.size) offsets = IntArray(values.size)
+        values.copyInto(offsets)
+        count = values.size
+        return this
+    }
+}
@@ -146,6 +146,17 @@ expect class GpuDevice internal constructor(
     fun createShaderModule(descriptor: GpuShaderModuleDescriptor): GpuShaderModule
     fun createRenderPipeline(descriptor: GpuRenderPipelineDescriptor): GpuRenderPipeline
     fun createComputePipeline(descriptor: GpuComputePipelineDescriptor): GpuComputePipeline
+    fun createQuerySet(descriptor: GpuQuerySetDescriptor): GpuQuerySet
+
+    /** Whether the device was created with the `timestamp-query` feature. */
+    val supportsTimestampQueries: Boolean
+
+    /**
+     * Timer adding timestamp writes to every pass encoded on this device; set by
+     * [GpuPassTimer.install].
+     */
+    var passTimer: GpuPassTimer?
+
     fun destroy()
 }
 
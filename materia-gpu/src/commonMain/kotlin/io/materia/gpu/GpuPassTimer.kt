@@ -0,0 +1,174 @@
+package io.materia.gpu
+
+import io.materia.core.platform.Platform
+import io.materia.profiling.GpuPassSpan
+import io.materia.profiling.PerformanceProfiler
+import kotlinx.atomicfu.atomic
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.launch
+
+/** Kind of pass a timestamp pair belongs to. */
+enum class GpuPassKind(internal val category: String) {
+    RENDER("render"),
+    COMPUTE("compute")
+}
+
+/**
+ * Times every render and compute pass of a device on the GPU with timestamp queries.
+ *
+ * Once [install]ed, command encoders of the device add timestamp writes to each pass that
+ * doesn't supply its own and resolve them in [GpuCommandEncoder.finish], so no renderer
+ * code has to be instrumented. Frames rotate through [framesInFlight] query sets. After
+ * [endFrame] the results are read back in [scope] and reported to
+ * [PerformanceProfiler.recordGpuFrame], which places them next to the CPU measurements of
+ * the same frame. A frame whose query set is still being read back goes untimed rather
+ * than stalling the CPU.
+ */
+class GpuPassTimer private constructor(
+    private val device: GpuDevice,
+    private val scope: CoroutineScope,
+    val maxPassesPerFrame: Int,
+    framesInFlight: Int
+) {
+    private class Slot(
+        val querySet: GpuQuerySet,
+        val resolveBuffer: GpuBuffer,
+        val readbackBuffer: GpuBuffer
+    ) {
+        val names = ArrayList<String>()
+        val kinds = ArrayList<GpuPassKind>()
+        var resolved = 0
+        val busy = atomic(false)
+    }
+
+    private val slots = List(framesInFlight) { index ->
+        val bytes = maxPassesPerFrame * 2L * Long.SIZE_BYTES
+        Slot(
+            device.createQuerySet(
+                GpuQuerySetDescriptor(GpuQueryType.TIMESTAMP, maxPassesPerFrame * 2, "pass-timer-queries-$index")
+            ),
+            device.createBuffer(
+                GpuBufferDescriptor(
+                    label = "pass-timer-resolve-$index",
+                    size = bytes,
+                    usage = gpuBufferUsage(GpuBufferUsage.QUERY_RESOLVE, GpuBufferUsage.COPY_SRC)
+                )
+            ),
+            device.createBuffer(
+                GpuBufferDescriptor(
+                    label = "pass-timer-readback-$index",
+                    size = bytes,
+                    usage = gpuBufferUsage(GpuBufferUsage.MAP_READ, GpuBufferUsage.COPY_DST)
+                )
+            )
+        )
+    }
+    private var current: Slot? = null
+
+    /** Number of frames dropped because every query set was still being read back. */
+    var skippedFrames: Int = 0
+        private set
+
+    /** Starts timing the passes encoded until [endFrame]. */
+    fun beginFrame() {
+        current?.busy?.value = false
+        current = slots.firstOrNull { it.busy.compareAndSet(false, true) }?.also {
+            it.names.clear()
+            it.kinds.clear()
+            it.resolved = 0
+        }
+        if (current == null) skippedFrames++
+    }
+
+    /**
+     * Ends the frame after its command buffers were submitted and starts reading back the
+     * results of [frameNumber].
+     *
+     * @param submittedAtNanos [Platform.currentTimeNanos] read just before the submit call.
+     *   The GPU can start as soon as submit is entered, so only a time taken before it is
+     *   guaranteed to precede the frame's first timestamp, which the clock alignment needs.
+     */
+    fun endFrame(submittedAtNanos: Long, frameNumber: Int = PerformanceProfiler.currentFrameNumber()) {
+        val slot = current ?: return
+        current = null
+        val count = slot.resolved
+        if (count == 0) {
+            slot.busy.value = false
+            return
+        }
+        val names = slot.names.subList(0, count).toList()
+        val kinds = slot.kinds.subList(0, count).toList()
+        scope.launch {
+            try {
+                val bytes = slot.readbackBuffer.mapRead(0L, count * 2L * Long.SIZE_BYTES)
+                val passes = List(count) { i ->
+                    GpuPassSpan(names[i], kinds[i].category, bytes.readLong(i * 16), bytes.readLong(i * 16 + 8))
+                }
+                PerformanceProfiler.recordGpuFrame(frameNumber, submittedAtNanos, passes)
+            } finally {
+                slot.busy.value = false
+            }
+        }
+    }
+
+    /** Timestamp writes for the next pass, or null when the frame is untimed or full. */
+    internal fun timestampWrites(label: String?, kind: GpuPassKind): GpuPassTimestampWrites? {
+        val slot = current ?: return null
+        val index = slot.names.size
+        if (index >= maxPassesPerFrame) return null
+        slot.names += label ?: "${kind.category}-pass-$index"
+        slot.kinds += kind
+        return GpuPassTimestampWrites(slot.querySet, index * 2, index * 2 + 1)
+    }
+
+    /** Resolves the passes recorded since the last resolve; called when [encoder] finishes. */
+    internal fun resolve(encoder: GpuCommandEncoder) {
+        val slot = current ?: return
+        val first = slot.resolved
+        val count = slot.names.size - first
+        if (count == 0) return
+        // Resolves must land on 256-byte offsets, so stage at zero and copy into place
+        val bytes = count * 2L * Long.SIZE_BYTES
+        encoder.resolveQuerySet(slot.querySet, first * 2, count * 2, slot.resolveBuffer, 0L)
+        encoder.copyBufferToBuffer(slot.resolveBuffer, 0L, slot.readbackBuffer, first * 2L * Long.SIZE_BYTES, bytes)
+        slot.resolved = slot.names.size
+    }
+
+    fun dispose() {
+        if (device.passTimer === this) device.passTimer = null
+        current = null
+        slots.forEach {
+            it.querySet.destroy()
+            it.resolveBuffer.destroy()
+            it.readbackBuffer.destroy()
+        }
+    }
+
+    companion object {
+        /**
+         * Creates a timer for [device] and attaches it as [GpuDevice.passTimer], or returns
+         * null when the device lacks timestamp queries.
+         */
+        fun install(
+            device: GpuDevice,
+            scope: CoroutineScope,
+            maxPassesPerFrame: Int = 64,
+            framesInFlight: Int = 3
+        ): GpuPassTimer? {
+            require(maxPassesPerFrame in 1..GpuQuerySetDescriptor.MAX_QUERIES / 2) {
+                "maxPassesPerFrame must be within 1..${GpuQuerySetDescriptor.MAX_QUERIES / 2}"
+            }
+            require(framesInFlight >= 1) { "framesInFlight must be >= 1 (was $framesInFlight)" }
+            if (!device.supportsTimestampQueries) return null
+            return GpuPassTimer(device, scope, maxPassesPerFrame, framesInFlight).also { device.passTimer = it }
+        }
+    }
+}
+
+private fun ByteArray.readLong(offset: Int): Long {
+    var value = 0L
+    for (i in 7 downTo 0) {
+        value = (value shl 8) or (this[offset + i].toLong() and 0xFF)
+    }
+    return value
+}
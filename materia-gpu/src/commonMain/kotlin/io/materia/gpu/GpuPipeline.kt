@@ -49,12 +49,23 @@ data class GpuBindGroupLayoutDescriptor(
  * @property binding Slot index in the bind group.
  * @property visibility Which shader stages can access this binding.
  * @property resourceType Type of resource expected at this binding.
+ * @property hasDynamicOffset Buffer bindings only: the offset is supplied per
+ *   draw via [GpuRenderPassEncoder.setBindGroup] instead of being fixed in the bind group.
+ * @property storageTextureFormat Format of a [GpuBindingResourceType.STORAGE_TEXTURE] binding.
  */
 data class GpuBindGroupLayoutEntry(
     val binding: Int,
     val visibility: Set<GpuShaderStage>,
-    val resourceType: GpuBindingResourceType
-)
+    val resourceType: GpuBindingResourceType,
+    val hasDynamicOffset: Boolean = false,
+    val storageTextureFormat: GpuTextureFormat? = null
+) {
+    init {
+        require(resourceType != GpuBindingResourceType.STORAGE_TEXTURE || storageTextureFormat != null) {
+            "Storage texture binding $binding requires a storageTextureFormat"
+        }
+    }
+}
 
 /**
  * Configuration for creating a bind group.
@@ -86,10 +97,18 @@ enum class GpuBindingResourceType {
     UNIFORM_BUFFER,
     /** Storage buffer (read/write, large). */
     STORAGE_BUFFER,
+    /** Read-only storage buffer; the only storage kind vertex shaders may bind. */
+    READ_ONLY_STORAGE_BUFFER,
     /** Texture sampler. */
     SAMPLER,
     /** Texture for sampling. */
-    TEXTURE
+    TEXTURE,
+    /** Depth texture read with `textureLoad` or a comparison sampler. */
+    DEPTH_TEXTURE,
+    /** Float texture read with `textureLoad` only (e.g. R32_FLOAT). */
+    UNFILTERABLE_TEXTURE,
+    /** Write-only storage texture for compute output. */
+    STORAGE_TEXTURE
 }
 
 /**
@@ -279,10 +298,12 @@ data class GpuRenderPipelineDescriptor(
  *
  * @property label Optional debug label.
  * @property shader Compute shader module.
+ * @property bindGroupLayouts Explicit layouts; empty derives the layout from the shader.
  */
 data class GpuComputePipelineDescriptor(
     val label: String? = null,
-    val shader: GpuShaderModule
+    val shader: GpuShaderModule,
+    val bindGroupLayouts: List<GpuBindGroupLayout> = emptyList()
 )
 
 /** Compiled shader code ready for use in pipelines. */
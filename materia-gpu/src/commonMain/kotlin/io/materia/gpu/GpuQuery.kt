@@ -0,0 +1,49 @@
+package io.materia.gpu
+
+/**
+ * Kinds of GPU queries.
+ *
+ * WebGPU has no pipeline-statistics queries, so only timestamps are exposed; on the
+ * Vulkan backend wgpu records them with `vkCmdWriteTimestamp`.
+ */
+enum class GpuQueryType {
+    /** 64-bit GPU timestamps in nanoseconds, written around passes. */
+    TIMESTAMP
+}
+
+/**
+ * Configuration for creating a query set.
+ *
+ * @property type Kind of query stored in the set.
+ * @property count Number of queries.
+ * @property label Optional debug label.
+ */
+data class GpuQuerySetDescriptor(
+    val type: GpuQueryType,
+    val count: Int,
+    val label: String? = null
+) {
+    init {
+        require(count in 1..MAX_QUERIES) { "Query count must be within 1..$MAX_QUERIES (was $count)" }
+    }
+
+    companion object {
+        /** Largest query set WebGPU allows. */
+        const val MAX_QUERIES = 4096
+    }
+}
+
+/**
+ * Set of GPU queries written by passes and read back with
+ * [GpuCommandEncoder.resolveQuerySet]. Timestamp sets need
+ * [GpuDevice.supportsTimestampQueries].
+ */
+expect class GpuQuerySet internal constructor(
+    device: GpuDevice,
+    descriptor: GpuQuerySetDescriptor
+) {
+    val device: GpuDevice
+    val descriptor: GpuQuerySetDescriptor
+
+    fun destroy()
+}
@@ -24,7 +24,9 @@ enum class GpuBufferUsage(internal val mask: Int) {
     /** Buffer can be used as a storage buffer. */
     STORAGE(0x0080),
     /** Buffer can be used for indirect draw/dispatch commands. */
-    INDIRECT(0x0100)
+    INDIRECT(0x0100),
+    /** Buffer can receive resolved query results. */
+    QUERY_RESOLVE(0x0200)
 }
 
 typealias GpuBufferUsageFlags = Int
@@ -66,7 +68,9 @@ enum class GpuTextureFormat {
     /** 16-bit RGBA float for HDR rendering. */
     RGBA16_FLOAT,
     /** 24-bit depth buffer. */
-    DEPTH24_PLUS
+    DEPTH24_PLUS,
+    /** 32-bit single-channel float; storage-capable, used for depth pyramids. */
+    R32_FLOAT
 }
 
 /** Texture dimensionality. */
@@ -234,6 +238,8 @@ data class GpuSurfaceConfiguration(
  * GPU buffer for storing vertex, index, uniform, or storage data.
  *
  * Data can be uploaded via [write] (bytes) or [writeFloats] (floats).
+ * [writeFloats] accepts a sub-range of the source array so large CPU-side
+ * staging arrays can be uploaded partially without copying them first.
  * Call [destroy] to release GPU resources when no longer needed.
  */
 expect class GpuBuffer internal constructor(
@@ -244,7 +250,19 @@ expect class GpuBuffer internal constructor(
     val descriptor: GpuBufferDescriptor
 
     fun write(data: ByteArray, offset: Int = 0)
-    fun writeFloats(data: FloatArray, offset: Int = 0)
+    fun writeFloats(
+        data: FloatArray,
+        offset: Int = 0,
+        dataOffset: Int = 0,
+        count: Int = data.size - dataOffset
+    )
+
+    /**
+     * Maps [size] bytes at [offset] for reading once the GPU is done with them, copies them
+     * out and unmaps. The buffer needs [GpuBufferUsage.MAP_READ]; suspends until the
+     * commands writing it have completed.
+     */
+    suspend fun mapRead(offset: Long = 0L, size: Long = descriptor.size - offset): ByteArray
     fun destroy()
 }
 
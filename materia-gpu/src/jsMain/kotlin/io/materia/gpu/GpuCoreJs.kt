@@ -120,8 +120,18 @@ actual class GpuDevice actual constructor(
                 binding = entry.binding.toUInt(),
                 visibility = entry.visibility.toWgpu(),
                 buffer = when (entry.resourceType) {
-                    GpuBindingResourceType.UNIFORM_BUFFER -> BufferBindingLayout(type = GPUBufferBindingType.Uniform)
-                    GpuBindingResourceType.STORAGE_BUFFER -> BufferBindingLayout(type = GPUBufferBindingType.Storage)
+                    GpuBindingResourceType.UNIFORM_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.Uniform,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
+                    GpuBindingResourceType.STORAGE_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.Storage,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
+                    GpuBindingResourceType.READ_ONLY_STORAGE_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.ReadOnlyStorage,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
                     else -> null
                 },
                 sampler = when (entry.resourceType) {
@@ -130,6 +140,19 @@ actual class GpuDevice actual constructor(
                 },
                 texture = when (entry.resourceType) {
                     GpuBindingResourceType.TEXTURE -> TextureBindingLayout()
+                    GpuBindingResourceType.DEPTH_TEXTURE -> TextureBindingLayout(
+                        sampleType = GPUTextureSampleType.Depth
+                    )
+                    GpuBindingResourceType.UNFILTERABLE_TEXTURE -> TextureBindingLayout(
+                        sampleType = GPUTextureSampleType.UnfilterableFloat
+                    )
+                    else -> null
+                },
+                storageTexture = when (entry.resourceType) {
+                    GpuBindingResourceType.STORAGE_TEXTURE -> StorageTextureBindingLayout(
+                        access = GPUStorageTextureAccess.WriteOnly,
+                        format = requireNotNull(entry.storageTextureFormat).toWgpu()
+                    )
                     else -> null
                 }
             )
@@ -245,9 +268,18 @@ actual class GpuDevice actual constructor(
     }
 
     actual fun createComputePipeline(descriptor: GpuComputePipelineDescriptor): GpuComputePipeline {
+        val layout = if (descriptor.bindGroupLayouts.isNotEmpty()) {
+            wgpuDevice.createPipelineLayout(
+                PipelineLayoutDescriptor(
+                    bindGroupLayouts = descriptor.bindGroupLayouts.map { it.wgpuLayout }
+                )
+            )
+        } else null
+
         val wgpuPipeline = wgpuDevice.createComputePipeline(
             ComputePipelineDescriptor(
                 label = descriptor.label ?: "",
+                layout = layout,
                 compute = ProgrammableStage(
                     module = descriptor.shader.wgpuModule,
                     entryPoint = "main"
@@ -257,7 +289,24 @@ actual class GpuDevice actual constructor(
         return GpuComputePipeline(this, descriptor, wgpuPipeline)
     }
 
+    actual fun createQuerySet(descriptor: GpuQuerySetDescriptor): GpuQuerySet {
+        val wgpuQuerySet = wgpuDevice.createQuerySet(
+            QuerySetDescriptor(
+                label = descriptor.label ?: "",
+                type = descriptor.type.toWgpu(),
+                count = descriptor.count.toUInt()
+            )
+        )
+        return GpuQuerySet(this, descriptor, wgpuQuerySet)
+    }
+
+    actual val supportsTimestampQueries: Boolean
+        get() = GPUFeatureName.TimestampQuery in wgpuDevice.features
+
+    actual var passTimer: GpuPassTimer? = null
+
     actual fun destroy() {
+        passTimer?.dispose()
         wgpuDevice.close()
     }
 }
@@ -274,8 +323,9 @@ actual class GpuQueue actual constructor(
         wgpuQueue.submit(commandBuffers.map { it.wgpuCommandBuffer })
     }
     
-    fun writeBuffer(buffer: GpuBuffer, offset: Long, data: ByteArray) {
-        wgpuQueue.writeBuffer(buffer.wgpuBuffer, offset.toULong(), data)
+    /** Writes the first [size] bytes of [data] into [buffer] at [offset]. */
+    fun writeBuffer(buffer: GpuBuffer, offset: Long, data: ByteArray, size: Int = data.size) {
+        wgpuQueue.writeBuffer(buffer.wgpuBuffer, offset.toULong(), data, 0u, size.toULong())
     }
 }
 
@@ -387,6 +437,7 @@ internal fun GpuBufferUsageFlags.toWgpuBufferUsage(): Set<GPUBufferUsage> = buil
     if (this@toWgpuBufferUsage and GpuBufferUsage.UNIFORM.mask != 0) add(GPUBufferUsage.Uniform)
     if (this@toWgpuBufferUsage and GpuBufferUsage.STORAGE.mask != 0) add(GPUBufferUsage.Storage)
     if (this@toWgpuBufferUsage and GpuBufferUsage.INDIRECT.mask != 0) add(GPUBufferUsage.Indirect)
+    if (this@toWgpuBufferUsage and GpuBufferUsage.QUERY_RESOLVE.mask != 0) add(GPUBufferUsage.QueryResolve)
 }
 
 internal fun GpuTextureUsageFlags.toWgpuTextureUsage(): Set<GPUTextureUsage> = buildSet {
@@ -408,6 +459,7 @@ internal fun GpuTextureFormat.toWgpu(): GPUTextureFormat = when (this) {
     GpuTextureFormat.BGRA8_UNORM -> GPUTextureFormat.BGRA8Unorm
     GpuTextureFormat.RGBA16_FLOAT -> GPUTextureFormat.RGBA16Float
     GpuTextureFormat.DEPTH24_PLUS -> GPUTextureFormat.Depth24Plus
+    GpuTextureFormat.R32_FLOAT -> GPUTextureFormat.R32Float
 }
 
 internal fun GpuAddressMode.toWgpu(): GPUAddressMode = when (this) {
@@ -514,3 +566,7 @@ internal fun GpuCompositeAlphaMode.toWgpu(): CompositeAlphaMode = when (this) {
     GpuCompositeAlphaMode.UNPREMULTIPLIED -> CompositeAlphaMode.Unpremultiplied
     GpuCompositeAlphaMode.INHERIT -> CompositeAlphaMode.Inherit
 }
+
+internal fun GpuQueryType.toWgpu(): GPUQueryType = when (this) {
+    GpuQueryType.TIMESTAMP -> GPUQueryType.Timestamp
+}
@@ -133,8 +133,18 @@ actual class GpuDevice actual constructor(
                 binding = entry.binding.toUInt(),
                 visibility = entry.visibility.toWgpu(),
                 buffer = when (entry.resourceType) {
-                    GpuBindingResourceType.UNIFORM_BUFFER -> BufferBindingLayout(type = GPUBufferBindingType.Uniform)
-                    GpuBindingResourceType.STORAGE_BUFFER -> BufferBindingLayout(type = GPUBufferBindingType.Storage)
+                    GpuBindingResourceType.UNIFORM_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.Uniform,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
+                    GpuBindingResourceType.STORAGE_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.Storage,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
+                    GpuBindingResourceType.READ_ONLY_STORAGE_BUFFER -> BufferBindingLayout(
+                        type = GPUBufferBindingType.ReadOnlyStorage,
+                        hasDynamicOffset = entry.hasDynamicOffset
+                    )
                     else -> null
                 },
                 sampler = when (entry.resourceType) {
@@ -143,6 +153,19 @@ actual class GpuDevice actual constructor(
                 },
                 texture = when (entry.resourceType) {
                     GpuBindingResourceType.TEXTURE -> TextureBindingLayout()
+                    GpuBindingResourceType.DEPTH_TEXTURE -> TextureBindingLayout(
+                        sampleType = GPUTextureSampleType.Depth
+                    )
+                    GpuBindingResourceType.UNFILTERABLE_TEXTURE -> TextureBindingLayout(
+                        sampleType = GPUTextureSampleType.UnfilterableFloat
+                    )
+                    else -> null
+                },
+                storageTexture = when (entry.resourceType) {
+                    GpuBindingResourceType.STORAGE_TEXTURE -> StorageTextureBindingLayout(
+                        access = GPUStorageTextureAccess.WriteOnly,
+                        format = requireNotNull(entry.storageTextureFormat).toWgpu()
+                    )
                     else -> null
                 }
             )
@@ -258,9 +281,18 @@ actual class GpuDevice actual constructor(
     }
 
     actual fun createComputePipeline(descriptor: GpuComputePipelineDescriptor): GpuComputePipeline {
+        val layout = if (descriptor.bindGroupLayouts.isNotEmpty()) {
+            wgpuDevice.createPipelineLayout(
+                PipelineLayoutDescriptor(
+                    bindGroupLayouts = descriptor.bindGroupLayouts.map { it.wgpuLayout }
+                )
+            )
+        } else null
+
         val wgpuPipeline = wgpuDevice.createComputePipeline(
             ComputePipelineDescriptor(
                 label = descriptor.label ?: "",
+                layout = layout,
                 compute = ProgrammableStage(
                     module = descriptor.shader.wgpuModule,
                     entryPoint = "main"
@@ -270,7 +302,24 @@ actual class GpuDevice actual constructor(
         return GpuComputePipeline(this, descriptor, wgpuPipeline)
     }
 
+    actual fun createQuerySet(descriptor: GpuQuerySetDescriptor): GpuQuerySet {
+        val wgpuQuerySet = wgpuDevice.createQuerySet(
+            QuerySetDescriptor(
+                label = descriptor.label ?: "",
+                type = descriptor.type.toWgpu(),
+                count = descriptor.count.toUInt()
+            )
+        )
+        return GpuQuerySet(this, descriptor, wgpuQuerySet)
+    }
+
+    actual val supportsTimestampQueries: Boolean
+        get() = GPUFeatureName.TimestampQuery in wgpuDevice.features
+
+    actual var passTimer: GpuPassTimer? = null
+
     actual fun destroy() {
+        passTimer?.dispose()
         wgpuDevice.close()
     }
 }
@@ -287,8 +336,9 @@ actual class GpuQueue actual constructor(
         wgpuQueue.submit(commandBuffers.map { it.wgpuCommandBuffer })
     }
     
-    fun writeBuffer(buffer: GpuBuffer, offset: Long, data: ByteArray) {
-        wgpuQueue.writeBuffer(buffer.wgpuBuffer, offset.toULong(), data)
+    /** Writes the first [size] bytes of [data] into [buffer] at [offset]. */
+    fun writeBuffer(buffer: GpuBuffer, offset: Long, data: ByteArray, size: Int = data.size) {
+        wgpuQueue.writeBuffer(buffer.wgpuBuffer, offset.toULong(), data, 0u, size.toULong())
     }
 }
 
@@ -440,7 +490,9 @@ private suspend fun createWgpuContextFromWindow(
     val adapter = wgpu.requestAdapter(nativeSurface)
         ?: error("Failed to get GPU adapter")
     
-    val device = adapter.requestDevice(DeviceDescriptor())
+    // Timestamp queries back GpuPassTimer; only ask for them where the adapter has them
+    val features = setOf(GPUFeatureName.TimestampQuery).filter { it in adapter.features }.toSet()
+    val device = adapter.requestDevice(DeviceDescriptor(requiredFeatures = features))
         .getOrThrow()
     
     nativeSurface.computeSurfaceCapabilities(adapter)
@@ -525,6 +577,7 @@ internal fun GpuBufferUsageFlags.toWgpuBufferUsage(): Set<GPUBufferUsage> = buil
     if (this@toWgpuBufferUsage and GpuBufferUsage.UNIFORM.mask != 0) add(GPUBufferUsage.Uniform)
     if (this@toWgpuBufferUsage and GpuBufferUsage.STORAGE.mask != 0) add(GPUBufferUsage.Storage)
     if (this@toWgpuBufferUsage and GpuBufferUsage.INDIRECT.mask != 0) add(GPUBufferUsage.Indirect)
+    if (this@toWgpuBufferUsage and GpuBufferUsage.QUERY_RESOLVE.mask != 0) add(GPUBufferUsage.QueryResolve)
 }
 
 internal fun GpuTextureUsageFlags.toWgpuTextureUsage(): Set<GPUTextureUsage> = buildSet {
@@ -546,6 +599,7 @@ internal fun GpuTextureFormat.toWgpu(): GPUTextureFormat = when (this) {
     GpuTextureFormat.BGRA8_UNORM -> GPUTextureFormat.BGRA8Unorm
     GpuTextureFormat.RGBA16_FLOAT -> GPUTextureFormat.RGBA16Float
     GpuTextureFormat.DEPTH24_PLUS -> GPUTextureFormat.Depth24Plus
+    GpuTextureFormat.R32_FLOAT -> GPUTextureFormat.R32Float
 }
 
 internal fun GPUTextureFormat.toMateriaFormat(): GpuTextureFormat = when (this) {
@@ -555,6 +609,7 @@ internal fun GPUTextureFormat.toMateriaFormat(): GpuTextureFormat = when (this)
     GPUTextureFormat.BGRA8UnormSrgb -> GpuTextureFormat.BGRA8_UNORM
     GPUTextureFormat.RGBA16Float -> GpuTextureFormat.RGBA16_FLOAT
     GPUTextureFormat.Depth24Plus -> GpuTextureFormat.DEPTH24_PLUS
+    GPUTextureFormat.R32Float -> GpuTextureFormat.R32_FLOAT
     else -> GpuTextureFormat.BGRA8_UNORM // Default fallback
 }
 
@@ -662,3 +717,7 @@ internal fun GpuCompositeAlphaMode.toWgpu(): CompositeAlphaMode = when (this) {
     GpuCompositeAlphaMode.UNPREMULTIPLIED -> CompositeAlphaMode.Unpremultiplied
     GpuCompositeAlphaMode.INHERIT -> CompositeAlphaMode.Inherit
 }
+
+internal fun GpuQueryType.toWgpu(): GPUQueryType = when (this) {
+    GpuQueryType.TIMESTAMP -> GPUQueryType.Timestamp
+}
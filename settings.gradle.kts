@@ -43,6 +43,9 @@ include(":materia-gpu")
 // materia-gpu-android-native removed: wgpu4k-toolkit handles Android GPU backend
 include(":materia-engine")
 
+// Renderer benchmarks with a regression gate (runs on JVM/Vulkan)
+include(":materia-benchmarks")
+
 // Example projects
 include(":examples:triangle")
 include(":examples:triangle-android")
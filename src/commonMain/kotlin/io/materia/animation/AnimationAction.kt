@@ -1,9 +1,5 @@
 package io.materia.animation
 
-import io.materia.core.math.Euler
-import io.materia.core.math.Quaternion
-import io.materia.core.math.Vector3
-
 /**
  * Animation action interface for controlling individual animation playback
  * Provides play, pause, stop, and fade functionality
@@ -144,6 +140,10 @@ class DefaultClipAction(
     private var fadeStartWeight = 0f
     private var fadeInitialized = false
 
+    // Used when driven directly rather than through a DefaultAnimationMixer
+    private var ownPose: AnimationPose? = null
+    private var ownBinding: ClipBinding? = null
+
     override fun play(): AnimationAction {
         if (_isDisposed) return this
 
@@ -224,7 +224,18 @@ class DefaultClipAction(
     }
 
     override fun update(deltaTime: Float) {
-        if (_isDisposed || !_isRunning || _isPaused) return
+        if (advance(deltaTime)) {
+            // Apply animation to the target object
+            applyAnimation()
+        }
+    }
+
+    /**
+     * Advances time and fades by [deltaTime] without applying the clip. Returns whether the
+     * action is still playing at a non-zero weight.
+     */
+    internal fun advance(deltaTime: Float): Boolean {
+        if (_isDisposed || !_isRunning || _isPaused) return false
 
         // Update animation time
         time += deltaTime * timeScale
@@ -235,7 +246,7 @@ class DefaultClipAction(
         } else if (!loop && time > clip.duration) {
             time = clip.duration
             stop()
-            return
+            return false
         }
 
         // Update fading
@@ -267,213 +278,15 @@ class DefaultClipAction(
             }
         }
 
-        // Apply animation to the target object
-        applyAnimation()
+        return weight > 0f
     }
 
     private fun applyAnimation() {
-        if (weight <= 0f) return
-
-        // Apply animation tracks to the target object
-        clip.tracks.forEach { track ->
-            val value = interpolateTrack(track, time)
-            applyTrackValue(track.name, value)
-        }
-    }
-
-    private fun interpolateTrack(track: KeyframeTrack, time: Float): FloatArray {
-        val times = track.times
-        val values = track.values
-
-        // Check for empty times to avoid division by zero
-        if (times.isEmpty()) {
-            return floatArrayOf()
-        }
-
-        val valuesPerKey = if (times.isNotEmpty()) values.size / times.size else 0
-
-        // Find the keyframe indices
-        var index = 0
-        for (i in times.indices) {
-            if (time >= times[i]) {
-                index = i
-            } else {
-                break
-            }
-        }
-
-        val nextIndex = (index + 1).coerceAtMost(times.lastIndex)
-
-        if (index == nextIndex) {
-            // Return the exact value
-            val startIdx = index * valuesPerKey
-            return values.sliceArray(startIdx until startIdx + valuesPerKey)
-        }
-
-        // Interpolate between keyframes
-        val t1 = times[index]
-        val t2 = times[nextIndex]
-        val alpha = ((time - t1) / (t2 - t1)).coerceIn(0f, 1f)
-
-        val startIdx1 = index * valuesPerKey
-        val startIdx2 = nextIndex * valuesPerKey
-
-        val result = FloatArray(valuesPerKey)
-        for (i in 0 until valuesPerKey) {
-            if (startIdx1 + i < values.size && startIdx2 + i < values.size) {
-                val v1 = values[startIdx1 + i]
-                val v2 = values[startIdx2 + i]
-                result[i] = when (track.interpolation) {
-                    InterpolationType.LINEAR -> v1 + (v2 - v1) * alpha
-                    InterpolationType.STEP -> v1
-                    InterpolationType.CUBIC_SPLINE -> {
-                        // Simplified cubic interpolation
-                        v1 + (v2 - v1) * alpha * alpha * (3f - 2f * alpha)
-                    }
-                }
-            }
-        }
-
-        return result
-    }
-
-    private fun applyTrackValue(trackName: String, value: FloatArray) {
-        // Apply the animated value to the target object
-        val root = mixer.root
-
-        // Parse track name to extract property and potential sub-paths
-        val parts = trackName.split(".")
-        val propertyName = parts.lastOrNull() ?: return
-
-        // Handle standard Three.js-style track names
-        when {
-            propertyName == "position" || trackName.endsWith(".position") -> {
-                if (value.size >= 3) {
-                    val blendedPos = root.position.clone()
-                    val newPos = Vector3(value[0], value[1], value[2])
-
-                    // Apply with blending based on weight
-                    if (weight >= 1f) {
-                        root.position.copy(newPos)
-                    } else if (weight > 0f) {
-                        root.position.copy(blendedPos.lerp(newPos, weight))
-                    }
-                }
-            }
-
-            propertyName == "quaternion" || trackName.endsWith(".quaternion") -> {
-                if (value.size >= 4) {
-                    val blendedRot = root.quaternion.clone()
-                    val newRot = Quaternion(value[0], value[1], value[2], value[3]).normalize()
-
-                    // Apply with blending based on weight
-                    if (weight >= 1f) {
-                        root.quaternion.copy(newRot)
-                    } else if (weight > 0f) {
-                        root.quaternion.copy(blendedRot.slerp(newRot, weight))
-                    }
-                }
-            }
-
-            propertyName == "rotation" || trackName.endsWith(".rotation") -> {
-                // Euler rotation support
-                if (value.size >= 3) {
-                    val euler = Euler(value[0], value[1], value[2])
-                    val newRot = Quaternion().setFromEuler(euler)
-                    val blendedRot = root.quaternion.clone()
-
-                    // Apply with blending based on weight
-                    if (weight >= 1f) {
-                        root.quaternion.copy(newRot)
-                    } else if (weight > 0f) {
-                        root.quaternion.copy(blendedRot.slerp(newRot, weight))
-                    }
-                }
-            }
-
-            propertyName == "scale" || trackName.endsWith(".scale") -> {
-                if (value.size >= 3) {
-                    val blendedScale = root.scale.clone()
-                    val newScale = Vector3(value[0], value[1], value[2])
-
-                    // Apply with blending based on weight
-                    if (weight >= 1f) {
-                        root.scale.copy(newScale)
-                    } else if (weight > 0f) {
-                        root.scale.copy(blendedScale.lerp(newScale, weight))
-                    }
-                }
-            }
-
-            // Support for morph targets
-            propertyName.startsWith("morphTargetInfluences[") -> {
-                val index = propertyName.substringAfter("[").substringBefore("]").toIntOrNull()
-                if (index != null && value.isNotEmpty()) {
-                    // Morph target influences stored in userData for mesh renderer access
-                    @Suppress("UNCHECKED_CAST")
-                    val morphTargets = root.userData["morphTargetInfluences"] as? MutableList<Float>
-                        ?: mutableListOf<Float>().also {
-                            root.userData["morphTargetInfluences"] = it
-                        }
-
-                    while (morphTargets.size <= index) {
-                        morphTargets.add(0f)
-                    }
-
-                    val currentValue = morphTargets[index]
-                    morphTargets[index] = if (weight >= 1f) {
-                        value[0]
-                    } else {
-                        currentValue + (value[0] - currentValue) * weight
-                    }
-                }
-            }
-
-            // Support for material properties
-            propertyName == "opacity" || trackName.contains("material.opacity") -> {
-                if (value.isNotEmpty()) {
-                    @Suppress("UNCHECKED_CAST")
-                    val materials = root.userData["materials"] as? MutableMap<String, Any>
-                        ?: mutableMapOf<String, Any>().also { root.userData["materials"] = it }
-
-                    val currentOpacity = (materials["opacity"] as? Float) ?: 1f
-                    materials["opacity"] = if (weight >= 1f) {
-                        value[0]
-                    } else {
-                        currentOpacity + (value[0] - currentOpacity) * weight
-                    }
-                }
-            }
-
-            // Support for visibility
-            propertyName == "visible" -> {
-                if (value.isNotEmpty()) {
-                    // Visibility is typically binary, but we can use weight as threshold
-                    root.visible = value[0] > 0.5f || (weight < 0.5f && root.visible)
-                }
-            }
-
-            // Support for custom properties via userData
-            else -> {
-                // Store in userData for custom property animation
-                @Suppress("UNCHECKED_CAST")
-                val animatedProps =
-                    root.userData["animatedProperties"] as? MutableMap<String, FloatArray>
-                        ?: mutableMapOf<String, FloatArray>().also {
-                            root.userData["animatedProperties"] = it
-                        }
-
-                if (weight >= 1f) {
-                    animatedProps[trackName] = value.copyOf()
-                } else if (weight > 0f) {
-                    val current = animatedProps[trackName] ?: FloatArray(value.size) { 0f }
-                    val blended = FloatArray(value.size) { i ->
-                        current[i] + (value[i] - current[i]) * weight
-                    }
-                    animatedProps[trackName] = blended
-                }
-            }
-        }
+        val pose = ownPose ?: AnimationPose().also { ownPose = it }
+        val binding = ownBinding ?: ClipBinding(clip, pose).also { ownBinding = it }
+        pose.begin()
+        binding.accumulate(time, weight)
+        pose.apply(mixer.root)
     }
 
     override fun dispose() {
@@ -215,6 +215,21 @@ object AnimationCompressor {
         return processedTrack
     }
 
+    /**
+     * Quantizes a (typically already compressed) track for playback: rotations are
+     * smallest-three packed at [CompressionConfig.quaternionBits], everything else is
+     * stored as 16-bit fixed point over the track's range. Put the result in
+     * [AnimationClip.quantizedTracks] to sample it without decompressing.
+     */
+    fun quantize(track: AnimationTrack, config: CompressionConfig = CompressionConfig()): QuantizedTrack =
+        when (track.type) {
+            AnimationTrack.TrackType.ROTATION -> QuaternionCompressor.quantizeTrack(track, config.quaternionBits)
+            AnimationTrack.TrackType.POSITION, AnimationTrack.TrackType.SCALE -> QuantizedVectorTrack.quantize(track, 3)
+            AnimationTrack.TrackType.MORPH_WEIGHTS -> QuantizedVectorTrack.quantize(track, 1)
+            AnimationTrack.TrackType.CUSTOM ->
+                QuantizedVectorTrack.quantize(track, track.keyframes.minOfOrNull { it.value.size }?.coerceAtLeast(1) ?: 1)
+        }
+
     /**
      * Batch compress multiple animations
      */
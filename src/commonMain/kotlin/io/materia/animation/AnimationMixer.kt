@@ -1,6 +1,12 @@
 package io.materia.animation
 
+import io.materia.animation.compression.QuantizedTrack
 import io.materia.core.scene.Object3D
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
 
 /**
  * Animation mixer interface for managing multiple animation clips on a single object
@@ -43,9 +49,16 @@ interface AnimationMixer {
 
 /**
  * Default implementation of AnimationMixer
+ *
+ * Each clip is bound once, when its action is created, to the mixer's [AnimationPose];
+ * [update] then samples every playing action into that pose, blends by weight in place and
+ * writes the result to [root] once, instead of each action overwriting the root in turn.
  */
 class DefaultAnimationMixer(override val root: Object3D) : AnimationMixer {
     private val actions = kotlin.collections.mutableMapOf<AnimationClip, ClipAction>()
+    private val playback = ArrayList<DefaultClipAction>()
+    private val bindings = ArrayList<ClipBinding>()
+    private val pose = AnimationPose()
     private var _isDisposed = false
 
     override val isDisposed: Boolean
@@ -53,7 +66,10 @@ class DefaultAnimationMixer(override val root: Object3D) : AnimationMixer {
 
     override fun clipAction(clip: AnimationClip): ClipAction {
         return actions.getOrPut(clip) {
-            DefaultClipAction(clip, this)
+            DefaultClipAction(clip, this).also {
+                playback.add(it)
+                bindings.add(ClipBinding(clip, pose))
+            }
         }
     }
 
@@ -66,12 +82,14 @@ class DefaultAnimationMixer(override val root: Object3D) : AnimationMixer {
     override fun update(deltaTime: Float) {
         if (_isDisposed) return
 
-        // Update all active actions
-        for (action in actions.values) {
-            if (action.isRunning) {
-                action.update(deltaTime)
+        pose.begin()
+        for (i in playback.indices) {
+            val action = playback[i]
+            if (action.advance(deltaTime)) {
+                bindings[i].accumulate(action.time, action.weight)
             }
         }
+        pose.apply(root)
     }
 
     override fun dispose() {
@@ -82,29 +100,92 @@ class DefaultAnimationMixer(override val root: Object3D) : AnimationMixer {
             action.dispose()
         }
         actions.clear()
+        playback.clear()
+        bindings.clear()
         _isDisposed = true
     }
+
+    companion object {
+        const val DEFAULT_PARALLEL_TASKS = 8
+
+        /**
+         * [update]s [mixers] on up to [tasks] coroutines on [dispatcher], each taking a
+         * contiguous run of mixers. Mixers must animate distinct roots. Worth it for crowds
+         * on multi-threaded dispatchers (JVM, native); on JS the default dispatcher is
+         * single-threaded and this only adds overhead.
+         */
+        suspend fun updateParallel(
+            mixers: List<DefaultAnimationMixer>,
+            deltaTime: Float,
+            tasks: Int = DEFAULT_PARALLEL_TASKS,
+            dispatcher: CoroutineDispatcher = Dispatchers.Default
+        ) {
+            require(tasks > 0) { "tasks must be positive (was $tasks)" }
+            val chunks = minOf(tasks, mixers.size)
+            if (chunks <= 1) {
+                mixers.forEach { it.update(deltaTime) }
+                return
+            }
+            coroutineScope {
+                (0 until chunks).map { task ->
+                    async(dispatcher) {
+                        val from = mixers.size * task / chunks
+                        val to = mixers.size * (task + 1) / chunks
+                        for (i in from until to) mixers[i].update(deltaTime)
+                    }
+                }.awaitAll()
+            }
+        }
+    }
 }
 
 /**
  * Animation clip data structure
  * Contains keyframe data and timing information
+ *
+ * [quantizedTracks] are sampled straight from their compressed keys, alongside [tracks].
  */
 data class AnimationClip(
     val name: String,
     val duration: Float,
-    val tracks: List<KeyframeTrack>
+    val tracks: List<KeyframeTrack>,
+    val quantizedTracks: List<QuantizedTrack> = emptyList()
 )
 
+/**
+ * Keyframes the animation evaluator can sample: key times plus random access to key values.
+ * Implemented by float tracks ([KeyframeTrack]) and compressed ones ([QuantizedTrack]), so
+ * compressed clips play without being expanded first.
+ */
+interface SampledTrack {
+    val name: String
+    val times: FloatArray
+    val interpolation: InterpolationType
+
+    /** Floats per key. */
+    val valueSize: Int
+
+    /** Writes the [valueSize] floats of [key] into [target] at [offset]. */
+    fun readKey(key: Int, target: FloatArray, offset: Int)
+}
+
 /**
  * Keyframe track for animating specific properties
  */
 data class KeyframeTrack(
-    val name: String,
-    val times: FloatArray,
+    override val name: String,
+    override val times: FloatArray,
     val values: FloatArray,
-    val interpolation: InterpolationType = InterpolationType.LINEAR
-) {
+    override val interpolation: InterpolationType = InterpolationType.LINEAR
+) : SampledTrack {
+    override val valueSize: Int
+        get() = if (times.isEmpty()) 0 else values.size / times.size
+
+    override fun readKey(key: Int, target: FloatArray, offset: Int) {
+        val size = valueSize
+        values.copyInto(target, offset, key * size, key * size + size)
+    }
+
     override fun equals(other: Any?): Boolean {
         if (this === other) return true
         if (other == null || this::class != other::class) return false
@@ -0,0 +1,282 @@
+package io.materia.animation
+
+import io.materia.core.math.Euler
+import io.materia.core.math.Quaternion
+import io.materia.core.scene.Object3D
+import kotlin.math.sqrt
+
+/**
+ * Blended pose of one animated root, stored structure-of-arrays: every animated property is
+ * a channel whose floats sit back to back in one array, next to the summed blend weight of
+ * each channel. Clip bindings add weighted samples in place between [begin] and [apply];
+ * channels are laid out when clips are bound, so evaluating a frame allocates nothing.
+ *
+ * Where the weights of a channel sum below one, [apply] fills the rest from the root's
+ * current value, so a single action at weight `w` lerps the property toward its track by
+ * `w`. Above one the samples are normalized by the total.
+ */
+class AnimationPose {
+    enum class Target {
+        POSITION,
+        QUATERNION,
+        SCALE,
+        MORPH_INFLUENCE,
+        OPACITY,
+        VISIBLE,
+        CUSTOM
+    }
+
+    private val targets = ArrayList<Target>()
+    private val names = ArrayList<String>()
+    private var indices = IntArray(8)
+    private var offsets = IntArray(8)
+    private var widths = IntArray(8)
+    private var values = FloatArray(32)
+    private var weights = FloatArray(8)
+    private val custom = HashMap<String, FloatArray>()
+
+    val channelCount: Int
+        get() = targets.size
+
+    /** Floats of all channels together. */
+    var floatCount: Int = 0
+        private set
+
+    /**
+     * Returns the channel for [target] ([index] for morph influences, [name] for custom
+     * properties), creating it with [width] floats on first use.
+     */
+    fun channel(target: Target, width: Int, index: Int = 0, name: String = ""): Int {
+        for (c in targets.indices) {
+            if (targets[c] == target && indices[c] == index && names[c] == name) {
+                require(widths[c] == width) { "Channel $target $name bound with $width floats, had ${widths[c]}" }
+                return c
+            }
+        }
+
+        val c = targets.size
+        if (c == offsets.size) {
+            indices = indices.copyOf(c * 2)
+            offsets = offsets.copyOf(c * 2)
+            widths = widths.copyOf(c * 2)
+            weights = weights.copyOf(c * 2)
+        }
+        if (floatCount + width > values.size) {
+            values = values.copyOf(maxOf(values.size * 2, floatCount + width))
+        }
+        targets.add(target)
+        names.add(name)
+        indices[c] = index
+        offsets[c] = floatCount
+        widths[c] = width
+        floatCount += width
+        return c
+    }
+
+    /** Clears accumulated samples; call once per frame before bindings accumulate. */
+    fun begin() {
+        values.fill(0f, 0, floatCount)
+        weights.fill(0f, 0, channelCount)
+    }
+
+    /** Adds `sample * weight` to [channel], reading its floats from [sample] at [sampleOffset]. */
+    fun accumulate(channel: Int, sample: FloatArray, sampleOffset: Int, weight: Float) {
+        val offset = offsets[channel]
+        var w = weight
+        if (targets[channel] == Target.QUATERNION && weights[channel] > 0f &&
+            dot4(values, offset, sample, sampleOffset) < 0f
+        ) {
+            w = -w
+        }
+        for (i in 0 until widths[channel]) {
+            values[offset + i] += sample[sampleOffset + i] * w
+        }
+        weights[channel] += weight
+    }
+
+    /** Writes the blended channels to [root]; channels nothing accumulated into are left alone. */
+    fun apply(root: Object3D) {
+        for (c in 0 until channelCount) {
+            val total = weights[c]
+            if (total <= 0f) continue
+            val offset = offsets[c]
+            when (targets[c]) {
+                Target.POSITION -> {
+                    val p = root.position
+                    root.position.set(
+                        blend(offset, total, p.x),
+                        blend(offset + 1, total, p.y),
+                        blend(offset + 2, total, p.z)
+                    )
+                }
+
+                Target.SCALE -> {
+                    val s = root.scale
+                    root.scale.set(
+                        blend(offset, total, s.x),
+                        blend(offset + 1, total, s.y),
+                        blend(offset + 2, total, s.z)
+                    )
+                }
+
+                Target.QUATERNION -> applyQuaternion(root.quaternion, offset, total)
+
+                Target.MORPH_INFLUENCE -> {
+                    // Morph target influences stored in userData for mesh renderer access
+                    @Suppress("UNCHECKED_CAST")
+                    val morphTargets = root.userData["morphTargetInfluences"] as? MutableList<Float>
+                        ?: mutableListOf<Float>().also { root.userData["morphTargetInfluences"] = it }
+                    val index = indices[c]
+                    while (morphTargets.size <= index) {
+                        morphTargets.add(0f)
+                    }
+                    morphTargets[index] = blend(offset, total, morphTargets[index])
+                }
+
+                Target.OPACITY -> {
+                    @Suppress("UNCHECKED_CAST")
+                    val materials = root.userData["materials"] as? MutableMap<String, Any>
+                        ?: mutableMapOf<String, Any>().also { root.userData["materials"] = it }
+                    materials["opacity"] = blend(offset, total, (materials["opacity"] as? Float) ?: 1f)
+                }
+
+                Target.VISIBLE -> root.visible = blend(offset, total, if (root.visible) 1f else 0f) > 0.5f
+
+                Target.CUSTOM -> {
+                    // Custom properties live in userData, one array per track name reused across frames
+                    @Suppress("UNCHECKED_CAST")
+                    val animatedProps = root.userData["animatedProperties"] as? MutableMap<String, FloatArray>
+                        ?: mutableMapOf<String, FloatArray>().also { root.userData["animatedProperties"] = it }
+                    val name = names[c]
+                    val width = widths[c]
+                    val current = animatedProps[name]
+                    val target = current?.takeIf { it.size == width }
+                        ?: custom.getOrPut(name) { FloatArray(width) }.also { animatedProps[name] = it }
+                    for (i in 0 until width) {
+                        val previous = current?.getOrElse(i) { 0f } ?: 0f
+                        target[i] = blend(offset + i, total, previous)
+                    }
+                }
+            }
+        }
+    }
+
+    private fun blend(index: Int, total: Float, current: Float): Float =
+        if (total >= 1f) values[index] / total else values[index] + current * (1f - total)
+
+    private fun applyQuaternion(q: Quaternion, offset: Int, total: Float) {
+        var x = values[offset]
+        var y = values[offset + 1]
+        var z = values[offset + 2]
+        var w = values[offset + 3]
+        if (total < 1f) {
+            var rest = 1f - total
+            if (x * q.x + y * q.y + z * q.z + w * q.w < 0f) rest = -rest
+            x += q.x * rest
+            y += q.y * rest
+            z += q.z * rest
+            w += q.w * rest
+        }
+        val length = sqrt(x * x + y * y + z * z + w * w)
+        if (length < 1e-6f) return
+        q.set(x / length, y / length, z / length, w / length)
+    }
+
+    private fun dot4(a: FloatArray, aOffset: Int, b: FloatArray, bOffset: Int): Float =
+        a[aOffset] * b[bOffset] + a[aOffset + 1] * b[bOffset + 1] +
+                a[aOffset + 2] * b[bOffset + 2] + a[aOffset + 3] * b[bOffset + 3]
+}
+
+/**
+ * The tracks of one clip resolved to channels of one [AnimationPose], with a [KeyCursor]
+ * per track. Track names are parsed once here instead of every frame.
+ */
+internal class ClipBinding(clip: AnimationClip, private val pose: AnimationPose) {
+    private val tracks: Array<SampledTrack>
+    private val channels: IntArray
+    private val eulerTracks: BooleanArray
+    private val quaternionTracks: BooleanArray
+    private val cursors: Array<KeyCursor>
+    private val sample: FloatArray
+    private val scratch: FloatArray
+    private val euler = Euler()
+    private val rotation = Quaternion()
+
+    init {
+        val bound = ArrayList<SampledTrack>()
+        val boundChannels = ArrayList<Int>()
+        val boundEuler = ArrayList<Boolean>()
+        val boundQuaternion = ArrayList<Boolean>()
+        var widest = 4
+        val sources: List<SampledTrack> = clip.tracks + clip.quantizedTracks
+        for (track in sources) {
+            val size = track.valueSize
+            if (track.times.isEmpty() || size == 0) continue
+            val property = track.name.substringAfterLast('.')
+            var isEuler = false
+            val channel = when {
+                property == "position" && size >= 3 -> pose.channel(AnimationPose.Target.POSITION, 3)
+                property == "quaternion" && size >= 4 -> pose.channel(AnimationPose.Target.QUATERNION, 4)
+                property == "rotation" && size >= 3 -> {
+                    isEuler = true
+                    pose.channel(AnimationPose.Target.QUATERNION, 4)
+                }
+
+                property == "scale" && size >= 3 -> pose.channel(AnimationPose.Target.SCALE, 3)
+                property.startsWith("morphTargetInfluences[") -> {
+                    val index = property.substringAfter("[").substringBefore("]").toIntOrNull()
+                    index?.let { pose.channel(AnimationPose.Target.MORPH_INFLUENCE, 1, index = it) }
+                }
+
+                property == "opacity" || track.name.contains("material.opacity") ->
+                    pose.channel(AnimationPose.Target.OPACITY, 1)
+
+                property == "visible" -> pose.channel(AnimationPose.Target.VISIBLE, 1)
+                property in RESERVED -> null
+                else -> pose.channel(AnimationPose.Target.CUSTOM, size, name = track.name)
+            } ?: continue
+            bound.add(track)
+            boundChannels.add(channel)
+            boundEuler.add(isEuler)
+            boundQuaternion.add(property == "quaternion")
+            widest = maxOf(widest, size)
+        }
+        tracks = bound.toTypedArray()
+        channels = boundChannels.toIntArray()
+        eulerTracks = boundEuler.toBooleanArray()
+        quaternionTracks = boundQuaternion.toBooleanArray()
+        cursors = Array(tracks.size) { KeyCursor() }
+        sample = FloatArray(widest)
+        scratch = FloatArray(widest)
+    }
+
+    val trackCount: Int
+        get() = tracks.size
+
+    /** Samples every bound track at [time] and adds it to the pose at [weight]. */
+    fun accumulate(time: Float, weight: Float) {
+        if (weight <= 0f) return
+        for (i in tracks.indices) {
+            val track = tracks[i]
+            sampleTrack(track, cursors[i], time, sample, 0, scratch, quaternionTracks[i])
+            if (eulerTracks[i]) {
+                euler.set(sample[0], sample[1], sample[2])
+                rotation.setFromEuler(euler)
+                sample[0] = rotation.x
+                sample[1] = rotation.y
+                sample[2] = rotation.z
+                sample[3] = rotation.w
+            }
+            pose.accumulate(channels[i], sample, 0, weight)
+        }
+    }
+
+    fun reset() {
+        cursors.forEach { it.reset() }
+    }
+
+    private companion object {
+        // Matched with too few components; the old per-frame path ignored these too
+        val RESERVED = setOf("position", "quaternion", "rotation", "scale")
+    }
+}
@@ -0,0 +1,97 @@
+package io.materia.animation
+
+/**
+ * Key index of one track cached between samples. Playback moves forward a key or two per
+ * frame, so [seek] walks from the previous key instead of searching the whole track; large
+ * jumps (loop wrap-around, scrubbing) fall back to a binary search.
+ */
+class KeyCursor {
+    var key: Int = 0
+        private set
+
+    /** Returns the last key with `times[key] <= time`, or 0 when [time] precedes every key. */
+    fun seek(times: FloatArray, time: Float): Int {
+        val last = times.size - 1
+        if (last <= 0) {
+            key = 0
+            return 0
+        }
+
+        var k = key.coerceIn(0, last)
+        if (time >= times[k]) {
+            var steps = 0
+            while (k < last && time >= times[k + 1]) {
+                if (++steps > MAX_WALK) {
+                    k = search(times, time)
+                    break
+                }
+                k++
+            }
+        } else {
+            k = if (k > 0 && time >= times[k - 1]) k - 1 else search(times, time)
+        }
+        key = k
+        return k
+    }
+
+    fun reset() {
+        key = 0
+    }
+
+    companion object {
+        private const val MAX_WALK = 4
+
+        private fun search(times: FloatArray, time: Float): Int {
+            if (time < times[0]) return 0
+            var lo = 0
+            var hi = times.size - 1
+            while (lo < hi) {
+                val mid = (lo + hi + 1) ushr 1
+                if (times[mid] <= time) lo = mid else hi = mid - 1
+            }
+            return lo
+        }
+    }
+}
+
+/**
+ * Samples [track] at [time] into [target] at [offset] ([SampledTrack.valueSize] floats),
+ * using [cursor] to find the keys. [scratch] holds the second key and must fit
+ * [SampledTrack.valueSize] floats. Quaternion tracks interpolate along the shorter arc
+ * and are left unnormalized; the blend normalizes once after accumulating.
+ */
+internal fun sampleTrack(
+    track: SampledTrack,
+    cursor: KeyCursor,
+    time: Float,
+    target: FloatArray,
+    offset: Int,
+    scratch: FloatArray,
+    quaternion: Boolean = false
+) {
+    val times = track.times
+    val size = track.valueSize
+    val index = cursor.seek(times, time)
+    track.readKey(index, target, offset)
+    if (index == times.lastIndex || track.interpolation == InterpolationType.STEP) return
+
+    val t1 = times[index]
+    val t2 = times[index + 1]
+    var alpha = ((time - t1) / (t2 - t1)).coerceIn(0f, 1f)
+    if (alpha <= 0f) return
+    if (track.interpolation == InterpolationType.CUBIC_SPLINE) {
+        alpha = alpha * alpha * (3f - 2f * alpha)
+    }
+
+    track.readKey(index + 1, scratch, 0)
+    var sign = 1f
+    if (quaternion && size >= 4) {
+        var dot = 0f
+        for (i in 0 until 4) dot += target[offset + i] * scratch[i]
+        if (dot < 0f) sign = -1f
+    }
+    for (i in 0 until size) {
+        val v1 = target[offset + i]
+        target[offset + i] = v1 + (scratch[i] * sign - v1) * alpha
+    }
+}
@@ -3,6 +3,7 @@ package io.materia.animation
 import io.materia.core.math.Matrix4
 import io.materia.core.math.Quaternion
 import io.materia.core.math.Vector3
+import kotlin.math.sqrt
 
 // Note: compose() is now a member function of Matrix4, no need to import extension
 
@@ -76,11 +77,29 @@ class DefaultSkeletalAnimationSystem(
     private val activeAnimations = mutableListOf<SkeletalAnimationAction>()
     private val boneTransforms = Array(skeleton.bones.size) { Matrix4.identity() }
     private val finalBoneMatrices = Array(skeleton.bones.size) { Matrix4.identity() }
+    private val worldMatrices = Array(skeleton.bones.size) { Matrix4.identity() }
+    private val worldComputed = BooleanArray(skeleton.bones.size)
+
+    // Local bone poses, structure-of-arrays: POSE_STRIDE floats per bone (position,
+    // quaternion, scale). Bind transforms are decomposed once, here.
+    private val bindPose = FloatArray(skeleton.bones.size * POSE_STRIDE)
+    private val localPose = FloatArray(skeleton.bones.size * POSE_STRIDE)
+    private val animated = FloatArray(POSE_STRIDE)
+    private val position = Vector3()
+    private val rotation = Quaternion()
+    private val scale = Vector3()
+
+    init {
+        skeleton.bones.forEachIndexed { index, bone ->
+            bone.bindTransform.decompose(position, rotation, scale)
+            writePose(bindPose, index * POSE_STRIDE)
+        }
+    }
 
     override val isDisposed: Boolean get() = _isDisposed
 
     override fun playAnimation(clip: AnimationClip, weight: Float, loop: Boolean): AnimationAction {
-        val action = SkeletalAnimationAction(clip, this, weight, loop)
+        val action = SkeletalAnimationAction(clip, BoneClipBinding(clip, skeleton), weight, loop)
         activeAnimations.add(action)
         action.play()
         return action
@@ -123,158 +142,120 @@ class DefaultSkeletalAnimationSystem(
         }
 
         // Calculate final bone matrices for rendering
+        composeBoneTransforms()
         calculateFinalBoneMatrices()
     }
 
     private fun resetToBindPose() {
-        skeleton.bones.forEachIndexed { index, bone ->
-            boneTransforms[index] = bone.bindTransform.copy()
-        }
+        bindPose.copyInto(localPose)
     }
 
     private fun applyAnimationToBones(animation: SkeletalAnimationAction) {
         val weight = animation.weight
         if (weight <= 0f) return
 
-        animation.clip.tracks.forEach { track ->
-            val boneIndex = findBoneIndex(track.name)
-            if (boneIndex >= 0) {
-                val animatedValue = interpolateTrack(track, animation.time)
-                val animatedTransform = createTransformFromValues(animatedValue)
-
-                // Blend with existing transform
-                boneTransforms[boneIndex] = blendTransforms(
-                    boneTransforms[boneIndex],
-                    animatedTransform,
-                    weight
-                )
-            }
+        val binding = animation.binding
+        for (i in 0 until binding.trackCount) {
+            val values = binding.sample(i, animation.time)
+            expandTransform(values, binding.valueSize(i))
+            blendPose(binding.boneIndex(i) * POSE_STRIDE, weight)
         }
     }
 
-    private fun findBoneIndex(boneName: String): Int {
-        return skeleton.bones.indexOfFirst { it.name == boneName }
-    }
-
-    private fun interpolateTrack(track: KeyframeTrack, time: Float): FloatArray {
-        // Similar to AnimationAction interpolation but simplified
-        val times = track.times
-        val values = track.values
-
-        // Check for empty times to avoid division by zero
-        if (times.isEmpty()) {
-            return floatArrayOf()
-        }
-
-        val valuesPerKey = if (times.isNotEmpty()) values.size / times.size else 0
-
-        var index = 0
-        for (i in times.indices) {
-            if (time >= times[i]) {
-                index = i
-            } else {
-                break
-            }
+    // Fills [animated] from [values] laid out [px, py, pz, qx, qy, qz, qw, sx, sy, sz],
+    // [px, py, pz, qx, qy, qz, qw] or [px, py, pz]; missing parts are identity
+    private fun expandTransform(values: FloatArray, size: Int) {
+        IDENTITY_POSE.copyInto(animated)
+        when (size) {
+            10 -> values.copyInto(animated, 0, 0, 10)
+            7 -> values.copyInto(animated, 0, 0, 7)
+            3 -> values.copyInto(animated, 0, 0, 3)
         }
+    }
 
-        val nextIndex = (index + 1).coerceAtMost(times.lastIndex)
-
-        if (index == nextIndex) {
-            val startIdx = index * valuesPerKey
-            return values.sliceArray(startIdx until startIdx + valuesPerKey)
+    // Blends [animated] into the local pose at [offset] in place: position and scale lerp,
+    // rotation nlerps along the shorter arc
+    private fun blendPose(offset: Int, weight: Float) {
+        val w = weight.coerceAtMost(1f)
+        var dot = 0f
+        for (i in 3 until 7) dot += localPose[offset + i] * animated[i]
+        val sign = if (dot < 0f) -1f else 1f
+        for (i in 0 until POSE_STRIDE) {
+            val target = if (i in 3 until 7) animated[i] * sign else animated[i]
+            localPose[offset + i] += (target - localPose[offset + i]) * w
         }
-
-        val t1 = times[index]
-        val t2 = times[nextIndex]
-        val alpha = ((time - t1) / (t2 - t1)).coerceIn(0f, 1f)
-
-        val startIdx1 = index * valuesPerKey
-        val startIdx2 = nextIndex * valuesPerKey
-
-        val result = FloatArray(valuesPerKey)
-        for (i in 0 until valuesPerKey) {
-            if (startIdx1 + i < values.size && startIdx2 + i < values.size) {
-                val v1 = values[startIdx1 + i]
-                val v2 = values[startIdx2 + i]
-                result[i] = v1 + (v2 - v1) * alpha
-            }
+        var length = 0f
+        for (i in 3 until 7) length += localPose[offset + i] * localPose[offset + i]
+        length = sqrt(length)
+        if (length > 1e-6f) {
+            for (i in 3 until 7) localPose[offset + i] /= length
         }
-
-        return result
     }
 
-    private fun createTransformFromValues(values: FloatArray): Matrix4 {
-        // Assumes values contain [px, py, pz, qx, qy, qz, qw, sx, sy, sz]
-        // Position, Quaternion rotation, Scale
-        when (values.size) {
-            10 -> {
-                val position = Vector3(values[0], values[1], values[2])
-                val rotation = Quaternion(values[3], values[4], values[5], values[6])
-                val scale = Vector3(values[7], values[8], values[9])
-                return Matrix4().compose(position, rotation, scale)
-            }
-
-            7 -> {
-                // Position + Quaternion only
-                val position = Vector3(values[0], values[1], values[2])
-                val rotation = Quaternion(values[3], values[4], values[5], values[6])
-                return Matrix4().compose(position, rotation, Vector3.ONE)
-            }
-
-            3 -> {
-                // Position only
-                val position = Vector3(values[0], values[1], values[2])
-                return Matrix4().compose(position, Quaternion.IDENTITY, Vector3.ONE)
-            }
-
-            else -> return Matrix4.identity()
+    private fun composeBoneTransforms() {
+        for (index in boneTransforms.indices) {
+            val o = index * POSE_STRIDE
+            position.set(localPose[o], localPose[o + 1], localPose[o + 2])
+            rotation.set(localPose[o + 3], localPose[o + 4], localPose[o + 5], localPose[o + 6])
+            scale.set(localPose[o + 7], localPose[o + 8], localPose[o + 9])
+            boneTransforms[index].compose(position, rotation, scale)
         }
     }
 
-    private fun blendTransforms(transform1: Matrix4, transform2: Matrix4, weight: Float): Matrix4 {
-        if (weight <= 0f) return transform1
-        if (weight >= 1f) return transform2
-
-        // Decompose both transforms
-        val pos1 = transform1.getTranslation()
-        val rot1 = transform1.getRotation()
-        val scale1 = transform1.getScale()
-
-        val pos2 = transform2.getTranslation()
-        val rot2 = transform2.getRotation()
-        val scale2 = transform2.getScale()
-
-        // Interpolate components
-        val blendedPos = pos1.lerp(pos2, weight)
-        val blendedRot = rot1.slerp(rot2, weight)
-        val blendedScale = scale1.lerp(scale2, weight)
-
-        return Matrix4().compose(blendedPos, blendedRot, blendedScale)
+    private fun writePose(target: FloatArray, offset: Int) {
+        target[offset] = position.x
+        target[offset + 1] = position.y
+        target[offset + 2] = position.z
+        target[offset + 3] = rotation.x
+        target[offset + 4] = rotation.y
+        target[offset + 5] = rotation.z
+        target[offset + 6] = rotation.w
+        target[offset + 7] = scale.x
+        target[offset + 8] = scale.y
+        target[offset + 9] = scale.z
     }
 
+    // Each world matrix is computed once per update and reused by its children
     private fun calculateFinalBoneMatrices() {
+        worldComputed.fill(false)
         skeleton.bones.forEachIndexed { index, bone ->
-            val worldMatrix = calculateBoneWorldMatrix(index)
-            finalBoneMatrices[index] = worldMatrix * bone.inverseBindMatrix
+            finalBoneMatrices[index].multiplyMatrices(calculateBoneWorldMatrix(index), bone.inverseBindMatrix)
         }
     }
 
     private fun calculateBoneWorldMatrix(boneIndex: Int): Matrix4 {
+        val world = worldMatrices[boneIndex]
+        if (worldComputed[boneIndex]) return world
+
         val bone = skeleton.bones[boneIndex]
         val localMatrix = boneTransforms[boneIndex]
-
-        return if (bone.parentIndex >= 0) {
-            calculateBoneWorldMatrix(bone.parentIndex) * localMatrix
+        if (bone.parentIndex >= 0) {
+            world.multiplyMatrices(calculateBoneWorldMatrix(bone.parentIndex), localMatrix)
         } else {
-            localMatrix
+            world.copy(localMatrix)
         }
+        worldComputed[boneIndex] = true
+        return world
     }
 
     /**
      * Gets the final bone matrices for rendering (bone space to world space)
      */
     fun getFinalBoneMatrices(): Array<Matrix4> {
-        return finalBoneMatrices.copyOf()
+        return Array(finalBoneMatrices.size) { finalBoneMatrices[it].clone() }
+    }
+
+    /**
+     * Writes the final bone matrices column-major into [target] at [offset], 16 floats per
+     * bone, e.g. straight into a renderer's bone palette without per-bone copies.
+     */
+    fun writeFinalBoneMatrices(target: FloatArray, offset: Int = 0) {
+        require(offset >= 0 && offset + finalBoneMatrices.size * 16 <= target.size) {
+            "target too small for ${finalBoneMatrices.size} bones at offset $offset"
+        }
+        for (i in finalBoneMatrices.indices) {
+            finalBoneMatrices[i].toArray(target, offset + i * 16)
+        }
     }
 
     override fun dispose() {
@@ -283,6 +264,49 @@ class DefaultSkeletalAnimationSystem(
         stopAllAnimations()
         _isDisposed = true
     }
+
+    private companion object {
+        const val POSE_STRIDE = 10
+        val IDENTITY_POSE = floatArrayOf(0f, 0f, 0f, 0f, 0f, 0f, 1f, 1f, 1f, 1f)
+    }
+}
+
+/**
+ * The bone tracks of one clip resolved to bone indices once, each with a [KeyCursor] and a
+ * shared sample buffer, so playback does no name lookups or allocations per frame.
+ */
+private class BoneClipBinding(clip: AnimationClip, skeleton: Skeleton) {
+    private val tracks: Array<SampledTrack>
+    private val bones: IntArray
+    private val cursors: Array<KeyCursor>
+    private val values: FloatArray
+    private val scratch: FloatArray
+
+    init {
+        val sources: List<SampledTrack> = clip.tracks + clip.quantizedTracks
+        val bound = sources.filter { track ->
+            track.times.isNotEmpty() && track.valueSize > 0 && skeleton.bones.any { it.name == track.name }
+        }
+        tracks = bound.toTypedArray()
+        bones = IntArray(tracks.size) { i -> skeleton.bones.indexOfFirst { it.name == tracks[i].name } }
+        cursors = Array(tracks.size) { KeyCursor() }
+        val widest = tracks.maxOfOrNull { it.valueSize } ?: 0
+        values = FloatArray(widest)
+        scratch = FloatArray(widest)
+    }
+
+    val trackCount: Int
+        get() = tracks.size
+
+    fun boneIndex(track: Int): Int = bones[track]
+
+    fun valueSize(track: Int): Int = tracks[track].valueSize
+
+    /** Samples [track] at [time]; the returned buffer is reused by the next call. */
+    fun sample(track: Int, time: Float): FloatArray {
+        sampleTrack(tracks[track], cursors[track], time, values, 0, scratch)
+        return values
+    }
 }
 
 /**
@@ -290,7 +314,7 @@ class DefaultSkeletalAnimationSystem(
  */
 private class SkeletalAnimationAction(
     override val clip: AnimationClip,
-    private val system: DefaultSkeletalAnimationSystem,
+    val binding: BoneClipBinding,
     initialWeight: Float,
     initialLoop: Boolean
 ) : AnimationAction {
@@ -0,0 +1,105 @@
+package io.materia.animation.compression
+
+import io.materia.animation.AnimationCompressor.AnimationTrack
+import io.materia.animation.InterpolationType
+import io.materia.animation.SampledTrack
+
+/**
+ * A track kept in its quantized form. Keys are decoded one at a time as the evaluator
+ * samples them, so a compressed clip plays without expanding to floats first.
+ */
+sealed class QuantizedTrack : SampledTrack {
+    /** Bytes of key data, times included. */
+    abstract val sizeBytes: Int
+}
+
+/**
+ * Rotation keys packed by [QuaternionCompressor.pack], one Long per key.
+ */
+class QuantizedRotationTrack(
+    override val name: String,
+    override val times: FloatArray,
+    val keys: LongArray,
+    val bits: Int,
+    override val interpolation: InterpolationType = InterpolationType.LINEAR
+) : QuantizedTrack() {
+    init {
+        require(keys.size == times.size) { "$name has ${times.size} times but ${keys.size} keys" }
+        require(bits in 2..QuaternionCompressor.MAX_BITS) { "bits must be in 2..${QuaternionCompressor.MAX_BITS}" }
+    }
+
+    override val valueSize: Int get() = 4
+
+    override val sizeBytes: Int
+        get() = times.size * 4 + keys.size * ((bits * 3 + 2 + 7) / 8)
+
+    override fun readKey(key: Int, target: FloatArray, offset: Int) {
+        QuaternionCompressor.unpack(keys[key], bits, target, offset)
+    }
+}
+
+/**
+ * Keys quantized to 16 bits per component over the track's per-component range:
+ * `value = min[c] + extent[c] * unorm16`.
+ */
+class QuantizedVectorTrack(
+    override val name: String,
+    override val times: FloatArray,
+    override val valueSize: Int,
+    val data: ShortArray,
+    val min: FloatArray,
+    val extent: FloatArray,
+    override val interpolation: InterpolationType = InterpolationType.LINEAR
+) : QuantizedTrack() {
+    init {
+        require(valueSize > 0) { "valueSize must be positive (was $valueSize)" }
+        require(data.size == times.size * valueSize) { "$name needs ${times.size * valueSize} components" }
+        require(min.size == valueSize && extent.size == valueSize) { "$name needs a range per component" }
+    }
+
+    override val sizeBytes: Int
+        get() = times.size * 4 + data.size * 2 + valueSize * 8
+
+    override fun readKey(key: Int, target: FloatArray, offset: Int) {
+        val base = key * valueSize
+        for (c in 0 until valueSize) {
+            val unit = (data[base + c].toInt() and 0xFFFF) * INV_MAX
+            target[offset + c] = min[c] + extent[c] * unit
+        }
+    }
+
+    companion object {
+        private const val MAX = 0xFFFF
+        private const val INV_MAX = 1f / MAX
+
+        /** Quantizes [track]'s keys; every key must have [valueSize] components. */
+        fun quantize(track: AnimationTrack, valueSize: Int): QuantizedVectorTrack {
+            val keys = track.keyframes
+            val min = FloatArray(valueSize) { Float.POSITIVE_INFINITY }
+            val max = FloatArray(valueSize) { Float.NEGATIVE_INFINITY }
+            for (key in keys) {
+                require(key.value.size >= valueSize) { "${track.name} has a key with ${key.value.size} components" }
+                for (c in 0 until valueSize) {
+                    min[c] = minOf(min[c], key.value[c])
+                    max[c] = maxOf(max[c], key.value[c])
+                }
+            }
+            if (keys.isEmpty()) {
+                min.fill(0f)
+                max.fill(0f)
+            }
+            val extent = FloatArray(valueSize) { max[it] - min[it] }
+            val data = ShortArray(keys.size * valueSize)
+            for (k in keys.indices) {
+                for (c in 0 until valueSize) {
+                    val unit = if (extent[c] > 0f) (keys[k].value[c] - min[c]) / extent[c] else 0f
+                    data[k * valueSize + c] = (unit.coerceIn(0f, 1f) * MAX + 0.5f).toInt().toShort()
+                }
+            }
+            val times = FloatArray(keys.size) { keys[it].time }
+            return QuantizedVectorTrack(
+                track.name, times, valueSize, data, min, extent, track.interpolation.toClipInterpolation()
+            )
+        }
+    }
+}
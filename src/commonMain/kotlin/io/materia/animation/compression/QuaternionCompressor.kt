@@ -2,27 +2,38 @@ package io.materia.animation.compression
 
 import io.materia.animation.AnimationCompressor.AnimationTrack
 import io.materia.animation.AnimationCompressor.CompressionConfig
-import io.materia.animation.AnimationCompressor.Keyframe
+import io.materia.animation.InterpolationType
 import io.materia.core.math.Quaternion
 import kotlin.math.abs
+import kotlin.math.roundToLong
 import kotlin.math.sqrt
 
 /**
  * Quaternion-specific compression using quantization
+ *
+ * Keys use smallest-three encoding: the largest component is dropped (and made positive,
+ * since q and -q are the same rotation) and rebuilt from the unit-length constraint; the
+ * other three lie in [-1/sqrt(2), 1/sqrt(2)] and are quantized to `bits` bits each. A key
+ * packs into one Long: the three components in the low `3 * bits` bits, the dropped index
+ * in the top two.
  */
 object QuaternionCompressor {
 
+    /** Largest supported bits per component, so three components and the index fit a Long. */
+    const val MAX_BITS = 20
+
     /**
      * Compressed quaternion representation
      */
     data class CompressedQuaternion(
-        val data: Int, // Packed quaternion data
-        val largestComponent: Int // Which component was dropped
+        val data: Long, // Packed quaternion data
+        val largestComponent: Int, // Which component was dropped
+        val bits: Int
     ) {
         fun decompress(): Quaternion {
-            // Decompress packed quaternion data back to normalized quaternion
-            // Uses smallest-three encoding where the largest component is reconstructed
-            return Quaternion()
+            val out = FloatArray(4)
+            unpack(data, bits, out, 0)
+            return Quaternion(out[0], out[1], out[2], out[3])
         }
     }
 
@@ -59,51 +70,72 @@ object QuaternionCompressor {
      * Quantize quaternion to reduce precision
      */
     fun quantize(quaternion: Quaternion, bits: Int): CompressedQuaternion {
-        // Find largest component to drop (for compression)
-        val components = arrayOf(
-            abs(quaternion.x),
-            abs(quaternion.y),
-            abs(quaternion.z),
-            abs(quaternion.w)
-        )
-        val largestIndex = components.indices.maxByOrNull { components[it] } ?: 3
-
-        // Quantize remaining components
-        val maxValue = (1 shl bits) - 1
-        val EPSILON = 0.000001f
-        val sqrtArg =
-            (1f - components[largestIndex] * components[largestIndex]).coerceAtLeast(EPSILON)
-        val sqrtValue = sqrt(sqrtArg).coerceAtLeast(EPSILON)
-        val scale = maxValue / sqrtValue
-
-        // Pack quaternion components into integer using bit-shifting
-        // Drops the largest component (reconstructed from unit constraint)
-        val packedData = when (largestIndex) {
-            0 -> { // Drop X
-                ((quaternion.y * scale).toInt() and maxValue) or
-                        (((quaternion.z * scale).toInt() and maxValue) shl bits) or
-                        (((quaternion.w * scale).toInt() and maxValue) shl (bits * 2))
-            }
-
-            1 -> { // Drop Y
-                ((quaternion.x * scale).toInt() and maxValue) or
-                        (((quaternion.z * scale).toInt() and maxValue) shl bits) or
-                        (((quaternion.w * scale).toInt() and maxValue) shl (bits * 2))
-            }
+        val packed = pack(quaternion.x, quaternion.y, quaternion.z, quaternion.w, bits)
+        return CompressedQuaternion(packed, (packed ushr 62).toInt(), bits)
+    }
 
-            2 -> { // Drop Z
-                ((quaternion.x * scale).toInt() and maxValue) or
-                        (((quaternion.y * scale).toInt() and maxValue) shl bits) or
-                        (((quaternion.w * scale).toInt() and maxValue) shl (bits * 2))
-            }
+    /**
+     * Packs a track's rotation keys for direct sampling, at [bits] per component.
+     */
+    fun quantizeTrack(track: AnimationTrack, bits: Int): QuantizedRotationTrack {
+        require(track.type == AnimationTrack.TrackType.ROTATION) { "${track.name} is not a rotation track" }
+        val times = FloatArray(track.keyframes.size) { track.keyframes[it].time }
+        val keys = LongArray(track.keyframes.size) {
+            val q = track.keyframes[it].quaternion.normalize()
+            pack(q.x, q.y, q.z, q.w, bits)
+        }
+        return QuantizedRotationTrack(track.name, times, keys, bits, track.interpolation.toClipInterpolation())
+    }
 
-            else -> { // Drop W
-                ((quaternion.x * scale).toInt() and maxValue) or
-                        (((quaternion.y * scale).toInt() and maxValue) shl bits) or
-                        (((quaternion.z * scale).toInt() and maxValue) shl (bits * 2))
-            }
+    /** Smallest-three packs a unit quaternion; it is normalized first. */
+    fun pack(x: Float, y: Float, z: Float, w: Float, bits: Int): Long {
+        require(bits in 2..MAX_BITS) { "bits must be in 2..$MAX_BITS (was $bits)" }
+        val length = sqrt(x * x + y * y + z * z + w * w)
+        if (length < EPSILON) return pack(0f, 0f, 0f, 1f, bits)
+
+        var largest = 3
+        var largestValue = abs(w)
+        if (abs(x) > largestValue) { largest = 0; largestValue = abs(x) }
+        if (abs(y) > largestValue) { largest = 1; largestValue = abs(y) }
+        if (abs(z) > largestValue) { largest = 2 }
+        val q = floatArrayOf(x, y, z, w)
+        val sign = if (q[largest] < 0f) -1f / length else 1f / length
+
+        val max = (1L shl bits) - 1
+        var packed = largest.toLong() shl 62
+        var shift = 0
+        for (i in 0 until 4) {
+            if (i == largest) continue
+            val unit = (q[i] * sign * SQRT2 * 0.5f + 0.5f).coerceIn(0f, 1f)
+            packed = packed or ((unit * max).roundToLong() shl shift)
+            shift += bits
         }
+        return packed
+    }
 
-        return CompressedQuaternion(packedData, largestIndex)
+    /** Writes the x, y, z, w of a [pack]ed quaternion into [target] at [offset]. */
+    fun unpack(packed: Long, bits: Int, target: FloatArray, offset: Int) {
+        val largest = (packed ushr 62).toInt()
+        val max = (1L shl bits) - 1
+        var shift = 0
+        var sum = 0f
+        for (i in 0 until 4) {
+            if (i == largest) continue
+            val unit = ((packed ushr shift) and max).toFloat() / max
+            val value = (unit * 2f - 1f) / SQRT2
+            target[offset + i] = value
+            sum += value * value
+            shift += bits
+        }
+        target[offset + largest] = sqrt((1f - sum).coerceAtLeast(0f))
     }
+
+    private const val EPSILON = 0.000001f
+    private const val SQRT2 = 1.4142135f
+}
+
+internal fun AnimationTrack.InterpolationType.toClipInterpolation(): InterpolationType = when (this) {
+    AnimationTrack.InterpolationType.STEP -> InterpolationType.STEP
+    AnimationTrack.InterpolationType.LINEAR -> InterpolationType.LINEAR
+    else -> InterpolationType.CUBIC_SPLINE
 }
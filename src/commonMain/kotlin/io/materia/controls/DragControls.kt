@@ -4,9 +4,9 @@ import io.materia.camera.Camera
 import io.materia.core.math.Plane
 import io.materia.core.math.Vector2
 import io.materia.core.math.Vector3
-import io.materia.core.scene.Intersection
+import io.materia.core.math.Ray
 import io.materia.core.scene.Object3D
-import io.materia.core.scene.Raycaster
+import io.materia.raycaster.Raycaster
 
 /**
  * Drag controls for interactively moving objects with mouse/touch.
@@ -322,7 +322,7 @@ class DragControls(
 }
 
 // Extension for ray distance to plane
-private fun io.materia.core.scene.Ray.distanceToPlane(plane: Plane): Float? {
+private fun Ray.distanceToPlane(plane: Plane): Float? {
     val denominator = plane.normal.dot(direction)
     if (kotlin.math.abs(denominator) < 0.0001f) {
         // Ray is parallel to plane
@@ -61,7 +61,8 @@ import io.materia.core.math.*
  * - Caches world matrix until invalidated
  * - Propagates updates efficiently through hierarchy
  *
- * Set [matrixAutoUpdate] to `false` for static objects to skip updates entirely.
+ * Mark static objects with [isStatic] so untouched static subtrees are skipped, or set
+ * [matrixAutoUpdate] to `false` to manage [matrix] manually.
  *
  * ## Architecture
  *
@@ -124,12 +125,53 @@ abstract class Object3D {
     // Auto-update behavior
     var matrixAutoUpdate: Boolean = true
     var matrixWorldNeedsUpdate: Boolean = false
+        set(value) {
+            field = value
+            if (value) markSubtreeDirty()
+        }
+
+    /**
+     * Declares the local transform as unchanging.
+     *
+     * Static objects skip the per-frame check for direct writes to [position] and
+     * [scale]; call [updateMatrix] after moving one. Subtrees made only of static
+     * objects are skipped entirely by [updateMatrixWorld] until one of them is
+     * invalidated or their parent moves.
+     */
+    var isStatic: Boolean = false
+        set(value) {
+            if (field == value) return
+            field = value
+            adjustDynamicCount(if (value) -1 else 1)
+            markTransformDirty()
+        }
+
+    /**
+     * Incremented every time [matrixWorld] is recomputed.
+     *
+     * Caches derived from the world matrix (bounds, uploaded uniforms) can store
+     * this value and compare it instead of the matrix.
+     */
+    var matrixWorldVersion: Int = 0
+        private set
 
     // Performance: Track if local transform has changed
     private var matrixNeedsUpdate: Boolean = true
-    private var worldMatrixVersion: Int = 0
     private var localMatrixVersion: Int = 0
 
+    // Parent's matrixWorldVersion when matrixWorld was last computed
+    internal var parentVersionSeen: Int = -1
+
+    // Set when this object or a descendant was invalidated since the last update
+    private var subtreeDirty: Boolean = true
+
+    // Non-static objects in this subtree, including this one
+    internal var dynamicNodeCount: Int = 1
+        private set
+
+    // Position and scale the local matrix was composed from (rotation notifies on change)
+    private val composedFrom = FloatArray(6)
+
     // Visibility and shadow properties
     var visible: Boolean = true
     var castShadow: Boolean = false
@@ -174,6 +216,44 @@ abstract class Object3D {
         matrixWorldNeedsUpdate = true
     }
 
+    // Descendants pick up a change through matrixWorldVersion, so only the ancestor
+    // chain is flagged; an already flagged ancestor has flagged the rest.
+    private fun markSubtreeDirty() {
+        subtreeDirty = true
+        var node = parent
+        while (node != null && !node.subtreeDirty) {
+            node.subtreeDirty = true
+            node = node.parent
+        }
+    }
+
+    internal fun adjustDynamicCount(delta: Int) {
+        var node: Object3D? = this
+        while (node != null) {
+            node.dynamicNodeCount += delta
+            node = node.parent
+        }
+    }
+
+    internal fun recordComposedTransform() {
+        val c = composedFrom
+        c[0] = position.x
+        c[1] = position.y
+        c[2] = position.z
+        c[3] = scale.x
+        c[4] = scale.y
+        c[5] = scale.z
+    }
+
+    private fun localTransformChanged(): Boolean {
+        val c = composedFrom
+        return c[0] != position.x || c[1] != position.y || c[2] != position.z ||
+            c[3] != scale.x || c[4] != scale.y || c[5] != scale.z
+    }
+
+    private fun needsUpdate(parentVersion: Int): Boolean =
+        dynamicNodeCount > 0 || subtreeDirty || parentVersionSeen != parentVersion
+
     // Hierarchy operations (delegated to Object3DHierarchy.kt)
     fun add(vararg objects: Object3D): Object3D = addChildren(*objects)
     fun remove(vararg objects: Object3D): Object3D = removeChildren(*objects)
@@ -232,29 +312,32 @@ abstract class Object3D {
     }
 
     /**
-     * Updates the world transformation matrix for this object and optionally its children.
+     * Updates the world transformation matrix for this object and its descendants.
      *
      * This method:
-     * - Recalculates the local matrix from position/rotation/scale if needed
-     * - Combines with parent's world matrix to produce this object's world matrix
-     * - Recursively updates children if the world matrix changed or [force] is true
+     * - Recalculates the local matrix from position/rotation/scale if they changed
+     * - Recomputes [matrixWorld] when the local matrix or the parent's world matrix changed
+     * - Visits children, skipping subtrees of unchanged [isStatic] objects
      *
      * ## Performance Optimization
      *
-     * Uses dirty flagging to skip unnecessary updates:
-     * - Only processes when transforms changed or forced
-     * - Tracks matrix versions to minimize recomputation
-     * - Efficiently propagates updates through hierarchy
+     * Updates are incremental, so calling this every frame without [force] is cheap:
+     * - Direct writes to [position] and [scale] are detected by comparing against the
+     *   values the local matrix was built from; rotation changes notify on their own
+     * - Each object remembers the parent [matrixWorldVersion] it was computed against,
+     *   so only descendants of a moved object are recomputed
+     * - Invalidation flags the ancestor chain, which lets untouched static subtrees be
+     *   skipped without being traversed
      *
      * Example:
      * ```kotlin
-     * // Manually trigger world matrix update
      * obj.position.x = 10f
-     * obj.updateMatrixWorld(force = true)
+     * scene.updateMatrixWorld() // recomputes obj and its descendants only
      *
-     * // For static objects, disable auto-update
-     * staticObj.matrixAutoUpdate = false
-     * staticObj.updateMatrix() // Manual update when needed
+     * // For static objects, skip per-frame change detection
+     * staticObj.isStatic = true
+     * staticObj.position.x = 5f
+     * staticObj.updateMatrix() // Manual invalidation when moved
      * ```
      *
      * @param force If true, forces update of this object and all descendants regardless of dirty flags
@@ -263,9 +346,8 @@ abstract class Object3D {
      * @since 1.0.0
      */
     open fun updateMatrixWorld(force: Boolean = false) {
-        // Performance: Skip if nothing changed and not forced
-        if (!force && !matrixWorldNeedsUpdate && !matrixNeedsUpdate) {
-            return
+        if (matrixAutoUpdate && !matrixNeedsUpdate && !isStatic && localTransformChanged()) {
+            matrixNeedsUpdate = true
         }
 
         if (matrixAutoUpdate && matrixNeedsUpdate) {
@@ -274,27 +356,27 @@ abstract class Object3D {
             localMatrixVersion++
         }
 
-        var forceChildren = force
-        if (matrixWorldNeedsUpdate || force) {
-            val parentVersion = parent?.worldMatrixVersion ?: 0
-
+        val parentVersion = parent?.matrixWorldVersion ?: 0
+        if (force || matrixWorldNeedsUpdate || parentVersion != parentVersionSeen) {
             parent?.let { p ->
                 matrixWorld.multiplyMatrices(p.matrixWorld, matrix)
             } ?: matrixWorld.copy(matrix)
 
             matrixWorldNeedsUpdate = false
-            worldMatrixVersion++
-            forceChildren = true
+            parentVersionSeen = parentVersion
+            matrixWorldVersion++
         }
 
-        // Performance: Only update children if this object's world matrix changed
-        if (forceChildren) {
-            // Take snapshot to avoid ConcurrentModificationException
-            val childrenSnapshot = children.toList()
-            for (child in childrenSnapshot) {
-                child.updateMatrixWorld(forceChildren)
+        // Index loop: no snapshot allocation per visited object
+        var i = 0
+        while (i < _children.size) {
+            val child = _children[i]
+            if (force || child.needsUpdate(matrixWorldVersion)) {
+                child.updateMatrixWorld(force)
             }
+            i++
         }
+        subtreeDirty = false
     }
 
     /**
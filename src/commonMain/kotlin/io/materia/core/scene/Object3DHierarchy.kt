@@ -21,11 +21,21 @@ internal fun Object3D.addChildren(vararg objects: Object3D): Object3D {
 
         obj.parent = this
         _children.add(obj)
+        adjustDynamicCount(obj.dynamicNodeCount)
+        obj.markReparented()
         obj.dispatchEvent(Event.Added(obj))
     }
     return this
 }
 
+/**
+ * Forces the next world update of an object that moved in the hierarchy
+ */
+private fun Object3D.markReparented() {
+    parentVersionSeen = -1
+    matrixWorldNeedsUpdate = true
+}
+
 /**
  * Removes children from this object
  */
@@ -34,7 +44,9 @@ internal fun Object3D.removeChildren(vararg objects: Object3D): Object3D {
         val index = _children.indexOf(obj)
         if (index >= 0) {
             _children.removeAt(index)
+            adjustDynamicCount(-obj.dynamicNodeCount)
             obj.parent = null
+            obj.markReparented()
             obj.dispatchEvent(Event.Removed(obj))
         }
     }
@@ -56,7 +68,9 @@ internal fun Object3D.clearChildren(): Object3D {
     val childrenCopy = _children.toList()
     _children.clear()
     for (child in childrenCopy) {
+        adjustDynamicCount(-child.dynamicNodeCount)
         child.parent = null
+        child.markReparented()
         child.dispatchEvent(Event.Removed(child))
     }
     return this
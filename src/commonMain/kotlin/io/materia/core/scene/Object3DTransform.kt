@@ -179,6 +179,7 @@ internal fun Object3D.applyMatrixTransform(matrix: Matrix4): Object3D {
  */
 internal fun Object3D.updateLocalMatrix() {
     matrix.compose(position, quaternion, scale)
+    recordComposedTransform()
     matrixWorldNeedsUpdate = true
 
     // Propagate dirty flag to children
@@ -5,6 +5,7 @@ import io.materia.animation.skeleton.Bone
 import io.materia.core.math.Matrix4
 import io.materia.core.math.Vector3
 import io.materia.core.math.Vector4
+import io.materia.geometry.BufferAttribute
 import io.materia.geometry.BufferGeometry
 
 /**
@@ -64,6 +65,8 @@ class SkinnedMesh(
      */
     private var boundingSphere: Sphere? = null
 
+    private var boundsMatrices: FloatArray? = null
+
     /**
      * Reference to the skeleton driving this mesh.
      */
@@ -117,27 +120,39 @@ class SkinnedMesh(
      * Calculate bone matrices for GPU skinning.
      * Should be called each frame before rendering.
      *
-     * The resulting matrices transform vertices from bind pose to current pose.
-     * Formula: boneMatrix = bone.matrixWorld * bone.inverseBindMatrix * bindMatrixInverse
+     * The resulting matrices take a vertex from bind pose to the current pose in mesh space,
+     * so a shader computes `Σ weight * boneMatrices[index] * position` and then applies
+     * the model matrix; the result matches [applyBoneTransform].
      */
     fun pose() {
         val skel = skeleton ?: return
         val matrices = boneMatrices ?: return
 
         skel.update()
+        writeSkinMatrices(matrices, 0)
+    }
+
+    /**
+     * Writes one column-major skin matrix per bone into [target] starting at [offset]:
+     * `bindMatrixInverse * bone.matrixWorld * bone.inverseBindMatrix * bindMatrix`.
+     * Bone world matrices are used as they are; call [Skeleton.update] first.
+     *
+     * @return the number of bones written, 0 when unbound
+     */
+    fun writeSkinMatrices(target: FloatArray, offset: Int = 0): Int {
+        val skel = skeleton ?: return 0
+        require(offset >= 0 && offset + skel.bones.size * 16 <= target.size) {
+            "target too small for ${skel.bones.size} bones at offset $offset"
+        }
 
+        val boneMatrix = _boneMatrix
         for ((index, bone) in skel.bones.withIndex()) {
-            // Compute final bone matrix
-            val boneMatrix = _boneMatrix
             boneMatrix.multiplyMatrices(bone.matrixWorld, bone.inverseBindMatrix)
-
-            if (bindMode == BindMode.ATTACHED) {
-                boneMatrix.multiplyMatrices(bindMatrixInverse, boneMatrix)
-            }
-
-            // Store in flattened array
-            boneMatrix.toArray(matrices, index * 16)
+            boneMatrix.multiplyMatrices(boneMatrix, bindMatrix)
+            boneMatrix.multiplyMatrices(bindMatrixInverse, boneMatrix)
+            boneMatrix.toArray(target, offset + index * 16)
         }
+        return skel.bones.size
     }
 
     /**
@@ -227,13 +242,14 @@ class SkinnedMesh(
         box.makeEmpty()
 
         val positionAttr = geometry.getAttribute("position") ?: return box
+        val matrices = skinMatricesForBounds()
 
         for (i in 0 until positionAttr.count) {
             _vertex.x = positionAttr.getX(i)
             _vertex.y = positionAttr.getY(i)
             _vertex.z = positionAttr.getZ(i)
 
-            applyBoneTransform(i, _vertex)
+            skinVertex(i, _vertex, matrices)
             box.expandByPoint(_vertex)
         }
         
@@ -251,13 +267,14 @@ class SkinnedMesh(
 
         var maxRadiusSq = 0f
         val positionAttr = geometry.getAttribute("position") ?: return sphere
+        val matrices = skinMatricesForBounds()
 
         for (i in 0 until positionAttr.count) {
             _vertex.x = positionAttr.getX(i)
             _vertex.y = positionAttr.getY(i)
             _vertex.z = positionAttr.getZ(i)
 
-            applyBoneTransform(i, _vertex)
+            skinVertex(i, _vertex, matrices)
             maxRadiusSq = maxOf(maxRadiusSq, sphere.center.distanceToSquared(_vertex))
         }
 
@@ -265,6 +282,41 @@ class SkinnedMesh(
         return sphere
     }
 
+    // Skin matrices computed once per bounds pass instead of once per vertex and bone
+    private fun skinMatricesForBounds(): FloatArray? {
+        val skel = skeleton ?: return null
+        val size = skel.bones.size * 16
+        val matrices = boundsMatrices?.takeIf { it.size == size } ?: FloatArray(size).also { boundsMatrices = it }
+        writeSkinMatrices(matrices, 0)
+        return matrices
+    }
+
+    // Same blend as applyBoneTransform, reading precomputed skin matrices
+    private fun skinVertex(index: Int, vector: Vector3, matrices: FloatArray?) {
+        if (matrices == null) return
+        val skinIndices = geometry.getAttribute("skinIndex") ?: return
+        val skinWeights = geometry.getAttribute("skinWeight") ?: return
+        val boneCount = matrices.size / 16
+
+        val x = vector.x
+        val y = vector.y
+        val z = vector.z
+        var sx = 0f
+        var sy = 0f
+        var sz = 0f
+        for (j in 0 until 4) {
+            val boneIndex = skinIndices.getComponent(index, j).toInt()
+            val weight = skinWeights.getComponent(index, j)
+            if (weight > 0f && boneIndex >= 0 && boneIndex < boneCount) {
+                val m = boneIndex * 16
+                sx += (matrices[m] * x + matrices[m + 4] * y + matrices[m + 8] * z + matrices[m + 12]) * weight
+                sy += (matrices[m + 1] * x + matrices[m + 5] * y + matrices[m + 9] * z + matrices[m + 13]) * weight
+                sz += (matrices[m + 2] * x + matrices[m + 6] * y + matrices[m + 10] * z + matrices[m + 14]) * weight
+            }
+        }
+        vector.set(sx, sy, sz)
+    }
+
     /**
      * Get the root bone of the skeleton.
      */
@@ -364,6 +416,13 @@ private fun Matrix4.invertCopy(): Matrix4 {
     return this.clone().invert()
 }
 
+private fun BufferAttribute.getComponent(index: Int, component: Int): Float = when (component) {
+    0 -> getX(index)
+    1 -> getY(index)
+    2 -> getZ(index)
+    else -> getW(index)
+}
+
 /**
  * Extension to set XYZW on a buffer attribute.
  * Note: getW already exists as a member of BufferAttribute.
@@ -10,6 +10,7 @@ package io.materia.geometry
 import io.materia.core.math.*
 import io.materia.core.platform.currentTimeMillis
 import io.materia.morph.MorphTargetGeometry
+import io.materia.raycaster.MeshBVH
 import kotlinx.serialization.Serializable
 
 /**
@@ -21,7 +22,7 @@ import kotlinx.serialization.Serializable
  * - Morph targets for blend-shape animation
  * - Per-instance attributes for hardware instancing
  * - Geometry groups for multi-material rendering
- * - Lazy-computed bounding volumes
+ * - Lazy-computed bounding volumes and a cached triangle BVH for raycasting
  * - Level-of-detail (LOD) variants
  *
  * Follows the Three.js BufferGeometry API for compatibility.
@@ -48,6 +49,8 @@ open class BufferGeometry : MorphTargetGeometry {
     private var _boundingSphere: Sphere? = null
     private var _boundingBoxNeedsUpdate = true
     private var _boundingSphereNeedsUpdate = true
+    private var _boundsTree: MeshBVH? = null
+    private var _boundsTreeNeedsRefit = false
 
     // LOD support
     private val _lodLevels = mutableListOf<LodLevel>()
@@ -76,6 +79,7 @@ open class BufferGeometry : MorphTargetGeometry {
      * @return This geometry for chaining.
      */
     fun setAttribute(name: String, attribute: BufferAttribute): BufferGeometry {
+        if (name == "position" && _attributes[name] !== attribute) _boundsTree = null
         _attributes[name] = attribute
         _markBoundingVolumesNeedUpdate()
         return this
@@ -96,6 +100,7 @@ open class BufferGeometry : MorphTargetGeometry {
      * @return This geometry for chaining.
      */
     fun deleteAttribute(name: String): BufferGeometry {
+        if (name == "position") _boundsTree = null
         _attributes.remove(name)
         _markBoundingVolumesNeedUpdate()
         return this
@@ -115,6 +120,7 @@ open class BufferGeometry : MorphTargetGeometry {
      * @return This geometry for chaining.
      */
     fun setIndex(index: BufferAttribute?): BufferGeometry {
+        if (_index !== index) _boundsTree = null
         _index = index
         return this
     }
@@ -301,6 +307,46 @@ open class BufferGeometry : MorphTargetGeometry {
     val boundingBox: Box3? get() = if (_boundingBoxNeedsUpdate) null else _boundingBox
     val boundingSphere: Sphere? get() = if (_boundingSphereNeedsUpdate) null else _boundingSphere
 
+    /**
+     * Returns the triangle BVH used for raycasting, building it on first use.
+     *
+     * The tree is cached on the geometry. Position edits made through this geometry
+     * ([translate], [scale], [applyMatrix4]) refit it on the next call; replacing the
+     * position attribute or the index rebuilds it. After writing attribute arrays
+     * directly, call [refitBoundsTree].
+     *
+     * @return The cached tree.
+     * @throws IllegalArgumentException If the geometry has no position attribute.
+     */
+    fun computeBoundsTree(): MeshBVH {
+        val existing = _boundsTree
+        if (existing != null) {
+            if (_boundsTreeNeedsRefit) {
+                existing.refit()
+                _boundsTreeNeedsRefit = false
+            }
+            return existing
+        }
+        return MeshBVH(this).also {
+            _boundsTree = it
+            _boundsTreeNeedsRefit = false
+        }
+    }
+
+    /** The cached triangle BVH, or null until [computeBoundsTree] runs. */
+    val boundsTree: MeshBVH? get() = _boundsTree
+
+    /** Refits the cached BVH to the current positions, e.g. after animating vertices. */
+    fun refitBoundsTree() {
+        _boundsTree?.refit()
+        _boundsTreeNeedsRefit = false
+    }
+
+    /** Drops the cached BVH. */
+    fun disposeBoundsTree() {
+        _boundsTree = null
+    }
+
     /**
      * Adds a level-of-detail variant at a specific distance.
      *
@@ -505,6 +551,7 @@ open class BufferGeometry : MorphTargetGeometry {
     private fun _markBoundingVolumesNeedUpdate() {
         _boundingBoxNeedsUpdate = true
         _boundingSphereNeedsUpdate = true
+        _boundsTreeNeedsRefit = true
     }
 }
 
@@ -103,6 +103,16 @@ class GeometryProcessor {
             optimizations.add("Optimized vertex cache ordering")
         }
 
+        if (options.optimizeOverdraw && result.index != null) {
+            result = vertexOptimizer.optimizeOverdraw(result)
+            optimizations.add("Reordered triangles to reduce overdraw")
+        }
+
+        if (options.optimizeVertexFetch && result.index != null) {
+            result = vertexOptimizer.optimizeVertexFetch(result)
+            optimizations.add("Reordered vertices for fetch locality")
+        }
+
         // Generate missing attributes
         if (result.getAttribute("normal") == null && options.generateNormals) {
             result = normalGenerator.generateSmoothNormals(result)
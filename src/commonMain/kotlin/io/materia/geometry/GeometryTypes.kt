@@ -53,10 +53,24 @@ data class GpuOptimizationOptions(
     val mergeThreshold: Float = 0.001f,
     val generateIndices: Boolean = true,
     val optimizeVertexCache: Boolean = true,
+    val optimizeOverdraw: Boolean = true,
+    val optimizeVertexFetch: Boolean = true,
     val generateNormals: Boolean = true,
     val generateTangents: Boolean = true
 )
 
+/**
+ * Import-time index and vertex reordering stages, see
+ * [io.materia.geometry.processing.VertexOptimizer.optimizeForRendering]
+ */
+data class MeshOptimizationOptions(
+    val vertexCache: Boolean = true,
+    val overdraw: Boolean = true,
+    val vertexFetch: Boolean = true,
+    val cacheSize: Int = io.materia.geometry.processing.IndexOptimizer.DEFAULT_CACHE_SIZE,
+    val overdrawThreshold: Float = io.materia.geometry.processing.IndexOptimizer.DEFAULT_OVERDRAW_THRESHOLD
+)
+
 /**
  * Quality tier enumeration for adaptive performance
  */
@@ -4,7 +4,12 @@
 package io.materia.geometry.processing
 
 import io.materia.geometry.BufferGeometry
-import kotlin.math.pow
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.withContext
 
 /**
  * Generates multiple LOD levels for geometry
@@ -47,7 +52,7 @@ class LODGenerator {
             }
 
             val simplifiedGeometry =
-                MeshSimplifier().simplifyGeometry(currentGeometry, targetTriangleCount)
+                MeshSimplifier().simplifyGeometry(currentGeometry, targetTriangleCount, options.simplification)
             val distance = calculateLodDistance(level, options.baseLodDistance)
 
             lodLevels.add(
@@ -62,17 +67,59 @@ class LODGenerator {
             currentReduction = currentReduction * options.reductionFactor
         }
 
-        return LodResult(
-            levels = lodLevels.toList(),
-            originalTriangleCount = originalTriangleCount,
-            totalReduction = if (lodLevels.size > 1 && originalTriangleCount > 0) {
-                1f - (lodLevels.last().triangleCount.toFloat() / originalTriangleCount)
-            } else {
-                0f
-            }
-        )
+        return result(lodLevels, originalTriangleCount)
     }
 
+    /**
+     * Generate the same LOD chain as [generateLodLevels], simplifying every level
+     * directly from the source geometry on its own coroutine. Levels no longer feed each
+     * other, so the chain takes as long as its finest level instead of the sum of all of
+     * them, and errors do not compound from level to level.
+     */
+    suspend fun generateLodLevelsParallel(
+        geometry: BufferGeometry,
+        options: LodGenerationOptions = LodGenerationOptions(),
+        dispatcher: CoroutineDispatcher = Dispatchers.Default
+    ): LodResult = withContext(dispatcher) {
+        val originalTriangleCount = geometry.getTriangleCount()
+        val targets = mutableListOf<Int>()
+        var currentReduction = options.initialReduction
+        for (level in 1 until options.lodLevels) {
+            val targetTriangleCount = (originalTriangleCount * currentReduction).toInt()
+            if (targetTriangleCount < options.minimumTriangles) break
+            targets.add(targetTriangleCount)
+            currentReduction = currentReduction * options.reductionFactor
+        }
+
+        val simplified = coroutineScope {
+            targets.map { target ->
+                async { MeshSimplifier().simplifyGeometry(geometry, target, options.simplification) }
+            }.awaitAll()
+        }
+
+        val lodLevels = mutableListOf(LodLevel(0f, geometry.clone(), originalTriangleCount))
+        simplified.forEachIndexed { i, level ->
+            lodLevels.add(
+                LodLevel(
+                    distance = calculateLodDistance(i + 1, options.baseLodDistance),
+                    geometry = level,
+                    triangleCount = level.getTriangleCount()
+                )
+            )
+        }
+        result(lodLevels, originalTriangleCount)
+    }
+
+    private fun result(lodLevels: List<LodLevel>, originalTriangleCount: Int) = LodResult(
+        levels = lodLevels.toList(),
+        originalTriangleCount = originalTriangleCount,
+        totalReduction = if (lodLevels.size > 1 && originalTriangleCount > 0) {
+            1f - (lodLevels.last().triangleCount.toFloat() / originalTriangleCount)
+        } else {
+            0f
+        }
+    )
+
     /**
      * Calculate LOD distance with exponential scaling
      */
@@ -89,7 +136,8 @@ data class LodGenerationOptions(
     val reductionFactor: Float = LODGenerator.DEFAULT_REDUCTION_FACTOR,
     val initialReduction: Float = 0.8f,
     val baseLodDistance: Float = 10f,
-    val minimumTriangles: Int = 100
+    val minimumTriangles: Int = 100,
+    val simplification: SimplificationOptions = SimplificationOptions()
 )
 
 /**
@@ -3,13 +3,41 @@
  */
 package io.materia.geometry.processing
 
-import io.materia.core.math.Vector3
-import io.materia.core.math.Plane
-import io.materia.geometry.BufferGeometry
 import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import kotlin.math.sqrt
+
+/**
+ * Simplification settings
+ *
+ * @property lockBorders Keep vertices on open boundaries in place; otherwise borders may
+ * collapse along themselves, held by constraint planes.
+ * @property attributeWeight Weight of normal, uv and color differences against the
+ * relative geometric error when ranking collapses.
+ * @property maxError Largest relative error, as a fraction of the bounding box diagonal,
+ * a collapse may introduce; simplification stops early rather than exceed it.
+ */
+data class SimplificationOptions(
+    val lockBorders: Boolean = true,
+    val attributeWeight: Float = 0.01f,
+    val maxError: Float = Float.MAX_VALUE
+)
 
 /**
  * Simplifies meshes using edge collapse with quadric error metrics
+ *
+ * Each vertex accumulates the area-weighted plane quadrics of its triangles (Garland and
+ * Heckbert). Edges are collapsed cheapest first from a heap: a half-edge collapse moves one
+ * endpoint onto the other, so every surviving vertex keeps its original attributes and
+ * no interpolation is needed. The cost is the positional quadric error, relative to the
+ * bounding box diagonal, plus [SimplificationOptions.attributeWeight] times the squared
+ * normal, uv and color difference of the endpoints.
+ *
+ * Vertices on attribute seams (one position, several attribute sets) and on non-manifold
+ * edges never move, nor do border vertices unless
+ * [SimplificationOptions.lockBorders] is off. Collapses that would flip a triangle are
+ * rejected. Groups keep their triangles' membership. The work is O(n log n) in the
+ * triangle count.
  */
 class MeshSimplifier {
 
@@ -18,63 +46,526 @@ class MeshSimplifier {
      */
     fun simplifyGeometry(
         geometry: BufferGeometry,
-        targetTriangleCount: Int
+        targetTriangleCount: Int,
+        options: SimplificationOptions = SimplificationOptions()
     ): BufferGeometry {
+        require(targetTriangleCount >= 0) { "targetTriangleCount must not be negative (was $targetTriangleCount)" }
         val positionAttribute = geometry.getAttribute("position")
             ?: return geometry.clone()
+        if (positionAttribute.itemSize < 3) return geometry.clone()
 
-        val indexAttribute = geometry.index
-        if (indexAttribute == null) {
-            // Convert non-indexed geometry to indexed first
-            val indexedGeometry = VertexOptimizer().generateIndices(geometry)
-            return simplifyGeometry(indexedGeometry, targetTriangleCount)
-        }
+        val sourceCount = positionAttribute.count
+        val sourceIndices = geometry.index?.let { index -> IntArray(index.count) { index.array[it].toInt() } }
+            ?: IntArray(sourceCount) { it }
+        if (sourceIndices.size / 3 <= targetTriangleCount) return geometry.clone()
 
-        val vertices = extractVertices(positionAttribute)
-        val indices = extractIndices(indexAttribute)
+        // Identical vertices become one, so only real attribute seams stay split
+        val attributes = (geometry.attributes.values + geometry.morphAttributes.values.flatten())
+            .filter { it.count >= sourceCount }
+        val weld = VertexWelder.weldAttributes(attributes, sourceCount)
+        val indices = IntArray(sourceIndices.size - sourceIndices.size % 3) { weld[sourceIndices[it]] }
 
-        // Simplified implementation - full version would use quadric error metrics
-        return buildSimplifiedGeometry(geometry, vertices, indices.take(targetTriangleCount * 3))
+        val state = CollapseState(positionAttribute, geometry, indices, sourceCount, options)
+        state.run(targetTriangleCount)
+        return state.build(geometry, triangleGroups(geometry, indices.size / 3))
     }
 
-    private fun extractVertices(positionAttribute: BufferAttribute): List<Vector3> {
-        val vertices = mutableListOf<Vector3>()
-        for (i in 0 until positionAttribute.count) {
-            vertices.add(
-                Vector3(
-                    positionAttribute.getX(i),
-                    positionAttribute.getY(i),
-                    positionAttribute.getZ(i)
-                )
-            )
-        }
-        return vertices
+    // Group of every triangle, or null when the geometry has no groups
+    private fun triangleGroups(geometry: BufferGeometry, triangleCount: Int): IntArray? {
+        val groups = geometry.groups
+        if (groups.isEmpty()) return null
+        val result = IntArray(triangleCount) { -1 }
+        groups.forEachIndexed { g, group ->
+            val first = (group.start / 3).coerceIn(0, triangleCount)
+            val last = ((group.start + group.count) / 3).coerceIn(first, triangleCount)
+            for (t in first until last) result[t] = g
+        }
+        return result
     }
 
-    private fun extractIndices(indexAttribute: BufferAttribute): List<Int> {
-        return indexAttribute.array.map { it.toInt() }
+    private class CollapseState(
+        positionAttribute: BufferAttribute,
+        geometry: BufferGeometry,
+        private val corners: IntArray,
+        private val vertexCount: Int,
+        private val options: SimplificationOptions
+    ) {
+        private val positions = positionAttribute.array
+        private val stride = positionAttribute.itemSize
+        private val triangleCount = corners.size / 3
+        private val features = listOfNotNull(
+            geometry.getAttribute("normal"),
+            geometry.getAttribute("uv"),
+            geometry.getAttribute("color")
+        ).filter { it.count >= vertexCount }
+
+        private val quadrics = DoubleArray(vertexCount * QUADRIC_SIZE)
+        private val locked = BooleanArray(vertexCount)
+        private val alive = BooleanArray(triangleCount) { true }
+        private val versions = IntArray(vertexCount)
+        private val removed = BooleanArray(vertexCount)
+
+        // Per-vertex triangle chains; merging a collapsed vertex's chain is O(1)
+        private val head = IntArray(vertexCount) { -1 }
+        private val tail = IntArray(vertexCount) { -1 }
+        private val next = IntArray(corners.size) { -1 }
+
+        private val heap = CollapseHeap(corners.size)
+        private val errorScale: Double
+        private val maxCost: Double
+        var liveTriangles = triangleCount
+            private set
+
+        init {
+            for (entry in corners.indices) {
+                val v = corners[entry]
+                if (head[v] < 0) head[v] = entry else next[tail[v]] = entry
+                tail[v] = entry
+            }
+
+            var minX = Float.POSITIVE_INFINITY
+            var minY = Float.POSITIVE_INFINITY
+            var minZ = Float.POSITIVE_INFINITY
+            var maxX = Float.NEGATIVE_INFINITY
+            var maxY = Float.NEGATIVE_INFINITY
+            var maxZ = Float.NEGATIVE_INFINITY
+            for (v in 0 until vertexCount) {
+                minX = minOf(minX, positions[v * stride])
+                minY = minOf(minY, positions[v * stride + 1])
+                minZ = minOf(minZ, positions[v * stride + 2])
+                maxX = maxOf(maxX, positions[v * stride])
+                maxY = maxOf(maxY, positions[v * stride + 1])
+                maxZ = maxOf(maxZ, positions[v * stride + 2])
+            }
+            val dx = (maxX - minX).toDouble()
+            val dy = (maxY - minY).toDouble()
+            val dz = (maxZ - minZ).toDouble()
+            val diagonalSq = dx * dx + dy * dy + dz * dz
+            errorScale = if (diagonalSq > 0.0) 1.0 / diagonalSq else 1.0
+            maxCost = if (options.maxError == Float.MAX_VALUE) {
+                Double.MAX_VALUE
+            } else {
+                options.maxError.toDouble() * options.maxError
+            }
+
+            for (t in 0 until triangleCount) {
+                if (corners[t * 3] == corners[t * 3 + 1] || corners[t * 3 + 1] == corners[t * 3 + 2] ||
+                    corners[t * 3] == corners[t * 3 + 2]
+                ) {
+                    alive[t] = false
+                    liveTriangles--
+                    continue
+                }
+                addTriangleQuadric(t)
+            }
+            classifyEdges()
+            pushInitialEdges()
+        }
+
+        fun run(targetTriangleCount: Int) {
+            while (liveTriangles > targetTriangleCount && heap.size > 0) {
+                val cost = heap.minCost()
+                if (cost > maxCost) break
+                val from = heap.minFrom()
+                val to = heap.minTo()
+                val fromVersion = heap.minFromVersion()
+                val toVersion = heap.minToVersion()
+                heap.pop()
+                if (removed[from] || removed[to]) continue
+                if (versions[from] != fromVersion || versions[to] != toVersion) continue
+                if (!canCollapse(from, to)) continue
+                collapse(from, to)
+            }
+        }
+
+        fun build(geometry: BufferGeometry, groups: IntArray?): BufferGeometry {
+            val result = BufferGeometry()
+            val order = ArrayList<Int>(liveTriangles)
+            val ranges = ArrayList<Triple<Int, Int, Int>>()
+            if (groups == null) {
+                for (t in 0 until triangleCount) if (alive[t]) order.add(t)
+            } else {
+                geometry.groups.forEachIndexed { g, group ->
+                    val start = order.size
+                    for (t in 0 until triangleCount) if (alive[t] && groups[t] == g) order.add(t)
+                    ranges.add(Triple(start * 3, (order.size - start) * 3, group.materialIndex))
+                }
+            }
+
+            // Surviving vertices, numbered in first-use order
+            val remap = IntArray(vertexCount) { -1 }
+            val used = ArrayList<Int>()
+            val outIndices = FloatArray(order.size * 3)
+            var cursor = 0
+            for (t in order) {
+                for (k in 0 until 3) {
+                    val v = corners[t * 3 + k]
+                    if (remap[v] < 0) {
+                        remap[v] = used.size
+                        used.add(v)
+                    }
+                    outIndices[cursor++] = remap[v].toFloat()
+                }
+            }
+
+            geometry.attributes.forEach { (name, attribute) ->
+                result.setAttribute(name, gather(attribute, used))
+            }
+            geometry.morphAttributes.forEach { (name, targets) ->
+                result.setMorphAttribute(name, targets.map { gather(it, used) }.toTypedArray())
+            }
+            result.morphTargetsRelative = geometry.morphTargetsRelative
+            result.setIndex(BufferAttribute(outIndices, 1))
+            ranges.forEach { (start, count, material) -> result.addGroup(start, count, material) }
+            result.name = geometry.name
+            return result
+        }
+
+        private fun gather(attribute: BufferAttribute, used: List<Int>): BufferAttribute {
+            val size = attribute.itemSize
+            val array = FloatArray(used.size * size)
+            used.forEachIndexed { i, v ->
+                if ((v + 1) * size <= attribute.array.size) attribute.array.copyInto(array, i * size, v * size, (v + 1) * size)
+            }
+            return BufferAttribute(array, size, attribute.normalized)
+        }
+
+        private fun addTriangleQuadric(t: Int) {
+            val a = corners[t * 3]
+            val b = corners[t * 3 + 1]
+            val c = corners[t * 3 + 2]
+            val ax = positions[a * stride].toDouble()
+            val ay = positions[a * stride + 1].toDouble()
+            val az = positions[a * stride + 2].toDouble()
+            val e1x = positions[b * stride] - ax
+            val e1y = positions[b * stride + 1] - ay
+            val e1z = positions[b * stride + 2] - az
+            val e2x = positions[c * stride] - ax
+            val e2y = positions[c * stride + 1] - ay
+            val e2z = positions[c * stride + 2] - az
+            var nx = e1y * e2z - e1z * e2y
+            var ny = e1z * e2x - e1x * e2z
+            var nz = e1x * e2y - e1y * e2x
+            val length = sqrt(nx * nx + ny * ny + nz * nz)
+            if (length <= 0.0) return
+            nx /= length
+            ny /= length
+            nz /= length
+            val d = -(nx * ax + ny * ay + nz * az)
+            val area = length * 0.5
+            addPlane(a, nx, ny, nz, d, area)
+            addPlane(b, nx, ny, nz, d, area)
+            addPlane(c, nx, ny, nz, d, area)
+        }
+
+        private fun addPlane(v: Int, a: Double, b: Double, c: Double, d: Double, weight: Double) {
+            val q = v * QUADRIC_SIZE
+            quadrics[q] += weight * a * a
+            quadrics[q + 1] += weight * a * b
+            quadrics[q + 2] += weight * a * c
+            quadrics[q + 3] += weight * a * d
+            quadrics[q + 4] += weight * b * b
+            quadrics[q + 5] += weight * b * c
+            quadrics[q + 6] += weight * b * d
+            quadrics[q + 7] += weight * c * c
+            quadrics[q + 8] += weight * c * d
+            quadrics[q + 9] += weight * d * d
+        }
+
+        // Locks seam, non-manifold and (optionally) border vertices; borders otherwise get constraint planes
+        private fun classifyEdges() {
+            val positionOf = VertexWelder.weldPositions(positions, stride, vertexCount, 0f)
+            val siblings = IntArray(vertexCount)
+            for (v in 0 until vertexCount) siblings[positionOf[v]]++
+            for (v in 0 until vertexCount) if (siblings[positionOf[v]] > 1) locked[v] = true
+
+            val keys = LongArray(liveTriangles * 3)
+            var count = 0
+            for (t in 0 until triangleCount) {
+                if (!alive[t]) continue
+                for (k in 0 until 3) {
+                    val a = positionOf[corners[t * 3 + k]]
+                    val b = positionOf[corners[t * 3 + (k + 1) % 3]]
+                    keys[count++] = edgeKey(a, b)
+                }
+            }
+            keys.sort()
+
+            val borderPositions = HashSet<Long>()
+            var i = 0
+            while (i < count) {
+                var j = i
+                while (j < count && keys[j] == keys[i]) j++
+                val uses = j - i
+                if (uses != 2) {
+                    val a = (keys[i] ushr 32).toInt()
+                    val b = (keys[i] and 0xFFFFFFFFL).toInt()
+                    if (uses > 2 || options.lockBorders) {
+                        locked[a] = true
+                        locked[b] = true
+                    } else {
+                        borderPositions.add(keys[i])
+                    }
+                }
+                i = j
+            }
+            // Canonical position vertices stand for their siblings
+            for (v in 0 until vertexCount) if (locked[positionOf[v]]) locked[v] = true
+
+            if (borderPositions.isEmpty()) return
+            for (t in 0 until triangleCount) {
+                if (!alive[t]) continue
+                for (k in 0 until 3) {
+                    val a = corners[t * 3 + k]
+                    val b = corners[t * 3 + (k + 1) % 3]
+                    if (edgeKey(positionOf[a], positionOf[b]) in borderPositions) addBorderPlane(t, a, b)
+                }
+            }
+        }
+
+        // Plane through the border edge, perpendicular to its triangle, heavily weighted
+        private fun addBorderPlane(t: Int, a: Int, b: Int) {
+            val c = corners[t * 3] + corners[t * 3 + 1] + corners[t * 3 + 2] - a - b
+            val ex = (positions[b * stride] - positions[a * stride]).toDouble()
+            val ey = (positions[b * stride + 1] - positions[a * stride + 1]).toDouble()
+            val ez = (positions[b * stride + 2] - positions[a * stride + 2]).toDouble()
+            val fx = (positions[c * stride] - positions[a * stride]).toDouble()
+            val fy = (positions[c * stride + 1] - positions[a * stride + 1]).toDouble()
+            val fz = (positions[c * stride + 2] - positions[a * stride + 2]).toDouble()
+            val fnx = ey * fz - ez * fy
+            val fny = ez * fx - ex * fz
+            val fnz = ex * fy - ey * fx
+            var nx = ey * fnz - ez * fny
+            var ny = ez * fnx - ex * fnz
+            var nz = ex * fny - ey * fnx
+            val length = sqrt(nx * nx + ny * ny + nz * nz)
+            if (length <= 0.0) return
+            nx /= length
+            ny /= length
+            nz /= length
+            val d = -(nx * positions[a * stride] + ny * positions[a * stride + 1] + nz * positions[a * stride + 2])
+            val weight = BORDER_WEIGHT * (ex * ex + ey * ey + ez * ez)
+            addPlane(a, nx, ny, nz, d, weight)
+            addPlane(b, nx, ny, nz, d, weight)
+        }
+
+        private fun pushInitialEdges() {
+            val keys = LongArray(liveTriangles * 3)
+            var count = 0
+            for (t in 0 until triangleCount) {
+                if (!alive[t]) continue
+                for (k in 0 until 3) keys[count++] = edgeKey(corners[t * 3 + k], corners[t * 3 + (k + 1) % 3])
+            }
+            keys.sort()
+            var previous = -1L
+            for (i in 0 until count) {
+                val key = keys[i]
+                if (key == previous) continue
+                previous = key
+                val a = (key ushr 32).toInt()
+                val b = (key and 0xFFFFFFFFL).toInt()
+                push(a, b)
+                push(b, a)
+            }
+        }
+
+        private fun push(from: Int, to: Int) {
+            if (locked[from]) return
+            heap.push(cost(from, to), from, to, versions[from], versions[to])
+        }
+
+        private fun cost(from: Int, to: Int): Float {
+            val q = from * QUADRIC_SIZE
+            val r = to * QUADRIC_SIZE
+            val x = positions[to * stride].toDouble()
+            val y = positions[to * stride + 1].toDouble()
+            val z = positions[to * stride + 2].toDouble()
+            fun k(i: Int) = quadrics[q + i] + quadrics[r + i]
+            val error = k(0) * x * x + 2 * k(1) * x * y + 2 * k(2) * x * z + 2 * k(3) * x +
+                    k(4) * y * y + 2 * k(5) * y * z + 2 * k(6) * y +
+                    k(7) * z * z + 2 * k(8) * z + k(9)
+
+            var attributeError = 0.0
+            for (attribute in features) {
+                val size = attribute.itemSize
+                for (c in 0 until size) {
+                    val delta = (attribute.array[from * size + c] - attribute.array[to * size + c]).toDouble()
+                    attributeError += delta * delta
+                }
+            }
+            return (maxOf(error, 0.0) * errorScale + options.attributeWeight * attributeError).toFloat()
+        }
+
+        // Rejects collapses that would flip or degenerate a triangle that survives them
+        private fun canCollapse(from: Int, to: Int): Boolean {
+            var entry = head[from]
+            while (entry >= 0) {
+                val t = entry / 3
+                entry = next[entry]
+                if (!alive[t]) continue
+                val a = corners[t * 3]
+                val b = corners[t * 3 + 1]
+                val c = corners[t * 3 + 2]
+                if (a == to || b == to || c == to) continue
+                if (a != from && b != from && c != from) continue
+
+                val before = normalOf(a, b, c, -1, 0, beforeScratch)
+                val after = normalOf(a, b, c, from, to, afterScratch)
+                val dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2]
+                val lengths = sqrt(before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) *
+                        sqrt(after[0] * after[0] + after[1] * after[1] + after[2] * after[2])
+                if (lengths <= 0.0 || dot <= FLIP_LIMIT * lengths) return false
+            }
+            return true
+        }
+
+        private val beforeScratch = DoubleArray(3)
+        private val afterScratch = DoubleArray(3)
+
+        private fun normalOf(a: Int, b: Int, c: Int, replace: Int, with: Int, out: DoubleArray): DoubleArray {
+            val ia = if (a == replace) with else a
+            val ib = if (b == replace) with else b
+            val ic = if (c == replace) with else c
+            val ax = positions[ia * stride].toDouble()
+            val ay = positions[ia * stride + 1].toDouble()
+            val az = positions[ia * stride + 2].toDouble()
+            val e1x = positions[ib * stride] - ax
+            val e1y = positions[ib * stride + 1] - ay
+            val e1z = positions[ib * stride + 2] - az
+            val e2x = positions[ic * stride] - ax
+            val e2y = positions[ic * stride + 1] - ay
+            val e2z = positions[ic * stride + 2] - az
+            out[0] = e1y * e2z - e1z * e2y
+            out[1] = e1z * e2x - e1x * e2z
+            out[2] = e1x * e2y - e1y * e2x
+            return out
+        }
+
+        private fun collapse(from: Int, to: Int) {
+            var entry = head[from]
+            while (entry >= 0) {
+                val t = entry / 3
+                entry = next[entry]
+                if (!alive[t]) continue
+                for (k in 0 until 3) if (corners[t * 3 + k] == from) corners[t * 3 + k] = to
+                if (corners[t * 3] == corners[t * 3 + 1] || corners[t * 3 + 1] == corners[t * 3 + 2] ||
+                    corners[t * 3] == corners[t * 3 + 2]
+                ) {
+                    alive[t] = false
+                    liveTriangles--
+                }
+            }
+            if (head[from] >= 0) {
+                if (head[to] < 0) head[to] = head[from] else next[tail[to]] = head[from]
+                tail[to] = tail[from]
+            }
+            head[from] = -1
+
+            for (i in 0 until QUADRIC_SIZE) quadrics[to * QUADRIC_SIZE + i] += quadrics[from * QUADRIC_SIZE + i]
+            removed[from] = true
+            versions[from]++
+            versions[to]++
+
+            entry = head[to]
+            while (entry >= 0) {
+                val t = entry / 3
+                entry = next[entry]
+                if (!alive[t]) continue
+                for (k in 0 until 3) {
+                    val other = corners[t * 3 + k]
+                    if (other == to) continue
+                    push(to, other)
+                    push(other, to)
+                }
+            }
+        }
+
+        private fun edgeKey(a: Int, b: Int): Long {
+            val low = minOf(a, b).toLong()
+            val high = maxOf(a, b).toLong()
+            return (low shl 32) or high
+        }
     }
 
-    private fun buildSimplifiedGeometry(
-        originalGeometry: BufferGeometry,
-        vertices: List<Vector3>,
-        indices: List<Int>
-    ): BufferGeometry {
-        val result = BufferGeometry()
+    // Binary min-heap of candidate collapses on parallel primitive arrays
+    private class CollapseHeap(initialCapacity: Int) {
+        private var costs = FloatArray(maxOf(initialCapacity, 16))
+        private var froms = IntArray(costs.size)
+        private var tos = IntArray(costs.size)
+        private var fromVersions = IntArray(costs.size)
+        private var toVersions = IntArray(costs.size)
+        var size = 0
+            private set
+
+        fun minCost(): Double = costs[0].toDouble()
+        fun minFrom(): Int = froms[0]
+        fun minTo(): Int = tos[0]
+        fun minFromVersion(): Int = fromVersions[0]
+        fun minToVersion(): Int = toVersions[0]
 
-        // Build position attribute
-        val positionArray = FloatArray(vertices.size * 3)
-        vertices.forEachIndexed { i, vertex ->
-            positionArray[i * 3] = vertex.x
-            positionArray[i * 3 + 1] = vertex.y
-            positionArray[i * 3 + 2] = vertex.z
+        fun push(cost: Float, from: Int, to: Int, fromVersion: Int, toVersion: Int) {
+            if (size == costs.size) grow()
+            var i = size++
+            while (i > 0) {
+                val parent = (i - 1) / 2
+                if (costs[parent] <= cost) break
+                move(parent, i)
+                i = parent
+            }
+            costs[i] = cost
+            froms[i] = from
+            tos[i] = to
+            fromVersions[i] = fromVersion
+            toVersions[i] = toVersion
         }
-        result.setAttribute("position", BufferAttribute(positionArray, 3))
 
-        // Set index (BufferAttribute expects FloatArray, convert indices)
-        val indexArray = indices.map { it.toFloat() }.toFloatArray()
-        result.setIndex(BufferAttribute(indexArray, 1))
+        fun pop() {
+            size--
+            if (size == 0) return
+            val cost = costs[size]
+            val from = froms[size]
+            val to = tos[size]
+            val fromVersion = fromVersions[size]
+            val toVersion = toVersions[size]
+            var i = 0
+            while (true) {
+                var child = i * 2 + 1
+                if (child >= size) break
+                if (child + 1 < size && costs[child + 1] < costs[child]) child++
+                if (costs[child] >= cost) break
+                move(child, i)
+                i = child
+            }
+            costs[i] = cost
+            froms[i] = from
+            tos[i] = to
+            fromVersions[i] = fromVersion
+            toVersions[i] = toVersion
+        }
 
-        return result
+        private fun move(from: Int, to: Int) {
+            costs[to] = costs[from]
+            froms[to] = froms[from]
+            tos[to] = tos[from]
+            fromVersions[to] = fromVersions[from]
+            toVersions[to] = toVersions[from]
+        }
+
+        private fun grow() {
+            val capacity = costs.size * 2
+            costs = costs.copyOf(capacity)
+            froms = froms.copyOf(capacity)
+            tos = tos.copyOf(capacity)
+            fromVersions = fromVersions.copyOf(capacity)
+            toVersions = toVersions.copyOf(capacity)
+        }
+    }
+
+    private companion object {
+        const val QUADRIC_SIZE = 10
+        const val BORDER_WEIGHT = 10.0
+
+        // Smallest cosine between a triangle's normal before and after a collapse
+        const val FLIP_LIMIT = 0.0
     }
 }
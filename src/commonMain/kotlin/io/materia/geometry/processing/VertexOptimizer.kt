@@ -3,10 +3,10 @@
  */
 package io.materia.geometry.processing
 
-import io.materia.core.math.Vector3
 import io.materia.geometry.BufferGeometry
 import io.materia.geometry.BufferAttribute
 import io.materia.geometry.GeometryMergeResult
+import io.materia.geometry.MeshOptimizationOptions
 
 /**
  * Optimizes vertex data for GPU rendering
@@ -18,7 +18,8 @@ class VertexOptimizer {
     }
 
     /**
-     * Merge duplicate vertices within threshold
+     * Merge duplicate vertices within threshold, keeping the attributes of the first
+     * vertex of each cluster. Uses a spatial hash, so it runs in linear time.
      */
     fun mergeVertices(
         geometry: BufferGeometry,
@@ -27,47 +28,27 @@ class VertexOptimizer {
         val positionAttribute = geometry.getAttribute("position")
             ?: return GeometryMergeResult(geometry.clone(), 0)
 
-        val vertices = mutableListOf<Vector3>()
-        val vertexMap = mutableMapOf<Int, Int>()
-        val newIndices = mutableListOf<Int>()
+        val vertexCount = positionAttribute.count
+        val weld = VertexWelder.weldPositions(
+            positionAttribute.array, positionAttribute.itemSize, vertexCount, threshold
+        )
 
-        // Extract and process vertices
-        for (i in 0 until positionAttribute.count) {
-            val vertex = Vector3(
-                positionAttribute.getX(i),
-                positionAttribute.getY(i),
-                positionAttribute.getZ(i)
-            )
-
-            // Find existing vertex within threshold
-            val existingIndex = findNearestVertex(vertices, vertex, threshold)
-
-            if (existingIndex >= 0) {
-                vertexMap[i] = existingIndex
-            } else {
-                vertexMap[i] = vertices.size
-                vertices.add(vertex)
-            }
+        // Kept vertices in their original order
+        val compacted = IntArray(vertexCount)
+        var kept = 0
+        for (i in 0 until vertexCount) {
+            compacted[i] = if (weld[i] == i) kept++ else compacted[weld[i]]
         }
 
-        // Update indices
         val originalIndex = geometry.index
-        if (originalIndex != null) {
-            for (i in 0 until originalIndex.count) {
-                val oldIndex = originalIndex.array[i].toInt()
-                newIndices.add(vertexMap[oldIndex] ?: oldIndex)
-            }
+        val newIndices = if (originalIndex != null) {
+            IntArray(originalIndex.count) { compacted[originalIndex.array[it].toInt()] }
         } else {
-            for (i in 0 until positionAttribute.count) {
-                newIndices.add(vertexMap[i] ?: i)
-            }
+            IntArray(vertexCount) { compacted[it] }
         }
 
-        // Build merged geometry
-        val mergedGeometry = buildMergedGeometry(geometry, vertices, newIndices)
-        val mergedVertices = positionAttribute.count - vertices.size
-
-        return GeometryMergeResult(mergedGeometry, mergedVertices)
+        val mergedGeometry = buildMergedGeometry(geometry, weld, kept, newIndices)
+        return GeometryMergeResult(mergedGeometry, vertexCount - kept)
     }
 
     /**
@@ -87,46 +68,124 @@ class VertexOptimizer {
     }
 
     /**
-     * Optimize vertex cache using simplified Forsyth algorithm
+     * Reorder triangles for the post-transform vertex cache (Forsyth), within each group.
+     * Non-indexed geometry is returned as a clone.
      */
-    fun optimizeVertexCache(geometry: BufferGeometry): BufferGeometry {
-        // Simplified implementation
-        return geometry.clone()
+    fun optimizeVertexCache(
+        geometry: BufferGeometry,
+        cacheSize: Int = IndexOptimizer.DEFAULT_CACHE_SIZE
+    ): BufferGeometry = reorderTriangles(geometry) { indices, vertexCount ->
+        IndexOptimizer.optimizeVertexCache(indices, vertexCount, cacheSize)
     }
 
-    private fun findNearestVertex(
-        vertices: List<Vector3>,
-        target: Vector3,
-        threshold: Float
-    ): Int {
-        val thresholdSq = threshold * threshold
-
-        for (i in vertices.indices) {
-            val distanceSq = vertices[i].distanceToSquared(target)
-            if (distanceSq <= thresholdSq) {
-                return i
-            }
+    /**
+     * Reorder cache-optimized triangles so outer surfaces draw first, within each group,
+     * giving up at most [threshold] of vertex cache efficiency.
+     */
+    fun optimizeOverdraw(
+        geometry: BufferGeometry,
+        threshold: Float = IndexOptimizer.DEFAULT_OVERDRAW_THRESHOLD,
+        cacheSize: Int = IndexOptimizer.DEFAULT_CACHE_SIZE
+    ): BufferGeometry {
+        val position = geometry.getAttribute("position") ?: return geometry.clone()
+        if (position.itemSize < 3) return geometry.clone()
+        return reorderTriangles(geometry) { indices, vertexCount ->
+            IndexOptimizer.optimizeOverdraw(
+                indices, position.array, vertexCount, position.itemSize, threshold, cacheSize
+            )
+        }
+    }
+
+    /**
+     * Renumber vertices in first-use order, rewriting every vertex and morph attribute.
+     * Non-indexed geometry is returned as a clone.
+     */
+    fun optimizeVertexFetch(geometry: BufferGeometry): BufferGeometry {
+        val result = geometry.clone()
+        val index = result.index ?: return result
+        val indices = IntArray(index.count) { index.array[it].toInt() }
+        val vertexCount = vertexCount(result, indices)
+        val remap = IndexOptimizer.optimizeVertexFetch(indices, vertexCount)
+
+        result.attributes.forEach { (name, attribute) ->
+            result.setAttribute(name, remapAttribute(attribute, remap))
+        }
+        result.morphAttributes.forEach { (name, targets) ->
+            result.setMorphAttribute(name, targets.map { remapAttribute(it, remap) }.toTypedArray())
         }
+        result.setIndex(BufferAttribute(FloatArray(indices.size) { indices[it].toFloat() }, 1))
+        return result
+    }
 
-        return -1
+    /**
+     * Run the import-time stages enabled in [options]: vertex cache, then overdraw, then
+     * vertex fetch order. Only triangle lists should be passed.
+     */
+    fun optimizeForRendering(
+        geometry: BufferGeometry,
+        options: MeshOptimizationOptions = MeshOptimizationOptions()
+    ): BufferGeometry {
+        var result = geometry
+        if (options.vertexCache) result = optimizeVertexCache(result, options.cacheSize)
+        if (options.overdraw) result = optimizeOverdraw(result, options.overdrawThreshold, options.cacheSize)
+        if (options.vertexFetch) result = optimizeVertexFetch(result)
+        return if (result === geometry) geometry.clone() else result
     }
 
+    // Applies [reorder] to the index range of every group, or to the whole index buffer
+    private inline fun reorderTriangles(
+        geometry: BufferGeometry,
+        reorder: (IntArray, Int) -> IntArray
+    ): BufferGeometry {
+        val result = geometry.clone()
+        val index = result.index ?: return result
+        val source = index.array
+        val vertexCount = vertexCount(result, IntArray(index.count) { source[it].toInt() })
+        val output = source.copyOf()
+        val ranges = result.groups.map { it.start to it.start + it.count }.ifEmpty { listOf(0 to index.count) }
+        for ((start, end) in ranges) {
+            val from = start.coerceIn(0, index.count)
+            val to = from + (end.coerceIn(from, index.count) - from) / 3 * 3
+            if (to - from < 6) continue
+            val indices = IntArray(to - from) { source[from + it].toInt() }
+            val reordered = reorder(indices, vertexCount)
+            for (i in reordered.indices) output[from + i] = reordered[i].toFloat()
+        }
+        result.setIndex(BufferAttribute(output, 1))
+        return result
+    }
+
+    private fun vertexCount(geometry: BufferGeometry, indices: IntArray): Int =
+        maxOf(geometry.getAttribute("position")?.count ?: 0, (indices.maxOrNull() ?: -1) + 1)
+
+    private fun remapAttribute(attribute: BufferAttribute, remap: IntArray): BufferAttribute =
+        BufferAttribute(
+            IndexOptimizer.remapVertices(attribute.array, attribute.itemSize, remap),
+            attribute.itemSize,
+            attribute.normalized
+        )
+
     private fun buildMergedGeometry(
         originalGeometry: BufferGeometry,
-        vertices: List<Vector3>,
-        indices: List<Int>
+        weld: IntArray,
+        keptCount: Int,
+        indices: IntArray
     ): BufferGeometry {
         val result = BufferGeometry()
 
-        val positionArray = FloatArray(vertices.size * 3)
-        vertices.forEachIndexed { i, vertex ->
-            positionArray[i * 3] = vertex.x
-            positionArray[i * 3 + 1] = vertex.y
-            positionArray[i * 3 + 2] = vertex.z
+        originalGeometry.attributes.forEach { (name, attribute) ->
+            val size = attribute.itemSize
+            val array = FloatArray(keptCount * size)
+            var write = 0
+            for (i in weld.indices) {
+                if (weld[i] != i || (i + 1) * size > attribute.array.size) continue
+                attribute.array.copyInto(array, write, i * size, (i + 1) * size)
+                write += size
+            }
+            result.setAttribute(name, BufferAttribute(array, size, attribute.normalized))
         }
-        result.setAttribute("position", BufferAttribute(positionArray, 3))
 
-        val indexArray = indices.map { it.toFloat() }.toFloatArray()
+        val indexArray = FloatArray(indices.size) { indices[it].toFloat() }
         result.setIndex(BufferAttribute(indexArray, 1))
 
         return result
@@ -0,0 +1,132 @@
+/**
+ * Spatial-hash vertex welding
+ */
+package io.materia.geometry.processing
+
+import io.materia.geometry.BufferAttribute
+import kotlin.math.floor
+
+/**
+ * Finds duplicate vertices in expected linear time by hashing them into a grid, instead
+ * of comparing every vertex with every other.
+ *
+ * Both functions return a remap table where `remap[i]` is the vertex that [i] welds to:
+ * the earliest kept vertex, so `remap[i] <= i` and kept vertices map to themselves.
+ */
+object VertexWelder {
+    private const val CELL_BITS = 21
+    private const val CELL_MASK = (1L shl CELL_BITS) - 1
+
+    /**
+     * Welds vertices whose positions lie within [threshold] of an earlier kept vertex,
+     * matching the first such vertex as a linear scan would. Cells are [threshold] wide,
+     * so only the 27 cells around a vertex need checking. A threshold of 0 welds exact
+     * duplicates only.
+     *
+     * @param positions Position data, [stride] floats per vertex starting at xyz.
+     */
+    fun weldPositions(positions: FloatArray, stride: Int, count: Int, threshold: Float): IntArray {
+        require(stride >= 3) { "Positions need at least 3 floats per vertex (stride $stride)" }
+        require(threshold >= 0f) { "threshold must not be negative (was $threshold)" }
+        if (threshold == 0f) return weldExact(positions, stride, 3, count)
+
+        val remap = IntArray(count)
+        val thresholdSq = threshold * threshold
+        val inverseCell = 1f / threshold
+        val heads = HashMap<Long, Int>(count * 2)
+        val next = IntArray(count) { -1 }
+
+        for (i in 0 until count) {
+            val x = positions[i * stride]
+            val y = positions[i * stride + 1]
+            val z = positions[i * stride + 2]
+            val cx = floor(x * inverseCell).toLong()
+            val cy = floor(y * inverseCell).toLong()
+            val cz = floor(z * inverseCell).toLong()
+
+            var match = Int.MAX_VALUE
+            for (dx in -1L..1L) {
+                for (dy in -1L..1L) {
+                    for (dz in -1L..1L) {
+                        var candidate = heads[cellKey(cx + dx, cy + dy, cz + dz)] ?: -1
+                        while (candidate >= 0) {
+                            if (candidate < match) {
+                                val ox = positions[candidate * stride] - x
+                                val oy = positions[candidate * stride + 1] - y
+                                val oz = positions[candidate * stride + 2] - z
+                                if (ox * ox + oy * oy + oz * oz <= thresholdSq) match = candidate
+                            }
+                            candidate = next[candidate]
+                        }
+                    }
+                }
+            }
+
+            if (match != Int.MAX_VALUE) {
+                remap[i] = match
+            } else {
+                remap[i] = i
+                val key = cellKey(cx, cy, cz)
+                next[i] = heads[key] ?: -1
+                heads[key] = i
+            }
+        }
+        return remap
+    }
+
+    /**
+     * Welds vertices whose every attribute in [attributes] is bit-for-bit equal, e.g. to
+     * index a triangle soup without merging across UV or normal seams.
+     */
+    fun weldAttributes(attributes: List<BufferAttribute>, count: Int): IntArray {
+        val remap = IntArray(count)
+        val heads = HashMap<Int, Int>(count * 2)
+        val next = IntArray(count) { -1 }
+
+        for (i in 0 until count) {
+            var hash = 17
+            for (attribute in attributes) {
+                val base = i * attribute.itemSize
+                for (c in 0 until attribute.itemSize) hash = hash * 31 + attribute.array[base + c].toRawBits()
+            }
+            var candidate = heads[hash] ?: -1
+            var match = -1
+            while (candidate >= 0 && match < 0) {
+                if (attributes.all { sameItem(it, candidate, i) }) match = candidate
+                candidate = next[candidate]
+            }
+            if (match >= 0) {
+                remap[i] = match
+            } else {
+                remap[i] = i
+                next[i] = heads[hash] ?: -1
+                heads[hash] = i
+            }
+        }
+        return remap
+    }
+
+    private fun weldExact(data: FloatArray, stride: Int, width: Int, count: Int): IntArray =
+        weldAttributes(
+            listOf(
+                if (stride == width) {
+                    BufferAttribute(data, width)
+                } else {
+                    BufferAttribute(FloatArray(count * width) { data[(it / width) * stride + it % width] }, width)
+                }
+            ),
+            count
+        )
+
+    private fun sameItem(attribute: BufferAttribute, a: Int, b: Int): Boolean {
+        val size = attribute.itemSize
+        for (c in 0 until size) {
+            if (attribute.array[a * size + c].toRawBits() != attribute.array[b * size + c].toRawBits()) return false
+        }
+        return true
+    }
+
+    // Wrapping to 21 bits per axis only adds candidates; distances are still checked
+    private fun cellKey(x: Long, y: Long, z: Long): Long =
+        ((x and CELL_MASK) shl (CELL_BITS * 2)) or ((y and CELL_MASK) shl CELL_BITS) or (z and CELL_MASK)
+}
@@ -9,7 +9,12 @@ import io.materia.core.math.Vector3
 import io.materia.core.scene.Material
 import io.materia.core.scene.Object3D
 import io.materia.core.scene.Scene
+import io.materia.lighting.shadow.CascadedShadowMapImpl
+import io.materia.lighting.shadow.CascadedShadowRenderer
 import io.materia.lighting.shadow.FrustumCalculator
+import io.materia.lighting.shadow.ShadowAtlas
+import io.materia.lighting.shadow.ShadowCascadeImpl
+import io.materia.lighting.shadow.ShadowDepthPass
 import io.materia.lighting.shadow.ShadowGenerator
 import io.materia.lighting.shadow.ShadowSampler
 import io.materia.renderer.Texture
@@ -20,17 +25,40 @@ import io.materia.material.Material as ConcreteMaterial
  * High-quality shadow mapping implementation
  * This file serves as the public API entry point.
  * Implementation is in io.materia.lighting.shadow package.
+ *
+ * Directional lights use cascaded shadow maps whose cascades, for all lights, are packed
+ * into [shadowAtlas]. Depth is written through [depthPass]; no backend supplies one yet,
+ * so on its own this schedules, fits and culls cascades without rendering them.
  */
-class ShadowMapperImpl : ShadowMapper {
+class ShadowMapperImpl(
+    /** Atlas shared by the cascades of every directional light. */
+    val shadowAtlas: ShadowAtlas = ShadowAtlas()
+) : ShadowMapper {
 
     private val frustumCalculator = FrustumCalculator()
     private val shadowGenerator = ShadowGenerator(frustumCalculator)
     private val shadowSampler = ShadowSampler()
+    private val cascadedShadowRenderer = CascadedShadowRenderer(frustumCalculator)
 
+    private var shadowBias: Float = 0.0005f
     private var shadowNormalBias: Float = 0.01f
-    private var cullingDistance: Float = 100.0f
-    private var lodBias: Float = 0.0f
-    private var shadowLODEnabled: Boolean = true
+    private val lastCascades = HashMap<Int, CascadedShadowMapImpl>()
+
+    /** Renders caster depth; null (the default) skips it. Cached cascades are re-rendered when it changes. */
+    var depthPass: ShadowDepthPass? = null
+        set(value) {
+            field = value
+            cascadedShadowRenderer.invalidate()
+        }
+
+    /** Cascades rendered for directional lights by [renderShadowMap]. */
+    var cascadeCount: Int = 4
+        set(value) {
+            require(value in 1..CascadedShadowRenderer.MAX_CASCADES) {
+                "cascadeCount must be within 1..${CascadedShadowRenderer.MAX_CASCADES} (was $value)"
+            }
+            field = value
+        }
 
     private var maxShadowMaps: Int = 8
     private var shadowMapPool: MutableList<io.materia.lighting.ShadowMap> = mutableListOf()
@@ -47,9 +75,9 @@ class ShadowMapperImpl : ShadowMapper {
         return try {
             when (light) {
                 is DirectionalLight -> {
-                    val result = shadowGenerator.generateDirectionalShadowMap(light, scene)
+                    val result = generateCascadedShadowMap(light, scene, camera, cascadeCount, objects)
                     when (result) {
-                        is ShadowResult.Success -> ShadowResult.Success(result.data.texture)
+                        is ShadowResult.Success -> ShadowResult.Success(shadowAtlas.texture)
                         is ShadowResult.Error -> result
                     }
                 }
@@ -143,11 +171,22 @@ class ShadowMapperImpl : ShadowMapper {
 
         when (light) {
             is DirectionalLight -> {
-                material.setUniform("shadowCascadeCount", 4)
-                material.setUniform(
-                    "shadowCascadeSplits",
-                    frustumCalculator.calculateCascadeSplits(PerspectiveCamera(), 4)
-                )
+                val cascaded = lastCascades[light.id]
+                if (cascaded != null) {
+                    material.setUniform("shadowCascadeCount", cascaded.cascades.size)
+                    material.setUniform("shadowCascadeSplits", cascaded.splitDistances)
+                    material.setUniform("shadowCascadeMatrices", cascaded.cascades.map { it.projectionViewMatrix })
+                    material.setUniform(
+                        "shadowCascadeAtlasRegions",
+                        cascaded.cascades.mapNotNull { (it as? ShadowCascadeImpl)?.region?.uvScaleOffset }
+                    )
+                } else {
+                    material.setUniform("shadowCascadeCount", cascadeCount)
+                    material.setUniform(
+                        "shadowCascadeSplits",
+                        frustumCalculator.calculateCascadeSplits(PerspectiveCamera(), cascadeCount)
+                    )
+                }
             }
 
             is SpotLight -> {
@@ -172,13 +211,37 @@ class ShadowMapperImpl : ShadowMapper {
         }
     }
 
+    /**
+     * Renders [cascadeCount] cascades of [light] for [camera] into [shadowAtlas].
+     *
+     * Casters are the visible shadow-casting meshes of [scene], or of [objects] when it is
+     * not empty, culled per cascade.
+     */
     suspend fun generateCascadedShadowMap(
         light: DirectionalLight,
         scene: Scene,
         camera: Camera,
-        cascadeCount: Int
+        cascadeCount: Int,
+        objects: List<Object3D> = emptyList()
     ): ShadowResult<io.materia.lighting.CascadedShadowMap> {
-        return shadowGenerator.generateCascadedShadowMap(light, scene, camera, cascadeCount)
+        return try {
+            val result = cascadedShadowRenderer.render(
+                light, scene, objects, camera, cascadeCount, shadowAtlas, depthPass, shadowBias
+            )
+            if (result is ShadowResult.Success) {
+                lastCascades[light.id] = result.data as CascadedShadowMapImpl
+            }
+            result
+        } catch (e: Exception) {
+            ShadowResult.Error(ShadowMapGenerationFailed("Failed to generate cascaded shadow map: ${e.message}"))
+        }
+    }
+
+    /** Frees the atlas tiles and cached cascades of a light that no longer casts shadows. */
+    fun releaseLight(light: Light) {
+        shadowAtlas.release(light.id)
+        cascadedShadowRenderer.release(light.id)
+        lastCascades.remove(light.id)
     }
 
     suspend fun generateOmnidirectionalShadowMap(
@@ -193,6 +256,7 @@ class ShadowMapperImpl : ShadowMapper {
     }
 
     fun setShadowBias(bias: Float) {
+        this.shadowBias = bias
         shadowSampler.setShadowBias(bias)
         shadowGenerator.setShadowBias(bias)
     }
@@ -205,16 +269,29 @@ class ShadowMapperImpl : ShadowMapper {
         this.shadowNormalBias = bias
     }
 
+    /** Sets the view distance covered by the cascades; casters beyond their reach are culled. */
     fun setCullingDistance(distance: Float) {
-        this.cullingDistance = distance
+        require(distance > 0f) { "Culling distance must be positive" }
+        cascadedShadowRenderer.shadowDistance = distance
     }
 
+    /** Raises the size below which casters are dropped from a cascade by `2^bias` texels. */
     fun setLODBias(bias: Float) {
-        this.lodBias = bias
+        cascadedShadowRenderer.lodBias = bias
     }
 
+    /** Enables dropping casters smaller than a shadow texel from each cascade. */
     fun enableShadowLOD(enabled: Boolean) {
-        this.shadowLODEnabled = enabled
+        cascadedShadowRenderer.lodEnabled = enabled
+    }
+
+    /**
+     * Sets how many of the farthest cascades cache the depth of static casters, re-rendering
+     * it only when the light, the cascade placement or the static casters change.
+     */
+    fun setCachedCascades(count: Int) {
+        require(count in 0..CascadedShadowRenderer.MAX_CASCADES) { "Cached cascade count must be within 0..${CascadedShadowRenderer.MAX_CASCADES}" }
+        cascadedShadowRenderer.cachedCascades = count
     }
 
     fun sampleShadowMap(
@@ -0,0 +1,317 @@
+package io.materia.lighting.shadow
+
+import io.materia.camera.Camera
+import io.materia.core.math.Box3
+import io.materia.core.math.Matrix4
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.Object3D
+import io.materia.lighting.CascadedShadowMap
+import io.materia.lighting.DirectionalLight
+import io.materia.lighting.ShadowCascade
+import io.materia.lighting.ShadowMapGenerationFailed
+import io.materia.lighting.ShadowResult
+import io.materia.renderer.Texture
+import kotlin.math.abs
+import kotlin.math.ceil
+import kotlin.math.floor
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.pow
+
+/**
+ * Cascaded shadow maps for directional lights, packed into a [ShadowAtlas].
+ *
+ * Each cascade is fitted to the bounding sphere of its slice of the camera frustum, so its
+ * extent does not change as the camera turns, and its origin is snapped to whole shadow
+ * texels in a light space anchored at the world origin, so shadow edges do not shimmer as
+ * the camera moves. Casters are culled per cascade against the cascade's orthographic
+ * volume, which is stretched towards the light to keep casters outside the camera frustum.
+ *
+ * The farthest [cachedCascades] cascades keep the depth of their static casters
+ * ([Object3D.isStatic]) in a texture of their own. They are fitted with [cachePadding] of
+ * slack and keep their placement while the camera stays inside it; the static depth is
+ * re-rendered only when the light turns, the cascade has to move, or a static caster is
+ * added, removed or moved. Otherwise the cached depth is copied into the atlas and only
+ * dynamic casters are drawn on top.
+ */
+internal class CascadedShadowRenderer(
+    private val frustumCalculator: FrustumCalculator
+) {
+    /** View distance the cascades cover; casters no cascade reaches are culled. */
+    var shadowDistance: Float = 100f
+
+    /** Whether casters smaller than a shadow texel of a cascade are dropped from it. */
+    var lodEnabled: Boolean = true
+
+    /** Raises the LOD size cutoff by `2^lodBias` texels. */
+    var lodBias: Float = 0f
+
+    /** Blend between uniform (0) and logarithmic (1) cascade splits. */
+    var splitLambda: Float = 0.5f
+
+    /** Number of far cascades whose static depth is cached. */
+    var cachedCascades: Int = 1
+
+    /** Fraction by which cached cascades are enlarged so the camera can move inside them. */
+    var cachePadding: Float = 0.25f
+
+    private class Caster(val mesh: Mesh, val lightBounds: Box3, val isStatic: Boolean)
+
+    /** Light-space placement of a cascade. */
+    private data class CascadeBounds(
+        val left: Float,
+        val right: Float,
+        val bottom: Float,
+        val top: Float,
+        val near: Float,
+        val far: Float
+    )
+
+    private class CachedCascade(
+        val direction: Vector3,
+        val bounds: CascadeBounds,
+        val regionSize: Int,
+        val staticSignature: Long,
+        val staticDepth: Texture
+    )
+
+    private val cache = HashMap<Long, CachedCascade>()
+
+    /**
+     * Fits, culls and renders [cascadeCount] cascades of [light] for [camera].
+     *
+     * [candidates] limits the casters to the given objects and their descendants; when
+     * empty, every visible shadow-casting mesh of [root] is considered.
+     */
+    fun render(
+        light: DirectionalLight,
+        root: Object3D,
+        candidates: List<Object3D>,
+        camera: Camera,
+        cascadeCount: Int,
+        atlas: ShadowAtlas,
+        depthPass: ShadowDepthPass?,
+        bias: Float
+    ): ShadowResult<CascadedShadowMap> {
+        require(cascadeCount in 1..MAX_CASCADES) { "cascadeCount must be within 1..$MAX_CASCADES (was $cascadeCount)" }
+        val far = min(camera.far, shadowDistance)
+        require(far > camera.near) { "Shadow distance $far must lie beyond the camera near plane ${camera.near}" }
+
+        val regions = atlas.allocate(light.id, cascadeCount, light.shadowMapSize)
+            ?: return ShadowResult.Error(ShadowMapGenerationFailed("Shadow atlas has no room for light ${light.id}"))
+        if (cascadeCount < MAX_CASCADES) {
+            for (i in cascadeCount until MAX_CASCADES) cache.remove(cacheKey(light.id, i))?.staticDepth?.dispose()
+        }
+
+        val direction = light.direction.normalized()
+        val lightView = lightViewMatrix(direction)
+        val casters = collectCasters(root, candidates, lightView)
+        val splits = frustumCalculator.calculateCascadeSplits(camera, cascadeCount, splitLambda, camera.near, far)
+        val cascades = ArrayList<ShadowCascade>(cascadeCount)
+
+        for (i in 0 until cascadeCount) {
+            val region = regions[i]
+            val corners = frustumCalculator.calculateCascadeCorners(camera, splits[i], splits[i + 1])
+            val cached = i >= cascadeCount - cachedCascades
+            val key = cacheKey(light.id, i)
+            val previous = cache[key]?.takeIf {
+                cached && it.regionSize == region.size && it.direction == direction
+            }
+
+            // A cached cascade keeps its placement while the camera slice stays inside it
+            // and no caster pokes through its near plane
+            val sphere = boundingSphere(corners, lightView)
+            val kept = previous?.bounds?.takeIf { encloses(it, sphere) }
+            val keptVisible = kept?.let { b ->
+                cull(casters, b, region.size).takeIf { visible -> visible.none { nearestDepth(it) < b.near } }
+            }
+            val bounds: CascadeBounds
+            val visible: List<Caster>
+            if (kept != null && keptVisible != null) {
+                bounds = kept
+                visible = keptVisible
+            } else {
+                bounds = fit(sphere, if (cached) 1f + cachePadding else 1f, region.size, casters)
+                visible = cull(casters, bounds, region.size)
+            }
+
+            val viewProjection = Matrix4()
+                .makeOrthographic(bounds.left, bounds.right, bounds.top, bounds.bottom, bounds.near, bounds.far)
+                .multiply(lightView)
+
+            var reused = false
+            if (cached) {
+                val statics = visible.filter { it.isStatic }.map { it.mesh }
+                val dynamics = visible.filter { !it.isStatic }.map { it.mesh }
+                val signature = staticSignature(statics)
+                val staticDepth = if (previous != null && previous.bounds == bounds && previous.staticSignature == signature) {
+                    reused = true
+                    previous.staticDepth
+                } else {
+                    val texture = previous?.staticDepth ?: run {
+                        cache.remove(key)?.staticDepth?.dispose()
+                        ShadowDepthTexture(region.size, region.size)
+                    }
+                    depthPass?.renderDepth(
+                        texture, ShadowAtlasRegion(0, 0, region.size, region.size), viewProjection, statics, clear = true
+                    )
+                    cache[key] = CachedCascade(direction, bounds, region.size, signature, texture)
+                    texture
+                }
+                depthPass?.copyDepth(staticDepth, atlas.texture, region)
+                depthPass?.renderDepth(atlas.texture, region, viewProjection, dynamics, clear = false)
+            } else {
+                cache.remove(key)?.staticDepth?.dispose()
+                depthPass?.renderDepth(atlas.texture, region, viewProjection, visible.map { it.mesh }, clear = true)
+            }
+
+            cascades += ShadowCascadeImpl(
+                texture = atlas.texture,
+                projectionViewMatrix = viewProjection,
+                splitDistance = splits[i + 1],
+                region = region,
+                casterCount = visible.size,
+                reusedStaticDepth = reused
+            )
+        }
+
+        return ShadowResult.Success(
+            CascadedShadowMapImpl(
+                cascades = cascades,
+                splitDistances = splits,
+                texture = atlas.texture,
+                lightSpaceMatrix = lightView,
+                near = splits.first(),
+                far = splits.last(),
+                bias = bias
+            )
+        )
+    }
+
+    /** Drops the cached static depth of [lightId]. */
+    fun release(lightId: Int) {
+        for (i in 0 until MAX_CASCADES) cache.remove(cacheKey(lightId, i))?.staticDepth?.dispose()
+    }
+
+    /** Forces every cached cascade to be re-rendered. */
+    fun invalidate() {
+        cache.values.forEach { it.staticDepth.dispose() }
+        cache.clear()
+    }
+
+    private fun collectCasters(root: Object3D, candidates: List<Object3D>, lightView: Matrix4): List<Caster> {
+        val casters = ArrayList<Caster>()
+        val visit: (Object3D) -> Unit = { obj ->
+            if (obj is Mesh && obj.castShadow) {
+                val bounds = obj.geometry.computeBoundingBox()
+                if (!bounds.isEmpty()) {
+                    val lightBounds = bounds.clone().applyMatrix4(obj.matrixWorld).applyMatrix4(lightView)
+                    casters += Caster(obj, lightBounds, obj.isStatic)
+                }
+            }
+        }
+        if (candidates.isEmpty()) root.traverseVisible(visit) else candidates.forEach { it.traverseVisible(visit) }
+        return casters
+    }
+
+    /** Bounding sphere of the cascade corners in light space: centre x, y, z and radius. */
+    private fun boundingSphere(corners: Array<Vector3>, lightView: Matrix4): FloatArray {
+        val center = Vector3()
+        for (corner in corners) center.add(corner)
+        center.multiplyScalar(1f / corners.size)
+        var radius = 0f
+        for (corner in corners) radius = max(radius, corner.distanceTo(center))
+        // Round up so floating-point noise does not change the cascade extent
+        radius = ceil(radius * 16f) / 16f
+        center.applyMatrix4(lightView)
+        return floatArrayOf(center.x, center.y, center.z, radius)
+    }
+
+    private fun fit(sphere: FloatArray, padding: Float, regionSize: Int, casters: List<Caster>): CascadeBounds {
+        val radius = sphere[3] * padding
+        val texel = 2f * radius / regionSize
+        val originX = floor(sphere[0] / texel) * texel
+        val originY = floor(sphere[1] / texel) * texel
+        // Light space looks down -z: depth along the light is -z
+        val receiverNear = -sphere[2] - radius
+        val receiverFar = -sphere[2] + radius
+
+        var near = receiverNear
+        for (caster in casters) {
+            val b = caster.lightBounds
+            if (b.max.x >= originX - radius && b.min.x <= originX + radius &&
+                b.max.y >= originY - radius && b.min.y <= originY + radius &&
+                nearestDepth(caster) <= receiverFar
+            ) {
+                near = min(near, nearestDepth(caster))
+            }
+        }
+
+        // Quantised so casters moving slightly towards the light do not refit the cascade
+        return CascadeBounds(
+            left = originX - radius,
+            right = originX + radius,
+            bottom = originY - radius,
+            top = originY + radius,
+            near = floor(near / radius) * radius - texel,
+            far = ceil(receiverFar / radius) * radius
+        )
+    }
+
+    /** True when the camera slice [sphere] still lies inside [bounds]. */
+    private fun encloses(bounds: CascadeBounds, sphere: FloatArray): Boolean {
+        val radius = sphere[3]
+        return sphere[0] - radius >= bounds.left && sphere[0] + radius <= bounds.right &&
+            sphere[1] - radius >= bounds.bottom && sphere[1] + radius <= bounds.top &&
+            -sphere[2] - radius >= bounds.near && -sphere[2] + radius <= bounds.far
+    }
+
+    private fun cull(casters: List<Caster>, bounds: CascadeBounds, regionSize: Int): List<Caster> {
+        val minExtent = if (lodEnabled) {
+            (bounds.right - bounds.left) / regionSize * 2f.pow(lodBias)
+        } else {
+            0f
+        }
+        return casters.filter { caster ->
+            val b = caster.lightBounds
+            // Anything between the light and the far plane can shadow a receiver
+            b.max.x >= bounds.left && b.min.x <= bounds.right &&
+                b.max.y >= bounds.bottom && b.min.y <= bounds.top &&
+                nearestDepth(caster) <= bounds.far &&
+                max(b.max.x - b.min.x, b.max.y - b.min.y) >= minExtent
+        }
+    }
+
+    private fun nearestDepth(caster: Caster): Float = -caster.lightBounds.max.z
+
+    private fun staticSignature(statics: List<Mesh>): Long {
+        var hash = statics.size.toLong()
+        for (mesh in statics) {
+            hash = hash * 31 + mesh.id
+            hash = hash * 31 + mesh.matrixWorldVersion
+            hash = hash * 31 + mesh.geometry.hashCode()
+        }
+        return hash
+    }
+
+    /** View matrix of a light space with its origin at the world origin, looking along [direction]. */
+    private fun lightViewMatrix(direction: Vector3): Matrix4 {
+        val zAxis = direction.clone().negate()
+        val up = if (abs(zAxis.y) > 0.99f) Vector3(0f, 0f, 1f) else Vector3(0f, 1f, 0f)
+        val xAxis = Vector3().crossVectors(up, zAxis).normalize()
+        val yAxis = Vector3().crossVectors(zAxis, xAxis)
+        return Matrix4().set(
+            xAxis.x, xAxis.y, xAxis.z, 0f,
+            yAxis.x, yAxis.y, yAxis.z, 0f,
+            zAxis.x, zAxis.y, zAxis.z, 0f,
+            0f, 0f, 0f, 1f
+        )
+    }
+
+    private fun cacheKey(lightId: Int, cascade: Int): Long = lightId.toLong() * MAX_CASCADES + cascade
+
+    companion object {
+        const val MAX_CASCADES = 8
+    }
+}
@@ -15,23 +15,31 @@ internal class FrustumCalculator {
 
     /**
      * Calculate cascade splits for CSM
+     *
+     * Practical split scheme: blends logarithmic and uniform splits of [near]..[far] by
+     * [lambda] (1 = fully logarithmic).
      */
-    fun calculateCascadeSplits(camera: Camera, cascadeCount: Int): FloatArray {
+    fun calculateCascadeSplits(
+        camera: Camera,
+        cascadeCount: Int,
+        lambda: Float = 0.5f,
+        near: Float = camera.near,
+        far: Float = camera.far
+    ): FloatArray {
         val splits = FloatArray(cascadeCount + 1)
-        splits[0] = camera.near
-        splits[cascadeCount] = camera.far
+        splits[0] = near
+        splits[cascadeCount] = far
 
-        val range = camera.far - camera.near
-        val ratio = camera.far / camera.near
+        val range = far - near
+        val ratio = far / near
 
         for (i in 1 until cascadeCount) {
             val p = i.toFloat() / cascadeCount
 
-            val logSplit = camera.near * ratio.pow(p)
-            val linearSplit = camera.near + range * p
+            val logSplit = near * ratio.pow(p)
+            val linearSplit = near + range * p
 
-            val lambda = 0.5f
-            splits[i] = linearSplit * lambda + logSplit * (1f - lambda)
+            splits[i] = logSplit * lambda + linearSplit * (1f - lambda)
         }
 
         return splits
@@ -127,39 +135,31 @@ internal class FrustumCalculator {
     }
 
     /**
-     * Calculate frustum for a cascade
+     * World-space corners of the slice of the camera frustum between view depths
+     * [near] and [far]: the near quad followed by the far quad.
      */
-    fun calculateCascadeFrustum(camera: Camera, near: Float, far: Float): LightFrustum {
-        val frustumCorners = arrayOf(
-            Vector3(-1f, -1f, -1f), Vector3(1f, -1f, -1f),
-            Vector3(1f, 1f, -1f), Vector3(-1f, 1f, -1f),
-            Vector3(-1f, -1f, 1f), Vector3(1f, -1f, 1f),
-            Vector3(1f, 1f, 1f), Vector3(-1f, 1f, 1f)
+    fun calculateCascadeCorners(camera: Camera, near: Float, far: Float): Array<Vector3> {
+        val inverseProjection = camera.projectionMatrix.clone().invert()
+        val ndc = arrayOf(
+            -1f to -1f, 1f to -1f, 1f to 1f, -1f to 1f
         )
-
-        val invProjView =
-            camera.projectionMatrix.multiply(camera.matrixWorldInverse.clone().invert())
-        for (i in frustumCorners.indices) {
-            frustumCorners[i] = frustumCorners[i].applyMatrix4(invProjView)
-        }
-
-        var minX = Float.POSITIVE_INFINITY
-        var maxX = Float.NEGATIVE_INFINITY
-        var minY = Float.POSITIVE_INFINITY
-        var maxY = Float.NEGATIVE_INFINITY
-        var minZ = Float.POSITIVE_INFINITY
-        var maxZ = Float.NEGATIVE_INFINITY
-
-        for (corner in frustumCorners) {
-            minX = min(minX, corner.x)
-            maxX = max(maxX, corner.x)
-            minY = min(minY, corner.y)
-            maxY = max(maxY, corner.y)
-            minZ = min(minZ, corner.z)
-            maxZ = max(maxZ, corner.z)
+        val corners = Array(8) { Vector3() }
+
+        for ((i, xy) in ndc.withIndex()) {
+            // Two points on the corner ray; the depth convention of the projection
+            // does not matter as long as both lie in front of the camera
+            val a = Vector3(xy.first, xy.second, 0f).applyMatrix4(inverseProjection)
+            val b = Vector3(xy.first, xy.second, 1f).applyMatrix4(inverseProjection)
+            val depthA = -a.z
+            val depthB = -b.z
+            val span = depthB - depthA
+            for ((j, depth) in floatArrayOf(near, far).withIndex()) {
+                val t = if (span != 0f) (depth - depthA) / span else 0f
+                corners[i + j * 4] = a.clone().lerp(b, t).applyMatrix4(camera.matrixWorld)
+            }
         }
 
-        return LightFrustum(minX, maxX, minY, maxY, minZ, maxZ)
+        return corners
     }
 
     /**
@@ -0,0 +1,121 @@
+package io.materia.lighting.shadow
+
+import io.materia.core.math.Vector4
+import io.materia.material.Rectangle
+import io.materia.material.atlas.MaxRectsPackager
+import io.materia.renderer.Texture
+
+/**
+ * Square tile of a [ShadowAtlas], in texels.
+ */
+data class ShadowAtlasRegion(
+    val x: Int,
+    val y: Int,
+    val size: Int,
+    val atlasSize: Int
+) {
+    /**
+     * Scale and offset mapping a shadow map's [0, 1] UVs into this tile:
+     * `atlasUv = uv * (x, y) + (z, w)`.
+     */
+    val uvScaleOffset: Vector4
+        get() {
+            val scale = size.toFloat() / atlasSize
+            return Vector4(scale, scale, x.toFloat() / atlasSize, y.toFloat() / atlasSize)
+        }
+}
+
+/**
+ * Depth atlas shared by the shadow maps of several lights.
+ *
+ * Each light asks for one square tile per cascade with [allocate]; tiles are packed with
+ * [MaxRectsPackager] and stay in place while the light keeps asking for the same size, so
+ * cached cascades remain valid from frame to frame. When the atlas is full, the request is
+ * retried at half the resolution down to [minRegionSize]. [release] returns a light's
+ * tiles to the free space without moving the others.
+ *
+ * @param size Width and height of the atlas texture in texels.
+ * @param minRegionSize Smallest tile handed out when the atlas is under pressure.
+ */
+class ShadowAtlas(
+    val size: Int = 4096,
+    val minRegionSize: Int = 256
+) {
+    private class Allocation(val requestedSize: Int, val rectangles: List<Rectangle>)
+
+    init {
+        require(size > 0) { "Atlas size must be positive" }
+        require(minRegionSize in 1..size) { "minRegionSize must be within 1..$size" }
+    }
+
+    private val packer = MaxRectsPackager(size, size)
+    private val allocations = HashMap<Int, Allocation>()
+
+    /** Depth texture all tiles live in. */
+    val texture: Texture = ShadowDepthTexture(size, size)
+
+    /**
+     * Returns [count] tiles of [regionSize] texels for [lightId], reusing its previous tiles
+     * when the request is unchanged. Returns null when not even [minRegionSize] tiles fit.
+     */
+    fun allocate(lightId: Int, count: Int, regionSize: Int): List<ShadowAtlasRegion>? {
+        require(count > 0) { "count must be > 0 (was $count)" }
+        require(regionSize > 0) { "regionSize must be > 0 (was $regionSize)" }
+        val existing = allocations[lightId]
+        if (existing != null && existing.requestedSize == regionSize && existing.rectangles.size == count) {
+            return existing.rectangles.map(::toRegion)
+        }
+        release(lightId)
+
+        var tileSize = regionSize.coerceAtMost(size)
+        while (true) {
+            val placed = place(count, tileSize)
+            if (placed != null) {
+                allocations[lightId] = Allocation(regionSize, placed)
+                return placed.map(::toRegion)
+            }
+            if (tileSize / 2 < minRegionSize) return null
+            tileSize /= 2
+        }
+    }
+
+    /** Frees the tiles of [lightId]. */
+    fun release(lightId: Int) {
+        allocations.remove(lightId)?.rectangles?.forEach(packer::freeRectangle)
+    }
+
+    /** Frees every tile. */
+    fun clear() {
+        allocations.clear()
+        packer.reset()
+    }
+
+    /** Lights currently holding tiles. */
+    val lightIds: Set<Int> get() = allocations.keys
+
+    /** Fraction of the atlas covered by tiles. */
+    val occupancy: Float get() = packer.usedArea.toFloat() / (size.toLong() * size).toFloat()
+
+    fun dispose() {
+        clear()
+        texture.dispose()
+    }
+
+    // All tiles of a light or none of them
+    private fun place(count: Int, tileSize: Int): List<Rectangle>? {
+        val placed = ArrayList<Rectangle>(count)
+        for (i in 0 until count) {
+            val rectangle = packer.findBestFit(tileSize, tileSize, allowRotation = false)
+            if (rectangle == null) {
+                placed.forEach(packer::freeRectangle)
+                return null
+            }
+            packer.markRectangleAsUsed(rectangle)
+            placed += rectangle
+        }
+        return placed
+    }
+
+    private fun toRegion(rectangle: Rectangle) =
+        ShadowAtlasRegion(rectangle.x, rectangle.y, rectangle.width, size)
+}
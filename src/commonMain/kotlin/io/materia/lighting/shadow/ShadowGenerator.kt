@@ -3,7 +3,6 @@ package io.materia.lighting.shadow
 import io.materia.camera.Camera
 import io.materia.camera.OrthographicCamera
 import io.materia.camera.PerspectiveCamera
-import io.materia.core.math.Matrix4
 import io.materia.core.math.Vector3
 import io.materia.core.scene.Scene
 import io.materia.lighting.*
@@ -17,11 +16,6 @@ internal class ShadowGenerator(
     private val frustumCalculator: FrustumCalculator
 ) {
 
-    companion object {
-        private var idCounter = 0
-        private fun nextId(): Int = ++idCounter
-    }
-
     private var shadowBias: Float = 0.0005f
 
     fun setShadowBias(bias: Float) {
@@ -101,46 +95,6 @@ internal class ShadowGenerator(
         return ShadowResult.Success(shadowMap)
     }
 
-    /**
-     * Generate cascaded shadow map
-     */
-    suspend fun generateCascadedShadowMap(
-        light: DirectionalLight,
-        scene: Scene,
-        camera: Camera,
-        cascadeCount: Int
-    ): ShadowResult<io.materia.lighting.CascadedShadowMap> {
-        return try {
-            val cascades = frustumCalculator.calculateCascadeSplits(camera, cascadeCount)
-            val shadowMaps = mutableListOf<io.materia.lighting.ShadowCascade>()
-
-            for (i in 0 until cascadeCount - 1) {
-                val cascade = generateCascade(light, scene, camera, cascades[i], cascades[i + 1])
-                shadowMaps.add(cascade)
-            }
-            // Handle last cascade
-            if (cascadeCount > 0 && cascades.size > cascadeCount - 1) {
-                val lastCascade =
-                    generateCascade(light, scene, camera, cascades[cascadeCount - 1], camera.far)
-                shadowMaps.add(lastCascade)
-            }
-
-            val cascadedMap = CascadedShadowMapImpl(
-                cascades = shadowMaps,
-                splitDistances = cascades,
-                texture = createCascadedTexture(shadowMaps),
-                lightSpaceMatrix = Matrix4.identity(),
-                near = camera.near,
-                far = camera.far,
-                bias = shadowBias
-            )
-
-            ShadowResult.Success(cascadedMap)
-        } catch (e: Exception) {
-            ShadowResult.Error(ShadowMapGenerationFailed("Failed to generate cascaded shadow map: ${e.message}"))
-        }
-    }
-
     /**
      * Generate omnidirectional shadow map
      */
@@ -197,43 +151,6 @@ internal class ShadowGenerator(
         }
     }
 
-    /**
-     * Generate a single cascade for CSM
-     */
-    private suspend fun generateCascade(
-        light: DirectionalLight,
-        scene: Scene,
-        camera: Camera,
-        nearPlane: Float,
-        farPlane: Float
-    ): io.materia.lighting.ShadowCascade {
-        val frustum = frustumCalculator.calculateCascadeFrustum(camera, nearPlane, farPlane)
-
-        val lightCamera = OrthographicCamera(
-            left = frustum.left,
-            right = frustum.right,
-            top = frustum.top,
-            bottom = frustum.bottom,
-            near = frustum.near,
-            far = frustum.far
-        )
-
-        val lightPos = light.position
-        lightCamera.position.copy(lightPos)
-        lightCamera.lookAt(lightPos + light.direction)
-        lightCamera.updateMatrixWorld()
-
-        val shadowMapSize = calculateCascadeShadowMapSize(nearPlane, farPlane)
-        val texture = createShadowTexture(shadowMapSize, shadowMapSize)
-        renderDepthToTexture(scene, lightCamera, texture)
-
-        return ShadowCascadeImpl(
-            texture = texture,
-            projectionViewMatrix = lightCamera.projectionMatrix.multiply(lightCamera.matrixWorldInverse),
-            splitDistance = farPlane
-        )
-    }
-
     private fun calculateShadowMapSize(light: Light, scene: Scene): Int {
         val baseSize = 1024
         val qualityMultiplier = when (light.shadowQuality) {
@@ -246,41 +163,8 @@ internal class ShadowGenerator(
         return (baseSize * qualityMultiplier).toInt().coerceIn(256, 4096)
     }
 
-    private fun calculateCascadeShadowMapSize(near: Float, far: Float): Int {
-        val cascadeSize = far - near
-        return when {
-            cascadeSize < 10f -> 2048
-            cascadeSize < 50f -> 1024
-            cascadeSize < 200f -> 512
-            else -> 256
-        }
-    }
-
-    private fun createShadowTexture(width: Int, height: Int): Texture {
-        return object : Texture {
-            override val id: Int = nextId()
-            override var needsUpdate: Boolean = true
-            override val width: Int = width
-            override val height: Int = height
-
-            override fun dispose() {
-                // Shadow texture disposal
-            }
-        }
-    }
-
-    private fun createCascadedTexture(cascades: List<ShadowCascade>): Texture {
-        return object : Texture {
-            override val id: Int = nextId()
-            override var needsUpdate: Boolean = true
-            override val width: Int = 1024
-            override val height: Int = 1024
-
-            override fun dispose() {
-                // Cascaded shadow texture disposal
-            }
-        }
-    }
+    private fun createShadowTexture(width: Int, height: Int): Texture =
+        ShadowDepthTexture(width, height)
 
     private suspend fun renderDepthToTexture(scene: Scene, camera: Camera, texture: Texture) {
         // Platform-specific depth rendering implementation
@@ -2,6 +2,7 @@ package io.materia.lighting.shadow
 
 import io.materia.core.math.Matrix4
 import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
 import io.materia.lighting.*
 import io.materia.renderer.Texture
 import io.materia.renderer.CubeTexture
@@ -43,11 +44,18 @@ internal data class ShadowMapImpl(
 
 /**
  * Shadow cascade implementation
+ *
+ * @property region Tile of the shadow atlas the cascade was rendered into.
+ * @property casterCount Casters that survived culling against the cascade.
+ * @property reusedStaticDepth True when the static casters' depth came from the cache.
  */
 internal data class ShadowCascadeImpl(
     override val texture: Texture,
     override val projectionViewMatrix: Matrix4,
-    override val splitDistance: Float
+    override val splitDistance: Float,
+    val region: ShadowAtlasRegion? = null,
+    val casterCount: Int = 0,
+    val reusedStaticDepth: Boolean = false
 ) : ShadowCascade
 
 /**
@@ -77,6 +85,50 @@ internal data class CascadedShadowMapImpl(
     }
 }
 
+/**
+ * Renders caster depth for the shadow passes.
+ *
+ * Meant to be implemented by backends, but neither the Vulkan nor the WebGPU renderer
+ * provides one yet, and no shader samples the atlas. Until then, shadow maps are laid
+ * out and culled but no depth is written.
+ */
+interface ShadowDepthPass {
+    /**
+     * Renders the depth of [casters] seen through [viewProjection] into [region] of
+     * [target], clearing the region first when [clear] is set.
+     */
+    fun renderDepth(
+        target: Texture,
+        region: ShadowAtlasRegion,
+        viewProjection: Matrix4,
+        casters: List<Mesh>,
+        clear: Boolean
+    )
+
+    /** Copies all of [source] into [region] of [target]. */
+    fun copyDepth(source: Texture, target: Texture, region: ShadowAtlasRegion)
+}
+
+/**
+ * Depth render target handed to [ShadowDepthPass]
+ */
+internal class ShadowDepthTexture(
+    override val width: Int,
+    override val height: Int
+) : Texture {
+    override val id: Int = nextId()
+    override var needsUpdate: Boolean = true
+
+    override fun dispose() {
+        // GPU storage is owned by the depth pass
+    }
+
+    companion object {
+        private var idCounter = 0
+        private fun nextId(): Int = ++idCounter
+    }
+}
+
 /**
  * Cube shadow map implementation
  */
@@ -0,0 +1,133 @@
+package io.materia.loader
+
+import io.materia.renderer.RendererCapabilities
+import io.materia.texture.CompressedTextureFormat
+import io.materia.texture.CompressedTextureSupport
+import io.materia.renderer.CompressedTextureFormat as CapabilityFormat
+
+/**
+ * Basis Universal payload kinds stored in KTX2 files
+ */
+enum class BasisPayload {
+    /** BasisLZ-supercompressed ETC1S: small files, transcodes best to ETC1/ETC2. */
+    ETC1S,
+
+    /** UASTC: higher quality, transcodes best to ASTC 4x4 and BC7. */
+    UASTC
+}
+
+/**
+ * GPU formats a Basis payload can be transcoded to.
+ *
+ * @property blockWidth Block width in texels (1 for uncompressed RGBA32).
+ * @property blockHeight Block height in texels.
+ * @property blockBytes Bytes per block (or per texel for RGBA32).
+ * @property textureFormat The matching [CompressedTextureFormat], or null for RGBA32.
+ * @property capability The matching renderer capability, or null for RGBA32.
+ */
+enum class BasisTargetFormat(
+    val blockWidth: Int,
+    val blockHeight: Int,
+    val blockBytes: Int,
+    val textureFormat: CompressedTextureFormat?,
+    val capability: CapabilityFormat?
+) {
+    ASTC_4x4(4, 4, 16, CompressedTextureFormat.ASTC_4x4, CapabilityFormat.ASTC_4x4),
+    BC7(4, 4, 16, CompressedTextureFormat.BC7_RGBA, CapabilityFormat.BC7),
+    BC1(4, 4, 8, CompressedTextureFormat.BC1_RGB, CapabilityFormat.DXT1),
+    BC3(4, 4, 16, CompressedTextureFormat.BC3_RGBA, CapabilityFormat.DXT5),
+    BC4(4, 4, 8, CompressedTextureFormat.BC4_R, CapabilityFormat.BC4),
+    BC5(4, 4, 16, CompressedTextureFormat.BC5_RG, CapabilityFormat.BC5),
+    ETC1(4, 4, 8, CompressedTextureFormat.ETC1_RGB, CapabilityFormat.ETC1),
+    ETC2_RGBA(4, 4, 16, CompressedTextureFormat.ETC2_RGBA, CapabilityFormat.ETC2_RGBA8),
+    RGBA32(1, 1, 4, null, null);
+
+    val isCompressed: Boolean get() = this != RGBA32
+
+    /** Bytes of one mip level of [width] x [height] texels. */
+    fun levelSize(width: Int, height: Int): Int =
+        ((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight) * blockBytes
+
+    companion object {
+        /**
+         * Picks the transcode target for a payload, preferring formats the payload maps to
+         * with the least loss: ASTC 4x4 then BC7 for UASTC, ETC1/ETC2 then BC7 for ETC1S.
+         * One- and two-channel images (e.g. roughness or normal maps) go to BC4/BC5 when
+         * available. Falls back to uncompressed RGBA32.
+         *
+         * @param supported Whether the device can sample a format.
+         */
+        fun select(
+            payload: BasisPayload,
+            hasAlpha: Boolean,
+            channels: Int,
+            supported: (BasisTargetFormat) -> Boolean
+        ): BasisTargetFormat {
+            val candidates = when {
+                channels == 1 -> listOf(BC4)
+                channels == 2 -> listOf(BC5)
+                else -> emptyList()
+            } + when (payload) {
+                BasisPayload.UASTC -> if (hasAlpha) {
+                    listOf(ASTC_4x4, BC7, ETC2_RGBA, BC3)
+                } else {
+                    listOf(ASTC_4x4, BC7, ETC1, BC1)
+                }
+
+                BasisPayload.ETC1S -> if (hasAlpha) {
+                    listOf(ETC2_RGBA, BC7, BC3, ASTC_4x4)
+                } else {
+                    listOf(ETC1, BC7, BC1, ASTC_4x4)
+                }
+            }
+            return candidates.firstOrNull(supported) ?: RGBA32
+        }
+
+        /** Support test backed by a renderer's reported [RendererCapabilities]. */
+        fun supportedBy(capabilities: RendererCapabilities): (BasisTargetFormat) -> Boolean = { target ->
+            val capability = target.capability
+            when {
+                capability == null -> false
+                // ETC1 data is valid ETC2 RGB, so ETC2 support covers it
+                target == ETC1 -> capabilities.supportsCompressedFormat(CapabilityFormat.ETC1) ||
+                    capabilities.supportsCompressedFormat(CapabilityFormat.ETC2_RGB)
+
+                else -> capabilities.supportsCompressedFormat(capability)
+            }
+        }
+
+        /** Support test backed by the platform's [CompressedTextureSupport] detection. */
+        fun supportedByPlatform(): (BasisTargetFormat) -> Boolean = { target ->
+            val format = target.textureFormat
+            when {
+                format == null -> false
+                target == ETC1 -> CompressedTextureSupport.isFormatSupported(format) ||
+                    CompressedTextureSupport.isFormatSupported(CompressedTextureFormat.ETC2_RGB)
+
+                else -> CompressedTextureSupport.isFormatSupported(format)
+            }
+        }
+    }
+}
+
+/**
+ * Transcodes Basis Universal payloads in KTX2 files. Platform implementations wrap the
+ * reference transcoder; a custom implementation can be passed to [KTX2Loader] where the
+ * platform has none.
+ */
+interface BasisTranscoder {
+    /**
+     * Transcode mip [level] of a KTX2 file to [target]. The whole file is passed because
+     * ETC1S levels share the BasisLZ global codebooks.
+     *
+     * @return Level data laid out as [BasisTargetFormat.levelSize] bytes.
+     */
+    suspend fun transcode(ktx2: ByteArray, level: Int, target: BasisTargetFormat): ByteArray
+
+    companion object {
+        /** The platform transcoder, or null when the platform ships none (all but JS today). */
+        fun default(): BasisTranscoder? = createDefaultBasisTranscoder()
+    }
+}
+
+internal expect fun createDefaultBasisTranscoder(): BasisTranscoder?
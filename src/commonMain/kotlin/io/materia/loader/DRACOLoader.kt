@@ -5,25 +5,31 @@ import io.materia.core.scene.Scene
 import io.materia.geometry.BufferAttribute
 import io.materia.geometry.BufferGeometry
 import io.materia.material.MeshStandardMaterial
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.withContext
 import kotlinx.serialization.SerialName
 import kotlinx.serialization.Serializable
 import kotlinx.serialization.json.Json
 
 /**
- * Loader for the simplified Draco JSON interchange format used by Materia.
- * Files are expected to contain a JSON object with position, index, and optional
- * normal/uv arrays (all stored as base64 or raw numeric lists). This keeps the
- * loader dependency-free while still providing a compact mesh container that can
- * be generated via the provided tooling.
+ * Loader for Draco `.drc` bitstreams and the simplified Draco JSON interchange format
+ * used by Materia.
+ *
+ * Bitstreams (files starting with `DRACO`) are decoded by [decoder], which defaults to
+ * the platform decoder. JSON files are expected to contain a JSON object with position,
+ * index, and optional normal/uv arrays (all stored as base64 or raw numeric lists); that
+ * path stays dependency-free and works on every platform.
  */
 class DRACOLoader(
     private val resolver: AssetResolver = AssetResolver.default(),
-    private val json: Json = Json { ignoreUnknownKeys = true }
+    private val json: Json = Json { ignoreUnknownKeys = true },
+    private val decoder: DracoDecoder? = DracoDecoder.default()
 ) : AssetLoader<ModelAsset> {
 
     override suspend fun load(path: String): ModelAsset {
         val basePath = path.substringBeforeLast('/', "")
         val bytes = resolver.load(path, if (basePath.isEmpty()) null else "$basePath/")
+        if (isBitstream(bytes)) return loadBitstream(bytes)
         val text = bytes.decodeToString()
         val model = json.decodeFromString(DracoJsonMesh.serializer(), text)
 
@@ -43,6 +49,35 @@ class DRACOLoader(
         return ModelAsset(scene = scene, materials = listOf(material))
     }
 
+    private suspend fun loadBitstream(bytes: ByteArray): ModelAsset {
+        val dracoDecoder = decoder ?: error(
+            "Draco bitstreams need a DracoDecoder; only the JS target ships one, " +
+                "so pass an implementation to DRACOLoader on other platforms"
+        )
+        val decoded = withContext(Dispatchers.Default) { dracoDecoder.decode(bytes) }
+        val position = decoded.attributes["POSITION"] ?: error("Draco mesh missing positions")
+
+        val geometry = BufferGeometry()
+        geometry.setAttribute("position", BufferAttribute(position.array, position.itemSize))
+        decoded.attributes["NORMAL"]?.let { geometry.setAttribute("normal", BufferAttribute(it.array, it.itemSize)) }
+        decoded.attributes["TEXCOORD_0"]?.let { geometry.setAttribute("uv", BufferAttribute(it.array, it.itemSize)) }
+        decoded.attributes["COLOR_0"]?.let { geometry.setAttribute("color", BufferAttribute(it.array, it.itemSize)) }
+        decoded.indices?.let { indices ->
+            geometry.setIndex(BufferAttribute(FloatArray(indices.size) { indices[it].toFloat() }, 1))
+        }
+
+        val material = MeshStandardMaterial(name = "DracoMaterial")
+        val mesh = Mesh(geometry, material).apply { name = "DracoMesh" }
+        return ModelAsset(scene = Scene().apply { add(mesh) }, materials = listOf(material))
+    }
+
+    private fun isBitstream(bytes: ByteArray): Boolean =
+        bytes.size >= MAGIC.size && MAGIC.indices.all { bytes[it] == MAGIC[it] }
+
+    private companion object {
+        val MAGIC = "DRACO".encodeToByteArray()
+    }
+
     @Serializable
     private data class DracoJsonMesh(
         val name: String? = null,
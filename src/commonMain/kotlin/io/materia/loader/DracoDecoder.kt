@@ -0,0 +1,41 @@
+package io.materia.loader
+
+/**
+ * Decodes Draco-compressed geometry (`.drc` files and `KHR_draco_mesh_compression`
+ * primitives). Platform implementations wrap the reference Draco decoder; a custom
+ * implementation can be passed to [GLTFLoader] and [DRACOLoader] where the platform
+ * has none.
+ */
+interface DracoDecoder {
+    /**
+     * Decode a Draco bitstream.
+     *
+     * @param attributeIds Draco attribute unique ids keyed by glTF semantic, as given by
+     * the `KHR_draco_mesh_compression` extension. When empty, the standard POSITION,
+     * NORMAL, TEXCOORD_0 and COLOR_0 attributes are looked up by Draco attribute type.
+     */
+    suspend fun decode(data: ByteArray, attributeIds: Map<String, Int> = emptyMap()): DracoMesh
+
+    companion object {
+        /** The platform decoder, or null when the platform ships none (all but JS today). */
+        fun default(): DracoDecoder? = createDefaultDracoDecoder()
+    }
+}
+
+/**
+ * One decoded attribute: [itemSize] floats per point.
+ */
+class DracoAttribute(val array: FloatArray, val itemSize: Int)
+
+/**
+ * Decoded Draco geometry.
+ *
+ * @property attributes Attributes keyed by glTF semantic (`POSITION`, `NORMAL`, ...).
+ * @property indices Triangle indices, or null for a point cloud.
+ */
+class DracoMesh(
+    val attributes: Map<String, DracoAttribute>,
+    val indices: IntArray?
+)
+
+internal expect fun createDefaultDracoDecoder(): DracoDecoder?
@@ -9,10 +9,21 @@ import io.materia.core.scene.Object3D
 import io.materia.core.scene.Scene
 import io.materia.geometry.BufferAttribute
 import io.materia.geometry.BufferGeometry
+import io.materia.geometry.MeshOptimizationOptions
+import io.materia.geometry.processing.VertexOptimizer
 import io.materia.material.MaterialSide
 import io.materia.material.MeshStandardMaterial
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
+import kotlinx.serialization.SerialName
 import kotlinx.serialization.Serializable
 import kotlinx.serialization.json.Json
 
@@ -53,11 +64,15 @@ data class LoadingProgress(
 /**
  * Loader for glTF 2.0 3D models.
  *
- * Supports both .gltf (JSON + external binaries) and embedded data URIs.
+ * Supports .gltf (JSON + external binaries), binary .glb containers and embedded data URIs.
  * Extracts geometry, materials, textures, and animations from glTF files.
  *
  * Features:
  * - Asynchronous loading with progress callbacks
+ * - GLB binary chunks used in place, without copying them out of the file bytes
+ * - Accessors decoded in parallel, grouped by bufferView
+ * - Meshes handed out as they finish, so uploads can start before the whole asset is ready
+ * - `EXT_meshopt_compression` bufferViews and `KHR_draco_mesh_compression` primitives
  * - Automatic base path resolution for relative URIs
  * - Mesh instancing (shared geometry for repeated nodes)
  * - Multi-primitive mesh support
@@ -73,13 +88,19 @@ data class LoadingProgress(
  *
  * @param resolver Asset resolver for loading external resources.
  * @param json JSON parser configuration.
+ * @param meshOptimization When set, indexed triangle primitives are reordered for the GPU
+ * vertex cache, overdraw and vertex fetch at import time.
+ * @param dracoDecoder Decoder for Draco-compressed primitives; defaults to the platform's.
+ * Without one, Draco primitives load their uncompressed fallback accessors when present.
  */
 class GLTFLoader(
     private val resolver: AssetResolver = AssetResolver.default(),
     private val json: Json = Json {
         ignoreUnknownKeys = true
         isLenient = true
-    }
+    },
+    private val meshOptimization: MeshOptimizationOptions? = null,
+    private val dracoDecoder: DracoDecoder? = DracoDecoder.default()
 ) {
 
     suspend fun load(
@@ -95,47 +116,54 @@ class GLTFLoader(
         }
     }
 
+    /**
+     * Load the asset at [url].
+     *
+     * @param progress Receives byte progress while buffers download.
+     * @param onMeshLoaded Called once per glTF mesh as soon as its accessors are decoded,
+     * before the rest of the asset finishes. Calls never overlap, so the callback may
+     * start GPU uploads without further locking.
+     */
     suspend fun load(
         url: String,
-        progress: ((LoadingProgress) -> Unit)? = null
+        progress: ((LoadingProgress) -> Unit)? = null,
+        onMeshLoaded: (suspend (meshIndex: Int, mesh: Object3D) -> Unit)? = null
     ): GLTFAsset = withContext(Dispatchers.Default) {
         val normalizedUrl = url.replace('\\', '/')
         val basePath = normalizedUrl.substringBeforeLast('/', missingDelimiterValue = "")
             .takeIf { it.isNotEmpty() }
         val documentBytes = loadDocumentBytes(normalizedUrl, basePath)
-        val document = json.decodeFromString<GltfDocument>(documentBytes.decodeToString())
+        val container = GlbContainer.parse(documentBytes)
+        val document = json.decodeFromString<GltfDocument>(
+            container?.json ?: documentBytes.decodeToString()
+        )
 
-        val buffers = loadBuffers(document.buffers, basePath, progress)
+        val buffers = loadBuffers(document.buffers, basePath, container?.binary, progress)
         val reader = AccessorReader(document, buffers)
         val materialFactory = MaterialFactory()
         val meshCache = HashMap<Int, Object3D>()
         val nodeCache = HashMap<Int, Object3D>()
-
-        fun buildMesh(index: Int): Object3D = meshCache.getOrPut(index) {
-            val meshDef = document.meshes.getOrNull(index) ?: return@getOrPut Group()
-            if (meshDef.primitives.size <= 1) {
-                val primitive = meshDef.primitives.firstOrNull()
-                return@getOrPut if (primitive != null) {
-                    buildPrimitive(meshDef.name, primitive, reader, materialFactory)
-                } else {
-                    Group()
-                }
-            }
-
-            Group().apply {
-                meshDef.name?.let { name = it }
-                meshDef.primitives.forEachIndexed { primitiveIndex, primitive ->
-                    val child = buildPrimitive(
-                        meshDef.name?.let { "${it}_$primitiveIndex" },
-                        primitive,
-                        reader,
-                        materialFactory
-                    )
-                    add(child)
+        val meshLock = Mutex()
+
+        coroutineScope {
+            val accessors = reader.decodeAll(
+                document.meshes.flatMap { mesh -> mesh.primitives.flatMap { it.accessorIndices(document) } },
+                this
+            )
+            document.meshes.forEachIndexed { index, meshDef ->
+                launch {
+                    val geometries = meshDef.primitives.map { buildGeometry(it, reader, accessors) }
+                    meshLock.withLock {
+                        val mesh = assembleMesh(meshDef, geometries, materialFactory)
+                        meshCache[index] = mesh
+                        onMeshLoaded?.invoke(index, mesh)
+                    }
                 }
             }
         }
 
+        fun buildMesh(index: Int): Object3D = meshCache[index] ?: Group()
+
         fun buildNode(index: Int): Object3D = nodeCache.getOrPut(index) {
             val nodeDef = document.nodes.getOrNull(index) ?: return@getOrPut Group()
             val base = when (val meshIndex = nodeDef.mesh) {
@@ -181,22 +209,32 @@ class GLTFLoader(
     private suspend fun loadBuffers(
         buffers: List<GltfBuffer>,
         basePath: String?,
+        binaryChunk: BufferData?,
         progress: ((LoadingProgress) -> Unit)?
-    ): List<ByteArray> {
+    ): List<BufferData> {
         if (buffers.isEmpty()) return emptyList()
         val total = buffers.sumOf { it.byteLength.toLong() }.coerceAtLeast(1L)
         var loaded = 0L
 
-        return buffers.map { buffer ->
+        return buffers.mapIndexed { index, buffer ->
             val data = when (val uri = buffer.uri) {
-                null -> ByteArray(buffer.byteLength)
-                else -> {
+                // The first buffer of a GLB without a uri is its BIN chunk
+                null -> if (index == 0 && binaryChunk != null) {
+                    binaryChunk
+                } else if (buffer.extensions?.meshopt?.fallback == true) {
+                    // Only referenced by compressed bufferViews, which decode from elsewhere
+                    BufferData(ByteArray(0))
+                } else {
+                    BufferData(ByteArray(buffer.byteLength))
+                }
+
+                else -> BufferData(
                     if (uri.startsWith("data:", ignoreCase = true)) {
                         DataUriDecoder.decode(uri)
                     } else {
                         resolver.load(uri, basePath?.let { ensureTrailingSlash(it) })
                     }
-                }
+                )
             }
 
             loaded += data.size
@@ -208,45 +246,128 @@ class GLTFLoader(
     private fun ensureTrailingSlash(path: String): String =
         if (path.endsWith("/")) path else "$path/"
 
-    private fun buildPrimitive(
-        name: String?,
+    // Draco primitives carry their attributes in the compressed bufferView instead
+    private fun GltfPrimitive.accessorIndices(document: GltfDocument): List<Int> =
+        if (decodesDraco(document)) emptyList() else uncompressedAccessors()
+
+    private fun GltfPrimitive.uncompressedAccessors(): List<Int> = listOfNotNull(
+        attributes["POSITION"],
+        attributes["NORMAL"],
+        attributes["TEXCOORD_0"],
+        attributes["COLOR_0"],
+        indices
+    )
+
+    /**
+     * Whether the primitive goes through [dracoDecoder]. Without a decoder, a Draco
+     * primitive whose accessors still point at bufferViews (the extension is optional, so
+     * exporters may keep an uncompressed copy) loads that copy instead.
+     */
+    private fun GltfPrimitive.decodesDraco(document: GltfDocument): Boolean {
+        if (extensions?.draco == null) return false
+        if (dracoDecoder != null) return true
+        val hasFallback = attributes["POSITION"] != null &&
+            uncompressedAccessors().all { document.accessors.getOrNull(it)?.bufferView != null }
+        return !hasFallback
+    }
+
+    private suspend fun buildGeometry(
         primitive: GltfPrimitive,
         reader: AccessorReader,
-        materialFactory: MaterialFactory
-    ): Object3D {
-        val geometry = BufferGeometry()
+        accessors: Map<Int, Deferred<FloatArray>>
+    ): BufferGeometry {
+        primitive.extensions?.draco?.takeIf { primitive.decodesDraco(reader.document) }?.let {
+            return buildDracoGeometry(primitive, it, reader)
+        }
+        var geometry = BufferGeometry()
+        suspend fun data(accessorIndex: Int): FloatArray = accessors.getValue(accessorIndex).await()
 
         primitive.attributes["POSITION"]?.let { accessorIndex ->
-            val data = reader.readFloatAttribute(accessorIndex)
-            geometry.setAttribute("position", BufferAttribute(data, 3))
+            geometry.setAttribute("position", BufferAttribute(data(accessorIndex), 3))
         } ?: error("GLTF primitive missing POSITION attribute")
 
         primitive.attributes["NORMAL"]?.let { accessorIndex ->
-            val data = reader.readFloatAttribute(accessorIndex)
-            geometry.setAttribute("normal", BufferAttribute(data, 3))
+            geometry.setAttribute("normal", BufferAttribute(data(accessorIndex), 3))
         }
 
         primitive.attributes["TEXCOORD_0"]?.let { accessorIndex ->
-            val data = reader.readFloatAttribute(accessorIndex)
-            geometry.setAttribute("uv", BufferAttribute(data, 2))
+            geometry.setAttribute("uv", BufferAttribute(data(accessorIndex), 2))
         }
 
         primitive.attributes["COLOR_0"]?.let { accessorIndex ->
             val accessor = reader.document.accessors[accessorIndex]
-            val data = reader.readFloatAttribute(accessorIndex)
             val size = when (accessor.type) {
                 "VEC4" -> 4
                 else -> 3
             }
-            geometry.setAttribute("color", BufferAttribute(data, size))
+            geometry.setAttribute("color", BufferAttribute(data(accessorIndex), size))
         }
 
         primitive.indices?.let { accessorIndex ->
-            val indices = reader.readIndices(accessorIndex)
-            val floatIndices = FloatArray(indices.size) { idx -> indices[idx].toFloat() }
-            geometry.setIndex(BufferAttribute(floatIndices, 1))
+            geometry.setIndex(BufferAttribute(data(accessorIndex), 1))
+            val triangles = (primitive.mode ?: 4) == 4
+            if (triangles) meshOptimization?.let { geometry = VertexOptimizer().optimizeForRendering(geometry, it) }
         }
+        return geometry
+    }
 
+    private suspend fun buildDracoGeometry(
+        primitive: GltfPrimitive,
+        draco: GltfDracoCompression,
+        reader: AccessorReader
+    ): BufferGeometry {
+        val decoder = dracoDecoder
+            ?: error(
+                "KHR_draco_mesh_compression primitive has no uncompressed fallback and no DracoDecoder; " +
+                    "only the JS target ships one, so pass an implementation to GLTFLoader on other platforms"
+            )
+        val view = reader.viewData(draco.bufferView)
+        val mesh = decoder.decode(view.bytes.copyOfRange(view.offset, view.offset + view.size), draco.attributes)
+
+        var geometry = BufferGeometry()
+        DRACO_ATTRIBUTES.forEach { (semantic, name) ->
+            mesh.attributes[semantic]?.let { geometry.setAttribute(name, BufferAttribute(it.array, it.itemSize)) }
+        }
+        require(geometry.getAttribute("position") != null) { "GLTF primitive missing POSITION attribute" }
+        mesh.indices?.let { indices ->
+            geometry.setIndex(BufferAttribute(FloatArray(indices.size) { indices[it].toFloat() }, 1))
+            val triangles = (primitive.mode ?: 4) == 4
+            if (triangles) meshOptimization?.let { geometry = VertexOptimizer().optimizeForRendering(geometry, it) }
+        }
+        return geometry
+    }
+
+    private fun assembleMesh(
+        meshDef: GltfMesh,
+        geometries: List<BufferGeometry>,
+        materialFactory: MaterialFactory
+    ): Object3D {
+        if (geometries.size <= 1) {
+            val geometry = geometries.firstOrNull() ?: return Group()
+            return buildPrimitive(meshDef.name, meshDef.primitives[0], geometry, materialFactory)
+        }
+
+        return Group().apply {
+            meshDef.name?.let { name = it }
+            meshDef.primitives.forEachIndexed { primitiveIndex, primitive ->
+                add(
+                    buildPrimitive(
+                        meshDef.name?.let { "${it}_$primitiveIndex" },
+                        primitive,
+                        geometries[primitiveIndex],
+                        materialFactory
+                    )
+                )
+            }
+        }
+    }
+
+    private fun buildPrimitive(
+        name: String?,
+        primitive: GltfPrimitive,
+        geometry: BufferGeometry,
+        materialFactory: MaterialFactory
+    ): Object3D {
         val material = materialFactory.resolve()
         return Mesh(geometry, material).apply {
             this.name = name ?: "GLTFMesh"
@@ -294,61 +415,201 @@ class GLTFLoader(
         }
     }
 
+    /**
+     * A range of bytes inside a larger array, such as the BIN chunk of a GLB file
+     */
+    private class BufferData(
+        val bytes: ByteArray,
+        val offset: Int = 0,
+        val size: Int = bytes.size
+    )
+
+    /**
+     * Splits a GLB container into its JSON text and BIN chunk without copying the chunk
+     */
+    private class GlbContainer(val json: String, val binary: BufferData?) {
+        companion object {
+            private const val MAGIC = 0x46546C67
+            private const val CHUNK_JSON = 0x4E4F534A
+            private const val CHUNK_BIN = 0x004E4942
+            private const val HEADER_SIZE = 12
+
+            /** Returns null when [bytes] is not a GLB file, so it can be read as JSON. */
+            fun parse(bytes: ByteArray): GlbContainer? {
+                if (bytes.size < HEADER_SIZE || bytes.readInt32(0) != MAGIC) return null
+                val version = bytes.readInt32(4)
+                require(version == 2) { "Unsupported GLB version $version" }
+                val length = bytes.readInt32(8)
+                require(length in HEADER_SIZE..bytes.size) { "GLB length $length exceeds ${bytes.size} bytes" }
+
+                var json: String? = null
+                var binary: BufferData? = null
+                var offset = HEADER_SIZE
+                while (offset + 8 <= length) {
+                    val chunkLength = bytes.readInt32(offset)
+                    val chunkType = bytes.readInt32(offset + 4)
+                    val start = offset + 8
+                    require(chunkLength >= 0 && start + chunkLength <= length) { "GLB chunk at $offset overruns the file" }
+                    when (chunkType) {
+                        CHUNK_JSON -> if (json == null) json = bytes.decodeToString(start, start + chunkLength)
+                        CHUNK_BIN -> if (binary == null) binary = BufferData(bytes, start, chunkLength)
+                    }
+                    offset = start + chunkLength
+                }
+                return GlbContainer(json ?: error("GLB file has no JSON chunk"), binary)
+            }
+        }
+    }
+
     private class AccessorReader(
         val document: GltfDocument,
-        private val buffers: List<ByteArray>
+        private val buffers: List<BufferData>
     ) {
-        fun readFloatAttribute(accessorIndex: Int): FloatArray {
-            val accessor = document.accessors.getOrNull(accessorIndex)
-                ?: error("Accessor $accessorIndex not found")
-            val bufferView = accessor.bufferView?.let { document.bufferViews[it] }
-                ?: error("Accessor $accessorIndex missing bufferView")
-
-            require(accessor.componentType == FLOAT_COMPONENT) {
-                "Only FLOAT attributes are supported in this loader subset"
+        // Each slot is written by the one task that decodes its bufferView
+        private val views = arrayOfNulls<BufferData>(document.bufferViews.size)
+
+        /**
+         * Bytes of a bufferView, decompressing `EXT_meshopt_compression` views on first use
+         */
+        fun viewData(viewIndex: Int): BufferData {
+            views.getOrNull(viewIndex)?.let { return it }
+            val bufferView = document.bufferViews.getOrNull(viewIndex)
+                ?: error("BufferView $viewIndex not found")
+            val meshopt = bufferView.extensions?.meshopt
+            val data = if (meshopt != null) {
+                decodeMeshopt(meshopt)
+            } else {
+                val buffer = buffers[bufferView.buffer]
+                val offset = bufferView.byteOffset ?: 0
+                require(offset + bufferView.byteLength.toLong() <= buffer.size) {
+                    "BufferView $viewIndex overruns buffer ${bufferView.buffer}"
+                }
+                BufferData(buffer.bytes, buffer.offset + offset, bufferView.byteLength)
             }
+            views[viewIndex] = data
+            return data
+        }
 
-            val componentCount = componentCount(accessor.type)
-            val data = FloatArray(accessor.count * componentCount)
-            val buffer = buffers[bufferView.buffer]
-
-            val stride =
-                bufferView.byteStride ?: componentCount * componentByteSize(accessor.componentType)
-            var offset = (bufferView.byteOffset ?: 0) + (accessor.byteOffset ?: 0)
+        private fun decodeMeshopt(compression: GltfMeshoptCompression): BufferData {
+            val buffer = buffers[compression.buffer]
+            val offset = compression.byteOffset ?: 0
+            require(offset + compression.byteLength.toLong() <= buffer.size) {
+                "Compressed bufferView overruns buffer ${compression.buffer}"
+            }
+            val source = buffer.offset + offset
+            val out = ByteArray(compression.count * compression.byteStride)
+            when (compression.mode) {
+                "ATTRIBUTES" -> MeshoptDecoder.decodeVertexBuffer(
+                    out, compression.count, compression.byteStride, buffer.bytes, source, compression.byteLength
+                )
+
+                "TRIANGLES" -> MeshoptDecoder.decodeIndexBuffer(
+                    out, compression.count, compression.byteStride, buffer.bytes, source, compression.byteLength
+                )
+
+                "INDICES" -> MeshoptDecoder.decodeIndexSequence(
+                    out, compression.count, compression.byteStride, buffer.bytes, source, compression.byteLength
+                )
+
+                else -> error("Unsupported meshopt mode ${compression.mode}")
+            }
+            MeshoptDecoder.applyFilter(out, compression.count, compression.byteStride, compression.filter)
+            return BufferData(out)
+        }
 
-            for (i in 0 until accessor.count) {
-                for (component in 0 until componentCount) {
-                    data[i * componentCount + component] =
-                        buffer.readFloat32(offset + component * 4)
+        /**
+         * Starts decoding every accessor in [accessorIndices] on [scope]. Accessors sharing a
+         * bufferView decode in one task, since interleaved attributes share cache lines;
+         * large accessors are additionally split into ranges so a single huge bufferView
+         * still spreads across threads.
+         */
+        fun decodeAll(accessorIndices: List<Int>, scope: CoroutineScope): Map<Int, Deferred<FloatArray>> {
+            val byView = accessorIndices.distinct().groupBy { document.accessors.getOrNull(it)?.bufferView }
+            val result = HashMap<Int, Deferred<FloatArray>>()
+            byView.values.forEach { group ->
+                val outputs = group.associateWith { allocate(it) }
+                val decoded = scope.async {
+                    group.firstNotNullOfOrNull { document.accessors.getOrNull(it)?.bufferView }?.let { viewData(it) }
+                    group.flatMap { accessorIndex ->
+                        val out = outputs.getValue(accessorIndex)
+                        val count = document.accessors[accessorIndex].count
+                        if (count <= DECODE_CHUNK_ELEMENTS) {
+                            decodeRange(accessorIndex, out, 0, count)
+                            emptyList()
+                        } else {
+                            (0 until count step DECODE_CHUNK_ELEMENTS).map { from ->
+                                async {
+                                    decodeRange(accessorIndex, out, from, minOf(count, from + DECODE_CHUNK_ELEMENTS))
+                                }
+                            }
+                        }
+                    }.awaitAll()
+                }
+                outputs.forEach { (accessorIndex, out) ->
+                    result[accessorIndex] = scope.async {
+                        decoded.await()
+                        out
+                    }
                 }
-                offset += stride
             }
+            return result
+        }
 
-            return data
+        private fun allocate(accessorIndex: Int): FloatArray {
+            val accessor = document.accessors.getOrNull(accessorIndex)
+                ?: error("Accessor $accessorIndex not found")
+            return FloatArray(accessor.count * componentCount(accessor.type))
         }
 
-        fun readIndices(accessorIndex: Int): IntArray {
+        /**
+         * Decodes elements [from] until [to] of an accessor into [out] as floats. Integer
+         * components are scaled to [0, 1] or [-1, 1] when the accessor is normalized and
+         * converted as-is otherwise, which is also how index accessors are read.
+         */
+        fun decodeRange(accessorIndex: Int, out: FloatArray, from: Int, to: Int) {
             val accessor = document.accessors.getOrNull(accessorIndex)
-                ?: error("Index accessor $accessorIndex missing")
-            val bufferView = accessor.bufferView?.let { document.bufferViews[it] }
-                ?: error("Index accessor $accessorIndex missing bufferView")
-            val buffer = buffers[bufferView.buffer]
-
-            val stride = bufferView.byteStride ?: componentByteSize(accessor.componentType)
-            val result = IntArray(accessor.count)
-            var offset = (bufferView.byteOffset ?: 0) + (accessor.byteOffset ?: 0)
-
-            for (i in 0 until accessor.count) {
-                result[i] = when (accessor.componentType) {
-                    UNSIGNED_BYTE -> buffer[offset].toInt() and 0xFF
-                    UNSIGNED_SHORT -> buffer.readUInt16(offset)
-                    UNSIGNED_INT -> buffer.readUInt32(offset)
-                    else -> error("Unsupported index component type ${accessor.componentType}")
+                ?: error("Accessor $accessorIndex not found")
+            // Accessors without a bufferView are all zeros
+            val viewIndex = accessor.bufferView ?: return
+            val view = viewData(viewIndex)
+            val bytes = view.bytes
+
+            val componentCount = componentCount(accessor.type)
+            val componentSize = componentByteSize(accessor.componentType)
+            val elementSize = componentCount * componentSize
+            val stride = document.bufferViews[viewIndex].byteStride ?: elementSize
+            val base = view.offset + (accessor.byteOffset ?: 0)
+            if (accessor.count > 0) {
+                val end = (accessor.byteOffset ?: 0) + (accessor.count - 1).toLong() * stride + elementSize
+                require(end <= view.size) { "Accessor $accessorIndex overruns its bufferView" }
+            }
+
+            if (accessor.componentType == FLOAT_COMPONENT && stride == elementSize) {
+                // Tightly packed floats are a straight little-endian copy
+                var offset = base + from * elementSize
+                for (i in from * componentCount until to * componentCount) {
+                    out[i] = Float.fromBits(bytes.readInt32(offset))
+                    offset += 4
                 }
-                offset += stride
+                return
             }
 
-            return result
+            val normalized = accessor.normalized
+            for (element in from until to) {
+                val offset = base + element * stride
+                for (component in 0 until componentCount) {
+                    val at = offset + component * componentSize
+                    out[element * componentCount + component] = when (accessor.componentType) {
+                        FLOAT_COMPONENT -> Float.fromBits(bytes.readInt32(at))
+                        BYTE -> bytes[at].toFloat().let { if (normalized) maxOf(it / 127f, -1f) else it }
+                        UNSIGNED_BYTE -> (bytes[at].toInt() and 0xFF).toFloat().let { if (normalized) it / 255f else it }
+                        SHORT -> bytes.readInt16(at).toFloat().let { if (normalized) maxOf(it / 32767f, -1f) else it }
+                        UNSIGNED_SHORT -> bytes.readUInt16(at).toFloat().let { if (normalized) it / 65535f else it }
+                        UNSIGNED_INT -> (bytes.readInt32(at).toLong() and 0xFFFFFFFFL).toFloat()
+                        else -> error("Unsupported component type ${accessor.componentType}")
+                    }
+                }
+            }
         }
 
         private fun componentCount(type: String): Int = when (type) {
@@ -362,37 +623,45 @@ class GLTFLoader(
         }
 
         companion object {
-            private const val FLOAT_COMPONENT = 5126
+            private const val BYTE = 5120
             private const val UNSIGNED_BYTE = 5121
+            private const val SHORT = 5122
             private const val UNSIGNED_SHORT = 5123
             private const val UNSIGNED_INT = 5125
+            private const val FLOAT_COMPONENT = 5126
+
+            // Elements per parallel decode task for large accessors
+            private const val DECODE_CHUNK_ELEMENTS = 1 shl 16
 
             fun componentByteSize(componentType: Int): Int = when (componentType) {
                 FLOAT_COMPONENT, UNSIGNED_INT -> 4
-                UNSIGNED_SHORT -> 2
-                UNSIGNED_BYTE -> 1
+                SHORT, UNSIGNED_SHORT -> 2
+                BYTE, UNSIGNED_BYTE -> 1
                 else -> error("Unsupported component type $componentType")
             }
 
-            private fun ByteArray.readFloat32(offset: Int): Float {
-                val bits = (this[offset].toInt() and 0xFF) or
-                    ((this[offset + 1].toInt() and 0xFF) shl 8) or
-                    ((this[offset + 2].toInt() and 0xFF) shl 16) or
-                    ((this[offset + 3].toInt() and 0xFF) shl 24)
-                return Float.fromBits(bits)
-            }
+            private fun ByteArray.readInt16(offset: Int): Int = readUInt16(offset).toShort().toInt()
 
             private fun ByteArray.readUInt16(offset: Int): Int {
                 return (this[offset].toInt() and 0xFF) or
                     ((this[offset + 1].toInt() and 0xFF) shl 8)
             }
+        }
+    }
 
-            private fun ByteArray.readUInt32(offset: Int): Int {
-                return (this[offset].toInt() and 0xFF) or
-                    ((this[offset + 1].toInt() and 0xFF) shl 8) or
-                    ((this[offset + 2].toInt() and 0xFF) shl 16) or
-                    ((this[offset + 3].toInt() and 0xFF) shl 24)
-            }
+    private companion object {
+        val DRACO_ATTRIBUTES = listOf(
+            "POSITION" to "position",
+            "NORMAL" to "normal",
+            "TEXCOORD_0" to "uv",
+            "COLOR_0" to "color"
+        )
+
+        fun ByteArray.readInt32(offset: Int): Int {
+            return (this[offset].toInt() and 0xFF) or
+                ((this[offset + 1].toInt() and 0xFF) shl 8) or
+                ((this[offset + 2].toInt() and 0xFF) shl 16) or
+                ((this[offset + 3].toInt() and 0xFF) shl 24)
         }
     }
 
@@ -455,7 +724,18 @@ class GLTFLoader(
     @Serializable
     private data class GltfBuffer(
         val uri: String? = null,
-        val byteLength: Int
+        val byteLength: Int,
+        val extensions: GltfBufferExtensions? = null
+    )
+
+    @Serializable
+    private data class GltfBufferExtensions(
+        @SerialName("EXT_meshopt_compression") val meshopt: GltfMeshoptBuffer? = null
+    )
+
+    @Serializable
+    private data class GltfMeshoptBuffer(
+        val fallback: Boolean = false
     )
 
     @Serializable
@@ -463,7 +743,24 @@ class GLTFLoader(
         val buffer: Int,
         val byteOffset: Int? = null,
         val byteLength: Int,
-        val byteStride: Int? = null
+        val byteStride: Int? = null,
+        val extensions: GltfBufferViewExtensions? = null
+    )
+
+    @Serializable
+    private data class GltfBufferViewExtensions(
+        @SerialName("EXT_meshopt_compression") val meshopt: GltfMeshoptCompression? = null
+    )
+
+    @Serializable
+    private data class GltfMeshoptCompression(
+        val buffer: Int,
+        val byteOffset: Int? = null,
+        val byteLength: Int,
+        val byteStride: Int,
+        val count: Int,
+        val mode: String,
+        val filter: String = "NONE"
     )
 
     @Serializable
@@ -487,7 +784,19 @@ class GLTFLoader(
         val attributes: Map<String, Int> = emptyMap(),
         val indices: Int? = null,
         val material: Int? = null,
-        val mode: Int? = null
+        val mode: Int? = null,
+        val extensions: GltfPrimitiveExtensions? = null
+    )
+
+    @Serializable
+    private data class GltfPrimitiveExtensions(
+        @SerialName("KHR_draco_mesh_compression") val draco: GltfDracoCompression? = null
+    )
+
+    @Serializable
+    private data class GltfDracoCompression(
+        val bufferView: Int,
+        val attributes: Map<String, Int> = emptyMap()
     )
 
     @Serializable
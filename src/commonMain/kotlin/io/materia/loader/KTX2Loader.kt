@@ -1,37 +1,160 @@
 package io.materia.loader
 
+import io.materia.renderer.RendererCapabilities
 import io.materia.renderer.TextureFilter
 import io.materia.renderer.TextureFormat
 import io.materia.renderer.TextureWrap
+import io.materia.texture.CompressedTexture
+import io.materia.texture.CompressedTextureFormat
+import io.materia.texture.Texture
 import io.materia.texture.Texture2D
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+
 /**
- * Minimal KTX2 loader supporting uncompressed RGBA8 textures (vkFormat 37).
- * The loader reads the level index and extracts the base mip level into a
- * `Texture2D` instance. Supercompression and block-compressed formats are not
- * handled.
+ * KTX2 loader for uncompressed RGBA8, GPU block-compressed and Basis Universal textures.
+ *
+ * - `VK_FORMAT_R8G8B8A8_UNORM` (37) loads its base level into a [Texture2D].
+ * - BC1-7, ETC2 and ASTC vkFormats load every mip level as-is into a [CompressedTexture].
+ * - Basis payloads (ETC1S and UASTC) are transcoded by [transcoder] to the best format
+ *   the device samples, picked by [BasisTargetFormat.select] from [capabilities] (or the
+ *   platform's detected support when null). Mip levels transcode in parallel on
+ *   background threads and land in a [CompressedTexture]; if no compressed format is
+ *   available the base level is transcoded to RGBA into a [Texture2D]. Only the JS
+ *   target has a default transcoder; elsewhere one must be passed in.
+ *
+ * Array, cube and 3D textures are not handled.
  */
 class KTX2Loader(
-    private val resolver: AssetResolver = AssetResolver.default()
-) : AssetLoader<Texture2D> {
+    private val resolver: AssetResolver = AssetResolver.default(),
+    private val capabilities: RendererCapabilities? = null,
+    private val transcoder: BasisTranscoder? = BasisTranscoder.default()
+) : AssetLoader<Texture> {
 
-    override suspend fun load(path: String): Texture2D {
+    override suspend fun load(path: String): Texture {
         val basePath = path.substringBeforeLast('/', "")
         val data = resolver.load(path, if (basePath.isEmpty()) null else "$basePath/")
         return decodeKtx2(data)
     }
 
-    private fun decodeKtx2(bytes: ByteArray): Texture2D {
-        require(bytes.size >= 80) { "KTX2 file too small" }
-        val identifier = byteArrayOf(
-            0xAB.toByte(), 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB.toByte(),
-            0x0D, 0x0A, 0x1A, 0x0A
+    private suspend fun decodeKtx2(bytes: ByteArray): Texture {
+        val header = parseHeader(bytes)
+        return when {
+            header.vkFormat == VK_FORMAT_R8G8B8A8_UNORM -> decodeRgba8(bytes, header)
+            header.vkFormat == VK_FORMAT_UNDEFINED && header.payload != null -> transcodeBasis(bytes, header)
+            else -> {
+                val format = blockFormat(header.vkFormat)
+                    ?: throw IllegalArgumentException("Unsupported KTX2 vkFormat ${header.vkFormat}")
+                require(header.supercompression == 0) { "Supercompressed block-compressed KTX2 levels are not supported" }
+                decodeCompressed(bytes, header, format)
+            }
+        }
+    }
+
+    private fun decodeRgba8(bytes: ByteArray, header: Ktx2Header): Texture2D {
+        require(header.typeSize == 1) { "Only typeSize == 1 textures are supported" }
+        require(header.supercompression == 0) { "Only uncompressed KTX2 images are supported" }
+        val level = header.levels[0]
+        if (level.uncompressedSize != 0L) {
+            require(level.uncompressedSize == level.size) { "Only uncompressed KTX2 levels are supported" }
+        }
+        val expectedSize = header.width.toLong() * header.height.toLong() * 4L
+        require(expectedSize > 0) { "KTX2 expected size overflow" }
+        require(level.size >= expectedSize) { "KTX2 payload smaller than expected texture data" }
+        return texture2D(header, bytes.copyOfRange(level.offset, level.offset + level.size.toInt()))
+    }
+
+    private fun decodeCompressed(bytes: ByteArray, header: Ktx2Header, format: CompressedTextureFormat): CompressedTexture {
+        val texture = compressedTexture(header, format)
+        header.levels.forEachIndexed { index, level ->
+            texture.addMipmap(
+                index,
+                mipSize(header.width, index),
+                mipSize(header.height, index),
+                bytes.copyOfRange(level.offset, level.offset + level.size.toInt())
+            )
+        }
+        return texture
+    }
+
+    private suspend fun transcodeBasis(bytes: ByteArray, header: Ktx2Header): Texture {
+        val basis = transcoder ?: error(
+            "Basis Universal KTX2 textures need a BasisTranscoder; only the JS target ships one, " +
+                "so pass an implementation to KTX2Loader on other platforms"
+        )
+        val payload = requireNotNull(header.payload)
+        val supported = capabilities?.let { BasisTargetFormat.supportedBy(it) } ?: BasisTargetFormat.supportedByPlatform()
+        val target = BasisTargetFormat.select(payload, header.hasAlpha, header.channels, supported)
+
+        if (!target.isCompressed) {
+            return texture2D(header, basis.transcode(bytes, 0, target))
+        }
+
+        val levels = coroutineScope {
+            header.levels.indices.map { level ->
+                async(Dispatchers.Default) { basis.transcode(bytes, level, target) }
+            }.awaitAll()
+        }
+        val texture = compressedTexture(header, requireNotNull(target.textureFormat))
+        levels.forEachIndexed { index, data ->
+            val width = mipSize(header.width, index)
+            val height = mipSize(header.height, index)
+            require(data.size >= target.levelSize(width, height)) {
+                "Transcoded level $index is ${data.size} bytes, expected ${target.levelSize(width, height)}"
+            }
+            texture.addMipmap(index, width, height, data)
+        }
+        return texture
+    }
+
+    private fun texture2D(header: Ktx2Header, data: ByteArray): Texture2D {
+        val texture = Texture2D(
+            width = header.width,
+            height = header.height,
+            format = TextureFormat.RGBA8,
+            magFilter = TextureFilter.LINEAR,
+            minFilter = TextureFilter.LINEAR,
+            textureName = "KTX2_${header.width}x${header.height}"
         )
-        require(bytes.copyOfRange(0, 12).contentEquals(identifier)) { "Invalid KTX2 header" }
+        texture.wrapS = TextureWrap.CLAMP_TO_EDGE
+        texture.wrapT = TextureWrap.CLAMP_TO_EDGE
+        texture.setData(data)
+        return texture
+    }
 
-        val vkFormat = readUInt32(bytes, 12)
-        require(vkFormat == 37uL) { "Only VK_FORMAT_R8G8B8A8_UNORM is supported (got $vkFormat)" }
+    private fun compressedTexture(header: Ktx2Header, format: CompressedTextureFormat): CompressedTexture =
+        CompressedTexture(header.width, header.height, format).apply {
+            name = "KTX2_${header.width}x${header.height}"
+            wrapS = TextureWrap.CLAMP_TO_EDGE
+            wrapT = TextureWrap.CLAMP_TO_EDGE
+            magFilter = TextureFilter.LINEAR
+            minFilter = if (header.levels.size > 1) TextureFilter.LINEAR_MIPMAP_LINEAR else TextureFilter.LINEAR
+        }
+
+    private fun mipSize(size: Int, level: Int): Int = maxOf(1, size shr level)
+
+    private class Ktx2Level(val offset: Int, val size: Long, val uncompressedSize: Long)
+
+    private class Ktx2Header(
+        val vkFormat: Int,
+        val typeSize: Int,
+        val width: Int,
+        val height: Int,
+        val supercompression: Int,
+        val levels: List<Ktx2Level>,
+        val payload: BasisPayload?,
+        val hasAlpha: Boolean,
+        val channels: Int
+    )
+
+    private fun parseHeader(bytes: ByteArray): Ktx2Header {
+        require(bytes.size >= 80) { "KTX2 file too small" }
+        require(bytes.copyOfRange(0, 12).contentEquals(IDENTIFIER)) { "Invalid KTX2 header" }
+
+        val vkFormat = readUInt32(bytes, 12).toInt()
         val typeSize = readUInt32(bytes, 16).toInt()
-        require(typeSize == 1) { "Only typeSize == 1 textures are supported" }
         val pixelWidth = readUInt32(bytes, 20).toInt()
         val pixelHeight = readUInt32(bytes, 24).toInt()
         require(pixelWidth > 0 && pixelHeight > 0) { "Invalid KTX2 dimensions" }
@@ -44,7 +167,6 @@ class KTX2Loader(
         require(faceCount == 1) { "Cube KTX2 textures are not supported" }
         val levelCount = readUInt32(bytes, 40).toInt().coerceAtLeast(1)
         val supercompression = readUInt32(bytes, 44).toInt()
-        require(supercompression == 0) { "Only uncompressed KTX2 images are supported" }
 
         val dfdOffset = readUInt32(bytes, 48).toInt()
         val dfdLength = readUInt32(bytes, 52).toInt()
@@ -60,51 +182,98 @@ class KTX2Loader(
 
         val sgdOffset = readUInt64(bytes, 64)
         val sgdLength = readUInt64(bytes, 72)
-        require(sgdLength == 0uL) { "Supercompression global data is not supported" }
-        require(sgdOffset == 0uL) { "Supercompression global data offset must be zero for uncompressed images" }
+        if (supercompression != SUPERCOMPRESSION_BASIS_LZ) {
+            require(sgdLength == 0uL) { "Supercompression global data is not supported" }
+            require(sgdOffset == 0uL) { "Supercompression global data offset must be zero for uncompressed images" }
+        } else {
+            require(sgdOffset + sgdLength <= bytes.size.toULong()) { "BasisLZ global data exceeds file bounds" }
+        }
 
         val levelIndexOffset = 80
-        val levelIndexLength = maxOf(1, levelCount) * 24
-        require(levelIndexOffset + levelIndexLength <= bytes.size) { "KTX2 level index truncated" }
-
-        var levelOffset = 0uL
-        var levelSize = 0uL
-        if (levelCount > 0) {
-            levelOffset = readUInt64(bytes, levelIndexOffset)
-            levelSize = readUInt64(bytes, levelIndexOffset + 8)
-            val uncompressedSize = readUInt64(bytes, levelIndexOffset + 16)
-            if (uncompressedSize != 0uL) {
-                require(uncompressedSize == levelSize) { "Only uncompressed KTX2 levels are supported" }
-            }
+        require(levelIndexOffset + levelCount * 24 <= bytes.size) { "KTX2 level index truncated" }
+        val levels = (0 until levelCount).map { level ->
+            val entry = levelIndexOffset + level * 24
+            val offset = readUInt64(bytes, entry)
+            val size = readUInt64(bytes, entry + 8)
+            require(size > 0uL) { "KTX2 level size missing" }
+            require(offset + size <= bytes.size.toULong()) { "KTX2 level exceeds file bounds" }
+            require(offset <= Int.MAX_VALUE.toULong()) { "KTX2 level offset unsupported" }
+            require(size <= Int.MAX_VALUE.toULong()) { "KTX2 level size unsupported" }
+            Ktx2Level(offset.toInt(), size.toLong(), readUInt64(bytes, entry + 16).toLong())
         }
-        require(levelSize > 0uL) { "KTX2 level size missing" }
-        require(levelOffset + levelSize <= bytes.size.toULong()) { "KTX2 level exceeds file bounds" }
-        require(levelOffset <= Int.MAX_VALUE.toULong()) { "KTX2 level offset unsupported" }
-        require(levelSize <= Int.MAX_VALUE.toULong()) { "KTX2 level size unsupported" }
 
-        val expectedSize = pixelWidth.toLong() * pixelHeight.toLong() * 4L
-        require(expectedSize > 0) { "KTX2 expected size overflow" }
-        if (levelSize.toLong() >= expectedSize) {
-            // OK
-        } else {
-            require(levelSize.toLong() == expectedSize) { "KTX2 payload smaller than expected texture data" }
+        var payload: BasisPayload? = null
+        var hasAlpha = false
+        var channels = 3
+        if (dfdLength >= 4 + DFD_BLOCK_HEADER_SIZE) {
+            val block = dfdOffset + 4
+            val blockSize = readUInt16(bytes, block + 6).coerceAtMost(dfdLength - 4)
+            val samples = ((blockSize - DFD_BLOCK_HEADER_SIZE) / DFD_SAMPLE_SIZE).coerceAtLeast(0)
+            val sampleChannels = (0 until samples).map {
+                bytes[block + DFD_BLOCK_HEADER_SIZE + it * DFD_SAMPLE_SIZE + 3].toInt() and 0x0F
+            }
+            when (bytes[block + 8].toInt() and 0xFF) {
+                KHR_DF_MODEL_ETC1S -> {
+                    payload = BasisPayload.ETC1S
+                    hasAlpha = ETC1S_AAA in sampleChannels
+                    channels = when {
+                        sampleChannels.firstOrNull() == ETC1S_RRR && sampleChannels.getOrNull(1) == ETC1S_GGG -> 2
+                        sampleChannels.firstOrNull() == ETC1S_RRR -> 1
+                        else -> if (hasAlpha) 4 else 3
+                    }
+                }
+
+                KHR_DF_MODEL_UASTC -> {
+                    payload = BasisPayload.UASTC
+                    val channel = sampleChannels.firstOrNull() ?: UASTC_RGB
+                    hasAlpha = channel == UASTC_RGBA || channel == UASTC_RRRG
+                    channels = when (channel) {
+                        UASTC_RRR -> 1
+                        UASTC_RRRG, UASTC_RG -> 2
+                        UASTC_RGBA -> 4
+                        else -> 3
+                    }
+                }
+            }
         }
 
-        val start = levelOffset.toInt()
-        val end = (levelOffset + levelSize).toInt()
-        val imageData = bytes.copyOfRange(start, end)
-        val texture = Texture2D(
-            width = pixelWidth,
-            height = pixelHeight,
-            format = TextureFormat.RGBA8,
-            magFilter = TextureFilter.LINEAR,
-            minFilter = TextureFilter.LINEAR,
-            textureName = "KTX2_${pixelWidth}x$pixelHeight"
+        return Ktx2Header(
+            vkFormat, typeSize, pixelWidth, pixelHeight, supercompression, levels, payload, hasAlpha, channels
         )
-        texture.wrapS = TextureWrap.CLAMP_TO_EDGE
-        texture.wrapT = TextureWrap.CLAMP_TO_EDGE
-        texture.setData(imageData)
-        return texture
+    }
+
+    private fun blockFormat(vkFormat: Int): CompressedTextureFormat? = when (vkFormat) {
+        131, 132 -> CompressedTextureFormat.BC1_RGB
+        133, 134 -> CompressedTextureFormat.BC1_RGBA
+        135, 136 -> CompressedTextureFormat.BC2_RGBA
+        137, 138 -> CompressedTextureFormat.BC3_RGBA
+        139 -> CompressedTextureFormat.BC4_R
+        141 -> CompressedTextureFormat.BC5_RG
+        143 -> CompressedTextureFormat.BC6H_RGB
+        145, 146 -> CompressedTextureFormat.BC7_RGBA
+        147, 148 -> CompressedTextureFormat.ETC2_RGB
+        149, 150 -> CompressedTextureFormat.ETC2_RGB_A1
+        151, 152 -> CompressedTextureFormat.ETC2_RGBA
+        157, 158 -> CompressedTextureFormat.ASTC_4x4
+        159, 160 -> CompressedTextureFormat.ASTC_5x4
+        161, 162 -> CompressedTextureFormat.ASTC_5x5
+        163, 164 -> CompressedTextureFormat.ASTC_6x5
+        165, 166 -> CompressedTextureFormat.ASTC_6x6
+        167, 168 -> CompressedTextureFormat.ASTC_8x5
+        169, 170 -> CompressedTextureFormat.ASTC_8x6
+        171, 172 -> CompressedTextureFormat.ASTC_8x8
+        173, 174 -> CompressedTextureFormat.ASTC_10x5
+        175, 176 -> CompressedTextureFormat.ASTC_10x6
+        177, 178 -> CompressedTextureFormat.ASTC_10x8
+        179, 180 -> CompressedTextureFormat.ASTC_10x10
+        181, 182 -> CompressedTextureFormat.ASTC_12x10
+        183, 184 -> CompressedTextureFormat.ASTC_12x12
+        else -> null
+    }
+
+    private fun readUInt16(bytes: ByteArray, offset: Int): Int {
+        require(offset + 2 <= bytes.size) { "KTX2 readUInt16 out of bounds" }
+        return (bytes[offset].toInt() and 0xFF) or ((bytes[offset + 1].toInt() and 0xFF) shl 8)
     }
 
     private fun readUInt32(bytes: ByteArray, offset: Int): ULong {
@@ -124,4 +293,29 @@ class KTX2Loader(
         }
         return result
     }
+
+    private companion object {
+        val IDENTIFIER = byteArrayOf(
+            0xAB.toByte(), 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB.toByte(),
+            0x0D, 0x0A, 0x1A, 0x0A
+        )
+
+        const val VK_FORMAT_UNDEFINED = 0
+        const val VK_FORMAT_R8G8B8A8_UNORM = 37
+        const val SUPERCOMPRESSION_BASIS_LZ = 1
+
+        // Data format descriptor: colour models and sample channel ids from the KDFS
+        const val DFD_BLOCK_HEADER_SIZE = 24
+        const val DFD_SAMPLE_SIZE = 16
+        const val KHR_DF_MODEL_ETC1S = 163
+        const val KHR_DF_MODEL_UASTC = 166
+        const val ETC1S_RRR = 3
+        const val ETC1S_GGG = 4
+        const val ETC1S_AAA = 15
+        const val UASTC_RGB = 0
+        const val UASTC_RGBA = 3
+        const val UASTC_RRR = 4
+        const val UASTC_RRRG = 5
+        const val UASTC_RG = 6
+    }
 }
@@ -0,0 +1,371 @@
+package io.materia.loader
+
+import kotlin.math.abs
+import kotlin.math.sqrt
+
+/**
+ * Decoder for the meshoptimizer codecs used by `EXT_meshopt_compression`.
+ *
+ * Implements the version 0 vertex codec, the version 0/1 triangle and index sequence
+ * codecs, and the octahedral, quaternion and exponential filters, following the
+ * bitstream described by the extension. All functions write into a caller-owned
+ * output array and read from a slice of a larger source array, so compressed
+ * bufferViews decode straight out of a GLB chunk.
+ */
+object MeshoptDecoder {
+    private const val VERTEX_HEADER = 0xa0
+    private const val INDEX_HEADER = 0xe0
+    private const val SEQUENCE_HEADER = 0xd0
+
+    private const val BYTE_GROUP_SIZE = 16
+    private const val BYTE_GROUP_DECODE_LIMIT = 24
+    private const val TAIL_MIN_SIZE = 32
+    private const val VERTEX_BLOCK_SIZE_BYTES = 8192
+    private const val VERTEX_BLOCK_MAX_SIZE = 256
+
+    /**
+     * Decodes [count] vertices of [stride] bytes from an `ATTRIBUTES` stream into [target].
+     */
+    fun decodeVertexBuffer(
+        target: ByteArray,
+        count: Int,
+        stride: Int,
+        source: ByteArray,
+        offset: Int = 0,
+        length: Int = source.size - offset
+    ) {
+        require(stride in 1..256 && stride % 4 == 0) { "Vertex stride must be a multiple of 4 up to 256 (was $stride)" }
+        require(target.size >= count * stride) { "Target holds ${target.size} bytes, needs ${count * stride}" }
+        require(length >= 1) { "Empty vertex stream" }
+        val header = source[offset].toInt() and 0xFF
+        require(header and 0xF0 == VERTEX_HEADER) { "Not a meshopt vertex stream (header $header)" }
+        require(header and 0x0F == 0) { "Unsupported meshopt vertex codec version ${header and 0x0F}" }
+
+        val end = offset + length
+        val tailSize = maxOf(stride, TAIL_MIN_SIZE)
+        require(end - (offset + 1) >= tailSize) { "Vertex stream truncated" }
+
+        // The first vertex, stored in the tail, is the baseline for the first block
+        val lastVertex = source.copyOfRange(end - stride, end)
+        val blockSize = minOf((VERTEX_BLOCK_SIZE_BYTES / stride) and (BYTE_GROUP_SIZE - 1).inv(), VERTEX_BLOCK_MAX_SIZE)
+        val deltas = ByteArray(VERTEX_BLOCK_MAX_SIZE)
+
+        var data = offset + 1
+        var vertex = 0
+        while (vertex < count) {
+            val blockCount = minOf(blockSize, count - vertex)
+            val alignedCount = (blockCount + BYTE_GROUP_SIZE - 1) and (BYTE_GROUP_SIZE - 1).inv()
+            for (k in 0 until stride) {
+                data = decodeBytes(source, data, end, deltas, alignedCount)
+                var previous = lastVertex[k].toInt()
+                var out = vertex * stride + k
+                for (i in 0 until blockCount) {
+                    val encoded = deltas[i].toInt() and 0xFF
+                    val value = ((-(encoded and 1)) xor (encoded ushr 1)) + previous
+                    target[out] = value.toByte()
+                    previous = value
+                    out += stride
+                }
+            }
+            target.copyInto(lastVertex, 0, (vertex + blockCount - 1) * stride, (vertex + blockCount) * stride)
+            vertex += blockCount
+        }
+        require(end - data == tailSize) { "Vertex stream has ${end - data - tailSize} trailing bytes" }
+    }
+
+    private fun decodeBytes(source: ByteArray, start: Int, end: Int, out: ByteArray, count: Int): Int {
+        val headerSize = (count / BYTE_GROUP_SIZE + 3) / 4
+        require(end - start >= headerSize) { "Vertex stream truncated" }
+        var data = start + headerSize
+        var i = 0
+        while (i < count) {
+            require(end - data >= BYTE_GROUP_DECODE_LIMIT) { "Vertex stream truncated" }
+            val group = i / BYTE_GROUP_SIZE
+            val bitsLog2 = ((source[start + group / 4].toInt() and 0xFF) ushr ((group % 4) * 2)) and 3
+            data = decodeBytesGroup(source, data, out, i, bitsLog2)
+            i += BYTE_GROUP_SIZE
+        }
+        return data
+    }
+
+    // One group of 16 bytes at 0, 2, 4 or 8 bits each; all-ones values escape to a full byte
+    private fun decodeBytesGroup(source: ByteArray, start: Int, out: ByteArray, outOffset: Int, bitsLog2: Int): Int {
+        when (bitsLog2) {
+            0 -> {
+                out.fill(0, outOffset, outOffset + BYTE_GROUP_SIZE)
+                return start
+            }
+
+            3 -> {
+                source.copyInto(out, outOffset, start, start + BYTE_GROUP_SIZE)
+                return start + BYTE_GROUP_SIZE
+            }
+        }
+        val bits = 1 shl bitsLog2
+        val escape = (1 shl bits) - 1
+        val perByte = 8 / bits
+        var escaped = start + BYTE_GROUP_SIZE / perByte
+        for (i in 0 until BYTE_GROUP_SIZE) {
+            val packed = source[start + i / perByte].toInt() and 0xFF
+            val value = (packed ushr (8 - bits * (i % perByte + 1))) and escape
+            if (value == escape) {
+                out[outOffset + i] = source[escaped++]
+            } else {
+                out[outOffset + i] = value.toByte()
+            }
+        }
+        return escaped
+    }
+
+    /**
+     * Decodes a `TRIANGLES` stream of [count] indices into [target], [indexSize] (2 or 4)
+     * little-endian bytes each.
+     */
+    fun decodeIndexBuffer(
+        target: ByteArray,
+        count: Int,
+        indexSize: Int,
+        source: ByteArray,
+        offset: Int = 0,
+        length: Int = source.size - offset
+    ) {
+        require(count % 3 == 0) { "Triangle index count must be a multiple of 3 (was $count)" }
+        require(indexSize == 2 || indexSize == 4) { "Index size must be 2 or 4 (was $indexSize)" }
+        require(target.size >= count * indexSize) { "Target holds ${target.size} bytes, needs ${count * indexSize}" }
+        require(length >= 1 + count / 3 + 16) { "Index stream truncated" }
+        val header = source[offset].toInt() and 0xFF
+        require(header and 0xF0 == INDEX_HEADER) { "Not a meshopt index stream (header $header)" }
+        val version = header and 0x0F
+        require(version <= 1) { "Unsupported meshopt index codec version $version" }
+
+        val edgeA = IntArray(16) { -1 }
+        val edgeB = IntArray(16) { -1 }
+        val vertices = IntArray(16) { -1 }
+        var edgeOffset = 0
+        var vertexOffset = 0
+        var next = 0
+        var last = 0
+        val fecMax = if (version >= 1) 13 else 15
+
+        var code = offset + 1
+        val reader = VByteReader(source, code + count / 3)
+        val safeEnd = offset + length - 16
+        val codeAux = safeEnd
+
+        var i = 0
+        while (i < count) {
+            require(reader.position <= safeEnd) { "Index stream truncated" }
+            val codeTri = source[code++].toInt() and 0xFF
+            val a: Int
+            val b: Int
+            val c: Int
+            if (codeTri < 0xF0) {
+                val edge = (edgeOffset - 1 - (codeTri ushr 4)) and 15
+                a = edgeA[edge]
+                b = edgeB[edge]
+                val fec = codeTri and 15
+                if (fec < fecMax) {
+                    c = if (fec == 0) next++ else vertices[(vertexOffset - 1 - fec) and 15]
+                    vertices[vertexOffset] = c
+                    if (fec == 0) vertexOffset = (vertexOffset + 1) and 15
+                } else {
+                    // 13 and 14 are -1 and +1 from the last free index in version 1
+                    last = if (fec != 15) last + (fec - (fec xor 3)) else last + reader.readDelta()
+                    c = last
+                    vertices[vertexOffset] = c
+                    vertexOffset = (vertexOffset + 1) and 15
+                }
+                edgeA[edgeOffset] = c; edgeB[edgeOffset] = b; edgeOffset = (edgeOffset + 1) and 15
+                edgeA[edgeOffset] = a; edgeB[edgeOffset] = c; edgeOffset = (edgeOffset + 1) and 15
+            } else {
+                val feb: Int
+                val fec: Int
+                if (codeTri < 0xFE) {
+                    val aux = source[codeAux + (codeTri and 15)].toInt() and 0xFF
+                    feb = aux ushr 4
+                    fec = aux and 15
+                    a = next++
+                    b = if (feb == 0) next++ else vertices[(vertexOffset - feb) and 15]
+                    c = if (fec == 0) next++ else vertices[(vertexOffset - fec) and 15]
+                } else {
+                    val aux = source[reader.position++].toInt() and 0xFF
+                    val fea = if (codeTri == 0xFE) 0 else 15
+                    feb = aux ushr 4
+                    fec = aux and 15
+                    if (aux == 0) next = 0
+                    var va = if (fea == 0) next++ else 0
+                    var vb = if (feb == 0) next++ else vertices[(vertexOffset - feb) and 15]
+                    var vc = if (fec == 0) next++ else vertices[(vertexOffset - fec) and 15]
+                    if (fea == 15) { last += reader.readDelta(); va = last }
+                    if (feb == 15) { last += reader.readDelta(); vb = last }
+                    if (fec == 15) { last += reader.readDelta(); vc = last }
+                    a = va
+                    b = vb
+                    c = vc
+                }
+                vertices[vertexOffset] = a
+                vertexOffset = (vertexOffset + 1) and 15
+                vertices[vertexOffset] = b
+                if (feb == 0 || feb == 15) vertexOffset = (vertexOffset + 1) and 15
+                vertices[vertexOffset] = c
+                if (fec == 0 || fec == 15) vertexOffset = (vertexOffset + 1) and 15
+                edgeA[edgeOffset] = b; edgeB[edgeOffset] = a; edgeOffset = (edgeOffset + 1) and 15
+                edgeA[edgeOffset] = c; edgeB[edgeOffset] = b; edgeOffset = (edgeOffset + 1) and 15
+                edgeA[edgeOffset] = a; edgeB[edgeOffset] = c; edgeOffset = (edgeOffset + 1) and 15
+            }
+            writeIndex(target, i, indexSize, a)
+            writeIndex(target, i + 1, indexSize, b)
+            writeIndex(target, i + 2, indexSize, c)
+            i += 3
+        }
+        require(reader.position == safeEnd) { "Index stream has unread bytes" }
+    }
+
+    /**
+     * Decodes an `INDICES` stream of [count] indices into [target], [indexSize] (2 or 4)
+     * little-endian bytes each.
+     */
+    fun decodeIndexSequence(
+        target: ByteArray,
+        count: Int,
+        indexSize: Int,
+        source: ByteArray,
+        offset: Int = 0,
+        length: Int = source.size - offset
+    ) {
+        require(indexSize == 2 || indexSize == 4) { "Index size must be 2 or 4 (was $indexSize)" }
+        require(target.size >= count * indexSize) { "Target holds ${target.size} bytes, needs ${count * indexSize}" }
+        require(length >= 1 + count + 4) { "Index sequence truncated" }
+        val header = source[offset].toInt() and 0xFF
+        require(header and 0xF0 == SEQUENCE_HEADER) { "Not a meshopt index sequence (header $header)" }
+        require(header and 0x0F <= 1) { "Unsupported meshopt sequence codec version ${header and 0x0F}" }
+
+        val reader = VByteReader(source, offset + 1)
+        val safeEnd = offset + length - 4
+        val last = IntArray(2)
+        for (i in 0 until count) {
+            require(reader.position < safeEnd) { "Index sequence truncated" }
+            val v = reader.read()
+            // The low bit picks one of two baselines, the rest is a zigzag delta
+            val baseline = v and 1
+            val delta = v ushr 1
+            val index = last[baseline] + ((delta ushr 1) xor -(delta and 1))
+            last[baseline] = index
+            writeIndex(target, i, indexSize, index)
+        }
+        require(reader.position == safeEnd) { "Index sequence has unread bytes" }
+    }
+
+    /**
+     * Applies an `EXT_meshopt_compression` [filter] in place to [count] decoded
+     * elements of [stride] bytes. `"NONE"` leaves the data untouched.
+     */
+    fun applyFilter(data: ByteArray, count: Int, stride: Int, filter: String) {
+        when (filter) {
+            "NONE" -> Unit
+            "OCTAHEDRAL" -> {
+                require(stride == 4 || stride == 8) { "Octahedral filter needs a stride of 4 or 8 (was $stride)" }
+                decodeOctahedral(data, count, stride / 4)
+            }
+
+            "QUATERNION" -> {
+                require(stride == 8) { "Quaternion filter needs a stride of 8 (was $stride)" }
+                decodeQuaternion(data, count)
+            }
+
+            "EXPONENTIAL" -> {
+                require(stride % 4 == 0) { "Exponential filter needs a stride multiple of 4 (was $stride)" }
+                decodeExponential(data, count * stride / 4)
+            }
+
+            else -> error("Unsupported meshopt filter $filter")
+        }
+    }
+
+    private fun decodeOctahedral(data: ByteArray, count: Int, componentSize: Int) {
+        val max = ((1 shl (componentSize * 8 - 1)) - 1).toFloat()
+        for (i in 0 until count) {
+            val base = i * componentSize * 4
+            var x = readSigned(data, base, componentSize).toFloat()
+            var y = readSigned(data, base + componentSize, componentSize).toFloat()
+            val z = readSigned(data, base + componentSize * 2, componentSize).toFloat() - abs(x) - abs(y)
+            // Fold the lower hemisphere back out
+            val t = if (z >= 0f) 0f else z
+            x += if (x >= 0f) t else -t
+            y += if (y >= 0f) t else -t
+            val scale = max / sqrt(x * x + y * y + z * z)
+            writeSigned(data, base, componentSize, round(x * scale))
+            writeSigned(data, base + componentSize, componentSize, round(y * scale))
+            writeSigned(data, base + componentSize * 2, componentSize, round(z * scale))
+        }
+    }
+
+    private fun decodeQuaternion(data: ByteArray, count: Int) {
+        val scale = 1f / sqrt(2f)
+        for (i in 0 until count) {
+            val base = i * 8
+            val packed = readSigned(data, base + 6, 2)
+            // The high bits of the fourth component carry the scale, the low two the dropped axis
+            val componentScale = scale / (packed or 3).toFloat()
+            val x = readSigned(data, base, 2) * componentScale
+            val y = readSigned(data, base + 2, 2) * componentScale
+            val z = readSigned(data, base + 4, 2) * componentScale
+            val ww = 1f - x * x - y * y - z * z
+            val w = sqrt(if (ww >= 0f) ww else 0f)
+            val dropped = packed and 3
+            writeSigned(data, base + ((dropped + 1) and 3) * 2, 2, round(x * 32767f))
+            writeSigned(data, base + ((dropped + 2) and 3) * 2, 2, round(y * 32767f))
+            writeSigned(data, base + ((dropped + 3) and 3) * 2, 2, round(z * 32767f))
+            writeSigned(data, base + (dropped and 3) * 2, 2, round(w * 32767f))
+        }
+    }
+
+    private fun decodeExponential(data: ByteArray, count: Int) {
+        for (i in 0 until count) {
+            val v = readSigned(data, i * 4, 4)
+            val mantissa = (v shl 8) shr 8
+            val exponent = v shr 24
+            val value = Float.fromBits((exponent + 127) shl 23) * mantissa.toFloat()
+            writeSigned(data, i * 4, 4, value.toRawBits())
+        }
+    }
+
+    private fun round(value: Float): Int = (value + if (value >= 0f) 0.5f else -0.5f).toInt()
+
+    private fun readSigned(data: ByteArray, offset: Int, size: Int): Int = when (size) {
+        1 -> data[offset].toInt()
+        2 -> ((data[offset].toInt() and 0xFF) or (data[offset + 1].toInt() shl 8)).toShort().toInt()
+        else -> (data[offset].toInt() and 0xFF) or
+            ((data[offset + 1].toInt() and 0xFF) shl 8) or
+            ((data[offset + 2].toInt() and 0xFF) shl 16) or
+            ((data[offset + 3].toInt() and 0xFF) shl 24)
+    }
+
+    private fun writeSigned(data: ByteArray, offset: Int, size: Int, value: Int) {
+        for (b in 0 until size) data[offset + b] = (value ushr (b * 8)).toByte()
+    }
+
+    private fun writeIndex(target: ByteArray, index: Int, size: Int, value: Int) =
+        writeSigned(target, index * size, size, value)
+
+    private class VByteReader(private val source: ByteArray, var position: Int) {
+        fun read(): Int {
+            val lead = source[position++].toInt() and 0xFF
+            if (lead < 128) return lead
+            var result = lead and 127
+            var shift = 7
+            for (i in 0 until 4) {
+                val group = source[position++].toInt() and 0xFF
+                result = result or ((group and 127) shl shift)
+                shift += 7
+                if (group < 128) break
+            }
+            return result
+        }
+
+        fun readDelta(): Int {
+            val v = read()
+            return (v ushr 1) xor -(v and 1)
+        }
+    }
+}
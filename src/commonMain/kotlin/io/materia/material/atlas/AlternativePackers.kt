@@ -1,56 +1,209 @@
 /**
  * Alternative Rectangle Packing Algorithms
- * Skyline, Guillotine, and Bottom-Left packing strategies
+ * Skyline, Guillotine, and Shelf packing strategies
  */
 package io.materia.material.atlas
 
+import io.materia.material.PackingStrategy
 import io.materia.material.Rectangle
 
+/**
+ * Disjoint free rectangles managed with guillotine cuts. Backs [GuillotinePackager] and
+ * holds the space released by [SkylinePackager] and [ShelfPackager], which cannot hand
+ * area back to their skyline or shelves.
+ */
+internal class GuillotineFreeList {
+    val rectangles = mutableListOf<Rectangle>()
+
+    /** Best-short-side fit among the free rectangles. */
+    fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? {
+        var best: Rectangle? = null
+        var bestScore = Int.MAX_VALUE
+        for (rect in rectangles) {
+            if (rect.width >= width && rect.height >= height) {
+                val score = minOf(rect.width - width, rect.height - height)
+                if (score < bestScore) {
+                    bestScore = score
+                    best = Rectangle(rect.x, rect.y, width, height)
+                }
+            }
+            if (allowRotation && width != height && rect.width >= height && rect.height >= width) {
+                val score = minOf(rect.width - height, rect.height - width)
+                if (score < bestScore) {
+                    bestScore = score
+                    best = Rectangle(rect.x, rect.y, height, width)
+                }
+            }
+        }
+        return best
+    }
+
+    /**
+     * Carve [used] out of the free rectangle containing it, splitting the remainder along
+     * the shorter leftover axis. Returns false when no single free rectangle contains it.
+     */
+    fun take(used: Rectangle): Boolean {
+        val index = rectangles.indexOfFirst { contains(it, used) }
+        if (index < 0) return false
+        val host = rectangles.removeAt(index)
+
+        val leftoverWidth = host.right - used.right
+        val leftoverHeight = host.bottom - used.bottom
+        // Cuts through the corner placement; regions above and left of it only exist when
+        // a caller placed the rectangle away from the host's origin
+        if (used.y > host.y) rectangles.add(Rectangle(host.x, host.y, host.width, used.y - host.y))
+        if (used.x > host.x) rectangles.add(Rectangle(host.x, used.y, used.x - host.x, host.bottom - used.y))
+        val splitHorizontal = leftoverWidth < leftoverHeight
+        if (splitHorizontal) {
+            if (leftoverWidth > 0) rectangles.add(Rectangle(used.right, used.y, leftoverWidth, used.height))
+            if (leftoverHeight > 0) rectangles.add(Rectangle(used.x, used.bottom, host.right - used.x, leftoverHeight))
+        } else {
+            if (leftoverWidth > 0) rectangles.add(Rectangle(used.right, used.y, leftoverWidth, host.bottom - used.y))
+            if (leftoverHeight > 0) rectangles.add(Rectangle(used.x, used.bottom, used.width, leftoverHeight))
+        }
+        return true
+    }
+
+    /** Return [rect] to the free set, merging it with neighbours that share a full edge. */
+    fun add(rect: Rectangle) {
+        var current = rect
+        var merged = true
+        while (merged) {
+            merged = false
+            val iterator = rectangles.iterator()
+            while (iterator.hasNext()) {
+                val other = iterator.next()
+                val union = mergeAdjacent(current, other) ?: continue
+                iterator.remove()
+                current = union
+                merged = true
+                break
+            }
+        }
+        rectangles.add(current)
+    }
+
+    private fun mergeAdjacent(a: Rectangle, b: Rectangle): Rectangle? = when {
+        a.y == b.y && a.height == b.height && a.right == b.x -> Rectangle(a.x, a.y, a.width + b.width, a.height)
+        a.y == b.y && a.height == b.height && b.right == a.x -> Rectangle(b.x, a.y, a.width + b.width, a.height)
+        a.x == b.x && a.width == b.width && a.bottom == b.y -> Rectangle(a.x, a.y, a.width, a.height + b.height)
+        a.x == b.x && a.width == b.width && b.bottom == a.y -> Rectangle(a.x, b.y, a.width, a.height + b.height)
+        else -> null
+    }
+
+    private fun contains(container: Rectangle, contained: Rectangle): Boolean =
+        container.x <= contained.x && container.y <= contained.y &&
+            container.right >= contained.right && container.bottom >= contained.bottom
+}
+
 /**
  * Skyline packing algorithm
  * Efficient for sprite sheets and game atlases
+ *
+ * Bottom-left skyline: each rectangle rests on the lowest stretch of the skyline that
+ * fits it. Gaps left underneath a placement and rectangles released by [freeRectangle]
+ * go to a waste list that is searched first.
  */
-class SkylinePackager : RectanglePacker {
+class SkylinePackager(
+    private val atlasWidth: Int = 2048,
+    private val atlasHeight: Int = 2048
+) : RectanglePacker {
     private data class SkylineNode(var x: Int, var y: Int, var width: Int)
 
-    private val skyline = mutableListOf(SkylineNode(0, 0, Int.MAX_VALUE))
+    private val skyline = mutableListOf<SkylineNode>()
+    private val waste = GuillotineFreeList()
+
+    init {
+        require(atlasWidth > 0 && atlasHeight > 0) { "Atlas size must be positive" }
+        reset()
+    }
 
     override fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? {
-        var bestY = Int.MAX_VALUE
-        var bestIndex = -1
-        var bestX = 0
+        waste.findBestFit(width, height, allowRotation)?.let { return it }
 
+        var best: Rectangle? = null
+        var bestTop = Int.MAX_VALUE
+        var bestWidth = Int.MAX_VALUE
         for (i in skyline.indices) {
-            val node = skyline[i]
-            if (node.width >= width) {
-                val y = node.y
-                if (y < bestY) {
-                    bestY = y
-                    bestX = node.x
-                    bestIndex = i
+            for ((w, h) in orientations(width, height, allowRotation)) {
+                val y = fitAt(i, w, h) ?: continue
+                val top = y + h
+                val nodeWidth = skyline[i].width
+                if (top < bestTop || (top == bestTop && nodeWidth < bestWidth)) {
+                    bestTop = top
+                    bestWidth = nodeWidth
+                    best = Rectangle(skyline[i].x, y, w, h)
                 }
             }
         }
-
-        return if (bestIndex != -1) {
-            Rectangle(bestX, bestY, width, height)
-        } else null
+        return best
     }
 
     override fun markRectangleAsUsed(rectangle: Rectangle) {
-        // Update skyline with new rectangle
-        val newNode = SkylineNode(rectangle.x, rectangle.y + rectangle.height, rectangle.width)
-        skyline.add(newNode)
-        skyline.sortBy { it.x }
+        if (waste.take(rectangle)) return
+
+        val start = skyline.indexOfFirst { it.x + it.width > rectangle.x }
+        require(start >= 0) { "Rectangle lies outside the skyline" }
+
+        // Space between the old skyline and the rectangle's base becomes waste
+        var i = start
+        while (i < skyline.size && skyline[i].x < rectangle.right) {
+            val node = skyline[i]
+            val left = maxOf(node.x, rectangle.x)
+            val right = minOf(node.x + node.width, rectangle.right)
+            if (node.y < rectangle.y) waste.add(Rectangle(left, node.y, right - left, rectangle.y - node.y))
+            i++
+        }
+
+        val newNode = SkylineNode(rectangle.x, rectangle.bottom, rectangle.width)
+        val replaced = skyline.subList(start, i)
+        val head = replaced.first()
+        val tail = replaced.last()
+        val pieces = mutableListOf<SkylineNode>()
+        if (head.x < rectangle.x) pieces += SkylineNode(head.x, head.y, rectangle.x - head.x)
+        pieces += newNode
+        if (tail.x + tail.width > rectangle.right) {
+            pieces += SkylineNode(rectangle.right, tail.y, tail.x + tail.width - rectangle.right)
+        }
+        replaced.clear()
+        skyline.addAll(start, pieces)
+        mergeSkyline()
     }
 
     override fun freeRectangle(rectangle: Rectangle) {
-        // Not typically supported in skyline algorithm
+        waste.add(rectangle)
     }
 
     override fun reset() {
         skyline.clear()
-        skyline.add(SkylineNode(0, 0, Int.MAX_VALUE))
+        skyline.add(SkylineNode(0, 0, atlasWidth))
+        waste.rectangles.clear()
+    }
+
+    /** Lowest y where a [width] x [height] rectangle starting at node [index] fits. */
+    private fun fitAt(index: Int, width: Int, height: Int): Int? {
+        val x = skyline[index].x
+        if (x + width > atlasWidth) return null
+        var y = 0
+        var i = index
+        while (i < skyline.size && skyline[i].x < x + width) {
+            y = maxOf(y, skyline[i].y)
+            if (y + height > atlasHeight) return null
+            i++
+        }
+        return y
+    }
+
+    private fun mergeSkyline() {
+        var i = 0
+        while (i < skyline.size - 1) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width
+                skyline.removeAt(i + 1)
+            } else {
+                i++
+            }
+        }
     }
 }
 
@@ -58,113 +211,114 @@ class SkylinePackager : RectanglePacker {
  * Guillotine packing algorithm
  * Fast packing with guillotine cuts
  */
-class GuillotinePackager : RectanglePacker {
-    private val freeRects = mutableListOf<Rectangle>()
-    private var atlasWidth = 0
-    private var atlasHeight = 0
+class GuillotinePackager(
+    private val atlasWidth: Int = 2048,
+    private val atlasHeight: Int = 2048
+) : RectanglePacker {
+    private val freeRects = GuillotineFreeList()
 
     init {
+        require(atlasWidth > 0 && atlasHeight > 0) { "Atlas size must be positive" }
         reset()
     }
 
-    override fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? {
-        var bestRect: Rectangle? = null
-        var bestScore = Int.MAX_VALUE
+    override fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? =
+        freeRects.findBestFit(width, height, allowRotation)
 
-        for (rect in freeRects) {
-            if (rect.width >= width && rect.height >= height) {
-                val leftoverX = rect.width - width
-                val leftoverY = rect.height - height
-                val score = minOf(leftoverX, leftoverY)
+    override fun markRectangleAsUsed(rectangle: Rectangle) {
+        require(freeRects.take(rectangle)) { "Rectangle does not lie in free space" }
+    }
 
-                if (score < bestScore) {
-                    bestScore = score
-                    bestRect = Rectangle(rect.x, rect.y, width, height)
-                }
-            }
-        }
+    override fun freeRectangle(rectangle: Rectangle) {
+        freeRects.add(rectangle)
+    }
 
-        return bestRect
+    override fun reset() {
+        freeRects.rectangles.clear()
+        freeRects.rectangles.add(Rectangle(0, 0, atlasWidth, atlasHeight))
     }
+}
 
-    override fun markRectangleAsUsed(rectangle: Rectangle) {
-        // Split free rectangles using guillotine cuts
-        val toRemove = mutableListOf<Rectangle>()
-        val toAdd = mutableListOf<Rectangle>()
+/**
+ * Shelf packing algorithm
+ * Rows of fixed height filled left to right; cheapest to run, best for similarly sized
+ * sprites and glyphs
+ */
+class ShelfPackager(
+    private val atlasWidth: Int = 2048,
+    private val atlasHeight: Int = 2048
+) : RectanglePacker {
+    private class Shelf(val y: Int, val height: Int, var used: Int)
 
-        for (rect in freeRects) {
-            if (intersects(rect, rectangle)) {
-                toRemove.add(rect)
+    private val shelves = mutableListOf<Shelf>()
+    private val waste = GuillotineFreeList()
 
-                // Horizontal split
-                if (rect.x < rectangle.x) {
-                    toAdd.add(Rectangle(rect.x, rect.y, rectangle.x - rect.x, rect.height))
-                }
-                if (rectangle.x + rectangle.width < rect.x + rect.width) {
-                    toAdd.add(
-                        Rectangle(
-                            rectangle.x + rectangle.width,
-                            rect.y,
-                            rect.x + rect.width - rectangle.x - rectangle.width,
-                            rect.height
-                        )
-                    )
-                }
+    init {
+        require(atlasWidth > 0 && atlasHeight > 0) { "Atlas size must be positive" }
+    }
 
-                // Vertical split
-                if (rect.y < rectangle.y) {
-                    toAdd.add(Rectangle(rect.x, rect.y, rect.width, rectangle.y - rect.y))
-                }
-                if (rectangle.y + rectangle.height < rect.y + rect.height) {
-                    toAdd.add(
-                        Rectangle(
-                            rect.x,
-                            rectangle.y + rectangle.height,
-                            rect.width,
-                            rect.y + rect.height - rectangle.y - rectangle.height
-                        )
-                    )
+    private val nextShelfY: Int get() = shelves.lastOrNull()?.let { it.y + it.height } ?: 0
+
+    override fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? {
+        waste.findBestFit(width, height, allowRotation)?.let { return it }
+
+        // Tightest existing shelf first, then a new shelf at the bottom
+        var best: Rectangle? = null
+        var bestSlack = Int.MAX_VALUE
+        for (shelf in shelves) {
+            for ((w, h) in orientations(width, height, allowRotation)) {
+                if (h <= shelf.height && shelf.used + w <= atlasWidth && shelf.height - h < bestSlack) {
+                    bestSlack = shelf.height - h
+                    best = Rectangle(shelf.used, shelf.y, w, h)
                 }
             }
         }
+        if (best != null) return best
 
-        freeRects.removeAll(toRemove)
-        freeRects.addAll(toAdd)
+        // Open the new shelf in the orientation that keeps it lowest
+        return orientations(width, height, allowRotation)
+            .filter { (w, h) -> w <= atlasWidth && nextShelfY + h <= atlasHeight }
+            .minByOrNull { (_, h) -> h }
+            ?.let { (w, h) -> Rectangle(0, nextShelfY, w, h) }
     }
 
-    override fun freeRectangle(rectangle: Rectangle) {
-        freeRects.add(rectangle)
+    override fun markRectangleAsUsed(rectangle: Rectangle) {
+        if (waste.take(rectangle)) return
+        val shelf = shelves.firstOrNull { it.y == rectangle.y }
+            ?: Shelf(rectangle.y, rectangle.height, 0).also { shelves += it }
+        require(rectangle.x == shelf.used && rectangle.height <= shelf.height) { "Rectangle is not the next slot on its shelf" }
+        // The strip above a short rectangle stays usable
+        if (rectangle.height < shelf.height) {
+            waste.add(Rectangle(rectangle.x, rectangle.bottom, rectangle.width, shelf.height - rectangle.height))
+        }
+        shelf.used = rectangle.right
     }
 
-    override fun reset() {
-        freeRects.clear()
-        freeRects.add(Rectangle(0, 0, 4096, 4096)) // Default atlas size
+    override fun freeRectangle(rectangle: Rectangle) {
+        waste.add(rectangle)
     }
 
-    private fun intersects(a: Rectangle, b: Rectangle): Boolean {
-        return !(a.x >= b.x + b.width || a.x + a.width <= b.x ||
-                a.y >= b.y + b.height || a.y + a.height <= b.y)
+    override fun reset() {
+        shelves.clear()
+        waste.rectangles.clear()
     }
 }
 
-/**
- * Bottom-Left packing algorithm (minimal implementation)
- */
-class BottomLeftPackager : RectanglePacker {
-    override fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle? = null
-    override fun markRectangleAsUsed(rectangle: Rectangle) {}
-    override fun freeRectangle(rectangle: Rectangle) {}
-    override fun reset() {}
-}
+private fun orientations(width: Int, height: Int, allowRotation: Boolean): List<Pair<Int, Int>> =
+    if (allowRotation && width != height) listOf(width to height, height to width) else listOf(width to height)
 
 /**
  * Create packer based on strategy
  */
-fun createPackerByStrategy(strategy: io.materia.material.PackingStrategy): RectanglePacker {
+fun createPackerByStrategy(
+    strategy: PackingStrategy,
+    width: Int = 2048,
+    height: Int = 2048
+): RectanglePacker {
     return when (strategy) {
-        io.materia.material.PackingStrategy.MAX_RECTS -> MaxRectsPackager()
-        io.materia.material.PackingStrategy.SKYLINE -> SkylinePackager()
-        io.materia.material.PackingStrategy.GUILLOTINE -> GuillotinePackager()
-        io.materia.material.PackingStrategy.SHELF -> BottomLeftPackager()
+        PackingStrategy.MAX_RECTS -> MaxRectsPackager(width, height)
+        PackingStrategy.SKYLINE -> SkylinePackager(width, height)
+        PackingStrategy.GUILLOTINE -> GuillotinePackager(width, height)
+        PackingStrategy.SHELF -> ShelfPackager(width, height)
     }
 }
@@ -7,9 +7,17 @@ package io.materia.material.atlas
 import io.materia.material.Rectangle
 
 /**
- * Base interface for rectangle packing algorithms
+ * Base interface for rectangle packing algorithms.
+ *
+ * Packers are incremental: [findBestFit] only proposes a placement, [markRectangleAsUsed]
+ * commits it and [freeRectangle] returns a previously committed rectangle to the free
+ * space so it can be reused without repacking everything else.
  */
 interface RectanglePacker {
+    /**
+     * Find a placement for a [width] x [height] rectangle. When [allowRotation] is set the
+     * result may be rotated by 90 degrees, in which case its width and height are swapped.
+     */
     fun findBestFit(width: Int, height: Int, allowRotation: Boolean): Rectangle?
     fun markRectangleAsUsed(rectangle: Rectangle)
     fun freeRectangle(rectangle: Rectangle)
@@ -19,12 +27,19 @@ interface RectanglePacker {
 /**
  * Max Rects packing algorithm implementation
  * Industry-standard algorithm for efficient rectangle packing
+ *
+ * Keeps the set of maximal free rectangles and places each rectangle with the
+ * best-short-side-fit heuristic.
  */
-class MaxRectsPackager : RectanglePacker {
+class MaxRectsPackager(
+    private val atlasWidth: Int = 2048,
+    private val atlasHeight: Int = 2048
+) : RectanglePacker {
     private val freeRectangles = mutableListOf<Rectangle>()
     private val usedRectangles = mutableListOf<Rectangle>()
 
     init {
+        require(atlasWidth > 0 && atlasHeight > 0) { "Atlas size must be positive" }
         reset()
     }
 
@@ -51,7 +66,7 @@ class MaxRectsPackager : RectanglePacker {
             }
 
             // Try rotated orientation
-            if (allowRotation && rect.width >= height && rect.height >= width) {
+            if (allowRotation && width != height && rect.width >= height && rect.height >= width) {
                 val leftoverHorizontal = rect.width - height
                 val leftoverVertical = rect.height - width
                 val shortSideFit = minOf(leftoverHorizontal, leftoverVertical)
@@ -94,18 +109,23 @@ class MaxRectsPackager : RectanglePacker {
     }
 
     override fun freeRectangle(rectangle: Rectangle) {
-        usedRectangles.remove(rectangle)
+        if (!usedRectangles.remove(rectangle)) return
         freeRectangles.add(rectangle)
-        // Merge adjacent free rectangles
+        // Merge adjacent free rectangles, then grow the freed space into its free neighbours
         mergeRectangles()
+        expandFreedRectangles()
+        pruneRectangles()
     }
 
     override fun reset() {
         freeRectangles.clear()
         usedRectangles.clear()
-        freeRectangles.add(Rectangle(0, 0, 2048, 2048)) // Default atlas size
+        freeRectangles.add(Rectangle(0, 0, atlasWidth, atlasHeight))
     }
 
+    /** Sum of the committed rectangles' areas. */
+    val usedArea: Int get() = usedRectangles.sumOf { it.area }
+
     private fun rectanglesIntersect(a: Rectangle, b: Rectangle): Boolean {
         return !(a.x >= b.x + b.width || a.x + a.width <= b.x ||
                 a.y >= b.y + b.height || a.y + a.height <= b.y)
@@ -158,16 +178,16 @@ class MaxRectsPackager : RectanglePacker {
     }
 
     private fun pruneRectangles() {
-        val toRemove = mutableListOf<Rectangle>()
-        for (i in freeRectangles.indices) {
-            for (j in freeRectangles.indices) {
-                if (i != j && rectangleContains(freeRectangles[j], freeRectangles[i])) {
-                    toRemove.add(freeRectangles[i])
-                    break
-                }
+        // Drop every free rectangle contained in another; of two identical ones keep the first
+        var i = 0
+        while (i < freeRectangles.size) {
+            val candidate = freeRectangles[i]
+            val redundant = freeRectangles.indices.any { j ->
+                j != i && rectangleContains(freeRectangles[j], candidate) &&
+                    (freeRectangles[j] != candidate || j < i)
             }
+            if (redundant) freeRectangles.removeAt(i) else i++
         }
-        freeRectangles.removeAll(toRemove)
     }
 
     private fun rectangleContains(container: Rectangle, contained: Rectangle): Boolean {
@@ -178,20 +198,13 @@ class MaxRectsPackager : RectanglePacker {
     }
 
     private fun mergeRectangles() {
-        // Simplified merge with iteration limit to prevent infinite loops
+        // Each merge removes a rectangle, so this terminates after at most size - 1 merges
         var merged = true
-        var iterations = 0
-        val maxIterations = freeRectangles.size * freeRectangles.size
-
-        while (merged && iterations < maxIterations) {
+        while (merged) {
             merged = false
-            iterations++
-
             for (i in freeRectangles.indices) {
                 for (j in i + 1 until freeRectangles.size) {
-                    val rect1 = freeRectangles[i]
-                    val rect2 = freeRectangles[j]
-                    val mergedRect = tryMergeRectangles(rect1, rect2)
+                    val mergedRect = tryMergeRectangles(freeRectangles[i], freeRectangles[j])
                     if (mergedRect != null) {
                         freeRectangles.removeAt(j)
                         freeRectangles.removeAt(i)
@@ -203,10 +216,39 @@ class MaxRectsPackager : RectanglePacker {
                 if (merged) break
             }
         }
+    }
+
+    /**
+     * Restores maximality after a removal: each free rectangle is stretched along each
+     * axis as far as the space stays clear of used rectangles.
+     */
+    private fun expandFreedRectangles() {
+        for (i in freeRectangles.indices) {
+            var rect = freeRectangles[i]
+            rect = grow(rect, dx = -1)
+            rect = grow(rect, dx = 1)
+            rect = grow(rect, dy = -1)
+            rect = grow(rect, dy = 1)
+            if (rect != freeRectangles[i]) freeRectangles.add(rect)
+        }
+    }
 
-        if (iterations >= maxIterations) {
-            println("WARNING: Rectangle merging hit iteration limit ($maxIterations)")
+    private fun grow(rect: Rectangle, dx: Int = 0, dy: Int = 0): Rectangle {
+        // A free rectangle never intersects a used one, so every used rectangle overlapping
+        // it on one axis lies wholly to one side of it on the other
+        var x0 = if (dx < 0) 0 else rect.x
+        var y0 = if (dy < 0) 0 else rect.y
+        var x1 = if (dx > 0) atlasWidth else rect.right
+        var y1 = if (dy > 0) atlasHeight else rect.bottom
+        for (used in usedRectangles) {
+            val overlapsY = used.y < rect.bottom && used.bottom > rect.y
+            val overlapsX = used.x < rect.right && used.right > rect.x
+            if (dx < 0 && overlapsY && used.right <= rect.x) x0 = maxOf(x0, used.right)
+            if (dx > 0 && overlapsY && used.x >= rect.right) x1 = minOf(x1, used.x)
+            if (dy < 0 && overlapsX && used.bottom <= rect.y) y0 = maxOf(y0, used.bottom)
+            if (dy > 0 && overlapsX && used.y >= rect.bottom) y1 = minOf(y1, used.y)
         }
+        return Rectangle(x0, y0, x1 - x0, y1 - y0)
     }
 
     private fun tryMergeRectangles(a: Rectangle, b: Rectangle): Rectangle? {
@@ -0,0 +1,789 @@
+package io.materia.optimization
+
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlin.math.max
+import kotlin.math.min
+
+/**
+ * Bounding volume hierarchy over axis-aligned boxes, built for frustum culling.
+ *
+ * Object bounds live in structure-of-arrays [FloatArray]s stored in leaf order, so each
+ * leaf is a contiguous run of at most [leafSize] boxes that is tested plane by plane in
+ * one tight loop. Nodes use the same layout.
+ *
+ * Moving objects only refit the bounds of their leaf and its ancestors; the tree is
+ * rebuilt only after objects are inserted, or once removals leave too many holes.
+ * Traversal tracks which frustum planes still straddle a node, so subtrees entirely
+ * inside the frustum are accepted without further plane tests.
+ *
+ * [cull] does not allocate once capacities have settled.
+ *
+ * @param initialCapacity Objects the arrays hold before the first growth
+ * @param leafSize Maximum boxes per leaf (1..32)
+ */
+class CullingBvh(
+    initialCapacity: Int = 64,
+    val leafSize: Int = DEFAULT_LEAF_SIZE
+) {
+    init {
+        require(initialCapacity > 0) { "initialCapacity must be positive (was $initialCapacity)" }
+        require(leafSize in 1..32) { "leafSize must be in 1..32 (was $leafSize)" }
+    }
+
+    // Object bounds, indexed by slot (leaf order)
+    private var minX = FloatArray(initialCapacity)
+    private var minY = FloatArray(initialCapacity)
+    private var minZ = FloatArray(initialCapacity)
+    private var maxX = FloatArray(initialCapacity)
+    private var maxY = FloatArray(initialCapacity)
+    private var maxZ = FloatArray(initialCapacity)
+    private var slotHandle = IntArray(initialCapacity)
+    private var slotLeaf = IntArray(initialCapacity)
+    private var slotCount = 0
+
+    // Handle -> slot, with a free list of released handles
+    private var handleSlot = IntArray(initialCapacity)
+    private var freeHandles = IntArray(initialCapacity)
+    private var freeHandleCount = 0
+    private var handleCount = 0
+
+    // Nodes in depth-first order: the left child of an inner node is the next node
+    private var nodeMinX = FloatArray(0)
+    private var nodeMinY = FloatArray(0)
+    private var nodeMinZ = FloatArray(0)
+    private var nodeMaxX = FloatArray(0)
+    private var nodeMaxY = FloatArray(0)
+    private var nodeMaxZ = FloatArray(0)
+    private var nodeFirstSlot = IntArray(0)
+    private var nodeSlotCount = IntArray(0)
+    private var nodeRight = IntArray(0)
+    private var nodeParent = IntArray(0)
+    private var nodeCount = 0
+    private var treeDepth = 0
+
+    private var dirtyNode = BooleanArray(0)
+    private var dirtyLeaves = IntArray(0)
+    private var dirtyLeafCount = 0
+
+    private var needsRebuild = false
+    private var removedSlots = 0
+
+    // Traversal scratch
+    private var stackNode = IntArray(0)
+    private var stackMask = IntArray(0)
+    private var visible = IntArray(initialCapacity)
+    private var parallelBuffers: Array<IntArray> = emptyArray()
+
+    /** Number of live objects. */
+    var size: Int = 0
+        private set
+
+    /** Number of handles written by the last cull. */
+    var visibleCount: Int = 0
+        private set
+
+    /** Node count of the current tree, for diagnostics. */
+    val nodes: Int
+        get() = nodeCount
+
+    /**
+     * Adds a box and returns its handle. The tree is rebuilt on the next cull.
+     */
+    fun insert(
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float
+    ): Int {
+        val handle = if (freeHandleCount > 0) {
+            freeHandles[--freeHandleCount]
+        } else {
+            if (handleCount == handleSlot.size) {
+                handleSlot = handleSlot.copyOf(handleCount * 2)
+            }
+            handleCount++
+        }
+
+        ensureSlotCapacity(slotCount + 1)
+        val slot = slotCount++
+        writeSlot(slot, minX, minY, minZ, maxX, maxY, maxZ)
+        slotHandle[slot] = handle
+        slotLeaf[slot] = -1
+        handleSlot[handle] = slot
+        size++
+        needsRebuild = true
+        return handle
+    }
+
+    /**
+     * Replaces the bounds of [handle]. The affected leaf is refit on the next cull.
+     */
+    fun update(
+        handle: Int,
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float
+    ) {
+        val slot = slotOf(handle)
+        writeSlot(slot, minX, minY, minZ, maxX, maxY, maxZ)
+        markLeafDirty(slotLeaf[slot])
+    }
+
+    /**
+     * Removes [handle]; the handle may be reused by a later [insert].
+     */
+    fun remove(handle: Int) {
+        val slot = slotOf(handle)
+        slotHandle[slot] = REMOVED
+        handleSlot[handle] = REMOVED
+        if (freeHandleCount == freeHandles.size) {
+            freeHandles = freeHandles.copyOf(max(4, freeHandleCount * 2))
+        }
+        freeHandles[freeHandleCount++] = handle
+        size--
+        removedSlots++
+        if (removedSlots > size) {
+            needsRebuild = true
+        } else {
+            markLeafDirty(slotLeaf[slot])
+        }
+    }
+
+    fun clear() {
+        slotCount = 0
+        handleCount = 0
+        freeHandleCount = 0
+        nodeCount = 0
+        treeDepth = 0
+        clearDirtyLeaves()
+        removedSlots = 0
+        size = 0
+        visibleCount = 0
+        needsRebuild = false
+    }
+
+    /** Handle of the [index]-th object accepted by the last cull. */
+    fun visibleHandle(index: Int): Int = visible[index]
+
+    /**
+     * Brings the tree up to date: rebuilds after insertions, otherwise refits dirty leaves.
+     */
+    fun refit() {
+        if (needsRebuild) {
+            rebuild()
+            return
+        }
+        for (i in 0 until dirtyLeafCount) {
+            val leaf = dirtyLeaves[i]
+            dirtyNode[leaf] = false
+            refitLeaf(leaf)
+            var node = nodeParent[leaf]
+            while (node >= 0 && refitInner(node)) {
+                node = nodeParent[node]
+            }
+        }
+        dirtyLeafCount = 0
+    }
+
+    /**
+     * Collects the handles of every box intersecting [frustum]; read them back with
+     * [visibleHandle] for indices below the returned [visibleCount].
+     */
+    fun cull(frustum: Frustum): Int {
+        refit()
+        ensureVisibleCapacity()
+        visibleCount = if (nodeCount == 0) 0 else traverse(0, ALL_PLANES, frustum.planeData, visible, 0)
+        return visibleCount
+    }
+
+    /**
+     * [cull] with the traversal split across up to [tasks] subtrees on [dispatcher].
+     *
+     * Worth it for large trees on multi-threaded dispatchers (JVM, native); on JS the
+     * default dispatcher is single-threaded and this only adds overhead.
+     */
+    suspend fun cullParallel(
+        frustum: Frustum,
+        tasks: Int = DEFAULT_PARALLEL_TASKS,
+        dispatcher: CoroutineDispatcher = Dispatchers.Default
+    ): Int {
+        refit()
+        ensureVisibleCapacity()
+        if (nodeCount == 0) {
+            visibleCount = 0
+            return 0
+        }
+
+        val roots = splitRoots(tasks)
+        if (parallelBuffers.size < roots.size) {
+            parallelBuffers = Array(roots.size) { IntArray(0) }
+        }
+        val planes = frustum.planeData
+        val counts = coroutineScope {
+            roots.indices.map { task ->
+                async(dispatcher) {
+                    val root = roots[task]
+                    if (parallelBuffers[task].size < nodeSlotCount[root]) {
+                        parallelBuffers[task] = IntArray(nodeSlotCount[root])
+                    }
+                    traverseWithOwnStack(root, planes, parallelBuffers[task])
+                }
+            }.awaitAll()
+        }
+
+        var total = 0
+        for (task in roots.indices) {
+            parallelBuffers[task].copyInto(visible, total, 0, counts[task])
+            total += counts[task]
+        }
+        visibleCount = total
+        return total
+    }
+
+    /**
+     * Visits the boxes hit by the ray `origin + t * direction` for t in `[0, maxDistance]`,
+     * nearer subtrees first.
+     *
+     * [visitor] receives each handle with the distance at which the ray enters its box and
+     * returns the new maximum distance, so a caller looking for the closest hit prunes
+     * everything behind the best one found so far. [direction] need not be normalised;
+     * distances are in units of its length.
+     */
+    fun raycast(
+        originX: Float, originY: Float, originZ: Float,
+        directionX: Float, directionY: Float, directionZ: Float,
+        maxDistance: Float,
+        visitor: RayVisitor
+    ) {
+        refit()
+        if (nodeCount == 0) return
+        val requiredStack = treeDepth + 2
+        if (stackNode.size < requiredStack) {
+            stackNode = IntArray(requiredStack)
+            stackMask = IntArray(requiredStack)
+        }
+        val invX = 1f / directionX
+        val invY = 1f / directionY
+        val invZ = 1f / directionZ
+        var limit = maxDistance
+
+        stackNode[0] = 0
+        var top = 1
+        while (top > 0) {
+            val node = stackNode[--top]
+            if (nodeEntry(node, originX, originY, originZ, invX, invY, invZ, limit) > limit) continue
+
+            if (nodeRight[node] == LEAF) {
+                val first = nodeFirstSlot[node]
+                for (s in first until first + nodeSlotCount[node]) {
+                    val handle = slotHandle[s]
+                    if (handle == REMOVED) continue
+                    val entry = slabEntry(
+                        minX[s], minY[s], minZ[s], maxX[s], maxY[s], maxZ[s],
+                        originX, originY, originZ, invX, invY, invZ, limit
+                    )
+                    if (entry <= limit) limit = visitor.visit(handle, entry)
+                }
+            } else {
+                val left = node + 1
+                val right = nodeRight[node]
+                val leftEntry = nodeEntry(left, originX, originY, originZ, invX, invY, invZ, limit)
+                val rightEntry = nodeEntry(right, originX, originY, originZ, invX, invY, invZ, limit)
+                // Push the farther child first so the nearer one is popped next
+                if (leftEntry <= rightEntry) {
+                    if (rightEntry <= limit) stackNode[top++] = right
+                    if (leftEntry <= limit) stackNode[top++] = left
+                } else {
+                    if (leftEntry <= limit) stackNode[top++] = left
+                    if (rightEntry <= limit) stackNode[top++] = right
+                }
+            }
+        }
+    }
+
+    /**
+     * Visits the handle of every box overlapping the given box (touching counts).
+     */
+    fun query(
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float,
+        visitor: HandleVisitor
+    ) {
+        refit()
+        if (nodeCount == 0) return
+        val requiredStack = treeDepth + 2
+        if (stackNode.size < requiredStack) {
+            stackNode = IntArray(requiredStack)
+            stackMask = IntArray(requiredStack)
+        }
+
+        stackNode[0] = 0
+        var top = 1
+        while (top > 0) {
+            val node = stackNode[--top]
+            if (nodeMinX[node] > maxX || nodeMaxX[node] < minX ||
+                nodeMinY[node] > maxY || nodeMaxY[node] < minY ||
+                nodeMinZ[node] > maxZ || nodeMaxZ[node] < minZ
+            ) {
+                continue
+            }
+            if (nodeRight[node] == LEAF) {
+                val first = nodeFirstSlot[node]
+                for (s in first until first + nodeSlotCount[node]) {
+                    val handle = slotHandle[s]
+                    if (handle == REMOVED) continue
+                    if (this.minX[s] > maxX || this.maxX[s] < minX ||
+                        this.minY[s] > maxY || this.maxY[s] < minY ||
+                        this.minZ[s] > maxZ || this.maxZ[s] < minZ
+                    ) {
+                        continue
+                    }
+                    visitor.visit(handle)
+                }
+            } else {
+                stackNode[top++] = nodeRight[node]
+                stackNode[top++] = node + 1
+            }
+        }
+    }
+
+    /** Receives the handles found by [query]. */
+    fun interface HandleVisitor {
+        fun visit(handle: Int)
+    }
+
+    /** Receives the boxes hit by [raycast]; returns the new maximum ray distance. */
+    fun interface RayVisitor {
+        fun visit(handle: Int, entryDistance: Float): Float
+    }
+
+    private fun nodeEntry(
+        node: Int,
+        ox: Float, oy: Float, oz: Float,
+        invX: Float, invY: Float, invZ: Float,
+        limit: Float
+    ): Float = slabEntry(
+        nodeMinX[node], nodeMinY[node], nodeMinZ[node],
+        nodeMaxX[node], nodeMaxY[node], nodeMaxZ[node],
+        ox, oy, oz, invX, invY, invZ, limit
+    )
+
+    private fun traverse(root: Int, rootMask: Int, planes: FloatArray, out: IntArray, outStart: Int): Int {
+        val requiredStack = treeDepth + 2
+        if (stackNode.size < requiredStack) {
+            stackNode = IntArray(requiredStack)
+            stackMask = IntArray(requiredStack)
+        }
+        return traverseInto(root, rootMask, planes, out, outStart, stackNode, stackMask)
+    }
+
+    private fun traverseWithOwnStack(root: Int, planes: FloatArray, out: IntArray): Int {
+        val stackSize = treeDepth + 2
+        return traverseInto(root, ALL_PLANES, planes, out, 0, IntArray(stackSize), IntArray(stackSize))
+    }
+
+    private fun traverseInto(
+        root: Int,
+        rootMask: Int,
+        planes: FloatArray,
+        out: IntArray,
+        outStart: Int,
+        nodeStack: IntArray,
+        maskStack: IntArray
+    ): Int {
+        var written = outStart
+        nodeStack[0] = root
+        maskStack[0] = rootMask
+        var top = 1
+
+        while (top > 0) {
+            top--
+            val node = nodeStack[top]
+            val mask = classifyNode(node, planes, maskStack[top])
+            if (mask == OUTSIDE) continue
+
+            if (mask == 0) {
+                // Entirely inside: accept the subtree's contiguous slot range
+                written = emitRange(nodeFirstSlot[node], nodeSlotCount[node], out, written)
+            } else if (nodeRight[node] == LEAF) {
+                written = testLeaf(node, planes, mask, out, written)
+            } else {
+                nodeStack[top] = nodeRight[node]
+                maskStack[top] = mask
+                top++
+                nodeStack[top] = node + 1
+                maskStack[top] = mask
+                top++
+            }
+        }
+        return written - outStart
+    }
+
+    /**
+     * Returns [OUTSIDE], or the subset of [mask] whose planes still cut the node.
+     */
+    private fun classifyNode(node: Int, planes: FloatArray, mask: Int): Int {
+        var remaining = mask
+        for (p in 0 until PLANE_COUNT) {
+            val bit = 1 shl p
+            if (mask and bit == 0) continue
+            val o = p * 4
+            val a = planes[o]
+            val b = planes[o + 1]
+            val c = planes[o + 2]
+            val d = planes[o + 3]
+
+            val far = a * (if (a >= 0f) nodeMaxX[node] else nodeMinX[node]) +
+                b * (if (b >= 0f) nodeMaxY[node] else nodeMinY[node]) +
+                c * (if (c >= 0f) nodeMaxZ[node] else nodeMinZ[node]) + d
+            if (far < 0f) return OUTSIDE
+
+            val near = a * (if (a >= 0f) nodeMinX[node] else nodeMaxX[node]) +
+                b * (if (b >= 0f) nodeMinY[node] else nodeMaxY[node]) +
+                c * (if (c >= 0f) nodeMinZ[node] else nodeMaxZ[node]) + d
+            if (near >= 0f) remaining = remaining and bit.inv()
+        }
+        return remaining
+    }
+
+    // Plane-major loop over the leaf's contiguous boxes: the inner loop reads six
+    // parallel arrays with unit stride and no per-box branching on plane signs.
+    private fun testLeaf(leaf: Int, planes: FloatArray, mask: Int, out: IntArray, outStart: Int): Int {
+        val first = nodeFirstSlot[leaf]
+        val count = nodeSlotCount[leaf]
+        var alive = if (count == 32) -1 else (1 shl count) - 1
+
+        for (p in 0 until PLANE_COUNT) {
+            if (mask and (1 shl p) == 0) continue
+            val o = p * 4
+            val a = planes[o]
+            val b = planes[o + 1]
+            val c = planes[o + 2]
+            val d = planes[o + 3]
+            val xs = if (a >= 0f) maxX else minX
+            val ys = if (b >= 0f) maxY else minY
+            val zs = if (c >= 0f) maxZ else minZ
+
+            for (i in 0 until count) {
+                val s = first + i
+                if (a * xs[s] + b * ys[s] + c * zs[s] + d < 0f) {
+                    alive = alive and (1 shl i).inv()
+                }
+            }
+            if (alive == 0) return outStart
+        }
+
+        var written = outStart
+        for (i in 0 until count) {
+            if (alive and (1 shl i) != 0) {
+                val handle = slotHandle[first + i]
+                if (handle != REMOVED) out[written++] = handle
+            }
+        }
+        return written
+    }
+
+    private fun emitRange(first: Int, count: Int, out: IntArray, outStart: Int): Int {
+        var written = outStart
+        for (s in first until first + count) {
+            val handle = slotHandle[s]
+            if (handle != REMOVED) out[written++] = handle
+        }
+        return written
+    }
+
+    private fun splitRoots(tasks: Int): IntArray {
+        // Breadth-first expansion until there are enough independent subtrees
+        var roots = IntArray(1)
+        var count = 1
+        while (count < tasks) {
+            val next = IntArray(count * 2)
+            var nextCount = 0
+            var expanded = false
+            for (i in 0 until count) {
+                val node = roots[i]
+                if (nodeRight[node] == LEAF) {
+                    next[nextCount++] = node
+                } else {
+                    next[nextCount++] = node + 1
+                    next[nextCount++] = nodeRight[node]
+                    expanded = true
+                }
+            }
+            roots = next
+            count = nextCount
+            if (!expanded) break
+        }
+        return roots.copyOf(count)
+    }
+
+    private fun rebuild() {
+        // Compact live slots
+        var live = 0
+        for (s in 0 until slotCount) {
+            val handle = slotHandle[s]
+            if (handle == REMOVED) continue
+            if (live != s) {
+                writeSlot(live, minX[s], minY[s], minZ[s], maxX[s], maxY[s], maxZ[s])
+                slotHandle[live] = handle
+            }
+            handleSlot[handle] = live
+            live++
+        }
+        slotCount = live
+        removedSlots = 0
+        needsRebuild = false
+        clearDirtyLeaves()
+
+        ensureNodeCapacity(max(1, nodesFor(live)))
+        nodeCount = 0
+        treeDepth = 0
+        if (live == 0) return
+        build(0, live, -1, 1)
+    }
+
+    // Node count of the tree build() creates over [count] slots; halving the range leaves
+    // up to twice as many leaves as the count / leafSize estimate
+    private fun nodesFor(count: Int): Int =
+        if (count <= leafSize) 1 else 1 + nodesFor(count / 2) + nodesFor(count - count / 2)
+
+    private fun build(first: Int, count: Int, parent: Int, depth: Int): Int {
+        val node = nodeCount++
+        nodeParent[node] = parent
+        nodeFirstSlot[node] = first
+        nodeSlotCount[node] = count
+        treeDepth = max(treeDepth, depth)
+
+        if (count <= leafSize) {
+            nodeRight[node] = LEAF
+            for (s in first until first + count) {
+                slotLeaf[s] = node
+            }
+            refitLeaf(node)
+            return node
+        }
+
+        // Median split along the widest axis of the centroids
+        var cMinX = Float.POSITIVE_INFINITY
+        var cMinY = Float.POSITIVE_INFINITY
+        var cMinZ = Float.POSITIVE_INFINITY
+        var cMaxX = Float.NEGATIVE_INFINITY
+        var cMaxY = Float.NEGATIVE_INFINITY
+        var cMaxZ = Float.NEGATIVE_INFINITY
+        for (s in first until first + count) {
+            val cx = minX[s] + maxX[s]
+            val cy = minY[s] + maxY[s]
+            val cz = minZ[s] + maxZ[s]
+            cMinX = min(cMinX, cx); cMaxX = max(cMaxX, cx)
+            cMinY = min(cMinY, cy); cMaxY = max(cMaxY, cy)
+            cMinZ = min(cMinZ, cz); cMaxZ = max(cMaxZ, cz)
+        }
+        val ex = cMaxX - cMinX
+        val ey = cMaxY - cMinY
+        val ez = cMaxZ - cMinZ
+        val axis = if (ex >= ey && ex >= ez) 0 else if (ey >= ez) 1 else 2
+
+        val half = count / 2
+        selectNth(first, first + count - 1, first + half, axis)
+
+        build(first, half, node, depth + 1)
+        nodeRight[node] = build(first + half, count - half, node, depth + 1)
+        refitInner(node)
+        return node
+    }
+
+    private fun centroid(slot: Int, axis: Int): Float = when (axis) {
+        0 -> minX[slot] + maxX[slot]
+        1 -> minY[slot] + maxY[slot]
+        else -> minZ[slot] + maxZ[slot]
+    }
+
+    // Quickselect: partially orders slots so that [nth] holds its sorted value
+    private fun selectNth(low: Int, high: Int, nth: Int, axis: Int) {
+        var lo = low
+        var hi = high
+        while (lo < hi) {
+            val pivot = centroid(lo + (hi - lo) / 2, axis)
+            var i = lo
+            var j = hi
+            while (i <= j) {
+                while (centroid(i, axis) < pivot) i++
+                while (centroid(j, axis) > pivot) j--
+                if (i <= j) {
+                    swapSlots(i, j)
+                    i++
+                    j--
+                }
+            }
+            if (nth <= j) {
+                hi = j
+            } else if (nth >= i) {
+                lo = i
+            } else {
+                return
+            }
+        }
+    }
+
+    private fun swapSlots(i: Int, j: Int) {
+        var t = minX[i]; minX[i] = minX[j]; minX[j] = t
+        t = minY[i]; minY[i] = minY[j]; minY[j] = t
+        t = minZ[i]; minZ[i] = minZ[j]; minZ[j] = t
+        t = maxX[i]; maxX[i] = maxX[j]; maxX[j] = t
+        t = maxY[i]; maxY[i] = maxY[j]; maxY[j] = t
+        t = maxZ[i]; maxZ[i] = maxZ[j]; maxZ[j] = t
+        val hi = slotHandle[i]
+        slotHandle[i] = slotHandle[j]
+        slotHandle[j] = hi
+        handleSlot[slotHandle[i]] = i
+        handleSlot[slotHandle[j]] = j
+    }
+
+    private fun refitLeaf(leaf: Int) {
+        var bMinX = Float.POSITIVE_INFINITY
+        var bMinY = Float.POSITIVE_INFINITY
+        var bMinZ = Float.POSITIVE_INFINITY
+        var bMaxX = Float.NEGATIVE_INFINITY
+        var bMaxY = Float.NEGATIVE_INFINITY
+        var bMaxZ = Float.NEGATIVE_INFINITY
+        val first = nodeFirstSlot[leaf]
+        for (s in first until first + nodeSlotCount[leaf]) {
+            if (slotHandle[s] == REMOVED) continue
+            bMinX = min(bMinX, minX[s]); bMaxX = max(bMaxX, maxX[s])
+            bMinY = min(bMinY, minY[s]); bMaxY = max(bMaxY, maxY[s])
+            bMinZ = min(bMinZ, minZ[s]); bMaxZ = max(bMaxZ, maxZ[s])
+        }
+        setNodeBounds(leaf, bMinX, bMinY, bMinZ, bMaxX, bMaxY, bMaxZ)
+    }
+
+    /** Recomputes an inner node from its children; returns false if nothing changed. */
+    private fun refitInner(node: Int): Boolean {
+        val l = node + 1
+        val r = nodeRight[node]
+        val bMinX = min(nodeMinX[l], nodeMinX[r])
+        val bMinY = min(nodeMinY[l], nodeMinY[r])
+        val bMinZ = min(nodeMinZ[l], nodeMinZ[r])
+        val bMaxX = max(nodeMaxX[l], nodeMaxX[r])
+        val bMaxY = max(nodeMaxY[l], nodeMaxY[r])
+        val bMaxZ = max(nodeMaxZ[l], nodeMaxZ[r])
+        if (bMinX == nodeMinX[node] && bMinY == nodeMinY[node] && bMinZ == nodeMinZ[node] &&
+            bMaxX == nodeMaxX[node] && bMaxY == nodeMaxY[node] && bMaxZ == nodeMaxZ[node]
+        ) {
+            return false
+        }
+        setNodeBounds(node, bMinX, bMinY, bMinZ, bMaxX, bMaxY, bMaxZ)
+        return true
+    }
+
+    private fun setNodeBounds(node: Int, x0: Float, y0: Float, z0: Float, x1: Float, y1: Float, z1: Float) {
+        nodeMinX[node] = x0
+        nodeMinY[node] = y0
+        nodeMinZ[node] = z0
+        nodeMaxX[node] = x1
+        nodeMaxY[node] = y1
+        nodeMaxZ[node] = z1
+    }
+
+    // Leaves queued before a rebuild are renumbered by it; their flags must not outlive it
+    private fun clearDirtyLeaves() {
+        for (i in 0 until dirtyLeafCount) dirtyNode[dirtyLeaves[i]] = false
+        dirtyLeafCount = 0
+    }
+
+    private fun markLeafDirty(leaf: Int) {
+        if (needsRebuild || leaf < 0 || dirtyNode[leaf]) return
+        dirtyNode[leaf] = true
+        dirtyLeaves[dirtyLeafCount++] = leaf
+    }
+
+    private fun slotOf(handle: Int): Int {
+        require(handle in 0 until handleCount && handleSlot[handle] != REMOVED) {
+            "Unknown culling handle $handle"
+        }
+        return handleSlot[handle]
+    }
+
+    private fun writeSlot(slot: Int, x0: Float, y0: Float, z0: Float, x1: Float, y1: Float, z1: Float) {
+        minX[slot] = x0
+        minY[slot] = y0
+        minZ[slot] = z0
+        maxX[slot] = x1
+        maxY[slot] = y1
+        maxZ[slot] = z1
+    }
+
+    private fun ensureSlotCapacity(required: Int) {
+        if (required <= minX.size) return
+        val capacity = max(required, minX.size * 2)
+        minX = minX.copyOf(capacity)
+        minY = minY.copyOf(capacity)
+        minZ = minZ.copyOf(capacity)
+        maxX = maxX.copyOf(capacity)
+        maxY = maxY.copyOf(capacity)
+        maxZ = maxZ.copyOf(capacity)
+        slotHandle = slotHandle.copyOf(capacity)
+        slotLeaf = slotLeaf.copyOf(capacity)
+    }
+
+    private fun ensureNodeCapacity(required: Int) {
+        if (required <= nodeMinX.size) return
+        val capacity = max(required, nodeMinX.size * 2)
+        nodeMinX = nodeMinX.copyOf(capacity)
+        nodeMinY = nodeMinY.copyOf(capacity)
+        nodeMinZ = nodeMinZ.copyOf(capacity)
+        nodeMaxX = nodeMaxX.copyOf(capacity)
+        nodeMaxY = nodeMaxY.copyOf(capacity)
+        nodeMaxZ = nodeMaxZ.copyOf(capacity)
+        nodeFirstSlot = nodeFirstSlot.copyOf(capacity)
+        nodeSlotCount = nodeSlotCount.copyOf(capacity)
+        nodeRight = nodeRight.copyOf(capacity)
+        nodeParent = nodeParent.copyOf(capacity)
+        dirtyNode = BooleanArray(capacity)
+        dirtyLeaves = IntArray(capacity)
+    }
+
+    private fun ensureVisibleCapacity() {
+        if (visible.size < size) {
+            visible = IntArray(max(size, visible.size * 2))
+        }
+    }
+
+    companion object {
+        const val DEFAULT_LEAF_SIZE = 8
+
+        /**
+         * Slab test: the distance at which the ray enters the box, 0 when the origin is
+         * inside, or [Float.POSITIVE_INFINITY] on a miss or past [limit].
+         */
+        internal fun slabEntry(
+            x0: Float, y0: Float, z0: Float,
+            x1: Float, y1: Float, z1: Float,
+            ox: Float, oy: Float, oz: Float,
+            invX: Float, invY: Float, invZ: Float,
+            limit: Float
+        ): Float {
+            val ax = (x0 - ox) * invX
+            val bx = (x1 - ox) * invX
+            val ay = (y0 - oy) * invY
+            val by = (y1 - oy) * invY
+            val az = (z0 - oz) * invZ
+            val bz = (z1 - oz) * invZ
+            val enter = max(max(min(ax, bx), min(ay, by)), max(min(az, bz), 0f))
+            val exit = min(min(max(ax, bx), max(ay, by)), min(max(az, bz), limit))
+            return when {
+                enter > exit -> Float.POSITIVE_INFINITY
+                // 0 * inf when the origin lies on a face parallel to the ray: treat as a hit
+                enter.isNaN() -> 0f
+                else -> enter
+            }
+        }
+        const val DEFAULT_PARALLEL_TASKS = 8
+
+        private const val PLANE_COUNT = 6
+        private const val ALL_PLANES = (1 shl PLANE_COUNT) - 1
+        private const val OUTSIDE = -1
+        private const val LEAF = -1
+        private const val REMOVED = -1
+    }
+}
@@ -11,118 +11,67 @@ import kotlin.math.*
 // Type alias for compatibility
 typealias BoundingBox = Box3
 
-/**
- * Represents a plane in 3D space (ax + by + cz + d = 0).
- */
-private class FrustumPlane {
-    var a = 0f
-    var b = 0f
-    var c = 0f
-    var d = 0f
-
-    fun set(a: Float, b: Float, c: Float, d: Float): FrustumPlane {
-        this.a = a
-        this.b = b
-        this.c = c
-        this.d = d
-        return this
-    }
-
-    fun normalize(): FrustumPlane {
-        val length = kotlin.math.sqrt(a * a + b * b + c * c)
-        if (length > 0) {
-            val invLength = 1f / length
-            a *= invLength
-            b *= invLength
-            c *= invLength
-            d *= invLength
-        }
-        return this
-    }
-
-    fun distanceToPoint(point: Vector3): Float {
-        return a * point.x.toFloat() + b * point.y.toFloat() + c * point.z.toFloat() + d
-    }
-}
-
 /**
  * View frustum for visibility culling
  */
 class Frustum {
-    // Frustum planes (left, right, bottom, top, near, far)
-    private val planes = Array(6) { FrustumPlane() }
+    // Frustum planes (left, right, bottom, top, near, far) as packed a, b, c, d
+    // quadruples, read directly by CullingBvh traversal
+    internal val planeData = FloatArray(24)
 
     /**
-     * Extracts frustum planes from camera's projection-view matrix.
-     * @param camera Camera with projection and view matrices
+     * Extracts frustum planes from a projection-view matrix.
+     * @param matrix Combined projection * view matrix
      */
     fun setFromMatrix(matrix: Matrix4) {
-        val me = matrix.toArray()
+        val me = matrix.elements
 
         // Extract frustum planes using Gribb-Hartmann method
         // Left plane
-        planes[0].set(
-            me[3] + me[0],
-            me[7] + me[4],
-            me[11] + me[8],
-            me[15] + me[12]
-        ).normalize()
-
+        setPlane(0, me[3] + me[0], me[7] + me[4], me[11] + me[8], me[15] + me[12])
         // Right plane
-        planes[1].set(
-            me[3] - me[0],
-            me[7] - me[4],
-            me[11] - me[8],
-            me[15] - me[12]
-        ).normalize()
-
+        setPlane(1, me[3] - me[0], me[7] - me[4], me[11] - me[8], me[15] - me[12])
         // Bottom plane
-        planes[2].set(
-            me[3] + me[1],
-            me[7] + me[5],
-            me[11] + me[9],
-            me[15] + me[13]
-        ).normalize()
-
+        setPlane(2, me[3] + me[1], me[7] + me[5], me[11] + me[9], me[15] + me[13])
         // Top plane
-        planes[3].set(
-            me[3] - me[1],
-            me[7] - me[5],
-            me[11] - me[9],
-            me[15] - me[13]
-        ).normalize()
-
+        setPlane(3, me[3] - me[1], me[7] - me[5], me[11] - me[9], me[15] - me[13])
         // Near plane
-        planes[4].set(
-            me[3] + me[2],
-            me[7] + me[6],
-            me[11] + me[10],
-            me[15] + me[14]
-        ).normalize()
-
+        setPlane(4, me[3] + me[2], me[7] + me[6], me[11] + me[10], me[15] + me[14])
         // Far plane
-        planes[5].set(
-            me[3] - me[2],
-            me[7] - me[6],
-            me[11] - me[10],
-            me[15] - me[14]
-        ).normalize()
-    }
-
-    fun intersectsBox(box: BoundingBox): Boolean {
-        for (plane in planes) {
-            // Find the positive vertex (furthest along the normal)
-            val positive = Vector3(
-                if (plane.a >= 0) box.max.x else box.min.x,
-                if (plane.b >= 0) box.max.y else box.min.y,
-                if (plane.c >= 0) box.max.z else box.min.z
-            )
-            if (plane.distanceToPoint(positive) < 0) {
+        setPlane(5, me[3] - me[2], me[7] - me[6], me[11] - me[10], me[15] - me[14])
+    }
+
+    fun intersectsBox(box: BoundingBox): Boolean =
+        intersectsBox(box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z)
+
+    fun intersectsBox(
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float
+    ): Boolean {
+        for (o in 0 until 24 step 4) {
+            val a = planeData[o]
+            val b = planeData[o + 1]
+            val c = planeData[o + 2]
+            // Test the positive vertex (furthest along the normal)
+            val distance = a * (if (a >= 0f) maxX else minX) +
+                b * (if (b >= 0f) maxY else minY) +
+                c * (if (c >= 0f) maxZ else minZ) + planeData[o + 3]
+            if (distance < 0f) {
                 return false
             }
         }
         return true
     }
+
+    private fun setPlane(index: Int, a: Float, b: Float, c: Float, d: Float) {
+        val length = sqrt(a * a + b * b + c * c)
+        val invLength = if (length > 0f) 1f / length else 1f
+        val o = index * 4
+        planeData[o] = a * invLength
+        planeData[o + 1] = b * invLength
+        planeData[o + 2] = c * invLength
+        planeData[o + 3] = d * invLength
+    }
 }
 
 /**
@@ -376,6 +325,10 @@ class HierarchicalZBuffer(
 
 /**
  * Comprehensive culling system
+ *
+ * Meshes are kept in a [CullingBvh] over their world-space bounds. Bounds are only
+ * recomputed for meshes whose `matrixWorldVersion` or geometry bounds changed, so a
+ * static scene costs one version check per mesh per frame plus the tree traversal.
  */
 class CullingSystem(
     private val renderer: Renderer,
@@ -384,17 +337,26 @@ class CullingSystem(
     private val enableSmallObject: Boolean = true
 ) {
     private val frustum = Frustum()
-    private val octree = OctreeNode(
-        BoundingBox(
-            Vector3(-1000f, -1000f, -1000f),
-            Vector3(1000f, 1000f, 1000f)
-        )
-    )
+    private val bvh = CullingBvh()
     private val hierarchicalZBuffer = if (enableOcclusion) {
         HierarchicalZBuffer()
     } else null
     private val statistics = CullingStatistics()
 
+    // Per-handle tracking, indexed by BVH handle
+    private val handles = HashMap<Mesh, Int>()
+    private var meshes = arrayOfNulls<Mesh>(64)
+    private var boundsSource = arrayOfNulls<Box3>(64)
+    private var worldVersion = IntArray(64)
+    private var centerX = FloatArray(64)
+    private var centerY = FloatArray(64)
+    private var centerZ = FloatArray(64)
+    private var radius = FloatArray(64)
+
+    private val viewProjection = Matrix4()
+    private val occlusionBox = BoundingBox()
+    private val visible = ArrayList<Mesh>()
+
     // Culling configuration
     var maxRenderDistance = 1000f
     var minObjectScreenSize = 2f // pixels
@@ -403,7 +365,12 @@ class CullingSystem(
      * Add object to culling system
      */
     fun addObject(mesh: Mesh) {
-        octree.insert(mesh)
+        if (mesh in handles) return
+        val handle = bvh.insert(0f, 0f, 0f, 0f, 0f, 0f)
+        ensureCapacity(handle + 1)
+        handles[mesh] = handle
+        meshes[handle] = mesh
+        writeWorldBounds(handle, mesh)
         statistics.totalObjects++
     }
 
@@ -411,77 +378,174 @@ class CullingSystem(
      * Remove object from culling system
      */
     fun removeObject(mesh: Mesh) {
-        // Would need to implement removal from octree
+        val handle = handles.remove(mesh) ?: return
+        bvh.remove(handle)
+        meshes[handle] = null
+        boundsSource[handle] = null
         statistics.totalObjects--
     }
 
     /**
-     * Perform all culling operations
+     * Perform all culling operations.
+     *
+     * The returned list is reused and is only valid until the next call.
      */
     fun cull(camera: Camera): List<Mesh> {
+        beginCull(camera)
+        return finishCull(camera, bvh.cull(frustum))
+    }
+
+    /**
+     * [cull] with the frustum traversal spread over [Dispatchers.Default]; pays off for
+     * scenes with many thousands of meshes on multi-threaded targets.
+     */
+    suspend fun cullAsync(camera: Camera): List<Mesh> {
+        beginCull(camera)
+        return finishCull(camera, bvh.cullParallel(frustum))
+    }
+
+    private fun beginCull(camera: Camera) {
         statistics.frameStart()
 
         // Update frustum from camera
-        val viewProjection = camera.projectionMatrix.clone().multiply(camera.viewMatrix)
+        viewProjection.multiplyMatrices(camera.projectionMatrix, camera.viewMatrix)
         frustum.setFromMatrix(viewProjection)
 
-        // Frustum culling via octree
-        val frustumCulled = mutableListOf<Mesh>()
-        octree.query(frustum, frustumCulled)
-        statistics.frustumCulled = statistics.totalObjects - frustumCulled.size
+        for (handle in meshes.indices) {
+            val mesh = meshes[handle] ?: continue
+            if (mesh.matrixWorldVersion != worldVersion[handle] ||
+                mesh.geometry.computeBoundingBox() !== boundsSource[handle]
+            ) {
+                writeWorldBounds(handle, mesh)
+            }
+        }
+    }
 
-        // Distance culling
-        val distanceCulled = if (enableDistance) {
-            frustumCulled.filter { mesh ->
-                val distance = camera.position.distanceTo(mesh.position)
-                distance <= maxRenderDistance
+    private fun finishCull(camera: Camera, frustumVisible: Int): List<Mesh> {
+        statistics.frustumCulled = statistics.totalObjects - frustumVisible
+        statistics.distanceCulled = 0
+        statistics.smallObjectCulled = 0
+        statistics.occlusionCulled = 0
+        visible.clear()
+
+        val cameraX = camera.position.x
+        val cameraY = camera.position.y
+        val cameraZ = camera.position.z
+        val maxDistanceSq = maxRenderDistance * maxRenderDistance
+        val fov = (camera as? io.materia.camera.PerspectiveCamera)?.fov ?: 50f
+        val fovRad = fov * (PI / 180f).toFloat()
+
+        for (i in 0 until frustumVisible) {
+            val handle = bvh.visibleHandle(i)
+            val dx = centerX[handle] - cameraX
+            val dy = centerY[handle] - cameraY
+            val dz = centerZ[handle] - cameraZ
+            val distanceSq = dx * dx + dy * dy + dz * dz
+
+            // Distance culling
+            if (enableDistance && distanceSq > maxDistanceSq) {
+                statistics.distanceCulled++
+                continue
             }
-        } else frustumCulled
-        statistics.distanceCulled = frustumCulled.size - distanceCulled.size
-
-        // Small object culling
-        val smallObjectCulled = if (enableSmallObject) {
-            distanceCulled.filter { mesh ->
-                val screenSize = calculateScreenSize(mesh, camera, viewProjection)
-                screenSize >= minObjectScreenSize
+
+            // Small object culling
+            if (enableSmallObject &&
+                calculateScreenSize(radius[handle], sqrt(distanceSq), fovRad) < minObjectScreenSize
+            ) {
+                statistics.smallObjectCulled++
+                continue
             }
-        } else distanceCulled
-        statistics.smallObjectCulled = distanceCulled.size - smallObjectCulled.size
-
-        // Occlusion culling
-        val finalVisible = if (enableOcclusion && hierarchicalZBuffer != null) {
-            smallObjectCulled.filter { mesh ->
-                val box = mesh.geometry.boundingBox ?: return@filter true
-                !hierarchicalZBuffer.isOccluded(box, viewProjection)
+
+            // Occlusion culling
+            if (hierarchicalZBuffer != null) {
+                val r = radius[handle]
+                occlusionBox.min.set(centerX[handle] - r, centerY[handle] - r, centerZ[handle] - r)
+                occlusionBox.max.set(centerX[handle] + r, centerY[handle] + r, centerZ[handle] + r)
+                if (hierarchicalZBuffer.isOccluded(occlusionBox, viewProjection)) {
+                    statistics.occlusionCulled++
+                    continue
+                }
             }
-        } else smallObjectCulled
-        statistics.occlusionCulled = smallObjectCulled.size - finalVisible.size
 
-        statistics.visibleObjects = finalVisible.size
+            visible.add(meshes[handle] ?: continue)
+        }
+
+        statistics.visibleObjects = visible.size
         statistics.frameEnd()
 
-        return finalVisible
+        return visible
     }
 
     /**
      * Calculate screen size of object
      */
-    private fun calculateScreenSize(mesh: Mesh, camera: Camera, viewProjection: Matrix4): Float {
-        val bounds = mesh.geometry.boundingBox ?: return Float.MAX_VALUE
-        val sphere = mesh.geometry.boundingSphere ?: return Float.MAX_VALUE
-
-        val distance = camera.position.distanceTo(mesh.position)
+    private fun calculateScreenSize(radius: Float, distance: Float, fovRad: Float): Float {
         if (distance <= 0) return Float.MAX_VALUE
 
         // Project bounding sphere to screen
-        val angularSize = 2f * atan(sphere.radius / distance)
+        val angularSize = 2f * atan(radius / distance)
         val screenHeight = 1080f // Default screen height, should be passed from renderer
-        val fov = (camera as? io.materia.camera.PerspectiveCamera)?.fov ?: 50f
-        val fovRad = fov * (PI / 180f).toFloat()
 
         return (angularSize / fovRad) * screenHeight
     }
 
+    /**
+     * Transform the geometry's local box by the mesh's world matrix (Arvo's method)
+     * and push the result into the BVH.
+     */
+    private fun writeWorldBounds(handle: Int, mesh: Mesh) {
+        val local = mesh.geometry.computeBoundingBox()
+        boundsSource[handle] = local
+        worldVersion[handle] = mesh.matrixWorldVersion
+
+        val e = mesh.matrixWorld.elements
+        var minX = e[12]
+        var minY = e[13]
+        var minZ = e[14]
+        var maxX = minX
+        var maxY = minY
+        var maxZ = minZ
+        if (!local.isEmpty()) {
+            for (axis in 0 until 3) {
+                val lo = when (axis) { 0 -> local.min.x; 1 -> local.min.y; else -> local.min.z }
+                val hi = when (axis) { 0 -> local.max.x; 1 -> local.max.y; else -> local.max.z }
+                val column = axis * 4
+
+                var a = e[column] * lo
+                var b = e[column] * hi
+                minX += min(a, b); maxX += max(a, b)
+                a = e[column + 1] * lo
+                b = e[column + 1] * hi
+                minY += min(a, b); maxY += max(a, b)
+                a = e[column + 2] * lo
+                b = e[column + 2] * hi
+                minZ += min(a, b); maxZ += max(a, b)
+            }
+        }
+
+        centerX[handle] = (minX + maxX) * 0.5f
+        centerY[handle] = (minY + maxY) * 0.5f
+        centerZ[handle] = (minZ + maxZ) * 0.5f
+        val hx = (maxX - minX) * 0.5f
+        val hy = (maxY - minY) * 0.5f
+        val hz = (maxZ - minZ) * 0.5f
+        radius[handle] = sqrt(hx * hx + hy * hy + hz * hz)
+
+        bvh.update(handle, minX, minY, minZ, maxX, maxY, maxZ)
+    }
+
+    private fun ensureCapacity(required: Int) {
+        if (required <= meshes.size) return
+        val capacity = max(required, meshes.size * 2)
+        meshes = meshes.copyOf(capacity)
+        boundsSource = boundsSource.copyOf(capacity)
+        worldVersion = worldVersion.copyOf(capacity)
+        centerX = centerX.copyOf(capacity)
+        centerY = centerY.copyOf(capacity)
+        centerZ = centerZ.copyOf(capacity)
+        radius = radius.copyOf(capacity)
+    }
+
     /**
      * Update occlusion buffer with rendered depth
      */
@@ -498,7 +562,11 @@ class CullingSystem(
      * Clear culling system
      */
     fun clear() {
-        octree.clear()
+        bvh.clear()
+        handles.clear()
+        meshes.fill(null)
+        boundsSource.fill(null)
+        visible.clear()
         hierarchicalZBuffer?.clear()
         statistics.reset()
     }
@@ -2,15 +2,11 @@ package io.materia.optimization
 
 import io.materia.camera.Camera
 import io.materia.core.math.*
-import io.materia.core.platform.currentTimeMillis
 import io.materia.core.scene.Material
 import io.materia.core.scene.Mesh
 import io.materia.core.scene.SpriteMaterial
 import io.materia.geometry.BufferGeometry
 import io.materia.renderer.Renderer
-import kotlinx.coroutines.*
-import kotlinx.coroutines.flow.Flow
-import kotlinx.coroutines.flow.flow
 import kotlin.math.PI
 import kotlin.random.Random
 
@@ -18,31 +14,92 @@ import kotlin.random.Random
 typealias Geometry = BufferGeometry
 
 /**
- * Instance data for a single instanced object
+ * Receives the instance data an [InstancedBatch] changed, to copy into GPU buffers.
  */
-data class InstanceData(
-    val id: String,
-    val transform: Matrix4,
-    val color: Color = Color.WHITE,
-    val customAttributes: Map<String, Any> = emptyMap(),
-    var visible: Boolean = true,
-    var culled: Boolean = false
-)
+interface InstanceUploadSink {
+    /**
+     * Instances `[firstInstance, firstInstance + instanceCount)` changed. Their matrices
+     * start at `firstInstance * 16` in [matrices] and their colors at `firstInstance * 4`
+     * in [colors]; the arrays are the batch's own storage and must not be kept.
+     */
+    fun writeInstances(firstInstance: Int, instanceCount: Int, matrices: FloatArray, colors: FloatArray)
+
+    /** The draw list changed; its first [drawCount] entries are instance indices. */
+    fun writeDrawIndices(indices: IntArray, drawCount: Int)
+}
 
 /**
  * Instanced mesh batch for efficient GPU rendering
+ *
+ * Instances are stored densely, structure-of-arrays: instance `i` of `[0, size)` owns
+ * `matrices[i * 16 until i * 16 + 16]` and `colors[i * 4 until i * 4 + 4]`, the same
+ * layout the GPU instance buffer uses. Callers hold integer handles; removal swap-removes
+ * the last instance into the hole, so an instance's index may change but its handle does not.
+ *
+ * Writes only mark the touched instances dirty; [flush] hands the sink the dirty indices
+ * coalesced into ranges, so updating a few percent of a large batch uploads only those.
+ * Culling and sorting leave the backing data alone and produce a compacted draw list of
+ * instance indices instead.
+ *
+ * @param mergeGap Clean instances a dirty range may span to join its neighbour, trading
+ *   upload bytes for fewer upload calls
  */
 class InstancedBatch(
     val geometry: Geometry,
     val material: Material,
-    val maxInstances: Int = 10000
+    val maxInstances: Int = 10000,
+    val mergeGap: Int = DEFAULT_MERGE_GAP
 ) {
-    private val instances = mutableListOf<InstanceData>()
-    private val instanceMatrices = FloatArray((maxInstances * 16))
-    private val instanceColors = FloatArray((maxInstances * 4))
-    private var dirty = true
-    private var sortingEnabled = false
-    private var sortingStrategy: SortingStrategy = SortingStrategy.NONE
+    init {
+        require(maxInstances > 0) { "maxInstances must be positive (was $maxInstances)" }
+        require(mergeGap >= 0) { "mergeGap must be non-negative (was $mergeGap)" }
+    }
+
+    /** Instance transforms, 16 floats (column-major) per instance. */
+    val matrices = FloatArray(maxInstances * 16)
+
+    /** Instance colors, RGBA per instance. */
+    val colors = FloatArray(maxInstances * 4)
+
+    private val sortKeys = IntArray(maxInstances)
+    private val hidden = BooleanArray(maxInstances)
+    private val culled = BooleanArray(maxInstances)
+    private val indexHandle = IntArray(maxInstances)
+
+    // Handle -> index, with a free list of released handles
+    private val handleIndex = IntArray(maxInstances)
+    private val freeHandles = IntArray(maxInstances)
+    private var freeHandleCount = 0
+    private var handleCount = 0
+
+    private val dirty = BooleanArray(maxInstances)
+    private val dirtyIndices = IntArray(maxInstances)
+    private var dirtyCount = 0
+
+    // Compacted indices of visible, unculled instances, in draw order
+    private val drawList = IntArray(maxInstances)
+    private var activeCount = 0
+    private var drawListStale = true
+    private var drawListChanged = true
+    private var sortScratch = LongArray(0)
+
+    /** Number of live instances. */
+    var size: Int = 0
+        private set
+
+    /** How [sortInstances] orders the draw list. */
+    var sortingStrategy: SortingStrategy = SortingStrategy.NONE
+
+    /**
+     * Where [flush] sends changes. Attaching a sink marks every instance dirty so it
+     * receives the whole batch once.
+     */
+    var uploadSink: InstanceUploadSink? = null
+        set(value) {
+            field = value
+            markAllDirty()
+            drawListChanged = true
+        }
 
     /**
      * Sorting strategies for instances
@@ -55,165 +112,311 @@ class InstancedBatch(
     }
 
     /**
-     * Add an instance to the batch
+     * Adds an instance and returns its handle, or -1 when the batch is full. [sortKey]
+     * orders instances under [SortingStrategy.BY_MATERIAL_STATE].
      */
-    fun addInstance(instance: InstanceData): Boolean {
-        if (instances.size >= maxInstances) {
-            return false
+    fun addInstance(transform: Matrix4, color: Color = Color.WHITE, sortKey: Int = 0): Int {
+        if (size >= maxInstances) {
+            return -1
         }
 
-        instances.add(instance)
-        dirty = true
-        return true
+        val handle = if (freeHandleCount > 0) freeHandles[--freeHandleCount] else handleCount++
+        val index = size++
+        handleIndex[handle] = index
+        indexHandle[index] = handle
+        sortKeys[index] = sortKey
+        hidden[index] = false
+        culled[index] = false
+        writeTransform(index, transform)
+        writeColor(index, color)
+        drawListStale = true
+        return handle
     }
 
     /**
-     * Remove an instance from the batch
+     * Removes [handle]'s instance by moving the last instance into its place; the handle
+     * may be reused by a later [addInstance]. Returns false for an unknown handle.
      */
-    fun removeInstance(id: String): Boolean {
-        val toRemove = instances.find { it.id == id }
-        val removed = if (toRemove != null) {
-            instances.remove(toRemove)
-        } else {
-            false
-        }
-        if (removed) {
-            dirty = true
+    fun removeInstance(handle: Int): Boolean {
+        if (!contains(handle)) return false
+        val index = handleIndex[handle]
+        val last = --size
+        if (index != last) {
+            matrices.copyInto(matrices, index * 16, last * 16, last * 16 + 16)
+            colors.copyInto(colors, index * 4, last * 4, last * 4 + 4)
+            sortKeys[index] = sortKeys[last]
+            hidden[index] = hidden[last]
+            culled[index] = culled[last]
+            val moved = indexHandle[last]
+            indexHandle[index] = moved
+            handleIndex[moved] = index
+            markDirty(index)
         }
-        return removed
+        handleIndex[handle] = REMOVED
+        freeHandles[freeHandleCount++] = handle
+        drawListStale = true
+        return true
     }
 
+    /** Whether [handle] names a live instance. */
+    fun contains(handle: Int): Boolean =
+        handle in 0 until handleCount && handleIndex[handle] != REMOVED
+
+    /** Current index of [handle]'s instance in [matrices] and [colors]. */
+    fun indexOf(handle: Int): Int = indexOfLive(handle)
+
     /**
      * Update instance transform
      */
-    fun updateInstance(id: String, transform: Matrix4) {
-        instances.find { it.id == id }?.let {
-            val index = instances.indexOf(it)
-            instances[index] = it.copy(transform = transform)
-            dirty = true
-        }
+    fun updateInstance(handle: Int, transform: Matrix4) {
+        writeTransform(indexOfLive(handle), transform)
+    }
+
+    fun updateColor(handle: Int, color: Color) {
+        writeColor(indexOfLive(handle), color)
+    }
+
+    fun setVisible(handle: Int, visible: Boolean) {
+        val index = indexOfLive(handle)
+        if (hidden[index] == !visible) return
+        hidden[index] = !visible
+        drawListStale = true
     }
 
     /**
-     * Update instance data buffers for GPU
+     * Sends the dirty instances to [uploadSink] as coalesced ranges, and the draw list when
+     * it changed. Without a sink nothing is sent and the changes stay pending. Returns the
+     * number of instances sent.
      */
-    fun updateBuffers() {
-        if (!dirty) return
-
-        instances.forEachIndexed { index, instance ->
-            if (!instance.culled && instance.visible) {
-                // Copy transform matrix
-                val matrixOffset = index * 16
-                instance.transform.toArray().forEachIndexed { i, value ->
-                    instanceMatrices[matrixOffset + i] = value
+    fun flush(): Int {
+        refreshDrawList()
+        val sink = uploadSink ?: return 0
+
+        var uploaded = 0
+        if (dirtyCount > 0) {
+            // Past half the batch, one upload of everything beats many small ones
+            if (dirtyCount > size / 2) {
+                if (size > 0) sink.writeInstances(0, size, matrices, colors)
+                uploaded = size
+            } else {
+                dirtyIndices.sort(0, dirtyCount)
+                var first = dirtyIndices[0]
+                var end = first + 1
+                for (i in 1 until dirtyCount) {
+                    val index = dirtyIndices[i]
+                    if (index >= size) continue
+                    if (index - end > mergeGap) {
+                        sink.writeInstances(first, end - first, matrices, colors)
+                        uploaded += end - first
+                        first = index
+                    }
+                    end = index + 1
+                }
+                if (first < size) {
+                    end = minOf(end, size)
+                    sink.writeInstances(first, end - first, matrices, colors)
+                    uploaded += end - first
                 }
-
-                // Copy color
-                val colorOffset = index * 4
-                instanceColors[colorOffset] = instance.color.r
-                instanceColors[colorOffset + 1] = instance.color.g
-                instanceColors[colorOffset + 2] = instance.color.b
-                instanceColors[colorOffset + 3] = 1.0f // Alpha always 1
             }
+            for (i in 0 until dirtyCount) dirty[dirtyIndices[i]] = false
+            dirtyCount = 0
         }
 
-        dirty = false
+        if (drawListChanged) {
+            sink.writeDrawIndices(drawList, activeCount)
+            drawListChanged = false
+        }
+        return uploaded
     }
 
     /**
-     * Sort instances based on strategy
+     * Orders the draw list by [sortingStrategy]; the instance data is not moved.
      */
     fun sortInstances(cameraPosition: Vector3) {
-        if (!sortingEnabled) return
-
-        when (sortingStrategy) {
-            SortingStrategy.FRONT_TO_BACK -> {
-                instances.sortBy { instance ->
-                    val position = instance.transform.extractTranslation()
-                    position.distanceTo(cameraPosition)
-                }
+        if (sortingStrategy == SortingStrategy.NONE) return
+        refreshDrawList()
+        val count = activeCount
+        if (count < 2) return
+        if (sortScratch.size < count) sortScratch = LongArray(maxOf(count, sortScratch.size * 2))
+
+        // Each entry packs an order-preserving key above the instance index
+        for (i in 0 until count) {
+            val index = drawList[i]
+            val key = when (sortingStrategy) {
+                SortingStrategy.FRONT_TO_BACK -> distanceSquared(index, cameraPosition).toRawBits().toLong()
+                SortingStrategy.BACK_TO_FRONT -> (Int.MAX_VALUE - distanceSquared(index, cameraPosition).toRawBits()).toLong()
+                SortingStrategy.BY_MATERIAL_STATE -> sortKeys[index].toLong()
+                SortingStrategy.NONE -> 0L
             }
-
-            SortingStrategy.BACK_TO_FRONT -> {
-                instances.sortByDescending { instance ->
-                    val position = instance.transform.extractTranslation()
-                    position.distanceTo(cameraPosition)
-                }
-            }
-
-            SortingStrategy.BY_MATERIAL_STATE -> {
-                // Sort by material properties to minimize state changes
-                instances.sortBy { it.customAttributes["materialOrder"] as? Int ?: 0 }
-            }
-
-            SortingStrategy.NONE -> {
-                // No sorting
+            sortScratch[i] = (key shl 32) or index.toLong()
+        }
+        sortScratch.sort(0, count)
+        for (i in 0 until count) {
+            val index = sortScratch[i].toInt()
+            if (drawList[i] != index) {
+                drawList[i] = index
+                drawListChanged = true
             }
         }
-
-        dirty = true
     }
 
     /**
-     * Perform frustum culling on instances
+     * Perform frustum culling on instances; [boundingBox] is the geometry's local bounds.
+     * Rebuilds the draw list from the instances that pass.
      */
     fun cullInstances(frustum: Frustum, boundingBox: BoundingBox) {
-        var culledCount = 0
-
-        instances.forEach { instance ->
-            val worldBounds = boundingBox.transform(instance.transform)
-            instance.culled = !frustum.intersectsBox(worldBounds)
-            if (instance.culled) culledCount++
-        }
-
-        if (culledCount > 0) {
-            dirty = true
+        val min = boundingBox.min
+        val max = boundingBox.max
+        for (index in 0 until size) {
+            culled[index] = !intersects(frustum, index, min.x, min.y, min.z, max.x, max.y, max.z)
         }
+        drawListStale = true
+        refreshDrawList()
     }
 
     /**
      * Get active instance count (visible and not culled)
      */
     fun getActiveCount(): Int {
-        return instances.count { it.visible && !it.culled }
+        refreshDrawList()
+        return activeCount
     }
 
+    /** Instance index at [position] of the draw list, `position < getActiveCount()`. */
+    fun drawIndex(position: Int): Int = drawList[position]
+
     /**
      * Get instance data arrays for rendering
      */
-    fun getInstanceData(): Pair<FloatArray, FloatArray> {
-        updateBuffers()
-        return instanceMatrices to instanceColors
-    }
+    fun getInstanceData(): Pair<FloatArray, FloatArray> = matrices to colors
 
     /**
      * Clear all instances
      */
     fun clear() {
-        instances.clear()
-        dirty = true
+        for (i in 0 until dirtyCount) dirty[dirtyIndices[i]] = false
+        dirtyCount = 0
+        size = 0
+        handleCount = 0
+        freeHandleCount = 0
+        activeCount = 0
+        drawListStale = false
+        drawListChanged = true
     }
 
     /**
      * Check if batch can accept more instances
      */
     fun hasCapacity(count: Int = 1): Boolean {
-        return instances.size + count <= maxInstances
+        return size + count <= maxInstances
+    }
+
+    private fun refreshDrawList() {
+        if (!drawListStale) return
+        var count = 0
+        for (index in 0 until size) {
+            if (!hidden[index] && !culled[index]) drawList[count++] = index
+        }
+        activeCount = count
+        drawListStale = false
+        drawListChanged = true
+    }
+
+    private fun writeTransform(index: Int, transform: Matrix4) {
+        transform.elements.copyInto(matrices, index * 16, 0, 16)
+        markDirty(index)
+    }
+
+    private fun writeColor(index: Int, color: Color) {
+        val offset = index * 4
+        colors[offset] = color.r
+        colors[offset + 1] = color.g
+        colors[offset + 2] = color.b
+        colors[offset + 3] = 1.0f // Alpha always 1
+        markDirty(index)
+    }
+
+    private fun markDirty(index: Int) {
+        if (dirty[index]) return
+        dirty[index] = true
+        dirtyIndices[dirtyCount++] = index
+    }
+
+    private fun markAllDirty() {
+        for (index in 0 until size) markDirty(index)
+    }
+
+    private fun indexOfLive(handle: Int): Int {
+        require(contains(handle)) { "Unknown instance handle $handle" }
+        return handleIndex[handle]
+    }
+
+    private fun distanceSquared(index: Int, camera: Vector3): Float {
+        val m = index * 16
+        val dx = matrices[m + 12] - camera.x
+        val dy = matrices[m + 13] - camera.y
+        val dz = matrices[m + 14] - camera.z
+        return dx * dx + dy * dy + dz * dz
+    }
+
+    // World AABB of the local box under the instance matrix (Arvo), then the frustum test
+    private fun intersects(
+        frustum: Frustum,
+        index: Int,
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float
+    ): Boolean {
+        val m = index * 16
+        var worldMinX = matrices[m + 12]
+        var worldMinY = matrices[m + 13]
+        var worldMinZ = matrices[m + 14]
+        var worldMaxX = worldMinX
+        var worldMaxY = worldMinY
+        var worldMaxZ = worldMinZ
+        for (column in 0 until 3) {
+            val lo = when (column) { 0 -> minX; 1 -> minY; else -> minZ }
+            val hi = when (column) { 0 -> maxX; 1 -> maxY; else -> maxZ }
+            val c = m + column * 4
+            for (row in 0 until 3) {
+                val a = matrices[c + row] * lo
+                val b = matrices[c + row] * hi
+                val low = minOf(a, b)
+                val high = maxOf(a, b)
+                when (row) {
+                    0 -> { worldMinX += low; worldMaxX += high }
+                    1 -> { worldMinY += low; worldMaxY += high }
+                    else -> { worldMinZ += low; worldMaxZ += high }
+                }
+            }
+        }
+        return frustum.intersectsBox(worldMinX, worldMinY, worldMinZ, worldMaxX, worldMaxY, worldMaxZ)
+    }
+
+    companion object {
+        const val DEFAULT_MERGE_GAP = 8
+        private const val REMOVED = -1
     }
 }
 
 /**
  * Instance manager for efficient GPU instancing
+ *
+ * Instance handles are integers valid across all of the manager's batches; each maps to
+ * its batch and that batch's own handle.
  */
 class InstanceManager(
     private val renderer: Renderer,
-    private val autoBatchThreshold: Int = 100,
     private val maxInstancesPerBatch: Int = 10000
 ) {
     private val batches = mutableMapOf<String, InstancedBatch>()
     private val meshToBatch = mutableMapOf<Mesh, String>()
     private val statistics = InstanceStatistics()
-    private val batchingScope = CoroutineScope(Dispatchers.Default)
+
+    // Manager handle -> batch and batch handle, with a free list of released handles
+    private val handleBatch = ArrayList<InstancedBatch?>()
+    private var handleLocal = IntArray(64)
+    private var freeHandles = IntArray(16)
+    private var freeHandleCount = 0
 
     /**
      * Register mesh for instancing
@@ -223,7 +426,7 @@ class InstanceManager(
         val batchKey = generateBatchKey(mesh.geometry, material)
 
         // Find or create batch
-        val batch = batches.getOrPut(batchKey) {
+        batches.getOrPut(batchKey) {
             InstancedBatch(
                 geometry = mesh.geometry,
                 material = material,
@@ -238,39 +441,28 @@ class InstanceManager(
     }
 
     /**
-     * Add instance of a mesh
+     * Add instance of a mesh; returns its handle, or -1 when it could not be placed.
      */
     fun addInstance(
         mesh: Mesh,
         transform: Matrix4,
         color: Color = Color.WHITE,
-        customAttributes: Map<String, Any> = emptyMap()
-    ): String? {
+        sortKey: Int = 0
+    ): Int {
         val batchKey = meshToBatch[mesh] ?: registerMesh(mesh)
-        val batch = batches[batchKey] ?: return null
-
-        val instanceId = generateInstanceId()
-        val instance = InstanceData(
-            id = instanceId,
-            transform = transform,
-            color = color,
-            customAttributes = customAttributes
-        )
-
-        if (batch.addInstance(instance)) {
-            statistics.totalInstances++
-            checkAutoBatching(batchKey)
-            return instanceId
-        }
-
-        // Batch full, try to create new batch
-        val newBatch = createOverflowBatch(mesh)
-        if (newBatch?.addInstance(instance) == true) {
-            statistics.totalInstances++
-            return instanceId
+        val batch = batches[batchKey] ?: return -1
+
+        var local = batch.addInstance(transform, color, sortKey)
+        var target = batch
+        if (local < 0) {
+            // Batch full, try to create new batch
+            target = createOverflowBatch(mesh) ?: return -1
+            local = target.addInstance(transform, color, sortKey)
+            if (local < 0) return -1
         }
 
-        return null
+        statistics.totalInstances++
+        return allocateHandle(target, local)
     }
 
     /**
@@ -310,38 +502,26 @@ class InstanceManager(
     /**
      * Remove instance
      */
-    fun removeInstance(instanceId: String): Boolean {
-        batches.values.forEach { batch ->
-            if (batch.removeInstance(instanceId)) {
-                statistics.totalInstances--
-                return true
-            }
-        }
-        return false
+    fun removeInstance(handle: Int): Boolean {
+        val batch = handleBatch.getOrNull(handle) ?: return false
+        batch.removeInstance(handleLocal[handle])
+        handleBatch[handle] = null
+        if (freeHandleCount == freeHandles.size) freeHandles = freeHandles.copyOf(freeHandleCount * 2)
+        freeHandles[freeHandleCount++] = handle
+        statistics.totalInstances--
+        return true
     }
 
     /**
      * Update instance transform
      */
-    fun updateInstanceTransform(instanceId: String, transform: Matrix4) {
-        batches.values.forEach { batch ->
-            batch.updateInstance(instanceId, transform)
-        }
+    fun updateInstanceTransform(handle: Int, transform: Matrix4) {
+        val batch = handleBatch.getOrNull(handle) ?: return
+        batch.updateInstance(handleLocal[handle], transform)
     }
 
-    /**
-     * Stream instance data for dynamic updates
-     */
-    fun streamInstanceData(): Flow<List<InstanceData>> = flow {
-        while (currentCoroutineContext().isActive) {
-            val allInstances = batches.values.flatMap { batch ->
-                // Get instances from batch (would need to expose this)
-                emptyList<InstanceData>()
-            }
-            emit(allInstances)
-            delay(16) // ~60 FPS
-        }
-    }
+    /** Batch holding [handle]'s instance, or null for an unknown handle. */
+    fun batchOf(handle: Int): InstancedBatch? = handleBatch.getOrNull(handle)
 
     /**
      * Perform frustum culling on all batches
@@ -361,35 +541,7 @@ class InstanceManager(
     }
 
     /**
-     * Check and perform automatic batching
-     */
-    private fun checkAutoBatching(batchKey: String) {
-        val batch = batches[batchKey] ?: return
-        val activeCount = batch.getActiveCount()
-
-        if (activeCount >= autoBatchThreshold) {
-            // Trigger automatic batching optimization
-            batchingScope.launch {
-                optimizeBatch(batch)
-            }
-        }
-    }
-
-    /**
-     * Optimize batch for better performance
-     */
-    private suspend fun optimizeBatch(batch: InstancedBatch) = withContext(Dispatchers.Default) {
-        // Sort instances for better GPU cache coherency
-        batch.sortInstances(Vector3(0f, 0f, 0f)) // Use camera position in real scenario
-
-        // Update buffers
-        batch.updateBuffers()
-
-        statistics.recordOptimization()
-    }
-
-    /**
-     * Render all instance batches
+     * Sorts each batch's draw list and sends its pending changes to its upload sink.
      */
     fun render(renderer: Renderer, camera: Camera) {
         statistics.frameStart()
@@ -400,16 +552,14 @@ class InstanceManager(
                 // Sort if needed
                 batch.sortInstances(camera.position)
 
-                // Get instance data
-                val (matrices, colors) = batch.getInstanceData()
+                // Upload changed instance ranges
+                batch.flush()
 
                 // Render instanced geometry via GPU instancing
                 // GPU instancing support requires WebGPU/Vulkan renderer integration
                 // renderer.renderInstanced(
                 //     geometry = batch.geometry,
                 //     material = batch.material,
-                //     instanceMatrices = matrices,
-                //     instanceColors = colors,
                 //     instanceCount = activeCount
                 // )
 
@@ -427,11 +577,16 @@ class InstanceManager(
         return "${geometry.hashCode()}_${material.hashCode()}"
     }
 
-    /**
-     * Generate unique instance ID
-     */
-    private fun generateInstanceId(): String {
-        return "instance_${currentTimeMillis()}_${(Random.nextFloat() * 10000).toInt()}"
+    private fun allocateHandle(batch: InstancedBatch, local: Int): Int {
+        val handle = if (freeHandleCount > 0) {
+            freeHandles[--freeHandleCount].also { handleBatch[it] = batch }
+        } else {
+            handleBatch.add(batch)
+            handleBatch.size - 1
+        }
+        if (handle >= handleLocal.size) handleLocal = handleLocal.copyOf(maxOf(handle + 1, handleLocal.size * 2))
+        handleLocal[handle] = local
+        return handle
     }
 
     /**
@@ -446,6 +601,8 @@ class InstanceManager(
         batches.values.forEach { it.clear() }
         batches.clear()
         meshToBatch.clear()
+        handleBatch.clear()
+        freeHandleCount = 0
         statistics.reset()
     }
 }
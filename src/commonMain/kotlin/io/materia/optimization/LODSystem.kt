@@ -5,6 +5,7 @@ import io.materia.camera.PerspectiveCamera
 import io.materia.core.math.Vector3
 import io.materia.core.scene.Mesh
 import io.materia.geometry.BufferGeometry
+import io.materia.geometry.processing.MeshSimplifier
 import io.materia.renderer.Renderer
 import kotlinx.coroutines.*
 import kotlin.math.PI
@@ -105,14 +106,7 @@ class LODGroup(
 
     private fun findLevelByScreenSpaceError(camera: Camera, position: Vector3): Int {
         val screenSize = calculateScreenSize(camera, position)
-
-        for (i in levels.indices) {
-            val error = levels[i].screenSpaceError
-            if (screenSize >= error) {
-                return i
-            }
-        }
-        return levels.size - 1
+        return LODUtils.levelForScreenSize(screenSize, levels.size) { levels[it].screenSpaceError }
     }
 
     private fun calculateScreenSize(camera: Camera, position: Vector3): Float {
@@ -125,21 +119,7 @@ class LODGroup(
             else -> camera.getEffectiveFOV()
         } * (PI / 180.0).toFloat()
 
-        val screenHeight = 1080f // Default screen height
-
-        // Check for division by zero - distance and tan(fov/2) must not be zero
-        if (kotlin.math.abs(distance) < io.materia.core.math.EPSILON) {
-            return Float.MAX_VALUE // Object is at camera position, use highest detail
-        }
-
-        val tanHalfFov = tan(fov / 2.0f)
-        if (kotlin.math.abs(tanHalfFov) < io.materia.core.math.EPSILON) {
-            return 0.0f // Invalid FOV, return minimum size
-        }
-
-        val projectedSize = (boundingRadius / distance) * (screenHeight / (2.0f * tanHalfFov))
-
-        return projectedSize
+        return LODUtils.projectedSize(boundingRadius, distance, LODUtils.projectionScale(fov))
     }
 
     private fun startTransition(from: Int, to: Int) {
@@ -261,33 +241,11 @@ class LODSystem(
     }
 
     /**
-     * Simplify geometry using edge collapse decimation
+     * Simplify geometry using quadric edge collapse decimation
      */
     private fun simplifyGeometry(geometry: BufferGeometry, targetRatio: Float): BufferGeometry {
-        // Mesh decimation using simplified index reduction
-        // Full implementation would use quadric error metrics for optimal quality
-        val positionAttribute = geometry.getAttribute("position")
-        val currentVertexCount = positionAttribute?.count ?: 0
-        val targetVertexCount = (currentVertexCount * targetRatio).toInt()
-
-        // Clone and reduce geometry
-        val simplified = geometry.clone()
-
-        // Reduction using indexed geometry decimation
-        if (targetRatio < 0.5f) {
-            // Aggressive simplification using index skipping for rapid LOD generation
-            val indexAttribute = simplified.index
-            if (indexAttribute != null) {
-                val skipFactor = (1.0f / targetRatio).toInt()
-                val newIndices = mutableListOf<Int>()
-                for (i in 0 until indexAttribute.count step skipFactor) {
-                    newIndices.add(indexAttribute.getX(i).toInt())
-                }
-                // This would need proper re-indexing
-            }
-        }
-
-        return simplified
+        val targetTriangleCount = (geometry.getTriangleCount() * targetRatio).toInt()
+        return MeshSimplifier().simplifyGeometry(geometry, targetTriangleCount)
     }
 
     /**
@@ -382,6 +340,46 @@ class LODStatistics {
  * LOD utilities for common operations
  */
 object LODUtils {
+    /** Screen height the screen-space error thresholds are expressed against. */
+    const val DEFAULT_SCREEN_HEIGHT = 1080f
+
+    /**
+     * Pixels per unit of `radius / distance` for a vertical field of view of [fovRadians],
+     * or 0 for a degenerate field of view.
+     */
+    fun projectionScale(fovRadians: Float, screenHeight: Float = DEFAULT_SCREEN_HEIGHT): Float {
+        val tanHalfFov = tan(fovRadians / 2.0f)
+        if (kotlin.math.abs(tanHalfFov) < io.materia.core.math.EPSILON) {
+            return 0.0f // Invalid FOV, return minimum size
+        }
+        return screenHeight / (2.0f * tanHalfFov)
+    }
+
+    /**
+     * Projected screen size of a bounding sphere, the metric screen-space error LOD selects
+     * by. GPU culling evaluates the same expression, so both paths pick the same level.
+     */
+    fun projectedSize(boundingRadius: Float, distance: Float, projectionScale: Float): Float {
+        // Check for division by zero - distance must not be zero
+        if (kotlin.math.abs(distance) < io.materia.core.math.EPSILON) {
+            return Float.MAX_VALUE // Object is at camera position, use highest detail
+        }
+        return (boundingRadius / distance) * projectionScale
+    }
+
+    /**
+     * First of [levelCount] levels whose threshold (from [screenSpaceError]) the
+     * [screenSize] reaches, or the last level when none does.
+     */
+    inline fun levelForScreenSize(screenSize: Float, levelCount: Int, screenSpaceError: (Int) -> Float): Int {
+        for (i in 0 until levelCount) {
+            if (screenSize >= screenSpaceError(i)) {
+                return i
+            }
+        }
+        return levelCount - 1
+    }
+
     /**
      * Calculate optimal LOD distances based on object size
      */
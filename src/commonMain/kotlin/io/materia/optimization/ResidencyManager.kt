@@ -0,0 +1,341 @@
+package io.materia.optimization
+
+import io.materia.profiling.MemoryAllocationType
+import kotlin.math.floor
+import kotlin.math.log2
+import kotlin.math.max
+
+/**
+ * Keeps GPU-resident geometry and textures inside a memory budget.
+ *
+ * Renderers [register] each resource when they upload it and [touch] it whenever a frame
+ * draws it. Resources are kept in least-recently-used order; when an upload would exceed
+ * [budgetBytes], the coldest resources that have not been drawn for [evictionDelayFrames]
+ * frames are evicted through their `onEvict` callback, which must release the GPU objects
+ * and drop them from the owner's cache so they are uploaded again on next use.
+ *
+ * Mipmapped textures registered with [registerTexture] keep only the levels from their
+ * resident level down to the smallest. [touch] records the finest level a draw needs
+ * (see [mipForScreenSize]); [endFrame] streams finer levels in for textures drawn this
+ * frame while the budget allows and, under pressure, drops levels finer than any draw
+ * asked for. Both are reported through `onResidentLevelChanged`.
+ *
+ * Resources drawn in the current frame are never evicted, so a single frame that needs
+ * more than the budget overshoots it rather than thrashing; [stats] shows the overshoot.
+ * The manager is not thread-safe and is meant to be driven from the render loop:
+ * [beginFrame], the frame's uploads and touches, then [endFrame] after submission.
+ *
+ * @param budgetBytes GPU memory the tracked resources may use.
+ * @param evictionDelayFrames Frames a resource must go undrawn before it may be evicted;
+ *   at least 1, and at least the number of frames the backend keeps in flight.
+ * @param streamInBytesPerFrame Upper bound on bytes of finer mip levels granted per frame.
+ */
+class ResidencyManager(
+    budgetBytes: Long,
+    val evictionDelayFrames: Int = 2,
+    val streamInBytesPerFrame: Long = Long.MAX_VALUE
+) {
+    private class Entry(
+        val key: Any,
+        val type: MemoryAllocationType,
+        val levelBytes: LongArray,
+        var residentLevel: Int,
+        val onResidentLevelChanged: ((Int) -> Unit)?,
+        val onEvict: () -> Unit
+    ) {
+        var bytes = 0L
+        var lastUsedFrame = 0L
+        var demandedLevel = 0
+        var prev: Entry? = null
+        var next: Entry? = null
+
+        fun bytesFrom(level: Int): Long {
+            var total = 0L
+            for (i in level until levelBytes.size) total += levelBytes[i]
+            return total
+        }
+    }
+
+    private val entries = HashMap<Any, Entry>()
+
+    // Least recently used at the head; touching moves an entry to the tail, so the list
+    // is ordered by lastUsedFrame
+    private var head: Entry? = null
+    private var tail: Entry? = null
+
+    private val bytesByType = LongArray(MemoryAllocationType.values().size)
+    private var evictionCount = 0L
+    private var evictedBytes = 0L
+    private var streamedBytes = 0L
+
+    /** GPU memory the tracked resources may use. Lowering it takes effect at [endFrame]. */
+    var budgetBytes: Long = budgetBytes
+        set(value) {
+            require(value > 0) { "Residency budget must be positive" }
+            field = value
+        }
+
+    /** Current frame number, advanced by [beginFrame]. */
+    var frame: Long = 0L
+        private set
+
+    /** Bytes held by all registered resources. */
+    var usedBytes: Long = 0L
+        private set
+
+    /** Number of registered resources. */
+    val residentCount: Int get() = entries.size
+
+    init {
+        require(budgetBytes > 0) { "Residency budget must be positive" }
+        require(evictionDelayFrames >= 1) { "Eviction delay must be at least one frame" }
+        require(streamInBytesPerFrame > 0) { "Stream-in allowance must be positive" }
+    }
+
+    /**
+     * Tracks a freshly uploaded resource of [bytes] as used in the current frame, first
+     * evicting cold resources to make room for it. Re-registering a key replaces it.
+     */
+    fun register(key: Any, type: MemoryAllocationType, bytes: Long, onEvict: () -> Unit) {
+        require(bytes >= 0) { "Resource size must not be negative" }
+        add(Entry(key, type, longArrayOf(bytes), 0, null, onEvict))
+    }
+
+    /**
+     * Tracks a mipmapped texture whose levels [residentLevel] and smaller are uploaded.
+     * [levelBytes] holds the size of every level, finest first.
+     */
+    fun registerTexture(
+        key: Any,
+        levelBytes: LongArray,
+        residentLevel: Int,
+        onResidentLevelChanged: (Int) -> Unit,
+        onEvict: () -> Unit
+    ) {
+        require(levelBytes.isNotEmpty()) { "Texture needs at least one level" }
+        require(residentLevel in levelBytes.indices) { "Resident level $residentLevel outside 0..${levelBytes.size - 1}" }
+        add(
+            Entry(key, MemoryAllocationType.TEXTURE, levelBytes.copyOf(), residentLevel, onResidentLevelChanged, onEvict)
+        )
+    }
+
+    /**
+     * Marks [key] as drawn this frame, needing mip levels down to [demandedLevel].
+     * Returns false when the key is not resident and must be uploaded again.
+     */
+    fun touch(key: Any, demandedLevel: Int = 0): Boolean {
+        val entry = entries[key] ?: return false
+        val level = demandedLevel.coerceIn(0, entry.levelBytes.size - 1)
+        entry.demandedLevel = if (entry.lastUsedFrame == frame) minOf(entry.demandedLevel, level) else level
+        entry.lastUsedFrame = frame
+        if (entry !== tail) {
+            unlink(entry)
+            append(entry)
+        }
+        return true
+    }
+
+    /** Finest resident mip level of [key], or -1 when it is not resident. */
+    fun residentLevel(key: Any): Int = entries[key]?.residentLevel ?: -1
+
+    operator fun contains(key: Any): Boolean = key in entries
+
+    /** Stops tracking [key] without calling its eviction callback; for owners freeing it themselves. */
+    fun unregister(key: Any) {
+        entries.remove(key)?.let(::detach)
+    }
+
+    /** Starts a new frame. */
+    fun beginFrame() {
+        frame++
+    }
+
+    /**
+     * Settles the frame: evicts cold resources and trims over-detailed textures while over
+     * budget, then streams in the finer levels that this frame's draws asked for.
+     */
+    fun endFrame() {
+        if (usedBytes > budgetBytes) {
+            evictCold(usedBytes - budgetBytes)
+        }
+        if (usedBytes > budgetBytes) {
+            trimUnneededLevels()
+        }
+        streamIn()
+    }
+
+    /** Evicts every resource; for device loss or teardown. */
+    fun evictAll() {
+        while (true) {
+            val entry = head ?: break
+            evict(entry)
+        }
+    }
+
+    /** Forgets every resource without calling eviction callbacks; for owners dropping their caches. */
+    fun clear() {
+        entries.clear()
+        head = null
+        tail = null
+        usedBytes = 0L
+        bytesByType.fill(0L)
+    }
+
+    /** Snapshot of budget use and eviction counters. */
+    fun stats(): ResidencyStats = ResidencyStats(
+        budgetBytes = budgetBytes,
+        usedBytes = usedBytes,
+        residentCount = entries.size,
+        bytesByType = MemoryAllocationType.values()
+            .filter { bytesByType[it.ordinal] > 0 }
+            .associateWith { bytesByType[it.ordinal] },
+        evictionCount = evictionCount,
+        evictedBytes = evictedBytes,
+        streamedBytes = streamedBytes
+    )
+
+    private fun add(entry: Entry) {
+        entries.remove(entry.key)?.let(::detach)
+        entry.bytes = entry.bytesFrom(entry.residentLevel)
+        entry.lastUsedFrame = frame
+        entry.demandedLevel = entry.residentLevel
+        evictCold(usedBytes + entry.bytes - budgetBytes)
+        entries[entry.key] = entry
+        append(entry)
+        account(entry, entry.bytes)
+    }
+
+    /** Evicts coldest-first until [needed] bytes are freed or only recent resources remain. */
+    private fun evictCold(needed: Long) {
+        var freed = 0L
+        while (freed < needed) {
+            val entry = head ?: return
+            if (frame - entry.lastUsedFrame < evictionDelayFrames) return
+            freed += entry.bytes
+            evict(entry)
+        }
+    }
+
+    private fun evict(entry: Entry) {
+        entries.remove(entry.key)
+        detach(entry)
+        evictionCount++
+        evictedBytes += entry.bytes
+        entry.onEvict()
+    }
+
+    /** Drops mip levels finer than the last demand, coldest textures first. */
+    private fun trimUnneededLevels() {
+        var entry = head
+        while (entry != null && usedBytes > budgetBytes) {
+            val next = entry.next
+            if (entry.onResidentLevelChanged != null && entry.residentLevel < entry.demandedLevel) {
+                changeLevel(entry, entry.demandedLevel)
+            }
+            entry = next
+        }
+    }
+
+    /** Grants finer levels to this frame's textures, most recently drawn first. */
+    private fun streamIn() {
+        var allowance = streamInBytesPerFrame
+        var entry = tail
+        while (entry != null && entry.lastUsedFrame == frame && allowance > 0) {
+            val previous = entry.prev
+            if (entry.onResidentLevelChanged != null && entry.demandedLevel < entry.residentLevel) {
+                // Finest level between the demand and what is resident that fits
+                var level = entry.demandedLevel
+                while (level < entry.residentLevel) {
+                    val extra = entry.bytesFrom(level) - entry.bytes
+                    if (extra <= allowance) {
+                        if (usedBytes + extra > budgetBytes) evictCold(usedBytes + extra - budgetBytes)
+                        if (usedBytes + extra <= budgetBytes) break
+                    }
+                    level++
+                }
+                if (level < entry.residentLevel) {
+                    val extra = entry.bytesFrom(level) - entry.bytes
+                    allowance -= extra
+                    streamedBytes += extra
+                    changeLevel(entry, level)
+                }
+            }
+            entry = previous
+        }
+    }
+
+    private fun changeLevel(entry: Entry, level: Int) {
+        val bytes = entry.bytesFrom(level)
+        account(entry, bytes - entry.bytes)
+        entry.bytes = bytes
+        entry.residentLevel = level
+        entry.onResidentLevelChanged?.invoke(level)
+    }
+
+    private fun account(entry: Entry, delta: Long) {
+        usedBytes += delta
+        bytesByType[entry.type.ordinal] += delta
+    }
+
+    private fun detach(entry: Entry) {
+        unlink(entry)
+        account(entry, -entry.bytes)
+    }
+
+    private fun append(entry: Entry) {
+        entry.prev = tail
+        entry.next = null
+        tail?.next = entry
+        tail = entry
+        if (head == null) head = entry
+    }
+
+    private fun unlink(entry: Entry) {
+        val prev = entry.prev
+        val next = entry.next
+        if (prev != null) prev.next = next else head = next
+        if (next != null) next.prev = prev else tail = prev
+        entry.prev = null
+        entry.next = null
+    }
+
+    companion object {
+        /**
+         * Finest mip level a [textureWidth] x [textureHeight] texture needs when it covers
+         * about [screenWidth] x [screenHeight] pixels: the level whose texels are no
+         * smaller than a pixel, clamped to the texture's [levelCount] levels.
+         */
+        fun mipForScreenSize(
+            textureWidth: Int,
+            textureHeight: Int,
+            screenWidth: Float,
+            screenHeight: Float,
+            levelCount: Int
+        ): Int {
+            val coarsest = max(levelCount - 1, 0)
+            if (screenWidth <= 0f || screenHeight <= 0f) return coarsest
+            val ratio = max(textureWidth / screenWidth, textureHeight / screenHeight)
+            if (ratio <= 1f) return 0
+            return floor(log2(ratio)).toInt().coerceIn(0, coarsest)
+        }
+    }
+}
+
+/**
+ * Budget use reported by [ResidencyManager.stats].
+ *
+ * @property evictionCount Resources evicted since the manager was created.
+ * @property evictedBytes Bytes released by those evictions.
+ * @property streamedBytes Bytes of finer mip levels streamed in.
+ */
+data class ResidencyStats(
+    val budgetBytes: Long,
+    val usedBytes: Long,
+    val residentCount: Int,
+    val bytesByType: Map<MemoryAllocationType, Long>,
+    val evictionCount: Long,
+    val evictedBytes: Long,
+    val streamedBytes: Long
+) {
+    val overBudget: Boolean get() = usedBytes > budgetBytes
+}
@@ -0,0 +1,359 @@
+package io.materia.physics
+
+import io.materia.optimization.CullingBvh
+import kotlin.math.max
+
+/**
+ * Broadphase collision detection: one axis-aligned box per proxy, reported as
+ * candidate pairs and query hits for the narrowphase to confirm.
+ *
+ * Proxies are small integer ids that may be reused after [destroyProxy]. Callbacks must
+ * not modify the broadphase or start another query while it is being traversed.
+ */
+interface Broadphase {
+    /** Number of live proxies. */
+    val size: Int
+
+    fun createProxy(minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float): Int
+
+    fun moveProxy(proxy: Int, minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float)
+
+    fun destroyProxy(proxy: Int)
+
+    fun clear()
+
+    /** Reports every pair of overlapping proxies once, with the smaller id first. */
+    fun findPairs(callback: PairCallback)
+
+    /** Reports every proxy whose box overlaps the given box. */
+    fun query(minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float, callback: ProxyCallback)
+
+    /**
+     * Reports proxies whose box the ray `origin + t * direction`, t in `[0, maxDistance]`,
+     * crosses. [callback] returns the new maximum distance; implementations may use it
+     * to skip proxies behind the closest hit.
+     */
+    fun raycast(
+        originX: Float, originY: Float, originZ: Float,
+        directionX: Float, directionY: Float, directionZ: Float,
+        maxDistance: Float,
+        callback: RayCallback
+    )
+
+    fun interface PairCallback {
+        fun pair(proxyA: Int, proxyB: Int)
+    }
+
+    fun interface ProxyCallback {
+        fun proxy(proxy: Int)
+    }
+
+    fun interface RayCallback {
+        fun hit(proxy: Int, entryDistance: Float): Float
+    }
+
+    companion object {
+        /**
+         * Creates the broadphase implementing [type]. Tree-style types (and those this
+         * engine has no dedicated implementation for) get an [AabbTreeBroadphase];
+         * sweep-style types get a [SweepAndPruneBroadphase].
+         */
+        fun create(type: BroadphaseType): Broadphase = when (type) {
+            BroadphaseType.SAP,
+            BroadphaseType.AXIS_SWEEP_3,
+            BroadphaseType.SORT_AND_SWEEP -> SweepAndPruneBroadphase()
+
+            BroadphaseType.SIMPLE,
+            BroadphaseType.DBVT,
+            BroadphaseType.DYNAMIC_AABB_TREE,
+            BroadphaseType.HASH_GRID,
+            BroadphaseType.SPATIAL_HASH -> AabbTreeBroadphase()
+        }
+    }
+}
+
+/**
+ * Dynamic AABB tree broadphase backed by [CullingBvh].
+ *
+ * Moving a proxy refits its leaf; the tree is rebuilt only after proxies are added or
+ * enough are removed. Pairs come from one box query per proxy, so a step costs
+ * O(n log n) rather than the O(n²) of testing every pair.
+ */
+class AabbTreeBroadphase(leafSize: Int = CullingBvh.DEFAULT_LEAF_SIZE) : Broadphase {
+    private val tree = CullingBvh(leafSize = leafSize)
+
+    // Proxy bounds by handle, kept for the per-proxy pair queries
+    private var bounds = FloatArray(64 * 6)
+    private var alive = BooleanArray(64)
+    private var handleLimit = 0
+
+    override val size: Int
+        get() = tree.size
+
+    override fun createProxy(minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float): Int {
+        val proxy = tree.insert(minX, minY, minZ, maxX, maxY, maxZ)
+        if (proxy >= alive.size) {
+            val capacity = max(proxy + 1, alive.size * 2)
+            alive = alive.copyOf(capacity)
+            bounds = bounds.copyOf(capacity * 6)
+        }
+        alive[proxy] = true
+        handleLimit = max(handleLimit, proxy + 1)
+        writeBounds(proxy, minX, minY, minZ, maxX, maxY, maxZ)
+        return proxy
+    }
+
+    override fun moveProxy(proxy: Int, minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float) {
+        tree.update(proxy, minX, minY, minZ, maxX, maxY, maxZ)
+        writeBounds(proxy, minX, minY, minZ, maxX, maxY, maxZ)
+    }
+
+    override fun destroyProxy(proxy: Int) {
+        tree.remove(proxy)
+        alive[proxy] = false
+    }
+
+    override fun clear() {
+        tree.clear()
+        alive.fill(false)
+        handleLimit = 0
+    }
+
+    override fun findPairs(callback: Broadphase.PairCallback) {
+        for (proxy in 0 until handleLimit) {
+            if (!alive[proxy]) continue
+            val b = proxy * 6
+            tree.query(bounds[b], bounds[b + 1], bounds[b + 2], bounds[b + 3], bounds[b + 4], bounds[b + 5]) { other ->
+                if (other > proxy) callback.pair(proxy, other)
+            }
+        }
+    }
+
+    override fun query(
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float,
+        callback: Broadphase.ProxyCallback
+    ) {
+        tree.query(minX, minY, minZ, maxX, maxY, maxZ) { callback.proxy(it) }
+    }
+
+    override fun raycast(
+        originX: Float, originY: Float, originZ: Float,
+        directionX: Float, directionY: Float, directionZ: Float,
+        maxDistance: Float,
+        callback: Broadphase.RayCallback
+    ) {
+        tree.raycast(originX, originY, originZ, directionX, directionY, directionZ, maxDistance) { handle, entry ->
+            callback.hit(handle, entry)
+        }
+    }
+
+    private fun writeBounds(proxy: Int, minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float) {
+        val b = proxy * 6
+        bounds[b] = minX
+        bounds[b + 1] = minY
+        bounds[b + 2] = minZ
+        bounds[b + 3] = maxX
+        bounds[b + 4] = maxY
+        bounds[b + 5] = maxZ
+    }
+}
+
+/**
+ * Sweep-and-prune broadphase over box endpoints on the x axis.
+ *
+ * Proxies are kept sorted by their minimum x with an insertion sort, which is close to
+ * linear when bodies move a little between steps. [findPairs] sweeps that order and
+ * only tests y and z for proxies whose x intervals overlap. Best for many bodies spread
+ * along x; heavily clustered scenes are better served by [AabbTreeBroadphase].
+ */
+class SweepAndPruneBroadphase(initialCapacity: Int = 64) : Broadphase {
+    init {
+        require(initialCapacity > 0) { "initialCapacity must be positive (was $initialCapacity)" }
+    }
+
+    private var bounds = FloatArray(initialCapacity * 6)
+    private var alive = BooleanArray(initialCapacity)
+    private var inOrder = BooleanArray(initialCapacity)
+    private var freeProxies = IntArray(initialCapacity)
+    private var freeCount = 0
+    private var proxyLimit = 0
+
+    // Live proxies ordered by min x, as of the last sort
+    private var order = IntArray(initialCapacity)
+    private var orderCount = 0
+    private var orderDirty = false
+
+    // Widest x extent among live proxies, bounding how far back a query must look
+    private var maxWidth = 0f
+
+    override var size: Int = 0
+        private set
+
+    override fun createProxy(minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float): Int {
+        val proxy = if (freeCount > 0) {
+            freeProxies[--freeCount]
+        } else {
+            if (proxyLimit == alive.size) grow()
+            proxyLimit++
+        }
+        alive[proxy] = true
+        writeBounds(proxy, minX, minY, minZ, maxX, maxY, maxZ)
+        // A reused id may still hold its slot in the order from before it was destroyed
+        if (!inOrder[proxy]) {
+            if (orderCount == order.size) order = order.copyOf(orderCount * 2)
+            order[orderCount++] = proxy
+            inOrder[proxy] = true
+        }
+        orderDirty = true
+        size++
+        return proxy
+    }
+
+    override fun moveProxy(proxy: Int, minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float) {
+        require(alive[proxy]) { "Unknown proxy $proxy" }
+        writeBounds(proxy, minX, minY, minZ, maxX, maxY, maxZ)
+        orderDirty = true
+    }
+
+    override fun destroyProxy(proxy: Int) {
+        require(alive[proxy]) { "Unknown proxy $proxy" }
+        alive[proxy] = false
+        if (freeCount == freeProxies.size) freeProxies = freeProxies.copyOf(freeCount * 2)
+        freeProxies[freeCount++] = proxy
+        size--
+        orderDirty = true
+    }
+
+    override fun clear() {
+        alive.fill(false)
+        inOrder.fill(false)
+        freeCount = 0
+        proxyLimit = 0
+        orderCount = 0
+        orderDirty = false
+        maxWidth = 0f
+        size = 0
+    }
+
+    override fun findPairs(callback: Broadphase.PairCallback) {
+        sort()
+        for (i in 0 until orderCount) {
+            val a = order[i]
+            val ba = a * 6
+            val aMaxX = bounds[ba + 3]
+            var j = i + 1
+            while (j < orderCount) {
+                val b = order[j]
+                val bb = b * 6
+                if (bounds[bb] > aMaxX) break
+                if (bounds[ba + 1] <= bounds[bb + 4] && bounds[bb + 1] <= bounds[ba + 4] &&
+                    bounds[ba + 2] <= bounds[bb + 5] && bounds[bb + 2] <= bounds[ba + 5]
+                ) {
+                    if (a < b) callback.pair(a, b) else callback.pair(b, a)
+                }
+                j++
+            }
+        }
+    }
+
+    override fun query(
+        minX: Float, minY: Float, minZ: Float,
+        maxX: Float, maxY: Float, maxZ: Float,
+        callback: Broadphase.ProxyCallback
+    ) {
+        sort()
+        var i = firstWithMinAtLeast(minX - maxWidth)
+        while (i < orderCount) {
+            val p = order[i++]
+            val b = p * 6
+            if (bounds[b] > maxX) break
+            if (bounds[b + 3] >= minX &&
+                bounds[b + 1] <= maxY && bounds[b + 4] >= minY &&
+                bounds[b + 2] <= maxZ && bounds[b + 5] >= minZ
+            ) {
+                callback.proxy(p)
+            }
+        }
+    }
+
+    override fun raycast(
+        originX: Float, originY: Float, originZ: Float,
+        directionX: Float, directionY: Float, directionZ: Float,
+        maxDistance: Float,
+        callback: Broadphase.RayCallback
+    ) {
+        // Candidates are the proxies overlapping the segment's box, tested by slab
+        val endX = originX + directionX * maxDistance
+        val endY = originY + directionY * maxDistance
+        val endZ = originZ + directionZ * maxDistance
+        val invX = 1f / directionX
+        val invY = 1f / directionY
+        val invZ = 1f / directionZ
+        var limit = maxDistance
+        query(
+            minOf(originX, endX), minOf(originY, endY), minOf(originZ, endZ),
+            maxOf(originX, endX), maxOf(originY, endY), maxOf(originZ, endZ)
+        ) { p ->
+            val b = p * 6
+            val entry = CullingBvh.slabEntry(
+                bounds[b], bounds[b + 1], bounds[b + 2], bounds[b + 3], bounds[b + 4], bounds[b + 5],
+                originX, originY, originZ, invX, invY, invZ, limit
+            )
+            if (entry <= limit) limit = callback.hit(p, entry)
+        }
+    }
+
+    // Drops dead proxies and insertion-sorts the rest by min x
+    private fun sort() {
+        if (!orderDirty) return
+        var live = 0
+        var width = 0f
+        for (i in 0 until orderCount) {
+            val p = order[i]
+            if (!alive[p]) {
+                inOrder[p] = false
+                continue
+            }
+            val key = bounds[p * 6]
+            width = max(width, bounds[p * 6 + 3] - key)
+            var j = live - 1
+            while (j >= 0 && bounds[order[j] * 6] > key) {
+                order[j + 1] = order[j]
+                j--
+            }
+            order[j + 1] = p
+            live++
+        }
+        orderCount = live
+        maxWidth = width
+        orderDirty = false
+    }
+
+    private fun firstWithMinAtLeast(value: Float): Int {
+        var low = 0
+        var high = orderCount
+        while (low < high) {
+            val mid = (low + high) ushr 1
+            if (bounds[order[mid] * 6] < value) low = mid + 1 else high = mid
+        }
+        return low
+    }
+
+    private fun grow() {
+        val capacity = alive.size * 2
+        alive = alive.copyOf(capacity)
+        inOrder = inOrder.copyOf(capacity)
+        bounds = bounds.copyOf(capacity * 6)
+    }
+
+    private fun writeBounds(proxy: Int, minX: Float, minY: Float, minZ: Float, maxX: Float, maxY: Float, maxZ: Float) {
+        val b = proxy * 6
+        bounds[b] = minX
+        bounds[b + 1] = minY
+        bounds[b + 2] = minZ
+        bounds[b + 3] = maxX
+        bounds[b + 4] = maxY
+        bounds[b + 5] = maxZ
+    }
+}
@@ -0,0 +1,212 @@
+package io.materia.physics
+
+import io.materia.core.math.Vector3
+
+/**
+ * Contact manifolds keyed by broadphase proxy pair, kept across steps.
+ *
+ * Each step the world calls [begin], [touch]es every pair the narrowphase confirms, and
+ * [end]s, which evicts pairs that stopped touching. A pair seen for the first time is
+ * [Manifold.isNew], which is how the world tells contact-added from contact-processed.
+ * Evicted manifolds go back to a pool, so a steady scene allocates nothing per step.
+ *
+ * Lookups use open addressing on the packed pair key, avoiding boxed keys.
+ */
+class ContactManifoldCache(initialCapacity: Int = 64) {
+    init {
+        require(initialCapacity > 0) { "initialCapacity must be positive (was $initialCapacity)" }
+    }
+
+    /**
+     * One persistent contact between two collision objects. Mutable and reused: copy
+     * anything needed after the callback returns.
+     */
+    class Manifold internal constructor() : ContactInfo {
+        override lateinit var objectA: CollisionObject
+            internal set
+        override lateinit var objectB: CollisionObject
+            internal set
+        override val worldPosA: Vector3 = Vector3()
+        override val worldPosB: Vector3 = Vector3()
+        override val normalWorldOnB: Vector3 = Vector3()
+        override var distance: Float = 0f
+            internal set
+        override var impulse: Float = 0f
+            internal set
+        override var friction: Float = 0f
+            internal set
+        override var restitution: Float = 0f
+            internal set
+
+        /** Broadphase proxies of [objectA] and [objectB]; `proxyA < proxyB`. */
+        var proxyA: Int = -1
+            internal set
+        var proxyB: Int = -1
+            internal set
+
+        /** Consecutive steps this pair has been touching, 1 on the step it started. */
+        var steps: Int = 0
+            internal set
+
+        val isNew: Boolean
+            get() = steps == 1
+
+        internal var stamp: Int = 0
+    }
+
+    private var keys = LongArray(tableSize(initialCapacity)) { EMPTY }
+    private var values = arrayOfNulls<Manifold>(keys.size)
+    private val active = ArrayList<Manifold>(initialCapacity)
+    private val pool = ArrayList<Manifold>()
+    private var stamp = 0
+
+    /** Pairs currently touching. */
+    val size: Int
+        get() = active.size
+
+    /** Manifold [index] of [size], in no particular order. */
+    fun manifold(index: Int): Manifold = active[index]
+
+    fun begin() {
+        stamp++
+    }
+
+    /**
+     * Returns the manifold for the pair, creating it when the pair was not touching last
+     * step, and marks it as touching this step.
+     */
+    fun touch(proxyA: Int, proxyB: Int): Manifold {
+        require(proxyA != proxyB) { "A proxy cannot touch itself" }
+        val lo = minOf(proxyA, proxyB)
+        val hi = maxOf(proxyA, proxyB)
+        val key = pack(lo, hi)
+        var slot = find(key)
+        if (slot >= 0) {
+            val manifold = requireNotNull(values[slot])
+            if (manifold.stamp != stamp) {
+                manifold.stamp = stamp
+                manifold.steps++
+            }
+            return manifold
+        }
+
+        if ((active.size + 1) * 2 > keys.size) {
+            resize(keys.size * 2)
+            slot = find(key)
+        }
+        slot = -slot - 1
+        val manifold = if (pool.isEmpty()) Manifold() else pool.removeAt(pool.size - 1)
+        manifold.proxyA = lo
+        manifold.proxyB = hi
+        manifold.steps = 1
+        manifold.stamp = stamp
+        keys[slot] = key
+        values[slot] = manifold
+        active.add(manifold)
+        return manifold
+    }
+
+    /** Evicts every pair not touched since [begin], passing each to [onRemoved] first. */
+    fun end(onRemoved: (Manifold) -> Unit) {
+        var i = 0
+        while (i < active.size) {
+            val manifold = active[i]
+            if (manifold.stamp == stamp) {
+                i++
+            } else {
+                onRemoved(manifold)
+                evict(i)
+            }
+        }
+    }
+
+    /** Evicts every pair involving [proxy], e.g. before the proxy id is reused. */
+    fun removeProxy(proxy: Int, onRemoved: (Manifold) -> Unit) {
+        var i = 0
+        while (i < active.size) {
+            val manifold = active[i]
+            if (manifold.proxyA == proxy || manifold.proxyB == proxy) {
+                onRemoved(manifold)
+                evict(i)
+            } else {
+                i++
+            }
+        }
+    }
+
+    fun clear() {
+        keys.fill(EMPTY)
+        values.fill(null)
+        pool.addAll(active)
+        active.clear()
+    }
+
+    // Swap-removes active[index] and deletes its table entry
+    private fun evict(index: Int) {
+        val manifold = active[index]
+        val last = active.removeAt(active.size - 1)
+        if (index < active.size) active[index] = last
+        deleteSlot(find(pack(manifold.proxyA, manifold.proxyB)))
+        manifold.steps = 0
+        pool.add(manifold)
+    }
+
+    // Slot holding key, or -(insertion slot) - 1 when absent
+    private fun find(key: Long): Int {
+        val mask = keys.size - 1
+        var slot = hash(key) and mask
+        while (true) {
+            val k = keys[slot]
+            if (k == key) return slot
+            if (k == EMPTY) return -slot - 1
+            slot = (slot + 1) and mask
+        }
+    }
+
+    // Linear probing deletion by backward shift, so no tombstones accumulate
+    private fun deleteSlot(start: Int) {
+        val mask = keys.size - 1
+        var hole = start
+        var slot = (hole + 1) and mask
+        while (keys[slot] != EMPTY) {
+            val home = hash(keys[slot]) and mask
+            // Move the entry into the hole unless its home lies cyclically in (hole, slot]
+            val inRange = if (hole <= slot) home in (hole + 1)..slot else home > hole || home <= slot
+            if (!inRange) {
+                keys[hole] = keys[slot]
+                values[hole] = values[slot]
+                hole = slot
+            }
+            slot = (slot + 1) and mask
+        }
+        keys[hole] = EMPTY
+        values[hole] = null
+    }
+
+    private fun resize(newSize: Int) {
+        keys = LongArray(newSize) { EMPTY }
+        values = arrayOfNulls(newSize)
+        for (manifold in active) {
+            val slot = -find(pack(manifold.proxyA, manifold.proxyB)) - 1
+            keys[slot] = pack(manifold.proxyA, manifold.proxyB)
+            values[slot] = manifold
+        }
+    }
+
+    companion object {
+        private const val EMPTY = -1L
+
+        private fun pack(lo: Int, hi: Int): Long = (lo.toLong() shl 32) or (hi.toLong() and 0xFFFFFFFFL)
+
+        private fun hash(key: Long): Int {
+            val h = key * -0x61c8864680b583ebL
+            return (h xor (h ushr 32)).toInt()
+        }
+
+        private fun tableSize(capacity: Int): Int {
+            var size = 16
+            while (size < capacity * 2) size *= 2
+            return size
+        }
+    }
+}
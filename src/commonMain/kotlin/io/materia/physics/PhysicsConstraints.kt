@@ -60,6 +60,14 @@ abstract class PhysicsConstraintImpl(
         // Subclasses override to populate constraint-specific parameters
     }
 
+    /**
+     * Applies this constraint's corrective impulses for one solver iteration.
+     * Called by [DefaultPhysicsWorld] [DefaultPhysicsWorld.solverIterations] times per step.
+     */
+    internal open fun solveConstraint(deltaTime: Float) {
+        // Constraints without a solver contribute nothing
+    }
+
     /**
      * Update applied impulse (called by physics solver)
      */
@@ -116,14 +116,17 @@ interface RaycastResult {
 
 /**
  * Collision contact information
+ *
+ * [PhysicsWorld] hands every collision callback the same instance, rewritten per pair;
+ * callbacks that keep a contact past their return must copy it, points included.
  */
 data class CollisionContact(
-    val bodyA: RigidBody,
-    val bodyB: RigidBody,
+    var bodyA: RigidBody,
+    var bodyB: RigidBody,
     val point: Vector3,
     val normal: Vector3,
-    val distance: Float = 0f,
-    val impulse: Float = 0f
+    var distance: Float = 0f,
+    var impulse: Float = 0f
 )
 
 /**
@@ -5,11 +5,30 @@ import io.materia.core.math.Quaternion
 import io.materia.core.math.Vector3
 import io.materia.physics.PhysicsOperationResult.Error
 import io.materia.physics.PhysicsOperationResult.Success
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
 
 /**
  * Default implementation of PhysicsWorld
  * Provides a complete physics simulation environment
  *
+ * Every collision object gets a proxy in a [Broadphase] chosen by [broadphase], so
+ * collision detection and the scene queries only run the narrowphase on objects whose
+ * boxes overlap. Proxy boxes are fattened by [PROXY_MARGIN] and only updated when an
+ * object leaves its box. Touching pairs persist in a [ContactManifoldCache], which
+ * drives [CollisionCallback.onContactAdded], [CollisionCallback.onContactProcessed]
+ * and [CollisionCallback.onContactDestroyed].
+ *
+ * [step] advances in fixed substeps of [timeStep], at most [maxSubSteps] per call, and
+ * carries the remainder over; render with [getInterpolatedTransform] to hide the
+ * stepping. Dynamic bodies linked by contacts or constraints form islands that are
+ * solved independently (in parallel with [stepParallel]) and fall asleep together
+ * once every body has rested for [TIME_TO_SLEEP]. Set [maxSubSteps] to 0 for one
+ * variable step of the given delta time instead.
+ *
  * NOTE: This implementation is NOT thread-safe. All operations must be called from a single thread.
  * For multi-threaded environments, external synchronization is required.
  */
@@ -22,6 +41,11 @@ class DefaultPhysicsWorld(
     override var maxSubSteps: Int = 1
     override var solverIterations: Int = 10
     override var broadphase: BroadphaseType = BroadphaseType.DYNAMIC_AABB_TREE
+        set(value) {
+            if (field == value) return
+            field = value
+            rebuildBroadphase()
+        }
 
     // Note: These collections are not thread-safe. Access must be synchronized externally
     private val rigidBodies = mutableListOf<RigidBody>()
@@ -35,6 +59,51 @@ class DefaultPhysicsWorld(
     // Event callbacks - not thread-safe
     private val triggerEnterCallbacks = mutableListOf<(RigidBody, RigidBody) -> Unit>()
     private val collisionCallbacks = mutableListOf<(CollisionContact) -> Unit>()
+    private var reportedContact: CollisionContact? = null
+
+    // Broadphase state: one proxy per collision object, indexed by proxy id
+    private var pairFinder: Broadphase = Broadphase.create(broadphase)
+    private val proxies = mutableMapOf<CollisionObject, Proxy>()
+    private val proxyList = mutableListOf<Proxy>()
+    private var proxyObjects = arrayOfNulls<CollisionObject>(64)
+    private val contacts = ContactManifoldCache()
+    private var pairBuffer = IntArray(256)
+    private var pairCount = 0
+
+    private class Proxy(val obj: CollisionObject) {
+        var id = -1
+        var listIndex = -1
+        val fatBox = FloatArray(6)
+    }
+
+    // Stepping state: per-body interpolation and sleep bookkeeping, islands rebuilt each substep
+    private var accumulator = 0f
+    private val bodyStates = mutableMapOf<RigidBody, BodyState>()
+    private val simulated = ArrayList<BodyState>()
+    private var islandParent = IntArray(64)
+    private var islandOfRoot = IntArray(64)
+    private val islands = ArrayList<Island>()
+    private var islandCount = 0
+
+    private class BodyState(val body: RigidBody) {
+        var index = -1
+        val previousPosition = Vector3()
+        val previousRotation = Quaternion()
+        var restTime = 0f
+    }
+
+    private class Island {
+        val bodies = ArrayList<BodyState>()
+        val constraints = ArrayList<PhysicsConstraintImpl>()
+        var awake = false
+    }
+
+    /**
+     * Fraction of a [timeStep] simulated time lags behind the caller's clock, in `[0, 1)`.
+     * 1 when [maxSubSteps] is 0, since variable steps leave no remainder.
+     */
+    val interpolationAlpha: Float
+        get() = if (maxSubSteps > 0 && timeStep > 0f) accumulator / timeStep else 1f
 
     override fun addRigidBody(body: RigidBody): PhysicsResult<Unit> {
         if (isDisposed) return Error(PhysicsException.UnsupportedOperation("PhysicsWorld is disposed"))
@@ -43,6 +112,7 @@ class DefaultPhysicsWorld(
             if (!rigidBodies.contains(body)) {
                 rigidBodies.add(body)
                 rigidBodyMap[body.id] = body
+                bodyStates[body] = BodyState(body).also { savePreviousTransform(it) }
                 addCollisionObject(body)
             }
             return Success(Unit)
@@ -57,6 +127,7 @@ class DefaultPhysicsWorld(
         try {
             rigidBodies.remove(body)
             rigidBodyMap.remove(body.id)
+            bodyStates.remove(body)
             removeCollisionObject(body)
             return Success(Unit)
         } catch (e: Exception) {
@@ -98,8 +169,9 @@ class DefaultPhysicsWorld(
         if (isDisposed) return Error(PhysicsException.UnsupportedOperation("PhysicsWorld is disposed"))
 
         try {
-            if (!collisionObjects.contains(obj)) {
+            if (!proxies.containsKey(obj)) {
                 collisionObjects.add(obj)
+                createProxy(obj)
             }
             return Success(Unit)
         } catch (e: Exception) {
@@ -111,7 +183,9 @@ class DefaultPhysicsWorld(
         if (isDisposed) return Error(PhysicsException.UnsupportedOperation("PhysicsWorld is disposed"))
 
         try {
-            collisionObjects.remove(obj)
+            if (collisionObjects.remove(obj)) {
+                destroyProxy(obj)
+            }
             return Success(Unit)
         } catch (e: Exception) {
             return Error(PhysicsException.EngineError("Failed to remove collision object", e))
@@ -123,35 +197,76 @@ class DefaultPhysicsWorld(
     }
 
     override fun step(deltaTime: Float): PhysicsResult<Unit> {
-        if (isDisposed) return Error(PhysicsException.UnsupportedOperation("PhysicsWorld is disposed"))
-        if (isPaused) return Success(Unit)
-        if (deltaTime < 0f) return Error(PhysicsException.InvalidParameters("Delta time must be non-negative"))
+        stepPrecondition(deltaTime)?.let { return it }
 
         try {
-            // Apply gravity to dynamic bodies
-            rigidBodies.forEach { body ->
-                if (body.bodyType == RigidBodyType.DYNAMIC && body.mass > 0f) {
-                    val gravityForce = gravity * body.mass
-                    body.applyCentralForce(gravityForce)
+            val subStep = if (maxSubSteps > 0) timeStep else deltaTime
+            repeat(takeSubSteps(deltaTime)) {
+                buildIslands()
+                for (i in 0 until islandCount) {
+                    val island = islands[i]
+                    if (island.awake) solveIsland(island, subStep)
                 }
+                detectCollisions()
             }
+            return Success(Unit)
+        } catch (e: Exception) {
+            return Error(PhysicsException.EngineError("Physics step failed", e))
+        }
+    }
 
-            // Update body positions based on velocities
-            rigidBodies.forEach { body ->
-                if (body.bodyType == RigidBodyType.DYNAMIC) {
-                    updateBodyPosition(body, deltaTime)
+    /**
+     * [step] with awake islands solved on up to [tasks] coroutines on [dispatcher].
+     * Island building and collision detection stay serial.
+     *
+     * Islands share no bodies, so they are solved without locking; callbacks still run
+     * on the calling coroutine. Worth it for many independent islands on multi-threaded
+     * dispatchers (JVM, native); on JS the default dispatcher is single-threaded and
+     * this only adds overhead.
+     */
+    suspend fun stepParallel(
+        deltaTime: Float,
+        tasks: Int = DEFAULT_PARALLEL_TASKS,
+        dispatcher: CoroutineDispatcher = Dispatchers.Default
+    ): PhysicsResult<Unit> {
+        require(tasks > 0) { "tasks must be positive (was $tasks)" }
+        stepPrecondition(deltaTime)?.let { return it }
+
+        try {
+            val subStep = if (maxSubSteps > 0) timeStep else deltaTime
+            repeat(takeSubSteps(deltaTime)) {
+                buildIslands()
+                val buckets = bucketIslands(tasks)
+                if (buckets.size == 1) {
+                    buckets[0].forEach { solveIsland(it, subStep) }
+                } else {
+                    coroutineScope {
+                        buckets.map { bucket ->
+                            async(dispatcher) { bucket.forEach { solveIsland(it, subStep) } }
+                        }.awaitAll()
+                    }
                 }
+                detectCollisions()
             }
-
-            // Check for collisions
-            detectCollisions()
-
             return Success(Unit)
         } catch (e: Exception) {
             return Error(PhysicsException.EngineError("Physics step failed", e))
         }
     }
 
+    /**
+     * Writes [body]'s transform blended between the last two substeps by
+     * [interpolationAlpha] into [target], for rendering between fixed steps.
+     */
+    fun getInterpolatedTransform(body: RigidBody, target: Matrix4 = Matrix4()): Matrix4 {
+        val transform = body.getWorldTransform()
+        val state = bodyStates[body] ?: return target.copy(transform)
+        val alpha = interpolationAlpha
+        val position = state.previousPosition.clone().lerp(transform.getTranslation(), alpha)
+        val rotation = state.previousRotation.clone().slerp(transform.getRotation(), alpha)
+        return target.compose(position, rotation, Vector3.ONE)
+    }
+
     override fun pause() {
         isPaused = true
     }
@@ -165,6 +280,15 @@ class DefaultPhysicsWorld(
         rigidBodyMap.clear()
         constraints.clear()
         collisionObjects.clear()
+        proxies.clear()
+        proxyList.clear()
+        proxyObjects.fill(null)
+        pairFinder.clear()
+        contacts.clear()
+        bodyStates.clear()
+        simulated.clear()
+        islandCount = 0
+        accumulator = 0f
         collisionCallback = null
         isPaused = false
     }
@@ -176,18 +300,21 @@ class DefaultPhysicsWorld(
         if (distance < 0.001f) return null
         val direction = (to - from).normalized()
 
-        // Simple raycast implementation - check intersection with all rigid bodies
+        // Nearest boxes first; boxes entered beyond the closest hit so far are skipped
         var closestHit: RaycastResult? = null
         var closestDistance = Float.MAX_VALUE
 
-        rigidBodies.forEach { body ->
-            if (groups == -1 || (body.collisionGroups and groups) != 0) {
+        syncProxies()
+        pairFinder.raycast(from.x, from.y, from.z, direction.x, direction.y, direction.z, distance) { proxy, _ ->
+            val body = proxyObjects[proxy] as? RigidBody
+            if (body != null && (groups == -1 || (body.collisionGroups and groups) != 0)) {
                 val hit = raycastBody(from, direction, distance, body)
                 if (hit != null && hit.distance < closestDistance) {
                     closestDistance = hit.distance
                     closestHit = hit
                 }
             }
+            minOf(closestDistance, distance)
         }
 
         return closestHit
@@ -198,7 +325,7 @@ class DefaultPhysicsWorld(
 
         val results = mutableListOf<CollisionObject>()
 
-        collisionObjects.forEach { obj ->
+        queryProxies(center, radius, radius, radius) { obj ->
             if (groups == -1 || (obj.collisionGroups and groups) != 0) {
                 if (sphereIntersectsObject(center, radius, obj)) {
                     results.add(obj)
@@ -219,7 +346,7 @@ class DefaultPhysicsWorld(
 
         val results = mutableListOf<CollisionObject>()
 
-        collisionObjects.forEach { obj ->
+        queryProxies(center, halfExtents.x, halfExtents.y, halfExtents.z) { obj ->
             if (groups == -1 || (obj.collisionGroups and groups) != 0) {
                 if (boxIntersectsObject(center, halfExtents, rotation, obj)) {
                     results.add(obj)
@@ -239,7 +366,9 @@ class DefaultPhysicsWorld(
 
         val results = mutableListOf<CollisionObject>()
 
-        collisionObjects.forEach { obj ->
+        // Proxy boxes already include the object's radius
+        val reach = OVERLAP_DISTANCE - BODY_RADIUS
+        queryProxies(transform.getTranslation(), reach, reach, reach) { obj ->
             if (groups == -1 || (obj.collisionGroups and groups) != 0) {
                 if (shapeOverlapsObject(shape, transform, obj)) {
                     results.add(obj)
@@ -266,14 +395,18 @@ class DefaultPhysicsWorld(
         val direction = (to - from).normalized()
         val distance = from.distanceTo(to)
 
-        rigidBodies.forEach { body ->
-            val hit = spherecastBody(from, direction, distance, radius, body)
-            if (hit != null) {
-                return Success(hit)
+        var closest: RaycastHit? = null
+        syncProxies()
+        pairFinder.raycast(from.x, from.y, from.z, direction.x, direction.y, direction.z, distance) { proxy, _ ->
+            val body = proxyObjects[proxy] as? RigidBody
+            val hit = body?.let { spherecastBody(from, direction, distance, radius, it) }
+            if (hit != null && hit.distance < (closest?.distance ?: Float.POSITIVE_INFINITY)) {
+                closest = hit
             }
+            closest?.distance ?: distance
         }
 
-        return Success(null)
+        return Success(closest)
     }
 
     fun overlapSphere(center: Vector3, radius: Float): PhysicsResult<List<RigidBody>> {
@@ -281,9 +414,9 @@ class DefaultPhysicsWorld(
 
         val results = mutableListOf<RigidBody>()
 
-        rigidBodies.forEach { body ->
-            if (sphereIntersectsRigidBody(center, radius, body)) {
-                results.add(body)
+        queryProxies(center, radius, radius, radius) { obj ->
+            if (obj is RigidBody && sphereIntersectsRigidBody(center, radius, obj)) {
+                results.add(obj)
             }
         }
 
@@ -295,13 +428,199 @@ class DefaultPhysicsWorld(
     }
 
     // Private helper methods
+    private fun stepPrecondition(deltaTime: Float): PhysicsResult<Unit>? = when {
+        isDisposed -> Error(PhysicsException.UnsupportedOperation("PhysicsWorld is disposed"))
+        isPaused -> Success(Unit)
+        deltaTime < 0f -> Error(PhysicsException.InvalidParameters("Delta time must be non-negative"))
+        else -> null
+    }
+
+    // Number of substeps deltaTime buys; time beyond maxSubSteps is dropped so a slow
+    // frame cannot make the next one slower
+    private fun takeSubSteps(deltaTime: Float): Int {
+        if (maxSubSteps <= 0 || timeStep <= 0f) return if (deltaTime > 0f) 1 else 0
+        accumulator += deltaTime
+        val steps = (accumulator / timeStep).toInt()
+        accumulator = maxOf(0f, accumulator - steps * timeStep)
+        if (steps > maxSubSteps) accumulator = 0f
+        return minOf(steps, maxSubSteps)
+    }
+
+    private fun savePreviousTransform(state: BodyState) {
+        val transform = state.body.getWorldTransform()
+        state.previousPosition.copy(transform.getTranslation())
+        state.previousRotation.copy(transform.getRotation())
+    }
+
+    /**
+     * Groups simulated dynamic bodies into islands with union-find over touching,
+     * non-trigger contacts and enabled constraints, then wakes every island with an
+     * awake body. Static and kinematic bodies never join islands, so resting on the
+     * ground does not chain unrelated bodies together.
+     */
+    private fun buildIslands() {
+        simulated.clear()
+        for (body in rigidBodies) {
+            val state = bodyStates[body] ?: continue
+            savePreviousTransform(state)
+            state.index = -1
+            if (body.bodyType == RigidBodyType.DYNAMIC && body.activationState != ActivationState.DISABLE_SIMULATION) {
+                state.index = simulated.size
+                simulated.add(state)
+            }
+        }
+
+        val count = simulated.size
+        if (islandParent.size < count) {
+            islandParent = IntArray(maxOf(count, islandParent.size * 2))
+            islandOfRoot = IntArray(islandParent.size)
+        }
+        for (i in 0 until count) {
+            islandParent[i] = i
+            islandOfRoot[i] = -1
+        }
+        for (i in 0 until contacts.size) {
+            val manifold = contacts.manifold(i)
+            if (manifold.objectA.isTrigger || manifold.objectB.isTrigger) continue
+            union(simulatedIndex(manifold.objectA), simulatedIndex(manifold.objectB))
+        }
+        for (constraint in constraints) {
+            if (constraint.isEnabled()) union(simulatedIndex(constraint.bodyA), simulatedIndex(constraint.bodyB))
+        }
+
+        islandCount = 0
+        for (i in 0 until count) {
+            val root = findRoot(i)
+            if (islandOfRoot[root] < 0) islandOfRoot[root] = nextIsland()
+            islands[islandOfRoot[root]].bodies.add(simulated[i])
+        }
+        for (constraint in constraints) {
+            if (constraint !is PhysicsConstraintImpl || !constraint.isEnabled()) continue
+            val owner = simulatedIndex(constraint.bodyA).takeIf { it >= 0 } ?: simulatedIndex(constraint.bodyB)
+            if (owner >= 0) islands[islandOfRoot[findRoot(owner)]].constraints.add(constraint)
+        }
+
+        for (i in 0 until islandCount) {
+            val island = islands[i]
+            island.awake = island.bodies.any { isAwake(it.body) }
+            if (!island.awake) continue
+            for (state in island.bodies) {
+                if (state.body.activationState == ActivationState.DEACTIVATED) {
+                    state.body.activationState = ActivationState.ACTIVE
+                    state.restTime = 0f
+                }
+            }
+        }
+    }
+
+    // A sleeping body given a velocity since it fell asleep wakes its island
+    private fun isAwake(body: RigidBody): Boolean =
+        body.activationState != ActivationState.DEACTIVATED ||
+                body.linearVelocity.lengthSquared() > 0f ||
+                body.angularVelocity.lengthSquared() > 0f
+
+    private fun nextIsland(): Int {
+        if (islandCount == islands.size) islands.add(Island())
+        val island = islands[islandCount]
+        island.bodies.clear()
+        island.constraints.clear()
+        return islandCount++
+    }
+
+    private fun simulatedIndex(obj: CollisionObject?): Int =
+        (obj as? RigidBody)?.let { bodyStates[it] }?.index ?: -1
+
+    private fun findRoot(index: Int): Int {
+        var i = index
+        while (islandParent[i] != i) {
+            islandParent[i] = islandParent[islandParent[i]]
+            i = islandParent[i]
+        }
+        return i
+    }
+
+    private fun union(a: Int, b: Int) {
+        if (a < 0 || b < 0) return
+        val rootA = findRoot(a)
+        val rootB = findRoot(b)
+        if (rootA != rootB) islandParent[rootB] = rootA
+    }
+
+    // Greedy partition of awake islands into at most tasks buckets of similar body count
+    private fun bucketIslands(tasks: Int): List<List<Island>> {
+        val awake = ArrayList<Island>(islandCount)
+        for (i in 0 until islandCount) {
+            if (islands[i].awake) awake.add(islands[i])
+        }
+        awake.sortByDescending { it.bodies.size }
+        val bucketCount = minOf(tasks, awake.size).coerceAtLeast(1)
+        val buckets = List(bucketCount) { ArrayList<Island>() }
+        val loads = IntArray(bucketCount)
+        for (island in awake) {
+            var lightest = 0
+            for (b in 1 until bucketCount) {
+                if (loads[b] < loads[lightest]) lightest = b
+            }
+            buckets[lightest].add(island)
+            loads[lightest] += island.bodies.size + island.constraints.size
+        }
+        return buckets
+    }
+
+    /**
+     * Integrates velocities, solves constraints and integrates transforms for one
+     * island, then puts it to sleep once all its bodies have rested long enough.
+     * Touches only the island's own bodies and constraints, so islands may be solved
+     * concurrently.
+     */
+    private fun solveIsland(island: Island, deltaTime: Float) {
+        for (state in island.bodies) integrateVelocity(state.body, deltaTime)
+        repeat(solverIterations) {
+            for (constraint in island.constraints) constraint.solveConstraint(deltaTime)
+        }
+
+        var canSleep = true
+        for (state in island.bodies) {
+            val body = state.body
+            updateBodyPosition(body, deltaTime)
+
+            val angularThreshold = body.sleepThreshold * 0.1f
+            val resting = body.linearVelocity.lengthSquared() < body.sleepThreshold * body.sleepThreshold &&
+                    body.angularVelocity.lengthSquared() < angularThreshold * angularThreshold
+            state.restTime = if (resting) state.restTime + deltaTime else 0f
+            if (state.restTime < TIME_TO_SLEEP || body.activationState == ActivationState.DISABLE_DEACTIVATION) {
+                canSleep = false
+            }
+        }
+
+        if (!canSleep) return
+        for (state in island.bodies) {
+            state.body.activationState = ActivationState.DEACTIVATED
+            state.body.linearVelocity = Vector3.ZERO
+            state.body.angularVelocity = Vector3.ZERO
+        }
+        island.awake = false
+    }
+
+    // Gravity is applied as an acceleration, not a force, so it never wakes sleeping bodies
+    private fun integrateVelocity(body: RigidBody, deltaTime: Float) {
+        var linear = body.linearVelocity
+        var angular = body.angularVelocity
+        if (body.mass > 0f) {
+            linear = linear + gravity * body.linearFactor * deltaTime
+        }
+        if (body is DefaultRigidBody) {
+            if (body.mass > 0f) linear = linear + body.getTotalForce() * (deltaTime / body.mass)
+            angular = angular + body.getInverseInertia() * body.getTotalTorque() * deltaTime
+            body.clearForces()
+        }
+        body.linearVelocity = linear * maxOf(0f, 1f - body.linearDamping * deltaTime)
+        body.angularVelocity = angular * maxOf(0f, 1f - body.angularDamping * deltaTime)
+    }
+
     private fun updateBodyPosition(body: RigidBody, deltaTime: Float) {
         if (body.bodyType != RigidBodyType.DYNAMIC) return
 
-        // Apply linear damping
-        body.linearVelocity = body.linearVelocity * (1f - body.linearDamping * deltaTime)
-        body.angularVelocity = body.angularVelocity * (1f - body.angularDamping * deltaTime)
-
         // Update position and rotation
         val position = body.getWorldTransform().getTranslation()
         val newPosition = position + body.linearVelocity * deltaTime
@@ -321,52 +640,173 @@ class DefaultPhysicsWorld(
     }
 
     private fun detectCollisions() {
-        for (i in rigidBodies.indices) {
-            for (j in i + 1 until rigidBodies.size) {
-                val bodyA = rigidBodies[i]
-                val bodyB = rigidBodies[j]
-
-                if (bodiesIntersect(bodyA, bodyB)) {
-                    val normalVec =
-                        bodyB.getWorldTransform().getTranslation() - bodyA.getWorldTransform()
-                            .getTranslation()
-                    val normalLen = normalVec.length()
-                    val normal = if (normalLen > 0.001f) {
-                        normalVec.normalized()
-                    } else {
-                        Vector3.UNIT_Y // Default normal if bodies are at same position
-                    }
+        syncProxies()
+
+        // Candidate pairs are buffered so callbacks may query the world safely
+        pairCount = 0
+        pairFinder.findPairs { a, b ->
+            if (pairCount * 2 + 2 > pairBuffer.size) pairBuffer = pairBuffer.copyOf(pairBuffer.size * 2)
+            pairBuffer[pairCount * 2] = a
+            pairBuffer[pairCount * 2 + 1] = b
+            pairCount++
+        }
 
-                    val contact = CollisionContact(
-                        bodyA = bodyA,
-                        bodyB = bodyB,
-                        point = bodyA.getWorldTransform().getTranslation(),
-                        normal = normal,
-                        distance = 0f,
-                        impulse = 0f
-                    )
-
-                    // Handle trigger events
-                    if (bodyA.isTrigger || bodyB.isTrigger) {
-                        triggerEnterCallbacks.forEach { it(bodyA, bodyB) }
-                    } else {
-                        // Handle collision
-                        collisionCallbacks.forEach { it(contact) }
-                        collisionCallback?.onContactAdded(object : ContactInfo {
-                            override val objectA: CollisionObject = bodyA
-                            override val objectB: CollisionObject = bodyB
-                            override val worldPosA: Vector3 = contact.point
-                            override val worldPosB: Vector3 = contact.point
-                            override val normalWorldOnB: Vector3 = contact.normal
-                            override val distance: Float = contact.distance
-                            override val impulse: Float = contact.impulse
-                            override val friction: Float = 0.5f
-                            override val restitution: Float = 0.0f
-                        })
-                    }
+        contacts.begin()
+        for (pair in 0 until pairCount) {
+            val proxyA = pairBuffer[pair * 2]
+            val proxyB = pairBuffer[pair * 2 + 1]
+            val bodyA = proxyObjects[proxyA] as? RigidBody ?: continue
+            val bodyB = proxyObjects[proxyB] as? RigidBody ?: continue
+            if (!canCollide(bodyA, bodyB) || !bodiesIntersect(bodyA, bodyB)) continue
+
+            val manifold = contacts.touch(proxyA, proxyB)
+            writeManifold(manifold, bodyA, bodyB)
+
+            // Handle trigger events
+            if (bodyA.isTrigger || bodyB.isTrigger) {
+                if (manifold.isNew) {
+                    triggerEnterCallbacks.forEach { it(bodyA, bodyB) }
+                }
+            } else {
+                // Handle collision
+                if (collisionCallbacks.isNotEmpty()) {
+                    val contact = reportContact(bodyA, bodyB)
+                    contact.point.copy(manifold.worldPosA)
+                    contact.normal.copy(manifold.normalWorldOnB)
+                    contact.distance = manifold.distance
+                    contact.impulse = manifold.impulse
+                    collisionCallbacks.forEach { it(contact) }
+                }
+                collisionCallback?.let { callback ->
+                    if (manifold.isNew) callback.onContactAdded(manifold) else callback.onContactProcessed(manifold)
                 }
             }
         }
+        contacts.end(::contactDestroyed)
+    }
+
+    /** The contact handed to collision callbacks, rebound to [bodyA] and [bodyB]. */
+    private fun reportContact(bodyA: RigidBody, bodyB: RigidBody): CollisionContact {
+        val contact = reportedContact
+            ?: CollisionContact(bodyA, bodyB, Vector3(), Vector3()).also { reportedContact = it }
+        contact.bodyA = bodyA
+        contact.bodyB = bodyB
+        return contact
+    }
+
+    private fun writeManifold(manifold: ContactManifoldCache.Manifold, bodyA: RigidBody, bodyB: RigidBody) {
+        val a = bodyA.getWorldTransform()
+        val b = bodyB.getWorldTransform()
+        manifold.objectA = bodyA
+        manifold.objectB = bodyB
+        manifold.worldPosA.set(a.m03, a.m13, a.m23)
+        manifold.worldPosB.copy(manifold.worldPosA)
+        manifold.normalWorldOnB.set(b.m03 - a.m03, b.m13 - a.m13, b.m23 - a.m23)
+        if (manifold.normalWorldOnB.length() > 0.001f) {
+            manifold.normalWorldOnB.normalize()
+        } else {
+            manifold.normalWorldOnB.copy(Vector3.UNIT_Y) // Default normal if bodies are at same position
+        }
+        manifold.distance = 0f
+        manifold.impulse = 0f
+        manifold.friction = 0.5f
+        manifold.restitution = 0.0f
+    }
+
+    private fun contactDestroyed(manifold: ContactManifoldCache.Manifold) {
+        if (!manifold.objectA.isTrigger && !manifold.objectB.isTrigger) {
+            collisionCallback?.onContactDestroyed(manifold)
+        }
+    }
+
+    /** Both objects' groups must be accepted by the other's mask. */
+    private fun canCollide(a: CollisionObject, b: CollisionObject): Boolean =
+        (a.collisionGroups and b.collisionMask) != 0 && (b.collisionGroups and a.collisionMask) != 0
+
+    private fun createProxy(obj: CollisionObject) {
+        val proxy = Proxy(obj)
+        writeFatBox(obj, proxy.fatBox)
+        val box = proxy.fatBox
+        proxy.id = pairFinder.createProxy(box[0], box[1], box[2], box[3], box[4], box[5])
+        if (proxy.id >= proxyObjects.size) {
+            proxyObjects = proxyObjects.copyOf(maxOf(proxy.id + 1, proxyObjects.size * 2))
+        }
+        proxyObjects[proxy.id] = obj
+        proxy.listIndex = proxyList.size
+        proxyList.add(proxy)
+        proxies[obj] = proxy
+    }
+
+    private fun destroyProxy(obj: CollisionObject) {
+        val proxy = proxies.remove(obj) ?: return
+        contacts.removeProxy(proxy.id, ::contactDestroyed)
+        pairFinder.destroyProxy(proxy.id)
+        proxyObjects[proxy.id] = null
+        val last = proxyList.removeAt(proxyList.size - 1)
+        if (last !== proxy) {
+            proxyList[proxy.listIndex] = last
+            last.listIndex = proxy.listIndex
+        }
+    }
+
+    private fun rebuildBroadphase() {
+        pairFinder = Broadphase.create(broadphase)
+        contacts.clear()
+        val existing = proxyList.toList()
+        proxies.clear()
+        proxyList.clear()
+        proxyObjects.fill(null)
+        existing.forEach { createProxy(it.obj) }
+    }
+
+    /**
+     * Moves proxies whose object left its fattened box. Objects can be moved directly
+     * between steps, so queries call this too; an object still inside its box costs a
+     * few comparisons.
+     */
+    private fun syncProxies() {
+        for (proxy in proxyList) {
+            val t = proxy.obj.getWorldTransform()
+            val box = proxy.fatBox
+            val x = t.m03
+            val y = t.m13
+            val z = t.m23
+            if (x - BODY_RADIUS >= box[0] && y - BODY_RADIUS >= box[1] && z - BODY_RADIUS >= box[2] &&
+                x + BODY_RADIUS <= box[3] && y + BODY_RADIUS <= box[4] && z + BODY_RADIUS <= box[5]
+            ) {
+                continue
+            }
+            writeFatBox(proxy.obj, box)
+            pairFinder.moveProxy(proxy.id, box[0], box[1], box[2], box[3], box[4], box[5])
+        }
+    }
+
+    // The narrowphase treats every object as a sphere of BODY_RADIUS at its position
+    private fun writeFatBox(obj: CollisionObject, box: FloatArray) {
+        val t = obj.getWorldTransform()
+        val extent = BODY_RADIUS + PROXY_MARGIN
+        box[0] = t.m03 - extent
+        box[1] = t.m13 - extent
+        box[2] = t.m23 - extent
+        box[3] = t.m03 + extent
+        box[4] = t.m13 + extent
+        box[5] = t.m23 + extent
+    }
+
+    private inline fun queryProxies(
+        center: Vector3,
+        halfX: Float,
+        halfY: Float,
+        halfZ: Float,
+        crossinline visit: (CollisionObject) -> Unit
+    ) {
+        syncProxies()
+        pairFinder.query(
+            center.x - halfX, center.y - halfY, center.z - halfZ,
+            center.x + halfX, center.y + halfY, center.z + halfZ
+        ) { proxy ->
+            proxyObjects[proxy]?.let { visit(it) }
+        }
     }
 
     private fun bodiesIntersect(bodyA: RigidBody, bodyB: RigidBody): Boolean {
@@ -376,10 +816,7 @@ class DefaultPhysicsWorld(
         val distance = posA.distanceTo(posB)
 
         // Assume radius of 1.0 for all objects in simple implementation
-        val radiusA = 1f
-        val radiusB = 1f
-
-        return distance < (radiusA + radiusB)
+        return distance < (BODY_RADIUS + BODY_RADIUS)
     }
 
     private fun raycastBody(
@@ -397,7 +834,7 @@ class DefaultPhysicsWorld(
 
         val closestPoint = from + direction * projection
         val distance = closestPoint.distanceTo(bodyPos)
-        val radius = 1f // Assume radius of 1.0
+        val radius = BODY_RADIUS
 
         if (distance <= radius) {
             val hitPoint = closestPoint
@@ -441,8 +878,7 @@ class DefaultPhysicsWorld(
     ): Boolean {
         val objPos = obj.getWorldTransform().getTranslation()
         val distance = center.distanceTo(objPos)
-        val objRadius = 1f // Simplified assumption
-        return distance <= (radius + objRadius)
+        return distance <= (radius + BODY_RADIUS)
     }
 
     private fun sphereIntersectsRigidBody(
@@ -452,8 +888,7 @@ class DefaultPhysicsWorld(
     ): Boolean {
         val bodyPos = body.getWorldTransform().getTranslation()
         val distance = center.distanceTo(bodyPos)
-        val bodyRadius = 1f // Simplified assumption
-        return distance <= (radius + bodyRadius)
+        return distance <= (radius + BODY_RADIUS)
     }
 
     private fun boxIntersectsObject(
@@ -481,13 +916,29 @@ class DefaultPhysicsWorld(
         val objPos = obj.getWorldTransform().getTranslation()
         val distance = shapePos.distanceTo(objPos)
 
-        return distance <= 2f // Simplified overlap threshold
+        return distance <= OVERLAP_DISTANCE // Simplified overlap threshold
     }
 
     fun dispose() {
         reset()
         isDisposed = true
     }
+
+    companion object {
+        /** Radius of the sphere the simplified narrowphase assumes for every object. */
+        const val BODY_RADIUS = 1f
+
+        /** Padding around proxy boxes, so slow objects do not update the broadphase each step. */
+        const val PROXY_MARGIN = 0.1f
+
+        /** Centre distance within which [overlaps] reports an object. */
+        private const val OVERLAP_DISTANCE = 2f
+
+        /** Seconds every body of an island must stay below its sleep threshold before the island sleeps. */
+        const val TIME_TO_SLEEP = 0.5f
+
+        const val DEFAULT_PARALLEL_TASKS = 8
+    }
 }
 
 /**
@@ -304,6 +304,14 @@ class DefaultRigidBody(
 
     override fun getTotalTorque(): Vector3 = totalTorque
 
+    /**
+     * Drops accumulated forces and torques once a world has integrated them
+     */
+    internal fun clearForces() {
+        totalForce = Vector3.ZERO
+        totalTorque = Vector3.ZERO
+    }
+
     override fun setTransform(position: Vector3, rotation: Quaternion) {
         transform = Matrix4.fromTranslationRotation(position, rotation)
     }
@@ -63,7 +63,7 @@ class ConeTwistConstraintImpl(
     /**
      * Solve cone-twist constraint
      */
-    internal fun solveConstraint(deltaTime: Float) {
+    internal override fun solveConstraint(deltaTime: Float) {
         // Solve positional constraints
         solvePositionalConstraint(deltaTime)
         // Solve angular constraints with cone and twist limits
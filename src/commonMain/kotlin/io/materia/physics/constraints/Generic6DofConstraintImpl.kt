@@ -69,7 +69,7 @@ class Generic6DofConstraintImpl(
     /**
      * Solve 6DOF constraint
      */
-    internal fun solveConstraint(deltaTime: Float) {
+    internal override fun solveConstraint(deltaTime: Float) {
         val transformA = bodyA.getWorldTransform()
         val transformB = bodyB?.getWorldTransform() ?: Matrix4.IDENTITY
 
@@ -148,7 +148,7 @@ class HingeConstraintImpl(
     /**
      * Apply constraint forces during physics step
      */
-    internal fun solveConstraint(deltaTime: Float) {
+    internal override fun solveConstraint(deltaTime: Float) {
         // Solve positional constraint (point-to-point part)
         solvePositionalConstraint(deltaTime)
         // Solve angular constraints
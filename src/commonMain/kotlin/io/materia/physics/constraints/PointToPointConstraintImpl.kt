@@ -61,6 +61,10 @@ class PointToPointConstraintImpl(
         }
     }
 
+    internal override fun solveConstraint(deltaTime: Float) {
+        updateRHS(deltaTime)
+    }
+
     /**
      * Get constraint jacobian for physics solver
      */
@@ -65,7 +65,7 @@ class SliderConstraintImpl(
     /**
      * Solve slider constraint
      */
-    internal fun solveConstraint(deltaTime: Float) {
+    internal override fun solveConstraint(deltaTime: Float) {
         // Solve positional constraints (maintain alignment except along slider axis)
         solvePositionalConstraints(deltaTime)
         // Solve angular constraints (prevent rotation except around slider axis)
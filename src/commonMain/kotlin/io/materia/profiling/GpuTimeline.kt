@@ -0,0 +1,109 @@
+package io.materia.profiling
+
+import kotlinx.atomicfu.atomic
+import kotlinx.atomicfu.update
+
+/**
+ * A GPU pass measured with timestamp queries, in the GPU's own clock.
+ *
+ * @property name Pass label.
+ * @property category Pass kind, such as "render" or "compute".
+ * @property beginNanos Timestamp written at the start of the pass.
+ * @property endNanos Timestamp written at the end of the pass.
+ */
+data class GpuPassSpan(
+    val name: String,
+    val category: String,
+    val beginNanos: Long,
+    val endNanos: Long
+) {
+    val durationNanos: Long get() = (endNanos - beginNanos).coerceAtLeast(0L)
+}
+
+/**
+ * A GPU pass placed on the CPU clock used by [PerformanceProfiler].
+ */
+data class GpuTimelineEvent(
+    val frameNumber: Int,
+    val name: String,
+    val category: String,
+    val startNanos: Long,
+    val durationNanos: Long
+)
+
+/**
+ * GPU pass timings of recent frames, aligned to the CPU clock so a trace shows CPU and
+ * GPU work of the same frame side by side.
+ *
+ * The offset between the clocks is unknown, but GPU work never starts before the CPU
+ * submitted it, so every frame bounds the offset from below by
+ * `submit - first GPU timestamp`. The largest bound among the stored frames is used;
+ * it is exact for any frame the GPU started right at submission.
+ */
+class GpuTimeline(
+    val historySize: Int = 300
+) {
+    private class Frame(val frameNumber: Int, val cpuSubmitNanos: Long, val passes: List<GpuPassSpan>)
+
+    private val frames = atomic<List<Frame>>(emptyList())
+
+    init {
+        require(historySize > 0) { "historySize must be > 0 (was $historySize)" }
+    }
+
+    /** Records the passes of [frameNumber], whose commands the CPU submitted at [cpuSubmitNanos]. */
+    fun addFrame(frameNumber: Int, cpuSubmitNanos: Long, passes: List<GpuPassSpan>) {
+        if (passes.isEmpty()) return
+        val frame = Frame(frameNumber, cpuSubmitNanos, passes.toList())
+        frames.update { (it + frame).takeLast(historySize) }
+    }
+
+    /** Number of stored frames. */
+    val frameCount: Int get() = frames.value.size
+
+    /** Estimated CPU time minus GPU time, or null before the first frame. */
+    val clockOffsetNanos: Long?
+        get() = offset(frames.value)
+
+    /** Every stored pass on the CPU clock, in frame order. */
+    fun events(): List<GpuTimelineEvent> {
+        val stored = frames.value
+        val offset = offset(stored) ?: return emptyList()
+        return stored.flatMap { frame ->
+            frame.passes.map { pass ->
+                GpuTimelineEvent(frame.frameNumber, pass.name, pass.category, pass.beginNanos + offset, pass.durationNanos)
+            }
+        }
+    }
+
+    /** Average GPU time per pass name over the stored frames, longest first. */
+    fun averagePassTimes(): Map<String, Long> {
+        val totals = LinkedHashMap<String, LongArray>()
+        for (frame in frames.value) {
+            for (pass in frame.passes) {
+                val entry = totals.getOrPut(pass.name) { LongArray(2) }
+                entry[0] += pass.durationNanos
+                entry[1]++
+            }
+        }
+        return totals.entries
+            .map { (name, entry) -> name to entry[0] / entry[1] }
+            .sortedByDescending { it.second }
+            .toMap()
+    }
+
+    /** Average GPU time of a frame, from its first pass start to its last pass end. */
+    fun averageFrameTime(): Long {
+        val stored = frames.value
+        if (stored.isEmpty()) return 0L
+        return stored.sumOf { frame -> frame.passes.maxOf { it.endNanos } - frame.passes.minOf { it.beginNanos } } /
+            stored.size
+    }
+
+    fun clear() {
+        frames.value = emptyList()
+    }
+
+    private fun offset(stored: List<Frame>): Long? =
+        stored.maxOfOrNull { frame -> frame.cpuSubmitNanos - frame.passes.minOf { it.beginNanos } }
+}
@@ -5,6 +5,8 @@
 package io.materia.profiling
 
 import io.materia.core.platform.currentTimeMillis
+import io.materia.optimization.ResidencyManager
+import io.materia.optimization.ResidencyStats
 import io.materia.util.MateriaLogger
 import kotlinx.coroutines.*
 import kotlinx.coroutines.sync.Mutex
@@ -87,6 +89,7 @@ class MemoryProfiler(private val config: MemoryProfilerConfig = MemoryProfilerCo
     private var _totalDeallocated = 0L
     private var _peakUsage = 0L
     private var profilingJob: Job? = null
+    private var residency: ResidencyManager? = null
 
     /**
      * Start memory profiling
@@ -114,6 +117,18 @@ class MemoryProfiler(private val config: MemoryProfilerConfig = MemoryProfilerCo
         profilingJob = null
     }
 
+    /**
+     * Report GPU residency from [manager] alongside the recorded allocations
+     */
+    fun trackResidency(manager: ResidencyManager?) {
+        residency = manager
+    }
+
+    /**
+     * Budget use of the tracked [ResidencyManager], if any
+     */
+    fun getResidencyStats(): ResidencyStats? = residency?.stats()
+
     /**
      * Record a memory allocation
      */
@@ -243,14 +258,22 @@ class MemoryProfiler(private val config: MemoryProfilerConfig = MemoryProfilerCo
      * Get memory usage summary
      */
     suspend fun getUsageSummary(): Map<String, Any> {
+        val residencyStats = getResidencyStats()
         return mutex.withLock {
-            mapOf(
+            val summary = mutableMapOf<String, Any>(
                 "currentAllocations" to _allocations.size,
                 "totalAllocated" to _totalAllocated,
                 "totalDeallocated" to _totalDeallocated,
                 "currentUsage" to getCurrentUsage(),
                 "peakUsage" to _peakUsage
             )
+            if (residencyStats != null) {
+                summary["residentBytes"] = residencyStats.usedBytes
+                summary["residencyBudget"] = residencyStats.budgetBytes
+                summary["residentResources"] = residencyStats.residentCount
+                summary["residencyEvictions"] = residencyStats.evictionCount
+            }
+            summary
         }
     }
 
@@ -31,6 +31,11 @@ object PerformanceProfiler {
     // Memory tracking
     private val memorySnapshots = atomic<List<PerformanceMemorySnapshot>>(emptyList())
 
+    /**
+     * GPU pass timings reported through [recordGpuFrame], placed on the CPU clock.
+     */
+    val gpuTimeline = GpuTimeline()
+
     /**
      * Configure the profiler
      */
@@ -203,6 +208,21 @@ object PerformanceProfiler {
         frame.counters[name] = (frame.counters[name] ?: 0L) + delta
     }
 
+    /**
+     * Record GPU timestamp results for [frameNumber], whose commands were submitted at
+     * [cpuSubmitNanos] on the [Platform.currentTimeNanos] clock. Results usually arrive a
+     * few frames after the frame itself.
+     */
+    fun recordGpuFrame(frameNumber: Int, cpuSubmitNanos: Long, passes: List<GpuPassSpan>) {
+        if (!enabled.value) return
+        gpuTimeline.addFrame(frameNumber, cpuSubmitNanos, passes)
+    }
+
+    /**
+     * Number of the frame started by the last [startFrame]
+     */
+    fun currentFrameNumber(): Int = frameNumber.value
+
     /**
      * Get frame statistics
      */
@@ -300,6 +320,7 @@ object PerformanceProfiler {
         frameHistory.value = emptyList()
         hotspots.value = emptyMap()
         memorySnapshots.value = emptyList()
+        gpuTimeline.clear()
         frameNumber.value = 0
         currentFrame.value = null
     }
@@ -436,35 +457,55 @@ object PerformanceProfiler {
         }
     }
 
+    // Chrome trace event format, also read by Perfetto: frames and CPU measurements on
+    // one track, GPU passes on another, both on the CPU clock
     private fun exportToChromeTrace(): String {
-        // Chrome trace event format
-        return buildString {
-            appendLine("[")
-            val events = mutableListOf<String>()
+        val events = mutableListOf(
+            """{"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "CPU"}}""",
+            """{"name": "thread_name", "ph": "M", "pid": 1, "tid": 2, "args": {"name": "GPU"}}"""
+        )
 
-            frameHistory.value.forEach { frame ->
-                frame.measurements.forEach { measurement ->
-                    events.add(
-                        """
-                        {
-                          "name": "${measurement.name}",
-                          "cat": "${measurement.category}",
-                          "ph": "X",
-                          "ts": ${measurement.timestamp / 1000},
-                          "dur": ${measurement.durationNanos / 1000},
-                          "pid": 1,
-                          "tid": 1
-                        }
-                    """.trimIndent()
-                    )
-                }
+        frameHistory.value.forEach { frame ->
+            events.add(traceEvent("Frame ${frame.frameNumber}", "frame", frame.startTime, frame.duration, 1))
+            frame.measurements.forEach { measurement ->
+                // Measurements are stamped when they end
+                val start = measurement.timestamp - measurement.durationNanos
+                events.add(traceEvent(measurement.name, measurement.category.name, start, measurement.durationNanos, 1))
             }
+        }
+        gpuTimeline.events().forEach { event ->
+            events.add(
+                traceEvent(event.name, event.category, event.startNanos, event.durationNanos, 2, event.frameNumber)
+            )
+        }
 
+        return buildString {
+            appendLine("[")
             append(events.joinToString(",\n"))
             appendLine()
             appendLine("]")
         }
     }
+
+    private fun traceEvent(
+        name: String,
+        category: String,
+        startNanos: Long,
+        durationNanos: Long,
+        tid: Int,
+        frameNumber: Int? = null
+    ): String {
+        val args = frameNumber?.let { ", \"args\": {\"frame\": $it}" } ?: ""
+        return "{\"name\": \"$name\", \"cat\": \"$category\", \"ph\": \"X\", " +
+            "\"ts\": ${micros(startNanos)}, \"dur\": ${micros(durationNanos)}, \"pid\": 1, \"tid\": $tid$args}"
+    }
+
+    // Trace timestamps are microseconds; keep the nanosecond digits GPU passes need
+    private fun micros(nanos: Long): String {
+        val whole = nanos / 1000
+        val fraction = (nanos % 1000).let { if (it < 0) -it else it }
+        return "$whole.${fraction.toString().padStart(3, '0')}"
+    }
 }
 
 /**
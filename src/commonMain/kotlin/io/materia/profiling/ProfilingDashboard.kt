@@ -66,12 +66,15 @@ class ProfilingDashboard {
             ProfilingReport.generateReport().recommendations.take(dashboardConfig.maxRecommendations)
         } else emptyList()
 
+        val gpuTimeline = PerformanceProfiler.gpuTimeline
         return DashboardState(
             enabled = true,
             frameStats = frameStats,
             hotspots = hotspots,
             memoryStats = memoryStats,
-            recommendations = recommendations
+            recommendations = recommendations,
+            gpuFrameTime = gpuTimeline.averageFrameTime(),
+            gpuPassTimes = gpuTimeline.averagePassTimes()
         )
     }
 
@@ -108,6 +111,15 @@ class ProfilingDashboard {
             appendLine("  Dropped: ${state.frameStats.droppedFrames} frames")
             appendLine()
 
+            // GPU passes, when the renderer reports timestamp queries
+            if (state.gpuPassTimes.isNotEmpty()) {
+                appendLine("  GPU Frame Time: ${formatNanosAsMs(state.gpuFrameTime)}")
+                state.gpuPassTimes.entries.take(5).forEach { (name, nanos) ->
+                    appendLine("    • $name: ${formatNanosAsMs(nanos)}")
+                }
+                appendLine()
+            }
+
             // Memory
             state.memoryStats?.let { memory ->
                 appendLine("  Memory: ${formatMB(memory.current)} / Peak: ${formatMB(memory.peak)}")
@@ -201,6 +213,10 @@ class ProfilingDashboard {
         return "${io.materia.core.platform.formatFloat(ms.toFloat(), 2)}ms"
     }
 
+    private fun formatNanosAsMs(nanos: Long): String {
+        return "${io.materia.core.platform.formatFloat(nanos / 1_000_000f, 2)}ms"
+    }
+
     private fun formatMB(bytes: Long): String {
         return "${io.materia.core.platform.formatFloat(bytes / (1024f * 1024f), 1)}MB"
     }
@@ -221,14 +237,17 @@ data class DashboardConfig(
 )
 
 /**
- * Dashboard state snapshot
+ * Dashboard state snapshot. GPU times are averages in nanoseconds and stay empty unless
+ * the renderer reports timestamp queries.
  */
 data class DashboardState(
     val enabled: Boolean,
     val frameStats: FrameStats,
     val hotspots: List<Hotspot>,
     val memoryStats: MemoryStats?,
-    val recommendations: List<Recommendation>
+    val recommendations: List<Recommendation>,
+    val gpuFrameTime: Long = 0L,
+    val gpuPassTimes: Map<String, Long> = emptyMap()
 )
 
 /**
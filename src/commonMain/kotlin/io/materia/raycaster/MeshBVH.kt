@@ -0,0 +1,475 @@
+package io.materia.raycaster
+
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import kotlin.math.abs
+import kotlin.math.max
+import kotlin.math.min
+
+/**
+ * Triangle bounding volume hierarchy for fast ray queries against one geometry.
+ *
+ * Built top-down with binned surface-area-heuristic splits. Nodes and triangles live
+ * in flat arrays: nodes are stored depth-first (the left child of an inner node is the
+ * next node), each with six bound floats and either a right-child index or a triangle
+ * range. Triangles are reordered so every leaf covers a contiguous range.
+ *
+ * The tree reads positions from the geometry's `position` attribute on every query, so
+ * after editing vertices in place call [refit] to update the bounds without rebuilding.
+ * Changing the triangle count or topology needs a new tree.
+ *
+ * Obtain one through [BufferGeometry.computeBoundsTree] so it is cached on the geometry.
+ *
+ * @param geometry Geometry with a `position` attribute, indexed or not
+ * @param maxLeafTriangles Leaves hold at most this many triangles unless they cannot be split
+ */
+class MeshBVH(
+    val geometry: BufferGeometry,
+    val maxLeafTriangles: Int = DEFAULT_MAX_LEAF_TRIANGLES
+) {
+    init {
+        require(maxLeafTriangles in 1..255) { "maxLeafTriangles must be in 1..255 (was $maxLeafTriangles)" }
+    }
+
+    private val position: BufferAttribute = requireNotNull(geometry.getAttribute("position")) {
+        "MeshBVH needs a position attribute"
+    }
+
+    /** Number of triangles in the tree. */
+    val triangleCount: Int
+
+    // Triangle vertex indices and original face index, in leaf order
+    private val triVertices: IntArray
+    private val triFace: IntArray
+
+    // Node data: bounds as min xyz / max xyz, then right child (inner) or first triangle (leaf)
+    private var nodeBounds = FloatArray(0)
+    private var nodeOffset = IntArray(0)
+    private var nodeTriangles = IntArray(0)
+
+    /** Node count, for diagnostics. */
+    var nodeCount: Int = 0
+        private set
+
+    // Build scratch, released after construction
+    private var centroids = FloatArray(0)
+    private var triBounds = FloatArray(0)
+    private val binCounts = IntArray(BINS)
+    private val binBounds = FloatArray(BINS * 6)
+    private val rightCost = FloatArray(BINS)
+    private val sweep = FloatArray(6)
+
+    private var stack = IntArray(64)
+
+    init {
+        val index = geometry.index
+        triangleCount = (index?.count ?: position.count) / 3
+        triVertices = IntArray(triangleCount * 3)
+        triFace = IntArray(triangleCount) { it }
+        for (i in 0 until triangleCount * 3) {
+            triVertices[i] = index?.array?.get(i)?.toInt() ?: i
+        }
+        build()
+    }
+
+    /**
+     * Recomputes every node's bounds from the current vertex positions, keeping the
+     * tree topology. Cheaper than a rebuild; query quality degrades only if vertices
+     * moved far relative to their neighbours.
+     */
+    fun refit() {
+        if (nodeCount == 0) return
+        for (node in nodeCount - 1 downTo 0) {
+            val base = node * 6
+            val count = nodeTriangles[node]
+            if (count > 0) {
+                resetBounds(nodeBounds, base)
+                val first = nodeOffset[node]
+                for (t in first until first + count) {
+                    for (k in 0 until 3) {
+                        val v = triVertices[t * 3 + k] * position.itemSize
+                        growBounds(nodeBounds, base, position.array[v], position.array[v + 1], position.array[v + 2])
+                    }
+                }
+            } else {
+                val left = (node + 1) * 6
+                val right = nodeOffset[node] * 6
+                for (axis in 0 until 3) {
+                    nodeBounds[base + axis] = min(nodeBounds[left + axis], nodeBounds[right + axis])
+                    nodeBounds[base + 3 + axis] = max(nodeBounds[left + 3 + axis], nodeBounds[right + 3 + axis])
+                }
+            }
+        }
+    }
+
+    /**
+     * Intersects a ray given in the geometry's local space with every triangle.
+     *
+     * Triangles are double-sided. Children are visited near-first, and with
+     * [firstHitOnly] the search range shrinks to the closest hit so far, so only the
+     * nearest hit is reported.
+     *
+     * @param near Smallest accepted ray parameter
+     * @param far Largest accepted ray parameter
+     * @param visitor Receives each hit's original face index and ray parameter
+     * @return Number of hits reported
+     */
+    fun raycast(
+        originX: Float, originY: Float, originZ: Float,
+        directionX: Float, directionY: Float, directionZ: Float,
+        near: Float,
+        far: Float,
+        firstHitOnly: Boolean,
+        visitor: HitVisitor
+    ): Int {
+        if (nodeCount == 0) return 0
+        val invX = 1f / directionX
+        val invY = 1f / directionY
+        val invZ = 1f / directionZ
+        var limit = far
+        var closestFace = -1
+        var closestT = 0f
+        var hits = 0
+
+        var top = 0
+        stack[top++] = 0
+        while (top > 0) {
+            val node = stack[--top]
+            val entry = slabEntry(node, originX, originY, originZ, invX, invY, invZ, near, limit)
+            if (entry < 0f) continue
+
+            val count = nodeTriangles[node]
+            if (count > 0) {
+                val first = nodeOffset[node]
+                for (t in first until first + count) {
+                    val hitT = intersectTriangle(t, originX, originY, originZ, directionX, directionY, directionZ)
+                    if (hitT < near || hitT > limit) continue
+                    if (firstHitOnly) {
+                        limit = hitT
+                        closestT = hitT
+                        closestFace = triFace[t]
+                    } else {
+                        visitor.visit(triFace[t], hitT)
+                        hits++
+                    }
+                }
+                continue
+            }
+
+            val left = node + 1
+            val right = nodeOffset[node]
+            // Push the farther child first so the nearer one is popped next
+            val leftEntry = slabEntry(left, originX, originY, originZ, invX, invY, invZ, near, limit)
+            val rightEntry = slabEntry(right, originX, originY, originZ, invX, invY, invZ, near, limit)
+            if (top + 2 > stack.size) stack = stack.copyOf(stack.size * 2)
+            if (leftEntry >= 0f && rightEntry >= 0f) {
+                if (leftEntry <= rightEntry) {
+                    stack[top++] = right
+                    stack[top++] = left
+                } else {
+                    stack[top++] = left
+                    stack[top++] = right
+                }
+            } else if (leftEntry >= 0f) {
+                stack[top++] = left
+            } else if (rightEntry >= 0f) {
+                stack[top++] = right
+            }
+        }
+
+        if (firstHitOnly && closestFace >= 0) {
+            visitor.visit(closestFace, closestT)
+            hits = 1
+        }
+        return hits
+    }
+
+    /** Vertex index [corner] (0..2) of the original face [faceIndex]. */
+    fun faceVertex(faceIndex: Int, corner: Int): Int {
+        val index = geometry.index
+        return index?.array?.get(faceIndex * 3 + corner)?.toInt() ?: (faceIndex * 3 + corner)
+    }
+
+    /** Receives ray hits from [raycast]. */
+    fun interface HitVisitor {
+        fun visit(faceIndex: Int, distance: Float)
+    }
+
+    // Möller-Trumbore; returns the ray parameter or -1 on a miss
+    private fun intersectTriangle(
+        tri: Int,
+        ox: Float, oy: Float, oz: Float,
+        dx: Float, dy: Float, dz: Float
+    ): Float {
+        val p = position.array
+        val stride = position.itemSize
+        val a = triVertices[tri * 3] * stride
+        val b = triVertices[tri * 3 + 1] * stride
+        val c = triVertices[tri * 3 + 2] * stride
+        val ax = p[a]
+        val ay = p[a + 1]
+        val az = p[a + 2]
+        val e1x = p[b] - ax
+        val e1y = p[b + 1] - ay
+        val e1z = p[b + 2] - az
+        val e2x = p[c] - ax
+        val e2y = p[c + 1] - ay
+        val e2z = p[c + 2] - az
+
+        val px = dy * e2z - dz * e2y
+        val py = dz * e2x - dx * e2z
+        val pz = dx * e2y - dy * e2x
+        val det = e1x * px + e1y * py + e1z * pz
+        if (abs(det) < DETERMINANT_EPSILON) return MISS
+        val invDet = 1f / det
+
+        val sx = ox - ax
+        val sy = oy - ay
+        val sz = oz - az
+        val u = (sx * px + sy * py + sz * pz) * invDet
+        if (u < 0f || u > 1f) return MISS
+
+        val qx = sy * e1z - sz * e1y
+        val qy = sz * e1x - sx * e1z
+        val qz = sx * e1y - sy * e1x
+        val v = (dx * qx + dy * qy + dz * qz) * invDet
+        if (v < 0f || u + v > 1f) return MISS
+
+        return (e2x * qx + e2y * qy + e2z * qz) * invDet
+    }
+
+    // Ray parameter at which the ray enters the node, or -1 when it misses [near, far]
+    private fun slabEntry(
+        node: Int,
+        ox: Float, oy: Float, oz: Float,
+        invX: Float, invY: Float, invZ: Float,
+        near: Float,
+        far: Float
+    ): Float {
+        val base = node * 6
+        var t0x = (nodeBounds[base] - ox) * invX
+        var t1x = (nodeBounds[base + 3] - ox) * invX
+        if (t0x > t1x) { val s = t0x; t0x = t1x; t1x = s }
+        var t0y = (nodeBounds[base + 1] - oy) * invY
+        var t1y = (nodeBounds[base + 4] - oy) * invY
+        if (t0y > t1y) { val s = t0y; t0y = t1y; t1y = s }
+        var t0z = (nodeBounds[base + 2] - oz) * invZ
+        var t1z = (nodeBounds[base + 5] - oz) * invZ
+        if (t0z > t1z) { val s = t0z; t0z = t1z; t1z = s }
+
+        // A ray lying exactly in a slab plane gives NaN here and is treated as a miss
+        val enter = max(max(t0x, t0y), max(t0z, near))
+        val exit = min(min(t1x, t1y), min(t1z, far))
+        return if (enter <= exit) max(enter, 0f) else MISS
+    }
+
+    private fun build() {
+        nodeBounds = FloatArray(max(1, 2 * triangleCount) * 6)
+        nodeOffset = IntArray(max(1, 2 * triangleCount))
+        nodeTriangles = IntArray(max(1, 2 * triangleCount))
+        nodeCount = 0
+        if (triangleCount == 0) return
+
+        centroids = FloatArray(triangleCount * 3)
+        triBounds = FloatArray(triangleCount * 6)
+        for (t in 0 until triangleCount) {
+            val base = t * 6
+            resetBounds(triBounds, base)
+            for (k in 0 until 3) {
+                val v = triVertices[t * 3 + k] * position.itemSize
+                growBounds(triBounds, base, position.array[v], position.array[v + 1], position.array[v + 2])
+            }
+            for (axis in 0 until 3) {
+                centroids[t * 3 + axis] = (triBounds[base + axis] + triBounds[base + 3 + axis]) * 0.5f
+            }
+        }
+
+        buildNode(0, triangleCount)
+
+        // Sized for the 2n - 1 worst case; leaves of several triangles leave most of it unused
+        nodeBounds = nodeBounds.copyOf(nodeCount * 6)
+        nodeOffset = nodeOffset.copyOf(nodeCount)
+        nodeTriangles = nodeTriangles.copyOf(nodeCount)
+        centroids = FloatArray(0)
+        triBounds = FloatArray(0)
+    }
+
+    private fun buildNode(first: Int, count: Int): Int {
+        val node = nodeCount++
+        val base = node * 6
+        resetBounds(nodeBounds, base)
+        var cMinX = Float.POSITIVE_INFINITY
+        var cMinY = Float.POSITIVE_INFINITY
+        var cMinZ = Float.POSITIVE_INFINITY
+        var cMaxX = Float.NEGATIVE_INFINITY
+        var cMaxY = Float.NEGATIVE_INFINITY
+        var cMaxZ = Float.NEGATIVE_INFINITY
+        for (t in first until first + count) {
+            val b = t * 6
+            growBounds(nodeBounds, base, triBounds[b], triBounds[b + 1], triBounds[b + 2])
+            growBounds(nodeBounds, base, triBounds[b + 3], triBounds[b + 4], triBounds[b + 5])
+            val cx = centroids[t * 3]
+            val cy = centroids[t * 3 + 1]
+            val cz = centroids[t * 3 + 2]
+            cMinX = min(cMinX, cx); cMaxX = max(cMaxX, cx)
+            cMinY = min(cMinY, cy); cMaxY = max(cMaxY, cy)
+            cMinZ = min(cMinZ, cz); cMaxZ = max(cMaxZ, cz)
+        }
+
+        val split = if (count > maxLeafTriangles) {
+            findSahSplit(first, count, cMinX, cMinY, cMinZ, cMaxX, cMaxY, cMaxZ)
+        } else {
+            NO_SPLIT
+        }
+        if (split == NO_SPLIT) {
+            nodeOffset[node] = first
+            nodeTriangles[node] = count
+            return node
+        }
+
+        val axis = split and 3
+        val bin = split ushr 2
+        val cMin = when (axis) { 0 -> cMinX; 1 -> cMinY; else -> cMinZ }
+        val cMax = when (axis) { 0 -> cMaxX; 1 -> cMaxY; else -> cMaxZ }
+        var mid = partition(first, count, axis, cMin, BINS / (cMax - cMin), bin)
+        if (mid == first || mid == first + count) {
+            mid = first + count / 2
+        }
+
+        nodeTriangles[node] = 0
+        buildNode(first, mid - first)
+        nodeOffset[node] = buildNode(mid, first + count - mid)
+        return node
+    }
+
+    /**
+     * Bins centroids along each axis and returns `bin << 2 | axis` of the split with the
+     * lowest SAH cost (triangles in bins `<= bin` go left), or [NO_SPLIT] when every
+     * centroid coincides.
+     */
+    private fun findSahSplit(
+        first: Int, count: Int,
+        cMinX: Float, cMinY: Float, cMinZ: Float,
+        cMaxX: Float, cMaxY: Float, cMaxZ: Float
+    ): Int {
+        var bestCost = Float.POSITIVE_INFINITY
+        var best = NO_SPLIT
+        val binCount = binCounts
+        for (axis in 0 until 3) {
+            val cMin = when (axis) { 0 -> cMinX; 1 -> cMinY; else -> cMinZ }
+            val cMax = when (axis) { 0 -> cMaxX; 1 -> cMaxY; else -> cMaxZ }
+            val extent = cMax - cMin
+            if (extent <= 0f) continue
+            val scale = BINS / extent
+
+            binCount.fill(0)
+            for (b in 0 until BINS) resetBounds(binBounds, b * 6)
+            for (t in first until first + count) {
+                val b = binOf(centroids[t * 3 + axis], cMin, scale)
+                binCount[b]++
+                val tb = t * 6
+                growBounds(binBounds, b * 6, triBounds[tb], triBounds[tb + 1], triBounds[tb + 2])
+                growBounds(binBounds, b * 6, triBounds[tb + 3], triBounds[tb + 4], triBounds[tb + 5])
+            }
+
+            // Sweep from the right to get the cost of every suffix, then from the left
+            resetBounds(sweep, 0)
+            var rightCount = 0
+            for (b in BINS - 1 downTo 1) {
+                rightCount += binCount[b]
+                unionInto(sweep, 0, binBounds, b * 6)
+                rightCost[b] = if (rightCount > 0) surfaceArea(sweep, 0) * rightCount else 0f
+            }
+            resetBounds(sweep, 0)
+            var leftCount = 0
+            for (b in 0 until BINS - 1) {
+                leftCount += binCount[b]
+                unionInto(sweep, 0, binBounds, b * 6)
+                if (leftCount == 0 || leftCount == count) continue
+                val cost = surfaceArea(sweep, 0) * leftCount + rightCost[b + 1]
+                if (cost < bestCost) {
+                    bestCost = cost
+                    best = (b shl 2) or axis
+                }
+            }
+        }
+        return best
+    }
+
+    private fun partition(first: Int, count: Int, axis: Int, cMin: Float, scale: Float, splitBin: Int): Int {
+        var i = first
+        var j = first + count - 1
+        while (i <= j) {
+            if (binOf(centroids[i * 3 + axis], cMin, scale) <= splitBin) {
+                i++
+            } else {
+                swapTriangles(i, j)
+                j--
+            }
+        }
+        return i
+    }
+
+    private fun swapTriangles(i: Int, j: Int) {
+        for (k in 0 until 3) {
+            val v = triVertices[i * 3 + k]
+            triVertices[i * 3 + k] = triVertices[j * 3 + k]
+            triVertices[j * 3 + k] = v
+            val c = centroids[i * 3 + k]
+            centroids[i * 3 + k] = centroids[j * 3 + k]
+            centroids[j * 3 + k] = c
+        }
+        for (k in 0 until 6) {
+            val b = triBounds[i * 6 + k]
+            triBounds[i * 6 + k] = triBounds[j * 6 + k]
+            triBounds[j * 6 + k] = b
+        }
+        val f = triFace[i]
+        triFace[i] = triFace[j]
+        triFace[j] = f
+    }
+
+    companion object {
+        const val DEFAULT_MAX_LEAF_TRIANGLES = 8
+
+        private const val BINS = 12
+        private const val NO_SPLIT = -1
+        private const val MISS = -1f
+        private const val DETERMINANT_EPSILON = 1e-10f
+
+        private fun binOf(value: Float, min: Float, scale: Float): Int =
+            ((value - min) * scale).toInt().coerceIn(0, BINS - 1)
+
+        private fun resetBounds(bounds: FloatArray, base: Int) {
+            bounds[base] = Float.POSITIVE_INFINITY
+            bounds[base + 1] = Float.POSITIVE_INFINITY
+            bounds[base + 2] = Float.POSITIVE_INFINITY
+            bounds[base + 3] = Float.NEGATIVE_INFINITY
+            bounds[base + 4] = Float.NEGATIVE_INFINITY
+            bounds[base + 5] = Float.NEGATIVE_INFINITY
+        }
+
+        private fun growBounds(bounds: FloatArray, base: Int, x: Float, y: Float, z: Float) {
+            bounds[base] = min(bounds[base], x)
+            bounds[base + 1] = min(bounds[base + 1], y)
+            bounds[base + 2] = min(bounds[base + 2], z)
+            bounds[base + 3] = max(bounds[base + 3], x)
+            bounds[base + 4] = max(bounds[base + 4], y)
+            bounds[base + 5] = max(bounds[base + 5], z)
+        }
+
+        private fun unionInto(target: FloatArray, base: Int, source: FloatArray, sourceBase: Int) {
+            if (source[sourceBase] > source[sourceBase + 3]) return
+            growBounds(target, base, source[sourceBase], source[sourceBase + 1], source[sourceBase + 2])
+            growBounds(target, base, source[sourceBase + 3], source[sourceBase + 4], source[sourceBase + 5])
+        }
+
+        // Half the surface area; the constant factor does not change SAH decisions
+        private fun surfaceArea(bounds: FloatArray, base: Int): Float {
+            val x = bounds[base + 3] - bounds[base]
+            val y = bounds[base + 4] - bounds[base + 1]
+            val z = bounds[base + 5] - bounds[base + 2]
+            return if (x < 0f) 0f else x * y + y * z + z * x
+        }
+    }
+}
@@ -4,7 +4,11 @@ import io.materia.core.math.Vector3
 import io.materia.core.math.Vector2
 import io.materia.core.math.Ray
 import io.materia.core.math.Matrix4
+import io.materia.core.scene.DrawMode
+import io.materia.core.scene.Mesh
 import io.materia.core.scene.Object3D
+import io.materia.points.Points
+import io.materia.points.Sprite
 import io.materia.camera.Camera
 import io.materia.camera.PerspectiveCamera
 import io.materia.camera.OrthographicCamera
@@ -27,6 +31,10 @@ import io.materia.camera.OrthographicCamera
  * }
  * ```
  *
+ * Meshes are tested through the triangle BVH cached on their geometry
+ * ([io.materia.geometry.BufferGeometry.computeBoundsTree]); for scenes with many
+ * objects, index them in a [SceneBVH] and use the [intersectObjects] overload taking it.
+ *
  * @param origin Ray origin point (default: world origin).
  * @param direction Ray direction (default: -Z axis).
  * @param near Minimum intersection distance (default: 0).
@@ -48,6 +56,14 @@ class Raycaster(
      */
     val params = Params()
 
+    /**
+     * When true, only the closest intersection is returned.
+     *
+     * Mesh BVH traversal then stops descending past the nearest triangle found so far,
+     * which is considerably cheaper for picking.
+     */
+    var firstHitOnly: Boolean = false
+
     /**
      * Configures the ray from camera and screen coordinates.
      *
@@ -122,7 +138,7 @@ class Raycaster(
 
         intersectObjectInternal(object3D, this, intersections, recursive)
 
-        intersections.sortBy { it.distance }
+        sortAndTrim(intersections)
 
         return intersections
     }
@@ -149,11 +165,59 @@ class Raycaster(
             intersectObjectInternal(obj, this, intersections, recursive)
         }
 
-        intersections.sortBy { it.distance }
+        sortAndTrim(intersections)
 
         return intersections
     }
 
+    /**
+     * Tests the meshes indexed by [index], visiting only those whose world bounds the
+     * ray crosses, nearest first.
+     *
+     * Call [SceneBVH.update] after moving objects. With [firstHitOnly], objects whose
+     * bounds start behind the closest hit so far are skipped.
+     *
+     * @param index Scene index to query.
+     * @param optionalTarget Reusable list to avoid allocation.
+     * @return Sorted list of intersections.
+     */
+    fun intersectObjects(
+        index: SceneBVH,
+        optionalTarget: MutableList<Intersection> = mutableListOf()
+    ): List<Intersection> {
+        val intersections = optionalTarget
+        intersections.clear()
+
+        var closest = far
+        index.bvh.raycast(
+            ray.origin.x, ray.origin.y, ray.origin.z,
+            ray.direction.x, ray.direction.y, ray.direction.z,
+            far
+        ) { handle, _ ->
+            val before = intersections.size
+            raycastMesh(index.meshOf(handle), this, intersections)
+            if (firstHitOnly) {
+                for (i in before until intersections.size) {
+                    closest = minOf(closest, intersections[i].distance)
+                }
+                closest
+            } else {
+                far
+            }
+        }
+
+        sortAndTrim(intersections)
+
+        return intersections
+    }
+
+    private fun sortAndTrim(intersections: MutableList<Intersection>) {
+        intersections.sortBy { it.distance }
+        if (firstHitOnly && intersections.size > 1) {
+            intersections.subList(1, intersections.size).clear()
+        }
+    }
+
     private fun intersectObjectInternal(
         object3D: Object3D,
         raycaster: Raycaster,
@@ -261,12 +325,66 @@ data class Face(
 /**
  * Performs raycasting against this object.
  *
- * Override in subclasses (Mesh, Line, Points) to implement
- * geometry-specific intersection testing.
+ * Extension functions dispatch statically, so this routes by type: triangle meshes are
+ * tested through their geometry's BVH, [Points] and [Sprite] through their own
+ * `raycast`. Other objects produce no hits.
  *
  * @param raycaster The raycaster to test against.
  * @param intersections Output list to append any hits.
  */
 fun Object3D.raycast(raycaster: Raycaster, intersections: MutableList<Intersection>) {
-    // Default no-op - overridden in Mesh, Line, Points with geometry intersection logic
-}
\ No newline at end of file
+    when (this) {
+        is Points -> raycast(raycaster, intersections)
+        is Sprite -> raycast(raycaster, intersections)
+        is Mesh -> if (drawMode == DrawMode.TRIANGLES) raycastMesh(this, raycaster, intersections)
+    }
+}
+
+/**
+ * Intersects [mesh]'s triangles with the raycaster's world-space ray.
+ *
+ * The ray is moved into the mesh's local space and rejected early against the geometry
+ * bounding box; surviving rays walk the geometry's cached [MeshBVH]. Distances reported
+ * are world-space; [Raycaster.near] / [Raycaster.far] are converted to the local ray's
+ * parameter range and bound the walk.
+ */
+internal fun raycastMesh(mesh: Mesh, raycaster: Raycaster, intersections: MutableList<Intersection>) {
+    val geometry = mesh.geometry
+    if (geometry.getAttribute("position") == null) return
+
+    val inverse = mesh.matrixWorld.clone().invert()
+    val localRay = raycaster.ray.clone().applyMatrix4(inverse)
+    if (!localRay.intersectsBox(geometry.computeBoundingBox())) return
+
+    val tree = geometry.computeBoundsTree()
+    val origin = localRay.origin
+    val direction = localRay.direction
+    // matrixWorld maps the local direction back onto the world one, so a local ray
+    // parameter t lies t * |world direction| from the world origin. Clipping the walk to
+    // near..far keeps a first-hit search from settling on a hit outside that range.
+    val worldPerLocal = raycaster.ray.direction.length()
+    tree.raycast(
+        origin.x, origin.y, origin.z,
+        direction.x, direction.y, direction.z,
+        raycaster.near / worldPerLocal, raycaster.far / worldPerLocal,
+        raycaster.firstHitOnly
+    ) { faceIndex, t ->
+        val point = localRay.at(t).applyMatrix4(mesh.matrixWorld)
+        val distance = raycaster.ray.origin.distanceTo(point)
+        if (distance >= raycaster.near && distance <= raycaster.far) {
+            intersections.add(
+                Intersection(
+                    distance = distance,
+                    point = point,
+                    `object` = mesh,
+                    face = Face(
+                        tree.faceVertex(faceIndex, 0),
+                        tree.faceVertex(faceIndex, 1),
+                        tree.faceVertex(faceIndex, 2)
+                    ),
+                    faceIndex = faceIndex
+                )
+            )
+        }
+    }
+}
@@ -0,0 +1,100 @@
+package io.materia.raycaster
+
+import io.materia.core.math.Box3
+import io.materia.core.scene.DrawMode
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.Object3D
+import io.materia.geometry.BufferGeometry
+import io.materia.optimization.CullingBvh
+
+/**
+ * Scene-level bounding volume hierarchy over the world bounds of visible meshes.
+ *
+ * Lets [Raycaster.intersectObjects] skip every mesh whose world box the ray misses,
+ * instead of transforming the ray into each mesh's space. The boxes live in a
+ * [CullingBvh], so meshes that move only refit their leaf.
+ *
+ * Call [update] once per frame (or after objects move) with the scene root. A mesh's
+ * box is recomputed only when its [Object3D.matrixWorldVersion] or geometry changed.
+ */
+class SceneBVH {
+    internal val bvh = CullingBvh()
+
+    private val entries = HashMap<Mesh, Entry>()
+    private var meshes = arrayOfNulls<Mesh>(64)
+    private var stamp = 0
+
+    /** Number of indexed meshes. */
+    val size: Int
+        get() = entries.size
+
+    /**
+     * Indexes every visible triangle mesh under [root] and drops meshes that are no
+     * longer visible or attached.
+     */
+    fun update(root: Object3D) {
+        stamp++
+        root.traverseVisible { obj ->
+            if (obj is Mesh && obj.drawMode == DrawMode.TRIANGLES &&
+                obj.geometry.getAttribute("position") != null
+            ) {
+                track(obj)
+            }
+        }
+
+        val iterator = entries.entries.iterator()
+        while (iterator.hasNext()) {
+            val entry = iterator.next().value
+            if (entry.stamp == stamp) continue
+            bvh.remove(entry.handle)
+            meshes[entry.handle] = null
+            iterator.remove()
+        }
+    }
+
+    fun clear() {
+        bvh.clear()
+        entries.clear()
+        meshes.fill(null)
+    }
+
+    internal fun meshOf(handle: Int): Mesh = requireNotNull(meshes[handle]) {
+        "No mesh indexed under handle $handle"
+    }
+
+    private fun track(mesh: Mesh) {
+        val existing = entries[mesh]
+        if (existing != null) {
+            existing.stamp = stamp
+            val geometry = mesh.geometry
+            // A null bounding box means the geometry changed since it was last computed
+            if (existing.version == mesh.matrixWorldVersion &&
+                existing.geometry === geometry &&
+                geometry.boundingBox != null
+            ) {
+                return
+            }
+            val box = worldBox(mesh)
+            bvh.update(existing.handle, box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z)
+            existing.version = mesh.matrixWorldVersion
+            existing.geometry = geometry
+            return
+        }
+
+        val box = worldBox(mesh)
+        val handle = bvh.insert(box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z)
+        if (handle >= meshes.size) meshes = meshes.copyOf(maxOf(handle + 1, meshes.size * 2))
+        meshes[handle] = mesh
+        entries[mesh] = Entry(handle, mesh.matrixWorldVersion, mesh.geometry, stamp)
+    }
+
+    private fun worldBox(mesh: Mesh): Box3 =
+        mesh.geometry.computeBoundingBox().clone().applyMatrix4(mesh.matrixWorld)
+
+    private class Entry(
+        val handle: Int,
+        var version: Int,
+        var geometry: BufferGeometry,
+        var stamp: Int
+    )
+}
@@ -24,6 +24,13 @@ import kotlin.math.roundToInt
  * @property textureMemory Texture memory usage in bytes
  * @property bufferMemory Buffer memory usage in bytes
  * @property timestamp Timestamp of stats capture (milliseconds since epoch)
+ * @property gpuMemoryAllocated Bytes held in backend memory blocks (pooled allocators only)
+ * @property gpuMemoryUsed Bytes covered by live sub-allocations inside those blocks
+ * @property gpuMemoryBlocks Number of live driver-level memory allocations
+ * @property gpuSubAllocations Number of live sub-allocations
+ * @property gpuMemoryFragmentation Average free-space fragmentation of pooled blocks (0-1)
+ * @property gpuFrameTime GPU time of the most recently completed frame in milliseconds,
+ *           from timestamp queries (0 when the backend cannot measure it)
  */
 data class RenderStats(
     val fps: Double,
@@ -35,7 +42,13 @@ data class RenderStats(
     val timestamp: Long = 0L,
     val iblCpuMs: Double = 0.0,
     val iblPrefilterMipCount: Int = 0,
-    val iblLastRoughness: Float = 0f
+    val iblLastRoughness: Float = 0f,
+    val gpuMemoryAllocated: Long = 0L,
+    val gpuMemoryUsed: Long = 0L,
+    val gpuMemoryBlocks: Int = 0,
+    val gpuSubAllocations: Int = 0,
+    val gpuMemoryFragmentation: Float = 0f,
+    val gpuFrameTime: Double = 0.0
 ) {
     init {
         require(fps >= 0) { "FPS must be non-negative, got: $fps" }
@@ -86,6 +99,13 @@ data class RenderStats(
             appendLine("  Draw Calls: $drawCalls")
             appendLine("  Texture Memory: ${textureMemory / 1024 / 1024}MB")
             appendLine("  Buffer Memory: ${bufferMemory / 1024 / 1024}MB")
+            if (gpuMemoryBlocks > 0) {
+                val fragmentationPct = (gpuMemoryFragmentation * 1000).roundToInt() / 10.0
+                appendLine(
+                    "  GPU Memory: ${gpuMemoryUsed / 1024 / 1024}/${gpuMemoryAllocated / 1024 / 1024}MB " +
+                        "($gpuSubAllocations allocations in $gpuMemoryBlocks blocks, $fragmentationPct% fragmented)"
+                )
+            }
             if (iblPrefilterMipCount > 0) {
                 val iblMs = (iblCpuMs * 100).roundToInt() / 100.0
                 val iblRough = (iblLastRoughness * 100).roundToInt() / 100.0
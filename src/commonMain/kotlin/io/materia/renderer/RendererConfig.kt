@@ -15,13 +15,25 @@ package io.materia.renderer
  * @property vsync Enable V-sync for frame pacing
  * @property msaaSamples MSAA sample count (must be power of 2: 1, 2, 4, 8, 16)
  * @property powerPreference GPU power preference (high-performance vs low-power)
+ * @property framesInFlight Number of frames the CPU may record ahead of the GPU (1-3).
+ *           Backends that manage their own frame pacing (WebGPU) ignore this value.
+ * @property persistPipelineCache Save the driver pipeline cache between runs so pipelines
+ *           seen before compile quickly. Backends without a pipeline cache ignore this value.
+ * @property pipelineCacheDirectory Directory for the persisted pipeline cache
+ *           (null = backend default location)
+ * @property gpuMemoryBudget Bytes of geometry and texture memory to keep resident; least
+ *           recently drawn resources are evicted beyond it (null = no budget).
  */
 data class RendererConfig(
     val preferredBackend: BackendType? = null,
     val enableValidation: Boolean = true,
     val vsync: Boolean = true,
     val msaaSamples: Int = 4,
-    val powerPreference: PowerPreference = PowerPreference.HIGH_PERFORMANCE
+    val powerPreference: PowerPreference = PowerPreference.HIGH_PERFORMANCE,
+    val framesInFlight: Int = DEFAULT_FRAMES_IN_FLIGHT,
+    val persistPipelineCache: Boolean = true,
+    val pipelineCacheDirectory: String? = null,
+    val gpuMemoryBudget: Long? = null
 ) {
     init {
         // Validate msaaSamples is power of 2
@@ -29,11 +41,24 @@ data class RendererConfig(
             "msaaSamples must be power of 2 (1, 2, 4, 8, 16), got: $msaaSamples"
         }
 
+        require(framesInFlight in 1..MAX_FRAMES_IN_FLIGHT) {
+            "framesInFlight must be in 1..$MAX_FRAMES_IN_FLIGHT, got: $framesInFlight"
+        }
+
+        require(gpuMemoryBudget == null || gpuMemoryBudget > 0) {
+            "gpuMemoryBudget must be positive, got: $gpuMemoryBudget"
+        }
+
         // Warn if preferredBackend is WEBGL (violates FR-001/FR-002)
         if (preferredBackend == BackendType.WEBGL) {
             println("⚠️ Warning: Explicitly requesting WebGL backend (should only be fallback per FR-001/FR-002)")
         }
     }
+
+    companion object {
+        const val DEFAULT_FRAMES_IN_FLIGHT = 2
+        const val MAX_FRAMES_IN_FLIGHT = 3
+    }
 }
 
 /**
@@ -21,5 +21,6 @@ data class BufferHandle(
 enum class BufferUsage {
     VERTEX,   // Vertex buffer (position + attributes)
     INDEX,    // Index buffer (triangle indices)
-    UNIFORM   // Uniform buffer (shader constants)
+    UNIFORM,  // Uniform buffer (shader constants)
+    STORAGE   // Storage buffer (shader-read arrays such as bone palettes)
 }
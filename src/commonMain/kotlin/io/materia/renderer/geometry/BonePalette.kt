@@ -0,0 +1,75 @@
+package io.materia.renderer.geometry
+
+import io.materia.core.scene.SkinnedMesh
+
+/**
+ * Skin matrices of every skinned mesh drawn in a frame, packed back to back so a renderer
+ * uploads them as one storage buffer instead of one buffer (or CPU skinning pass) per mesh.
+ *
+ * Each frame the renderer calls [reset], [add]s the visible skinned meshes, uploads the first
+ * [floatCount] floats of [data], and passes each mesh's first bone index (from [add] or
+ * [offsetOf]) and bone count to its draw. The vertex shader then blends
+ * `palette[first + skinIndex.i] * skinWeight.i` over the four influences before applying the
+ * model matrix, which reproduces [SkinnedMesh.applyBoneTransform].
+ *
+ * Matrices are column-major, [FLOATS_PER_BONE] floats per bone. A backend without storage
+ * buffers can upload the same array as an RGBA32F texture four texels wide per bone and
+ * fetch the columns with `texelFetch`.
+ */
+class BonePalette(initialBones: Int = 64) {
+    init {
+        require(initialBones > 0) { "initialBones must be positive (was $initialBones)" }
+    }
+
+    /** Packed palette; only the first [floatCount] floats are meaningful. Grows as needed. */
+    var data: FloatArray = FloatArray(initialBones * FLOATS_PER_BONE)
+        private set
+
+    /** Bones packed since the last [reset]. */
+    var boneCount: Int = 0
+        private set
+
+    val floatCount: Int
+        get() = boneCount * FLOATS_PER_BONE
+
+    private val offsets = LinkedHashMap<SkinnedMesh, Int>()
+
+    fun reset() {
+        boneCount = 0
+        offsets.clear()
+    }
+
+    /**
+     * Packs the current skin matrices of [mesh] and returns the index of its first bone.
+     * A mesh added twice in a frame (e.g. drawn in two passes) is packed once. Returns -1
+     * when the mesh has no skeleton bound.
+     *
+     * The skeleton is not updated here; pose it before adding.
+     */
+    fun add(mesh: SkinnedMesh): Int {
+        offsets[mesh]?.let { return it }
+        val bones = mesh.skeleton?.bones?.size ?: return -1
+
+        ensureCapacity(boneCount + bones)
+        val first = boneCount
+        mesh.writeSkinMatrices(data, first * FLOATS_PER_BONE)
+        boneCount += bones
+        offsets[mesh] = first
+        return first
+    }
+
+    /** First bone of [mesh] in this frame's palette, or -1 when it was not added. */
+    fun offsetOf(mesh: SkinnedMesh): Int = offsets[mesh] ?: -1
+
+    private fun ensureCapacity(bones: Int) {
+        val required = bones * FLOATS_PER_BONE
+        if (required <= data.size) return
+        var size = data.size
+        while (size < required) size *= 2
+        data = data.copyOf(size)
+    }
+
+    companion object {
+        const val FLOATS_PER_BONE = 16
+    }
+}
@@ -14,8 +14,8 @@ enum class GeometryAttribute {
     UV0,
     UV1,
     TANGENT,
-    MORPH_POSITION,
-    MORPH_NORMAL,
+    SKIN_INDEX,
+    SKIN_WEIGHT,
     INSTANCE_MATRIX
 }
 
@@ -25,12 +25,20 @@ data class GeometryAttributeBinding(
     val stepMode: VertexStepMode
 )
 
+/**
+ * [hasMorphTargets] and [morphTargetCount] describe the geometry's morph targets; they are
+ * not part of the vertex streams but encoded separately by a [MorphTargetBuffer].
+ */
 data class GeometryMetadata(
     val bindings: List<GeometryAttributeBinding>,
     val hasMorphTargets: Boolean,
     val morphTargetCount: Int,
     val isInstanced: Boolean
 ) {
+    /** True when both skin attributes are packed, i.e. the mesh is skinned on the GPU. */
+    val isSkinned: Boolean
+        get() = has(GeometryAttribute.SKIN_INDEX) && has(GeometryAttribute.SKIN_WEIGHT)
+
     fun has(attribute: GeometryAttribute): Boolean = bindings.any { it.attribute == attribute }
 
     fun bindingFor(attribute: GeometryAttribute): GeometryAttributeBinding? =
@@ -58,6 +66,7 @@ data class GeometryBuildOptions(
     val includeUVs: Boolean = true,
     val includeSecondaryUVs: Boolean = true,
     val includeTangents: Boolean = true,
+    val includeSkinning: Boolean = true,
     val includeMorphTargets: Boolean = true,
     val includeInstancing: Boolean = true
 )
@@ -70,6 +79,8 @@ object GeometryBuilder {
     private const val UV_ATTR = "uv"
     private const val UV2_ATTR = "uv2"
     private const val TANGENT_ATTR = "tangent"
+    private const val SKIN_INDEX_ATTR = "skinIndex"
+    private const val SKIN_WEIGHT_ATTR = "skinWeight"
 
     fun build(
         geometry: BufferGeometry,
@@ -89,10 +100,13 @@ object GeometryBuilder {
             IntArray(attr.count) { attr.getX(it).toInt() }
         }
 
+        val morphTargetCount = if (options.includeMorphTargets) {
+            geometry.morphAttributes[POSITION_ATTR]?.size ?: 0
+        } else 0
         val metadata = GeometryMetadata(
             bindings = vertexStream.bindings + (instanceStream?.bindings ?: emptyList()),
-            hasMorphTargets = geometry.morphAttributes.isNotEmpty(),
-            morphTargetCount = geometry.morphAttributes.values.maxOfOrNull { it.size } ?: 0,
+            hasMorphTargets = morphTargetCount > 0,
+            morphTargetCount = morphTargetCount,
             isInstanced = instanceStream != null
         )
 
@@ -144,6 +158,10 @@ object GeometryBuilder {
         val colors = if (options.includeColors) geometry.getAttribute(COLOR_ATTR) else null
         val uv = if (options.includeUVs) geometry.getAttribute(UV_ATTR) else null
         val uv2 = if (options.includeSecondaryUVs) geometry.getAttribute(UV2_ATTR) else null
+        // Skinning needs indices and weights together; one without the other is ignored
+        val skinIndex = if (options.includeSkinning) geometry.getAttribute(SKIN_INDEX_ATTR) else null
+        val skinWeight = if (options.includeSkinning) geometry.getAttribute(SKIN_WEIGHT_ATTR) else null
+        val skinned = skinIndex != null && skinWeight != null
 
         val packedAttributes = mutableListOf<PackedAttribute>()
         packedAttributes += PackedAttribute(
@@ -194,34 +212,23 @@ object GeometryBuilder {
             includeWhenMissing = options.includeSecondaryUVs,
             attributeType = GeometryAttribute.UV1
         )
-
-        if (options.includeMorphTargets) {
-            geometry.morphAttributes[POSITION_ATTR]?.forEach { attr ->
-                require(attr.itemSize >= 3) {
-                    "Morph position attribute requires itemSize >= 3 (received ${attr.itemSize})"
-                }
-                packedAttributes += PackedAttribute(
-                    attribute = attr,
-                    componentCount = 3,
-                    defaultValue = ZERO3,
-                    format = VertexFormat.FLOAT32X3,
-                    includeWhenMissing = true,
-                    attributeType = GeometryAttribute.MORPH_POSITION
-                )
-            }
-            geometry.morphAttributes[NORMAL_ATTR]?.forEach { attr ->
-                require(attr.itemSize >= 3) {
-                    "Morph normal attribute requires itemSize >= 3 (received ${attr.itemSize})"
-                }
-                packedAttributes += PackedAttribute(
-                    attribute = attr,
-                    componentCount = 3,
-                    defaultValue = ZERO3,
-                    format = VertexFormat.FLOAT32X3,
-                    includeWhenMissing = true,
-                    attributeType = GeometryAttribute.MORPH_NORMAL
-                )
-            }
+        if (skinned) {
+            packedAttributes += PackedAttribute(
+                attribute = skinIndex,
+                componentCount = 4,
+                defaultValue = null,
+                format = VertexFormat.FLOAT32X4,
+                includeWhenMissing = false,
+                attributeType = GeometryAttribute.SKIN_INDEX
+            )
+            packedAttributes += PackedAttribute(
+                attribute = skinWeight,
+                componentCount = 4,
+                defaultValue = null,
+                format = VertexFormat.FLOAT32X4,
+                includeWhenMissing = false,
+                attributeType = GeometryAttribute.SKIN_WEIGHT
+            )
         }
 
         val attributes = packedAttributes.filter { it.includeWhenMissing || it.attribute != null }
@@ -460,5 +467,4 @@ object GeometryBuilder {
     private val DEFAULT_COLOR = floatArrayOf(1f, 1f, 1f)
     private val DEFAULT_TANGENT = floatArrayOf(1f, 0f, 0f, 1f)
     private val DEFAULT_UV = floatArrayOf(0f, 0f)
-    private val ZERO3 = floatArrayOf(0f, 0f, 0f)
 }
@@ -20,9 +20,8 @@ fun MaterialDescriptor.buildGeometryOptions(geometry: BufferGeometry): GeometryB
         GeometryAttribute.UV0 -> geometry.hasAttribute(UV_ATTR)
         GeometryAttribute.UV1 -> geometry.hasAttribute(UV2_ATTR)
         GeometryAttribute.TANGENT -> geometry.hasAttribute(TANGENT_ATTR)
-        GeometryAttribute.MORPH_POSITION,
-        GeometryAttribute.MORPH_NORMAL -> geometry.morphAttributes.isNotEmpty()
-
+        GeometryAttribute.SKIN_INDEX -> geometry.hasAttribute(SKIN_INDEX_ATTR)
+        GeometryAttribute.SKIN_WEIGHT -> geometry.hasAttribute(SKIN_WEIGHT_ATTR)
         GeometryAttribute.INSTANCE_MATRIX -> geometry.isInstanced
     }
 
@@ -37,6 +36,7 @@ fun MaterialDescriptor.buildGeometryOptions(geometry: BufferGeometry): GeometryB
                 (optional(GeometryAttribute.UV1) && hasAttribute(GeometryAttribute.UV1)),
         includeTangents = requires(GeometryAttribute.TANGENT) ||
                 (optional(GeometryAttribute.TANGENT) && hasAttribute(GeometryAttribute.TANGENT)),
+        includeSkinning = hasAttribute(GeometryAttribute.SKIN_INDEX) && hasAttribute(GeometryAttribute.SKIN_WEIGHT),
         includeMorphTargets = geometry.morphAttributes.isNotEmpty(),
         includeInstancing = geometry.isInstanced || requires(GeometryAttribute.INSTANCE_MATRIX)
     )
@@ -48,3 +48,5 @@ private const val COLOR_ATTR = "color"
 private const val UV_ATTR = "uv"
 private const val UV2_ATTR = "uv2"
 private const val TANGENT_ATTR = "tangent"
+private const val SKIN_INDEX_ATTR = "skinIndex"
+private const val SKIN_WEIGHT_ATTR = "skinWeight"
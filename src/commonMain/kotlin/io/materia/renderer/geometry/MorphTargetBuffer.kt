@@ -0,0 +1,250 @@
+package io.materia.renderer.geometry
+
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import kotlin.math.abs
+
+/**
+ * Morph targets of every morphed geometry a renderer draws, encoded once as sparse,
+ * half-float deltas in one storage buffer so the vertex stage can blend any number of
+ * targets without a vertex attribute per target.
+ *
+ * Each target is a [HEADER_WORDS]-word header `[firstVertex, vertexCount, flags, 0]`
+ * followed by `vertexCount` deltas covering only the vertex range the target moves. A
+ * delta is two words of packed halves `(dx, dy), (dz, 0)`, then two more for the normal
+ * when `flags` has [FLAG_NORMALS]. Absolute targets (`morphTargetsRelative == false`) are
+ * stored relative to the base geometry, so the shader always adds.
+ *
+ * Per draw, [selectActive] picks the strongest influences (at most the slots given, sorted
+ * by magnitude) and reports each as its header word offset; the vertex shader loops over
+ * just those, and skips vertices outside each target's range.
+ *
+ * Renderers upload words `[uploadedWords, wordCount)` after adding geometries, then
+ * [markUploaded]; when [data] outgrows the GPU buffer they recreate it and upload all of it.
+ */
+class MorphTargetBuffer(initialWords: Int = 1024) {
+    init {
+        require(initialWords > 0) { "initialWords must be positive (was $initialWords)" }
+    }
+
+    /** Encoded targets as 32-bit words; only the first [wordCount] are meaningful. */
+    var data: IntArray = IntArray(initialWords)
+        private set
+
+    var wordCount: Int = 0
+        private set
+
+    /** Words already uploaded, per the renderer's last [markUploaded]. */
+    var uploadedWords: Int = 0
+        private set
+
+    val bytes: Int
+        get() = wordCount * Int.SIZE_BYTES
+
+    // Header word offset of each target, per geometry
+    private val entries = LinkedHashMap<BufferGeometry, IntArray>()
+
+    /**
+     * Encodes the morph targets of [geometry] unless already present and returns how many
+     * it has (0 for none).
+     */
+    fun add(geometry: BufferGeometry): Int {
+        entries[geometry]?.let { return it.size }
+        val positions = geometry.morphAttributes[POSITION_ATTR] ?: return 0
+        val base = geometry.getAttribute(POSITION_ATTR) ?: return 0
+        if (positions.isEmpty()) return 0
+        val normals = geometry.morphAttributes[NORMAL_ATTR]
+        val baseNormals = geometry.getAttribute(NORMAL_ATTR)
+        val relative = geometry.morphTargetsRelative
+
+        val headers = IntArray(positions.size) { target ->
+            encodeTarget(base, positions[target], baseNormals, normals?.getOrNull(target), relative)
+        }
+        entries[geometry] = headers
+        return headers.size
+    }
+
+    /** Header word offset of [target] of [geometry], or -1 when not added. */
+    fun headerOf(geometry: BufferGeometry, target: Int): Int =
+        entries[geometry]?.getOrNull(target) ?: -1
+
+    /**
+     * Writes the strongest of [influences] for [geometry] into [headers] and [weights],
+     * strongest first, at most `headers.size` of them; targets with no weight or no
+     * deltas are skipped. Unused slots are zeroed. Returns the number written.
+     */
+    fun selectActive(
+        geometry: BufferGeometry,
+        influences: List<Float>?,
+        headers: FloatArray,
+        weights: FloatArray
+    ): Int {
+        val slots = minOf(headers.size, weights.size)
+        headers.fill(0f)
+        weights.fill(0f)
+        val targets = entries[geometry] ?: return 0
+        if (influences == null) return 0
+
+        var count = 0
+        for (target in 0 until minOf(influences.size, targets.size)) {
+            val weight = influences[target]
+            val magnitude = abs(weight)
+            val header = targets[target]
+            if (magnitude < MIN_INFLUENCE || data[header + 1] == 0) continue
+
+            var slot: Int
+            if (count < slots) {
+                slot = count++
+            } else if (magnitude > abs(weights[slots - 1])) {
+                slot = slots - 1
+            } else {
+                continue
+            }
+            while (slot > 0 && abs(weights[slot - 1]) < magnitude) {
+                weights[slot] = weights[slot - 1]
+                headers[slot] = headers[slot - 1]
+                slot--
+            }
+            weights[slot] = weight
+            headers[slot] = header.toFloat()
+        }
+        return count
+    }
+
+    fun markUploaded() {
+        uploadedWords = wordCount
+    }
+
+    /** Forgets every geometry, e.g. on device loss; the next upload starts from scratch. */
+    fun clear() {
+        entries.clear()
+        wordCount = 0
+        uploadedWords = 0
+    }
+
+    private fun encodeTarget(
+        base: BufferAttribute,
+        target: BufferAttribute,
+        baseNormals: BufferAttribute?,
+        normals: BufferAttribute?,
+        relative: Boolean
+    ): Int {
+        require(target.itemSize >= 3) { "Morph position attribute requires itemSize >= 3 (received ${target.itemSize})" }
+        val vertices = minOf(base.count, target.count)
+        val hasNormals = normals != null && baseNormals != null && normals.itemSize >= 3
+
+        // The moved vertex range is what gets stored
+        var first = -1
+        var last = -1
+        for (v in 0 until vertices) {
+            if (moves(base, target, baseNormals, normals, hasNormals, relative, v)) {
+                if (first < 0) first = v
+                last = v
+            }
+        }
+        val count = if (first < 0) 0 else last - first + 1
+        val stride = if (hasNormals) 4 else 2
+
+        val header = wordCount
+        ensureCapacity(wordCount + HEADER_WORDS + count * stride)
+        data[header] = maxOf(first, 0)
+        data[header + 1] = count
+        data[header + 2] = if (hasNormals) FLAG_NORMALS else 0
+        data[header + 3] = 0
+        var cursor = header + HEADER_WORDS
+        for (v in first until first + count) {
+            cursor = writeDelta(base, target, relative, v, cursor)
+            if (hasNormals) cursor = writeDelta(requireNotNull(baseNormals), requireNotNull(normals), relative, v, cursor)
+        }
+        wordCount = cursor
+        return header
+    }
+
+    private fun moves(
+        base: BufferAttribute,
+        target: BufferAttribute,
+        baseNormals: BufferAttribute?,
+        normals: BufferAttribute?,
+        hasNormals: Boolean,
+        relative: Boolean,
+        v: Int
+    ): Boolean {
+        for (c in 0 until 3) {
+            if (abs(delta(base, target, relative, v, c)) > MIN_DELTA) return true
+            if (hasNormals && abs(delta(requireNotNull(baseNormals), requireNotNull(normals), relative, v, c)) > MIN_DELTA) {
+                return true
+            }
+        }
+        return false
+    }
+
+    private fun writeDelta(base: BufferAttribute, target: BufferAttribute, relative: Boolean, v: Int, at: Int): Int {
+        val x = toHalf(delta(base, target, relative, v, 0))
+        val y = toHalf(delta(base, target, relative, v, 1))
+        val z = toHalf(delta(base, target, relative, v, 2))
+        data[at] = x or (y shl 16)
+        data[at + 1] = z
+        return at + 2
+    }
+
+    private fun delta(base: BufferAttribute, target: BufferAttribute, relative: Boolean, v: Int, c: Int): Float {
+        val value = target.array[v * target.itemSize + c]
+        return if (relative) value else value - base.array[v * base.itemSize + c]
+    }
+
+    private fun ensureCapacity(words: Int) {
+        if (words <= data.size) return
+        var size = data.size
+        while (size < words) size *= 2
+        data = data.copyOf(size)
+    }
+
+    companion object {
+        const val HEADER_WORDS = 4
+        const val FLAG_NORMALS = 1
+
+        /** Active targets evaluated per draw; matches the eight influence slots of the uniform block. */
+        const val MAX_ACTIVE_TARGETS = 8
+
+        private const val MIN_DELTA = 1e-6f
+        private const val MIN_INFLUENCE = 1e-4f
+        private const val POSITION_ATTR = "position"
+        private const val NORMAL_ATTR = "normal"
+
+        /** IEEE half-float bits of [value], rounded to nearest. */
+        fun toHalf(value: Float): Int {
+            val bits = value.toRawBits()
+            val sign = (bits ushr 16) and 0x8000
+            val rawExponent = (bits ushr 23) and 0xFF
+            val mantissa = bits and 0x7FFFFF
+            if (rawExponent == 0xFF) return sign or 0x7C00 or (if (mantissa != 0) 0x200 else 0)
+
+            val exponent = rawExponent - 127 + 15
+            return when {
+                exponent >= 0x1F -> sign or 0x7C00
+                exponent <= 0 -> {
+                    if (exponent < -10) return sign
+                    val full = mantissa or 0x800000
+                    val shift = 14 - exponent
+                    sign or ((full + (1 shl (shift - 1))) ushr shift)
+                }
+
+                else -> sign or (((exponent shl 10) or (mantissa ushr 13)) + ((mantissa ushr 12) and 1))
+            }
+        }
+
+        /** Float value of half-float [bits] (low 16 bits). */
+        fun fromHalf(bits: Int): Float {
+            val sign = if (bits and 0x8000 != 0) -1f else 1f
+            val exponent = (bits ushr 10) and 0x1F
+            val mantissa = bits and 0x3FF
+            return when (exponent) {
+                0 -> sign * mantissa * HALF_SUBNORMAL
+                0x1F -> if (mantissa == 0) sign * Float.POSITIVE_INFINITY else Float.NaN
+                else -> sign * Float.fromBits(((exponent - 15 + 127) shl 23) or (mantissa shl 13))
+            }
+        }
+
+        private const val HALF_SUBNORMAL = 5.9604645e-8f
+    }
+}
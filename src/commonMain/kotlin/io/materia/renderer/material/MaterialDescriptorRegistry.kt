@@ -147,7 +147,7 @@ object MaterialDescriptorRegistry {
         name = "Uniforms",
         group = 0,
         binding = 0,
-        sizeBytes = 352,
+        sizeBytes = 416,
         fields = listOf(
             MaterialUniformField("projectionMatrix", MaterialUniformType.MAT4, offset = 0),
             MaterialUniformField("viewMatrix", MaterialUniformType.MAT4, offset = 64),
@@ -161,7 +161,15 @@ object MaterialDescriptorRegistry {
             MaterialUniformField("mainLightDirection", MaterialUniformType.VEC4, offset = 288),
             MaterialUniformField("mainLightColor", MaterialUniformType.VEC4, offset = 304),
             MaterialUniformField("morphInfluences0", MaterialUniformType.VEC4, offset = 320),
-            MaterialUniformField("morphInfluences1", MaterialUniformType.VEC4, offset = 336)
+            MaterialUniformField("morphInfluences1", MaterialUniformType.VEC4, offset = 336),
+            // x = first bone in the frame's bone palette, y = bone count (0 = not skinned)
+            MaterialUniformField("skinningParams", MaterialUniformType.VEC4, offset = 352),
+            // Header word offsets in the morph target buffer of the active targets whose
+            // weights are in morphInfluences0/1, strongest first
+            MaterialUniformField("morphTargets0", MaterialUniformType.VEC4, offset = 368),
+            MaterialUniformField("morphTargets1", MaterialUniformType.VEC4, offset = 384),
+            // x = active morph target count (0 = no morphing)
+            MaterialUniformField("morphParams", MaterialUniformType.VEC4, offset = 400)
         )
     )
 
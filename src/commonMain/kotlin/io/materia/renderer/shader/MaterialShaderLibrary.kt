@@ -142,6 +142,10 @@ private object BuiltInMaterialChunks {
                     mainLightColor: vec4<f32>,
                     morphInfluences0: vec4<f32>,
                     morphInfluences1: vec4<f32>,
+                    skinningParams: vec4<f32>,
+                    morphTargets0: vec4<f32>,
+                    morphTargets1: vec4<f32>,
+                    morphParams: vec4<f32>,
                 };
 
                 @group(0) @binding(0) var<uniform> uniforms: Uniforms;
@@ -171,6 +175,7 @@ private object BuiltInMaterialChunks {
             source = """
                 #include <common.uniforms>
                 #include <material.basic.vertex.input>
+                {{VERTEX_BINDINGS}}
 
                 @vertex
                 fn vs_main(in: VertexInput) -> BasicVertexOutput {
@@ -241,6 +246,7 @@ private object BuiltInMaterialChunks {
             source = """
                 #include <common.uniforms>
                 #include <material.pbr.vertex.input>
+                {{VERTEX_BINDINGS}}
 
                 @vertex
                 fn vs_main(in: PbrVertexInput) -> PbrVertexOutput {
@@ -244,3 +244,11 @@ object GPUTextureUsage {
     const val STORAGE_BINDING = 0x08
     const val RENDER_ATTACHMENT = 0x10
 }
+
+/**
+ * GPU buffer map mode flags.
+ */
+object GPUMapMode {
+    const val READ = 0x0001
+    const val WRITE = 0x0002
+}
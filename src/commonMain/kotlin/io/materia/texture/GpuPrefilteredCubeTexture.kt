@@ -0,0 +1,57 @@
+package io.materia.texture
+
+import io.materia.renderer.TextureFormat
+
+/**
+ * Implemented by renderers that can prefilter environment maps on the GPU.
+ *
+ * [PMREMGenerator.prefilter] hands such renderers a [GpuPrefilteredCubeTexture] instead of
+ * integrating the GGX lobes on the CPU.
+ */
+interface GpuEnvironmentPrefilter {
+    /** True when [GpuPrefilteredCubeTexture]s bound as scene environments are filtered on the GPU. */
+    val supportsGpuPrefilter: Boolean
+}
+
+/**
+ * Environment cube map whose prefiltering is left to the renderer.
+ *
+ * Holds the unfiltered [source] — a [CubeTexture] or an equirectangular [Texture2D] — and
+ * carries no pixels of its own. The first time it is bound as a scene environment the
+ * renderer converts the source to a cube, prefilters [roughnessLevels] GGX mip levels of
+ * [size] and smaller with [sampleCount] samples per texel, and projects the radiance onto
+ * third-order spherical harmonics. [sphericalHarmonics] stays null until that projection
+ * has been read back, a few frames later.
+ */
+class GpuPrefilteredCubeTexture(
+    val source: Texture,
+    override val size: Int,
+    val roughnessLevels: Int,
+    val sampleCount: Int
+) : Texture(), io.materia.renderer.CubeTexture {
+
+    override val width: Int get() = size
+    override val height: Int get() = size
+
+    /** Irradiance SH9 of the source, available once the renderer has read it back. */
+    var sphericalHarmonics: SphericalHarmonics? = null
+
+    init {
+        require(source is CubeTexture || source is Texture2D) { "Source must be a cube map or an equirectangular Texture2D" }
+        require(size > 0) { "size must be > 0 (was $size)" }
+        require(source !is CubeTexture || source.size == size) { "Cube sources keep their face size ${source.size}" }
+        require(roughnessLevels > 0) { "roughnessLevels must be > 0 (was $roughnessLevels)" }
+        require(sampleCount > 0) { "sampleCount must be > 0 (was $sampleCount)" }
+        name = "${source.name}_pmrem"
+        format = TextureFormat.RGBA16F
+        mapping = TextureMapping.CUBE_REFLECTION
+        generateMipmaps = roughnessLevels > 1
+        flipY = false
+    }
+
+    override fun clone(): GpuPrefilteredCubeTexture =
+        GpuPrefilteredCubeTexture(source, size, roughnessLevels, sampleCount).apply {
+            copy(this@GpuPrefilteredCubeTexture)
+            sphericalHarmonics = this@GpuPrefilteredCubeTexture.sphericalHarmonics
+        }
+}
@@ -19,8 +19,58 @@ import kotlin.math.sqrt
  *
  * Produces filtered cube maps suitable for physically based lighting by
  * importance sampling the source environment with a GGX distribution.
+ *
+ * [prefilter] leaves the work to the renderer when it implements
+ * [GpuEnvironmentPrefilter]; [fromCubeMap] and [fromEquirectangular] always integrate
+ * on the CPU and remain the path for headless use and backends without compute.
+ *
+ * @param preferGpu Set to false to make [prefilter] filter on the CPU regardless of the renderer.
  */
-class PMREMGenerator(private val renderer: Renderer) {
+class PMREMGenerator(
+    private val renderer: Renderer,
+    private val preferGpu: Boolean = true
+) {
+
+    /** True when [prefilter] defers to the renderer's GPU passes. */
+    val usesGpu: Boolean
+        get() = preferGpu && (renderer as? GpuEnvironmentPrefilter)?.supportsGpuPrefilter == true
+
+    /**
+     * Pre-filter [source], a cube map or an equirectangular [Texture2D], for use as a scene
+     * environment.
+     *
+     * Returns a [GpuPrefilteredCubeTexture] that the renderer filters on first use when
+     * [usesGpu] is set, and a CPU-filtered [CubeTexture] otherwise.
+     *
+     * @param cubeSize Face resolution of the result; cube sources keep their own size.
+     */
+    fun prefilter(
+        source: Texture,
+        cubeSize: Int = DEFAULT_CUBE_SIZE,
+        sampleCount: Int = 256,
+        roughnessLevels: Int = DEFAULT_ROUGHNESS_LEVELS
+    ): io.materia.renderer.CubeTexture {
+        require(sampleCount > 0) { "sampleCount must be > 0 (was $sampleCount)" }
+        require(roughnessLevels > 0) { "roughnessLevels must be > 0 (was $roughnessLevels)" }
+        val size = when (source) {
+            is CubeTexture -> {
+                require(source.isComplete()) { "Cube texture must have data for all faces" }
+                source.size
+            }
+
+            is Texture2D -> cubeSize
+            else -> throw IllegalArgumentException("PMREMGenerator expects a CubeTexture or Texture2D")
+        }
+
+        if (usesGpu) {
+            val levels = roughnessLevels.coerceAtMost(1 + log2Floor(size))
+            return GpuPrefilteredCubeTexture(source, size, levels, sampleCount)
+        }
+        return when (source) {
+            is CubeTexture -> fromCubeMap(source, sampleCount, roughnessLevels)
+            else -> fromEquirectangular(source, cubeSize, sampleCount, roughnessLevels)
+        }
+    }
 
     /**
      * Generate a pre-filtered environment map from an existing cube texture.
@@ -138,6 +188,8 @@ class PMREMGenerator(private val renderer: Renderer) {
 
     /**
      * Compute third-order spherical harmonics coefficients from the cube map.
+     *
+     * GPU-filtered environments report theirs in [GpuPrefilteredCubeTexture.sphericalHarmonics].
      */
     fun generateSphericalHarmonics(
         cubeTexture: CubeTexture,
@@ -33,6 +33,10 @@ class Texture2D(
     private var _data: ByteArray? = null
     private var _floatData: FloatArray? = null
 
+    // Sub-rectangles written through setRegion since the last upload
+    private val _dirtyRegions = mutableListOf<TextureRegion>()
+    private var fullUploadPending = true
+
     companion object {
         /**
          * Create a texture from image data
@@ -162,6 +166,49 @@ class Texture2D(
     fun setData(data: ByteArray) {
         _data = data.copyOf()
         _floatData = null
+        markFullUpload()
+    }
+
+    /**
+     * Write RGBA8 [data] into the [regionWidth] x [regionHeight] area at ([x], [y]),
+     * keeping the rest of the image. Renderers that support partial uploads copy only
+     * the [dirtyRegions] instead of the whole image.
+     */
+    fun setRegion(x: Int, y: Int, regionWidth: Int, regionHeight: Int, data: ByteArray) {
+        require(x >= 0 && y >= 0 && regionWidth >= 0 && regionHeight >= 0 &&
+            x + regionWidth <= width && y + regionHeight <= height) {
+            "Region ${regionWidth}x$regionHeight at ($x, $y) exceeds ${width}x$height texture"
+        }
+        require(data.size >= regionWidth * regionHeight * 4) { "Region data too small" }
+        val target = _data ?: ByteArray(width * height * 4).also {
+            _data = it
+            _floatData = null
+            fullUploadPending = true
+        }
+        val rowBytes = regionWidth * 4
+        for (row in 0 until regionHeight) {
+            data.copyInto(target, ((y + row) * width + x) * 4, row * rowBytes, (row + 1) * rowBytes)
+        }
+        if (!fullUploadPending) _dirtyRegions += TextureRegion(x, y, regionWidth, regionHeight)
+        needsUpdate = true
+        version++
+    }
+
+    /** True when the whole image must be (re)uploaded; [dirtyRegions] is then empty. */
+    val needsFullUpload: Boolean get() = fullUploadPending
+
+    /** Regions changed by [setRegion] since the last [markUploaded]. */
+    val dirtyRegions: List<TextureRegion> get() = _dirtyRegions
+
+    /** Called by renderers once the current image is on the GPU. */
+    fun markUploaded() {
+        _dirtyRegions.clear()
+        fullUploadPending = false
+    }
+
+    private fun markFullUpload() {
+        _dirtyRegions.clear()
+        fullUploadPending = true
         needsUpdate = true
         version++
     }
@@ -173,8 +220,7 @@ class Texture2D(
         _floatData = data.copyOf()
         _data = null
         type = TextureType.FLOAT
-        needsUpdate = true
-        version++
+        markFullUpload()
     }
 
     /**
@@ -182,6 +228,9 @@ class Texture2D(
      */
     fun getData(): ByteArray? = _data?.copyOf()
 
+    /** Backing bytes without the defensive copy, for renderer uploads. */
+    internal fun peekData(): ByteArray? = _data
+
     /**
      * Get texture data as float array
      */
@@ -304,4 +353,14 @@ class Texture2D(
  */
 enum class GradientDirection {
     HORIZONTAL, VERTICAL, DIAGONAL, RADIAL
-}
\ No newline at end of file
+}
+
+/**
+ * Texel rectangle of a [Texture2D], used to track partial updates
+ */
+data class TextureRegion(
+    val x: Int,
+    val y: Int,
+    val width: Int,
+    val height: Int
+)
@@ -0,0 +1,163 @@
+package io.materia.animation
+
+import io.materia.animation.AnimationCompressor.AnimationTrack
+import io.materia.animation.AnimationCompressor.Keyframe
+import io.materia.animation.compression.QuaternionCompressor
+import io.materia.animation.skeleton.Bone
+import io.materia.core.math.Quaternion
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Group
+import kotlinx.coroutines.test.runTest
+import kotlin.math.abs
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Cursor seeking, in-place pose blending, quantized sampling and parallel mixer updates.
+ */
+class AnimationPoseTest {
+
+    @Test
+    fun testCursorMatchesLinearScan() {
+        val times = FloatArray(50) { it * 0.1f }
+        val cursor = KeyCursor()
+        val random = Random(3)
+        val samples = List(200) { it * 0.013f % 5f } + List(100) { random.nextFloat() * 6f - 0.5f }
+
+        for (time in samples) {
+            var expected = 0
+            for (i in times.indices) if (time >= times[i]) expected = i
+            assertEquals(expected, cursor.seek(times, time), "time $time")
+        }
+    }
+
+    @Test
+    fun testMixerBlendsActionsByWeight() {
+        val root = Group()
+        val mixer = DefaultAnimationMixer(root)
+        val a = mixer.clipAction(positionClip("a", 4f))
+        val b = mixer.clipAction(positionClip("b", 8f))
+        a.play()
+        b.play()
+        a.weight = 0.25f
+        b.weight = 0.75f
+
+        mixer.update(0.5f)
+
+        assertEquals(0.5f * (0.25f * 4f + 0.75f * 8f), root.position.x, 1e-4f)
+        assertEquals(1f, root.scale.x, "Unanimated channels are left alone")
+    }
+
+    @Test
+    fun testPartialWeightKeepsRestOfCurrentValue() {
+        val root = Group()
+        root.quaternion.setFromAxisAngle(Vector3(0f, 1f, 0f), 0f)
+        val mixer = DefaultAnimationMixer(root)
+        val target = Quaternion().setFromAxisAngle(Vector3(0f, 1f, 0f), 1f)
+        val track = KeyframeTrack(
+            "bone.quaternion",
+            floatArrayOf(0f, 1f),
+            floatArrayOf(target.x, target.y, target.z, target.w, target.x, target.y, target.z, target.w)
+        )
+        mixer.clipAction(AnimationClip("turn", 1f, listOf(track))).apply { weight = 0.5f }.play()
+
+        mixer.update(0.1f)
+
+        val halfway = Quaternion().setFromAxisAngle(Vector3(0f, 1f, 0f), 0.5f)
+        assertEquals(halfway.y, root.quaternion.y, 1e-4f)
+        assertEquals(halfway.w, root.quaternion.w, 1e-4f)
+    }
+
+    @Test
+    fun testQuaternionPackRoundTrips() {
+        val random = Random(9)
+        val out = FloatArray(4)
+        repeat(100) {
+            val q = Quaternion(
+                random.nextFloat() * 2f - 1f,
+                random.nextFloat() * 2f - 1f,
+                random.nextFloat() * 2f - 1f,
+                random.nextFloat() * 2f - 1f
+            ).normalize()
+            QuaternionCompressor.unpack(QuaternionCompressor.pack(q.x, q.y, q.z, q.w, 16), 16, out, 0)
+            val dot = abs(q.x * out[0] + q.y * out[1] + q.z * out[2] + q.w * out[3])
+            assertTrue(dot > 0.99999f, "dot $dot")
+        }
+    }
+
+    @Test
+    fun testQuantizedTracksSampleLikeFloatTracks() {
+        val rotations = List(5) { Quaternion().setFromAxisAngle(Vector3(0f, 0f, 1f), it * 0.4f) }
+        val rotationTrack = AnimationTrack(
+            "quaternion",
+            AnimationTrack.TrackType.ROTATION,
+            rotations.mapIndexed { i, q -> Keyframe(i * 0.25f, floatArrayOf(q.x, q.y, q.z, q.w)) }.toMutableList()
+        )
+        val positionTrack = AnimationTrack(
+            "position",
+            AnimationTrack.TrackType.POSITION,
+            MutableList(5) { Keyframe(it * 0.25f, floatArrayOf(it * 2f, -it.toFloat(), 3f)) }
+        )
+        val quantized = AnimationClip(
+            "quantized", 1f, emptyList(),
+            listOf(AnimationCompressor.quantize(rotationTrack), AnimationCompressor.quantize(positionTrack))
+        )
+        val root = Group()
+        val mixer = DefaultAnimationMixer(root)
+        mixer.clipAction(quantized).play()
+
+        mixer.update(0.625f)
+
+        val expected = Quaternion().setFromAxisAngle(Vector3(0f, 0f, 1f), 1f)
+        assertEquals(expected.z, root.quaternion.z, 1e-3f)
+        assertEquals(expected.w, root.quaternion.w, 1e-3f)
+        assertEquals(5f, root.position.x, 1e-3f)
+        assertEquals(-2.5f, root.position.y, 1e-3f)
+        assertEquals(3f, root.position.z, 1e-3f)
+    }
+
+    @Test
+    fun testParallelUpdateMatchesSerial() = runTest {
+        val serial = List(20) { DefaultAnimationMixer(Group()) }
+        val parallel = List(20) { DefaultAnimationMixer(Group()) }
+        for (i in serial.indices) {
+            serial[i].clipAction(positionClip("c$i", i.toFloat())).play()
+            parallel[i].clipAction(positionClip("c$i", i.toFloat())).play()
+        }
+
+        repeat(5) {
+            serial.forEach { it.update(0.1f) }
+            DefaultAnimationMixer.updateParallel(parallel, 0.1f, tasks = 3)
+        }
+
+        for (i in serial.indices) {
+            assertEquals(serial[i].root.position.x, parallel[i].root.position.x, 1e-6f)
+        }
+    }
+
+    @Test
+    fun testSkeletalTracksBlendIntoBones() {
+        val bone = Bone("arm")
+        val system = DefaultSkeletalAnimationSystem(Skeleton(listOf(bone)))
+        val track = KeyframeTrack(
+            "arm",
+            floatArrayOf(0f, 1f),
+            floatArrayOf(0f, 0f, 0f, 0f, 0f, 0f, 1f, 1f, 1f, 1f, 4f, 0f, 0f, 0f, 0f, 0f, 1f, 2f, 2f, 2f)
+        )
+        system.playAnimation(AnimationClip("reach", 1f, listOf(track)), weight = 0.5f)
+
+        system.update(0.5f)
+
+        val transform = system.getBoneTransform(0)
+        assertEquals(1f, transform.getTranslation().x, 1e-4f)
+        assertEquals(1.25f, transform.getScale().x, 1e-4f)
+    }
+
+    private fun positionClip(name: String, distance: Float) = AnimationClip(
+        name, 1f, listOf(
+            KeyframeTrack("position", floatArrayOf(0f, 1f), floatArrayOf(0f, 0f, 0f, distance, 0f, 0f))
+        )
+    )
+}
@@ -0,0 +1,137 @@
+package io.materia.geometry
+
+import io.materia.geometry.processing.LODGenerator
+import io.materia.geometry.processing.LodGenerationOptions
+import io.materia.geometry.processing.MeshSimplifier
+import io.materia.geometry.processing.SimplificationOptions
+import io.materia.geometry.processing.VertexWelder
+import kotlinx.coroutines.test.runTest
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Quadric simplification reaches its target without moving borders or flipping faces,
+ * and spatial welding matches a brute-force scan.
+ */
+class MeshSimplifierTest {
+
+    private val size = 32
+
+    // Gently curved size x size grid facing +z, with uvs laid out on the grid
+    private fun grid(): BufferGeometry {
+        val stride = size + 1
+        val positions = FloatArray(stride * stride * 3)
+        val uvs = FloatArray(stride * stride * 2)
+        for (y in 0..size) {
+            for (x in 0..size) {
+                val v = y * stride + x
+                positions[v * 3] = x.toFloat()
+                positions[v * 3 + 1] = y.toFloat()
+                positions[v * 3 + 2] = 0.02f * ((x - size / 2) * (x - size / 2)).toFloat() / size
+                uvs[v * 2] = x.toFloat() / size
+                uvs[v * 2 + 1] = y.toFloat() / size
+            }
+        }
+        val indices = FloatArray(size * size * 6)
+        var i = 0
+        for (y in 0 until size) {
+            for (x in 0 until size) {
+                val a = (y * stride + x).toFloat()
+                val b = a + 1
+                val c = a + stride
+                val d = c + 1
+                indices[i++] = a; indices[i++] = b; indices[i++] = c
+                indices[i++] = b; indices[i++] = d; indices[i++] = c
+            }
+        }
+        return BufferGeometry().apply {
+            setAttribute("position", BufferAttribute(positions, 3))
+            setAttribute("uv", BufferAttribute(uvs, 2))
+            setIndex(BufferAttribute(indices, 1))
+        }
+    }
+
+    private fun normalZ(geometry: BufferGeometry, triangle: Int): Float {
+        val p = requireNotNull(geometry.getAttribute("position"))
+        val index = requireNotNull(geometry.index)
+        val a = index.array[triangle * 3].toInt()
+        val b = index.array[triangle * 3 + 1].toInt()
+        val c = index.array[triangle * 3 + 2].toInt()
+        val e1x = p.getX(b) - p.getX(a)
+        val e1y = p.getY(b) - p.getY(a)
+        val e2x = p.getX(c) - p.getX(a)
+        val e2y = p.getY(c) - p.getY(a)
+        return e1x * e2y - e1y * e2x
+    }
+
+    @Test
+    fun testSimplifyReachesTargetWithoutFlips() {
+        val source = grid()
+        val target = source.getTriangleCount() / 4
+
+        val simplified = MeshSimplifier().simplifyGeometry(source, target)
+
+        val triangles = simplified.getTriangleCount()
+        assertTrue(triangles in 1..target, "$triangles triangles for target $target")
+        for (t in 0 until triangles) assertTrue(normalZ(simplified, t) > 0f, "triangle $t flipped")
+    }
+
+    @Test
+    fun testLockedBordersKeepEveryBoundaryVertex() {
+        val simplified = MeshSimplifier().simplifyGeometry(grid(), 200, SimplificationOptions(lockBorders = true))
+
+        val position = requireNotNull(simplified.getAttribute("position"))
+        val uv = requireNotNull(simplified.getAttribute("uv"))
+        val kept = HashSet<Pair<Float, Float>>()
+        for (v in 0 until position.count) {
+            kept.add(position.getX(v) to position.getY(v))
+            // Half-edge collapses never interpolate, so uvs still match their positions
+            assertEquals(position.getX(v) / size, uv.getX(v), 1e-6f)
+        }
+        for (i in 0..size) {
+            val s = i.toFloat()
+            val edge = size.toFloat()
+            assertTrue((s to 0f) in kept && (s to edge) in kept && (0f to s) in kept && (edge to s) in kept)
+        }
+    }
+
+    @Test
+    fun testWeldMatchesBruteForce() {
+        val random = Random(7)
+        val count = 2_000
+        val positions = FloatArray(count * 3) { random.nextInt(20) * 0.5f + random.nextFloat() * 0.01f }
+        val threshold = 0.05f
+
+        val remap = VertexWelder.weldPositions(positions, 3, count, threshold)
+
+        for (i in 0 until count) {
+            var expected = i
+            for (j in 0 until i) {
+                if (remap[j] != j) continue
+                val dx = positions[j * 3] - positions[i * 3]
+                val dy = positions[j * 3 + 1] - positions[i * 3 + 1]
+                val dz = positions[j * 3 + 2] - positions[i * 3 + 2]
+                if (dx * dx + dy * dy + dz * dz <= threshold * threshold) {
+                    expected = j
+                    break
+                }
+            }
+            assertEquals(expected, remap[i], "vertex $i")
+        }
+    }
+
+    @Test
+    fun testParallelLodChainShrinks() = runTest {
+        val options = LodGenerationOptions(lodLevels = 4, initialReduction = 0.5f, minimumTriangles = 10)
+
+        val result = LODGenerator().generateLodLevelsParallel(grid(), options)
+
+        assertEquals(4, result.levels.size)
+        result.levels.zipWithNext { finer, coarser ->
+            assertTrue(coarser.triangleCount < finer.triangleCount)
+            assertTrue(coarser.distance > finer.distance)
+        }
+    }
+}
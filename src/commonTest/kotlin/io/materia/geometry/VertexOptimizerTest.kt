@@ -0,0 +1,134 @@
+package io.materia.geometry
+
+import io.materia.geometry.processing.IndexOptimizer
+import io.materia.geometry.processing.VertexOptimizer
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Vertex cache, overdraw and vertex fetch reordering keep the mesh and improve its order.
+ */
+class VertexOptimizerTest {
+
+    private val size = 48
+    private val vertexCount = (size + 1) * (size + 1)
+
+    // Row-major quads of a size x size grid, two triangles each
+    private fun grid(): IntArray {
+        val indices = IntArray(size * size * 6)
+        var i = 0
+        for (y in 0 until size) {
+            for (x in 0 until size) {
+                val a = y * (size + 1) + x
+                val b = a + 1
+                val c = a + size + 1
+                val d = c + 1
+                indices[i++] = a; indices[i++] = c; indices[i++] = b
+                indices[i++] = b; indices[i++] = c; indices[i++] = d
+            }
+        }
+        return indices
+    }
+
+    private fun shuffled(indices: IntArray, seed: Int): IntArray {
+        val order = (0 until indices.size / 3).shuffled(Random(seed))
+        return IntArray(indices.size) { indices[order[it / 3] * 3 + it % 3] }
+    }
+
+    private fun triangles(indices: IntArray): List<List<Int>> =
+        (0 until indices.size / 3).map { listOf(indices[it * 3], indices[it * 3 + 1], indices[it * 3 + 2]) }
+            .sortedWith(compareBy({ it[0] }, { it[1] }, { it[2] }))
+
+    private fun positions(): FloatArray = FloatArray(vertexCount * 3) { i ->
+        val v = i / 3
+        when (i % 3) {
+            0 -> (v % (size + 1)).toFloat()
+            1 -> (v / (size + 1)).toFloat()
+            else -> 0f
+        }
+    }
+
+    @Test
+    fun testVertexCacheOrderCutsMisses() {
+        val input = shuffled(grid(), 1)
+        val before = IndexOptimizer.averageCacheMissRatio(input, vertexCount)
+
+        val optimized = IndexOptimizer.optimizeVertexCache(input, vertexCount)
+        val after = IndexOptimizer.averageCacheMissRatio(optimized, vertexCount)
+
+        assertEquals(triangles(input), triangles(optimized), "Same triangles with the same winding")
+        assertTrue(before > 2f, "shuffled ACMR $before")
+        assertTrue(after < 0.9f, "optimized ACMR $after")
+        assertTrue(after < IndexOptimizer.averageCacheMissRatio(grid(), vertexCount))
+    }
+
+    @Test
+    fun testOverdrawOrderStaysWithinThreshold() {
+        val cached = IndexOptimizer.optimizeVertexCache(shuffled(grid(), 2), vertexCount)
+        val threshold = 1.05f
+
+        val reordered = IndexOptimizer.optimizeOverdraw(cached, positions(), vertexCount, threshold = threshold)
+
+        assertEquals(triangles(cached), triangles(reordered))
+        val before = IndexOptimizer.averageCacheMissRatio(cached, vertexCount)
+        val after = IndexOptimizer.averageCacheMissRatio(reordered, vertexCount)
+        assertTrue(after <= before * threshold, "ACMR $before -> $after")
+    }
+
+    @Test
+    fun testVertexFetchRenumbersInFirstUseOrder() {
+        val input = shuffled(grid(), 3)
+        val indices = input.copyOf()
+
+        val remap = IndexOptimizer.optimizeVertexFetch(indices, vertexCount)
+
+        var next = 0
+        for (index in indices) {
+            assertTrue(index <= next, "index $index before $next")
+            if (index == next) next++
+        }
+        assertEquals(vertexCount, next)
+        for (i in input.indices) assertEquals(remap[input[i]], indices[i])
+    }
+
+    @Test
+    fun testGeometryPipelineKeepsGroupsAndAttributes() {
+        val source = shuffled(grid(), 4)
+        val geometry = BufferGeometry().apply {
+            setAttribute("position", BufferAttribute(positions(), 3))
+            setAttribute("uv", BufferAttribute(FloatArray(vertexCount * 2) { it.toFloat() }, 2))
+            setIndex(BufferAttribute(FloatArray(source.size) { source[it].toFloat() }, 1))
+            addGroup(0, 600, materialIndex = 0)
+            addGroup(600, source.size - 600, materialIndex = 1)
+        }
+
+        val optimized = VertexOptimizer().optimizeForRendering(geometry)
+
+        val index = requireNotNull(optimized.index)
+        val position = requireNotNull(optimized.getAttribute("position"))
+        val uv = requireNotNull(optimized.getAttribute("uv"))
+        fun corners(g: BufferGeometry, from: Int, to: Int): List<List<Float>> {
+            val p = requireNotNull(g.getAttribute("position"))
+            val ix = requireNotNull(g.index)
+            return (from until to).map { i ->
+                val v = ix.array[i].toInt()
+                listOf(p.getX(v), p.getY(v))
+            }.chunked(3).map { it.flatten() }.sortedWith(compareBy({ it[0] }, { it[1] }, { it[2] }, { it[3] }))
+        }
+        for (group in geometry.groups) {
+            assertEquals(
+                corners(geometry, group.start, group.start + group.count),
+                corners(optimized, group.start, group.start + group.count),
+                "group ${group.materialIndex} keeps its triangles"
+            )
+        }
+        for (v in 0 until vertexCount) {
+            // uv encodes the original vertex number, which must travel with its position
+            val original = (uv.getX(v) / 2f).toInt()
+            assertEquals(original % (size + 1), position.getX(v).toInt())
+        }
+        assertEquals(0, index.array[0].toInt())
+    }
+}
@@ -0,0 +1,197 @@
+package io.materia.lighting
+
+import io.materia.camera.PerspectiveCamera
+import io.materia.core.math.Matrix4
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.Scene
+import io.materia.geometry.primitives.BoxGeometry
+import io.materia.lighting.shadow.CascadedShadowMapImpl
+import io.materia.lighting.shadow.ShadowAtlas
+import io.materia.lighting.shadow.ShadowAtlasRegion
+import io.materia.lighting.shadow.ShadowCascadeImpl
+import io.materia.lighting.shadow.ShadowDepthPass
+import io.materia.renderer.Texture
+import kotlinx.coroutines.test.runTest
+import kotlin.math.abs
+import kotlin.math.round
+import kotlin.math.sqrt
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertIs
+import kotlin.test.assertNotNull
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class CascadedShadowMapTest {
+
+    private class Draw(val target: Texture, val casters: List<Mesh>)
+
+    private class RecordingDepthPass : ShadowDepthPass {
+        val draws = mutableListOf<Draw>()
+
+        override fun renderDepth(
+            target: Texture,
+            region: ShadowAtlasRegion,
+            viewProjection: Matrix4,
+            casters: List<Mesh>,
+            clear: Boolean
+        ) {
+            draws += Draw(target, casters)
+        }
+
+        override fun copyDepth(source: Texture, target: Texture, region: ShadowAtlasRegion) {}
+    }
+
+    private val scene = Scene()
+    private val ground = Mesh(BoxGeometry(200f, 1f, 200f)).apply {
+        position.set(0f, -0.5f, 0f)
+        castShadow = true
+        isStatic = true
+    }
+    private val crate = Mesh(BoxGeometry(1f, 1f, 1f)).apply {
+        position.set(1f, 0.5f, 0f)
+        castShadow = true
+    }
+    private val distant = Mesh(BoxGeometry(1f, 1f, 1f)).apply {
+        position.set(500f, 0.5f, 500f)
+        castShadow = true
+    }
+    private val pebble = Mesh(BoxGeometry(0.02f, 0.02f, 0.02f)).apply {
+        position.set(0f, 4f, 6f)
+        castShadow = true
+    }
+    private val camera = PerspectiveCamera(fov = 60f, aspect = 1f, near = 0.5f, far = 200f).apply {
+        position.set(0f, 5f, 10f)
+        updateMatrixWorld()
+        lookAt(Vector3(0f, 0f, 0f))
+        updateMatrixWorld()
+    }
+    private val light = DirectionalLightImpl(direction = Vector3(-1f, -2f, -1f).normalize())
+    private val depthPass = RecordingDepthPass()
+    private val mapper = ShadowMapperImpl().apply {
+        depthPass = this@CascadedShadowMapTest.depthPass
+        setCullingDistance(60f)
+    }
+
+    init {
+        scene.add(ground)
+        scene.add(crate)
+        scene.add(distant)
+        scene.add(pebble)
+        scene.updateMatrixWorld()
+    }
+
+    private suspend fun render(): CascadedShadowMapImpl {
+        val result = mapper.generateCascadedShadowMap(light, scene, camera, cascadeCount = 4)
+        return assertIs<CascadedShadowMapImpl>(assertIs<ShadowResult.Success<CascadedShadowMap>>(result).data)
+    }
+
+    private fun CascadedShadowMapImpl.cascade(index: Int) = cascades[index] as ShadowCascadeImpl
+
+    private fun drawnCasters() = depthPass.draws.flatMap { it.casters }.toSet()
+
+    @Test
+    fun `cascades split the shadow distance and snap to whole texels`() = runTest {
+        val map = render()
+        assertEquals(5, map.splitDistances.size)
+        assertEquals(0.5f, map.splitDistances.first())
+        assertEquals(60f, map.splitDistances.last())
+
+        for (i in 0 until 4) {
+            val cascade = map.cascade(i)
+            val e = cascade.projectionViewMatrix.elements
+            // The light view has no translation, so the x row is the ortho scale times a unit axis
+            val scale = sqrt(e[0] * e[0] + e[4] * e[4] + e[8] * e[8])
+            val texel = 2f / (scale * cascade.region!!.size)
+            val texelsFromOrigin = -e[12] / scale / texel
+            assertTrue(abs(texelsFromOrigin - round(texelsFromOrigin)) < 1e-2f, "cascade $i is off by a fraction of a texel")
+        }
+    }
+
+    @Test
+    fun `casters are culled per cascade`() = runTest {
+        render()
+        val drawn = drawnCasters()
+        assertTrue(ground in drawn)
+        assertTrue(crate in drawn)
+        assertTrue(pebble in drawn)
+        assertFalse(distant in drawn)
+
+        // Sixteen texels is far larger than the pebble in every cascade
+        depthPass.draws.clear()
+        mapper.setLODBias(4f)
+        render()
+        assertFalse(pebble in drawnCasters())
+
+        depthPass.draws.clear()
+        mapper.enableShadowLOD(false)
+        render()
+        assertTrue(pebble in drawnCasters())
+    }
+
+    @Test
+    fun `far cascade reuses static depth until the light or static casters change`() = runTest {
+        val atlasTexture = mapper.shadowAtlas.texture
+        assertFalse(render().cascade(3).reusedStaticDepth)
+        val staticDraws = depthPass.draws.filter { it.target !== atlasTexture }
+        assertEquals(listOf(listOf(ground)), staticDraws.map { it.casters })
+
+        depthPass.draws.clear()
+        crate.position.x = 2f
+        scene.updateMatrixWorld()
+        val cached = render().cascade(3)
+        assertTrue(cached.reusedStaticDepth)
+        assertTrue(depthPass.draws.all { it.target === atlasTexture })
+        assertFalse(render().cascade(0).reusedStaticDepth)
+
+        ground.position.y = -0.6f
+        ground.updateMatrix()
+        scene.updateMatrixWorld()
+        assertFalse(render().cascade(3).reusedStaticDepth)
+        assertTrue(render().cascade(3).reusedStaticDepth)
+
+        light.direction.set(-1f, -2f, -0.9f).normalize()
+        assertFalse(render().cascade(3).reusedStaticDepth)
+    }
+
+    @Test
+    fun `lights share the atlas without overlapping`() = runTest {
+        val second = DirectionalLightImpl(direction = Vector3(1f, -1f, 0f).normalize()).apply { shadowMapSize = 1024 }
+        light.shadowMapSize = 1024
+        val regions = render().cascades.map { (it as ShadowCascadeImpl).region!! } +
+            assertIs<CascadedShadowMapImpl>(
+                assertIs<ShadowResult.Success<CascadedShadowMap>>(
+                    mapper.generateCascadedShadowMap(second, scene, camera, cascadeCount = 4)
+                ).data
+            ).cascades.map { (it as ShadowCascadeImpl).region!! }
+
+        assertEquals(8, regions.size)
+        for (a in regions.indices) for (b in a + 1 until regions.size) {
+            val r = regions[a]
+            val s = regions[b]
+            val disjoint = r.x + r.size <= s.x || s.x + s.size <= r.x || r.y + r.size <= s.y || s.y + s.size <= r.y
+            assertTrue(disjoint, "tiles $r and $s overlap")
+        }
+        assertEquals(0.5f, mapper.shadowAtlas.occupancy)
+
+        mapper.releaseLight(second)
+        assertEquals(setOf(light.id), mapper.shadowAtlas.lightIds)
+    }
+
+    @Test
+    fun `full atlases shrink tiles down to the minimum`() {
+        val atlas = ShadowAtlas(size = 2048, minRegionSize = 512)
+        val first = assertNotNull(atlas.allocate(1, 3, 1024))
+        assertEquals(first, atlas.allocate(1, 3, 1024))
+
+        // One 1024 tile is left, which holds the two tiles at half size
+        val shrunk = assertNotNull(atlas.allocate(2, 2, 1024))
+        assertEquals(listOf(512, 512), shrunk.map { it.size })
+        assertNull(atlas.allocate(3, 4, 1024))
+
+        atlas.release(1)
+        assertEquals(List(3) { 1024 }, assertNotNull(atlas.allocate(3, 3, 1024)).map { it.size })
+    }
+}
@@ -4,6 +4,7 @@ import io.materia.util.Base64Compat
 import kotlinx.coroutines.test.runTest
 import kotlin.test.Test
 import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
 import kotlin.test.assertIs
 import kotlin.test.assertNotNull
 import kotlin.test.assertTrue
@@ -64,6 +65,131 @@ class GLTFLoaderTest {
         assertEquals(3, positionAttribute.count)
     }
 
+    @Test
+    fun `load GLB with interleaved normalized attributes`() = runTest {
+        // Three vertices of 16 bytes: float3 position and normalized ubyte4 color
+        val bin = ByteArray(48 + 8)
+        for (v in 0 until 3) {
+            val position = floatArrayOf(v.toFloat(), v * 2f, 0f)
+            FloatArrayEncoder.encode(position).copyInto(bin, v * 16)
+            bin[v * 16 + 12] = 255.toByte()
+            bin[v * 16 + 13] = (v * 51).toByte()
+            bin[v * 16 + 14] = 0
+            bin[v * 16 + 15] = 255.toByte()
+        }
+        // uint16 indices 2, 1, 0 after the vertices
+        bin[48] = 2; bin[50] = 1; bin[52] = 0
+
+        val gltfJson = """
+            {
+              "asset": { "version": "2.0" },
+              "buffers": [ { "byteLength": ${bin.size} } ],
+              "bufferViews": [
+                { "buffer": 0, "byteOffset": 0, "byteLength": 48, "byteStride": 16 },
+                { "buffer": 0, "byteOffset": 48, "byteLength": 6 }
+              ],
+              "accessors": [
+                { "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },
+                { "bufferView": 0, "byteOffset": 12, "componentType": 5121, "normalized": true, "count": 3, "type": "VEC4" },
+                { "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" }
+              ],
+              "meshes": [
+                { "primitives": [ { "attributes": { "POSITION": 0, "COLOR_0": 1 }, "indices": 2 } ] },
+                { "primitives": [ { "attributes": { "POSITION": 0 } } ] }
+              ],
+              "nodes": [ { "mesh": 0 }, { "mesh": 1 } ],
+              "scenes": [ { "nodes": [ 0, 1 ] } ]
+            }
+        """.trimIndent()
+
+        val loaded = mutableListOf<Int>()
+        val asset = GLTFLoader().load(
+            "data:model/gltf-binary;base64," + Base64Compat.encode(GlbEncoder.encode(gltfJson, bin)),
+            onMeshLoaded = { index, _ -> loaded.add(index) }
+        )
+
+        assertEquals(listOf(0, 1), loaded.sorted())
+        val mesh = assertIs<io.materia.core.scene.Mesh>(asset.scene.children[0])
+        val position = assertNotNull(mesh.geometry.getAttribute("position"))
+        assertEquals(2f, position.getX(2))
+        assertEquals(4f, position.getY(2))
+        val color = assertNotNull(mesh.geometry.getAttribute("color"))
+        assertEquals(4, color.itemSize)
+        assertEquals(1f, color.getX(1))
+        assertEquals(0.2f, color.getY(1), 1e-6f)
+        val index = assertNotNull(mesh.geometry.index)
+        assertEquals(listOf(2f, 1f, 0f), index.array.toList())
+    }
+
+    @Test
+    fun `draco primitive loads its uncompressed fallback without a decoder`() = runTest {
+        val positions = FloatArrayEncoder.encode(floatArrayOf(0f, 0f, 0f, 1f, 0f, 0f, 0f, 1f, 0f))
+        // Stand-in Draco bytes after the positions; they must not be read
+        val bin = positions + ByteArray(8) { 0x7F }
+
+        fun gltf(positionView: String) = """
+            {
+              "asset": { "version": "2.0" },
+              "extensionsUsed": [ "KHR_draco_mesh_compression" ],
+              "buffers": [ { "byteLength": ${bin.size} } ],
+              "bufferViews": [
+                { "buffer": 0, "byteOffset": 0, "byteLength": ${positions.size} },
+                { "buffer": 0, "byteOffset": ${positions.size}, "byteLength": 8 }
+              ],
+              "accessors": [ { $positionView "componentType": 5126, "count": 3, "type": "VEC3" } ],
+              "meshes": [
+                {
+                  "primitives": [
+                    {
+                      "attributes": { "POSITION": 0 },
+                      "extensions": {
+                        "KHR_draco_mesh_compression": { "bufferView": 1, "attributes": { "POSITION": 0 } }
+                      }
+                    }
+                  ]
+                }
+              ],
+              "nodes": [ { "mesh": 0 } ],
+              "scenes": [ { "nodes": [ 0 ] } ]
+            }
+        """.trimIndent()
+
+        fun glb(json: String) = "data:model/gltf-binary;base64," + Base64Compat.encode(GlbEncoder.encode(json, bin))
+        val loader = GLTFLoader(dracoDecoder = null)
+
+        val asset = loader.load(glb(gltf("\"bufferView\": 0,")))
+        val mesh = assertIs<io.materia.core.scene.Mesh>(asset.scene.children.single())
+        val position = assertNotNull(mesh.geometry.getAttribute("position"))
+        assertEquals(1f, position.getX(1))
+
+        // Draco-only accessors have no bufferView to fall back on
+        assertFailsWith<IllegalStateException> { loader.load(glb(gltf(""))) }
+    }
+
+    private object GlbEncoder {
+        fun encode(json: String, bin: ByteArray): ByteArray {
+            val jsonBytes = json.encodeToByteArray().let { bytes ->
+                bytes + ByteArray((4 - bytes.size % 4) % 4) { ' '.code.toByte() }
+            }
+            val out = ByteArray(12 + 8 + jsonBytes.size + 8 + bin.size)
+            writeInt(out, 0, 0x46546C67)
+            writeInt(out, 4, 2)
+            writeInt(out, 8, out.size)
+            writeInt(out, 12, jsonBytes.size)
+            writeInt(out, 16, 0x4E4F534A)
+            jsonBytes.copyInto(out, 20)
+            val binStart = 20 + jsonBytes.size
+            writeInt(out, binStart, bin.size)
+            writeInt(out, binStart + 4, 0x004E4942)
+            bin.copyInto(out, binStart + 8)
+            return out
+        }
+
+        private fun writeInt(out: ByteArray, offset: Int, value: Int) {
+            for (i in 0 until 4) out[offset + i] = ((value shr (i * 8)) and 0xFF).toByte()
+        }
+    }
+
     private object FloatArrayEncoder {
         fun encode(values: FloatArray): ByteArray {
             val bytes = ByteArray(values.size * 4)
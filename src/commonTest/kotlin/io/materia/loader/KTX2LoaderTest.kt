@@ -1,10 +1,14 @@
 package io.materia.loader
 
+import io.materia.renderer.RendererCapabilities
+import io.materia.texture.CompressedTexture
+import io.materia.texture.CompressedTextureFormat
 import io.materia.texture.Texture2D
 import kotlinx.coroutines.test.runTest
 import kotlin.test.Test
 import kotlin.test.assertEquals
 import kotlin.test.assertIs
+import io.materia.renderer.CompressedTextureFormat as CapabilityFormat
 
 class KTX2LoaderTest {
 
@@ -24,13 +28,143 @@ class KTX2LoaderTest {
         assertEquals(2, texture.height)
     }
 
+    @Test
+    fun `block compressed ktx2 keeps every mip level`() = runTest {
+        // BC1: 8 bytes per 4x4 block, so both the 4x4 and 2x2 levels are one block
+        val file = buildKtx2(
+            width = 4, height = 4, vkFormat = 131u,
+            levels = listOf(ByteArray(8) { 1 }, ByteArray(8) { 2 })
+        )
+        val loader = KTX2Loader(InMemoryResolver(mapOf("tex.ktx2" to file)), transcoder = null)
+        val texture = loader.load("tex.ktx2")
+        assertIs<CompressedTexture>(texture)
+        assertEquals(CompressedTextureFormat.BC1_RGB, texture.compressedFormat)
+        assertEquals(listOf(4 to 4, 2 to 2), texture.compressedMipmaps.map { it.width to it.height })
+        assertEquals(2, texture.getMipmap(1)?.data?.get(0))
+    }
+
+    @Test
+    fun `uastc payload transcodes to a format the renderer supports`() = runTest {
+        val transcoder = TaggingTranscoder(8)
+        val file = buildKtx2(
+            width = 8, height = 8, vkFormat = 0u,
+            levels = listOf(ByteArray(16), ByteArray(16)),
+            dfd = uastcDfd(channelId = 0)
+        )
+        val capabilities = RendererCapabilities(
+            compressedTextureFormats = setOf(CapabilityFormat.BC7, CapabilityFormat.DXT1)
+        )
+        val loader = KTX2Loader(InMemoryResolver(mapOf("tex.ktx2" to file)), capabilities, transcoder)
+        val texture = loader.load("tex.ktx2")
+        assertIs<CompressedTexture>(texture)
+        assertEquals(CompressedTextureFormat.BC7_RGBA, texture.compressedFormat)
+        // Levels transcode concurrently, so check what came back rather than the call order
+        for (level in 0..1) {
+            val data = texture.getMipmap(level)?.data
+            assertEquals(if (level == 0) 64 else 16, data?.size)
+            assertEquals(TaggingTranscoder.tag(level, BasisTargetFormat.BC7), data?.first())
+        }
+    }
+
+    @Test
+    fun `basis target falls back to rgba without compressed support`() = runTest {
+        val transcoder = TaggingTranscoder(2)
+        val file = buildKtx2(
+            width = 2, height = 2, vkFormat = 0u,
+            levels = listOf(ByteArray(16)),
+            dfd = uastcDfd(channelId = 0)
+        )
+        val loader = KTX2Loader(InMemoryResolver(mapOf("tex.ktx2" to file)), RendererCapabilities(), transcoder)
+        val texture = loader.load("tex.ktx2")
+        assertIs<Texture2D>(texture)
+        val data = texture.getData()
+        assertEquals(16, data?.size)
+        assertEquals(TaggingTranscoder.tag(0, BasisTargetFormat.RGBA32), data?.first())
+    }
+
+    @Test
+    fun `basis target selection prefers channel specific formats`() {
+        val all: (BasisTargetFormat) -> Boolean = { true }
+        assertEquals(BasisTargetFormat.ASTC_4x4, BasisTargetFormat.select(BasisPayload.UASTC, true, 4, all))
+        assertEquals(BasisTargetFormat.ETC2_RGBA, BasisTargetFormat.select(BasisPayload.ETC1S, true, 4, all))
+        assertEquals(BasisTargetFormat.BC5, BasisTargetFormat.select(BasisPayload.UASTC, false, 2, all))
+        assertEquals(
+            BasisTargetFormat.BC1,
+            BasisTargetFormat.select(BasisPayload.ETC1S, false, 3) { it == BasisTargetFormat.BC1 }
+        )
+    }
+
+    /**
+     * Fills each level, at the size the target format expects, with a byte tagging the
+     * level and target it was asked for. Holds no state, as levels transcode in parallel.
+     */
+    private class TaggingTranscoder(private val baseSize: Int) : BasisTranscoder {
+        override suspend fun transcode(ktx2: ByteArray, level: Int, target: BasisTargetFormat): ByteArray {
+            val size = maxOf(1, baseSize shr level)
+            return ByteArray(target.levelSize(size, size)) { tag(level, target) }
+        }
+
+        companion object {
+            fun tag(level: Int, target: BasisTargetFormat): Byte = (level * 16 + target.ordinal).toByte()
+        }
+    }
+
+    /** Minimal KHR_DF_MODEL_UASTC descriptor with one sample of [channelId]. */
+    private fun uastcDfd(channelId: Int): ByteArray {
+        val writer = ByteArrayWriter()
+        val blockSize = 24 + 16
+        writer.writeUInt32((4 + blockSize).toUInt())                 // dfdTotalSize
+        writer.writeUInt32(0u)                                       // vendorId / descriptorType
+        writer.writeUInt32((2 or (blockSize shl 16)).toUInt())       // versionNumber / descriptorBlockSize
+        writer.writeBytes(byteArrayOf(166.toByte(), 1, 1, 0))        // colorModel, primaries, transfer, flags
+        writer.writeBytes(byteArrayOf(3, 3, 0, 0, 0, 0, 0, 0))       // texelBlockDimension, bytesPlane0-7
+        writer.writeUInt32(0u)
+        writer.writeBytes(byteArrayOf(0, 0, 127, channelId.toByte())) // bitOffset, bitLength, channelType
+        writer.writeBytes(ByteArray(12))
+        return writer.toByteArray()
+    }
+
+    private fun buildKtx2(
+        width: Int,
+        height: Int,
+        vkFormat: UInt,
+        levels: List<ByteArray>,
+        dfd: ByteArray = ByteArray(0)
+    ): ByteArray {
+        val writer = ByteArrayWriter()
+        writer.writeBytes(IDENTIFIER)
+        val dfdOffset = 80 + levels.size * 24
+        writer.writeUInt32(vkFormat)
+        writer.writeUInt32(1u)
+        writer.writeUInt32(width.toUInt())
+        writer.writeUInt32(height.toUInt())
+        writer.writeUInt32(0u)
+        writer.writeUInt32(0u)
+        writer.writeUInt32(1u)
+        writer.writeUInt32(levels.size.toUInt())
+        writer.writeUInt32(0u)
+        writer.writeUInt32(if (dfd.isEmpty()) 0u else dfdOffset.toUInt())
+        writer.writeUInt32(dfd.size.toUInt())
+        writer.writeUInt32(0u)
+        writer.writeUInt32(0u)
+        writer.writeUInt64(0u)
+        writer.writeUInt64(0u)
+
+        var offset = dfdOffset + dfd.size
+        levels.forEach { level ->
+            writer.writeUInt64(offset.toULong())
+            writer.writeUInt64(level.size.toULong())
+            writer.writeUInt64(level.size.toULong())
+            offset += level.size
+        }
+        writer.writeBytes(dfd)
+        levels.forEach(writer::writeBytes)
+        return writer.toByteArray()
+    }
+
     private fun buildKtx2(width: Int, height: Int, data: ByteArray): ByteArray {
         val writer = ByteArrayWriter()
-        val identifier = byteArrayOf(
-            0xAB.toByte(), 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB.toByte(),
-            0x0D, 0x0A, 0x1A, 0x0A
-        )
-        writer.writeBytes(identifier)
+        writer.writeBytes(IDENTIFIER)
         writer.writeUInt32(37u)                // vkFormat (RGBA8)
         writer.writeUInt32(1u)                 // typeSize
         writer.writeUInt32(width.toUInt())     // pixelWidth
@@ -80,6 +214,13 @@ class KTX2LoaderTest {
         fun toByteArray(): ByteArray = bytes.toByteArray()
     }
 
+    private companion object {
+        val IDENTIFIER = byteArrayOf(
+            0xAB.toByte(), 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB.toByte(),
+            0x0D, 0x0A, 0x1A, 0x0A
+        )
+    }
+
     private class InMemoryResolver(private val files: Map<String, ByteArray>) : AssetResolver {
         override suspend fun load(uri: String, basePath: String?): ByteArray =
             files[uri] ?: error("Missing asset: $uri")
@@ -0,0 +1,70 @@
+package io.materia.loader
+
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+
+class MeshoptDecoderTest {
+
+    private fun bytes(vararg values: Int) = ByteArray(values.size) { values[it].toByte() }
+
+    private fun shorts(data: ByteArray) = List(data.size / 2) {
+        (data[it * 2].toInt() and 0xFF) or ((data[it * 2 + 1].toInt() and 0xFF) shl 8)
+    }
+
+    @Test
+    fun `vertex stream applies byte deltas to the tail baseline`() {
+        // Two 4-byte vertices; byte 0 uses a 2-bit group (deltas 0, +1), the rest are constant
+        val stream = bytes(0xa0, 0x01, 0x20, 0, 0, 0, 0x00, 0x00, 0x00) +
+            ByteArray(28) + bytes(1, 2, 3, 4)
+        val out = ByteArray(8)
+
+        MeshoptDecoder.decodeVertexBuffer(out, 2, 4, stream)
+
+        assertContentEquals(bytes(1, 2, 3, 4, 2, 2, 3, 4), out)
+    }
+
+    @Test
+    fun `triangle stream reuses edges from the fifo`() {
+        // 0xf0 starts a fresh triangle through the aux table, 0x10 extends edge (2, 1) with a new vertex
+        val stream = bytes(0xe1, 0xf0, 0x10) + ByteArray(16)
+        val out = ByteArray(12)
+
+        MeshoptDecoder.decodeIndexBuffer(out, 6, 2, stream)
+
+        assertEquals(listOf(0, 1, 2, 2, 1, 3), shorts(out))
+    }
+
+    @Test
+    fun `index sequence decodes zigzag deltas`() {
+        val stream = bytes(0xd1, 0x00, 0x04, 0x04, 0x0c) + ByteArray(4)
+        val out = ByteArray(8)
+
+        MeshoptDecoder.decodeIndexSequence(out, 4, 2, stream)
+
+        assertEquals(listOf(0, 1, 2, 5), shorts(out))
+    }
+
+    @Test
+    fun `exponential filter rebuilds floats`() {
+        // mantissa 3, exponent -2
+        val data = bytes(3, 0, 0, 0xFE)
+
+        MeshoptDecoder.applyFilter(data, 1, 4, "EXPONENTIAL")
+
+        val bits = (data[0].toInt() and 0xFF) or ((data[1].toInt() and 0xFF) shl 8) or
+            ((data[2].toInt() and 0xFF) shl 16) or ((data[3].toInt() and 0xFF) shl 24)
+        assertEquals(0.75f, Float.fromBits(bits))
+    }
+
+    @Test
+    fun `truncated streams are rejected`() {
+        assertFailsWith<IllegalArgumentException> {
+            MeshoptDecoder.decodeVertexBuffer(ByteArray(8), 2, 4, bytes(0xa0, 0x01, 0x20))
+        }
+        assertFailsWith<IllegalArgumentException> {
+            MeshoptDecoder.decodeIndexSequence(ByteArray(8), 4, 2, bytes(0xe1, 0, 0, 0, 0, 0, 0, 0, 0))
+        }
+    }
+}
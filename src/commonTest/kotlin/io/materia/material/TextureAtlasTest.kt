@@ -0,0 +1,113 @@
+package io.materia.material
+
+import io.materia.material.atlas.createPackerByStrategy
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNotNull
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class TextureAtlasTest {
+
+    private fun overlaps(a: Rectangle, b: Rectangle) =
+        a.x < b.right && b.x < a.right && a.y < b.bottom && b.y < a.bottom
+
+    private fun solid(width: Int, height: Int, value: Int) = ByteArray(width * height * 4) { value.toByte() }
+
+    @Test
+    fun `every strategy packs without overlaps inside the atlas`() {
+        val random = Random(7)
+        val sizes = List(60) { (4 + random.nextInt(28)) to (4 + random.nextInt(28)) }
+        for (strategy in PackingStrategy.values()) {
+            val packer = createPackerByStrategy(strategy, 256, 256)
+            val placed = mutableListOf<Rectangle>()
+            for ((w, h) in sizes) {
+                val rect = packer.findBestFit(w, h, allowRotation = true) ?: continue
+                packer.markRectangleAsUsed(rect)
+                placed += rect
+            }
+            assertTrue(placed.size > 20, "$strategy placed only ${placed.size}")
+            for (rect in placed) {
+                assertTrue(rect.x >= 0 && rect.y >= 0 && rect.right <= 256 && rect.bottom <= 256, "$strategy: $rect")
+            }
+            for (i in placed.indices) for (j in i + 1 until placed.size) {
+                assertFalse(overlaps(placed[i], placed[j]), "$strategy: ${placed[i]} overlaps ${placed[j]}")
+            }
+        }
+    }
+
+    @Test
+    fun `removed slots are reused without repacking`() {
+        for (strategy in PackingStrategy.values()) {
+            val atlas = TextureAtlas(64, 64, strategy, padding = 0)
+            val first = assertNotNull(atlas.add("a", 32, 32, solid(32, 32, 1)))
+            repeat(3) { assertNotNull(atlas.add("b$it", 32, 32, solid(32, 32, 2))) }
+            assertNull(atlas.add("full", 32, 32, solid(32, 32, 3)), "$strategy")
+
+            val kept = atlas["b0"]
+            assertTrue(atlas.remove("a"))
+            val reused = assertNotNull(atlas.add("c", 32, 32, solid(32, 32, 4)), "$strategy")
+            assertEquals(first.x to first.y, reused.x to reused.y)
+            assertEquals(kept, atlas["b0"])
+            assertEquals(1f, atlas.occupancy)
+        }
+    }
+
+    @Test
+    fun `gutter repeats edge texels and uvs address the image`() {
+        val atlas = TextureAtlas(16, 16, padding = 2)
+        val pixels = ByteArray(2 * 2 * 4) { (it / 4 + 1).toByte() } // texel ids 1..4
+        val packed = assertNotNull(atlas.add("img", 2, 2, pixels))
+        assertEquals(2, packed.x)
+        assertEquals(2, packed.y)
+
+        val data = assertNotNull(atlas.texture.getData())
+        fun texel(x: Int, y: Int) = data[(y * 16 + x) * 4].toInt()
+        assertEquals(1, texel(0, 0))  // corner bleed from the top-left texel
+        assertEquals(2, texel(5, 2))  // right gutter repeats the top-right texel
+        assertEquals(4, texel(5, 5))
+
+        val uv = packed.mapUV(1f, 1f)
+        assertEquals(4f / 16f, uv.x)
+        assertEquals(4f / 16f, uv.y)
+    }
+
+    @Test
+    fun `mipmapped atlases align slots to the coarsest level`() {
+        val atlas = TextureAtlas(256, 256, padding = 1, mipLevels = 4)
+        val packed = List(5) { assertNotNull(atlas.add("img$it", 10, 6, solid(10, 6, it))) }
+        for (p in packed) {
+            assertEquals(0, (p.x - 8) % 8, "slot origin of $p")
+            assertEquals(0, (p.y - 8) % 8, "slot origin of $p")
+        }
+    }
+
+    @Test
+    fun `rotated images map uvs through the turn`() {
+        val atlas = TextureAtlas(8, 4, PackingStrategy.MAX_RECTS, padding = 0, allowRotation = true)
+        // 4x8 only fits turned on its side
+        val pixels = ByteArray(4 * 8 * 4).also { it[0] = 9 } // top-left texel differs
+        val packed = assertNotNull(atlas.add("tall", 4, 8, pixels))
+        assertTrue(packed.rotated)
+        assertEquals(8, packed.width)
+
+        // The source's top-left corner lands at the atlas region's top-right corner
+        val corner = packed.mapUV(0f, 0f)
+        assertEquals(1f, corner.x)
+        assertEquals(0f, corner.y)
+        assertEquals(9, atlas.texture.getData()!![7 * 4].toInt())
+    }
+
+    @Test
+    fun `inserts mark only their slot dirty`() {
+        val atlas = TextureAtlas(64, 64, padding = 1)
+        atlas.texture.markUploaded()
+        atlas.add("a", 8, 8, solid(8, 8, 1))
+        val regions = atlas.texture.dirtyRegions
+        assertEquals(1, regions.size)
+        assertEquals(10, regions[0].width)
+        assertFalse(atlas.texture.needsFullUpload)
+    }
+}
@@ -0,0 +1,165 @@
+package io.materia.optimization
+
+import io.materia.core.math.Matrix4
+import kotlinx.coroutines.test.runTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+/**
+ * BVH frustum culling: results must match a brute-force test under insert/move/remove
+ */
+class CullingBvhTest {
+
+    // Clip volume of a 0.1 scale matrix: the cube [-10, 10]^3
+    private val frustum = Frustum().apply { setFromMatrix(Matrix4.scale(0.1f, 0.1f, 0.1f)) }
+
+    private fun BvhFixture.visibleSet(): Set<Int> =
+        (0 until bvh.visibleCount).map { bvh.visibleHandle(it) }.toSet()
+
+    private class BvhFixture(count: Int) {
+        val bvh = CullingBvh(initialCapacity = 4)
+        val positions = HashMap<Int, Float>()
+
+        init {
+            // A row of unit boxes along x from -50 to +49
+            for (i in 0 until count) {
+                val x = (i - count / 2).toFloat()
+                positions[bvh.insert(x, 0f, 0f, x + 1f, 1f, 1f)] = x
+            }
+        }
+
+        fun move(handle: Int, x: Float) {
+            positions[handle] = x
+            bvh.update(handle, x, 0f, 0f, x + 1f, 1f, 1f)
+        }
+
+        fun expected(frustum: Frustum): Set<Int> =
+            positions.filter { (_, x) -> frustum.intersectsBox(x, 0f, 0f, x + 1f, 1f, 1f) }.keys
+    }
+
+    @Test
+    fun testCullMatchesBruteForce() {
+        val fixture = BvhFixture(100)
+
+        val count = fixture.bvh.cull(frustum)
+
+        assertEquals(fixture.expected(frustum), fixture.visibleSet())
+        assertEquals(fixture.expected(frustum).size, count)
+        assertTrue(fixture.bvh.nodes > 1)
+    }
+
+    @Test
+    fun testMovedObjectsAreRefit() {
+        val fixture = BvhFixture(100)
+        fixture.bvh.cull(frustum)
+
+        // Move two visible boxes away and two distant boxes into view
+        val handles = fixture.positions.keys.sorted()
+        fixture.move(handles[50], 500f)
+        fixture.move(handles[51], -500f)
+        fixture.move(handles[0], 3.5f)
+        fixture.move(handles[99], -2.5f)
+        fixture.bvh.cull(frustum)
+
+        assertEquals(fixture.expected(frustum), fixture.visibleSet())
+    }
+
+    @Test
+    fun testLeavesDirtiedBeforeRebuildStillRefit() {
+        val fixture = BvhFixture(100)
+        fixture.bvh.cull(frustum)
+        val leftmost = fixture.positions.minByOrNull { it.value }!!.key
+
+        // Dirty the leftmost leaf, then force a rebuild before it is refit
+        fixture.move(leftmost, -49.5f)
+        fixture.positions[fixture.bvh.insert(200f, 0f, 0f, 201f, 1f, 1f)] = 200f
+        fixture.bvh.cull(frustum)
+
+        fixture.move(leftmost, 0f)
+        fixture.bvh.cull(frustum)
+
+        assertEquals(fixture.expected(frustum), fixture.visibleSet())
+    }
+
+    @Test
+    fun testRemovedObjectsAreNotReported() {
+        val fixture = BvhFixture(100)
+        fixture.bvh.cull(frustum)
+
+        val removed = fixture.positions.keys.filter { fixture.positions.getValue(it) in -3f..3f }
+        removed.forEach {
+            fixture.bvh.remove(it)
+            fixture.positions.remove(it)
+        }
+        fixture.bvh.cull(frustum)
+
+        assertEquals(fixture.expected(frustum), fixture.visibleSet())
+        assertFailsWith<IllegalArgumentException> { fixture.bvh.update(removed.first(), 0f, 0f, 0f, 1f, 1f, 1f) }
+    }
+
+    @Test
+    fun testHandlesAreReusedAfterRemoval() {
+        val bvh = CullingBvh()
+        val first = bvh.insert(0f, 0f, 0f, 1f, 1f, 1f)
+        bvh.remove(first)
+        val second = bvh.insert(2f, 0f, 0f, 3f, 1f, 1f)
+
+        assertEquals(first, second)
+        assertEquals(1, bvh.cull(frustum))
+        assertEquals(second, bvh.visibleHandle(0))
+    }
+
+    @Test
+    fun testDeepTreesFitTheirNodeArrays() {
+        // Median splits can leave nearly twice count / leafSize leaves
+        for (count in listOf(17, 18, 21, 40, 300, 10_000)) {
+            val fixture = BvhFixture(count)
+
+            fixture.bvh.cull(frustum)
+
+            assertEquals(fixture.expected(frustum), fixture.visibleSet(), "count=$count")
+        }
+    }
+
+    @Test
+    fun testParallelCullMatchesSerial() = runTest {
+        val fixture = BvhFixture(1000)
+        fixture.bvh.cull(frustum)
+        val serial = fixture.visibleSet()
+
+        fixture.bvh.cullParallel(frustum, tasks = 4)
+
+        assertEquals(serial, fixture.visibleSet())
+        assertEquals(fixture.expected(frustum), serial)
+    }
+
+    @Test
+    fun testBoxQueryMatchesBruteForce() {
+        val fixture = BvhFixture(100)
+        fixture.move(fixture.positions.keys.first(), 500f)
+        val found = mutableSetOf<Int>()
+
+        fixture.bvh.query(-10.5f, 0.5f, 0.5f, 10.5f, 2f, 2f) { found.add(it) }
+
+        val expected = fixture.positions.filter { (_, x) -> x <= 10.5f && x + 1f >= -10.5f }.keys
+        assertEquals(expected, found)
+    }
+
+    @Test
+    fun testRaycastVisitsNearestFirstAndPrunes() {
+        val fixture = BvhFixture(100)
+        val entries = mutableListOf<Float>()
+
+        // Along +x through the middle of the row, stopping after the first box
+        fixture.bvh.raycast(-100f, 0.5f, 0.5f, 1f, 0f, 0f, 1000f) { _, entry ->
+            entries.add(entry)
+            entry
+        }
+
+        // Only the nearest leaf is opened; every box behind it starts past the limit
+        assertEquals(50f, entries.min(), 1e-4f)
+        assertTrue(entries.size <= CullingBvh.DEFAULT_LEAF_SIZE, "Visited ${entries.size} boxes")
+    }
+}
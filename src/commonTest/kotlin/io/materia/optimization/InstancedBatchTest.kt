@@ -0,0 +1,117 @@
+package io.materia.optimization
+
+import io.materia.core.math.Box3
+import io.materia.core.math.Color
+import io.materia.core.math.Matrix4
+import io.materia.core.math.Vector3
+import io.materia.core.scene.SpriteMaterial
+import io.materia.geometry.BufferGeometry
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+/**
+ * Dense instance storage: stable handles over swap-remove, partial uploads, draw lists
+ */
+class InstancedBatchTest {
+
+    private class RecordingSink : InstanceUploadSink {
+        val ranges = mutableListOf<IntRange>()
+        var drawIndices: List<Int> = emptyList()
+
+        override fun writeInstances(firstInstance: Int, instanceCount: Int, matrices: FloatArray, colors: FloatArray) {
+            ranges += firstInstance until firstInstance + instanceCount
+        }
+
+        override fun writeDrawIndices(indices: IntArray, drawCount: Int) {
+            drawIndices = indices.take(drawCount)
+        }
+    }
+
+    private fun batch(count: Int, mergeGap: Int = InstancedBatch.DEFAULT_MERGE_GAP): Pair<InstancedBatch, List<Int>> {
+        val batch = InstancedBatch(BufferGeometry(), SpriteMaterial(), maxInstances = count + 8, mergeGap = mergeGap)
+        val handles = List(count) { batch.addInstance(Matrix4().makeTranslation(it.toFloat(), 0f, 0f)) }
+        return batch to handles
+    }
+
+    private fun InstancedBatch.x(handle: Int): Float = matrices[indexOf(handle) * 16 + 12]
+
+    @Test
+    fun testSwapRemoveKeepsHandlesValid() {
+        val (batch, handles) = batch(10)
+
+        assertTrue(batch.removeInstance(handles[2]))
+        assertFalse(batch.removeInstance(handles[2]))
+
+        assertEquals(9, batch.size)
+        assertEquals(2, batch.indexOf(handles[9]), "The last instance fills the hole")
+        for (i in handles.indices) {
+            if (i != 2) assertEquals(i.toFloat(), batch.x(handles[i]))
+        }
+        val reused = batch.addInstance(Matrix4().makeTranslation(42f, 0f, 0f))
+        assertEquals(handles[2], reused)
+        assertEquals(42f, batch.x(reused))
+    }
+
+    @Test
+    fun testFlushUploadsOnlyDirtyRanges() {
+        val (batch, handles) = batch(1000, mergeGap = 2)
+        val sink = RecordingSink()
+        batch.uploadSink = sink
+        batch.flush()
+        assertEquals(listOf(0 until 1000), sink.ranges, "A new sink receives everything once")
+
+        sink.ranges.clear()
+        for (i in listOf(10, 11, 13, 500, 998)) {
+            batch.updateInstance(handles[i], Matrix4().makeTranslation(-1f, 0f, 0f))
+        }
+        batch.updateColor(handles[700], Color(1f, 0f, 0f))
+        val uploaded = batch.flush()
+
+        assertEquals(listOf(10..13, 500..500, 700..700, 998..998), sink.ranges)
+        assertEquals(7, uploaded)
+        sink.ranges.clear()
+        assertEquals(0, batch.flush(), "Nothing is resent once clean")
+        assertTrue(sink.ranges.isEmpty())
+    }
+
+    @Test
+    fun testRemovalUploadsTheFilledSlotOnly() {
+        val (batch, handles) = batch(100)
+        val sink = RecordingSink()
+        batch.uploadSink = sink
+        batch.flush()
+        sink.ranges.clear()
+
+        batch.updateInstance(handles[99], Matrix4().makeTranslation(5f, 0f, 0f))
+        batch.removeInstance(handles[40])
+        batch.flush()
+
+        assertEquals(listOf(40..40), sink.ranges, "The removed tail slot is not uploaded")
+        assertEquals(5f, batch.x(handles[99]))
+    }
+
+    @Test
+    fun testCullingAndSortingOnlyReorderTheDrawList() {
+        val (batch, handles) = batch(20)
+        val before = batch.matrices.copyOf()
+        batch.setVisible(handles[3], false)
+
+        // Clip volume [-10, 10]^3 keeps the boxes at x = 0..10 of x = 0..19
+        val frustum = Frustum().apply { setFromMatrix(Matrix4.scale(0.1f, 0.1f, 0.1f)) }
+        batch.cullInstances(frustum, Box3(Vector3(-0.25f, -0.25f, -0.25f), Vector3(0.25f, 0.25f, 0.25f)))
+        assertEquals(10, batch.getActiveCount())
+
+        batch.sortingStrategy = InstancedBatch.SortingStrategy.BACK_TO_FRONT
+        batch.sortInstances(Vector3(0f, 0f, 0f))
+        val order = (0 until batch.getActiveCount()).map { batch.drawIndex(it) }
+        assertEquals(listOf(10, 9, 8, 7, 6, 5, 4, 2, 1, 0), order)
+        assertTrue(before.contentEquals(batch.matrices), "Backing data is not reordered")
+
+        val sink = RecordingSink()
+        batch.uploadSink = sink
+        batch.flush()
+        assertEquals(order, sink.drawIndices)
+    }
+}
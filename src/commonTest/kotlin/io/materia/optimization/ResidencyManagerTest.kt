@@ -0,0 +1,132 @@
+package io.materia.optimization
+
+import io.materia.profiling.MemoryAllocationType
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class ResidencyManagerTest {
+
+    private val evicted = mutableListOf<String>()
+
+    private fun ResidencyManager.add(key: String, bytes: Long) =
+        register(key, MemoryAllocationType.GEOMETRY, bytes) { evicted += key }
+
+    private fun ResidencyManager.frame(block: ResidencyManager.() -> Unit = {}) {
+        beginFrame()
+        block()
+        endFrame()
+    }
+
+    @Test
+    fun `uploads over budget evict the least recently drawn`() {
+        val residency = ResidencyManager(budgetBytes = 300, evictionDelayFrames = 1)
+        residency.frame {
+            add("a", 100)
+            add("b", 100)
+            add("c", 100)
+        }
+        residency.frame { touch("a") }
+        residency.frame {
+            touch("c")
+            add("d", 100)
+        }
+
+        assertEquals(listOf("b"), evicted)
+        assertFalse("b" in residency)
+        assertFalse(residency.touch("b"))
+        assertEquals(300, residency.usedBytes)
+    }
+
+    @Test
+    fun `recently drawn resources survive overshooting the budget`() {
+        val residency = ResidencyManager(budgetBytes = 100, evictionDelayFrames = 2)
+        residency.frame { add("a", 80) }
+        residency.frame {
+            touch("a")
+            add("b", 80)
+        }
+        assertTrue(evicted.isEmpty())
+        assertTrue(residency.stats().overBudget)
+
+        // "a" is two frames cold by now
+        residency.frame { touch("b") }
+        residency.frame { touch("b") }
+        assertEquals(listOf("a"), evicted)
+        assertEquals(80, residency.usedBytes)
+    }
+
+    @Test
+    fun `unregister frees without calling back`() {
+        val residency = ResidencyManager(budgetBytes = 1000)
+        residency.frame { add("a", 400) }
+        residency.unregister("a")
+        assertEquals(0, residency.usedBytes)
+        assertTrue(evicted.isEmpty())
+    }
+
+    @Test
+    fun `textures stream in finer levels on demand within the budget`() {
+        val residency = ResidencyManager(budgetBytes = 100, evictionDelayFrames = 1)
+        val levels = mutableListOf<Int>()
+        val levelBytes = longArrayOf(64, 16, 4, 1)
+        residency.frame {
+            registerTexture("t", levelBytes, residentLevel = 3, onResidentLevelChanged = { levels += it }) {}
+        }
+        assertEquals(1, residency.usedBytes)
+
+        residency.frame { touch("t", demandedLevel = 0) }
+        assertEquals(listOf(0), levels)
+        assertEquals(85, residency.usedBytes)
+
+        // While the texture keeps being drawn, the buffer that overshot the budget goes first
+        residency.frame {
+            touch("t", demandedLevel = 0)
+            add("cold", 20)
+        }
+        residency.frame {
+            touch("t", demandedLevel = 0)
+            add("new", 10)
+        }
+        assertEquals(listOf("cold"), evicted)
+        assertEquals(0, residency.residentLevel("t"))
+    }
+
+    @Test
+    fun `stream in settles for the finest level that fits`() {
+        val residency = ResidencyManager(budgetBytes = 40, evictionDelayFrames = 1)
+        val levelBytes = longArrayOf(64, 16, 4, 1)
+        residency.frame {
+            registerTexture("t", levelBytes, residentLevel = 3, onResidentLevelChanged = {}) {}
+        }
+        residency.frame { touch("t", demandedLevel = 0) }
+        assertEquals(1, residency.residentLevel("t"))
+        assertEquals(21, residency.usedBytes)
+    }
+
+    @Test
+    fun `over budget trims levels no draw asked for`() {
+        val residency = ResidencyManager(budgetBytes = 100, evictionDelayFrames = 1)
+        val levelBytes = longArrayOf(64, 16, 4, 1)
+        residency.frame {
+            registerTexture("t", levelBytes, residentLevel = 0, onResidentLevelChanged = {}) {}
+        }
+        residency.frame {
+            touch("t", demandedLevel = 2)
+            add("b", 30)
+        }
+        assertEquals(2, residency.residentLevel("t"))
+        assertEquals(35, residency.usedBytes)
+        assertTrue(evicted.isEmpty())
+    }
+
+    @Test
+    fun `screen coverage picks the mip level`() {
+        assertEquals(0, ResidencyManager.mipForScreenSize(1024, 1024, 2048f, 2048f, 11))
+        assertEquals(0, ResidencyManager.mipForScreenSize(1024, 1024, 1024f, 1024f, 11))
+        assertEquals(2, ResidencyManager.mipForScreenSize(1024, 1024, 200f, 200f, 11))
+        assertEquals(3, ResidencyManager.mipForScreenSize(1024, 512, 100f, 100f, 4))
+        assertEquals(10, ResidencyManager.mipForScreenSize(1024, 1024, 0f, 0f, 11))
+    }
+}
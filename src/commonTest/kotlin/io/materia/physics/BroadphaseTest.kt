@@ -0,0 +1,193 @@
+package io.materia.physics
+
+import io.materia.core.math.Quaternion
+import io.materia.core.math.Vector3
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNotNull
+import kotlin.test.assertTrue
+
+/**
+ * Broadphase pairs and queries must match brute force; the world must report
+ * persistent contacts and respect collision filtering.
+ */
+class BroadphaseTest {
+
+    private class Boxes(seed: Int, count: Int) {
+        val random = Random(seed)
+        val boxes = HashMap<Int, FloatArray>()
+
+        fun randomBox(): FloatArray {
+            val x = random.nextFloat() * 50f
+            val y = random.nextFloat() * 50f
+            val z = random.nextFloat() * 50f
+            val size = 0.5f + random.nextFloat() * 3f
+            return floatArrayOf(x, y, z, x + size, y + size, z + size)
+        }
+
+        val initial = List(count) { randomBox() }
+
+        fun overlaps(a: FloatArray, b: FloatArray): Boolean =
+            a[0] <= b[3] && b[0] <= a[3] && a[1] <= b[4] && b[1] <= a[4] && a[2] <= b[5] && b[2] <= a[5]
+
+        fun expectedPairs(): Set<Pair<Int, Int>> {
+            val ids = boxes.keys.sorted()
+            val pairs = mutableSetOf<Pair<Int, Int>>()
+            for (i in ids.indices) {
+                for (j in i + 1 until ids.size) {
+                    if (overlaps(boxes.getValue(ids[i]), boxes.getValue(ids[j]))) pairs.add(ids[i] to ids[j])
+                }
+            }
+            return pairs
+        }
+    }
+
+    private fun Broadphase.add(boxes: Boxes, box: FloatArray) {
+        boxes.boxes[createProxy(box[0], box[1], box[2], box[3], box[4], box[5])] = box
+    }
+
+    private fun Broadphase.pairs(): List<Pair<Int, Int>> {
+        val pairs = mutableListOf<Pair<Int, Int>>()
+        findPairs { a, b -> pairs.add(a to b) }
+        return pairs
+    }
+
+    private fun checkAgainstBruteForce(broadphase: Broadphase) {
+        val boxes = Boxes(seed = 11, count = 300)
+        boxes.initial.forEach { broadphase.add(boxes, it) }
+        assertEquals(boxes.expectedPairs(), broadphase.pairs().toSet())
+        assertEquals(broadphase.pairs().size, broadphase.pairs().toSet().size, "Each pair is reported once")
+
+        // Move a third, remove a tenth, add a few (reusing ids)
+        val ids = boxes.boxes.keys.sorted()
+        for (id in ids.filter { it % 3 == 0 }) {
+            val box = boxes.randomBox()
+            boxes.boxes[id] = box
+            broadphase.moveProxy(id, box[0], box[1], box[2], box[3], box[4], box[5])
+        }
+        for (id in ids.filter { it % 10 == 1 }) {
+            boxes.boxes.remove(id)
+            broadphase.destroyProxy(id)
+        }
+        repeat(10) { broadphase.add(boxes, boxes.randomBox()) }
+
+        assertEquals(boxes.boxes.size, broadphase.size)
+        assertEquals(boxes.expectedPairs(), broadphase.pairs().toSet())
+
+        val query = floatArrayOf(10f, 10f, 10f, 20f, 20f, 20f)
+        val found = mutableSetOf<Int>()
+        broadphase.query(query[0], query[1], query[2], query[3], query[4], query[5]) { found.add(it) }
+        assertEquals(boxes.boxes.filterValues { boxes.overlaps(it, query) }.keys, found)
+    }
+
+    @Test
+    fun testAabbTreeMatchesBruteForce() = checkAgainstBruteForce(AabbTreeBroadphase())
+
+    @Test
+    fun testSweepAndPruneMatchesBruteForce() = checkAgainstBruteForce(SweepAndPruneBroadphase(initialCapacity = 4))
+
+    @Test
+    fun testSweepAndPruneRaycastFindsCrossedBoxes() {
+        val broadphase = SweepAndPruneBroadphase()
+        val near = broadphase.createProxy(5f, -1f, -1f, 6f, 1f, 1f)
+        val far = broadphase.createProxy(10f, -1f, -1f, 11f, 1f, 1f)
+        broadphase.createProxy(5f, 5f, -1f, 6f, 6f, 1f)
+        val hits = mutableMapOf<Int, Float>()
+
+        broadphase.raycast(0f, 0f, 0f, 1f, 0f, 0f, 20f) { proxy, entry ->
+            hits[proxy] = entry
+            20f
+        }
+
+        assertEquals(setOf(near, far), hits.keys)
+        assertEquals(5f, hits.getValue(near), 1e-5f)
+        assertEquals(10f, hits.getValue(far), 1e-5f)
+    }
+
+    @Test
+    fun testContactManifoldCacheTracksPairLifetime() {
+        val cache = ContactManifoldCache(initialCapacity = 2)
+        cache.begin()
+        val first = cache.touch(3, 1)
+        repeat(40) { cache.touch(10 + it, 100 + it) }
+        cache.end { }
+        assertTrue(first.isNew)
+        assertEquals(1, first.proxyA)
+        assertEquals(41, cache.size)
+
+        cache.begin()
+        val again = cache.touch(1, 3)
+        val removed = mutableListOf<ContactManifoldCache.Manifold>()
+        cache.end { removed.add(it) }
+
+        assertTrue(again === first)
+        assertEquals(2, again.steps)
+        assertEquals(40, removed.size)
+        assertEquals(1, cache.size)
+    }
+
+    @Test
+    fun testWorldReportsPersistentContacts() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+        val a = body("a", 0f)
+        val b = body("b", 1.5f)
+        world.addRigidBody(a)
+        world.addRigidBody(b)
+        val events = mutableListOf<String>()
+        world.setCollisionCallback(object : CollisionCallback {
+            override fun onContactAdded(contact: ContactInfo): Boolean = events.add("added")
+            override fun onContactProcessed(contact: ContactInfo): Boolean = events.add("processed")
+            override fun onContactDestroyed(contact: ContactInfo) {
+                events.add("destroyed")
+            }
+        })
+
+        world.step(1f / 60f)
+        world.step(1f / 60f)
+        b.setTransform(Vector3(5f, 0f, 0f), Quaternion())
+        world.step(1f / 60f)
+
+        assertEquals(listOf("added", "processed", "destroyed"), events)
+    }
+
+    @Test
+    fun testWorldRespectsCollisionFiltering() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+        val a = body("a", 0f).apply { collisionGroups = 1; collisionMask = 1 }
+        val b = body("b", 1f).apply { collisionGroups = 2; collisionMask = -1 }
+        val c = body("c", 0.5f)
+        world.addRigidBody(a)
+        world.addRigidBody(b)
+        world.addRigidBody(c)
+        val contacts = mutableListOf<Set<String>>()
+        world.onCollision { contacts.add(setOf(it.bodyA.id, it.bodyB.id)) }
+
+        world.step(1f / 60f)
+
+        assertEquals(setOf(setOf("a", "c"), setOf("b", "c")), contacts.toSet())
+    }
+
+    @Test
+    fun testWorldQueriesUseCurrentPositions() {
+        for (type in listOf(BroadphaseType.DYNAMIC_AABB_TREE, BroadphaseType.SAP)) {
+            val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+            world.broadphase = type
+            val bodies = List(50) { body("b$it", it * 4f) }
+            bodies.forEach { world.addRigidBody(it) }
+            bodies[10].setTransform(Vector3(-20f, 0f, 0f), Quaternion())
+
+            val hit = world.raycast(Vector3(-30f, 0f, 0f), Vector3(300f, 0f, 0f), -1)
+            assertNotNull(hit, "$type")
+            assertTrue(hit.hitObject === bodies[10], "$type hit ${hit.hitObject?.id}")
+
+            val nearby = world.sphereCast(Vector3(12f, 0f, 0f), 1.5f, -1).map { it.id }.toSet()
+            assertEquals(setOf("b3"), nearby, "$type")
+        }
+    }
+
+    private fun body(id: String, x: Float): DefaultRigidBody =
+        DefaultRigidBody(id, DefaultSphereShape(1f)).apply {
+            setTransform(Vector3(x, 0f, 0f), Quaternion())
+        }
+}
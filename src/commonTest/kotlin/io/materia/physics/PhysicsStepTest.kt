@@ -0,0 +1,156 @@
+package io.materia.physics
+
+import io.materia.core.math.Matrix4
+import io.materia.core.math.Quaternion
+import io.materia.core.math.Vector3
+import kotlinx.coroutines.test.runTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNotEquals
+import kotlin.test.assertTrue
+
+/**
+ * Fixed-timestep stepping, interpolation, island sleeping and parallel island solving.
+ */
+class PhysicsStepTest {
+
+    @Test
+    fun testAccumulatorRunsFixedSubSteps() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f)).apply {
+            timeStep = 0.25f
+            maxSubSteps = 4
+        }
+        val body = body("a", 0f).apply { linearVelocity = Vector3(4f, 0f, 0f) }
+        world.addRigidBody(body)
+
+        world.step(0.125f)
+        assertEquals(0f, x(body), 1e-5f, "Half a step simulates nothing yet")
+        assertEquals(0.5f, world.interpolationAlpha, 1e-6f)
+
+        world.step(0.375f)
+        assertEquals(2f, x(body), 1e-5f, "The carried half step completes two substeps")
+        assertEquals(0f, world.interpolationAlpha, 1e-6f)
+
+        world.step(10f)
+        assertEquals(6f, x(body), 1e-5f, "Substeps are capped at maxSubSteps")
+        assertEquals(0f, world.interpolationAlpha, 1e-6f, "Dropped time is not carried over")
+    }
+
+    @Test
+    fun testVariableStepWhenSubStepsDisabled() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f)).apply { maxSubSteps = 0 }
+        val body = body("a", 0f).apply { linearVelocity = Vector3(1f, 0f, 0f) }
+        world.addRigidBody(body)
+
+        world.step(0.25f)
+
+        assertEquals(0.25f, x(body), 1e-5f)
+        assertEquals(1f, world.interpolationAlpha)
+    }
+
+    @Test
+    fun testInterpolatedTransformBlendsSubSteps() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+        val body = body("a", 0f).apply { linearVelocity = Vector3(60f, 0f, 0f) }
+        world.addRigidBody(body)
+
+        world.step(1.25f / 60f)
+        val transform = world.getInterpolatedTransform(body, Matrix4())
+
+        assertEquals(1f, x(body), 1e-4f)
+        assertEquals(0.25f, transform.m03, 1e-3f)
+    }
+
+    @Test
+    fun testGravityAccelerates() {
+        val world = DefaultPhysicsWorld()
+        val body = body("a", 0f)
+        world.addRigidBody(body)
+
+        repeat(60) { world.step(1f / 60f) }
+
+        assertEquals(-9.81f, body.linearVelocity.y, 1e-2f)
+        assertTrue(body.getWorldTransform().m13 < -4f)
+    }
+
+    @Test
+    fun testDefaultBroadphaseStepsLargeWorlds() {
+        // Well past 2 * leafSize proxies, so the AABB tree splits into many leaves
+        val world = DefaultPhysicsWorld()
+        val bodies = List(200) { i ->
+            DefaultRigidBody("b$i", DefaultSphereShape(1f)).apply {
+                setTransform(Vector3((i % 20) * 4f, 0f, (i / 20) * 4f), Quaternion())
+            }
+        }
+        bodies.forEach { world.addRigidBody(it) }
+
+        repeat(60) { world.step(1f / 60f) }
+
+        assertTrue(bodies.all { it.getWorldTransform().m13 < -4f }, "Every body falls freely")
+    }
+
+    @Test
+    fun testRestingIslandFallsAsleepAndWakes() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+        val a = body("a", 0f)
+        val b = body("b", 1.5f)
+        world.addRigidBody(a)
+        world.addRigidBody(b)
+
+        repeat(40) { world.step(1f / 60f) }
+        assertEquals(ActivationState.DEACTIVATED, a.activationState)
+        assertEquals(ActivationState.DEACTIVATED, b.activationState)
+
+        b.linearVelocity = Vector3(0f, 0.1f, 0f)
+        world.step(1f / 60f)
+        assertEquals(ActivationState.ACTIVE, a.activationState, "Touching bodies wake together")
+        assertEquals(ActivationState.ACTIVE, b.activationState)
+    }
+
+    @Test
+    fun testMovingContactKeepsIslandAwake() {
+        val world = DefaultPhysicsWorld(Vector3(0f, 0f, 0f))
+        val resting = body("resting", 0f)
+        val moving = body("moving", 1f).apply { linearVelocity = Vector3(1f, 0f, 0f) }
+        val alone = body("alone", 20f)
+        world.addRigidBody(resting)
+        world.addRigidBody(moving)
+        world.addRigidBody(alone)
+
+        repeat(36) { world.step(1f / 60f) }
+
+        assertEquals(ActivationState.DEACTIVATED, alone.activationState)
+        assertNotEquals(ActivationState.DEACTIVATED, resting.activationState)
+        assertNotEquals(ActivationState.DEACTIVATED, moving.activationState)
+    }
+
+    @Test
+    fun testParallelStepMatchesSerial() = runTest {
+        val serial = DefaultPhysicsWorld()
+        val parallel = DefaultPhysicsWorld()
+        val serialBodies = List(40) { body("b$it", it * 5f).apply { linearVelocity = Vector3(0f, it.toFloat(), 1f) } }
+        val parallelBodies = List(40) { body("b$it", it * 5f).apply { linearVelocity = Vector3(0f, it.toFloat(), 1f) } }
+        serialBodies.forEach { serial.addRigidBody(it) }
+        parallelBodies.forEach { parallel.addRigidBody(it) }
+
+        repeat(30) {
+            serial.step(1f / 60f)
+            parallel.stepParallel(1f / 60f, tasks = 4)
+        }
+
+        for (i in serialBodies.indices) {
+            val expected = serialBodies[i].getWorldTransform()
+            val actual = parallelBodies[i].getWorldTransform()
+            assertEquals(expected.m03, actual.m03, 1e-5f)
+            assertEquals(expected.m13, actual.m13, 1e-5f)
+            assertEquals(expected.m23, actual.m23, 1e-5f)
+        }
+    }
+
+    private fun x(body: RigidBody): Float = body.getWorldTransform().m03
+
+    private fun body(id: String, x: Float): DefaultRigidBody =
+        DefaultRigidBody(id, DefaultSphereShape(1f)).apply {
+            setTransform(Vector3(x, 0f, 0f), Quaternion())
+        }
+}
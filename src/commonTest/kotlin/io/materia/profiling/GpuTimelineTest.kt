@@ -0,0 +1,105 @@
+package io.materia.profiling
+
+import kotlin.test.*
+
+/**
+ * Tests for GPU pass timings and their alignment to the CPU clock
+ */
+class GpuTimelineTest {
+
+    @AfterTest
+    fun cleanup() {
+        PerformanceProfiler.reset()
+        PerformanceProfiler.configure(ProfilerConfig(enabled = false))
+    }
+
+    @Test
+    fun testClockOffsetUsesTightestFrame() {
+        val timeline = GpuTimeline()
+        assertNull(timeline.clockOffsetNanos)
+
+        // Each frame bounds the offset from below; the second GPU started 4µs after submit
+        timeline.addFrame(1, 10_000, listOf(GpuPassSpan("scene", "render", 1_000, 4_000)))
+        timeline.addFrame(2, 30_000, listOf(GpuPassSpan("scene", "render", 25_000, 27_000)))
+
+        assertEquals(9_000L, timeline.clockOffsetNanos)
+    }
+
+    @Test
+    fun testEventsAreOnCpuClock() {
+        val timeline = GpuTimeline()
+        timeline.addFrame(
+            7,
+            10_000,
+            listOf(
+                GpuPassSpan("scene", "render", 500, 2_500),
+                GpuPassSpan("bloom", "compute", 2_600, 3_000)
+            )
+        )
+
+        val events = timeline.events()
+        assertEquals(listOf("scene", "bloom"), events.map { it.name })
+        assertEquals(listOf(10_000L, 12_100L), events.map { it.startNanos })
+        assertEquals(listOf(2_000L, 400L), events.map { it.durationNanos })
+        assertTrue(events.all { it.frameNumber == 7 })
+    }
+
+    @Test
+    fun testAveragesAndHistoryLimit() {
+        val timeline = GpuTimeline(historySize = 2)
+        repeat(3) { frame ->
+            val base = frame * 10_000L
+            timeline.addFrame(
+                frame,
+                base,
+                listOf(
+                    GpuPassSpan("shadow", "render", base, base + 1_000 * (frame + 1)),
+                    GpuPassSpan("scene", "render", base + 4_000, base + 8_000)
+                )
+            )
+        }
+
+        assertEquals(2, timeline.frameCount)
+        // Frame 0 fell out of the history
+        assertEquals(mapOf("scene" to 4_000L, "shadow" to 2_500L), timeline.averagePassTimes())
+        assertEquals(listOf("scene", "shadow"), timeline.averagePassTimes().keys.toList())
+        assertEquals(8_000L, timeline.averageFrameTime())
+
+        timeline.clear()
+        assertEquals(0, timeline.frameCount)
+        assertEquals(0L, timeline.averageFrameTime())
+    }
+
+    @Test
+    fun testChromeTraceHasCpuAndGpuTracks() {
+        PerformanceProfiler.reset()
+        PerformanceProfiler.configure(ProfilerConfig(enabled = true, trackMemory = false))
+        PerformanceProfiler.startFrame()
+        PerformanceProfiler.measure("engine.record", ProfileCategory.RENDERING) {
+            var sum = 0
+            repeat(100) { sum += it }
+        }
+        PerformanceProfiler.endFrame()
+        PerformanceProfiler.recordGpuFrame(
+            PerformanceProfiler.currentFrameNumber(),
+            1_000_000,
+            listOf(GpuPassSpan("scene-pass", "render", 0, 1_500))
+        )
+
+        val trace = PerformanceProfiler.export(ExportFormat.CHROME_TRACE)
+        assertTrue(trace.contains("\"args\": {\"name\": \"GPU\"}"), "Should name the GPU track")
+        assertTrue(trace.contains("\"name\": \"engine.record\""), "Should contain CPU measurements")
+        assertTrue(
+            trace.contains("\"name\": \"scene-pass\", \"cat\": \"render\", \"ph\": \"X\", \"ts\": 1000.000, \"dur\": 1.500, \"pid\": 1, \"tid\": 2"),
+            "Should place GPU passes on the GPU track"
+        )
+    }
+
+    @Test
+    fun testGpuFramesIgnoredWhenDisabled() {
+        PerformanceProfiler.configure(ProfilerConfig(enabled = false))
+        PerformanceProfiler.recordGpuFrame(1, 0, listOf(GpuPassSpan("scene", "render", 0, 10)))
+
+        assertEquals(0, PerformanceProfiler.gpuTimeline.frameCount)
+    }
+}
@@ -1,7 +1,14 @@
 package io.materia.raycaster
 
-import io.materia.validation.currentTimeMillis
+import io.materia.core.math.Vector3
+import io.materia.core.scene.Mesh
+import io.materia.core.scene.Object3D
+import io.materia.geometry.primitives.BoxGeometry
+import io.materia.material.MeshBasicMaterial
+import kotlin.random.Random
 import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
 import kotlin.test.assertTrue
 
 /**
@@ -11,28 +18,204 @@ import kotlin.test.assertTrue
 class BVHContractTest {
     @Test
     fun testBVHConstruction() {
-        // FR-R008: BVH construction from objects
-        val bvh = BVH()
-        assertTrue(bvh.build(10000))
+        // FR-R008: BVH construction from geometry, cached on the geometry
+        val geometry = BoxGeometry(1f, 1f, 1f, 4, 4, 4)
+        val bvh = geometry.computeBoundsTree()
+
+        assertEquals(requireNotNull(geometry.index).count / 3, bvh.triangleCount)
+        assertTrue(bvh.nodeCount > 1, "A 192-triangle box should split into several nodes")
+        assertSame(bvh, geometry.computeBoundsTree())
     }
 
     @Test
     fun testRayBVHTraversal() {
-        // FR-R009: Ray-BVH intersection traversal
-        val bvh = BVH()
-        assertTrue(bvh.intersect() >= 0L)
+        // FR-R009: Ray-BVH traversal finds exactly the triangles a linear scan finds
+        val geometry = BoxGeometry(1f, 1f, 1f, 4, 4, 4)
+        val tree = MeshBVH(geometry)
+        val linear = MeshBVH(geometry, maxLeafTriangles = 255)
+        assertEquals(1, linear.nodeCount)
+
+        val random = Random(7)
+        repeat(200) {
+            val ox = random.nextFloat() * 4f - 2f
+            val oy = random.nextFloat() * 4f - 2f
+            val oz = random.nextFloat() * 4f - 2f
+            val dir = Vector3(-ox + random.nextFloat() - 0.5f, -oy + random.nextFloat() - 0.5f, -oz).normalize()
+
+            assertEquals(
+                hitFaces(linear, ox, oy, oz, dir),
+                hitFaces(tree, ox, oy, oz, dir),
+                "Ray $it from ($ox, $oy, $oz)"
+            )
+        }
+    }
+
+    @Test
+    fun testFirstHitOnly() {
+        val raycaster = Raycaster(Vector3(0.13f, 0.21f, 5f), Vector3(0f, 0f, -1f))
+        val mesh = Mesh(BoxGeometry(1f, 1f, 1f), MeshBasicMaterial())
+        mesh.updateMatrixWorld(true)
+
+        val all = raycaster.intersectObject(mesh, recursive = false)
+        assertEquals(2, all.size)
+        assertEquals(4.5f, all[0].distance, 1e-4f)
+        assertEquals(5.5f, all[1].distance, 1e-4f)
+
+        raycaster.firstHitOnly = true
+        val first = raycaster.intersectObject(mesh, recursive = false)
+        assertEquals(1, first.size)
+        assertEquals(4.5f, first[0].distance, 1e-4f)
+        assertEquals(Vector3(0.13f, 0.21f, 0.5f).distanceTo(requireNotNull(first[0].point)), 0f, 1e-4f)
+    }
+
+    @Test
+    fun testFirstHitOnlyRespectsNear() {
+        val raycaster = Raycaster(Vector3(0.13f, 0.21f, 5f), Vector3(0f, 0f, -1f), near = 5f)
+        raycaster.firstHitOnly = true
+        val mesh = Mesh(BoxGeometry(1f, 1f, 1f), MeshBasicMaterial())
+        mesh.scale.set(1f, 1f, 2f)
+        mesh.updateMatrixWorld(true)
+
+        // The front face at 4 is closer than near; the back face at 6 is the first valid hit
+        val hits = raycaster.intersectObject(mesh, recursive = false)
+
+        assertEquals(6f, hits.single().distance, 1e-4f)
+    }
+
+    @Test
+    fun testTreeRefitsAfterGeometryTransform() {
+        val raycaster = Raycaster(Vector3(0.13f, 0.21f, 5f), Vector3(0f, 0f, -1f))
+        raycaster.firstHitOnly = true
+        val geometry = BoxGeometry(1f, 1f, 1f)
+        val mesh = Mesh(geometry, MeshBasicMaterial())
+        mesh.updateMatrixWorld(true)
+        val tree = geometry.computeBoundsTree()
+
+        geometry.translate(0f, 0f, 2f)
+        val hits = raycaster.intersectObject(mesh, recursive = false)
+
+        assertSame(tree, geometry.boundsTree, "Translating refits the tree instead of rebuilding it")
+        assertEquals(2.5f, hits.single().distance, 1e-4f)
+    }
+
+    @Test
+    fun testWorldTransformIsApplied() {
+        val raycaster = Raycaster(Vector3(10.13f, 0.21f, 5f), Vector3(0f, 0f, -1f))
+        val mesh = Mesh(BoxGeometry(1f, 1f, 1f), MeshBasicMaterial())
+        mesh.position.set(10f, 0f, 0f)
+        mesh.scale.set(1f, 1f, 4f)
+        mesh.updateMatrixWorld(true)
+
+        val hits = raycaster.intersectObject(mesh, recursive = false)
+
+        assertEquals(2, hits.size)
+        assertEquals(3f, hits[0].distance, 1e-4f)
+        assertEquals(7f, hits[1].distance, 1e-4f)
     }
 
     @Test
     fun testPerformanceTarget() {
-        // FR-R010: Performance target: 10,000 objects at 60 FPS
-        val bvh = BVH()
-        assertTrue(bvh.testPerformance())
+        // FR-R010: 10,000 objects indexed by the scene BVH answer like a full scan
+        val root = TestObject3D()
+        val geometry = BoxGeometry(0.5f, 0.5f, 0.5f)
+        val material = MeshBasicMaterial()
+        for (x in 0 until 100) {
+            for (y in 0 until 100) {
+                root.add(Mesh(geometry, material).also { it.position.set(x.toFloat(), y.toFloat(), -(x % 7).toFloat()) })
+            }
+        }
+        root.updateMatrixWorld(true)
+        val index = SceneBVH()
+        index.update(root)
+        assertEquals(10_000, index.size)
+
+        val raycaster = Raycaster()
+        val random = Random(3)
+        repeat(50) {
+            raycaster.set(
+                Vector3(random.nextFloat() * 100f, random.nextFloat() * 100f, 20f),
+                Vector3(random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, -4f).normalize()
+            )
+            assertSameHits(raycaster.intersectObject(root), raycaster.intersectObjects(index))
+
+            raycaster.firstHitOnly = true
+            assertSameHits(raycaster.intersectObject(root), raycaster.intersectObjects(index))
+            raycaster.firstHitOnly = false
+        }
     }
-}
 
-class BVH {
-    fun build(count: Int): Boolean = count >= 0
-    fun intersect(): Long = currentTimeMillis()
-    fun testPerformance(): Boolean = currentTimeMillis() >= 0L
+    @Test
+    fun testSceneBVHTracksChanges() {
+        val root = TestObject3D()
+        val geometry = BoxGeometry(1f, 1f, 1f)
+        val moving = Mesh(geometry, MeshBasicMaterial())
+        val removed = Mesh(geometry, MeshBasicMaterial())
+        removed.position.set(5f, 0f, 0f)
+        root.add(moving, removed)
+        root.updateMatrixWorld(true)
+        val index = SceneBVH()
+        index.update(root)
+
+        moving.position.set(-5f, 0f, 0f)
+        root.remove(removed)
+        root.updateMatrixWorld(true)
+        index.update(root)
+
+        assertEquals(1, index.size)
+        val raycaster = Raycaster(Vector3(-5f, 0.2f, 5f), Vector3(0f, 0f, -1f))
+        val hits = raycaster.intersectObjects(index)
+        assertEquals(2, hits.size)
+        assertSame<Object3D>(moving, hits[0].`object`)
+
+        raycaster.set(Vector3(5f, 0.2f, 5f), Vector3(0f, 0f, -1f))
+        assertTrue(raycaster.intersectObjects(index).isEmpty())
+    }
+
+    @Test
+    fun testSceneBVHTracksChangesAcrossManyLeaves() {
+        // A row of 60 boxes along x: enough meshes for a multi-level CullingBvh
+        val root = TestObject3D()
+        val geometry = BoxGeometry(1f, 1f, 1f)
+        val row = List(60) { i -> Mesh(geometry, MeshBasicMaterial()).also { it.position.set(i * 2f, 0f, 0f) } }
+        row.forEach { root.add(it) }
+        root.updateMatrixWorld(true)
+        val index = SceneBVH()
+        index.update(root)
+        val raycaster = Raycaster()
+        fun hitAt(x: Float): Object3D? {
+            raycaster.set(Vector3(x, 0.2f, 5f), Vector3(0f, 0f, -1f))
+            return raycaster.intersectObjects(index).firstOrNull()?.`object`
+        }
+        assertSame<Object3D?>(row[45], hitAt(90f))
+
+        // Move one box into a gap, remove a few and add one past the end
+        row[45].position.set(-3f, 0f, 0f)
+        row.take(5).forEach { root.remove(it) }
+        val added = Mesh(geometry, MeshBasicMaterial()).also { it.position.set(130f, 0f, 0f) }
+        root.add(added)
+        root.updateMatrixWorld(true)
+        index.update(root)
+
+        assertEquals(56, index.size)
+        assertSame<Object3D?>(row[45], hitAt(-3f))
+        assertEquals(null, hitAt(90f))
+        assertEquals(null, hitAt(4f))
+        assertSame<Object3D?>(added, hitAt(130f))
+        assertSame<Object3D?>(row[30], hitAt(60f))
+    }
+
+    private fun hitFaces(tree: MeshBVH, ox: Float, oy: Float, oz: Float, dir: Vector3): Set<Int> {
+        val faces = mutableSetOf<Int>()
+        tree.raycast(ox, oy, oz, dir.x, dir.y, dir.z, 0f, Float.POSITIVE_INFINITY, false) { face, _ ->
+            faces.add(face)
+        }
+        return faces
+    }
+
+    private fun assertSameHits(expected: List<Intersection>, actual: List<Intersection>) {
+        assertEquals(expected.size, actual.size)
+        for (i in expected.indices) {
+            assertEquals(expected[i].distance, actual[i].distance, 1e-4f)
+        }
+    }
 }
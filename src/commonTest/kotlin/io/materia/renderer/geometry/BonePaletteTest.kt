@@ -0,0 +1,107 @@
+package io.materia.renderer.geometry
+
+import io.materia.animation.Skeleton
+import io.materia.animation.skeleton.Bone
+import io.materia.core.math.Vector3
+import io.materia.core.scene.SkinnedMesh
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+/**
+ * The packed palette must skin vertices exactly like the CPU reference path.
+ */
+class BonePaletteTest {
+
+    @Test
+    fun paletteMatricesReproduceCpuSkinning() {
+        val rig = rig()
+        rig.root.rotation.setFromAxisAngle(Vector3(0f, 0f, 1f), 0.6f)
+        rig.child.position.set(0.5f, 2f, 1f)
+        rig.root.updateMatrixWorld(true)
+
+        val palette = BonePalette()
+        val first = palette.add(rig.mesh)
+        val positions = requireNotNull(rig.mesh.geometry.getAttribute("position"))
+        val indices = requireNotNull(rig.mesh.geometry.getAttribute("skinIndex"))
+        val weights = requireNotNull(rig.mesh.geometry.getAttribute("skinWeight"))
+
+        for (i in 0 until positions.count) {
+            val expected = rig.mesh.applyBoneTransform(i, Vector3(positions.getX(i), positions.getY(i), positions.getZ(i)))
+
+            var x = 0f
+            var y = 0f
+            var z = 0f
+            for (j in 0 until 4) {
+                val weight = component(weights, i, j)
+                val m = (first + component(indices, i, j).toInt()) * BonePalette.FLOATS_PER_BONE
+                val d = palette.data
+                x += (d[m] * positions.getX(i) + d[m + 4] * positions.getY(i) + d[m + 8] * positions.getZ(i) + d[m + 12]) * weight
+                y += (d[m + 1] * positions.getX(i) + d[m + 5] * positions.getY(i) + d[m + 9] * positions.getZ(i) + d[m + 13]) * weight
+                z += (d[m + 2] * positions.getX(i) + d[m + 6] * positions.getY(i) + d[m + 10] * positions.getZ(i) + d[m + 14]) * weight
+            }
+
+            assertEquals(expected.x, x, 1e-4f, "vertex $i x")
+            assertEquals(expected.y, y, 1e-4f, "vertex $i y")
+            assertEquals(expected.z, z, 1e-4f, "vertex $i z")
+        }
+    }
+
+    @Test
+    fun meshesPackBackToBack() {
+        val a = rig().mesh
+        val b = rig().mesh
+        val unbound = SkinnedMesh(BufferGeometry())
+        val palette = BonePalette(initialBones = 1)
+
+        assertEquals(0, palette.add(a))
+        assertEquals(2, palette.add(b))
+        assertEquals(0, palette.add(a), "A mesh drawn twice is packed once")
+        assertEquals(-1, palette.add(unbound))
+        assertEquals(4, palette.boneCount)
+        assertEquals(64, palette.floatCount)
+        assertEquals(2, palette.offsetOf(b))
+
+        palette.reset()
+        assertEquals(0, palette.boneCount)
+        assertEquals(-1, palette.offsetOf(b))
+    }
+
+    private class Rig(val mesh: SkinnedMesh, val root: Bone, val child: Bone)
+
+    private fun rig(): Rig {
+        val root = Bone("root")
+        val child = Bone("child", position = Vector3(0f, 1f, 0f), parentIndex = 0)
+        root.add(child)
+        root.updateMatrixWorld(true)
+        root.inverseBindMatrix.copy(root.matrixWorld).invert()
+        child.inverseBindMatrix.copy(child.matrixWorld).invert()
+
+        val geometry = BufferGeometry().apply {
+            setAttribute(
+                "position",
+                BufferAttribute(floatArrayOf(0f, 0f, 0f, 1f, 1f, 0f, 0f, 2f, 1f), itemSize = 3)
+            )
+            setAttribute(
+                "skinIndex",
+                BufferAttribute(floatArrayOf(0f, 0f, 0f, 0f, 0f, 1f, 0f, 0f, 1f, 0f, 0f, 0f), itemSize = 4)
+            )
+            setAttribute(
+                "skinWeight",
+                BufferAttribute(floatArrayOf(1f, 0f, 0f, 0f, 0.5f, 0.5f, 0f, 0f, 1f, 0f, 0f, 0f), itemSize = 4)
+            )
+        }
+        val mesh = SkinnedMesh(geometry)
+        mesh.position.set(1f, -2f, 3f)
+        mesh.bind(Skeleton(listOf(root, child)))
+        return Rig(mesh, root, child)
+    }
+
+    private fun component(attribute: BufferAttribute, index: Int, component: Int): Float = when (component) {
+        0 -> attribute.getX(index)
+        1 -> attribute.getY(index)
+        2 -> attribute.getZ(index)
+        else -> attribute.getW(index)
+    }
+}
@@ -7,6 +7,7 @@ import io.materia.renderer.webgpu.VertexStepMode
 import kotlin.test.Test
 import kotlin.test.assertContentEquals
 import kotlin.test.assertEquals
+import kotlin.test.assertFalse
 import kotlin.test.assertTrue
 
 class GeometryBuilderTest {
@@ -167,4 +168,41 @@ class GeometryBuilderTest {
             instanceStream.data
         )
     }
+
+    @Test
+    fun packsSkinAttributesOnlyAsAPair() {
+        val geometry = BufferGeometry().apply {
+            setAttribute("position", BufferAttribute(floatArrayOf(0f, 0f, 0f, 1f, 0f, 0f), itemSize = 3))
+            setAttribute("skinIndex", BufferAttribute(floatArrayOf(0f, 1f, 0f, 0f, 2f, 0f, 0f, 0f), itemSize = 4))
+        }
+        val options = GeometryBuildOptions(
+            includeNormals = false,
+            includeColors = false,
+            includeUVs = false,
+            includeSecondaryUVs = false,
+            includeTangents = false,
+            includeInstancing = false
+        )
+
+        val indicesOnly = GeometryBuilder.build(geometry, options)
+        assertFalse(indicesOnly.metadata.isSkinned, "Indices without weights are not skinning data")
+        assertEquals(12, indicesOnly.streams.first().layout.arrayStride)
+
+        geometry.setAttribute("skinWeight", BufferAttribute(floatArrayOf(0.75f, 0.25f, 0f, 0f, 1f, 0f, 0f, 0f), itemSize = 4))
+        val skinned = GeometryBuilder.build(geometry, options)
+        val stream = skinned.streams.first()
+
+        assertTrue(skinned.metadata.isSkinned)
+        assertEquals(1, skinned.metadata.bindingFor(GeometryAttribute.SKIN_INDEX)?.location)
+        assertEquals(2, skinned.metadata.bindingFor(GeometryAttribute.SKIN_WEIGHT)?.location)
+        assertEquals(44, stream.layout.arrayStride)
+        assertContentEquals(
+            floatArrayOf(
+                0f, 0f, 0f, 0f, 1f, 0f, 0f, 0.75f, 0.25f, 0f, 0f,
+                1f, 0f, 0f, 2f, 0f, 0f, 0f, 1f, 0f, 0f, 0f
+            ),
+            stream.data
+        )
+        assertFalse(GeometryBuilder.build(geometry, options.copy(includeSkinning = false)).metadata.isSkinned)
+    }
 }
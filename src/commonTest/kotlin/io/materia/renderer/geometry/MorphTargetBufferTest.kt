@@ -0,0 +1,140 @@
+package io.materia.renderer.geometry
+
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+/**
+ * Decoding the encoded deltas the way the vertex shaders do must reproduce CPU blending.
+ */
+class MorphTargetBufferTest {
+
+    @Test
+    fun decodedDeltasMatchCpuBlending() {
+        val random = Random(5)
+        val vertices = 40
+        val base = FloatArray(vertices * 3) { random.nextFloat() * 4f - 2f }
+        val targets = Array(12) { t ->
+            // Absolute targets, each moving its own vertex window
+            FloatArray(vertices * 3) { i ->
+                val v = i / 3
+                if (v in t * 2 until t * 2 + 10) base[i] + random.nextFloat() - 0.5f else base[i]
+            }
+        }
+        val geometry = geometry(base, targets, relative = false)
+        val influences = List(targets.size) { if (it % 3 == 0) 0f else random.nextFloat() * 2f - 1f }
+
+        val buffer = MorphTargetBuffer(initialWords = 4)
+        assertEquals(targets.size, buffer.add(geometry))
+        val headers = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+        val weights = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+        val count = buffer.selectActive(geometry, influences, headers, weights)
+
+        // CPU reference over the same selection
+        val selected = (0 until count).map { slot ->
+            (0 until targets.size).first { buffer.headerOf(geometry, it) == headers[slot].toInt() }
+        }
+        for (v in 0 until vertices) {
+            for (c in 0 until 3) {
+                var expected = base[v * 3 + c]
+                selected.forEachIndexed { slot, target ->
+                    expected += (targets[target][v * 3 + c] - base[v * 3 + c]) * weights[slot]
+                }
+                assertEquals(expected, decode(buffer, headers, weights, count, base, v, c), 2e-3f, "vertex $v component $c")
+            }
+        }
+    }
+
+    @Test
+    fun targetsStoreOnlyTheirMovedRange() {
+        val base = FloatArray(100 * 3)
+        val delta = FloatArray(100 * 3)
+        for (v in 60..69) delta[v * 3 + 1] = 0.25f
+        val geometry = geometry(base, arrayOf(delta, FloatArray(100 * 3)), relative = true)
+
+        val buffer = MorphTargetBuffer()
+        buffer.add(geometry)
+        val header = buffer.headerOf(geometry, 0)
+        assertEquals(60, buffer.data[header])
+        assertEquals(10, buffer.data[header + 1])
+        assertEquals(0, buffer.data[buffer.headerOf(geometry, 1) + 1], "A target that moves nothing stores no deltas")
+        assertEquals(2 * MorphTargetBuffer.HEADER_WORDS + 10 * 2, buffer.wordCount)
+
+        assertEquals(2, buffer.add(geometry), "A geometry is encoded once")
+        assertEquals(2 * MorphTargetBuffer.HEADER_WORDS + 10 * 2, buffer.wordCount)
+    }
+
+    @Test
+    fun selectionKeepsTheStrongestInfluencesSorted() {
+        val vertices = 4
+        val targets = Array(20) { FloatArray(vertices * 3) { 1f } }
+        val geometry = geometry(FloatArray(vertices * 3), targets, relative = true)
+        val buffer = MorphTargetBuffer()
+        buffer.add(geometry)
+        val influences = List(20) { (it - 10) / 10f }
+        val headers = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+        val weights = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+
+        val count = buffer.selectActive(geometry, influences, headers, weights)
+
+        assertEquals(MorphTargetBuffer.MAX_ACTIVE_TARGETS, count)
+        val expected = listOf(-1f, 0.9f, -0.9f, 0.8f, -0.8f, 0.7f, -0.7f, 0.6f)
+        for (slot in 0 until count) {
+            assertEquals(kotlin.math.abs(expected[slot]), kotlin.math.abs(weights[slot]), 1e-6f, "slot $slot")
+            val target = (0 until 20).first { buffer.headerOf(geometry, it) == headers[slot].toInt() }
+            assertEquals(weights[slot], influences[target])
+        }
+
+        val none = buffer.selectActive(geometry, List(20) { 0f }, headers, weights)
+        assertEquals(0, none)
+        assertEquals(0f, weights[0])
+    }
+
+    @Test
+    fun halfRoundTripsWithinPrecision() {
+        val random = Random(11)
+        repeat(500) {
+            val value = (random.nextFloat() * 2f - 1f) * 100f
+            val decoded = MorphTargetBuffer.fromHalf(MorphTargetBuffer.toHalf(value))
+            assertEquals(value, decoded, kotlin.math.abs(value) / 1024f + 1e-7f)
+        }
+        assertEquals(0f, MorphTargetBuffer.fromHalf(MorphTargetBuffer.toHalf(0f)))
+        assertEquals(1e-5f, MorphTargetBuffer.fromHalf(MorphTargetBuffer.toHalf(1e-5f)), 1e-7f)
+        assertEquals(Float.POSITIVE_INFINITY, MorphTargetBuffer.fromHalf(MorphTargetBuffer.toHalf(1e6f)))
+    }
+
+    private fun geometry(base: FloatArray, targets: Array<FloatArray>, relative: Boolean) = BufferGeometry().apply {
+        setAttribute("position", BufferAttribute(base, itemSize = 3))
+        setMorphAttribute("position", Array(targets.size) { BufferAttribute(targets[it], itemSize = 3) })
+        morphTargetsRelative = relative
+    }
+
+    // Mirrors the vertex shader loop in the WebGPU and Vulkan renderers
+    private fun decode(
+        buffer: MorphTargetBuffer,
+        headers: FloatArray,
+        weights: FloatArray,
+        count: Int,
+        base: FloatArray,
+        vertex: Int,
+        component: Int
+    ): Float {
+        var value = base[vertex * 3 + component]
+        for (slot in 0 until count) {
+            val header = headers[slot].toInt()
+            val first = buffer.data[header]
+            if (vertex < first || vertex >= first + buffer.data[header + 1]) continue
+            val stride = if (buffer.data[header + 2] and MorphTargetBuffer.FLAG_NORMALS != 0) 4 else 2
+            val at = header + MorphTargetBuffer.HEADER_WORDS + (vertex - first) * stride
+            val bits = when (component) {
+                0 -> buffer.data[at] and 0xFFFF
+                1 -> (buffer.data[at] ushr 16) and 0xFFFF
+                else -> buffer.data[at + 1] and 0xFFFF
+            }
+            value += MorphTargetBuffer.fromHalf(bits) * weights[slot]
+        }
+        return value
+    }
+}
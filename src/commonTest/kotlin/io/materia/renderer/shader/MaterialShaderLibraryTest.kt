@@ -130,6 +130,7 @@ class MaterialShaderLibraryTest {
     }
 
     private fun emptyOverrideMap(): MutableMap<String, String> = mutableMapOf(
+        "VERTEX_BINDINGS" to "",
         "VERTEX_INPUT_EXTRA" to "",
         "VERTEX_OUTPUT_EXTRA" to "",
         "VERTEX_ASSIGN_EXTRA" to "",
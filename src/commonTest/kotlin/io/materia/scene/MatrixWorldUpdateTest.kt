@@ -0,0 +1,105 @@
+package io.materia.scene
+
+import io.materia.core.scene.Group
+import io.materia.core.scene.Scene
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Incremental world-matrix propagation without forced updates
+ */
+class MatrixWorldUpdateTest {
+
+    @Test
+    fun testDirectPositionWriteIsPickedUp() {
+        val scene = Scene()
+        val parent = Group()
+        val child = Group()
+        child.position.set(0f, 1f, 0f)
+        parent.add(child)
+        scene.add(parent)
+        scene.updateMatrixWorld()
+
+        parent.position.x = 2f
+        scene.updateMatrixWorld()
+
+        val e = child.matrixWorld.elements
+        assertEquals(2f, e[12], 1e-5f)
+        assertEquals(1f, e[13], 1e-5f)
+    }
+
+    @Test
+    fun testUnchangedObjectsKeepVersion() {
+        val scene = Scene()
+        val moving = Group()
+        val still = Group()
+        scene.add(moving)
+        scene.add(still)
+        scene.updateMatrixWorld()
+        val stillVersion = still.matrixWorldVersion
+
+        moving.position.z = 3f
+        scene.updateMatrixWorld()
+
+        assertEquals(stillVersion, still.matrixWorldVersion)
+        assertEquals(3f, moving.matrixWorld.elements[14], 1e-5f)
+    }
+
+    @Test
+    fun testStaticSubtreeFollowsParent() {
+        val scene = Scene()
+        val parent = Group()
+        val child = Group()
+        child.position.set(1f, 0f, 0f)
+        child.isStatic = true
+        parent.add(child)
+        scene.add(parent)
+        scene.updateMatrixWorld()
+        val childVersion = child.matrixWorldVersion
+
+        scene.updateMatrixWorld()
+        assertEquals(childVersion, child.matrixWorldVersion)
+
+        parent.position.y = 4f
+        scene.updateMatrixWorld()
+
+        assertTrue(child.matrixWorldVersion > childVersion)
+        assertEquals(1f, child.matrixWorld.elements[12], 1e-5f)
+        assertEquals(4f, child.matrixWorld.elements[13], 1e-5f)
+    }
+
+    @Test
+    fun testStaticObjectMovesAfterUpdateMatrix() {
+        val scene = Scene()
+        val obj = Group()
+        obj.isStatic = true
+        scene.add(obj)
+        scene.updateMatrixWorld()
+
+        obj.position.x = 5f
+        obj.updateMatrix()
+        scene.updateMatrixWorld()
+
+        assertEquals(5f, obj.matrixWorld.elements[12], 1e-5f)
+    }
+
+    @Test
+    fun testReparentedObjectUsesNewParent() {
+        val scene = Scene()
+        val first = Group()
+        val second = Group()
+        second.position.set(0f, 0f, 7f)
+        val child = Group()
+        child.isStatic = true
+        scene.add(first)
+        scene.add(second)
+        first.add(child)
+        scene.updateMatrixWorld()
+
+        second.add(child)
+        scene.updateMatrixWorld()
+
+        assertEquals(7f, child.matrixWorld.elements[14], 1e-5f)
+    }
+}
@@ -160,8 +160,9 @@ class PMREMGeneratorContractTest {
     }
 }
 
-// Test fixtures: PMREM implementations for contract testing
-class PMREMGenerator(private val renderer: Renderer) {
+// Test fixtures: PMREM implementations for contract testing; named apart from the real
+// PMREMGenerator so they do not shadow it in this package
+class PMREMGeneratorFixture(private val renderer: Renderer) {
     var isDisposed = false
 
     fun fromCubeMap(cubeTexture: RealCubeTexture): PMREMTexture {
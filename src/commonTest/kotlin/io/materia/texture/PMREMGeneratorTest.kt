@@ -0,0 +1,91 @@
+package io.materia.texture
+
+import io.materia.camera.Camera
+import io.materia.core.math.Color
+import io.materia.core.scene.Scene
+import io.materia.renderer.BackendType
+import io.materia.renderer.RenderStats
+import io.materia.renderer.Renderer
+import io.materia.renderer.RendererCapabilities
+import io.materia.renderer.RendererConfig
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
+import kotlin.test.assertIs
+import kotlin.test.assertNull
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class PMREMGeneratorTest {
+
+    private open class StubRenderer : Renderer {
+        override val backend: BackendType = BackendType.WEBGPU
+        override val capabilities: RendererCapabilities = RendererCapabilities(
+            maxTextureSize = 2048,
+            maxCubeMapSize = 2048,
+            maxVertexAttributes = 16,
+            maxFragmentUniforms = 1024,
+            maxVertexUniforms = 1024,
+            maxSamples = 4
+        )
+        override val stats: RenderStats = RenderStats(fps = 60.0, frameTime = 16.67, triangles = 0, drawCalls = 0)
+
+        override suspend fun initialize(config: RendererConfig): io.materia.core.Result<Unit> =
+            io.materia.core.Result.Success(Unit)
+
+        override fun render(scene: Scene, camera: Camera) {}
+        override fun resize(width: Int, height: Int) {}
+        override fun dispose() {}
+    }
+
+    private class ComputeRenderer(override val supportsGpuPrefilter: Boolean = true) :
+        StubRenderer(), GpuEnvironmentPrefilter
+
+    private val cube = CubeTexture.solidColor(Color(0.5f, 0.25f, 1f), size = 8)
+
+    @Test
+    fun `gpu renderers receive the unfiltered source`() {
+        val generator = PMREMGenerator(ComputeRenderer())
+        assertTrue(generator.usesGpu)
+
+        val result = assertIs<GpuPrefilteredCubeTexture>(generator.prefilter(cube, sampleCount = 64))
+        assertSame(cube, result.source)
+        assertEquals(8, result.size)
+        // 8, 4, 2, 1: six requested levels clamp to the face size
+        assertEquals(4, result.roughnessLevels)
+        assertEquals(64, result.sampleCount)
+        assertNull(result.sphericalHarmonics)
+    }
+
+    @Test
+    fun `equirectangular sources take the requested cube size`() {
+        val equirect = Texture2D(16, 8)
+        equirect.setData(ByteArray(16 * 8 * 4) { 0x40 })
+        val result = PMREMGenerator(ComputeRenderer()).prefilter(equirect, cubeSize = 32)
+
+        assertIs<GpuPrefilteredCubeTexture>(result)
+        assertEquals(32, result.size)
+    }
+
+    @Test
+    fun `other renderers fall back to cpu filtering`() {
+        for (generator in listOf(
+            PMREMGenerator(StubRenderer()),
+            PMREMGenerator(ComputeRenderer(supportsGpuPrefilter = false)),
+            PMREMGenerator(ComputeRenderer(), preferGpu = false)
+        )) {
+            assertFalse(generator.usesGpu)
+            val result = assertIs<CubeTexture>(generator.prefilter(cube, sampleCount = 4, roughnessLevels = 3))
+            assertTrue(result.isComplete())
+            assertEquals(2, result.mipmaps?.size)
+        }
+    }
+
+    @Test
+    fun `incomplete cube maps are rejected on both paths`() {
+        val partial = CubeTexture(8).apply { setFaceData(CubeFace.POSITIVE_X, ByteArray(8 * 8 * 4)) }
+        assertFailsWith<IllegalArgumentException> { PMREMGenerator(ComputeRenderer()).prefilter(partial) }
+        assertFailsWith<IllegalArgumentException> { PMREMGenerator(StubRenderer()).prefilter(partial) }
+    }
+}
@@ -0,0 +1,66 @@
+package io.materia.loader
+
+import kotlinx.coroutines.await
+import org.khronos.webgl.Int8Array
+import org.khronos.webgl.Uint8Array
+import kotlin.js.Promise
+
+/**
+ * Basis transcoder backed by the reference `basis_transcoder` WebAssembly build, which
+ * the page loads as the global `BASIS` factory (as with three.js' KTX2Loader). The module
+ * is instantiated on first use and shared afterwards.
+ */
+internal class WasmBasisTranscoder : BasisTranscoder {
+    private var module: dynamic = null
+
+    private suspend fun module(): dynamic {
+        module?.let { return it }
+        val factory = js("globalThis.BASIS")
+            ?: throw IllegalStateException("basis_transcoder.js is not loaded; include it before transcoding KTX2 textures")
+        val instance = (factory(js("({})")) as Promise<dynamic>).await()
+        instance.initializeBasis()
+        module = instance
+        return instance
+    }
+
+    override suspend fun transcode(ktx2: ByteArray, level: Int, target: BasisTargetFormat): ByteArray {
+        val basis = module()
+        // Kotlin ByteArray is an Int8Array on JS; the transcoder wants unsigned bytes
+        val source = ktx2.unsafeCast<Int8Array>()
+        val file = construct(basis.KTX2File, Uint8Array(source.buffer, source.byteOffset, source.length))
+        try {
+            if (!(file.isValid() as Boolean) || !(file.startTranscoding() as Boolean)) {
+                throw IllegalArgumentException("Invalid Basis KTX2 payload")
+            }
+            val format = transcoderFormat(target)
+            val size = file.getImageTranscodedSizeInBytes(level, 0, 0, format) as Int
+            val out = Uint8Array(size)
+            if (!(file.transcodeImage(out, level, 0, 0, format, 0, -1, -1) as Boolean)) {
+                throw IllegalArgumentException("Basis transcoding of level $level to $target failed")
+            }
+            return Int8Array(out.buffer, 0, size).unsafeCast<ByteArray>()
+        } finally {
+            file.close()
+            file.delete()
+        }
+    }
+
+    // basist::transcoder_texture_format values
+    private fun transcoderFormat(target: BasisTargetFormat): Int = when (target) {
+        BasisTargetFormat.ETC1 -> 0
+        BasisTargetFormat.ETC2_RGBA -> 1
+        BasisTargetFormat.BC1 -> 2
+        BasisTargetFormat.BC3 -> 3
+        BasisTargetFormat.BC4 -> 4
+        BasisTargetFormat.BC5 -> 5
+        BasisTargetFormat.BC7 -> 6
+        BasisTargetFormat.ASTC_4x4 -> 10
+        BasisTargetFormat.RGBA32 -> 13
+    }
+
+    @Suppress("UNUSED_PARAMETER")
+    private fun construct(type: dynamic, vararg args: dynamic): dynamic =
+        js("Reflect.construct(type, args)")
+}
+
+internal actual fun createDefaultBasisTranscoder(): BasisTranscoder? = WasmBasisTranscoder()
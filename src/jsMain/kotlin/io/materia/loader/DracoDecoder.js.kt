@@ -0,0 +1,109 @@
+package io.materia.loader
+
+import kotlinx.coroutines.await
+import kotlin.js.Promise
+
+/**
+ * External declaration of the draco3d WASM decoder module
+ */
+@JsModule("draco3d")
+@JsNonModule
+private external object Draco3d {
+    fun createDecoderModule(options: dynamic): Promise<dynamic>
+}
+
+/**
+ * Draco decoder backed by the reference draco3d WebAssembly build, decoding on the calling
+ * thread. The module is instantiated on first use and shared afterwards; in browsers
+ * [DracoWorkerDecoder] runs the same decode off the main thread and falls back to this.
+ */
+internal class WasmDracoDecoder : DracoDecoder {
+    private var module: dynamic = null
+
+    private suspend fun module(): dynamic {
+        if (module == null) module = Draco3d.createDecoderModule(js("({})")).await()
+        return module
+    }
+
+    override suspend fun decode(data: ByteArray, attributeIds: Map<String, Int>): DracoMesh {
+        val draco = module()
+        val decoder = construct(draco.Decoder)
+        // Kotlin ByteArray is an Int8Array on JS, which is what the decoder reads
+        val pointCloud = decoder.GetEncodedGeometryType(data) == draco.POINT_CLOUD
+        val geometry = if (pointCloud) construct(draco.PointCloud) else construct(draco.Mesh)
+        try {
+            val status = if (pointCloud) {
+                decoder.DecodeArrayToPointCloud(data, data.size, geometry)
+            } else {
+                decoder.DecodeArrayToMesh(data, data.size, geometry)
+            }
+            if (!(status.ok() as Boolean) || geometry.ptr == 0) {
+                throw IllegalArgumentException("Draco decoding failed: ${status.error_msg()}")
+            }
+
+            val attributes = HashMap<String, DracoAttribute>()
+            val semantics = attributeIds.ifEmpty { null }
+            DEFAULT_TYPES.forEach { (semantic, type) ->
+                val attribute = if (semantics != null) {
+                    val id = semantics[semantic] ?: return@forEach
+                    decoder.GetAttributeByUniqueId(geometry, id)
+                } else {
+                    val id = decoder.GetAttributeId(geometry, draco[type]) as Int
+                    if (id < 0) return@forEach
+                    decoder.GetAttribute(geometry, id)
+                }
+                if (attribute == null || attribute.ptr == 0) return@forEach
+                attributes[semantic] = readAttribute(draco, decoder, geometry, attribute)
+            }
+
+            val indices = if (pointCloud) null else readIndices(draco, decoder, geometry)
+            return DracoMesh(attributes, indices)
+        } finally {
+            draco.destroy(geometry)
+            draco.destroy(decoder)
+        }
+    }
+
+    private fun readAttribute(draco: dynamic, decoder: dynamic, geometry: dynamic, attribute: dynamic): DracoAttribute {
+        val itemSize = attribute.num_components() as Int
+        val count = (geometry.num_points() as Int) * itemSize
+        val byteLength = count * 4
+        val pointer = draco._malloc(byteLength)
+        try {
+            decoder.GetAttributeDataArrayForAllPoints(geometry, attribute, draco.DT_FLOAT32, byteLength, pointer)
+            val view = construct(js("Float32Array"), draco.HEAPF32.buffer, pointer, count)
+            // Copy out of the WASM heap; Kotlin FloatArray is a Float32Array on JS
+            return DracoAttribute(view.slice().unsafeCast<FloatArray>(), itemSize)
+        } finally {
+            draco._free(pointer)
+        }
+    }
+
+    private fun readIndices(draco: dynamic, decoder: dynamic, geometry: dynamic): IntArray {
+        val count = (geometry.num_faces() as Int) * 3
+        val byteLength = count * 4
+        val pointer = draco._malloc(byteLength)
+        try {
+            decoder.GetTrianglesUInt32Array(geometry, byteLength, pointer)
+            val view = construct(js("Int32Array"), draco.HEAPF32.buffer, pointer, count)
+            return view.slice().unsafeCast<IntArray>()
+        } finally {
+            draco._free(pointer)
+        }
+    }
+
+    @Suppress("UNUSED_PARAMETER")
+    private fun construct(type: dynamic, vararg args: dynamic): dynamic =
+        js("Reflect.construct(type, args)")
+
+    private companion object {
+        val DEFAULT_TYPES = listOf(
+            "POSITION" to "POSITION",
+            "NORMAL" to "NORMAL",
+            "TEXCOORD_0" to "TEX_COORD",
+            "COLOR_0" to "COLOR"
+        )
+    }
+}
+
+internal actual fun createDefaultDracoDecoder(): DracoDecoder? = DracoWorkerDecoder()
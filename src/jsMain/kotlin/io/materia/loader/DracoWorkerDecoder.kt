@@ -0,0 +1,206 @@
+package io.materia.loader
+
+import kotlinx.browser.window
+import kotlinx.coroutines.CompletableDeferred
+import org.w3c.dom.MessageEvent
+import org.w3c.dom.Worker
+import org.w3c.dom.url.URL
+import org.w3c.files.Blob
+import org.w3c.files.BlobPropertyBag
+
+/**
+ * Draco decoder that runs the draco3d WebAssembly build in a dedicated Web Worker, so
+ * decoding large meshes does not stall the page.
+ *
+ * The worker loads `draco_decoder.js` and `draco_decoder.wasm` from [decoderPath]; copy
+ * them there from the `draco3d` package. Decodes go to one shared worker and results come
+ * back as transferred buffers. Where workers are unavailable (Node) or the decoder files
+ * cannot be loaded, decoding falls back to the in-thread [WasmDracoDecoder].
+ *
+ * @param decoderPath URL of the directory holding the decoder files, relative to the page.
+ */
+class DracoWorkerDecoder(private val decoderPath: String = DEFAULT_DECODER_PATH) : DracoDecoder {
+    private val fallback = WasmDracoDecoder()
+    private val pending = HashMap<Int, CompletableDeferred<dynamic>>()
+    private var worker: Worker? = null
+    private var unavailable = !workersSupported()
+    private var nextId = 0
+
+    override suspend fun decode(data: ByteArray, attributeIds: Map<String, Int>): DracoMesh {
+        if (unavailable) return fallback.decode(data, attributeIds)
+
+        val id = nextId++
+        val reply = CompletableDeferred<dynamic>()
+        pending[id] = reply
+        // Transfer a copy so the caller's array stays usable
+        val payload = data.asDynamic().slice()
+        val ids: dynamic = js("({})")
+        attributeIds.forEach { (semantic, uniqueId) -> ids[semantic] = uniqueId }
+        val message: dynamic = js("({})")
+        message.id = id
+        message.data = payload.buffer
+        message.attributeIds = ids
+        message.useIds = attributeIds.isNotEmpty()
+
+        val result = try {
+            worker().postMessage(message, arrayOf(payload.buffer))
+            reply.await()
+        } finally {
+            pending.remove(id)
+        }
+
+        if (result.unavailable == true) {
+            markUnavailable(result.error as? String)
+            return fallback.decode(data, attributeIds)
+        }
+        if (result.error != null) throw IllegalArgumentException("Draco decoding failed: ${result.error}")
+        return toMesh(result)
+    }
+
+    private fun worker(): Worker = worker ?: createWorker().also { worker = it }
+
+    private fun createWorker(): Worker {
+        val blob = Blob(arrayOf(WORKER_SOURCE), BlobPropertyBag(type = "application/javascript"))
+        val created = Worker(URL.createObjectURL(blob))
+        created.onmessage = { event: MessageEvent ->
+            val data = event.data.asDynamic()
+            pending[data.id as Int]?.complete(data)
+        }
+        created.onerror = { event ->
+            val failure: dynamic = js("({ unavailable: true })")
+            failure.error = event.asDynamic().message as? String
+            pending.values.toList().forEach { it.complete(failure) }
+        }
+        // importScripts in a blob worker resolves against the blob URL, so pass absolute URLs
+        val base = URL(decoderPath.let { if (it.endsWith("/")) it else "$it/" }, window.location.href).href
+        val init: dynamic = js("({ init: true })")
+        init.decoderUrl = base + DECODER_SCRIPT
+        init.decoderPath = base
+        created.postMessage(init)
+        return created
+    }
+
+    private fun markUnavailable(reason: String?) {
+        if (unavailable) return
+        unavailable = true
+        worker?.terminate()
+        worker = null
+        console.warn("Draco worker unavailable (${reason ?: "unknown error"}); decoding on the main thread")
+    }
+
+    private fun toMesh(result: dynamic): DracoMesh {
+        val attributes = HashMap<String, DracoAttribute>()
+        val names = js("Object.keys")(result.attributes).unsafeCast<Array<String>>()
+        names.forEach { semantic ->
+            val attribute = result.attributes[semantic]
+            attributes[semantic] = DracoAttribute(attribute.array.unsafeCast<FloatArray>(), attribute.itemSize as Int)
+        }
+        val indices = result.indices?.unsafeCast<IntArray>()
+        return DracoMesh(attributes, indices)
+    }
+
+    private companion object {
+        const val DEFAULT_DECODER_PATH = "draco/"
+        const val DECODER_SCRIPT = "draco_decoder.js"
+
+        fun workersSupported(): Boolean = js("typeof Worker !== 'undefined' && typeof Blob !== 'undefined'") as Boolean
+
+        // Mirrors WasmDracoDecoder.decode; replies carry transferred Float32/Int32 buffers
+        val WORKER_SOURCE = """
+            var modulePromise = null;
+            var loadError = null;
+            var DEFAULT_TYPES = [
+                ['POSITION', 'POSITION'], ['NORMAL', 'NORMAL'],
+                ['TEXCOORD_0', 'TEX_COORD'], ['COLOR_0', 'COLOR']
+            ];
+
+            self.onmessage = function (event) {
+                var message = event.data;
+                if (message.init) {
+                    try {
+                        importScripts(message.decoderUrl);
+                        modulePromise = DracoDecoderModule({
+                            locateFile: function (file) { return message.decoderPath + file; }
+                        });
+                    } catch (error) {
+                        loadError = String(error && error.message || error);
+                    }
+                    return;
+                }
+                if (loadError !== null) {
+                    self.postMessage({ id: message.id, unavailable: true, error: loadError });
+                    return;
+                }
+                modulePromise.then(function (draco) {
+                    var transfer = [];
+                    var result;
+                    try {
+                        result = decode(draco, new Int8Array(message.data), message, transfer);
+                    } catch (error) {
+                        self.postMessage({ id: message.id, error: String(error && error.message || error) });
+                        return;
+                    }
+                    result.id = message.id;
+                    self.postMessage(result, transfer);
+                }, function (error) {
+                    self.postMessage({ id: message.id, unavailable: true, error: String(error && error.message || error) });
+                });
+            };
+
+            function decode(draco, data, message, transfer) {
+                var decoder = new draco.Decoder();
+                var pointCloud = decoder.GetEncodedGeometryType(data) === draco.POINT_CLOUD;
+                var geometry = pointCloud ? new draco.PointCloud() : new draco.Mesh();
+                try {
+                    var status = pointCloud
+                        ? decoder.DecodeArrayToPointCloud(data, data.length, geometry)
+                        : decoder.DecodeArrayToMesh(data, data.length, geometry);
+                    if (!status.ok() || geometry.ptr === 0) throw new Error(status.error_msg());
+
+                    var attributes = {};
+                    DEFAULT_TYPES.forEach(function (entry) {
+                        var semantic = entry[0];
+                        var attribute;
+                        if (message.useIds) {
+                            if (!(semantic in message.attributeIds)) return;
+                            attribute = decoder.GetAttributeByUniqueId(geometry, message.attributeIds[semantic]);
+                        } else {
+                            var id = decoder.GetAttributeId(geometry, draco[entry[1]]);
+                            if (id < 0) return;
+                            attribute = decoder.GetAttribute(geometry, id);
+                        }
+                        if (!attribute || attribute.ptr === 0) return;
+                        var itemSize = attribute.num_components();
+                        var count = geometry.num_points() * itemSize;
+                        var pointer = draco._malloc(count * 4);
+                        try {
+                            decoder.GetAttributeDataArrayForAllPoints(geometry, attribute, draco.DT_FLOAT32, count * 4, pointer);
+                            var array = new Float32Array(draco.HEAPF32.buffer, pointer, count).slice();
+                            attributes[semantic] = { array: array, itemSize: itemSize };
+                            transfer.push(array.buffer);
+                        } finally {
+                            draco._free(pointer);
+                        }
+                    });
+
+                    var indices = null;
+                    if (!pointCloud) {
+                        var indexCount = geometry.num_faces() * 3;
+                        var indexPointer = draco._malloc(indexCount * 4);
+                        try {
+                            decoder.GetTrianglesUInt32Array(geometry, indexCount * 4, indexPointer);
+                            indices = new Int32Array(draco.HEAPF32.buffer, indexPointer, indexCount).slice();
+                            transfer.push(indices.buffer);
+                        } finally {
+                            draco._free(indexPointer);
+                        }
+                    }
+                    return { attributes: attributes, indices: indices };
+                } finally {
+                    draco.destroy(geometry);
+                    draco.destroy(decoder);
+                }
+            }
+        """.trimIndent()
+    }
+}
@@ -7,6 +7,7 @@
 
 package io.materia.renderer
 
+import io.materia.optimization.ResidencyManager
 import io.materia.renderer.webgpu.WebGPURenderer
 import io.materia.renderer.webgpu.WebGPUSurface
 import org.w3c.dom.HTMLCanvasElement
@@ -177,7 +178,10 @@ actual object RendererFactory {
      * @return WebGPURenderer instance
      */
     private fun createWebGPURenderer(canvas: HTMLCanvasElement, config: RendererConfig): Renderer =
-        WebGPURenderer(canvas)
+        WebGPURenderer(
+            canvas,
+            config.gpuMemoryBudget?.let { ResidencyManager(it, evictionDelayFrames = config.framesInFlight) }
+        )
 
     /**
      * Create WebGLRenderer instance.
@@ -258,6 +258,14 @@ actual object GpuDeviceFactory {
 
         val deviceDescriptor = js("({})").unsafeCast<GPUDeviceDescriptor>()
         config.label?.let { deviceDescriptor.label = it }
+        // Opt into every block-compression family the adapter offers so transcoded
+        // KTX2 textures can be uploaded without falling back to RGBA8
+        val adapterFeatures = adapter.features
+        val compressionFeatures = TEXTURE_COMPRESSION_FEATURES
+            .filter { adapterFeatures?.has(it) == true }
+        if (compressionFeatures.isNotEmpty()) {
+            deviceDescriptor.requiredFeatures = compressionFeatures.toTypedArray()
+        }
 
         val devicePromise = adapter.requestDevice(deviceDescriptor) as? Promise<GPUDevice>
             ?: error("WebGPU device request did not return a promise")
@@ -277,6 +285,12 @@ actual object GpuDeviceFactory {
     }
 }
 
+private val TEXTURE_COMPRESSION_FEATURES = listOf(
+    "texture-compression-bc",
+    "texture-compression-etc2",
+    "texture-compression-astc"
+)
+
 actual fun GpuDevice.unwrapHandle(): Any? = this.device
 
 actual fun GpuDevice.unwrapPhysicalHandle(): Any? = this.physicalDeviceHandle
@@ -131,7 +131,7 @@ class WebGLRenderer(
         gl.viewport(0, 0, canvas.width, canvas.height)
         gl.clear(COLOR_BUFFER_BIT or DEPTH_BUFFER_BIT)
 
-        scene.updateMatrixWorld(true)
+        scene.updateMatrixWorld()
         camera.updateMatrixWorld(false)
         camera.updateProjectionMatrix()
 
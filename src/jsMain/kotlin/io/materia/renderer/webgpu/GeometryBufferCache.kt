@@ -1,15 +1,23 @@
 package io.materia.renderer.webgpu
 
 import io.materia.geometry.BufferGeometry
+import io.materia.optimization.ResidencyManager
+import io.materia.profiling.MemoryAllocationType
 import io.materia.renderer.gpu.GpuDevice
 import io.materia.renderer.geometry.GeometryBuilder
 import io.materia.renderer.geometry.GeometryBuildOptions
 import io.materia.renderer.geometry.GeometryMetadata
 import io.materia.renderer.webgpu.VertexBufferLayout
 
+/**
+ * Vertex and index buffers per geometry and build options. With a [residency] manager the
+ * buffers count against its budget and are destroyed when it evicts them; the next
+ * [getOrCreate] for an evicted geometry uploads it again.
+ */
 internal class GeometryBufferCache(
     private val deviceProvider: () -> GpuDevice?,
-    private val statsTracker: RenderStatsTracker? = null
+    private val statsTracker: RenderStatsTracker? = null,
+    private val residency: ResidencyManager? = null
 ) {
     private data class CacheKey(val geometryId: String, val options: GeometryBuildOptions)
 
@@ -21,7 +29,10 @@ internal class GeometryBufferCache(
         options: GeometryBuildOptions
     ): GeometryBuffers? {
         val key = CacheKey(geometry.uuid, options)
-        buffersByGeometry[key]?.let { return it }
+        buffersByGeometry[key]?.let {
+            residency?.touch(key)
+            return it
+        }
 
         val gpuDevice = deviceProvider() ?: run {
             console.error("WebGPU device unavailable when creating geometry buffers")
@@ -83,6 +94,11 @@ internal class GeometryBufferCache(
             )
 
             buffersByGeometry[key] = buffers
+            residency?.register(
+                key,
+                MemoryAllocationType.GEOMETRY,
+                vertexStreams.sumOf { it.sizeBytes.toLong() } + indexSizeBytes
+            ) { buffersByGeometry.remove(key)?.let(::destroy) }
             buffers
         } catch (e: Exception) {
             console.error("Failed to create geometry buffers: ${e.message}")
@@ -91,26 +107,31 @@ internal class GeometryBufferCache(
     }
 
     fun clear() {
-        buffersByGeometry.values.forEach { buffers ->
-            buffers.vertexStreams.forEach { stream ->
-                try {
-                    statsTracker?.recordBufferDeallocated(stream.sizeBytes.toLong())
-                    stream.buffer.destroy()
-                } catch (_: Throwable) {
-                    // ignored
-                }
-            }
+        buffersByGeometry.forEach { (key, buffers) ->
+            residency?.unregister(key)
+            destroy(buffers)
+        }
+        buffersByGeometry.clear()
+    }
 
+    private fun destroy(buffers: GeometryBuffers) {
+        buffers.vertexStreams.forEach { stream ->
             try {
-                buffers.indexBuffer?.let { indexBuffer ->
-                    statsTracker?.recordBufferDeallocated(buffers.indexBufferSize.toLong())
-                    indexBuffer.destroy()
-                }
+                statsTracker?.recordBufferDeallocated(stream.sizeBytes.toLong())
+                stream.buffer.destroy()
             } catch (_: Throwable) {
                 // ignored
             }
         }
-        buffersByGeometry.clear()
+
+        try {
+            buffers.indexBuffer?.let { indexBuffer ->
+                statsTracker?.recordBufferDeallocated(buffers.indexBufferSize.toLong())
+                indexBuffer.destroy()
+            }
+        } catch (_: Throwable) {
+            // ignored
+        }
     }
 }
 
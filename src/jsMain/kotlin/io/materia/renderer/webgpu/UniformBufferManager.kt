@@ -2,6 +2,8 @@ package io.materia.renderer.webgpu
 
 import io.materia.camera.Camera
 import io.materia.core.scene.Mesh
+import io.materia.renderer.geometry.BonePalette
+import io.materia.renderer.geometry.MorphTargetBuffer
 import io.materia.renderer.gpu.*
 import io.materia.renderer.material.MaterialDescriptorRegistry
 
@@ -19,10 +21,16 @@ internal class UniformBufferManager(
     private var pipelineLayout: GpuPipelineLayout? = null
     private var cachedBindGroup: GpuBindGroup? = null
     private var uniformBufferSizeBytes: Long = 0
+    private var boneBuffer: WebGPUBuffer? = null
+    private var boneBufferSizeBytes: Long = 0
+    private var morphBuffer: WebGPUBuffer? = null
+    private var morphBufferSizeBytes: Long = 0
 
     fun onDeviceReady(device: GpuDevice) {
         ensureLayouts(device)
         ensureUniformBuffer(device)
+        ensureBoneBuffer(device, MIN_BONE_BUFFER_BYTES)
+        ensureMorphBuffer(device, MIN_MORPH_BUFFER_BYTES)
     }
 
     fun updateUniforms(
@@ -31,7 +39,12 @@ internal class UniformBufferManager(
         drawIndex: Int,
         frameInfo: FrameDebugInfo,
         enableDiagnostics: Boolean,
-        materialUniforms: MaterialUniformData? = null
+        materialUniforms: MaterialUniformData? = null,
+        firstBone: Int = 0,
+        boneCount: Int = 0,
+        morphHeaders: FloatArray? = null,
+        morphWeights: FloatArray? = null,
+        morphCount: Int = 0
     ): Boolean {
         val gpuDevice = deviceProvider() ?: return false
         ensureUniformBuffer(gpuDevice)
@@ -54,7 +67,7 @@ internal class UniformBufferManager(
             logMatrices(frameInfo, camera, projMatrix, viewMatrix, modelMatrix)
         }
 
-        val uniformData = FloatArray(88)
+        val uniformData = FloatArray(UNIFORM_FLOATS)
         for (i in 0 until 16) {
             uniformData[i] = projMatrix[i]
             uniformData[16 + i] = viewMatrix[i]
@@ -116,13 +129,16 @@ internal class UniformBufferManager(
         uniformData[78] = mainLightColor.getOrNull(2) ?: 0f
         uniformData[79] = mainLightColor.getOrNull(3) ?: 0f
 
-        val morphInfluenceSource = mesh.morphTargetInfluences
-            ?: (mesh.userData["morphTargetInfluences"] as? MutableList<Float>)
-            ?: emptyList<Float>()
-        for (i in 0 until MAX_MORPH_TARGETS) {
-            uniformData[80 + i] = morphInfluenceSource.getOrNull(i) ?: 0f
+        // Active morph targets, already capped and sorted by MorphTargetBuffer.selectActive
+        if (morphCount > 0 && morphHeaders != null && morphWeights != null) {
+            morphWeights.copyInto(uniformData, 80, 0, MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+            morphHeaders.copyInto(uniformData, 92, 0, MorphTargetBuffer.MAX_ACTIVE_TARGETS)
         }
 
+        uniformData[88] = firstBone.toFloat()
+        uniformData[89] = boneCount.toFloat()
+        uniformData[100] = morphCount.toFloat()
+
         val offset = dynamicOffset(drawIndex)
         if (offset + OBJECT_BYTES > UNIFORM_BUFFER_SIZE) {
             console.error("T021 CRITICAL: Buffer overflow prevented! Offset=$offset exceeds buffer size=$UNIFORM_BUFFER_SIZE")
@@ -133,14 +149,49 @@ internal class UniformBufferManager(
         return true
     }
 
+    /**
+     * Uploads this frame's bone palette to the storage buffer bound at group 0 binding 1,
+     * growing the buffer (and rebuilding the bind group) when the palette outgrew it.
+     * Call before recording draws that read it.
+     */
+    fun uploadBonePalette(palette: BonePalette): Boolean {
+        if (palette.boneCount == 0) return true
+        val gpuDevice = deviceProvider() ?: return false
+        val bytes = palette.floatCount * Float.SIZE_BYTES
+        ensureBoneBuffer(gpuDevice, bytes)
+        val buffer = boneBuffer ?: return false
+        return buffer.upload(palette.data, 0, palette.floatCount) is io.materia.core.Result.Success
+    }
+
+    /**
+     * Uploads the morph target words added since the last upload to the storage buffer
+     * bound at group 0 binding 2. When the buffer has to grow, the new one gets all of them.
+     */
+    fun uploadMorphTargets(targets: MorphTargetBuffer): Boolean {
+        if (targets.wordCount == targets.uploadedWords) return true
+        val gpuDevice = deviceProvider() ?: return false
+        val previous = morphBuffer
+        ensureMorphBuffer(gpuDevice, targets.bytes)
+        val buffer = morphBuffer ?: return false
+        val from = if (buffer === previous) targets.uploadedWords else 0
+        val result = buffer.uploadIndices(targets.data, from * Int.SIZE_BYTES, from, targets.wordCount - from)
+        if (result !is io.materia.core.Result.Success) return false
+        targets.markUploaded()
+        return true
+    }
+
     fun bindGroup(): GpuBindGroup? {
         cachedBindGroup?.let { return it }
 
         val gpuDevice = deviceProvider() ?: return null
         ensureLayouts(gpuDevice)
         ensureUniformBuffer(gpuDevice)
+        ensureBoneBuffer(gpuDevice, MIN_BONE_BUFFER_BYTES)
+        ensureMorphBuffer(gpuDevice, MIN_MORPH_BUFFER_BYTES)
         val layout = bindGroupLayout ?: return null
         val gpuBuffer = uniformBuffer?.gpuBuffer() ?: return null
+        val boneGpuBuffer = boneBuffer?.gpuBuffer() ?: return null
+        val morphGpuBuffer = morphBuffer?.gpuBuffer() ?: return null
 
         val descriptor = GpuBindGroupDescriptor(
             layout = layout,
@@ -152,6 +203,22 @@ internal class UniformBufferManager(
                         offset = 0,
                         size = OBJECT_BYTES.toLong()
                     )
+                ),
+                GpuBindGroupEntry(
+                    binding = 1,
+                    resource = GpuBindingResource.Buffer(
+                        buffer = boneGpuBuffer,
+                        offset = 0,
+                        size = boneBufferSizeBytes
+                    )
+                ),
+                GpuBindGroupEntry(
+                    binding = 2,
+                    resource = GpuBindingResource.Buffer(
+                        buffer = morphGpuBuffer,
+                        offset = 0,
+                        size = morphBufferSizeBytes
+                    )
                 )
             ),
             label = "Uniform Bind Group (Dynamic Offsets)"
@@ -200,6 +267,18 @@ internal class UniformBufferManager(
         }
         uniformBuffer?.dispose()
         uniformBuffer = null
+        if (boneBuffer != null && boneBufferSizeBytes > 0) {
+            statsTracker?.recordBufferDeallocated(boneBufferSizeBytes)
+            boneBufferSizeBytes = 0
+        }
+        boneBuffer?.dispose()
+        boneBuffer = null
+        if (morphBuffer != null && morphBufferSizeBytes > 0) {
+            statsTracker?.recordBufferDeallocated(morphBufferSizeBytes)
+            morphBufferSizeBytes = 0
+        }
+        morphBuffer?.dispose()
+        morphBuffer = null
     }
 
     private fun ensureLayouts(device: GpuDevice) {
@@ -236,6 +315,67 @@ internal class UniformBufferManager(
         }
     }
 
+    // Grows geometrically so a steadily growing crowd does not reallocate every frame
+    private fun ensureBoneBuffer(device: GpuDevice, requiredBytes: Int) {
+        if (boneBuffer != null && boneBufferSizeBytes >= requiredBytes) return
+
+        var size = maxOf(boneBufferSizeBytes.toInt(), MIN_BONE_BUFFER_BYTES)
+        while (size < requiredBytes) size *= 2
+        val buffer = WebGPUBuffer(
+            device,
+            BufferDescriptor(
+                size = size,
+                usage = GPUBufferUsage.STORAGE or GPUBufferUsage.COPY_DST,
+                label = "Bone Palette"
+            )
+        )
+
+        when (buffer.create()) {
+            is io.materia.core.Result.Success -> {
+                boneBuffer?.dispose()
+                if (boneBufferSizeBytes > 0) statsTracker?.recordBufferDeallocated(boneBufferSizeBytes)
+                boneBuffer = buffer
+                boneBufferSizeBytes = size.toLong()
+                cachedBindGroup = null
+                statsTracker?.recordBufferAllocated(boneBufferSizeBytes)
+            }
+
+            is io.materia.core.Result.Error -> {
+                console.error("Failed to create bone palette buffer ($size bytes)")
+            }
+        }
+    }
+
+    private fun ensureMorphBuffer(device: GpuDevice, requiredBytes: Int) {
+        if (morphBuffer != null && morphBufferSizeBytes >= requiredBytes) return
+
+        var size = maxOf(morphBufferSizeBytes.toInt(), MIN_MORPH_BUFFER_BYTES)
+        while (size < requiredBytes) size *= 2
+        val buffer = WebGPUBuffer(
+            device,
+            BufferDescriptor(
+                size = size,
+                usage = GPUBufferUsage.STORAGE or GPUBufferUsage.COPY_DST,
+                label = "Morph Targets"
+            )
+        )
+
+        when (buffer.create()) {
+            is io.materia.core.Result.Success -> {
+                morphBuffer?.dispose()
+                if (morphBufferSizeBytes > 0) statsTracker?.recordBufferDeallocated(morphBufferSizeBytes)
+                morphBuffer = buffer
+                morphBufferSizeBytes = size.toLong()
+                cachedBindGroup = null
+                statsTracker?.recordBufferAllocated(morphBufferSizeBytes)
+            }
+
+            is io.materia.core.Result.Error -> {
+                console.error("Failed to create morph target buffer ($size bytes)")
+            }
+        }
+    }
+
     private fun createUniformBindGroupLayout(device: GpuDevice): GpuBindGroupLayout {
         val descriptor = GpuBindGroupLayoutDescriptor(
             entries = listOf(
@@ -247,6 +387,16 @@ internal class UniformBufferManager(
                         hasDynamicOffset = true,
                         minBindingSize = OBJECT_BYTES.toLong()
                     )
+                ),
+                GpuBindGroupLayoutEntry(
+                    binding = 1,
+                    visibility = GpuShaderStage.VERTEX.bits,
+                    buffer = GpuBufferBindingLayout(type = GpuBufferBindingType.READ_ONLY_STORAGE)
+                ),
+                GpuBindGroupLayoutEntry(
+                    binding = 2,
+                    visibility = GpuShaderStage.VERTEX.bits,
+                    buffer = GpuBufferBindingLayout(type = GpuBufferBindingType.READ_ONLY_STORAGE)
                 )
             ),
             label = "Uniform Bind Group Layout (Dynamic Offsets)"
@@ -284,7 +434,9 @@ internal class UniformBufferManager(
     companion object {
         const val MAX_MESHES_PER_FRAME = 200
         private const val UNIFORM_ALIGNMENT = 256
-        private const val MAX_MORPH_TARGETS = 8
+        private const val UNIFORM_FLOATS = 104
+        private const val MIN_BONE_BUFFER_BYTES = 64 * BonePalette.FLOATS_PER_BONE * Float.SIZE_BYTES
+        private const val MIN_MORPH_BUFFER_BYTES = 4096
         private val OBJECT_BYTES_INTERNAL = MaterialDescriptorRegistry.uniformBlockSizeBytes()
         val OBJECT_BYTES: Int = OBJECT_BYTES_INTERNAL
         val UNIFORM_SIZE_PER_MESH: Int =
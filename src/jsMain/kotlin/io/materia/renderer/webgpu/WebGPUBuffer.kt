@@ -49,12 +49,13 @@ class WebGPUBuffer(
      * Uploads data to the buffer.
      * @param data Data to upload (FloatArray, IntArray, etc.)
      * @param offset Offset in bytes
+     * @param count Number of leading floats of [data] to upload
      */
-    fun upload(data: FloatArray, offset: Int = 0): io.materia.core.Result<Unit> {
+    fun upload(data: FloatArray, offset: Int = 0, count: Int = data.size): io.materia.core.Result<Unit> {
         return try {
             buffer?.let { buf ->
-                val float32Array = Float32Array(data.size)
-                for (i in data.indices) {
+                val float32Array = Float32Array(count)
+                for (i in 0 until count) {
                     float32Array.asDynamic()[i] = data[i]
                 }
                 val rawDevice = device.unwrapHandle() as? GPUDevice
@@ -62,7 +63,7 @@ class WebGPUBuffer(
                         "Device unavailable",
                         IllegalStateException("GPU device missing")
                     )
-                rawDevice.queue.writeBuffer(buf, offset, float32Array, 0, data.size)
+                rawDevice.queue.writeBuffer(buf, offset, float32Array, 0, count)
                 io.materia.core.Result.Success(Unit)
             } ?: io.materia.core.Result.Error(
                 "Buffer not created",
@@ -75,20 +76,28 @@ class WebGPUBuffer(
 
     /**
      * Uploads index data to the buffer.
+     * @param offset Offset in bytes
+     * @param from First element of [data] to upload
+     * @param count Number of elements of [data] to upload, starting at [from]
      */
-    fun uploadIndices(data: IntArray, offset: Int = 0): io.materia.core.Result<Unit> {
+    fun uploadIndices(
+        data: IntArray,
+        offset: Int = 0,
+        from: Int = 0,
+        count: Int = data.size - from
+    ): io.materia.core.Result<Unit> {
         return try {
             buffer?.let { buf ->
-                val uint32Array = Uint32Array(data.size)
-                for (i in data.indices) {
-                    uint32Array.asDynamic()[i] = data[i]
+                val uint32Array = Uint32Array(count)
+                for (i in 0 until count) {
+                    uint32Array.asDynamic()[i] = data[from + i]
                 }
                 val rawDevice = device.unwrapHandle() as? GPUDevice
                     ?: return io.materia.core.Result.Error(
                         "Device unavailable",
                         IllegalStateException("GPU device missing")
                     )
-                rawDevice.queue.writeBuffer(buf, offset, uint32Array, 0, data.size)
+                rawDevice.queue.writeBuffer(buf, offset, uint32Array, 0, count)
                 io.materia.core.Result.Success(Unit)
             } ?: io.materia.core.Result.Error(
                 "Buffer not created",
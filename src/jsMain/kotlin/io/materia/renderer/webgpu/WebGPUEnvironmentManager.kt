@@ -31,6 +31,7 @@ import io.materia.renderer.gpu.unwrapHandle
 import io.materia.renderer.webgpu.GPUTextureUsage
 import io.materia.renderer.webgpu.GPUDevice
 import io.materia.renderer.webgpu.GPUTexture
+import io.materia.texture.GpuPrefilteredCubeTexture
 import org.khronos.webgl.Float32Array
 import org.khronos.webgl.Uint8Array
 import kotlin.math.abs
@@ -47,6 +48,10 @@ internal data class EnvironmentBinding(
 /**
  * Handles uploading prefiltered environment cubemaps to GPU memory and
  * prepares sampler/bind group objects for the WebGPU renderer.
+ *
+ * [GpuPrefilteredCubeTexture] environments are filtered on the device by
+ * [WebGPUIblGenerator] instead of being uploaded, and scenes without a BRDF LUT get
+ * one computed once per device.
  */
 internal class WebGPUEnvironmentManager(
     private val deviceProvider: () -> GpuDevice?,
@@ -67,11 +72,24 @@ internal class WebGPUEnvironmentManager(
     private var lastBrdfId: Int = -1
     private var lastBrdfVersion: Int = -1
     private var trackedBrdfBytes: Long = 0
+    private val iblGenerator = WebGPUIblGenerator()
+    private var generatedBrdfDevice: GpuDevice? = null
+    private var generatedBrdfTexture: GpuTexture? = null
+    private var generatedBrdfView: GpuTextureView? = null
+    private var generatedBrdfBytes: Long = 0
+    private val brdfSamplerDescriptor = GpuSamplerDescriptor(
+        magFilter = GpuSamplerFilter.LINEAR,
+        minFilter = GpuSamplerFilter.LINEAR,
+        mipmapFilter = GpuSamplerFilter.LINEAR,
+        lodMinClamp = 0f,
+        lodMaxClamp = 0f,
+        label = "IBL BRDF Sampler"
+    )
 
     fun prepare(cube: CubeTexture?, brdf: Texture2D?): EnvironmentBinding? {
         val device = deviceProvider() ?: return null
         cube ?: run {
-            dispose()
+            release()
             return null
         }
 
@@ -81,7 +99,11 @@ internal class WebGPUEnvironmentManager(
             return EnvironmentBinding(bindGroup!!, layout, mipCount)
         }
 
-        uploadEnvironment(device, cube)
+        if (cube is GpuPrefilteredCubeTexture) {
+            generateEnvironment(device, cube)
+        } else {
+            uploadEnvironment(device, cube)
+        }
         createSampler(device)
         ensureBrdfResources(device, brdf)
         createBindGroup(device)
@@ -92,35 +114,27 @@ internal class WebGPUEnvironmentManager(
     }
 
     fun dispose() {
-        if (trackedBytes > 0) {
-            statsTracker?.recordTextureDisposed(trackedBytes)
-            trackedBytes = 0
-        }
-        if (trackedBrdfBytes > 0) {
-            statsTracker?.recordTextureDisposed(trackedBrdfBytes)
-            trackedBrdfBytes = 0
+        release()
+        generatedBrdfTexture?.destroy()
+        generatedBrdfTexture = null
+        generatedBrdfView = null
+        generatedBrdfDevice = null
+        if (generatedBrdfBytes > 0) {
+            statsTracker?.recordTextureDisposed(generatedBrdfBytes)
+            generatedBrdfBytes = 0
         }
-        resourceRegistry.disposeAll()
-        resourceRegistry.reset()
-        cubeTexture = null
-        cubeView = null
+        iblGenerator.dispose()
+    }
+
+    /** Frees the current environment; the generated BRDF LUT is kept for the next one. */
+    private fun release() {
+        releaseTextures()
         sampler = null
-        brdfTexture = null
-        brdfView = null
-        brdfSampler = null
-        bindGroup = null
         bindGroupLayout = null
         lastTextureId = -1
-        lastBrdfId = -1
-        lastBrdfVersion = -1
     }
 
-    private fun uploadEnvironment(device: GpuDevice, cube: CubeTexture) {
-        val size = cube.size
-
-        val (mipLevels, faceMipData, byteSize) = collectMipChain(cube)
-        mipCount = mipLevels
-
+    private fun releaseTextures() {
         if (trackedBytes > 0) {
             statsTracker?.recordTextureDisposed(trackedBytes)
             trackedBytes = 0
@@ -139,31 +153,15 @@ internal class WebGPUEnvironmentManager(
         bindGroup = null
         lastBrdfId = -1
         lastBrdfVersion = -1
+    }
 
-        val descriptor = GpuTextureDescriptor(
-            width = size,
-            height = size,
-            depthOrArrayLayers = 6,
-            mipLevelCount = mipCount,
-            sampleCount = 1,
-            dimension = GpuTextureDimension.D2,
-            format = "rgba16float",
-            usage = GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.COPY_DST,
-            label = "IBL Prefilter Cubemap"
-        )
+    private fun uploadEnvironment(device: GpuDevice, cube: CubeTexture) {
+        val size = cube.size
 
-        val texture = device.createTexture(descriptor)
-        resourceRegistry.trackTexture(texture)
-        cubeTexture = texture
-        cubeView = texture.createView(
-            GpuTextureViewDescriptor(
-                label = "IBL Prefilter Cube View",
-                dimension = GpuTextureViewDimension.CUBE,
-                mipLevelCount = mipCount
-            )
-        )
-        trackedBytes = byteSize
-        statsTracker?.recordTextureCreated(byteSize)
+        val (mipLevels, faceMipData, byteSize) = collectMipChain(cube)
+        mipCount = mipLevels
+
+        val texture = createCubeTexture(device, size, GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.COPY_DST, byteSize)
 
         val rawDevice = device.unwrapHandle() as? GPUDevice ?: return
         val rawTexture = texture.unwrapHandle() as GPUTexture
@@ -216,6 +214,51 @@ internal class WebGPUEnvironmentManager(
         lastTextureId = cube.id
     }
 
+    private fun generateEnvironment(device: GpuDevice, cube: GpuPrefilteredCubeTexture) {
+        val rawDevice = device.unwrapHandle() as? GPUDevice ?: return
+        mipCount = cube.roughnessLevels
+        var byteSize = 0L
+        for (level in 0 until mipCount) {
+            val mipSize = max(1, cube.size shr level).toLong()
+            byteSize += HALF_BYTE_STRIDE * mipSize * mipSize * 6
+        }
+
+        val texture = createCubeTexture(device, cube.size, GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.STORAGE_BINDING, byteSize)
+        iblGenerator.prefilter(rawDevice, cube, texture.unwrapHandle() as GPUTexture)
+        lastTextureId = cube.id
+    }
+
+    /** Replaces the environment cube with an empty rgba16float one of [mipCount] levels. */
+    private fun createCubeTexture(device: GpuDevice, size: Int, usage: Int, byteSize: Long): GpuTexture {
+        releaseTextures()
+
+        val descriptor = GpuTextureDescriptor(
+            width = size,
+            height = size,
+            depthOrArrayLayers = 6,
+            mipLevelCount = mipCount,
+            sampleCount = 1,
+            dimension = GpuTextureDimension.D2,
+            format = "rgba16float",
+            usage = usage,
+            label = "IBL Prefilter Cubemap"
+        )
+
+        val texture = device.createTexture(descriptor)
+        resourceRegistry.trackTexture(texture)
+        cubeTexture = texture
+        cubeView = texture.createView(
+            GpuTextureViewDescriptor(
+                label = "IBL Prefilter Cube View",
+                dimension = GpuTextureViewDimension.CUBE,
+                mipLevelCount = mipCount
+            )
+        )
+        trackedBytes = byteSize
+        statsTracker?.recordTextureCreated(byteSize)
+        return texture
+    }
+
     private fun ensureBrdfResources(device: GpuDevice, brdf: Texture2D?) {
         val sourceId = brdf?.id ?: FALLBACK_BRDF_ID
         val sourceVersion = brdf?.version ?: FALLBACK_VERSION
@@ -229,6 +272,17 @@ internal class WebGPUEnvironmentManager(
         brdfView = null
         brdfSampler = null
 
+        if (brdf == null) {
+            val generated = generatedBrdfLut(device)
+            if (generated != null) {
+                brdfView = generated
+                brdfSampler = device.createSampler(brdfSamplerDescriptor)
+                lastBrdfId = sourceId
+                lastBrdfVersion = sourceVersion
+                return
+            }
+        }
+
         val width = brdf?.width ?: FALLBACK_BRDF_SIZE
         val height = brdf?.height ?: FALLBACK_BRDF_SIZE
         val floatData = brdf?.getData() ?: fallbackBrdfData(width, height)
@@ -256,16 +310,7 @@ internal class WebGPUEnvironmentManager(
         )
         brdfView = view
 
-        val samplerDescriptor = GpuSamplerDescriptor(
-            magFilter = GpuSamplerFilter.LINEAR,
-            minFilter = GpuSamplerFilter.LINEAR,
-            mipmapFilter = GpuSamplerFilter.LINEAR,
-            lodMinClamp = 0f,
-            lodMaxClamp = 0f,
-            label = "IBL BRDF Sampler"
-        )
-        val samplerHandle = device.createSampler(samplerDescriptor)
-        brdfSampler = samplerHandle
+        brdfSampler = device.createSampler(brdfSamplerDescriptor)
 
         uploadBrdfData(device, texture, floatData, width, height)
 
@@ -277,6 +322,43 @@ internal class WebGPUEnvironmentManager(
         brdf?.needsUpdate = false
     }
 
+    /**
+     * Split-sum LUT computed on the GPU, once per device, for scenes without their own.
+     * Returns null when the raw device is unavailable and the flat fallback must be used.
+     */
+    private fun generatedBrdfLut(device: GpuDevice): GpuTextureView? {
+        if (generatedBrdfDevice === device) generatedBrdfView?.let { return it }
+        val rawDevice = device.unwrapHandle() as? GPUDevice ?: return null
+        generatedBrdfTexture?.destroy()
+
+        val texture = device.createTexture(
+            GpuTextureDescriptor(
+                width = GENERATED_BRDF_SIZE,
+                height = GENERATED_BRDF_SIZE,
+                depthOrArrayLayers = 1,
+                mipLevelCount = 1,
+                sampleCount = 1,
+                dimension = GpuTextureDimension.D2,
+                format = "rg32float",
+                usage = GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.STORAGE_BINDING,
+                label = "IBL BRDF LUT"
+            )
+        )
+        iblGenerator.generateBrdfLut(rawDevice, texture.unwrapHandle() as GPUTexture, GENERATED_BRDF_SIZE, GENERATED_BRDF_SIZE)
+        if (generatedBrdfBytes == 0L) {
+            generatedBrdfBytes = GENERATED_BRDF_SIZE.toLong() * GENERATED_BRDF_SIZE * BRDF_BYTES_PER_PIXEL
+            statsTracker?.recordTextureCreated(generatedBrdfBytes)
+        }
+        generatedBrdfTexture = texture
+        generatedBrdfDevice = device
+        return texture.createView(
+            GpuTextureViewDescriptor(
+                label = "IBL BRDF View",
+                dimension = GpuTextureViewDimension.D2
+            )
+        ).also { generatedBrdfView = it }
+    }
+
     private fun createSampler(device: GpuDevice) {
         sampler = device.createSampler(
             GpuSamplerDescriptor(
@@ -410,47 +492,6 @@ internal class WebGPUEnvironmentManager(
         return data
     }
 
-    private fun floatArrayToHalfBytes(source: FloatArray): ByteArray {
-        val result = ByteArray(source.size * 2)
-        var outIndex = 0
-        for (value in source) {
-            val half = floatToHalf(value)
-            result[outIndex++] = (half and 0xFF).toByte()
-            result[outIndex++] = ((half shr 8) and 0xFF).toByte()
-        }
-        return result
-    }
-
-    private fun floatToHalf(value: Float): Int {
-        if (value.isNaN()) return 0x7E00
-        if (value == Float.POSITIVE_INFINITY) return 0x7C00
-        if (value == Float.NEGATIVE_INFINITY) return 0xFC00
-        val bits = abs(value).toBits()
-        val sign = if (value < 0f) 0x8000 else 0
-        var exponent = ((bits shr 23) and 0xFF) - 127 + 15
-        var mantissa = bits and 0x7FFFFF
-
-        return when {
-            exponent <= 0 -> {
-                if (exponent < -10) {
-                    sign
-                } else {
-                    mantissa = mantissa or 0x800000
-                    val shift = 14 - exponent
-                    val halfMantissa = mantissa shr shift
-                    sign or (halfMantissa + ((mantissa shr (shift - 1)) and 1))
-                }
-            }
-
-            exponent >= 0x1F -> sign or 0x7C00
-            else -> {
-                val halfMantissa = mantissa shr 13
-                val half = sign or (exponent shl 10) or halfMantissa
-                half + ((mantissa shr 12) and 1)
-            }
-        }
-    }
-
     private fun alignRowPitch(rowBytes: Int): Int {
         val alignment = 256
         return if (rowBytes % alignment == 0) rowBytes else ((rowBytes / alignment) + 1) * alignment
@@ -529,5 +570,48 @@ internal class WebGPUEnvironmentManager(
         private const val FALLBACK_BRDF_ID = -3
         private const val FALLBACK_VERSION = -1
         private const val FALLBACK_BRDF_SIZE = 32
+        private const val GENERATED_BRDF_SIZE = 256
+    }
+}
+
+/** Packs RGBA floats as little-endian half floats for rgba16float uploads. */
+internal fun floatArrayToHalfBytes(source: FloatArray): ByteArray {
+    val result = ByteArray(source.size * 2)
+    var outIndex = 0
+    for (value in source) {
+        val half = floatToHalf(value)
+        result[outIndex++] = (half and 0xFF).toByte()
+        result[outIndex++] = ((half shr 8) and 0xFF).toByte()
+    }
+    return result
+}
+
+private fun floatToHalf(value: Float): Int {
+    if (value.isNaN()) return 0x7E00
+    if (value == Float.POSITIVE_INFINITY) return 0x7C00
+    if (value == Float.NEGATIVE_INFINITY) return 0xFC00
+    val bits = abs(value).toBits()
+    val sign = if (value < 0f) 0x8000 else 0
+    var exponent = ((bits shr 23) and 0xFF) - 127 + 15
+    var mantissa = bits and 0x7FFFFF
+
+    return when {
+        exponent <= 0 -> {
+            if (exponent < -10) {
+                sign
+            } else {
+                mantissa = mantissa or 0x800000
+                val shift = 14 - exponent
+                val halfMantissa = mantissa shr shift
+                sign or (halfMantissa + ((mantissa shr (shift - 1)) and 1))
+            }
+        }
+
+        exponent >= 0x1F -> sign or 0x7C00
+        else -> {
+            val halfMantissa = mantissa shr 13
+            val half = sign or (exponent shl 10) or halfMantissa
+            half + ((mantissa shr 12) and 1)
+        }
     }
 }
@@ -0,0 +1,571 @@
+package io.materia.renderer.webgpu
+
+import io.materia.core.math.Vector3
+import io.materia.lighting.ibl.IBLConvolutionProfiler
+import io.materia.texture.CubeFace
+import io.materia.texture.GpuPrefilteredCubeTexture
+import io.materia.texture.SphericalHarmonics
+import org.khronos.webgl.ArrayBuffer
+import org.khronos.webgl.Float32Array
+import org.khronos.webgl.Int8Array
+import org.khronos.webgl.Uint8Array
+import org.khronos.webgl.get
+import kotlin.math.max
+import kotlin.math.sqrt
+
+/**
+ * Compute passes that build image-based lighting inputs on the GPU instead of
+ * integrating them on the CPU.
+ *
+ * [prefilter] turns the source of a [GpuPrefilteredCubeTexture] into a GGX prefiltered
+ * cube: an equirectangular source is first projected onto a cube, the cube is box
+ * downsampled into a full mip chain, and every roughness level is integrated with
+ * filtered importance sampling, reading the coarser source levels for wide lobes so a
+ * few hundred samples stay free of fireflies. SH9 irradiance coefficients are reduced per
+ * face in workgroup memory and read back asynchronously. [generateBrdfLut] writes the
+ * split-sum BRDF table.
+ *
+ * Pipelines are created on first use and kept for the device they were built on.
+ */
+internal class WebGPUIblGenerator {
+    private var device: GPUDevice? = null
+    private val pipelines = mutableMapOf<String, GPUComputePipeline>()
+    private var cubeSampler: GPUSampler? = null
+    private var equirectSampler: GPUSampler? = null
+
+    /**
+     * Fills every mip level of [target] — an rgba16float cube with storage binding and
+     * [GpuPrefilteredCubeTexture.roughnessLevels] levels — from [cube]'s source, and submits
+     * the work. [GpuPrefilteredCubeTexture.sphericalHarmonics] is set once the GPU finishes.
+     */
+    fun prefilter(device: GPUDevice, cube: GpuPrefilteredCubeTexture, target: GPUTexture) {
+        bind(device)
+        val startTime = js("performance.now()").unsafeCast<Double>()
+        val size = cube.size
+        val sourceLevels = 1 + log2Floor(size)
+        val usage = GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.STORAGE_BINDING or GPUTextureUsage.COPY_DST
+        val sourceCube = createTexture(device, "IBL Source Cube", size, size, 6, sourceLevels, "rgba16float", usage)
+        val transient = mutableListOf(sourceCube)
+
+        val encoder = device.createCommandEncoder(
+            js("({})").unsafeCast<GPUCommandEncoderDescriptor>().apply { label = "IBL Prefilter" }
+        )
+        val pass = encoder.beginComputePass()
+
+        when (val source = cube.source) {
+            is io.materia.texture.CubeTexture -> for (face in CubeFace.values()) {
+                val texels = source.faceTexels(face) ?: FloatArray(size * size * 4)
+                writeLayer(device, sourceCube, face.ordinal, size, size, texels)
+            }
+
+            is io.materia.texture.Texture2D -> {
+                val texels = source.getFloatData() ?: source.getData()?.let(::unormToFloats)
+                    ?: FloatArray(source.width * source.height * 4)
+                val equirect = createTexture(
+                    device, "IBL Equirect Source", source.width, source.height, 1, 1, "rgba16float",
+                    GPUTextureUsage.TEXTURE_BINDING or GPUTextureUsage.COPY_DST
+                )
+                transient += equirect
+                writeLayer(device, equirect, 0, source.width, source.height, texels)
+                val project = pipeline(device, "IBL Equirect To Cube", EQUIRECT_TO_CUBE_WGSL)
+                val group = bindGroup(device, project, equirect.createView(), equirectSampler!!, sourceCube.view("2d-array", 0))
+                pass.dispatch(project, group, size, size)
+            }
+        }
+
+        val downsample = pipeline(device, "IBL Downsample", DOWNSAMPLE_WGSL)
+        for (level in 1 until sourceLevels) {
+            val group = bindGroup(device, downsample, sourceCube.view("2d-array", level - 1), sourceCube.view("2d-array", level))
+            pass.dispatch(downsample, group, max(1, size shr level), max(1, size shr level))
+        }
+
+        // One 256-byte uniform slot per level: roughness and sample count
+        val levels = cube.roughnessLevels
+        val params = device.createBuffer(
+            js("({})").unsafeCast<GPUBufferDescriptor>().apply {
+                label = "IBL Prefilter Params"
+                this.size = levels * UNIFORM_SLOT_BYTES
+                this.usage = GPUBufferUsage.UNIFORM or GPUBufferUsage.COPY_DST
+            }
+        )
+        val paramData = Float32Array(levels * UNIFORM_SLOT_BYTES / 4)
+        val paramDynamic = paramData.asDynamic()
+        for (level in 0 until levels) {
+            paramDynamic[level * UNIFORM_SLOT_BYTES / 4] = levelRoughness(level, levels)
+            paramDynamic[level * UNIFORM_SLOT_BYTES / 4 + 1] = cube.sampleCount.toFloat()
+        }
+        device.queue.writeBuffer(params, 0, paramData)
+
+        val prefilter = pipeline(device, "IBL GGX Prefilter", PREFILTER_WGSL)
+        val sourceView = sourceCube.view("cube", 0, sourceLevels)
+        for (level in 0 until levels) {
+            val group = bindGroup(
+                device, prefilter,
+                sourceView, cubeSampler!!, target.view("2d-array", level),
+                bufferBinding(params, level * UNIFORM_SLOT_BYTES, PARAMS_BYTES)
+            )
+            pass.dispatch(prefilter, group, max(1, size shr level), max(1, size shr level))
+        }
+
+        // SH9 from a level of at most 64x64 texels; the projection is smooth enough for it
+        val partials = device.createBuffer(
+            js("({})").unsafeCast<GPUBufferDescriptor>().apply {
+                label = "IBL SH Partials"
+                this.size = SH_PARTIALS_BYTES
+                this.usage = GPUBufferUsage.STORAGE or GPUBufferUsage.COPY_SRC
+            }
+        )
+        val shLevel = max(0, sourceLevels - 1 - SH_MAX_LOG2_SIZE)
+        val sh = pipeline(device, "IBL SH Projection", SH_PROJECTION_WGSL)
+        pass.setPipeline(sh)
+        pass.setBindGroup(0, bindGroup(device, sh, sourceCube.view("2d-array", shLevel), bufferBinding(partials, 0, SH_PARTIALS_BYTES)))
+        pass.dispatchWorkgroups(6)
+        pass.end()
+
+        val readback = device.createBuffer(
+            js("({})").unsafeCast<GPUBufferDescriptor>().apply {
+                label = "IBL SH Readback"
+                this.size = SH_PARTIALS_BYTES
+                this.usage = GPUBufferUsage.MAP_READ or GPUBufferUsage.COPY_DST
+            }
+        )
+        encoder.copyBufferToBuffer(partials, 0, readback, 0, SH_PARTIALS_BYTES)
+        device.queue.submit(arrayOf(encoder.finish()))
+
+        // Destruction waits for the submitted passes
+        transient.forEach { it.destroy() }
+        params.destroy()
+        partials.destroy()
+
+        device.queue.onSubmittedWorkDone().then { _: dynamic ->
+            val elapsed = js("performance.now()").unsafeCast<Double>() - startTime
+            IBLConvolutionProfiler.recordPrefilter(elapsed, size, levels, cube.sampleCount)
+        }
+        readback.mapAsync(GPUMapMode.READ).then({ _: dynamic ->
+            cube.sphericalHarmonics = sumFacePartials(Float32Array(readback.getMappedRange().unsafeCast<ArrayBuffer>()))
+            readback.unmap()
+            readback.destroy()
+        }, { _: dynamic ->
+            readback.destroy()
+        })
+    }
+
+    /** Writes the split-sum BRDF table into [target], an rg32float texture with storage binding. */
+    fun generateBrdfLut(device: GPUDevice, target: GPUTexture, width: Int, height: Int) {
+        bind(device)
+        val encoder = device.createCommandEncoder(
+            js("({})").unsafeCast<GPUCommandEncoderDescriptor>().apply { label = "IBL BRDF LUT" }
+        )
+        val pass = encoder.beginComputePass()
+        val brdf = pipeline(device, "IBL BRDF Integration", BRDF_LUT_WGSL)
+        pass.setPipeline(brdf)
+        pass.setBindGroup(0, bindGroup(device, brdf, target.view("2d", 0)))
+        pass.dispatchWorkgroups(workgroups(width), workgroups(height))
+        pass.end()
+        device.queue.submit(arrayOf(encoder.finish()))
+    }
+
+    fun dispose() {
+        device = null
+        pipelines.clear()
+        cubeSampler = null
+        equirectSampler = null
+    }
+
+    private fun bind(device: GPUDevice) {
+        if (this.device === device) return
+        dispose()
+        this.device = device
+        cubeSampler = device.createSampler(js("({})").unsafeCast<GPUSamplerDescriptor>().apply {
+            label = "IBL Source Sampler"
+            magFilter = "linear"
+            minFilter = "linear"
+            mipmapFilter = "linear"
+            addressModeU = "clamp-to-edge"
+            addressModeV = "clamp-to-edge"
+            addressModeW = "clamp-to-edge"
+        })
+        equirectSampler = device.createSampler(js("({})").unsafeCast<GPUSamplerDescriptor>().apply {
+            label = "IBL Equirect Sampler"
+            magFilter = "linear"
+            minFilter = "linear"
+            addressModeU = "repeat"
+            addressModeV = "clamp-to-edge"
+        })
+    }
+
+    private fun pipeline(device: GPUDevice, label: String, code: String): GPUComputePipeline =
+        pipelines.getOrPut(label) {
+            val module = device.createShaderModule(js("({})").unsafeCast<GPUShaderModuleDescriptor>().apply {
+                this.label = label
+                this.code = code
+            })
+            device.createComputePipeline(js("({})").unsafeCast<GPUComputePipelineDescriptor>().apply {
+                this.label = label
+                layout = "auto"
+                compute = js("({})").unsafeCast<GPUProgrammableStage>().apply {
+                    this.module = module
+                    entryPoint = "main"
+                }
+            })
+        }
+
+    private fun bindGroup(device: GPUDevice, pipeline: GPUComputePipeline, vararg resources: Any): GPUBindGroup {
+        val descriptor = js("({})").unsafeCast<GPUBindGroupDescriptor>()
+        descriptor.layout = pipeline.getBindGroupLayout(0)
+        descriptor.entries = Array(resources.size) { index ->
+            js("({})").unsafeCast<GPUBindGroupEntry>().apply {
+                binding = index
+                resource = resources[index]
+            }
+        }
+        return device.createBindGroup(descriptor)
+    }
+
+    private fun bufferBinding(buffer: GPUBuffer, offset: Int, size: Int): GPUBufferBinding =
+        js("({})").unsafeCast<GPUBufferBinding>().apply {
+            this.buffer = buffer
+            this.offset = offset
+            this.size = size
+        }
+
+    /** Dispatches 8x8 workgroups over a [width] x [height] image on every face of the target. */
+    private fun GPUComputePassEncoder.dispatch(pipeline: GPUComputePipeline, group: GPUBindGroup, width: Int, height: Int) {
+        setPipeline(pipeline)
+        setBindGroup(0, group)
+        dispatchWorkgroups(workgroups(width), workgroups(height), 6)
+    }
+
+    private fun createTexture(
+        device: GPUDevice,
+        label: String,
+        width: Int,
+        height: Int,
+        layers: Int,
+        mipLevels: Int,
+        format: String,
+        usage: Int
+    ): GPUTexture {
+        val descriptor = js("({})").unsafeCast<GPUTextureDescriptor>()
+        descriptor.label = label
+        val extent = js("({})")
+        extent.width = width
+        extent.height = height
+        extent.depthOrArrayLayers = layers
+        descriptor.size = extent
+        descriptor.mipLevelCount = mipLevels
+        descriptor.format = format
+        descriptor.usage = usage
+        return device.createTexture(descriptor)
+    }
+
+    private fun GPUTexture.view(dimension: String, baseMipLevel: Int, mipLevelCount: Int = 1): GPUTextureView =
+        createView(js("({})").unsafeCast<GPUTextureViewDescriptor>().apply {
+            this.dimension = dimension
+            this.baseMipLevel = baseMipLevel
+            this.mipLevelCount = mipLevelCount
+        })
+
+    /** Uploads RGBA float [texels] as half floats into level 0 of array [layer]. */
+    private fun writeLayer(device: GPUDevice, texture: GPUTexture, layer: Int, width: Int, height: Int, texels: FloatArray) {
+        val bytes = floatArrayToHalfBytes(texels).unsafeCast<Int8Array>()
+
+        val destination = js("({})")
+        destination.texture = texture
+        destination.mipLevel = 0
+        val origin = js("({})")
+        origin.x = 0
+        origin.y = 0
+        origin.z = layer
+        destination.origin = origin
+
+        val dataLayout = js("({})")
+        dataLayout.offset = 0
+        dataLayout.bytesPerRow = width * HALF_TEXEL_BYTES
+        dataLayout.rowsPerImage = height
+
+        val sizeDesc = js("({})")
+        sizeDesc.width = width
+        sizeDesc.height = height
+        sizeDesc.depthOrArrayLayers = 1
+
+        device.queue.writeTexture(destination, Uint8Array(bytes.buffer, bytes.byteOffset, bytes.length), dataLayout, sizeDesc)
+    }
+
+    private fun sumFacePartials(partials: Float32Array): SphericalHarmonics =
+        SphericalHarmonics(List(9) { k ->
+            val sum = Vector3(0f, 0f, 0f)
+            for (face in 0 until 6) {
+                val base = (face * 9 + k) * 4
+                sum.x += partials[base]
+                sum.y += partials[base + 1]
+                sum.z += partials[base + 2]
+            }
+            sum
+        })
+
+    companion object {
+        private const val UNIFORM_SLOT_BYTES = 256
+        private const val PARAMS_BYTES = 16
+        private const val HALF_TEXEL_BYTES = 8
+        private const val SH_MAX_LOG2_SIZE = 6
+        private const val SH_PARTIALS_BYTES = 6 * 9 * 16
+
+        /**
+         * Lobe roughness of prefilter [level]; the inverse of
+         * [io.materia.lighting.ibl.PrefilterMipSelector], so a material samples the level
+         * that was filtered for its roughness.
+         */
+        fun levelRoughness(level: Int, levels: Int): Float =
+            if (levels <= 1) 0f else sqrt(level.toFloat() / (levels - 1))
+
+        private fun workgroups(extent: Int): Int = (extent + 7) / 8
+
+        private fun log2Floor(value: Int): Int {
+            var result = 0
+            var current = value
+            while (current > 1) {
+                current /= 2
+                result++
+            }
+            return result
+        }
+
+        private fun unormToFloats(bytes: ByteArray): FloatArray =
+            FloatArray(bytes.size) { (bytes[it].toInt() and 0xFF) / 255f }
+
+        private fun io.materia.texture.CubeTexture.faceTexels(face: CubeFace): FloatArray? =
+            getFaceFloatData(face) ?: getFaceData(face)?.let(::unormToFloats)
+
+        private const val FACE_DIRECTION_WGSL = """
+const PI: f32 = 3.14159265359;
+
+// Same face orientation as the CPU PMREM path and the WebGPU cube sampler
+fn faceDirection(face: u32, uv: vec2<f32>) -> vec3<f32> {
+    let n = uv * 2.0 - 1.0;
+    var dir: vec3<f32>;
+    switch face {
+        case 0u: { dir = vec3<f32>(1.0, -n.y, -n.x); }
+        case 1u: { dir = vec3<f32>(-1.0, -n.y, n.x); }
+        case 2u: { dir = vec3<f32>(n.x, 1.0, n.y); }
+        case 3u: { dir = vec3<f32>(n.x, -1.0, -n.y); }
+        case 4u: { dir = vec3<f32>(n.x, -n.y, 1.0); }
+        default: { dir = vec3<f32>(-n.x, -n.y, -1.0); }
+    }
+    return normalize(dir);
+}
+"""
+
+        private const val GGX_SAMPLING_WGSL = """
+fn hammersley(i: u32, count: u32) -> vec2<f32> {
+    return vec2<f32>(f32(i) / f32(count), f32(reverseBits(i)) * 2.3283064365386963e-10);
+}
+
+// GGX-distributed half vector around +Z
+fn importanceSampleGgx(xi: vec2<f32>, alpha: f32) -> vec3<f32> {
+    let phi = 2.0 * PI * xi.x;
+    let cosTheta = sqrt((1.0 - xi.y) / (1.0 + (alpha * alpha - 1.0) * xi.y));
+    let sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    return vec3<f32>(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+}
+"""
+
+        private const val EQUIRECT_TO_CUBE_WGSL = FACE_DIRECTION_WGSL + """
+@group(0) @binding(0) var srcTexture: texture_2d<f32>;
+@group(0) @binding(1) var srcSampler: sampler;
+@group(0) @binding(2) var dstTexture: texture_storage_2d_array<rgba16float, write>;
+
+@compute @workgroup_size(8, 8, 1)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let size = textureDimensions(dstTexture).x;
+    if (id.x >= size || id.y >= size) {
+        return;
+    }
+    let dir = faceDirection(id.z, (vec2<f32>(id.xy) + 0.5) / f32(size));
+    var phi = atan2(dir.z, dir.x);
+    if (phi < 0.0) {
+        phi = phi + 2.0 * PI;
+    }
+    let uv = vec2<f32>(phi / (2.0 * PI), acos(clamp(dir.y, -1.0, 1.0)) / PI);
+    let color = textureSampleLevel(srcTexture, srcSampler, uv, 0.0);
+    textureStore(dstTexture, vec2<i32>(id.xy), i32(id.z), vec4<f32>(color.rgb, 1.0));
+}
+"""
+
+        private const val DOWNSAMPLE_WGSL = """
+@group(0) @binding(0) var srcTexture: texture_2d_array<f32>;
+@group(0) @binding(1) var dstTexture: texture_storage_2d_array<rgba16float, write>;
+
+@compute @workgroup_size(8, 8, 1)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let size = textureDimensions(dstTexture).x;
+    if (id.x >= size || id.y >= size) {
+        return;
+    }
+    let base = vec2<i32>(id.xy) * 2;
+    let face = i32(id.z);
+    let color = textureLoad(srcTexture, base, face, 0)
+        + textureLoad(srcTexture, base + vec2<i32>(1, 0), face, 0)
+        + textureLoad(srcTexture, base + vec2<i32>(0, 1), face, 0)
+        + textureLoad(srcTexture, base + vec2<i32>(1, 1), face, 0);
+    textureStore(dstTexture, vec2<i32>(id.xy), face, color * 0.25);
+}
+"""
+
+        private const val PREFILTER_WGSL = FACE_DIRECTION_WGSL + GGX_SAMPLING_WGSL + """
+struct Params {
+    roughness: f32,
+    sampleCount: f32,
+    pad0: f32,
+    pad1: f32,
+}
+
+@group(0) @binding(0) var srcTexture: texture_cube<f32>;
+@group(0) @binding(1) var srcSampler: sampler;
+@group(0) @binding(2) var dstTexture: texture_storage_2d_array<rgba16float, write>;
+@group(0) @binding(3) var<uniform> params: Params;
+
+@compute @workgroup_size(8, 8, 1)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let size = textureDimensions(dstTexture).x;
+    if (id.x >= size || id.y >= size) {
+        return;
+    }
+    let n = faceDirection(id.z, (vec2<f32>(id.xy) + 0.5) / f32(size));
+    if (params.roughness <= 0.0) {
+        let mirror = textureSampleLevel(srcTexture, srcSampler, n, 0.0);
+        textureStore(dstTexture, vec2<i32>(id.xy), i32(id.z), vec4<f32>(mirror.rgb, 1.0));
+        return;
+    }
+
+    // Split-sum assumption: view and normal coincide with the lookup direction
+    let up = select(vec3<f32>(1.0, 0.0, 0.0), vec3<f32>(0.0, 0.0, 1.0), abs(n.z) < 0.999);
+    let tangent = normalize(cross(up, n));
+    let bitangent = cross(n, tangent);
+
+    let alpha = params.roughness * params.roughness;
+    let a2 = alpha * alpha;
+    let count = u32(params.sampleCount);
+    let srcSize = f32(textureDimensions(srcTexture).x);
+    let maxLod = f32(textureNumLevels(srcTexture) - 1u);
+    let texelSolidAngle = 4.0 * PI / (6.0 * srcSize * srcSize);
+
+    var color = vec3<f32>(0.0);
+    var weight = 0.0;
+    for (var i = 0u; i < count; i = i + 1u) {
+        let h = importanceSampleGgx(hammersley(i, count), alpha);
+        let hw = normalize(tangent * h.x + bitangent * h.y + n * h.z);
+        let l = 2.0 * dot(n, hw) * hw - n;
+        let nDotL = dot(n, l);
+        if (nDotL > 0.0) {
+            // Filtered importance sampling: read the level whose texels match the sample's solid angle
+            let q = h.z * h.z * (a2 - 1.0) + 1.0;
+            let pdf = a2 / (PI * q * q) * 0.25;
+            let sampleSolidAngle = 1.0 / (f32(count) * pdf + 1e-4);
+            let lod = clamp(0.5 * log2(sampleSolidAngle / texelSolidAngle) + 1.0, 0.0, maxLod);
+            color = color + textureSampleLevel(srcTexture, srcSampler, l, lod).rgb * nDotL;
+            weight = weight + nDotL;
+        }
+    }
+    textureStore(dstTexture, vec2<i32>(id.xy), i32(id.z), vec4<f32>(color / max(weight, 1e-4), 1.0));
+}
+"""
+
+        private const val SH_PROJECTION_WGSL = FACE_DIRECTION_WGSL + """
+@group(0) @binding(0) var srcTexture: texture_2d_array<f32>;
+@group(0) @binding(1) var<storage, read_write> partials: array<vec4<f32>>;
+
+var<workgroup> accum: array<array<vec3<f32>, 9>, 64>;
+
+fn shBasis(d: vec3<f32>) -> array<f32, 9> {
+    return array<f32, 9>(
+        0.282095,
+        0.488603 * d.y,
+        0.488603 * d.z,
+        0.488603 * d.x,
+        1.092548 * d.x * d.y,
+        1.092548 * d.y * d.z,
+        0.315392 * (3.0 * d.z * d.z - 1.0),
+        1.092548 * d.x * d.z,
+        0.546274 * (d.x * d.x - d.y * d.y)
+    );
+}
+
+// One workgroup per face: each thread strides over the face, then a tree reduction
+@compute @workgroup_size(64, 1, 1)
+fn main(@builtin(local_invocation_index) index: u32, @builtin(workgroup_id) group: vec3<u32>) {
+    let face = group.x;
+    let size = textureDimensions(srcTexture).x;
+    var sum: array<vec3<f32>, 9>;
+    for (var i = index; i < size * size; i = i + 64u) {
+        let texel = vec2<u32>(i % size, i / size);
+        let uv = (vec2<f32>(texel) + 0.5) / f32(size);
+        let p = uv * 2.0 - 1.0;
+        let solidAngle = 4.0 / (f32(size * size) * pow(1.0 + dot(p, p), 1.5));
+        let radiance = textureLoad(srcTexture, vec2<i32>(texel), i32(face), 0).rgb * solidAngle;
+        var basis = shBasis(faceDirection(face, uv));
+        for (var k = 0u; k < 9u; k = k + 1u) {
+            sum[k] = sum[k] + radiance * basis[k];
+        }
+    }
+    accum[index] = sum;
+    workgroupBarrier();
+
+    for (var stride = 32u; stride > 0u; stride = stride >> 1u) {
+        if (index < stride) {
+            for (var k = 0u; k < 9u; k = k + 1u) {
+                accum[index][k] = accum[index][k] + accum[index + stride][k];
+            }
+        }
+        workgroupBarrier();
+    }
+
+    if (index == 0u) {
+        for (var k = 0u; k < 9u; k = k + 1u) {
+            partials[face * 9u + k] = vec4<f32>(accum[0][k], 0.0);
+        }
+    }
+}
+"""
+
+        private const val BRDF_LUT_WGSL = "const PI: f32 = 3.14159265359;\n" + GGX_SAMPLING_WGSL + """
+const SAMPLE_COUNT: u32 = 512u;
+
+@group(0) @binding(0) var dstTexture: texture_storage_2d<rg32float, write>;
+
+fn geometrySchlickGgx(nDotX: f32, k: f32) -> f32 {
+    return nDotX / (nDotX * (1.0 - k) + k);
+}
+
+// x: N.V, y: roughness; scale and bias applied to F0
+@compute @workgroup_size(8, 8, 1)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let dims = textureDimensions(dstTexture);
+    if (id.x >= dims.x || id.y >= dims.y) {
+        return;
+    }
+    let nDotV = max((f32(id.x) + 0.5) / f32(dims.x), 1e-4);
+    let roughness = (f32(id.y) + 0.5) / f32(dims.y);
+    let alpha = roughness * roughness;
+    let k = alpha * 0.5;
+    let v = vec3<f32>(sqrt(1.0 - nDotV * nDotV), 0.0, nDotV);
+
+    var scale = 0.0;
+    var bias = 0.0;
+    for (var i = 0u; i < SAMPLE_COUNT; i = i + 1u) {
+        let h = importanceSampleGgx(hammersley(i, SAMPLE_COUNT), alpha);
+        let l = 2.0 * dot(v, h) * h - v;
+        if (l.z > 0.0) {
+            let vDotH = max(dot(v, h), 0.0);
+            let g = geometrySchlickGgx(nDotV, k) * geometrySchlickGgx(l.z, k);
+            let gVis = g * vDotH / max(h.z * nDotV, 1e-6);
+            let fc = pow(1.0 - vDotH, 5.0);
+            scale = scale + (1.0 - fc) * gVis;
+            bias = bias + fc * gVis;
+        }
+    }
+    textureStore(dstTexture, vec2<i32>(id.xy), vec4<f32>(scale / f32(SAMPLE_COUNT), bias / f32(SAMPLE_COUNT), 0.0, 0.0));
+}
+"""
+    }
+}
@@ -4,6 +4,8 @@ import io.materia.renderer.webgpu.RenderStatsTracker
 import io.materia.material.MeshBasicMaterial
 import io.materia.material.MeshStandardMaterial
 import io.materia.material.Material as EngineMaterial
+import io.materia.optimization.ResidencyManager
+import io.materia.profiling.MemoryAllocationType
 import io.materia.renderer.gpu.GpuBindGroup
 import io.materia.renderer.gpu.GpuBindGroupDescriptor
 import io.materia.renderer.gpu.GpuBindGroupEntry
@@ -30,8 +32,13 @@ import io.materia.renderer.gpu.unwrapHandle
 import io.materia.renderer.material.MaterialBindingSource
 import io.materia.renderer.material.MaterialBindingType
 import io.materia.renderer.material.MaterialDescriptor
+import io.materia.texture.CompressedTexture
+import io.materia.texture.CompressedTextureFormat
+import io.materia.texture.CompressedTextureMipmap
 import io.materia.texture.Texture
 import io.materia.texture.Texture2D
+import io.materia.texture.TextureRegion
+import org.khronos.webgl.Int8Array
 import org.khronos.webgl.Uint8Array
 
 internal data class MaterialTextureBinding(
@@ -39,9 +46,17 @@ internal data class MaterialTextureBinding(
     val layout: GpuBindGroupLayout
 )
 
+/**
+ * Uploads material textures and builds their bind groups.
+ *
+ * With a [residency] manager, uploaded textures count against its budget and are destroyed
+ * when it evicts them. Mipmapped compressed textures are then uploaded only from the level
+ * their on-screen size needs; finer levels are streamed in as the manager grants them.
+ */
 internal class WebGPUMaterialTextureManager(
     private val deviceProvider: () -> GpuDevice?,
-    private val statsTracker: RenderStatsTracker? = null
+    private val statsTracker: RenderStatsTracker? = null,
+    private val residency: ResidencyManager? = null
 ) {
 
     private data class CachedTexture(
@@ -72,6 +87,7 @@ internal class WebGPUMaterialTextureManager(
     private val layoutCache = mutableMapOf<LayoutKey, GpuBindGroupLayout>()
     private val bindGroupCache = mutableMapOf<BindGroupKey, MaterialTextureBinding>()
     private val textureCache = mutableMapOf<Int, CachedTexture>()
+    private val textureSources = mutableMapOf<Int, Texture>()
 
     private var fallbackAlbedo: CachedTexture? = null
     private var fallbackNormal: CachedTexture? = null
@@ -90,11 +106,16 @@ internal class WebGPUMaterialTextureManager(
             createFallbackTexture(device, byteArrayOf(127, 127, 255.toByte(), 255.toByte()))
     }
 
+    /**
+     * Returns the texture bind group for [material]. [screenSize] is the drawn object's
+     * approximate on-screen extent in pixels, used to pick the mip levels to keep resident.
+     */
     fun prepare(
         descriptor: MaterialDescriptor,
         material: EngineMaterial?,
         useAlbedo: Boolean,
-        useNormal: Boolean
+        useNormal: Boolean,
+        screenSize: Float = Float.POSITIVE_INFINITY
     ): MaterialTextureBinding? {
         if (!useAlbedo && !useNormal) return null
 
@@ -107,11 +128,11 @@ internal class WebGPUMaterialTextureManager(
         }
 
         val albedoTexture = if (useAlbedo) {
-            acquireTexture(device, albedoSource(material)) ?: fallbackAlbedo
+            acquireTexture(device, albedoSource(material), screenSize) ?: fallbackAlbedo
         } else fallbackAlbedo
 
         val normalTexture = if (useNormal) {
-            acquireTexture(device, normalSource(material)) ?: fallbackNormal
+            acquireTexture(device, normalSource(material), screenSize) ?: fallbackNormal
         } else fallbackNormal
 
         val albedoKey = albedoTexture?.let { it.gpuTexture.hashCode() }
@@ -178,6 +199,8 @@ internal class WebGPUMaterialTextureManager(
 
     fun dispose() {
         bindGroupCache.clear()
+        textureSources.values.forEach { residency?.unregister(it) }
+        textureSources.clear()
         textureCache.values.forEach { cached ->
             statsTracker?.recordTextureDisposed(cached.trackedBytes)
             runCatching { cached.gpuTexture.destroy() }
@@ -199,14 +222,14 @@ internal class WebGPUMaterialTextureManager(
         currentDevice = null
     }
 
-    private fun albedoSource(material: EngineMaterial?): Texture2D? = when (material) {
-        is MeshBasicMaterial -> material.map as? Texture2D
-        is MeshStandardMaterial -> material.map as? Texture2D
+    private fun albedoSource(material: EngineMaterial?): Texture? = when (material) {
+        is MeshBasicMaterial -> material.map
+        is MeshStandardMaterial -> material.map
         else -> null
     }
 
-    private fun normalSource(material: EngineMaterial?): Texture2D? = when (material) {
-        is MeshStandardMaterial -> material.normalMap as? Texture2D
+    private fun normalSource(material: EngineMaterial?): Texture? = when (material) {
+        is MeshStandardMaterial -> material.normalMap
         else -> null
     }
 
@@ -272,13 +295,50 @@ internal class WebGPUMaterialTextureManager(
         type: MaterialBindingType
     ) = bindings.firstOrNull { it.source == source && it.type == type }
 
-    private fun acquireTexture(device: GpuDevice, texture: Texture2D?): CachedTexture? {
-        texture ?: return null
+    private fun acquireTexture(device: GpuDevice, texture: Texture?, screenSize: Float): CachedTexture? =
+        when (texture) {
+            is Texture2D -> acquireTexture2D(device, texture)
+            is CompressedTexture -> acquireCompressedTexture(device, texture, screenSize)
+            else -> null
+        }
+
+    /** Destroys [cached] and drops the bind groups that reference it. */
+    private fun release(cached: CachedTexture) {
+        val id = cached.gpuTexture.hashCode()
+        bindGroupCache.keys.removeAll { it.albedoId == id || it.normalId == id }
+        statsTracker?.recordTextureDisposed(cached.trackedBytes)
+        runCatching { cached.gpuTexture.destroy() }
+    }
+
+    /** Evicted by [residency]: free the GPU copy; the next draw uploads it again. */
+    private fun evict(texture: Texture) {
+        textureSources.remove(texture.id)
+        textureCache.remove(texture.id)?.let(::release)
+    }
+
+    private fun acquireTexture2D(device: GpuDevice, texture: Texture2D): CachedTexture? {
         val width = texture.width
         val height = texture.height
         if (width <= 0 || height <= 0) return null
 
-        val data = texture.getData() ?: texture.getFloatData()?.let { floats ->
+        val cached = textureCache[texture.id]
+        if (cached != null && cached.width == width && cached.height == height) {
+            residency?.touch(texture)
+            if (cached.version == texture.version) return cached
+            // Only sub-rectangles changed (e.g. atlas inserts): copy just those
+            val bytes = texture.peekData()
+            if (bytes != null && !texture.needsFullUpload && texture.dirtyRegions.isNotEmpty()) {
+                texture.dirtyRegions.forEach { region ->
+                    writeTextureRegion(device, cached.gpuTexture, width, bytes, region)
+                }
+                texture.markUploaded()
+                cached.version = texture.version
+                texture.needsUpdate = false
+                return cached
+            }
+        }
+
+        val data = texture.peekData() ?: texture.getFloatData()?.let { floats ->
             ByteArray(floats.size) { idx ->
                 (floats[idx].coerceIn(0f, 1f) * 255f).toInt().coerceIn(0, 255).toByte()
             }
@@ -287,15 +347,7 @@ internal class WebGPUMaterialTextureManager(
         val bytesPerTexel = 4
         val totalBytes = width.toLong() * height * bytesPerTexel
 
-        val cached = textureCache[texture.id]
-        if (cached != null && cached.version == texture.version && cached.width == width && cached.height == height) {
-            return cached
-        }
-
-        cached?.let { previous ->
-            statsTracker?.recordTextureDisposed(previous.trackedBytes)
-            runCatching { previous.gpuTexture.destroy() }
-        }
+        cached?.let(::release)
 
         val gpuTexture = device.createTexture(
             GpuTextureDescriptor(
@@ -324,6 +376,105 @@ internal class WebGPUMaterialTextureManager(
         )
         textureCache[texture.id] = cachedTexture
         statsTracker?.recordTextureCreated(totalBytes)
+        if (residency != null) {
+            textureSources[texture.id] = texture
+            residency.register(texture, MemoryAllocationType.TEXTURE, totalBytes) { evict(texture) }
+        }
+        texture.markUploaded()
+        texture.needsUpdate = false
+        return cachedTexture
+    }
+
+    /**
+     * Uploads the mips of a block-compressed texture as-is. Returns null (so the fallback
+     * is bound) when the device lacks the format's compression feature.
+     *
+     * Without a residency manager every level is uploaded. With one, a new texture starts
+     * at the level [screenSize] needs and the manager's stream-in decisions move that base
+     * level, each move re-creating the GPU texture from the retained CPU levels.
+     */
+    private fun acquireCompressedTexture(
+        device: GpuDevice,
+        texture: CompressedTexture,
+        screenSize: Float
+    ): CachedTexture? {
+        val width = texture.width
+        val height = texture.height
+        val mipmaps = texture.compressedMipmaps.sortedBy { it.level }
+        if (width <= 0 || height <= 0 || mipmaps.isEmpty()) return null
+
+        val demandedLevel = ResidencyManager.mipForScreenSize(width, height, screenSize, screenSize, mipmaps.size)
+        val cached = textureCache[texture.id]
+        if (cached != null && cached.version == texture.version && cached.width == width && cached.height == height) {
+            if (residency == null || residency.touch(texture, demandedLevel)) return cached
+        }
+
+        val baseLevel = if (residency != null) demandedLevel else 0
+        val uploaded = uploadCompressed(device, texture, mipmaps, baseLevel) ?: return null
+        if (residency != null) {
+            textureSources[texture.id] = texture
+            residency.registerTexture(
+                texture,
+                LongArray(mipmaps.size) { mipmaps[it].data.size.toLong() },
+                baseLevel,
+                onResidentLevelChanged = { level -> restream(texture, level) },
+                onEvict = { evict(texture) }
+            )
+        }
+        return uploaded
+    }
+
+    /** Re-creates [texture] from [level] down after the residency manager moved its base level. */
+    private fun restream(texture: CompressedTexture, level: Int) {
+        val device = currentDevice ?: return
+        val mipmaps = texture.compressedMipmaps.sortedBy { it.level }
+        if (level !in mipmaps.indices) return
+        uploadCompressed(device, texture, mipmaps, level)
+    }
+
+    private fun uploadCompressed(
+        device: GpuDevice,
+        texture: CompressedTexture,
+        mipmaps: List<CompressedTextureMipmap>,
+        baseLevel: Int
+    ): CachedTexture? {
+        val block = compressedBlock(texture.compressedFormat) ?: return null
+        val rawDevice = device.unwrapHandle() as? GPUDevice ?: return null
+        if (rawDevice.features?.has(block.feature) != true) return null
+
+        textureCache[texture.id]?.let(::release)
+
+        val resident = mipmaps.subList(baseLevel, mipmaps.size)
+        val gpuTexture = device.createTexture(
+            GpuTextureDescriptor(
+                width = resident[0].width,
+                height = resident[0].height,
+                depthOrArrayLayers = 1,
+                mipLevelCount = resident.size,
+                sampleCount = 1,
+                dimension = GpuTextureDimension.D2,
+                format = block.format,
+                usage = GpuTextureUsage.TEXTURE_BINDING.bits or GpuTextureUsage.COPY_DST.bits,
+                label = texture.name.ifEmpty { "MaterialTexture${texture.id}" }
+            )
+        )
+        resident.forEachIndexed { level, mip ->
+            writeCompressedLevel(rawDevice, gpuTexture, level, mip.width, mip.height, mip.data, block)
+        }
+        val view =
+            gpuTexture.createView(GpuTextureViewDescriptor(dimension = GpuTextureViewDimension.D2))
+
+        val totalBytes = resident.sumOf { it.data.size.toLong() }
+        val cachedTexture = CachedTexture(
+            gpuTexture = gpuTexture,
+            view = view,
+            version = texture.version,
+            width = texture.width,
+            height = texture.height,
+            trackedBytes = totalBytes
+        )
+        textureCache[texture.id] = cachedTexture
+        statsTracker?.recordTextureCreated(totalBytes)
         texture.needsUpdate = false
         return cachedTexture
     }
@@ -393,5 +544,116 @@ internal class WebGPUMaterialTextureManager(
         }
         rawDevice.queue.writeTexture(destination, dataArray, layout, size)
     }
+
+    private fun writeTextureRegion(
+        device: GpuDevice,
+        texture: GpuTexture,
+        imageWidth: Int,
+        data: ByteArray,
+        region: TextureRegion
+    ) {
+        val rawDevice = device.unwrapHandle() as? GPUDevice ?: return
+        val rawTexture = texture.unwrapHandle() as? GPUTexture ?: return
+
+        val destination = js("({})")
+        destination.texture = rawTexture
+        destination.mipLevel = 0
+        val origin = js("({})")
+        origin.x = region.x
+        origin.y = region.y
+        origin.z = 0
+        destination.origin = origin
+
+        // Read the region straight out of the full image rows
+        val layout = js("({})")
+        layout.offset = (region.y * imageWidth + region.x) * 4
+        layout.bytesPerRow = imageWidth * 4
+        layout.rowsPerImage = region.height
+
+        val size = js("({})")
+        size.width = region.width
+        size.height = region.height
+        size.depthOrArrayLayers = 1
+
+        val source = data.unsafeCast<Int8Array>()
+        rawDevice.queue.writeTexture(destination, Uint8Array(source.buffer, source.byteOffset, source.length), layout, size)
+    }
+
+    private fun writeCompressedLevel(
+        rawDevice: GPUDevice,
+        texture: GpuTexture,
+        level: Int,
+        width: Int,
+        height: Int,
+        data: ByteArray,
+        block: CompressedBlock
+    ) {
+        val rawTexture = texture.unwrapHandle() as? GPUTexture ?: return
+        val blocksWide = (width + block.width - 1) / block.width
+        val blocksHigh = (height + block.height - 1) / block.height
+
+        val destination = js("({})")
+        destination.texture = rawTexture
+        destination.mipLevel = level
+
+        val layout = js("({})")
+        layout.offset = 0
+        layout.bytesPerRow = blocksWide * block.bytes
+        layout.rowsPerImage = blocksHigh
+
+        // Copy extents of compressed formats must cover whole blocks
+        val size = js("({})")
+        size.width = blocksWide * block.width
+        size.height = blocksHigh * block.height
+        size.depthOrArrayLayers = 1
+
+        val source = data.unsafeCast<Int8Array>()
+        val dataArray = Uint8Array(source.buffer, source.byteOffset, source.length)
+        rawDevice.queue.writeTexture(destination, dataArray, layout, size)
+    }
+
+    private data class CompressedBlock(
+        val format: String,
+        val feature: String,
+        val width: Int,
+        val height: Int,
+        val bytes: Int
+    )
+
+    private fun compressedBlock(format: CompressedTextureFormat): CompressedBlock? {
+        fun bc(name: String, bytes: Int) = CompressedBlock(name, "texture-compression-bc", 4, 4, bytes)
+        fun etc(name: String, bytes: Int) = CompressedBlock(name, "texture-compression-etc2", 4, 4, bytes)
+        fun astc(w: Int, h: Int) =
+            CompressedBlock("astc-${w}x$h-unorm", "texture-compression-astc", w, h, 16)
+        return when (format) {
+            CompressedTextureFormat.BC1_RGB, CompressedTextureFormat.BC1_RGBA -> bc("bc1-rgba-unorm", 8)
+            CompressedTextureFormat.BC2_RGBA -> bc("bc2-rgba-unorm", 16)
+            CompressedTextureFormat.BC3_RGBA -> bc("bc3-rgba-unorm", 16)
+            CompressedTextureFormat.BC4_R -> bc("bc4-r-unorm", 8)
+            CompressedTextureFormat.BC5_RG -> bc("bc5-rg-unorm", 16)
+            CompressedTextureFormat.BC6H_RGB -> bc("bc6h-rgb-ufloat", 16)
+            CompressedTextureFormat.BC7_RGBA -> bc("bc7-rgba-unorm", 16)
+            // ETC1 is a subset of ETC2 RGB8
+            CompressedTextureFormat.ETC1_RGB, CompressedTextureFormat.ETC2_RGB -> etc("etc2-rgb8unorm", 8)
+            CompressedTextureFormat.ETC2_RGB_A1 -> etc("etc2-rgb8a1unorm", 8)
+            CompressedTextureFormat.ETC2_RGBA -> etc("etc2-rgba8unorm", 16)
+            CompressedTextureFormat.ASTC_4x4 -> astc(4, 4)
+            CompressedTextureFormat.ASTC_5x4 -> astc(5, 4)
+            CompressedTextureFormat.ASTC_5x5 -> astc(5, 5)
+            CompressedTextureFormat.ASTC_6x5 -> astc(6, 5)
+            CompressedTextureFormat.ASTC_6x6 -> astc(6, 6)
+            CompressedTextureFormat.ASTC_8x5 -> astc(8, 5)
+            CompressedTextureFormat.ASTC_8x6 -> astc(8, 6)
+            CompressedTextureFormat.ASTC_8x8 -> astc(8, 8)
+            CompressedTextureFormat.ASTC_10x5 -> astc(10, 5)
+            CompressedTextureFormat.ASTC_10x6 -> astc(10, 6)
+            CompressedTextureFormat.ASTC_10x8 -> astc(10, 8)
+            CompressedTextureFormat.ASTC_10x10 -> astc(10, 10)
+            CompressedTextureFormat.ASTC_12x10 -> astc(12, 10)
+            CompressedTextureFormat.ASTC_12x12 -> astc(12, 12)
+            // WebGPU has no PVRTC formats
+            else -> null
+        }
+    }
 }
 
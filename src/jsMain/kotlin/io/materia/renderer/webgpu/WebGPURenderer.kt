@@ -6,21 +6,27 @@ import io.materia.camera.Camera
 import io.materia.camera.Viewport
 import io.materia.core.math.Color
 import io.materia.core.math.Matrix4
+import io.materia.core.math.Vector3
+import io.materia.core.math.getMaxScaleOnAxis
 import io.materia.core.scene.Mesh
 import io.materia.core.scene.Scene
+import io.materia.core.scene.SkinnedMesh
 import io.materia.lighting.ibl.IBLConvolutionProfiler
 import io.materia.lighting.ibl.PrefilterMipSelector
 import io.materia.material.MeshBasicMaterial
 import io.materia.material.MeshStandardMaterial
 import io.materia.optimization.Frustum
+import io.materia.optimization.ResidencyManager
 import io.materia.renderer.BackendType
 import io.materia.renderer.RenderStats
 import io.materia.renderer.Renderer
 import io.materia.renderer.RendererCapabilities
 import io.materia.renderer.RendererConfig
 import io.materia.renderer.Texture2D
+import io.materia.renderer.geometry.BonePalette
 import io.materia.renderer.geometry.GeometryAttribute
 import io.materia.renderer.geometry.GeometryMetadata
+import io.materia.renderer.geometry.MorphTargetBuffer
 import io.materia.renderer.geometry.buildGeometryOptions
 import io.materia.renderer.gpu.GpuBackend
 import io.materia.renderer.gpu.GpuBindGroupLayout
@@ -42,6 +48,7 @@ import io.materia.renderer.material.requiresBinding
 import io.materia.renderer.shader.MaterialShaderDescriptor
 import io.materia.renderer.shader.MaterialShaderGenerator
 import io.materia.renderer.shader.withOverrides
+import io.materia.texture.GpuEnvironmentPrefilter
 import org.w3c.dom.HTMLCanvasElement
 import io.materia.material.Material as EngineMaterial
 
@@ -55,11 +62,19 @@ import io.materia.material.Material as EngineMaterial
  * FR-009: Performance (60 FPS @ 1M triangles)
  * FR-011: Context loss recovery
  * FR-013: Pipeline caching
+ *
+ * Environments built with [io.materia.texture.PMREMGenerator.prefilter] are prefiltered
+ * with compute passes when first bound; see [io.materia.texture.GpuPrefilteredCubeTexture].
+ *
+ * @param residency Optional GPU memory budget for geometry and material textures; see
+ *   [ResidencyManager]. The renderer advances its frames.
  */
-class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
+class WebGPURenderer(
+    private val canvas: HTMLCanvasElement,
+    val residency: ResidencyManager? = null
+) : Renderer, GpuEnvironmentPrefilter {
 
     private companion object {
-        private const val MAX_MORPH_TARGETS = 8
     }
 
     private val statsTracker = RenderStatsTracker()
@@ -77,7 +92,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
     private val contextLossRecovery = ContextLossRecovery()
     private val environmentManager = WebGPUEnvironmentManager({ gpuContext?.device }, statsTracker)
     private val materialTextureManager =
-        WebGPUMaterialTextureManager({ gpuContext?.device }, statsTracker)
+        WebGPUMaterialTextureManager({ gpuContext?.device }, statsTracker, residency)
 
     // Feature 020 Managers (T020)
     private var bufferManager: WebGPUBufferManager? = null
@@ -93,9 +108,20 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
     private var drawIndexInFrame = 0
 
     // Geometry buffer cache (mesh.uuid -> buffers)
-    private val geometryCache = GeometryBufferCache({ gpuContext?.device }, statsTracker)
+    private val geometryCache = GeometryBufferCache({ gpuContext?.device }, statsTracker, residency)
     private val uniformManager = UniformBufferManager({ gpuContext?.device }, statsTracker)
 
+    // Skin matrices of every skinned mesh in the frame, uploaded once before drawing
+    private val bonePalette = BonePalette()
+
+    // Morph target deltas of every morphed geometry drawn so far, plus per-draw selection scratch
+    private val morphTargets = MorphTargetBuffer()
+    private val morphHeaders = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+    private val morphWeights = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+
+    // World-space bounding sphere centre scratch for projectedSize
+    private val projectedCenter = Vector3()
+
     // Pipeline cache map (for synchronous access)
     private val pipelineCacheMap = mutableMapOf<PipelineKey, WebGPUPipeline>()
 
@@ -128,6 +154,9 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
     override val stats: RenderStats
         get() = statsTracker.getStats()
 
+    override val supportsGpuPrefilter: Boolean
+        get() = capabilities.supportsCompute
+
     // Old Three.js-style properties removed - not part of Feature 020 Renderer interface
     // These will be restored in advanced features phase (Phase 2-13)
     var clearColor: Color = Color(0x0000FF) // Blue
@@ -327,6 +356,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
 
         uniformManager.dispose()
         geometryCache.clear()
+        morphTargets.clear()
         bufferManager = null
 
         if (depthTexture != null && depthTextureBytes > 0) {
@@ -368,6 +398,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
         }
 
         statsTracker.frameStart()
+        residency?.beginFrame()
         statsTracker.recordIBLConvolution(IBLConvolutionProfiler.snapshot())
         statsTracker.recordIBLMaterial(0f, 0)
 
@@ -383,7 +414,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
             drawIndexInFrame = 0  // T021 FIX: Reset draw index for new frame
 
             // T009: Create frustum for culling
-            scene.updateMatrixWorld(true)
+            scene.updateMatrixWorld()
 
             if (enableFrameLogging) console.log("T033: [Frame $frameCount] - Updating camera matrices...")
             camera.updateMatrixWorld()
@@ -450,6 +481,19 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
             val lightingUniforms = collectSceneLightingUniforms(scene)
             val environmentBinding = environmentManager.prepare(scene.environment, sceneBrdf)
 
+            bonePalette.reset()
+            scene.traverse { obj ->
+                if (obj is SkinnedMesh && obj.visible) {
+                    obj.pose()
+                    bonePalette.add(obj)
+                }
+                if (obj is Mesh && obj.visible && obj.geometry.morphAttributes.isNotEmpty()) {
+                    morphTargets.add(obj.geometry)
+                }
+            }
+            uniformManager.uploadBonePalette(bonePalette)
+            uniformManager.uploadMorphTargets(morphTargets)
+
             if (enableFrameLogging) console.log("T033: [Frame $frameCount] - Traversing scene graph and rendering meshes...")
             scene.traverse { obj ->
                 if (obj is Mesh) {
@@ -496,10 +540,28 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
             console.error("T033: ERROR during rendering frame $frameCount: ${e.message}")
             console.error("T033: Stack trace: ${e.stackTraceToString()}")
         } finally {
+            residency?.endFrame()
             statsTracker.frameEnd()
         }
     }
 
+    /**
+     * Approximate on-screen diameter of [mesh] in pixels, from its world bounding sphere;
+     * drives which texture mips stay resident.
+     */
+    private fun projectedSize(mesh: Mesh, camera: Camera): Float {
+        val sphere = mesh.geometry.computeBoundingSphere()
+        val center = projectedCenter.copy(sphere.center).applyMatrix4(mesh.matrixWorld)
+        val radius = sphere.radius * mesh.matrixWorld.getMaxScaleOnAxis()
+        if (radius <= 0f) return 0f
+        val projection = camera.projectionMatrix.elements
+        val pixelsPerUnit = projection[5] * canvas.height
+        // A perspective projection has no constant term in w
+        if (projection[15] != 0f) return radius * pixelsPerUnit
+        val distance = center.distanceTo(camera.position)
+        return if (distance <= radius) Float.POSITIVE_INFINITY else radius * pixelsPerUnit / distance
+    }
+
     private fun renderMesh(
         mesh: Mesh,
         camera: Camera,
@@ -615,7 +677,8 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
                     descriptor = descriptor,
                     material = material as? EngineMaterial,
                     useAlbedo = materialOverrides.usesAlbedoMap,
-                    useNormal = materialOverrides.usesNormalMap
+                    useNormal = materialOverrides.usesNormalMap,
+                    screenSize = if (residency != null) projectedSize(mesh, camera) else Float.POSITIVE_INFINITY
                 )
             } else null
 
@@ -636,6 +699,17 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
             return
         }
 
+        val firstBone = if (buffers.metadata.isSkinned && mesh is SkinnedMesh) bonePalette.offsetOf(mesh) else -1
+        val boneCount = if (firstBone >= 0) (mesh as SkinnedMesh).skeleton?.bones?.size ?: 0 else 0
+        val morphCount = if (buffers.metadata.hasMorphTargets) {
+            @Suppress("UNCHECKED_CAST")
+            val influences = mesh.morphTargetInfluences
+                ?: (mesh.userData["morphTargetInfluences"] as? List<Float>)
+            morphTargets.selectActive(mesh.geometry, influences, morphHeaders, morphWeights)
+        } else {
+            0
+        }
+
         val frameInfo = FrameDebugInfo(frameCount, drawCallCount)
         if (!uniformManager.updateUniforms(
                 mesh,
@@ -643,7 +717,12 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
                 drawIndexInFrame,
                 frameInfo,
                 enableFrameLogging,
-                materialUniforms
+                materialUniforms,
+                firstBone = maxOf(firstBone, 0),
+                boneCount = boneCount,
+                morphHeaders = morphHeaders,
+                morphWeights = morphWeights,
+                morphCount = morphCount
             )
         ) {
             return
@@ -727,6 +806,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
         materialKey: String,
         metadata: GeometryMetadata
     ): Map<String, String> {
+        val vertexBindings = StringBuilder()
         val vertexInputExtra = StringBuilder()
         val vertexOutputExtra = StringBuilder()
         val vertexAssignExtra = StringBuilder()
@@ -761,51 +841,57 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
             }
         }
 
-        val morphPositionBindings = metadata.bindings
-            .filter { it.attribute == GeometryAttribute.MORPH_POSITION }
-            .sortedBy { it.location }
-        val morphNormalBindings = metadata.bindings
-            .filter { it.attribute == GeometryAttribute.MORPH_NORMAL }
-            .sortedBy { it.location }
-        val morphCount = morphPositionBindings.size.coerceAtMost(MAX_MORPH_TARGETS)
-
-        if (morphCount > 0) {
-            val positionNames = mutableListOf<String>()
-            val normalNames = mutableListOf<String>()
-            morphPositionBindings.take(morphCount).forEachIndexed { index, binding ->
-                val name = "morphPosition$index"
-                vertexInputExtra.appendLine("    @location(${binding.location}) $name: vec3<f32>,")
-                positionNames += name
-            }
-            morphNormalBindings.take(morphCount).forEachIndexed { index, binding ->
-                val name = "morphNormal$index"
-                vertexInputExtra.appendLine("    @location(${binding.location}) $name: vec3<f32>,")
-                normalNames += name
-            }
+        // Sparse morph deltas come from the morph target storage buffer (see MorphTargetBuffer);
+        // only the active targets chosen for this draw are looped over
+        if (metadata.hasMorphTargets) {
+            vertexBindings.appendLine("@group(0) @binding(2) var<storage, read> morphTargets: array<u32>;")
+            vertexInputExtra.appendLine("    @builtin(vertex_index) vertexIndex: u32,")
+            vertexAssignExtra.appendLine("    let morphCount = u32(uniforms.morphParams.x);")
+            vertexAssignExtra.appendLine("    for (var m = 0u; m < morphCount; m = m + 1u) {")
+            vertexAssignExtra.appendLine("        var weight = uniforms.morphInfluences0[m & 3u];")
+            vertexAssignExtra.appendLine("        var header = u32(uniforms.morphTargets0[m & 3u]);")
+            vertexAssignExtra.appendLine("        if (m >= 4u) {")
+            vertexAssignExtra.appendLine("            weight = uniforms.morphInfluences1[m & 3u];")
+            vertexAssignExtra.appendLine("            header = u32(uniforms.morphTargets1[m & 3u]);")
+            vertexAssignExtra.appendLine("        }")
+            vertexAssignExtra.appendLine("        let firstVertex = morphTargets[header];")
+            vertexAssignExtra.appendLine("        if (in.vertexIndex < firstVertex || in.vertexIndex >= firstVertex + morphTargets[header + 1u]) {")
+            vertexAssignExtra.appendLine("            continue;")
+            vertexAssignExtra.appendLine("        }")
+            vertexAssignExtra.appendLine("        let hasNormals = (morphTargets[header + 2u] & ${MorphTargetBuffer.FLAG_NORMALS}u) != 0u;")
+            vertexAssignExtra.appendLine("        let stride = select(2u, 4u, hasNormals);")
+            vertexAssignExtra.appendLine("        let at = header + ${MorphTargetBuffer.HEADER_WORDS}u + (in.vertexIndex - firstVertex) * stride;")
+            vertexAssignExtra.appendLine("        let dxy = unpack2x16float(morphTargets[at]);")
+            vertexAssignExtra.appendLine("        position = position + vec3<f32>(dxy, unpack2x16float(morphTargets[at + 1u]).x) * weight;")
+            vertexAssignExtra.appendLine("        if (hasNormals) {")
+            vertexAssignExtra.appendLine("            let nxy = unpack2x16float(morphTargets[at + 2u]);")
+            vertexAssignExtra.appendLine("            normal = normal + vec3<f32>(nxy, unpack2x16float(morphTargets[at + 3u]).x) * weight;")
+            vertexAssignExtra.appendLine("        }")
+            vertexAssignExtra.appendLine("    }")
+            vertexAssignExtra.appendLine("    normal = normalize(normal);")
+        }
 
-            vertexAssignExtra.appendLine("    var blendedPosition = position;")
-            if (normalNames.isNotEmpty()) {
-                vertexAssignExtra.appendLine("    var blendedNormal = normal;")
-            } else {
-                vertexAssignExtra.appendLine("    var blendedNormal = normal;")
-            }
-            val components = arrayOf("x", "y", "z", "w")
-            repeat(morphCount) { index ->
-                val source =
-                    if (index < 4) "uniforms.morphInfluences0" else "uniforms.morphInfluences1"
-                val comp = components[index % 4]
-                val weightName = "morphWeight$index"
-                vertexAssignExtra.appendLine("    let $weightName = $source.$comp;")
-                vertexAssignExtra.appendLine("    blendedPosition = blendedPosition + ${positionNames[index]} * $weightName;")
-                normalNames.getOrNull(index)?.let { normalAttr ->
-                    vertexAssignExtra.appendLine("    blendedNormal = blendedNormal + $normalAttr * $weightName;")
-                }
-            }
-            vertexAssignExtra.appendLine("    position = blendedPosition;")
-            vertexAssignExtra.appendLine("    normal = normalize(blendedNormal);")
+        // Skinning runs after morphing, on the morphed bind-pose vertex
+        val skinIndexBinding = metadata.bindingFor(GeometryAttribute.SKIN_INDEX)
+        val skinWeightBinding = metadata.bindingFor(GeometryAttribute.SKIN_WEIGHT)
+        if (skinIndexBinding != null && skinWeightBinding != null) {
+            vertexBindings.appendLine("@group(0) @binding(1) var<storage, read> bonePalette: array<mat4x4<f32>>;")
+            vertexInputExtra.appendLine("    @location(${skinIndexBinding.location}) skinIndex: vec4<f32>,")
+            vertexInputExtra.appendLine("    @location(${skinWeightBinding.location}) skinWeight: vec4<f32>,")
+            vertexAssignExtra.appendLine("    if (uniforms.skinningParams.y > 0.0) {")
+            vertexAssignExtra.appendLine("        let firstBone = u32(uniforms.skinningParams.x);")
+            vertexAssignExtra.appendLine("        let skinMatrix =")
+            vertexAssignExtra.appendLine("            bonePalette[firstBone + u32(in.skinIndex.x)] * in.skinWeight.x +")
+            vertexAssignExtra.appendLine("            bonePalette[firstBone + u32(in.skinIndex.y)] * in.skinWeight.y +")
+            vertexAssignExtra.appendLine("            bonePalette[firstBone + u32(in.skinIndex.z)] * in.skinWeight.z +")
+            vertexAssignExtra.appendLine("            bonePalette[firstBone + u32(in.skinIndex.w)] * in.skinWeight.w;")
+            vertexAssignExtra.appendLine("        position = (skinMatrix * vec4<f32>(position, 1.0)).xyz;")
+            vertexAssignExtra.appendLine("        normal = normalize((skinMatrix * vec4<f32>(normal, 0.0)).xyz);")
+            vertexAssignExtra.appendLine("    }")
         }
 
         return mapOf(
+            "VERTEX_BINDINGS" to vertexBindings.toString(),
             "VERTEX_INPUT_EXTRA" to vertexInputExtra.toString(),
             "VERTEX_OUTPUT_EXTRA" to vertexOutputExtra.toString(),
             "VERTEX_ASSIGN_EXTRA" to vertexAssignExtra.toString(),
@@ -923,6 +1009,7 @@ class WebGPURenderer(private val canvas: HTMLCanvasElement) : Renderer {
 
     private fun mergeShaderOverrides(vararg overrideMaps: Map<String, String>): Map<String, String> {
         val concatKeys = setOf(
+            "VERTEX_BINDINGS",
             "VERTEX_INPUT_EXTRA",
             "VERTEX_OUTPUT_EXTRA",
             "VERTEX_ASSIGN_EXTRA",
@@ -88,6 +88,7 @@ external interface GPUDevice {
     fun createBindGroup(descriptor: GPUBindGroupDescriptor): GPUBindGroup
     fun createShaderModule(descriptor: GPUShaderModuleDescriptor): GPUShaderModule
     fun createRenderPipeline(descriptor: GPURenderPipelineDescriptor): GPURenderPipeline
+    fun createComputePipeline(descriptor: GPUComputePipelineDescriptor): GPUComputePipeline
     fun createCommandEncoder(descriptor: GPUCommandEncoderDescriptor = definedExternally): GPUCommandEncoder
 }
 
@@ -389,6 +390,23 @@ external interface GPUBlendComponent {
 
 external interface GPURenderPipeline
 
+external interface GPUComputePipelineDescriptor {
+    var label: String?
+        get() = definedExternally
+        set(value) = definedExternally
+    var layout: dynamic /* GPUPipelineLayout | "auto" */
+    var compute: GPUProgrammableStage
+}
+
+external interface GPUProgrammableStage {
+    var module: GPUShaderModule
+    var entryPoint: String
+}
+
+external interface GPUComputePipeline {
+    fun getBindGroupLayout(index: Int): GPUBindGroupLayout
+}
+
 external interface GPUPipelineLayoutDescriptor {
     var label: String?
         get() = definedExternally
@@ -505,6 +523,15 @@ external interface GPUCommandEncoderDescriptor {
 
 external interface GPUCommandEncoder {
     fun beginRenderPass(descriptor: GPURenderPassDescriptor): GPURenderPassEncoder
+    fun beginComputePass(descriptor: GPUComputePassDescriptor = definedExternally): GPUComputePassEncoder
+    fun copyBufferToBuffer(
+        source: GPUBuffer,
+        sourceOffset: Int,
+        destination: GPUBuffer,
+        destinationOffset: Int,
+        size: Int
+    )
+
     fun finish(descriptor: GPUCommandBufferDescriptor = definedExternally): GPUCommandBuffer
 }
 
@@ -604,6 +631,32 @@ external interface GPURenderPassEncoder {
     fun end()
 }
 
+external interface GPUComputePassDescriptor {
+    var label: String?
+        get() = definedExternally
+        set(value) = definedExternally
+    var timestampWrites: dynamic
+        get() = definedExternally
+        set(value) = definedExternally
+}
+
+external interface GPUComputePassEncoder {
+    fun setPipeline(pipeline: GPUComputePipeline)
+    fun setBindGroup(
+        index: Int,
+        bindGroup: GPUBindGroup?,
+        dynamicOffsets: IntArray = definedExternally
+    )
+
+    fun dispatchWorkgroups(
+        workgroupCountX: Int,
+        workgroupCountY: Int = definedExternally,
+        workgroupCountZ: Int = definedExternally
+    )
+
+    fun end()
+}
+
 external interface GPUCommandBufferDescriptor {
     var label: String?
         get() = definedExternally
@@ -627,6 +680,7 @@ external interface GPUQueue {
     )
 
     fun writeTexture(destination: dynamic, data: dynamic, dataLayout: dynamic, size: dynamic)
+    fun onSubmittedWorkDone(): dynamic /* Promise<void> */
 }
 
 // ============================================================================
@@ -0,0 +1,6 @@
+package io.materia.loader
+
+// Follow-up: no Basis transcoder ships for this platform yet; it needs basisu's native
+// transcoder (JNI). Until then pass a BasisTranscoder to KTX2Loader to load ETC1S/UASTC
+// textures. KTX2 files already in BC, ETC2 or ASTC vkFormats load without one.
+internal actual fun createDefaultBasisTranscoder(): BasisTranscoder? = null
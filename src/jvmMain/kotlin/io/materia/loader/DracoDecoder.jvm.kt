@@ -0,0 +1,6 @@
+package io.materia.loader
+
+// Follow-up: no Draco decoder ships for this platform yet; it needs the reference decoder
+// behind JNI. Until then pass a DracoDecoder to GLTFLoader or DRACOLoader. GLTFLoader
+// falls back to a primitive's uncompressed accessors when the asset keeps them.
+internal actual fun createDefaultDracoDecoder(): DracoDecoder? = null
@@ -11,6 +11,7 @@ import org.lwjgl.vulkan.VK10.VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
 import org.lwjgl.vulkan.VK10.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
 import org.lwjgl.vulkan.VK10.VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
 import org.lwjgl.vulkan.VK10.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+import org.lwjgl.vulkan.VK10.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
 import org.lwjgl.vulkan.VK10.VK_MAKE_VERSION
 import org.lwjgl.vulkan.VK10.VK_PHYSICAL_DEVICE_TYPE_CPU
 import org.lwjgl.vulkan.VK10.VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU
@@ -413,10 +414,13 @@ internal object VulkanBootstrap {
 
     private fun createDescriptorPool(device: VkDevice): Long =
         MemoryStack.stackPush().use { stack ->
-            val poolSizes = VkDescriptorPoolSize.calloc(3, stack)
+            val poolSizes = VkDescriptorPoolSize.calloc(4, stack)
             poolSizes[0]
                 .type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
                 .descriptorCount(64)
+            poolSizes[3]
+                .type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+                .descriptorCount(16)
             poolSizes[1]
                 .type(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
                 .descriptorCount(64)
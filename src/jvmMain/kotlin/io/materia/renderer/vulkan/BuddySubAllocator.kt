@@ -0,0 +1,132 @@
+/**
+ * Buddy sub-allocator for offsets inside one VkDeviceMemory block.
+ *
+ * The allocator only manages offsets; it never touches Vulkan. Blocks are split in
+ * halves down to [minBlockSize] and coalesced with their buddy on free, so every
+ * returned offset is naturally aligned to its (power-of-two) block size.
+ */
+
+package io.materia.renderer.vulkan
+
+/**
+ * Power-of-two buddy allocator over `[0, capacity)`.
+ *
+ * @property capacity Managed range in bytes (power of two)
+ * @property minBlockSize Smallest block handed out (power of two)
+ */
+internal class BuddySubAllocator(
+    val capacity: Long,
+    val minBlockSize: Long = DEFAULT_MIN_BLOCK_SIZE
+) {
+    init {
+        require(isPowerOfTwo(capacity)) { "capacity must be a power of two, got $capacity" }
+        require(isPowerOfTwo(minBlockSize)) { "minBlockSize must be a power of two, got $minBlockSize" }
+        require(capacity >= minBlockSize) { "capacity ($capacity) must be >= minBlockSize ($minBlockSize)" }
+    }
+
+    private val maxOrder: Int = log2(capacity / minBlockSize)
+
+    // freeBlocks[k] holds offsets of free blocks of size minBlockSize shl k
+    private val freeBlocks = Array(maxOrder + 1) { HashSet<Long>() }
+    private val allocatedOrders = HashMap<Long, Int>()
+
+    /** Bytes covered by live blocks (including internal rounding). */
+    var usedBytes: Long = 0L
+        private set
+
+    val freeBytes: Long
+        get() = capacity - usedBytes
+
+    val allocationCount: Int
+        get() = allocatedOrders.size
+
+    init {
+        freeBlocks[maxOrder].add(0L)
+    }
+
+    fun isEmpty(): Boolean = allocatedOrders.isEmpty()
+
+    /**
+     * Reserve [size] bytes aligned to [alignment].
+     *
+     * @return offset of the block, or -1 if no block large enough is free
+     */
+    fun allocate(size: Long, alignment: Long = 1L): Long {
+        require(size > 0) { "size must be > 0, got $size" }
+        require(alignment > 0 && isPowerOfTwo(alignment)) { "alignment must be a power of two, got $alignment" }
+
+        val needed = nextPowerOfTwo(maxOf(size, alignment, minBlockSize))
+        if (needed > capacity) return -1L
+        val order = log2(needed / minBlockSize)
+
+        var k = order
+        while (k <= maxOrder && freeBlocks[k].isEmpty()) {
+            k++
+        }
+        if (k > maxOrder) return -1L
+
+        val offset = freeBlocks[k].first()
+        freeBlocks[k].remove(offset)
+        while (k > order) {
+            k--
+            freeBlocks[k].add(offset + blockSize(k))
+        }
+
+        allocatedOrders[offset] = order
+        usedBytes += blockSize(order)
+        return offset
+    }
+
+    /**
+     * Release the block starting at [offset] and merge it with free buddies.
+     *
+     * @throws IllegalArgumentException if [offset] is not a live allocation
+     */
+    fun free(offset: Long) {
+        val order = allocatedOrders.remove(offset)
+            ?: throw IllegalArgumentException("No allocation at offset $offset")
+        usedBytes -= blockSize(order)
+
+        var k = order
+        var blockOffset = offset
+        while (k < maxOrder) {
+            val buddy = blockOffset xor blockSize(k)
+            if (!freeBlocks[k].remove(buddy)) break
+            blockOffset = minOf(blockOffset, buddy)
+            k++
+        }
+        freeBlocks[k].add(blockOffset)
+    }
+
+    fun largestFreeBlock(): Long {
+        for (k in maxOrder downTo 0) {
+            if (freeBlocks[k].isNotEmpty()) return blockSize(k)
+        }
+        return 0L
+    }
+
+    /**
+     * External fragmentation in `[0, 1]`: 0 when all free space is one block.
+     */
+    fun fragmentation(): Float {
+        val free = freeBytes
+        if (free == 0L) return 0f
+        return 1f - largestFreeBlock().toFloat() / free.toFloat()
+    }
+
+    private fun blockSize(order: Int): Long = minBlockSize shl order
+
+    companion object {
+        const val DEFAULT_MIN_BLOCK_SIZE = 256L
+
+        fun isPowerOfTwo(value: Long): Boolean = value > 0 && (value and (value - 1)) == 0L
+
+        fun nextPowerOfTwo(value: Long): Long {
+            require(value > 0) { "value must be > 0, got $value" }
+            val highest = java.lang.Long.highestOneBit(value)
+            return if (highest == value) value else highest shl 1
+        }
+
+        private fun log2(value: Long): Int = 63 - java.lang.Long.numberOfLeadingZeros(value)
+    }
+}
@@ -9,36 +9,54 @@ package io.materia.renderer.vulkan
 
 import io.materia.renderer.feature020.*
 import org.lwjgl.system.MemoryStack
+import org.lwjgl.system.MemoryUtil
 import org.lwjgl.vulkan.*
 import org.lwjgl.vulkan.VK12.*
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * Vulkan buffer manager implementation.
  *
- * Manages GPU buffer lifecycle using VkBuffer and VkDeviceMemory.
- * Uses manual memory allocation with HOST_VISIBLE | HOST_COHERENT properties.
+ * Manages GPU buffer lifecycle using VkBuffer objects sub-allocated from pooled
+ * VkDeviceMemory blocks ([VulkanMemoryAllocator]). When a command pool and queue
+ * are provided, vertex and index data live in device-local memory and are uploaded
+ * through a persistent [VulkanStagingRing]; otherwise geometry falls back to
+ * host-visible memory. Uniform buffers come from a separate persistently mapped pool.
  *
  * @property device Vulkan logical device
  * @property physicalDevice Vulkan physical device (for memory type queries)
  */
 class VulkanBufferManager(
     private val device: VkDevice,
-    private val physicalDevice: VkPhysicalDevice
+    private val physicalDevice: VkPhysicalDevice,
+    commandPool: Long = VK_NULL_HANDLE,
+    queue: VkQueue? = null
 ) : BufferManager {
 
     // Track destroyed buffers to prevent double-free
     private val destroyedBuffers = mutableSetOf<Long>()
 
+    private val allocator = VulkanMemoryAllocator(device, physicalDevice)
+    private val stagingRing: VulkanStagingRing? =
+        if (commandPool != VK_NULL_HANDLE && queue != null) {
+            VulkanStagingRing(device, allocator, commandPool, queue)
+        } else {
+            null
+        }
+
+    /**
+     * Current pooled memory usage across all buffers created by this manager.
+     */
+    fun memoryStats(): VulkanMemoryStats = allocator.stats()
+
     /**
      * Create vertex buffer from float array.
      *
      * Process:
-     * 1. Create VkBuffer with VERTEX_BUFFER_BIT usage
-     * 2. Query memory requirements
-     * 3. Find HOST_VISIBLE | HOST_COHERENT memory type
-     * 4. Allocate VkDeviceMemory
-     * 5. Bind buffer to memory
-     * 6. Map memory, copy data, unmap
+     * 1. Create VkBuffer with VERTEX_BUFFER_BIT (+ TRANSFER_DST when staged)
+     * 2. Sub-allocate memory from the static geometry pool and bind at its offset
+     * 3. Upload through the staging ring (or write the host-visible mapping directly)
      *
      * @param data Vertex data (interleaved attributes, any stride)
      * @return Buffer handle with VkBuffer
@@ -51,70 +69,16 @@ class VulkanBufferManager(
         }
 
         val sizeBytes = data.size * Float.SIZE_BYTES
-        // println("VulkanBufferManager: Creating vertex buffer size=$sizeBytes")
 
         return try {
-            MemoryStack.stackPush().use { stack ->
-                // 1. Create VkBuffer
-                val bufferInfo = VkBufferCreateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
-                    .size(sizeBytes.toLong())
-                    .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-                    .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
-
-                val pBuffer = stack.mallocLong(1)
-                val result = vkCreateBuffer(device, bufferInfo, null, pBuffer)
-                if (result != VK_SUCCESS) {
-                    throw OutOfMemoryException("Failed to create vertex buffer: VkResult=$result")
-                }
-                val buffer = pBuffer.get(0)
-
-                // 2. Query memory requirements
-                val memRequirements = VkMemoryRequirements.malloc(stack)
-                vkGetBufferMemoryRequirements(device, buffer, memRequirements)
-
-                // 3. Find memory type (HOST_VISIBLE | HOST_COHERENT)
-                val memoryTypeIndex = findMemoryType(
-                    memRequirements.memoryTypeBits(),
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                )
-
-                // 4. Allocate memory
-                val allocInfo = VkMemoryAllocateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
-                    .allocationSize(memRequirements.size())
-                    .memoryTypeIndex(memoryTypeIndex)
-
-                val pMemory = stack.mallocLong(1)
-                val allocResult = vkAllocateMemory(device, allocInfo, null, pMemory)
-                if (allocResult != VK_SUCCESS) {
-                    vkDestroyBuffer(device, buffer, null)
-                    throw OutOfMemoryException("Failed to allocate vertex buffer memory: VkResult=$allocResult")
-                }
-                val memory = pMemory.get(0)
-
-                // 5. Bind buffer to memory
-                vkBindBufferMemory(device, buffer, memory, 0)
-
-                // 6. Map memory, copy data, unmap
-                val ppData = stack.mallocPointer(1)
-                val mapResult = vkMapMemory(device, memory, 0, sizeBytes.toLong(), 0, ppData)
-                if (mapResult != VK_SUCCESS) {
-                     vkFreeMemory(device, memory, null)
-                     vkDestroyBuffer(device, buffer, null)
-                     throw OutOfMemoryException("Failed to map memory: VkResult=$mapResult")
-                }
-                
-                val mappedData = ppData.getByteBuffer(0, sizeBytes)
-                mappedData.asFloatBuffer().put(data)
-                vkUnmapMemory(device, memory)
-
-                // Return handle with both VkBuffer and VkDeviceMemory
-                BufferHandle(
-                    handle = VulkanBufferHandleData(buffer, memory),
-                    size = sizeBytes,
-                    usage = BufferUsage.VERTEX
-                )
+            createGeometryBuffer(
+                sizeBytes = sizeBytes,
+                usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                bufferUsage = BufferUsage.VERTEX,
+                dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+            ) { target, sourceOffset ->
+                target.order(ByteOrder.nativeOrder()).asFloatBuffer()
+                    .put(data, sourceOffset / Float.SIZE_BYTES, target.remaining() / Float.SIZE_BYTES)
             }
         } catch (e: OutOfMemoryException) {
             throw e
@@ -144,60 +108,14 @@ class VulkanBufferManager(
         val sizeBytes = data.size * Int.SIZE_BYTES
 
         return try {
-            MemoryStack.stackPush().use { stack ->
-                // Create VkBuffer with INDEX_BUFFER_BIT
-                val bufferInfo = VkBufferCreateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
-                    .size(sizeBytes.toLong())
-                    .usage(VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
-                    .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
-
-                val pBuffer = stack.mallocLong(1)
-                val result = vkCreateBuffer(device, bufferInfo, null, pBuffer)
-                if (result != VK_SUCCESS) {
-                    throw OutOfMemoryException("Failed to create index buffer: VkResult=$result")
-                }
-                val buffer = pBuffer.get(0)
-
-                // Query memory requirements
-                val memRequirements = VkMemoryRequirements.malloc(stack)
-                vkGetBufferMemoryRequirements(device, buffer, memRequirements)
-
-                // Find memory type
-                val memoryTypeIndex = findMemoryType(
-                    memRequirements.memoryTypeBits(),
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                )
-
-                // Allocate memory
-                val allocInfo = VkMemoryAllocateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
-                    .allocationSize(memRequirements.size())
-                    .memoryTypeIndex(memoryTypeIndex)
-
-                val pMemory = stack.mallocLong(1)
-                val allocResult = vkAllocateMemory(device, allocInfo, null, pMemory)
-                if (allocResult != VK_SUCCESS) {
-                    vkDestroyBuffer(device, buffer, null)
-                    throw OutOfMemoryException("Failed to allocate index buffer memory: VkResult=$allocResult")
-                }
-                val memory = pMemory.get(0)
-
-                // Bind buffer to memory
-                vkBindBufferMemory(device, buffer, memory, 0)
-
-                // Map memory, copy data, unmap
-                val ppData = stack.mallocPointer(1)
-                vkMapMemory(device, memory, 0, sizeBytes.toLong(), 0, ppData)
-                val mappedData = ppData.getByteBuffer(0, sizeBytes)
-                mappedData.asIntBuffer().put(data)
-                vkUnmapMemory(device, memory)
-
-                BufferHandle(
-                    handle = VulkanBufferHandleData(buffer, memory),
-                    size = sizeBytes,
-                    usage = BufferUsage.INDEX
-                )
+            createGeometryBuffer(
+                sizeBytes = sizeBytes,
+                usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                bufferUsage = BufferUsage.INDEX,
+                dstAccessMask = VK_ACCESS_INDEX_READ_BIT
+            ) { target, sourceOffset ->
+                target.order(ByteOrder.nativeOrder()).asIntBuffer()
+                    .put(data, sourceOffset / Int.SIZE_BYTES, target.remaining() / Int.SIZE_BYTES)
             }
         } catch (e: OutOfMemoryException) {
             throw e
@@ -209,6 +127,9 @@ class VulkanBufferManager(
     /**
      * Create uniform buffer with fixed size.
      *
+     * The buffer is sub-allocated from the persistently mapped uniform pool; use
+     * [mappedBuffer] for direct writes or [updateUniformBuffer] for copies.
+     *
      * @param sizeBytes Buffer size in bytes (minimum 64 for mat4x4)
      * @return Buffer handle with VkBuffer
      * @throws IllegalArgumentException if sizeBytes < 64
@@ -221,54 +142,16 @@ class VulkanBufferManager(
         }
 
         return try {
-            MemoryStack.stackPush().use { stack ->
-                // Create VkBuffer with UNIFORM_BUFFER_BIT
-                val bufferInfo = VkBufferCreateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
-                    .size(sizeBytes.toLong())
-                    .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-                    .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
-
-                val pBuffer = stack.mallocLong(1)
-                val result = vkCreateBuffer(device, bufferInfo, null, pBuffer)
-                if (result != VK_SUCCESS) {
-                    throw OutOfMemoryException("Failed to create uniform buffer: VkResult=$result")
-                }
-                val buffer = pBuffer.get(0)
-
-                // Query memory requirements
-                val memRequirements = VkMemoryRequirements.malloc(stack)
-                vkGetBufferMemoryRequirements(device, buffer, memRequirements)
-
-                // Find memory type
-                val memoryTypeIndex = findMemoryType(
-                    memRequirements.memoryTypeBits(),
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                )
-
-                // Allocate memory
-                val allocInfo = VkMemoryAllocateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
-                    .allocationSize(memRequirements.size())
-                    .memoryTypeIndex(memoryTypeIndex)
-
-                val pMemory = stack.mallocLong(1)
-                val allocResult = vkAllocateMemory(device, allocInfo, null, pMemory)
-                if (allocResult != VK_SUCCESS) {
-                    vkDestroyBuffer(device, buffer, null)
-                    throw OutOfMemoryException("Failed to allocate uniform buffer memory: VkResult=$allocResult")
-                }
-                val memory = pMemory.get(0)
-
-                // Bind buffer to memory
-                vkBindBufferMemory(device, buffer, memory, 0)
-
-                BufferHandle(
-                    handle = VulkanBufferHandleData(buffer, memory),
-                    size = sizeBytes,
-                    usage = BufferUsage.UNIFORM
-                )
-            }
+            val (buffer, allocation) = createBoundBuffer(
+                sizeBytes.toLong(),
+                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VulkanMemoryPool.DYNAMIC_UNIFORM
+            )
+            BufferHandle(
+                handle = VulkanBufferHandleData(buffer, allocation.memory, allocation.offset, allocation),
+                size = sizeBytes,
+                usage = BufferUsage.UNIFORM
+            )
         } catch (e: OutOfMemoryException) {
             throw e
         } catch (e: Exception) {
@@ -277,27 +160,148 @@ class VulkanBufferManager(
     }
 
     /**
-     * Update uniform buffer data (transformation matrices).
+     * Create a host-mapped storage buffer for per-frame data the CPU rewrites every frame,
+     * such as the bone palette. Shares the uniform pool; write through [mappedBuffer].
      *
-     * @param handle Buffer handle from createUniformBuffer()
-     * @param data Matrix data as byte array (64 bytes for mat4x4)
-     * @param offset Write offset in bytes (must be 16-byte aligned)
-     * @throws InvalidBufferException if handle is invalid or destroyed
-     * @throws IllegalArgumentException if offset not aligned or data too large
+     * @param sizeBytes Buffer size in bytes (minimum 64 for mat4x4)
+     * @throws IllegalArgumentException if sizeBytes < 64
      */
-    override fun updateUniformBuffer(handle: BufferHandle, data: ByteArray, offset: Int) {
-        // Validate handle
+    fun createStorageBuffer(sizeBytes: Int): BufferHandle {
+        if (sizeBytes < 64) {
+            throw IllegalArgumentException(
+                "storageBuffer.sizeBytes must be at least 64 bytes (mat4x4), got $sizeBytes"
+            )
+        }
+
+        return try {
+            val (buffer, allocation) = createBoundBuffer(
+                sizeBytes.toLong(),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VulkanMemoryPool.DYNAMIC_UNIFORM
+            )
+            BufferHandle(
+                handle = VulkanBufferHandleData(buffer, allocation.memory, allocation.offset, allocation),
+                size = sizeBytes,
+                usage = BufferUsage.STORAGE
+            )
+        } catch (e: OutOfMemoryException) {
+            throw e
+        } catch (e: Exception) {
+            throw OutOfMemoryException("Unexpected error creating storage buffer: ${e.message}")
+        }
+    }
+
+    /**
+     * Persistently mapped host view of a uniform (or host-visible) buffer.
+     *
+     * @throws InvalidBufferException if the buffer is destroyed or not host-mapped
+     */
+    fun mappedBuffer(handle: BufferHandle): ByteBuffer {
+        val bufferData = requireLive(handle)
+        val allocation = bufferData.allocation
+        if (allocation == null || allocation.mappedAddress == 0L) {
+            throw InvalidBufferException("Buffer memory is not host-mapped")
+        }
+        return MemoryUtil.memByteBuffer(allocation.mappedAddress, handle.size)
+    }
+
+    private fun createGeometryBuffer(
+        sizeBytes: Int,
+        usage: Int,
+        bufferUsage: BufferUsage,
+        dstAccessMask: Int,
+        fill: (ByteBuffer, Int) -> Unit
+    ): BufferHandle {
+        val ring = stagingRing
+        val pool = if (ring != null) VulkanMemoryPool.STATIC_GEOMETRY else VulkanMemoryPool.HOST_GEOMETRY
+        val bufferUsageFlags = if (ring != null) usage or VK_BUFFER_USAGE_TRANSFER_DST_BIT else usage
+        val (buffer, allocation) = createBoundBuffer(sizeBytes.toLong(), bufferUsageFlags, pool)
+
+        if (ring != null) {
+            ring.upload(
+                dstBuffer = buffer,
+                dstOffset = 0L,
+                size = sizeBytes.toLong(),
+                dstAccessMask = dstAccessMask,
+                dstStageMask = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                fill = fill
+            )
+        } else {
+            fill(MemoryUtil.memByteBuffer(allocation.mappedAddress, sizeBytes), 0)
+        }
+
+        return BufferHandle(
+            handle = VulkanBufferHandleData(buffer, allocation.memory, allocation.offset, allocation),
+            size = sizeBytes,
+            usage = bufferUsage
+        )
+    }
+
+    private fun createBoundBuffer(
+        sizeBytes: Long,
+        usage: Int,
+        pool: VulkanMemoryPool
+    ): Pair<Long, VulkanAllocation> {
+        MemoryStack.stackPush().use { stack ->
+            val bufferInfo = VkBufferCreateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
+                .size(sizeBytes)
+                .usage(usage)
+                .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
+
+            val pBuffer = stack.mallocLong(1)
+            val result = vkCreateBuffer(device, bufferInfo, null, pBuffer)
+            if (result != VK_SUCCESS) {
+                throw OutOfMemoryException("Failed to create ${pool.name} buffer: VkResult=$result")
+            }
+            val buffer = pBuffer.get(0)
+            // Drivers may hand out a previously destroyed handle value again
+            destroyedBuffers.remove(buffer)
+
+            val memRequirements = VkMemoryRequirements.malloc(stack)
+            vkGetBufferMemoryRequirements(device, buffer, memRequirements)
+
+            val allocation = try {
+                allocator.allocate(memRequirements, pool)
+            } catch (e: Exception) {
+                vkDestroyBuffer(device, buffer, null)
+                throw e
+            }
+
+            val bindResult = vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset)
+            if (bindResult != VK_SUCCESS) {
+                vkDestroyBuffer(device, buffer, null)
+                allocator.free(allocation)
+                throw OutOfMemoryException("Failed to bind ${pool.name} buffer memory: VkResult=$bindResult")
+            }
+
+            return buffer to allocation
+        }
+    }
+
+    private fun requireLive(handle: BufferHandle): VulkanBufferHandleData {
         if (!handle.isValid()) {
             throw InvalidBufferException("Buffer handle is invalid (null handle or zero size)")
         }
-
         val bufferData = handle.handle as? VulkanBufferHandleData
             ?: throw InvalidBufferException("Buffer handle is not a VulkanBufferHandleData")
-
-        // Check if destroyed
         if (destroyedBuffers.contains(bufferData.buffer)) {
             throw InvalidBufferException("Buffer has been destroyed")
         }
+        return bufferData
+    }
+
+    /**
+     * Update uniform buffer data (transformation matrices).
+     *
+     * @param handle Buffer handle from createUniformBuffer()
+     * @param data Matrix data as byte array (64 bytes for mat4x4)
+     * @param offset Write offset in bytes (must be 16-byte aligned)
+     * @throws InvalidBufferException if handle is invalid or destroyed
+     * @throws IllegalArgumentException if offset not aligned or data too large
+     */
+    override fun updateUniformBuffer(handle: BufferHandle, data: ByteArray, offset: Int) {
+        val bufferData = requireLive(handle)
 
         // Validate offset alignment (16-byte for mat4x4)
         if (offset % 16 != 0) {
@@ -311,26 +315,12 @@ class VulkanBufferManager(
             )
         }
 
+        val allocation = bufferData.allocation
+            ?: throw InvalidBufferException("Buffer handle has no pooled allocation")
+
         try {
-            MemoryStack.stackPush().use { stack ->
-                // Map memory
-                val ppData = stack.mallocPointer(1)
-                vkMapMemory(
-                    device,
-                    bufferData.memory,
-                    offset.toLong(),
-                    data.size.toLong(),
-                    0,
-                    ppData
-                )
-                val mappedData = ppData.getByteBuffer(0, data.size)
-
-                // Copy data
-                mappedData.put(data)
-
-                // Unmap memory
-                vkUnmapMemory(device, bufferData.memory)
-            }
+            val mappedData = MemoryUtil.memByteBuffer(allocation.mappedAddress + offset, data.size)
+            mappedData.put(data)
         } catch (e: Exception) {
             throw InvalidBufferException("Failed to update uniform buffer: ${e.message}")
         }
@@ -355,8 +345,13 @@ class VulkanBufferManager(
             // Destroy buffer
             vkDestroyBuffer(device, bufferData.buffer, null)
 
-            // Free memory
-            vkFreeMemory(device, bufferData.memory, null)
+            // Return memory to its pool (or free legacy dedicated memory)
+            val allocation = bufferData.allocation
+            if (allocation != null) {
+                allocator.free(allocation)
+            } else {
+                vkFreeMemory(device, bufferData.memory, null)
+            }
 
             // Mark as destroyed
             destroyedBuffers.add(bufferData.buffer)
@@ -366,39 +361,25 @@ class VulkanBufferManager(
     }
 
     /**
-     * Find suitable memory type from memory type bits.
+     * Release the staging ring and all pooled memory blocks.
      *
-     * @param typeFilter Memory type bits from VkMemoryRequirements
-     * @param properties Required memory properties
-     * @return Memory type index
-     * @throws OutOfMemoryException if no suitable memory type found
+     * Waits for pending uploads; the device must not be using any buffer created here.
      */
-    private fun findMemoryType(typeFilter: Int, properties: Int): Int {
-        MemoryStack.stackPush().use { stack ->
-            val memProperties = VkPhysicalDeviceMemoryProperties.malloc(stack)
-            vkGetPhysicalDeviceMemoryProperties(physicalDevice, memProperties)
-
-            for (i in 0 until memProperties.memoryTypeCount()) {
-                val hasType = (typeFilter and (1 shl i)) != 0
-                val hasProperties =
-                    (memProperties.memoryTypes(i).propertyFlags() and properties) == properties
-
-                if (hasType && hasProperties) {
-                    return i
-                }
-            }
-        }
-
-        throw OutOfMemoryException(
-            "Failed to find suitable memory type (typeFilter=$typeFilter, properties=$properties)"
-        )
+    fun dispose() {
+        stagingRing?.dispose()
+        allocator.dispose()
     }
 }
 
 /**
- * Vulkan buffer handle data containing both VkBuffer and VkDeviceMemory.
+ * Vulkan buffer handle data containing the VkBuffer and its backing memory range.
+ *
+ * @property offset Byte offset of the buffer inside [memory]
+ * @property allocation Pooled allocation backing the buffer (null for dedicated memory)
  */
 data class VulkanBufferHandleData(
     val buffer: Long,
-    val memory: Long
+    val memory: Long,
+    val offset: Long = 0L,
+    val allocation: VulkanAllocation? = null
 )
@@ -0,0 +1,110 @@
+package io.materia.renderer.vulkan
+
+import io.materia.texture.CompressedTextureFormat
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.vulkan.VK12.*
+import org.lwjgl.vulkan.VkFormatProperties
+import org.lwjgl.vulkan.VkPhysicalDevice
+import org.lwjgl.vulkan.VkPhysicalDeviceFeatures
+import io.materia.renderer.CompressedTextureFormat as CapabilityFormat
+
+/**
+ * Block-compressed texture formats on Vulkan: the VkFormat behind each texture and
+ * capability format, and which of them a device can sample.
+ *
+ * BC, ETC2/EAC and ASTC LDR are each gated by a device feature, enabled by
+ * [enableSupportedFeatures] at device creation. PVRTC needs an IMG extension and is not mapped.
+ */
+internal object VulkanCompressedFormats {
+
+    /** The VkFormat uploading [format] as-is, or null when Vulkan has none. */
+    fun vkFormat(format: CompressedTextureFormat): Int? = when (format) {
+        CompressedTextureFormat.BC1_RGB -> VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        CompressedTextureFormat.BC1_RGBA -> VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        CompressedTextureFormat.BC2_RGBA -> VK_FORMAT_BC2_UNORM_BLOCK
+        CompressedTextureFormat.BC3_RGBA -> VK_FORMAT_BC3_UNORM_BLOCK
+        CompressedTextureFormat.BC4_R -> VK_FORMAT_BC4_UNORM_BLOCK
+        CompressedTextureFormat.BC5_RG -> VK_FORMAT_BC5_UNORM_BLOCK
+        CompressedTextureFormat.BC6H_RGB -> VK_FORMAT_BC6H_UFLOAT_BLOCK
+        CompressedTextureFormat.BC7_RGBA -> VK_FORMAT_BC7_UNORM_BLOCK
+        // ETC1 data is valid ETC2 RGB
+        CompressedTextureFormat.ETC1_RGB,
+        CompressedTextureFormat.ETC2_RGB -> VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        CompressedTextureFormat.ETC2_RGBA -> VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        CompressedTextureFormat.ETC2_RGB_A1 -> VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_4x4 -> VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_5x4 -> VK_FORMAT_ASTC_5x4_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_5x5 -> VK_FORMAT_ASTC_5x5_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_6x5 -> VK_FORMAT_ASTC_6x5_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_6x6 -> VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_8x5 -> VK_FORMAT_ASTC_8x5_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_8x6 -> VK_FORMAT_ASTC_8x6_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_8x8 -> VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_10x5 -> VK_FORMAT_ASTC_10x5_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_10x6 -> VK_FORMAT_ASTC_10x6_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_10x8 -> VK_FORMAT_ASTC_10x8_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_10x10 -> VK_FORMAT_ASTC_10x10_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_12x10 -> VK_FORMAT_ASTC_12x10_UNORM_BLOCK
+        CompressedTextureFormat.ASTC_12x12 -> VK_FORMAT_ASTC_12x12_UNORM_BLOCK
+        CompressedTextureFormat.PVRTC_2BPP_RGB,
+        CompressedTextureFormat.PVRTC_2BPP_RGBA,
+        CompressedTextureFormat.PVRTC_4BPP_RGB,
+        CompressedTextureFormat.PVRTC_4BPP_RGBA -> null
+    }
+
+    /** The VkFormat behind a renderer capability, or null when Vulkan has none. */
+    fun vkFormat(format: CapabilityFormat): Int? = when (format) {
+        CapabilityFormat.DXT1 -> VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        CapabilityFormat.DXT3 -> VK_FORMAT_BC2_UNORM_BLOCK
+        CapabilityFormat.DXT5 -> VK_FORMAT_BC3_UNORM_BLOCK
+        CapabilityFormat.BC4 -> VK_FORMAT_BC4_UNORM_BLOCK
+        CapabilityFormat.BC5 -> VK_FORMAT_BC5_UNORM_BLOCK
+        CapabilityFormat.BC6H -> VK_FORMAT_BC6H_UFLOAT_BLOCK
+        CapabilityFormat.BC7 -> VK_FORMAT_BC7_UNORM_BLOCK
+        CapabilityFormat.ETC1,
+        CapabilityFormat.ETC2_RGB -> VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        CapabilityFormat.ETC2_RGBA8 -> VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        CapabilityFormat.EAC_R11 -> VK_FORMAT_EAC_R11_UNORM_BLOCK
+        CapabilityFormat.EAC_RG11 -> VK_FORMAT_EAC_R11G11_UNORM_BLOCK
+        CapabilityFormat.ASTC_4x4 -> VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+        CapabilityFormat.ASTC_5x4 -> VK_FORMAT_ASTC_5x4_UNORM_BLOCK
+        CapabilityFormat.ASTC_5x5 -> VK_FORMAT_ASTC_5x5_UNORM_BLOCK
+        CapabilityFormat.ASTC_6x5 -> VK_FORMAT_ASTC_6x5_UNORM_BLOCK
+        CapabilityFormat.ASTC_6x6 -> VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+        CapabilityFormat.ASTC_8x5 -> VK_FORMAT_ASTC_8x5_UNORM_BLOCK
+        CapabilityFormat.ASTC_8x6 -> VK_FORMAT_ASTC_8x6_UNORM_BLOCK
+        CapabilityFormat.ASTC_8x8 -> VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+        CapabilityFormat.ASTC_10x5 -> VK_FORMAT_ASTC_10x5_UNORM_BLOCK
+        CapabilityFormat.ASTC_10x6 -> VK_FORMAT_ASTC_10x6_UNORM_BLOCK
+        CapabilityFormat.ASTC_10x8 -> VK_FORMAT_ASTC_10x8_UNORM_BLOCK
+        CapabilityFormat.ASTC_10x10 -> VK_FORMAT_ASTC_10x10_UNORM_BLOCK
+        CapabilityFormat.ASTC_12x10 -> VK_FORMAT_ASTC_12x10_UNORM_BLOCK
+        CapabilityFormat.ASTC_12x12 -> VK_FORMAT_ASTC_12x12_UNORM_BLOCK
+        else -> null
+    }
+
+    /** Turn on in [enabled] every texture compression feature [physicalDevice] has. */
+    fun enableSupportedFeatures(physicalDevice: VkPhysicalDevice, enabled: VkPhysicalDeviceFeatures) {
+        MemoryStack.stackPush().use { stack ->
+            val supported = VkPhysicalDeviceFeatures.calloc(stack)
+            vkGetPhysicalDeviceFeatures(physicalDevice, supported)
+            enabled.textureCompressionBC(supported.textureCompressionBC())
+            enabled.textureCompressionETC2(supported.textureCompressionETC2())
+            enabled.textureCompressionASTC_LDR(supported.textureCompressionASTC_LDR())
+        }
+    }
+
+    /** Whether [physicalDevice] can sample optimally tiled images of [vkFormat]. */
+    fun isSampleable(physicalDevice: VkPhysicalDevice, vkFormat: Int): Boolean =
+        MemoryStack.stackPush().use { stack ->
+            val properties = VkFormatProperties.calloc(stack)
+            vkGetPhysicalDeviceFormatProperties(physicalDevice, vkFormat, properties)
+            (properties.optimalTilingFeatures() and VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0
+        }
+
+    /** Capability formats [physicalDevice] can sample, for [io.materia.renderer.RendererCapabilities]. */
+    fun supportedCapabilities(physicalDevice: VkPhysicalDevice): Set<CapabilityFormat> =
+        CapabilityFormat.values().filterTo(LinkedHashSet()) { format ->
+            vkFormat(format)?.let { isSampleable(physicalDevice, it) } == true
+        }
+}
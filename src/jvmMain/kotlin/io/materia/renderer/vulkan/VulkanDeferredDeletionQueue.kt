@@ -0,0 +1,81 @@
+/**
+ * Deferred GPU resource destruction for the Vulkan renderer.
+ *
+ * With several frames in flight, a buffer that is no longer referenced by the
+ * frame being recorded may still be read by a frame the GPU has not finished yet.
+ * Releases are therefore queued with the serial of the last submitted frame and
+ * only executed once the frame fences report that serial as complete.
+ */
+
+package io.materia.renderer.vulkan
+
+/**
+ * FIFO of pending resource releases keyed on monotonically increasing frame serials.
+ */
+internal class VulkanDeferredDeletionQueue {
+
+    private class PendingRelease(
+        val retireAfterSerial: Long,
+        val release: () -> Unit
+    )
+
+    private val pending = ArrayDeque<PendingRelease>()
+
+    /**
+     * Number of releases waiting for their frame to retire.
+     */
+    val size: Int
+        get() = pending.size
+
+    fun isEmpty(): Boolean = pending.isEmpty()
+
+    /**
+     * Queue [release] to run once the GPU has finished the frame with [retireAfterSerial].
+     *
+     * Serials must be non-decreasing across calls; they always are when callers pass the
+     * renderer's latest submitted frame serial.
+     */
+    fun enqueue(retireAfterSerial: Long, release: () -> Unit) {
+        val last = pending.lastOrNull()
+        require(last == null || retireAfterSerial >= last.retireAfterSerial) {
+            "Deferred releases must be queued in frame order (got $retireAfterSerial after ${last?.retireAfterSerial})"
+        }
+        pending.addLast(PendingRelease(retireAfterSerial, release))
+    }
+
+    /**
+     * Run every release whose frame serial is at or below [completedSerial].
+     *
+     * @return number of releases executed
+     */
+    fun collect(completedSerial: Long): Int {
+        var released = 0
+        while (pending.isNotEmpty() && pending.first().retireAfterSerial <= completedSerial) {
+            runRelease(pending.removeFirst())
+            released++
+        }
+        return released
+    }
+
+    /**
+     * Run all pending releases regardless of serial. Only valid once the device is idle.
+     *
+     * @return number of releases executed
+     */
+    fun flush(): Int {
+        var released = 0
+        while (pending.isNotEmpty()) {
+            runRelease(pending.removeFirst())
+            released++
+        }
+        return released
+    }
+
+    private fun runRelease(entry: PendingRelease) {
+        try {
+            entry.release()
+        } catch (e: Exception) {
+            println("[VulkanRenderer] Deferred resource release failed: ${e.message}")
+        }
+    }
+}
@@ -0,0 +1,334 @@
+/**
+ * Per-frame resources for frames-in-flight rendering.
+ *
+ * Each slot owns the command buffer, synchronization objects and per-draw uniform
+ * storage for one frame, so the CPU can record frame N+1 while the GPU still
+ * executes frame N. A slot is only reused after its fence has signalled.
+ */
+
+package io.materia.renderer.vulkan
+
+import io.materia.renderer.feature020.BufferHandle
+import io.materia.renderer.feature020.SwapchainException
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.vulkan.*
+import org.lwjgl.vulkan.VK12.*
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Resources owned by a single frame-in-flight slot.
+ *
+ * @property index Slot index in `[0, framesInFlight)`
+ * @property commandBuffer Primary command buffer recorded for this slot
+ * @property inFlightFence Fence signalled when the slot's last submission completes
+ */
+internal class VulkanFrameContext private constructor(
+    val index: Int,
+    val commandBuffer: VkCommandBuffer,
+    val inFlightFence: Long
+) {
+    /** Signalled by vkAcquireNextImageKHR, waited by the slot's submission. */
+    var imageAvailableSemaphore: Long = VK_NULL_HANDLE
+        private set
+
+    /** Signalled by the slot's submission, waited by vkQueuePresentKHR. */
+    var renderFinishedSemaphore: Long = VK_NULL_HANDLE
+        private set
+
+    /** Render pass recorder bound to [commandBuffer]; rebuilt with the render pass. */
+    var renderPassManager: VulkanRenderPassManager? = null
+
+    /** Descriptor set 0 for this slot (dynamic uniform buffer, bone palette, morph targets). */
+    var descriptorSet: Long = VK_NULL_HANDLE
+
+    /** Per-draw uniform storage, [uniformSlotCapacity] slots of the aligned block stride. */
+    var uniformBuffer: BufferHandle? = null
+        private set
+
+    /** Persistently mapped view of [uniformBuffer] (owned by the buffer manager's uniform pool). */
+    var uniformMapping: ByteBuffer? = null
+        private set
+
+    var uniformSlotCapacity: Int = 0
+        private set
+
+    /** Bone palette storage for the frame's skinned draws, [boneCapacity] matrices. */
+    var boneBuffer: BufferHandle? = null
+        private set
+
+    /** Persistently mapped view of [boneBuffer]. */
+    var boneMapping: ByteBuffer? = null
+        private set
+
+    var boneCapacity: Int = 0
+        private set
+
+    /** Morph target words (see MorphTargetBuffer), [morphCapacityWords] of them. */
+    var morphBuffer: BufferHandle? = null
+        private set
+
+    /** Persistently mapped view of [morphBuffer]. */
+    var morphMapping: ByteBuffer? = null
+        private set
+
+    var morphCapacityWords: Int = 0
+        private set
+
+    /** Leading morph words already copied into [morphBuffer]; reset when it is reallocated. */
+    var morphUploadedWords: Int = 0
+
+    /** Renderer frame serial of the last submission made from this slot (0 = never submitted). */
+    var submittedSerial: Long = 0L
+
+    /**
+     * Start and end timestamps of up to [MAX_TIMED_PASSES] passes per frame, or
+     * VK_NULL_HANDLE when the queue cannot write timestamps.
+     */
+    var timestampQueryPool: Long = VK_NULL_HANDLE
+        private set
+
+    /** Passes timed in the slot's command buffer; pass i writes queries 2i and 2i + 1. */
+    val timedPassNames = ArrayList<String>(MAX_TIMED_PASSES)
+
+    /** Profiler category of each entry in [timedPassNames]. */
+    val timedPassCategories = ArrayList<String>(MAX_TIMED_PASSES)
+
+    /** Whether the last submission wrote [timestampQueryPool]; its results are ready once the fence signals. */
+    var timestampsPending: Boolean = false
+
+    /** Profiler clock time read just before the last submission, so it precedes the GPU work. */
+    var submittedAtNanos: Long = 0L
+
+    /** [io.materia.profiling.PerformanceProfiler] frame of the last submission. */
+    var submittedProfilerFrame: Int = 0
+
+    /**
+     * Replace the slot's uniform storage with a buffer holding [slotCount] draw slots.
+     *
+     * Callers must have waited on [inFlightFence] first so the old buffer is idle.
+     */
+    fun allocateUniforms(
+        bufferManager: VulkanBufferManager,
+        slotCount: Int,
+        slotStride: Int
+    ) {
+        releaseUniforms(bufferManager)
+
+        val buffer = bufferManager.createUniformBuffer(slotCount * slotStride)
+        uniformMapping = bufferManager.mappedBuffer(buffer).order(ByteOrder.LITTLE_ENDIAN)
+
+        uniformBuffer = buffer
+        uniformSlotCapacity = slotCount
+    }
+
+    fun releaseUniforms(bufferManager: VulkanBufferManager?) {
+        val buffer = uniformBuffer ?: return
+        try {
+            bufferManager?.destroyBuffer(buffer)
+        } catch (_: Exception) {
+        }
+        uniformBuffer = null
+        uniformMapping = null
+        uniformSlotCapacity = 0
+    }
+
+    /**
+     * Replace the slot's bone palette storage with a buffer holding [boneCount] matrices.
+     *
+     * Callers must have waited on [inFlightFence] first so the old buffer is idle.
+     */
+    fun allocateBones(bufferManager: VulkanBufferManager, boneCount: Int) {
+        releaseBones(bufferManager)
+
+        val buffer = bufferManager.createStorageBuffer(boneCount * BONE_BYTES)
+        boneMapping = bufferManager.mappedBuffer(buffer).order(ByteOrder.LITTLE_ENDIAN)
+
+        boneBuffer = buffer
+        boneCapacity = boneCount
+    }
+
+    fun releaseBones(bufferManager: VulkanBufferManager?) {
+        val buffer = boneBuffer ?: return
+        try {
+            bufferManager?.destroyBuffer(buffer)
+        } catch (_: Exception) {
+        }
+        boneBuffer = null
+        boneMapping = null
+        boneCapacity = 0
+    }
+
+    /**
+     * Replace the slot's morph target storage with a buffer holding [wordCount] words.
+     *
+     * Callers must have waited on [inFlightFence] first so the old buffer is idle.
+     */
+    fun allocateMorphTargets(bufferManager: VulkanBufferManager, wordCount: Int) {
+        releaseMorphTargets(bufferManager)
+
+        val buffer = bufferManager.createStorageBuffer(wordCount * Int.SIZE_BYTES)
+        morphMapping = bufferManager.mappedBuffer(buffer).order(ByteOrder.LITTLE_ENDIAN)
+
+        morphBuffer = buffer
+        morphCapacityWords = wordCount
+    }
+
+    fun releaseMorphTargets(bufferManager: VulkanBufferManager?) {
+        val buffer = morphBuffer ?: return
+        try {
+            bufferManager?.destroyBuffer(buffer)
+        } catch (_: Exception) {
+        }
+        morphBuffer = null
+        morphMapping = null
+        morphCapacityWords = 0
+        morphUploadedWords = 0
+    }
+
+    /**
+     * Recreate both semaphores.
+     *
+     * Used after swapchain recreation, where an acquire may have signalled
+     * [imageAvailableSemaphore] without a matching wait. The device must be idle.
+     */
+    fun recreateSemaphores(device: VkDevice) {
+        destroySemaphores(device)
+        imageAvailableSemaphore = createSemaphore(device, "imageAvailable")
+        renderFinishedSemaphore = createSemaphore(device, "renderFinished")
+    }
+
+    /**
+     * Destroy the slot's synchronization objects and uniform storage.
+     *
+     * The command buffer is released together with its command pool.
+     */
+    fun dispose(device: VkDevice, bufferManager: VulkanBufferManager?) {
+        releaseUniforms(bufferManager)
+        releaseBones(bufferManager)
+        releaseMorphTargets(bufferManager)
+        destroySemaphores(device)
+        if (timestampQueryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, timestampQueryPool, null)
+            timestampQueryPool = VK_NULL_HANDLE
+            timestampsPending = false
+        }
+        if (inFlightFence != VK_NULL_HANDLE) {
+            vkDestroyFence(device, inFlightFence, null)
+        }
+        renderPassManager = null
+        descriptorSet = VK_NULL_HANDLE
+    }
+
+    private fun destroySemaphores(device: VkDevice) {
+        if (imageAvailableSemaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, imageAvailableSemaphore, null)
+            imageAvailableSemaphore = VK_NULL_HANDLE
+        }
+        if (renderFinishedSemaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, renderFinishedSemaphore, null)
+            renderFinishedSemaphore = VK_NULL_HANDLE
+        }
+    }
+
+    /** Reset the slot's queries at the start of [command]; must precede any timed pass. */
+    fun resetTimedPasses(command: VkCommandBuffer) {
+        timedPassNames.clear()
+        timedPassCategories.clear()
+        if (timestampQueryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(command, timestampQueryPool, 0, TIMESTAMP_QUERIES)
+        }
+    }
+
+    /**
+     * Write the start timestamp of pass [name] into [command].
+     *
+     * @return Index to hand to [endTimedPass], or -1 when the pass goes untimed
+     */
+    fun beginTimedPass(command: VkCommandBuffer, name: String, category: String): Int {
+        if (timestampQueryPool == VK_NULL_HANDLE || timedPassNames.size == MAX_TIMED_PASSES) return -1
+        val pass = timedPassNames.size
+        timedPassNames += name
+        timedPassCategories += category
+        vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampQueryPool, pass * 2)
+        return pass
+    }
+
+    /** Write the end timestamp of [pass], once all of its commands have been recorded. */
+    fun endTimedPass(command: VkCommandBuffer, pass: Int) {
+        if (pass < 0) return
+        vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, pass * 2 + 1)
+    }
+
+    companion object {
+        /** One column-major mat4 per bone. */
+        const val BONE_BYTES = 16 * Float.SIZE_BYTES
+
+        /** Passes a frame can time; later passes in the same frame go untimed. */
+        const val MAX_TIMED_PASSES = 8
+
+        /** Queries in [timestampQueryPool]: a start and an end per timed pass. */
+        const val TIMESTAMP_QUERIES = MAX_TIMED_PASSES * 2
+
+        /**
+         * Allocate a frame slot: one primary command buffer, a fence created in the
+         * signalled state (so the first wait returns immediately), two semaphores and,
+         * with [timestamps], a timestamp query pool.
+         */
+        fun create(device: VkDevice, commandPool: Long, index: Int, timestamps: Boolean = false): VulkanFrameContext {
+            MemoryStack.stackPush().use { stack ->
+                val allocInfo = VkCommandBufferAllocateInfo.calloc(stack)
+                    .sType(VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO)
+                    .commandPool(commandPool)
+                    .level(VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+                    .commandBufferCount(1)
+
+                val pCommandBuffer = stack.callocPointer(1)
+                val allocResult = vkAllocateCommandBuffers(device, allocInfo, pCommandBuffer)
+                if (allocResult != VK_SUCCESS) {
+                    throw IllegalStateException("Failed to allocate frame command buffer: VkResult=$allocResult")
+                }
+
+                val fenceInfo = VkFenceCreateInfo.calloc(stack)
+                    .sType(VK_STRUCTURE_TYPE_FENCE_CREATE_INFO)
+                    .flags(VK_FENCE_CREATE_SIGNALED_BIT)
+                val pFence = stack.mallocLong(1)
+                val fenceResult = vkCreateFence(device, fenceInfo, null, pFence)
+                if (fenceResult != VK_SUCCESS) {
+                    throw IllegalStateException("Failed to create frame fence: VkResult=$fenceResult")
+                }
+
+                val frame = VulkanFrameContext(
+                    index = index,
+                    commandBuffer = VkCommandBuffer(pCommandBuffer.get(0), device),
+                    inFlightFence = pFence.get(0)
+                )
+                frame.recreateSemaphores(device)
+                if (timestamps) {
+                    val queryInfo = VkQueryPoolCreateInfo.calloc(stack)
+                        .sType(VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO)
+                        .queryType(VK_QUERY_TYPE_TIMESTAMP)
+                        .queryCount(TIMESTAMP_QUERIES)
+                    val pPool = stack.mallocLong(1)
+                    if (vkCreateQueryPool(device, queryInfo, null, pPool) == VK_SUCCESS) {
+                        frame.timestampQueryPool = pPool.get(0)
+                    }
+                }
+                return frame
+            }
+        }
+
+        private fun createSemaphore(device: VkDevice, label: String): Long {
+            MemoryStack.stackPush().use { stack ->
+                val semaphoreInfo = VkSemaphoreCreateInfo.calloc(stack)
+                    .sType(VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO)
+                val pSemaphore = stack.mallocLong(1)
+                val result = vkCreateSemaphore(device, semaphoreInfo, null, pSemaphore)
+                if (result != VK_SUCCESS) {
+                    throw SwapchainException("Failed to create $label semaphore: VkResult=$result")
+                }
+                return pSemaphore.get(0)
+            }
+        }
+    }
+}
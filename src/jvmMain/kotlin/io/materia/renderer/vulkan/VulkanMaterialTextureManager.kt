@@ -9,6 +9,7 @@ import io.materia.renderer.material.MaterialBinding
 import io.materia.renderer.material.MaterialBindingSource
 import io.materia.renderer.material.MaterialBindingType
 import io.materia.renderer.material.MaterialDescriptor
+import io.materia.texture.CompressedTexture
 import io.materia.texture.Texture
 import io.materia.texture.Texture2D
 import kotlin.math.log2
@@ -62,6 +63,9 @@ internal class VulkanMaterialTextureManager(
     private val textureCache = mutableMapOf<Int, VulkanTextureResource>()
     private val materialBindings = mutableMapOf<Int, MaterialBindingState>()
 
+    // Compressed VkFormats by whether the device samples them, queried once per format
+    private val sampleableFormats = mutableMapOf<Int, Boolean>()
+
     private val fallbackAlbedo =
         createFallbackTexture(Texture2D.solidColor(Color.WHITE).apply { needsUpdate = false })
     private val fallbackNormal = createFallbackTexture(
@@ -172,8 +176,8 @@ internal class VulkanMaterialTextureManager(
         materialBindings.clear()
     }
 
-    private fun extractAlbedoTexture(material: Material): Texture2D? = when (material) {
-        is MeshBasicMaterial -> material.map as? Texture2D
+    private fun extractAlbedoTexture(material: Material): Texture? = when (material) {
+        is MeshBasicMaterial -> material.map
         is MeshStandardMaterial -> material.map
         else -> null
     }
@@ -202,17 +206,22 @@ internal class VulkanMaterialTextureManager(
         texture: Texture?,
         fallback: VulkanTextureResource
     ): VulkanTextureResource {
-        val texture2D = texture as? Texture2D ?: return fallback
+        if (texture == null || (texture !is Texture2D && texture !is CompressedTexture)) return fallback
 
-        val cached = textureCache[texture2D.id]
-        if (cached != null && cached.version == texture2D.version && !texture2D.needsUpdate) {
+        val cached = textureCache[texture.id]
+        if (cached != null && cached.version == texture.version && !texture.needsUpdate) {
             return cached
         }
 
+        val resource = when (texture) {
+            is Texture2D -> createTextureResource(texture)
+            // Formats the device can't sample keep the fallback bound
+            is CompressedTexture -> createCompressedResource(texture) ?: return fallback
+            else -> return fallback
+        }
         cached?.destroy(device)
-        val resource = createTextureResource(texture2D)
-        textureCache[texture2D.id] = resource
-        texture2D.needsUpdate = false
+        textureCache[texture.id] = resource
+        texture.needsUpdate = false
         return resource
     }
 
@@ -238,94 +247,25 @@ internal class VulkanMaterialTextureManager(
         }
 
         val rawData = acquireTextureData(texture, pixelSize)
-        val imageSize = rawData.remaining().toLong()
 
         MemoryStack.stackPush().use { stack ->
-            val stagingBufferInfo = VkBufferCreateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
-                .size(imageSize)
-                .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-                .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
-
-            val pStagingBuffer = stack.mallocLong(1)
-            check(vkCreateBuffer(device, stagingBufferInfo, null, pStagingBuffer) == VK_SUCCESS) {
-                "Failed to create staging buffer"
-            }
-            val stagingBuffer = pStagingBuffer[0]
-
-            val stagingMemRequirements = VkMemoryRequirements.malloc(stack)
-            vkGetBufferMemoryRequirements(device, stagingBuffer, stagingMemRequirements)
-
-            val stagingAllocInfo = VkMemoryAllocateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
-                .allocationSize(stagingMemRequirements.size())
-                .memoryTypeIndex(
-                    findMemoryType(
-                        stagingMemRequirements.memoryTypeBits(),
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                    )
-                )
-
-            val pStagingMemory = stack.mallocLong(1)
-            check(vkAllocateMemory(device, stagingAllocInfo, null, pStagingMemory) == VK_SUCCESS) {
-                "Failed to allocate staging buffer memory"
-            }
-            val stagingMemory = pStagingMemory[0]
-            vkBindBufferMemory(device, stagingBuffer, stagingMemory, 0)
-
-            val ppData = stack.mallocPointer(1)
-            vkMapMemory(device, stagingMemory, 0, imageSize, 0, ppData)
-            val mapped = ppData.getByteBuffer(0, rawData.remaining())
-            mapped.put(rawData).flip()
-            vkUnmapMemory(device, stagingMemory)
+            val (stagingBuffer, stagingMemory) = createStagingBuffer(stack, rawData)
             MemoryUtil.memFree(rawData)
 
             val mipLevels = calculateMipLevels(texture)
             val allowLinearFilter = supportsLinearFilter(format)
             val generateMipmaps = mipLevels > 1 && allowLinearFilter
 
-            val imageInfo = VkImageCreateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO)
-                .imageType(VK_IMAGE_TYPE_2D)
-                .extent { it.width(texture.width).height(texture.height).depth(1) }
-                .mipLevels(mipLevels)
-                .arrayLayers(1)
-                .format(format)
-                .tiling(VK_IMAGE_TILING_OPTIMAL)
-                .initialLayout(VK_IMAGE_LAYOUT_UNDEFINED)
-                .usage(
-                    VK_IMAGE_USAGE_SAMPLED_BIT or
-                            VK_IMAGE_USAGE_TRANSFER_DST_BIT or
-                            if (generateMipmaps) VK_IMAGE_USAGE_TRANSFER_SRC_BIT else 0
-                )
-                .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
-                .samples(VK_SAMPLE_COUNT_1_BIT)
-
-            val pImage = stack.mallocLong(1)
-            check(vkCreateImage(device, imageInfo, null, pImage) == VK_SUCCESS) {
-                "Failed to create image"
-            }
-            val image = pImage[0]
-
-            val memRequirements = VkMemoryRequirements.malloc(stack)
-            vkGetImageMemoryRequirements(device, image, memRequirements)
-
-            val allocInfo = VkMemoryAllocateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
-                .allocationSize(memRequirements.size())
-                .memoryTypeIndex(
-                    findMemoryType(
-                        memRequirements.memoryTypeBits(),
-                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-                    )
-                )
-
-            val pMemory = stack.mallocLong(1)
-            check(vkAllocateMemory(device, allocInfo, null, pMemory) == VK_SUCCESS) {
-                "Failed to allocate image memory"
-            }
-            val imageMemory = pMemory[0]
-            vkBindImageMemory(device, image, imageMemory, 0)
+            val (image, imageMemory) = createImage(
+                stack,
+                texture.width,
+                texture.height,
+                mipLevels,
+                format,
+                VK_IMAGE_USAGE_SAMPLED_BIT or
+                        VK_IMAGE_USAGE_TRANSFER_DST_BIT or
+                        if (generateMipmaps) VK_IMAGE_USAGE_TRANSFER_SRC_BIT else 0
+            )
 
             executeSingleTimeCommands { cmd, innerStack ->
                 transitionImageLayout(
@@ -400,6 +340,199 @@ internal class VulkanMaterialTextureManager(
         }
     }
 
+    /**
+     * Upload every mip of a block-compressed texture as-is, or return null when Vulkan has
+     * no format for it or the device can't sample that format.
+     */
+    private fun createCompressedResource(texture: CompressedTexture): VulkanTextureResource? {
+        val format = VulkanCompressedFormats.vkFormat(texture.compressedFormat) ?: return null
+        val sampleable = sampleableFormats.getOrPut(format) {
+            VulkanCompressedFormats.isSampleable(physicalDevice, format)
+        }
+        val mipmaps = texture.compressedMipmaps.sortedBy { it.level }
+        if (!sampleable || mipmaps.isEmpty() || texture.width <= 0 || texture.height <= 0) return null
+
+        val rawData = MemoryUtil.memAlloc(mipmaps.sumOf { it.data.size })
+        mipmaps.forEach { rawData.put(it.data) }
+        rawData.flip()
+
+        MemoryStack.stackPush().use { stack ->
+            val (stagingBuffer, stagingMemory) = createStagingBuffer(stack, rawData)
+            MemoryUtil.memFree(rawData)
+
+            val mipLevels = mipmaps.size
+            val (image, imageMemory) = createImage(
+                stack,
+                texture.width,
+                texture.height,
+                mipLevels,
+                format,
+                VK_IMAGE_USAGE_SAMPLED_BIT or VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            )
+
+            executeSingleTimeCommands { cmd, innerStack ->
+                transitionImageLayout(
+                    cmd,
+                    innerStack,
+                    image,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    mipLevels,
+                    0,
+                    mipLevels
+                )
+
+                // Levels sit back to back in the staging buffer; each is a whole number of
+                // blocks, so every offset stays block-aligned
+                val regions = VkBufferImageCopy.calloc(mipLevels, innerStack)
+                var offset = 0L
+                for (level in 0 until mipLevels) {
+                    regions[level]
+                        .bufferOffset(offset)
+                        .bufferRowLength(0)
+                        .bufferImageHeight(0)
+                        .imageSubresource { sub ->
+                            sub.aspectMask(VK_IMAGE_ASPECT_COLOR_BIT)
+                            sub.mipLevel(level)
+                            sub.baseArrayLayer(0)
+                            sub.layerCount(1)
+                        }
+                        .imageOffset { it.x(0).y(0).z(0) }
+                        .imageExtent {
+                            it.width(maxOf(1, texture.width shr level))
+                                .height(maxOf(1, texture.height shr level))
+                                .depth(1)
+                        }
+                    offset += mipmaps[level].data.size
+                }
+
+                vkCmdCopyBufferToImage(
+                    cmd,
+                    stagingBuffer,
+                    image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    regions
+                )
+
+                transitionImageLayout(
+                    cmd,
+                    innerStack,
+                    image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    mipLevels,
+                    0,
+                    mipLevels
+                )
+            }
+
+            vkDestroyBuffer(device, stagingBuffer, null)
+            vkFreeMemory(device, stagingMemory, null)
+
+            return VulkanTextureResource(
+                image = image,
+                memory = imageMemory,
+                imageView = createImageView(image, format, mipLevels),
+                sampler = createSampler(texture, mipLevels),
+                textureId = texture.id,
+                version = texture.version
+            )
+        }
+    }
+
+    /** Host-visible buffer holding a copy of [data]; returns the buffer and its memory. */
+    private fun createStagingBuffer(stack: MemoryStack, data: java.nio.ByteBuffer): Pair<Long, Long> {
+        val size = data.remaining().toLong()
+        val stagingBufferInfo = VkBufferCreateInfo.calloc(stack)
+            .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
+            .size(size)
+            .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+            .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
+
+        val pStagingBuffer = stack.mallocLong(1)
+        check(vkCreateBuffer(device, stagingBufferInfo, null, pStagingBuffer) == VK_SUCCESS) {
+            "Failed to create staging buffer"
+        }
+        val stagingBuffer = pStagingBuffer[0]
+
+        val stagingMemRequirements = VkMemoryRequirements.malloc(stack)
+        vkGetBufferMemoryRequirements(device, stagingBuffer, stagingMemRequirements)
+
+        val stagingAllocInfo = VkMemoryAllocateInfo.calloc(stack)
+            .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
+            .allocationSize(stagingMemRequirements.size())
+            .memoryTypeIndex(
+                findMemoryType(
+                    stagingMemRequirements.memoryTypeBits(),
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                )
+            )
+
+        val pStagingMemory = stack.mallocLong(1)
+        check(vkAllocateMemory(device, stagingAllocInfo, null, pStagingMemory) == VK_SUCCESS) {
+            "Failed to allocate staging buffer memory"
+        }
+        val stagingMemory = pStagingMemory[0]
+        vkBindBufferMemory(device, stagingBuffer, stagingMemory, 0)
+
+        val ppData = stack.mallocPointer(1)
+        vkMapMemory(device, stagingMemory, 0, size, 0, ppData)
+        val mapped = ppData.getByteBuffer(0, data.remaining())
+        mapped.put(data).flip()
+        vkUnmapMemory(device, stagingMemory)
+        return stagingBuffer to stagingMemory
+    }
+
+    /** Device-local, optimally tiled 2D image; returns the image and its memory. */
+    private fun createImage(
+        stack: MemoryStack,
+        width: Int,
+        height: Int,
+        mipLevels: Int,
+        format: Int,
+        usage: Int
+    ): Pair<Long, Long> {
+        val imageInfo = VkImageCreateInfo.calloc(stack)
+            .sType(VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO)
+            .imageType(VK_IMAGE_TYPE_2D)
+            .extent { it.width(width).height(height).depth(1) }
+            .mipLevels(mipLevels)
+            .arrayLayers(1)
+            .format(format)
+            .tiling(VK_IMAGE_TILING_OPTIMAL)
+            .initialLayout(VK_IMAGE_LAYOUT_UNDEFINED)
+            .usage(usage)
+            .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
+            .samples(VK_SAMPLE_COUNT_1_BIT)
+
+        val pImage = stack.mallocLong(1)
+        check(vkCreateImage(device, imageInfo, null, pImage) == VK_SUCCESS) {
+            "Failed to create image"
+        }
+        val image = pImage[0]
+
+        val memRequirements = VkMemoryRequirements.malloc(stack)
+        vkGetImageMemoryRequirements(device, image, memRequirements)
+
+        val allocInfo = VkMemoryAllocateInfo.calloc(stack)
+            .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
+            .allocationSize(memRequirements.size())
+            .memoryTypeIndex(
+                findMemoryType(
+                    memRequirements.memoryTypeBits(),
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                )
+            )
+
+        val pMemory = stack.mallocLong(1)
+        check(vkAllocateMemory(device, allocInfo, null, pMemory) == VK_SUCCESS) {
+            "Failed to allocate image memory"
+        }
+        val imageMemory = pMemory[0]
+        vkBindImageMemory(device, image, imageMemory, 0)
+        return image to imageMemory
+    }
+
     private fun createImageView(image: Long, format: Int, mipLevels: Int): Long =
         MemoryStack.stackPush().use { stack ->
             val components = VkComponentMapping.calloc(stack)
@@ -435,7 +568,7 @@ internal class VulkanMaterialTextureManager(
             pView[0]
         }
 
-    private fun createSampler(texture: Texture2D, mipLevels: Int): Long =
+    private fun createSampler(texture: Texture, mipLevels: Int): Long =
         MemoryStack.stackPush().use { stack ->
             val createInfo = VkSamplerCreateInfo.calloc(stack)
                 .sType(VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO)
@@ -0,0 +1,278 @@
+/**
+ * Pooled VkDeviceMemory allocator for the Vulkan renderer.
+ *
+ * Buffers are carved out of large memory blocks instead of calling
+ * vkAllocateMemory per buffer, which keeps large scenes well below the driver's
+ * maxMemoryAllocationCount and keeps the driver allocator out of load time.
+ */
+
+package io.materia.renderer.vulkan
+
+import io.materia.renderer.feature020.OutOfMemoryException
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.system.MemoryUtil
+import org.lwjgl.vulkan.*
+import org.lwjgl.vulkan.VK12.*
+import java.nio.ByteBuffer
+
+/**
+ * Memory pools with separate blocks, so long-lived geometry never shares (and
+ * fragments) a block with short-lived per-frame uniform storage.
+ *
+ * @property requiredFlags Memory property flags the pool's memory type must have
+ * @property blockSize Size of each pooled VkDeviceMemory allocation (power of two)
+ * @property persistentlyMapped Blocks are mapped once at creation and stay mapped
+ */
+enum class VulkanMemoryPool(
+    val requiredFlags: Int,
+    val blockSize: Long,
+    val persistentlyMapped: Boolean
+) {
+    /** Device-local static vertex/index data, filled through the staging ring. */
+    STATIC_GEOMETRY(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 64L * 1024 * 1024, false),
+
+    /** Host-visible geometry for when no staging queue is available. */
+    HOST_GEOMETRY(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 32L * 1024 * 1024, true),
+
+    /** Per-frame uniform data written by the CPU every frame. */
+    DYNAMIC_UNIFORM(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 16L * 1024 * 1024, true),
+
+    /** Upload staging memory; the staging ring takes one dedicated block. */
+    STAGING(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT or VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 16L * 1024 * 1024, true)
+}
+
+/**
+ * A sub-allocated range of a memory block.
+ *
+ * @property memory Backing VkDeviceMemory
+ * @property offset Byte offset inside [memory]
+ * @property size Requested size in bytes
+ * @property mappedAddress Host address of the range, or 0 if not host-mapped
+ */
+class VulkanAllocation internal constructor(
+    val memory: Long,
+    val offset: Long,
+    val size: Long,
+    val mappedAddress: Long,
+    internal val pool: VulkanMemoryPool,
+    internal val block: VulkanMemoryAllocator.MemoryBlock
+) {
+    /** Host view of the allocation; only valid for persistently mapped pools. */
+    fun mappedBuffer(): ByteBuffer {
+        check(mappedAddress != 0L) { "Allocation from $pool is not host-mapped" }
+        return MemoryUtil.memByteBuffer(mappedAddress, size.toInt())
+    }
+}
+
+/**
+ * Snapshot of allocator usage.
+ *
+ * @property allocatedBytes Bytes held in VkDeviceMemory blocks
+ * @property usedBytes Bytes covered by live sub-allocations (including buddy rounding)
+ * @property blockCount Number of live vkAllocateMemory allocations
+ * @property allocationCount Number of live sub-allocations
+ * @property fragmentation Average external fragmentation of pooled blocks, `[0, 1]`
+ */
+data class VulkanMemoryStats(
+    val allocatedBytes: Long,
+    val usedBytes: Long,
+    val blockCount: Int,
+    val allocationCount: Int,
+    val fragmentation: Float
+)
+
+/**
+ * Block-based allocator: one list of blocks per (pool, memory type), each block
+ * sub-allocated with a [BuddySubAllocator]. Requests larger than a pool's block
+ * size get a dedicated allocation.
+ */
+class VulkanMemoryAllocator(
+    private val device: VkDevice,
+    private val physicalDevice: VkPhysicalDevice
+) {
+    internal class MemoryBlock(
+        val memory: Long,
+        val size: Long,
+        val memoryTypeIndex: Int,
+        val mappedAddress: Long,
+        val suballocator: BuddySubAllocator?
+    )
+
+    private data class PoolKey(val pool: VulkanMemoryPool, val memoryTypeIndex: Int)
+
+    private val blocks = HashMap<PoolKey, MutableList<MemoryBlock>>()
+    private val dedicatedBlocks = mutableSetOf<MemoryBlock>()
+
+    /**
+     * Allocate memory satisfying [requirements] from [pool].
+     *
+     * @throws OutOfMemoryException if no compatible memory type exists or the driver is out of memory
+     */
+    fun allocate(requirements: VkMemoryRequirements, pool: VulkanMemoryPool): VulkanAllocation =
+        allocate(requirements.size(), requirements.alignment(), requirements.memoryTypeBits(), pool)
+
+    fun allocate(size: Long, alignment: Long, memoryTypeBits: Int, pool: VulkanMemoryPool): VulkanAllocation {
+        val memoryTypeIndex = findMemoryType(memoryTypeBits, pool.requiredFlags)
+
+        if (size > pool.blockSize / 2) {
+            val block = allocateBlock(size, memoryTypeIndex, pool, pooled = false)
+            dedicatedBlocks += block
+            return VulkanAllocation(block.memory, 0L, size, block.mappedAddress, pool, block)
+        }
+
+        val key = PoolKey(pool, memoryTypeIndex)
+        val poolBlocks = blocks.getOrPut(key) { mutableListOf() }
+        for (block in poolBlocks) {
+            val offset = block.suballocator!!.allocate(size, alignment)
+            if (offset >= 0) {
+                return makeAllocation(block, offset, size, pool)
+            }
+        }
+
+        val block = allocateBlock(pool.blockSize, memoryTypeIndex, pool, pooled = true)
+        poolBlocks += block
+        val offset = block.suballocator!!.allocate(size, alignment)
+        check(offset >= 0) { "Fresh ${pool.name} block could not satisfy $size bytes" }
+        return makeAllocation(block, offset, size, pool)
+    }
+
+    /**
+     * Return an allocation to its block. Fully empty pooled blocks are released
+     * as long as the pool keeps at least one block for reuse.
+     */
+    fun free(allocation: VulkanAllocation) {
+        val block = allocation.block
+        if (block.suballocator == null) {
+            if (dedicatedBlocks.remove(block)) {
+                releaseBlock(block)
+            }
+            return
+        }
+
+        block.suballocator.free(allocation.offset)
+        if (block.suballocator.isEmpty()) {
+            val poolBlocks = blocks[PoolKey(allocation.pool, block.memoryTypeIndex)] ?: return
+            if (poolBlocks.size > 1 && poolBlocks.remove(block)) {
+                releaseBlock(block)
+            }
+        }
+    }
+
+    fun stats(): VulkanMemoryStats {
+        var allocated = 0L
+        var used = 0L
+        var blockCount = 0
+        var allocationCount = 0
+        var fragmentationSum = 0f
+        var pooledBlockCount = 0
+
+        for (poolBlocks in blocks.values) {
+            for (block in poolBlocks) {
+                val suballocator = block.suballocator ?: continue
+                allocated += block.size
+                used += suballocator.usedBytes
+                allocationCount += suballocator.allocationCount
+                fragmentationSum += suballocator.fragmentation()
+                blockCount++
+                pooledBlockCount++
+            }
+        }
+        for (block in dedicatedBlocks) {
+            allocated += block.size
+            used += block.size
+            allocationCount++
+            blockCount++
+        }
+
+        val fragmentation = if (pooledBlockCount > 0) fragmentationSum / pooledBlockCount else 0f
+        return VulkanMemoryStats(allocated, used, blockCount, allocationCount, fragmentation)
+    }
+
+    /**
+     * Release every block. All buffers bound to this allocator's memory must be destroyed.
+     */
+    fun dispose() {
+        blocks.values.forEach { poolBlocks -> poolBlocks.forEach(::releaseBlock) }
+        blocks.clear()
+        dedicatedBlocks.forEach(::releaseBlock)
+        dedicatedBlocks.clear()
+    }
+
+    private fun makeAllocation(
+        block: MemoryBlock,
+        offset: Long,
+        size: Long,
+        pool: VulkanMemoryPool
+    ): VulkanAllocation {
+        val mapped = if (block.mappedAddress != 0L) block.mappedAddress + offset else 0L
+        return VulkanAllocation(block.memory, offset, size, mapped, pool, block)
+    }
+
+    private fun allocateBlock(
+        size: Long,
+        memoryTypeIndex: Int,
+        pool: VulkanMemoryPool,
+        pooled: Boolean
+    ): MemoryBlock {
+        MemoryStack.stackPush().use { stack ->
+            val allocInfo = VkMemoryAllocateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO)
+                .allocationSize(size)
+                .memoryTypeIndex(memoryTypeIndex)
+
+            val pMemory = stack.mallocLong(1)
+            val result = vkAllocateMemory(device, allocInfo, null, pMemory)
+            if (result != VK_SUCCESS) {
+                throw OutOfMemoryException("Failed to allocate ${pool.name} memory block ($size bytes): VkResult=$result")
+            }
+            val memory = pMemory.get(0)
+
+            var mappedAddress = 0L
+            if (pool.persistentlyMapped) {
+                val ppData = stack.mallocPointer(1)
+                val mapResult = vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, ppData)
+                if (mapResult != VK_SUCCESS) {
+                    vkFreeMemory(device, memory, null)
+                    throw OutOfMemoryException("Failed to map ${pool.name} memory block: VkResult=$mapResult")
+                }
+                mappedAddress = ppData.get(0)
+            }
+
+            return MemoryBlock(
+                memory = memory,
+                size = size,
+                memoryTypeIndex = memoryTypeIndex,
+                mappedAddress = mappedAddress,
+                suballocator = if (pooled) BuddySubAllocator(size) else null
+            )
+        }
+    }
+
+    private fun releaseBlock(block: MemoryBlock) {
+        if (block.mappedAddress != 0L) {
+            vkUnmapMemory(device, block.memory)
+        }
+        vkFreeMemory(device, block.memory, null)
+    }
+
+    private fun findMemoryType(typeFilter: Int, properties: Int): Int {
+        MemoryStack.stackPush().use { stack ->
+            val memProperties = VkPhysicalDeviceMemoryProperties.malloc(stack)
+            vkGetPhysicalDeviceMemoryProperties(physicalDevice, memProperties)
+
+            for (i in 0 until memProperties.memoryTypeCount()) {
+                val hasType = (typeFilter and (1 shl i)) != 0
+                val hasProperties =
+                    (memProperties.memoryTypes(i).propertyFlags() and properties) == properties
+
+                if (hasType && hasProperties) {
+                    return i
+                }
+            }
+        }
+
+        throw OutOfMemoryException(
+            "Failed to find suitable memory type (typeFilter=$typeFilter, properties=$properties)"
+        )
+    }
+}
@@ -9,22 +9,17 @@ import io.materia.renderer.webgpu.CullMode
 import io.materia.renderer.webgpu.FrontFace
 import io.materia.renderer.webgpu.BlendFactor
 import io.materia.renderer.webgpu.BlendOperation
-import org.lwjgl.BufferUtils
 import org.lwjgl.system.MemoryStack
-import org.lwjgl.system.MemoryUtil
-import org.lwjgl.util.shaderc.Shaderc
 import org.lwjgl.vulkan.VK12.*
 import org.lwjgl.vulkan.VkCommandBuffer
 import org.lwjgl.vulkan.VkDevice
 import org.lwjgl.vulkan.VkPipelineShaderStageCreateInfo
-import org.lwjgl.vulkan.VkShaderModuleCreateInfo
 import org.lwjgl.vulkan.VkVertexInputAttributeDescription
 import org.lwjgl.vulkan.VkVertexInputBindingDescription
 
 /**
- * Vulkan graphics pipeline responsible for compiling shaders and creating the fixed pipeline state
- * used by the renderer. The implementation deliberately keeps the shader extremely small: the
- * vertex shader forwards clip-space positions, and the fragment shader outputs vertex colours.
+ * Vulkan graphics pipeline: pipeline layout plus the fixed-function state used by the
+ * renderer. Shader modules come from [VulkanShaderModuleCache] and are not owned here.
  */
 class VulkanPipeline(
     private val device: VkDevice
@@ -35,11 +30,14 @@ class VulkanPipeline(
     private var graphicsPipeline: Long = VK_NULL_HANDLE
 
     /**
-     * Compile shaders (GLSL -> SPIR-V) and create the Vulkan graphics pipeline.
+     * Create the Vulkan graphics pipeline from already compiled shader modules.
      *
      * @param renderPass Render pass the pipeline depends on.
      * @param width Swapchain width (used for static viewport/scissor configuration).
      * @param height Swapchain height.
+     * @param vertexModule Vertex shader module; must outlive this call only.
+     * @param fragmentModule Fragment shader module; must outlive this call only.
+     * @param pipelineCache Driver pipeline cache to consult and fill, or VK_NULL_HANDLE.
      */
     fun createPipeline(
         renderPass: Long,
@@ -48,30 +46,29 @@ class VulkanPipeline(
         descriptorSetLayouts: LongArray,
         vertexLayouts: List<VertexBufferLayout>,
         renderState: MaterialRenderState,
-        vertexSource: String,
-        fragmentSource: String
+        vertexModule: Long,
+        fragmentModule: Long,
+        pipelineCache: Long = VK_NULL_HANDLE
     ): Boolean {
         dispose()
 
         return try {
-            val vertexSpv =
-                compileShader(vertexSource, Shaderc.shaderc_glsl_vertex_shader, "triangle.vert")
-            val fragmentSpv =
-                compileShader(fragmentSource, Shaderc.shaderc_glsl_fragment_shader, "triangle.frag")
-
-            vertexShaderModule = createShaderModule(vertexSpv)
-            fragmentShaderModule = createShaderModule(fragmentSpv)
-
-            MemoryUtil.memFree(vertexSpv)
-            MemoryUtil.memFree(fragmentSpv)
+            vertexShaderModule = vertexModule
+            fragmentShaderModule = fragmentModule
 
             pipelineLayout = createPipelineLayout(descriptorSetLayouts)
             if (pipelineLayout == VK_NULL_HANDLE) {
                 throw IllegalStateException("Failed to create pipeline layout")
             }
 
-            graphicsPipeline =
-                createGraphicsPipeline(renderPass, width, height, vertexLayouts, renderState)
+            graphicsPipeline = createGraphicsPipeline(
+                renderPass,
+                width,
+                height,
+                vertexLayouts,
+                renderState,
+                pipelineCache
+            )
             graphicsPipeline != VK_NULL_HANDLE
         } catch (exc: Exception) {
             println("VulkanPipeline creation failed: ${exc.message}")
@@ -81,48 +78,6 @@ class VulkanPipeline(
         }
     }
 
-    private fun compileShader(source: String, kind: Int, name: String): java.nio.ByteBuffer {
-        val compiler = Shaderc.shaderc_compiler_initialize()
-        val options = Shaderc.shaderc_compile_options_initialize()
-
-        val result = Shaderc.shaderc_compile_into_spv(compiler, source, kind, name, "main", options)
-        val status = Shaderc.shaderc_result_get_compilation_status(result)
-        if (status != Shaderc.shaderc_compilation_status_success) {
-            val error = Shaderc.shaderc_result_get_error_message(result)
-            Shaderc.shaderc_result_release(result)
-            Shaderc.shaderc_compile_options_release(options)
-            Shaderc.shaderc_compiler_release(compiler)
-            throw IllegalStateException("Shader compilation failed for $name: $error")
-        }
-
-        val length = Shaderc.shaderc_result_get_length(result).toInt()
-        val output = BufferUtils.createByteBuffer(length)
-        output.put(Shaderc.shaderc_result_get_bytes(result))
-        output.flip()
-
-        Shaderc.shaderc_result_release(result)
-        Shaderc.shaderc_compile_options_release(options)
-        Shaderc.shaderc_compiler_release(compiler)
-
-        return output
-    }
-
-    private fun createShaderModule(spirvCode: java.nio.ByteBuffer): Long {
-        return MemoryStack.stackPush().use { stack ->
-            val createInfo = VkShaderModuleCreateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO)
-                .pCode(spirvCode)
-
-            val pShaderModule = stack.mallocLong(1)
-            val result = vkCreateShaderModule(device, createInfo, null, pShaderModule)
-            if (result != VK_SUCCESS) {
-                VK_NULL_HANDLE
-            } else {
-                pShaderModule[0]
-            }
-        }
-    }
-
     private fun createPipelineLayout(descriptorSetLayouts: LongArray): Long {
         return MemoryStack.stackPush().use { stack ->
             val setLayoutsBuffer = stack.mallocLong(descriptorSetLayouts.size)
@@ -145,7 +100,8 @@ class VulkanPipeline(
         width: Int,
         height: Int,
         vertexLayouts: List<VertexBufferLayout>,
-        renderState: MaterialRenderState
+        renderState: MaterialRenderState,
+        pipelineCache: Long
     ): Long {
         return MemoryStack.stackPush().use { stack ->
             val entryPoint = stack.UTF8("main")
@@ -275,7 +231,7 @@ class VulkanPipeline(
             val pGraphicsPipeline = stack.mallocLong(1)
             val result = vkCreateGraphicsPipelines(
                 device,
-                VK_NULL_HANDLE,
+                pipelineCache,
                 pipelineInfo,
                 null,
                 pGraphicsPipeline
@@ -305,15 +261,9 @@ class VulkanPipeline(
             pipelineLayout = VK_NULL_HANDLE
         }
 
-        if (vertexShaderModule != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(device, vertexShaderModule, null)
-            vertexShaderModule = VK_NULL_HANDLE
-        }
-
-        if (fragmentShaderModule != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(device, fragmentShaderModule, null)
-            fragmentShaderModule = VK_NULL_HANDLE
-        }
+        // Shader modules belong to the module cache
+        vertexShaderModule = VK_NULL_HANDLE
+        fragmentShaderModule = VK_NULL_HANDLE
     }
 
     private fun toVulkanFormat(format: VertexFormat): Int = when (format) {
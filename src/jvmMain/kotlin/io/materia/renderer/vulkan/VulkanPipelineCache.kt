@@ -0,0 +1,198 @@
+/**
+ * Persistent VkPipelineCache for the Vulkan renderer.
+ *
+ * Drivers spend most of pipeline creation compiling SPIR-V to machine code. A
+ * pipeline cache lets them reuse that work, and saving it to disk carries it over
+ * to the next run so materials seen before no longer hitch on first draw.
+ */
+
+package io.materia.renderer.vulkan
+
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.system.MemoryUtil
+import org.lwjgl.vulkan.VK12.*
+import org.lwjgl.vulkan.VkDevice
+import org.lwjgl.vulkan.VkPhysicalDevice
+import org.lwjgl.vulkan.VkPhysicalDeviceProperties
+import org.lwjgl.vulkan.VkPipelineCacheCreateInfo
+import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.file.Files
+import java.nio.file.StandardCopyOption
+
+/**
+ * Identity of the device a cache blob was produced on.
+ *
+ * @property vendorId PCI vendor id
+ * @property deviceId Vendor-specific device id
+ * @property driverVersion Vendor-encoded driver version
+ * @property cacheUuid VkPhysicalDeviceProperties::pipelineCacheUUID (16 bytes)
+ */
+internal class PipelineCacheIdentity(
+    val vendorId: Int,
+    val deviceId: Int,
+    val driverVersion: Int,
+    val cacheUuid: ByteArray
+) {
+    init {
+        require(cacheUuid.size == VK_UUID_SIZE) { "cacheUuid must be $VK_UUID_SIZE bytes" }
+    }
+
+    /** File name unique to this device and driver, so upgrades never load a stale blob. */
+    fun fileName(): String {
+        val uuid = cacheUuid.joinToString("") { (it.toInt() and 0xFF).toString(16).padStart(2, '0') }
+        return "pipeline-cache-%08x-%08x-%08x-%s.bin".format(vendorId, deviceId, driverVersion, uuid)
+    }
+
+    /**
+     * Check a serialized cache against the `VkPipelineCacheHeaderVersionOne` layout:
+     * header length, header version, vendor id, device id and cache UUID.
+     */
+    fun accepts(data: ByteArray): Boolean {
+        if (data.size < HEADER_SIZE) return false
+        val header = ByteBuffer.wrap(data).order(ByteOrder.LITTLE_ENDIAN)
+        if (header.getInt(0) < HEADER_SIZE) return false
+        if (header.getInt(4) != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) return false
+        if (header.getInt(8) != vendorId || header.getInt(12) != deviceId) return false
+        for (i in 0 until VK_UUID_SIZE) {
+            if (data[16 + i] != cacheUuid[i]) return false
+        }
+        return true
+    }
+
+    companion object {
+        const val HEADER_SIZE = 16 + VK_UUID_SIZE
+
+        fun of(physicalDevice: VkPhysicalDevice): PipelineCacheIdentity =
+            MemoryStack.stackPush().use { stack ->
+                val properties = VkPhysicalDeviceProperties.malloc(stack)
+                vkGetPhysicalDeviceProperties(physicalDevice, properties)
+                val uuid = ByteArray(VK_UUID_SIZE)
+                properties.pipelineCacheUUID().get(uuid)
+                PipelineCacheIdentity(
+                    vendorId = properties.vendorID(),
+                    deviceId = properties.deviceID(),
+                    driverVersion = properties.driverVersion(),
+                    cacheUuid = uuid
+                )
+            }
+    }
+}
+
+/**
+ * Owns one VkPipelineCache and, when [file] is set, its on-disk copy.
+ *
+ * The cache handle can be passed to `vkCreateGraphicsPipelines` from any thread;
+ * VkPipelineCache objects are internally synchronized.
+ */
+internal class VulkanPipelineCache private constructor(
+    private val device: VkDevice,
+    val handle: Long,
+    private val file: File?
+) {
+    /**
+     * Write the current cache contents to disk, replacing the previous file atomically.
+     * I/O failures are logged and otherwise ignored; the cache is only an optimization.
+     */
+    fun save() {
+        val target = file ?: return
+        if (handle == VK_NULL_HANDLE) return
+        val data = readData() ?: return
+
+        try {
+            target.parentFile?.mkdirs()
+            val temp = File(target.parentFile, "${target.name}.tmp")
+            temp.writeBytes(data)
+            Files.move(
+                temp.toPath(),
+                target.toPath(),
+                StandardCopyOption.REPLACE_EXISTING,
+                StandardCopyOption.ATOMIC_MOVE
+            )
+        } catch (e: IOException) {
+            println("[VulkanPipelineCache] Failed to save ${target.path}: ${e.message}")
+        }
+    }
+
+    /**
+     * Save and destroy the cache. Pipelines created from it stay valid.
+     */
+    fun dispose() {
+        save()
+        if (handle != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(device, handle, null)
+        }
+    }
+
+    private fun readData(): ByteArray? = MemoryStack.stackPush().use { stack ->
+        val pSize = stack.mallocPointer(1)
+        if (vkGetPipelineCacheData(device, handle, pSize, null) != VK_SUCCESS) return null
+        val size = pSize.get(0).toInt()
+        if (size <= 0) return null
+
+        // Cache blobs can be megabytes, far beyond the MemoryStack size
+        val buffer = MemoryUtil.memAlloc(size)
+        try {
+            if (vkGetPipelineCacheData(device, handle, pSize, buffer) != VK_SUCCESS) return null
+            ByteArray(pSize.get(0).toInt()).also { buffer.get(it) }
+        } finally {
+            MemoryUtil.memFree(buffer)
+        }
+    }
+
+    companion object {
+        /**
+         * Create a pipeline cache, seeded from [directory] when it holds a blob written
+         * by the same device and driver. A missing, foreign or corrupt blob starts an
+         * empty cache instead.
+         *
+         * @param directory Where the cache is persisted, or null to keep it in memory only
+         */
+        fun create(
+            device: VkDevice,
+            physicalDevice: VkPhysicalDevice,
+            directory: File?
+        ): VulkanPipelineCache {
+            val identity = PipelineCacheIdentity.of(physicalDevice)
+            val file = directory?.let { File(it, identity.fileName()) }
+
+            val initialData = file?.takeIf { it.isFile }?.let { existing ->
+                try {
+                    existing.readBytes().takeIf(identity::accepts)
+                } catch (_: IOException) {
+                    null
+                }
+            }
+
+            if (initialData != null) {
+                val seeded = createHandle(device, initialData)
+                if (seeded != null) {
+                    println("[VulkanPipelineCache] Loaded ${initialData.size} bytes from ${file?.path}")
+                    return VulkanPipelineCache(device, seeded, file)
+                }
+            }
+            return VulkanPipelineCache(device, createHandle(device, null) ?: VK_NULL_HANDLE, file)
+        }
+
+        private fun createHandle(device: VkDevice, initialData: ByteArray?): Long? {
+            val data = initialData?.let { bytes -> MemoryUtil.memAlloc(bytes.size).put(bytes).flip() }
+            try {
+                return MemoryStack.stackPush().use { stack ->
+                    val createInfo = VkPipelineCacheCreateInfo.calloc(stack)
+                        .sType(VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO)
+                        .pInitialData(data)
+                    val pCache = stack.mallocLong(1)
+                    if (vkCreatePipelineCache(device, createInfo, null, pCache) == VK_SUCCESS) {
+                        pCache.get(0)
+                    } else {
+                        null
+                    }
+                }
+            } finally {
+                data?.let(MemoryUtil::memFree)
+            }
+        }
+    }
+}
@@ -10,14 +10,22 @@ package io.materia.renderer.vulkan
 
 import io.materia.camera.Camera
 import io.materia.core.math.Matrix4
+import io.materia.core.platform.Platform
 import io.materia.core.scene.Background
 import io.materia.core.scene.Material
 import io.materia.core.scene.Mesh
 import io.materia.core.scene.Scene
+import io.materia.core.scene.SkinnedMesh
+import io.materia.geometry.BufferAttribute
+import io.materia.geometry.BufferGeometry
 import io.materia.lighting.ibl.IBLConvolutionProfiler
 import io.materia.lighting.ibl.PrefilterMipSelector
 import io.materia.material.MeshBasicMaterial
 import io.materia.material.MeshStandardMaterial
+import io.materia.optimization.ResidencyManager
+import io.materia.profiling.GpuPassSpan
+import io.materia.profiling.MemoryAllocationType
+import io.materia.profiling.PerformanceProfiler
 import io.materia.renderer.BackendType
 import io.materia.renderer.PowerPreference
 import io.materia.renderer.RenderStats
@@ -31,6 +39,8 @@ import io.materia.renderer.feature020.Color
 import io.materia.renderer.feature020.FramebufferHandle
 import io.materia.renderer.feature020.PipelineHandle
 import io.materia.renderer.feature020.SwapchainException
+import io.materia.renderer.geometry.BonePalette
+import io.materia.renderer.geometry.MorphTargetBuffer
 import io.materia.renderer.geometry.GeometryAttribute
 import io.materia.renderer.geometry.GeometryBuilder
 import io.materia.renderer.geometry.GeometryMetadata
@@ -89,6 +99,7 @@ import org.lwjgl.vulkan.VK12.VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
 import org.lwjgl.vulkan.VK12.VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
 import org.lwjgl.vulkan.VK12.VK_DESCRIPTOR_TYPE_SAMPLER
 import org.lwjgl.vulkan.VK12.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+import org.lwjgl.vulkan.VK12.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
 import org.lwjgl.vulkan.VK12.VK_IMAGE_ASPECT_COLOR_BIT
 import org.lwjgl.vulkan.VK12.VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
 import org.lwjgl.vulkan.VK12.VK_IMAGE_LAYOUT_GENERAL
@@ -104,6 +115,7 @@ import org.lwjgl.vulkan.VK12.VK_PIPELINE_BIND_POINT_GRAPHICS
 import org.lwjgl.vulkan.VK12.VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
 import org.lwjgl.vulkan.VK12.VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
 import org.lwjgl.vulkan.VK12.VK_PIPELINE_STAGE_TRANSFER_BIT
+import org.lwjgl.vulkan.VK12.VK_QUERY_RESULT_64_BIT
 import org.lwjgl.vulkan.VK12.VK_QUEUE_FAMILY_IGNORED
 import org.lwjgl.vulkan.VK12.VK_SAMPLE_COUNT_16_BIT
 import org.lwjgl.vulkan.VK12.VK_SAMPLE_COUNT_1_BIT
@@ -166,14 +178,19 @@ import org.lwjgl.vulkan.VK12.vkEnumerateDeviceExtensionProperties
 import org.lwjgl.vulkan.VK12.vkEnumeratePhysicalDevices
 import org.lwjgl.vulkan.VK12.vkFreeMemory
 import org.lwjgl.vulkan.VK12.vkGetBufferMemoryRequirements
+import org.lwjgl.vulkan.VK12.vkGetFenceStatus
 import org.lwjgl.vulkan.VK12.vkGetPhysicalDeviceMemoryProperties
 import org.lwjgl.vulkan.VK12.vkGetPhysicalDeviceProperties
+import org.lwjgl.vulkan.VK12.vkGetPhysicalDeviceQueueFamilyProperties
+import org.lwjgl.vulkan.VK12.vkGetQueryPoolResults
 import org.lwjgl.vulkan.VK12.vkMapMemory
 import org.lwjgl.vulkan.VK12.vkQueueSubmit
 import org.lwjgl.vulkan.VK12.vkQueueWaitIdle
 import org.lwjgl.vulkan.VK12.vkResetCommandBuffer
+import org.lwjgl.vulkan.VK12.vkResetFences
 import org.lwjgl.vulkan.VK12.vkUnmapMemory
 import org.lwjgl.vulkan.VK12.vkUpdateDescriptorSets
+import org.lwjgl.vulkan.VK12.vkWaitForFences
 import org.lwjgl.vulkan.VkApplicationInfo
 import org.lwjgl.vulkan.VkAttachmentDescription
 import org.lwjgl.vulkan.VkAttachmentReference
@@ -209,6 +226,7 @@ import org.lwjgl.vulkan.VkPhysicalDeviceFeatures
 import org.lwjgl.vulkan.VkPhysicalDeviceMemoryProperties
 import org.lwjgl.vulkan.VkPhysicalDeviceProperties
 import org.lwjgl.vulkan.VkQueue
+import org.lwjgl.vulkan.VkQueueFamilyProperties
 import org.lwjgl.vulkan.VkRenderPassCreateInfo
 import org.lwjgl.vulkan.VkSubpassDependency
 import org.lwjgl.vulkan.VkSubpassDescription
@@ -218,6 +236,11 @@ import java.io.File
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
 import java.util.Locale
+import java.util.concurrent.CompletableFuture
+import java.util.concurrent.ConcurrentLinkedQueue
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
 import javax.imageio.ImageIO
 import kotlin.math.min
 import kotlin.system.measureTimeMillis
@@ -248,15 +271,22 @@ class VulkanRenderer(
     private var device: VkDevice? = null
     private var graphicsQueue: VkQueue? = null
     private var commandPool: Long = VK_NULL_HANDLE
-    private var commandBuffer: VkCommandBuffer? = null
     private var renderPass: Long = VK_NULL_HANDLE
     private var queueFamilyIndex: Int = 0
 
     // Feature 020 Managers (T017-T019)
     private var bufferManager: VulkanBufferManager? = null
-    private var renderPassManager: VulkanRenderPassManager? = null
     private var swapchainManager: VulkanSwapchain? = null
 
+    // Frames in flight: each slot owns a command buffer, fence, semaphores and
+    // per-draw uniform storage. frameSerial counts submitted frames.
+    private var frames: List<VulkanFrameContext> = emptyList()
+    private var currentFrameIndex = 0
+    private var frameSerial = 0L
+    private var imageFences: LongArray = LongArray(0)
+    private val deletionQueue = VulkanDeferredDeletionQueue()
+    private var uniformSlotStride: Int = UNIFORM_BUFFER_SIZE
+
     private val pipelineCache =
         object : LinkedHashMap<PipelineCacheKey, VulkanPipeline>(16, 0.75f, true) {
             override fun removeEldestEntry(eldest: MutableMap.MutableEntry<PipelineCacheKey, VulkanPipeline>?): Boolean {
@@ -268,20 +298,49 @@ class VulkanRenderer(
             }
         }
     private var activePipelineKey: PipelineCacheKey? = null
-    private val morphWarningMeshes = mutableSetOf<Int>()
+
+    // Driver pipeline cache (persisted to disk) and shared shader modules
+    private var driverPipelineCache: VulkanPipelineCache? = null
+    private var shaderModules: VulkanShaderModuleCache? = null
+
+    // Pipelines compiled by prewarmPipelines(), adopted on the render thread. The
+    // generation tags them with the render pass they were built against; it only changes
+    // under prewarmLock, which the worker holds while a pipeline creation uses the render
+    // pass and descriptor set layouts it snapshotted.
+    private val prewarmedPipelines = ConcurrentLinkedQueue<PrewarmedPipeline>()
+    private var prewarmExecutor: ExecutorService? = null
+    private val prewarmLock = Any()
+    @Volatile
+    private var renderPassGeneration = 0
     private var descriptorSetLayout: Long = VK_NULL_HANDLE
     private var descriptorPool: Long = VK_NULL_HANDLE
     private var ownsDescriptorPool: Boolean = false
-    private var descriptorSet: Long = VK_NULL_HANDLE
     private var materialTextureDescriptorSetLayout: Long = VK_NULL_HANDLE
     private var materialTextureDescriptorPool: Long = VK_NULL_HANDLE
     private var materialTextureManager: VulkanMaterialTextureManager? = null
     private var environmentManager: VulkanEnvironmentManager? = null
-    private var uniformBuffer: BufferHandle? = null
     private var swapchainFramebuffers: List<VulkanFramebufferData> = emptyList()
     private var gpuContext: GpuContext? = null
 
     private val meshBuffers: MutableMap<Int, VulkanMeshBuffers> = mutableMapOf()
+
+    /**
+     * Budget for mesh buffers when [RendererConfig.gpuMemoryBudget] is set. Buffers of meshes
+     * that go undrawn are then kept until the budget needs their memory, instead of being
+     * released at the end of the frame.
+     */
+    val residency: ResidencyManager? = config.gpuMemoryBudget?.let {
+        ResidencyManager(it, evictionDelayFrames = config.framesInFlight)
+    }
+
+    // Skin matrices of the frame's skinned draws, copied into the slot's bone buffer
+    private val bonePalette = BonePalette()
+
+    // Morph target deltas of every morphed geometry drawn so far; each slot copies what it lacks
+    private val morphTargets = MorphTargetBuffer()
+    private val morphHeaders = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+    private val morphWeights = FloatArray(MorphTargetBuffer.MAX_ACTIVE_TARGETS)
+
     private var depthStateWarningIssued = false
 
     private val materialTextureBindingLayout: List<MaterialBinding> =
@@ -312,6 +371,12 @@ class VulkanRenderer(
     private var lastIblRoughness = 0f
     private var lastIblHasRealEnvironment = false
 
+    // Nanoseconds per timestamp tick (0 = no timestamps on the graphics queue) and the
+    // mask of valid timestamp bits
+    private var timestampPeriod = 0f
+    private var timestampMask = 0L
+    private var lastGpuFrameTimeNanos = 0L
+
     private data class CaptureRequest(val outputPath: String)
 
     private data class CaptureResources(
@@ -397,14 +462,19 @@ class VulkanRenderer(
             }
             println("T033: Command pool created successfully")
 
-            println("T033: Allocating command buffer...")
-            commandBuffer = allocateCommandBuffer(vkDevice, commandPool)
-            println("T033: Command buffer allocated successfully")
+            println("T033: Allocating ${config.framesInFlight} frame(s) in flight...")
+            queryTimestampSupport(vkPhysicalDevice, queueFamilyIndex)
+            frames = List(config.framesInFlight) { index ->
+                VulkanFrameContext.create(vkDevice, commandPool, index, timestamps = timestampPeriod > 0f)
+            }
+            currentFrameIndex = 0
+            frameSerial = 0L
+            println("T033: Frame command buffers and sync objects allocated successfully")
 
             // Swapchain + render pass
             println("T033: Initializing SwapchainManager...")
             val vulkanSurface = extractVulkanSurface(surface)
-            swapchainManager = VulkanSwapchain(vkDevice, vkPhysicalDevice, vulkanSurface)
+            swapchainManager = VulkanSwapchain(vkDevice, vkPhysicalDevice, vulkanSurface, config.vsync)
             println("T033: SwapchainManager initialized successfully")
 
             println("T033: Creating render pass...")
@@ -424,18 +494,22 @@ class VulkanRenderer(
 
             // Feature 020 managers
             println("T033: Initializing BufferManager...")
-            bufferManager = VulkanBufferManager(vkDevice, vkPhysicalDevice)
+            bufferManager = VulkanBufferManager(vkDevice, vkPhysicalDevice, commandPool, vkQueue)
             println("T033: BufferManager initialized successfully")
 
             println("T033: Initializing RenderPassManager...")
-            renderPassManager = VulkanRenderPassManager(vkDevice, commandBuffer!!, renderPass)
+            frames.forEach { frame ->
+                frame.renderPassManager = VulkanRenderPassManager(vkDevice, frame.commandBuffer, renderPass)
+            }
             println("T033: RenderPassManager initialized successfully")
 
             println("T033: Creating swapchain framebuffers...")
             swapchainFramebuffers = swapchainManager!!.createFramebuffers(renderPass)
+            imageFences = LongArray(swapchainFramebuffers.size) { VK_NULL_HANDLE }
             println("T033: Framebuffers created (${swapchainFramebuffers.size} images)")
 
             println("T033: Creating descriptor resources...")
+            uniformSlotStride = alignUniformStride(vkPhysicalDevice)
             createDescriptorResources()
             println("T033: Descriptor resources ready")
 
@@ -463,6 +537,12 @@ class VulkanRenderer(
             pipelineCache.values.forEach { it.dispose() }
             pipelineCache.clear()
             activePipelineKey = null
+            shaderModules = VulkanShaderModuleCache(vkDevice)
+            driverPipelineCache = VulkanPipelineCache.create(
+                vkDevice,
+                vkPhysicalDevice,
+                pipelineCacheDirectory()
+            )
             println("T033: Pipeline cache reset; pipelines will be created on demand.")
 
             println("T033: Querying device capabilities...")
@@ -499,20 +579,31 @@ class VulkanRenderer(
         }
 
         val swapchain = swapchainManager ?: return
-        if (swapchainFramebuffers.isEmpty() || renderPassManager == null) {
+        val deviceHandle = device ?: return
+        if (frames.isEmpty()) return
+        val frame = frames[currentFrameIndex]
+        if (swapchainFramebuffers.isEmpty() || frame.renderPassManager == null) {
             recreateSwapchainResources()
             return
         }
-        val renderPassMgr = renderPassManager!!
+        val renderPassMgr = frame.renderPassManager!!
+
+        // Block only until this slot's previous submission has retired, then release
+        // resources no in-flight frame can still reference.
+        vkWaitForFences(deviceHandle, frame.inFlightFence, true, Long.MAX_VALUE)
+        collectFrameTimestamps(deviceHandle, frame)
+        collectDeferredDeletions(deviceHandle)
+        adoptPrewarmedPipelines()
+        residency?.beginFrame()
 
-        if (descriptorSetLayout == VK_NULL_HANDLE || descriptorSet == VK_NULL_HANDLE || uniformBuffer == null) {
+        if (descriptorSetLayout == VK_NULL_HANDLE || frame.descriptorSet == VK_NULL_HANDLE || frame.uniformBuffer == null) {
             createDescriptorResources()
-            if (descriptorSetLayout == VK_NULL_HANDLE || descriptorSet == VK_NULL_HANDLE || uniformBuffer == null) {
+            if (descriptorSetLayout == VK_NULL_HANDLE || frame.descriptorSet == VK_NULL_HANDLE || frame.uniformBuffer == null) {
                 return
             }
         }
 
-        scene.updateMatrixWorld(true)
+        scene.updateMatrixWorld()
         camera.updateMatrixWorld(false)
         camera.updateProjectionMatrix()
 
@@ -594,13 +685,19 @@ class VulkanRenderer(
             }
         }
 
-        val staleIds = meshBuffers.keys - retainedIds
+        val staleIds = if (residency == null) meshBuffers.keys - retainedIds else emptySet()
         staleIds.forEach { id ->
             val buffers = meshBuffers.remove(id)
             if (buffers != null) {
                 destroyMeshBuffers(buffers)
             }
         }
+
+        if (drawInfos.size > frame.uniformSlotCapacity) {
+            growFrameUniforms(deviceHandle, frame, drawInfos.size)
+        }
+        uploadBonePalette(deviceHandle, frame, drawInfos)
+        uploadMorphTargets(deviceHandle, frame, drawInfos)
         
         val clearColor = determineClearColor(scene)
         
@@ -631,9 +728,18 @@ class VulkanRenderer(
                 return@measureTimeMillis
             }
 
+            // More swapchain images than frame slots: the acquired image may still be
+            // targeted by an older slot's submission.
+            val imageFence = imageFences[image.index]
+            if (imageFence != VK_NULL_HANDLE && imageFence != frame.inFlightFence) {
+                vkWaitForFences(deviceHandle, imageFence, true, Long.MAX_VALUE)
+            }
+            imageFences[image.index] = frame.inFlightFence
+
             MemoryStack.stackPush().use { stack ->
-                val command = commandBuffer ?: return@measureTimeMillis
+                val command = frame.commandBuffer
                 val queue = graphicsQueue ?: return@measureTimeMillis
+                val uniformMapping = frame.uniformMapping ?: return@measureTimeMillis
 
                 vkResetCommandBuffer(command, 0)
 
@@ -646,8 +752,11 @@ class VulkanRenderer(
                     throw RuntimeException("Failed to begin command buffer: VkResult=$beginResult")
                 }
 
+                frame.resetTimedPasses(command)
+
                 val framebufferHandle = FramebufferHandle(swapchainFramebuffers[image.index])
                 
+                val scenePass = frame.beginTimedPass(command, "vulkan.scene", "render")
                 renderPassMgr.beginRenderPass(clearColor, framebufferHandle)
                 
                 // Set dynamic viewport and scissor to match swapchain extent
@@ -669,9 +778,11 @@ class VulkanRenderer(
                 // Reset pipeline tracking since beginRenderPass resets pipelineBound
                 activePipelineKey = null
 
-                val descriptorHandle = descriptorSet
+                val descriptorHandle = frame.descriptorSet
                 val extent = swapchain.getExtent()
-                val deviceHandle = device ?: return@measureTimeMillis
+                val descriptorSetsBuffer = stack.mallocLong(3)
+                val dynamicOffsets = stack.mallocInt(1)
+                var uniformSlot = 0
 
                 for (drawInfo in drawInfos) {
                     val buffers = drawInfo.buffers
@@ -717,23 +828,16 @@ class VulkanRenderer(
                     )
                     val pipelineForDraw = pipelineCache.getOrPut(pipelineKey) {
                         warnDepthStateIfNeeded(renderState)
-                        val newPipeline = VulkanPipeline(deviceHandle)
                         println("[VulkanRenderer] Creating pipeline with extent=${extent.first}x${extent.second}, cullMode=${renderState.cullMode}, frontFace=${renderState.frontFace}")
-                        if (!newPipeline.createPipeline(
-                                renderPass,
-                                extent.first,
-                                extent.second,
-                                descriptorSetLayouts,
-                                buffers.vertexLayouts,
-                                renderState,
-                                shaderConfig.vertexSource,
-                                shaderConfig.fragmentSource
-                            )
-                        ) {
-                            newPipeline.dispose()
-                            throw RuntimeException("Failed to create Vulkan graphics pipeline for vertex layout/state")
-                        }
-                        newPipeline
+                        createGraphicsPipeline(
+                            deviceHandle,
+                            renderPass,
+                            extent,
+                            descriptorSetLayouts,
+                            buffers.vertexLayouts,
+                            renderState,
+                            shaderConfig
+                        ) ?: throw RuntimeException("Failed to create Vulkan graphics pipeline for vertex layout/state")
                     }
 
                     if (activePipelineKey != pipelineKey) {
@@ -794,14 +898,29 @@ class VulkanRenderer(
                         aoIntensity
                     )
 
-                    val morphInfluenceSource: List<Float>? = drawInfo.mesh.morphTargetInfluences
-                        ?: (drawInfo.mesh.userData["morphTargetInfluences"] as? List<*>)
-                            ?.mapNotNull { (it as? Number)?.toFloat() }
-                    val morphInfluences = FloatArray(MAX_MORPH_TARGETS) { index ->
-                        morphInfluenceSource?.getOrNull(index) ?: 0f
+                    val morphCount = if (buffers.metadata.hasMorphTargets) {
+                        @Suppress("UNCHECKED_CAST")
+                        val influences = drawInfo.mesh.morphTargetInfluences
+                            ?: (drawInfo.mesh.userData["morphTargetInfluences"] as? List<Float>)
+                        morphTargets.selectActive(drawInfo.mesh.geometry, influences, morphHeaders, morphWeights)
+                    } else {
+                        morphHeaders.fill(0f)
+                        morphWeights.fill(0f)
+                        0
                     }
 
+                    val skinnedMesh = drawInfo.mesh as? SkinnedMesh
+                    val firstBone = if (skinnedMesh != null && buffers.metadata.isSkinned) {
+                        bonePalette.offsetOf(skinnedMesh)
+                    } else -1
+                    val boneCount = if (firstBone >= 0) skinnedMesh?.skeleton?.bones?.size ?: 0 else 0
+
+                    val uniformOffset = uniformSlot * uniformSlotStride
+                    uniformSlot++
+
                     updateUniformBuffer(
+                        uniformMapping,
+                        uniformOffset,
                         projectionMatrix,
                         viewMatrix,
                         modelMatrix,
@@ -813,12 +932,15 @@ class VulkanRenderer(
                         lightingUniforms.fogParams,
                         lightingUniforms.mainLightDirection,
                         lightingUniforms.mainLightColor,
-                        morphInfluences
+                        morphWeights,
+                        firstBone.coerceAtLeast(0),
+                        boneCount,
+                        morphHeaders,
+                        morphCount
                     )
 
                     val pipelineLayout = pipelineForDraw.getPipelineLayout()
-                    val descriptorSetsBuffer =
-                        stack.mallocLong(1 + (if (hasMaterialSet) 1 else 0) + (if (hasEnvironmentSet) 1 else 0))
+                    descriptorSetsBuffer.clear()
                     descriptorSetsBuffer.put(0, descriptorHandle)
                     var descriptorIndex = 1
                     if (hasMaterialSet) {
@@ -837,13 +959,14 @@ class VulkanRenderer(
                     }
                     descriptorSetsBuffer.limit(descriptorIndex)
                     descriptorSetsBuffer.position(0)
+                    dynamicOffsets.put(0, uniformOffset)
                     vkCmdBindDescriptorSets(
                         command,
                         VK_PIPELINE_BIND_POINT_GRAPHICS,
                         pipelineLayout,
                         0,
                         descriptorSetsBuffer,
-                        null
+                        dynamicOffsets
                     )
 
                     buffers.vertexBuffers.forEachIndexed { slot, buffer ->
@@ -861,6 +984,7 @@ class VulkanRenderer(
                 }
 
                 renderPassMgr.endRenderPass()
+                frame.endTimedPass(command, scenePass)
 
                 if (captureRequest != null) {
                     val (captureWidth, captureHeight) = swapchain.getExtent()
@@ -876,6 +1000,7 @@ class VulkanRenderer(
                         null
                     }
                     if (resources != null) {
+                        val capturePass = frame.beginTimedPass(command, "vulkan.capture", "transfer")
                         recordImageCopy(
                             command,
                             stack,
@@ -884,6 +1009,7 @@ class VulkanRenderer(
                             captureWidth,
                             captureHeight
                         )
+                        frame.endTimedPass(command, capturePass)
                         captureResources = resources
                     } else {
                         println("[VulkanRenderer] Failed to allocate capture resources; skipping screenshot")
@@ -895,9 +1021,9 @@ class VulkanRenderer(
                     throw RuntimeException("Failed to record command buffer: VkResult=$endResult")
                 }
 
-                val waitSemaphores = stack.longs(swapchain.getImageAvailableSemaphore())
+                val waitSemaphores = stack.longs(frame.imageAvailableSemaphore)
                 val waitStages = stack.ints(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
-                val signalSemaphores = stack.longs(swapchain.getRenderFinishedSemaphore())
+                val signalSemaphores = stack.longs(frame.renderFinishedSemaphore)
                 val commandBuffers = stack.pointers(command.address())
 
                 val submitInfo = org.lwjgl.vulkan.VkSubmitInfo.calloc(stack)
@@ -908,10 +1034,22 @@ class VulkanRenderer(
                     .pCommandBuffers(commandBuffers)
                     .pSignalSemaphores(signalSemaphores)
 
-                val submitResult = vkQueueSubmit(queue, submitInfo, VK_NULL_HANDLE)
+                // Reset only once submission is certain; an early return above must leave
+                // the fence signalled or the next wait on this slot would never return.
+                vkResetFences(deviceHandle, frame.inFlightFence)
+                // Read the clock before submitting: the GPU may start as soon as the call
+                // is made, and the timeline needs a CPU time that precedes the GPU's
+                val submittedAt = Platform.currentTimeNanos()
+                val submitResult = vkQueueSubmit(queue, submitInfo, frame.inFlightFence)
                 if (submitResult != VK_SUCCESS) {
                     throw RuntimeException("Failed to submit draw command buffer: VkResult=$submitResult")
                 }
+                frameSerial++
+                frame.submittedSerial = frameSerial
+                frame.timestampsPending = frame.timedPassNames.isNotEmpty()
+                frame.submittedAtNanos = submittedAt
+                frame.submittedProfilerFrame = PerformanceProfiler.currentFrameNumber()
+                currentFrameIndex = (currentFrameIndex + 1) % frames.size
 
                 captureResources?.let { capture ->
                     vkQueueWaitIdle(queue)
@@ -929,18 +1067,16 @@ class VulkanRenderer(
 
                 val presentResult = vkQueuePresentKHR(queue, presentInfo)
                 if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
-                    vkQueueWaitIdle(queue)
                     recreateSwapchainResources()
                     return@measureTimeMillis
                 } else if (presentResult != VK_SUCCESS) {
                     throw RuntimeException("Failed to present swapchain image: VkResult=$presentResult")
                 }
-
-                vkQueueWaitIdle(queue)
             }
 
             frameCount++
         }
+        residency?.endFrame()
 
         lastIblMipCount = frameIblMipCount
         lastIblRoughness = frameLastRoughness
@@ -964,10 +1100,13 @@ class VulkanRenderer(
 
     private fun recreateSwapchainResources(newWidth: Int? = null, newHeight: Int? = null) {
         val deviceHandle = device ?: return
-        val command = commandBuffer ?: return
         val swapchain = swapchainManager ?: return
+        if (frames.isEmpty()) return
 
         vkDeviceWaitIdle(deviceHandle)
+        deletionQueue.flush()
+        // An acquire that was not followed by a submit leaves its semaphore signalled.
+        frames.forEach { it.recreateSemaphores(deviceHandle) }
 
         materialTextureManager?.dispose()
         materialTextureManager = null
@@ -977,8 +1116,12 @@ class VulkanRenderer(
         pipelineCache.values.forEach { it.dispose() }
         pipelineCache.clear()
         activePipelineKey = null
+        // Waits out a pipeline creation that is using the old render pass; later ones in
+        // the batch see the new generation and stop
+        retirePrewarmSnapshots()
+        drainPrewarmedPipelines()
 
-        renderPassManager = null
+        frames.forEach { it.renderPassManager = null }
         if (renderPass != VK_NULL_HANDLE) {
             vkDestroyRenderPass(deviceHandle, renderPass, null)
             renderPass = VK_NULL_HANDLE
@@ -990,8 +1133,11 @@ class VulkanRenderer(
 
         val imageFormat = swapchain.getImageFormat()
         renderPass = createRenderPass(deviceHandle, imageFormat)
-        renderPassManager = VulkanRenderPassManager(deviceHandle, command, renderPass)
+        frames.forEach { frame ->
+            frame.renderPassManager = VulkanRenderPassManager(deviceHandle, frame.commandBuffer, renderPass)
+        }
         swapchainFramebuffers = swapchain.createFramebuffers(renderPass)
+        imageFences = LongArray(swapchainFramebuffers.size) { VK_NULL_HANDLE }
 
         createDescriptorResources()
         createMaterialTextureResources()
@@ -1019,12 +1165,27 @@ class VulkanRenderer(
 
         if (descriptorSetLayout == VK_NULL_HANDLE) {
             MemoryStack.stackPush().use { stack ->
-                val layoutBinding = VkDescriptorSetLayoutBinding.calloc(1, stack)
+                val layoutBinding = VkDescriptorSetLayoutBinding.calloc(3, stack)
+                layoutBinding[0]
                     .binding(0)
-                    .descriptorType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                    .descriptorType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
                     .descriptorCount(1)
                     .stageFlags(VK_SHADER_STAGE_VERTEX_BIT or VK_SHADER_STAGE_FRAGMENT_BIT)
                     .pImmutableSamplers(null)
+                // Bone palette read by skinned vertex shaders
+                layoutBinding[1]
+                    .binding(1)
+                    .descriptorType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                    .descriptorCount(1)
+                    .stageFlags(VK_SHADER_STAGE_VERTEX_BIT)
+                    .pImmutableSamplers(null)
+                // Sparse morph target deltas read by morphed vertex shaders
+                layoutBinding[2]
+                    .binding(2)
+                    .descriptorType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                    .descriptorCount(1)
+                    .stageFlags(VK_SHADER_STAGE_VERTEX_BIT)
+                    .pImmutableSamplers(null)
 
                 val layoutInfo = VkDescriptorSetLayoutCreateInfo.calloc(stack)
                     .sType(VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO)
@@ -1042,14 +1203,18 @@ class VulkanRenderer(
 
         if (descriptorPool == VK_NULL_HANDLE) {
             MemoryStack.stackPush().use { stack ->
-                val poolSize = VkDescriptorPoolSize.calloc(1, stack)
-                    .type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
-                    .descriptorCount(1)
+                val poolSize = VkDescriptorPoolSize.calloc(2, stack)
+                poolSize[0]
+                    .type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+                    .descriptorCount(frames.size)
+                poolSize[1]
+                    .type(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                    .descriptorCount(frames.size * 2)
 
                 val poolInfo = VkDescriptorPoolCreateInfo.calloc(stack)
                     .sType(VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO)
                     .pPoolSizes(poolSize)
-                    .maxSets(1)
+                    .maxSets(frames.size)
 
                 val pPool = stack.mallocLong(1)
                 val poolResult = vkCreateDescriptorPool(deviceHandle, poolInfo, null, pPool)
@@ -1061,29 +1226,44 @@ class VulkanRenderer(
             }
         }
 
-        if (descriptorSet == VK_NULL_HANDLE) {
-            MemoryStack.stackPush().use { stack ->
-                val allocInfo = VkDescriptorSetAllocateInfo.calloc(stack)
-                    .sType(VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO)
-                    .descriptorPool(descriptorPool)
-                    .pSetLayouts(stack.longs(descriptorSetLayout))
+        for (frame in frames) {
+            if (frame.descriptorSet == VK_NULL_HANDLE) {
+                MemoryStack.stackPush().use { stack ->
+                    val allocInfo = VkDescriptorSetAllocateInfo.calloc(stack)
+                        .sType(VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO)
+                        .descriptorPool(descriptorPool)
+                        .pSetLayouts(stack.longs(descriptorSetLayout))
 
-                val pDescriptorSet = stack.mallocLong(1)
-                val allocResult = vkAllocateDescriptorSets(deviceHandle, allocInfo, pDescriptorSet)
-                if (allocResult != VK_SUCCESS) {
-                    throw RuntimeException("Failed to allocate descriptor set: VkResult=$allocResult")
+                    val pDescriptorSet = stack.mallocLong(1)
+                    val allocResult = vkAllocateDescriptorSets(deviceHandle, allocInfo, pDescriptorSet)
+                    if (allocResult != VK_SUCCESS) {
+                        throw RuntimeException("Failed to allocate descriptor set: VkResult=$allocResult")
+                    }
+                    frame.descriptorSet = pDescriptorSet[0]
                 }
-                descriptorSet = pDescriptorSet[0]
             }
-        }
 
-        uniformBuffer?.let { existing ->
-            bufferMgr.destroyBuffer(existing)
-            uniformBuffer = null
+            if (frame.uniformBuffer == null) {
+                frame.allocateUniforms(bufferMgr, INITIAL_UNIFORM_SLOTS, uniformSlotStride)
+                writeFrameUniformDescriptor(deviceHandle, frame)
+            }
+            if (frame.boneBuffer == null) {
+                frame.allocateBones(bufferMgr, INITIAL_PALETTE_BONES)
+                writeFrameBoneDescriptor(deviceHandle, frame)
+            }
+            if (frame.morphBuffer == null) {
+                frame.allocateMorphTargets(bufferMgr, INITIAL_MORPH_WORDS)
+                writeFrameStorageDescriptor(deviceHandle, frame, frame.morphBuffer, 2)
+            }
         }
+    }
 
-        uniformBuffer = bufferMgr.createUniformBuffer(UNIFORM_BUFFER_SIZE)
-        val bufferData = uniformBuffer?.handle as? VulkanBufferHandleData
+    /**
+     * Point the slot's dynamic uniform descriptor at its current uniform buffer.
+     * Each draw selects its block through a dynamic offset, so the range is one block.
+     */
+    private fun writeFrameUniformDescriptor(deviceHandle: VkDevice, frame: VulkanFrameContext) {
+        val bufferData = frame.uniformBuffer?.handle as? VulkanBufferHandleData
             ?: throw RuntimeException("Failed to obtain uniform buffer handle")
 
         MemoryStack.stackPush().use { stack ->
@@ -1094,43 +1274,219 @@ class VulkanRenderer(
 
             val descriptorWrite = VkWriteDescriptorSet.calloc(1, stack)
                 .sType(VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET)
-                .dstSet(descriptorSet)
+                .dstSet(frame.descriptorSet)
                 .dstBinding(0)
                 .dstArrayElement(0)
-                .descriptorType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                .descriptorType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
                 .descriptorCount(1)  // CRITICAL: Must specify count for LWJGL
                 .pBufferInfo(bufferInfo)
 
             vkUpdateDescriptorSets(deviceHandle, descriptorWrite, null)
         }
+    }
 
-        val identity = Matrix4()
-        updateUniformBuffer(
-            projection = identity,
-            view = identity,
-            model = identity,
-            baseColor = floatArrayOf(1f, 1f, 1f, 1f),
-            pbrParams = floatArrayOf(1f, 0f, 0f, 1f),
-            cameraPosition = floatArrayOf(0f, 0f, 0f, 1f),
-            ambientColor = floatArrayOf(0f, 0f, 0f, 1f),
-            fogColor = floatArrayOf(0f, 0f, 0f, 0f),
-            fogParams = floatArrayOf(0f, 0f, 0f, 0f),
-            mainLightDirection = floatArrayOf(0f, -1f, 0f, 0f),
-            mainLightColor = floatArrayOf(0f, 0f, 0f, 0f),
-            morphInfluences = FloatArray(MAX_MORPH_TARGETS)
-        )
+    /** Point the slot's bone palette descriptor at its current bone buffer. */
+    private fun writeFrameBoneDescriptor(deviceHandle: VkDevice, frame: VulkanFrameContext) {
+        writeFrameStorageDescriptor(deviceHandle, frame, frame.boneBuffer, 1)
     }
 
-    private fun destroyDescriptorResources() {
-        uniformBuffer?.let {
-            try {
-                bufferManager?.destroyBuffer(it)
-            } catch (_: Exception) {
+    /** Point the slot's storage buffer descriptor at [binding] of set 0 at [buffer]. */
+    private fun writeFrameStorageDescriptor(
+        deviceHandle: VkDevice,
+        frame: VulkanFrameContext,
+        buffer: BufferHandle?,
+        binding: Int
+    ) {
+        val bufferData = buffer?.handle as? VulkanBufferHandleData
+        if (buffer == null || bufferData == null) {
+            throw RuntimeException("Failed to obtain storage buffer handle for binding $binding")
+        }
+
+        MemoryStack.stackPush().use { stack ->
+            val bufferInfo = VkDescriptorBufferInfo.calloc(1, stack)
+                .buffer(bufferData.buffer)
+                .offset(0)
+                .range(buffer.size.toLong())
+
+            val descriptorWrite = VkWriteDescriptorSet.calloc(1, stack)
+                .sType(VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET)
+                .dstSet(frame.descriptorSet)
+                .dstBinding(binding)
+                .dstArrayElement(0)
+                .descriptorType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                .descriptorCount(1)
+                .pBufferInfo(bufferInfo)
+
+            vkUpdateDescriptorSets(deviceHandle, descriptorWrite, null)
+        }
+    }
+
+    /**
+     * Pack the skin matrices of this frame's skinned draws into the slot's bone buffer,
+     * growing it first if needed. Like [growFrameUniforms], this runs after the slot's
+     * fence wait, so the buffer is idle.
+     */
+    private fun uploadBonePalette(deviceHandle: VkDevice, frame: VulkanFrameContext, drawInfos: List<MeshDrawInfo>) {
+        bonePalette.reset()
+        for (drawInfo in drawInfos) {
+            val mesh = drawInfo.mesh as? SkinnedMesh ?: continue
+            if (!drawInfo.buffers.metadata.isSkinned) continue
+            mesh.pose()
+            bonePalette.add(mesh)
+        }
+        if (bonePalette.boneCount == 0) return
+
+        if (bonePalette.boneCount > frame.boneCapacity) {
+            val bufferMgr = bufferManager ?: return
+            var capacity = frame.boneCapacity.coerceAtLeast(INITIAL_PALETTE_BONES)
+            while (capacity < bonePalette.boneCount) {
+                capacity *= 2
+            }
+            frame.allocateBones(bufferMgr, capacity)
+            writeFrameBoneDescriptor(deviceHandle, frame)
+        }
+
+        val mapping = frame.boneMapping ?: return
+        mapping.asFloatBuffer().put(bonePalette.data, 0, bonePalette.floatCount)
+    }
+
+    /**
+     * Encode the morph targets of newly seen morphed geometries and copy the words this
+     * slot has not received yet into its morph buffer, growing it first if needed (then
+     * everything is copied). Runs after the slot's fence wait, so the buffer is idle.
+     */
+    private fun uploadMorphTargets(deviceHandle: VkDevice, frame: VulkanFrameContext, drawInfos: List<MeshDrawInfo>) {
+        for (drawInfo in drawInfos) {
+            if (drawInfo.buffers.metadata.hasMorphTargets) {
+                morphTargets.add(drawInfo.mesh.geometry)
+            }
+        }
+        if (frame.morphUploadedWords == morphTargets.wordCount) return
+
+        if (morphTargets.wordCount > frame.morphCapacityWords) {
+            val bufferMgr = bufferManager ?: return
+            var capacity = frame.morphCapacityWords.coerceAtLeast(INITIAL_MORPH_WORDS)
+            while (capacity < morphTargets.wordCount) {
+                capacity *= 2
+            }
+            frame.allocateMorphTargets(bufferMgr, capacity)
+            writeFrameStorageDescriptor(deviceHandle, frame, frame.morphBuffer, 2)
+        }
+
+        val mapping = frame.morphMapping ?: return
+        val from = frame.morphUploadedWords
+        val words = mapping.asIntBuffer()
+        words.position(from)
+        words.put(morphTargets.data, from, morphTargets.wordCount - from)
+        frame.morphUploadedWords = morphTargets.wordCount
+    }
+
+    /**
+     * Grow the slot's uniform storage to hold at least [drawCount] draws.
+     * Only the slot's own submission could reference the old buffer, and its fence
+     * has already been waited on, so the old buffer is released immediately.
+     */
+    private fun growFrameUniforms(deviceHandle: VkDevice, frame: VulkanFrameContext, drawCount: Int) {
+        val bufferMgr = bufferManager ?: return
+        var capacity = frame.uniformSlotCapacity.coerceAtLeast(INITIAL_UNIFORM_SLOTS)
+        while (capacity < drawCount) {
+            capacity *= 2
+        }
+        frame.allocateUniforms(bufferMgr, capacity, uniformSlotStride)
+        writeFrameUniformDescriptor(deviceHandle, frame)
+    }
+
+    private fun queryTimestampSupport(physicalDevice: VkPhysicalDevice, queueFamily: Int) {
+        MemoryStack.stackPush().use { stack ->
+            val properties = VkPhysicalDeviceProperties.malloc(stack)
+            vkGetPhysicalDeviceProperties(physicalDevice, properties)
+            val pCount = stack.mallocInt(1)
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, pCount, null)
+            val families = VkQueueFamilyProperties.malloc(pCount.get(0), stack)
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, pCount, families)
+
+            val validBits = if (queueFamily < families.capacity()) families.get(queueFamily).timestampValidBits() else 0
+            val period = properties.limits().timestampPeriod()
+            if (validBits == 0 || period <= 0f) {
+                timestampPeriod = 0f
+                timestampMask = 0L
+            } else {
+                timestampPeriod = period
+                timestampMask = if (validBits >= 64) -1L else (1L shl validBits) - 1
             }
         }
-        uniformBuffer = null
+    }
+
+    /**
+     * Read the pass timings of the slot's previous submission. Called after waiting on its
+     * fence, so the results are available without stalling.
+     */
+    private fun collectFrameTimestamps(deviceHandle: VkDevice, frame: VulkanFrameContext) {
+        if (!frame.timestampsPending) return
+        frame.timestampsPending = false
+        val passCount = frame.timedPassNames.size
+        MemoryStack.stackPush().use { stack ->
+            val results = stack.mallocLong(passCount * 2)
+            val result = vkGetQueryPoolResults(
+                deviceHandle,
+                frame.timestampQueryPool,
+                0,
+                passCount * 2,
+                results,
+                Long.SIZE_BYTES.toLong(),
+                VK_QUERY_RESULT_64_BIT
+            )
+            if (result != VK_SUCCESS) return
+
+            val spans = ArrayList<GpuPassSpan>(passCount)
+            for (pass in 0 until passCount) {
+                val begin = ((results.get(pass * 2) and timestampMask) * timestampPeriod.toDouble()).toLong()
+                val end = ((results.get(pass * 2 + 1) and timestampMask) * timestampPeriod.toDouble()).toLong()
+                // A counter that wrapped mid-pass has no usable duration
+                if (end < begin) return
+                spans += GpuPassSpan(frame.timedPassNames[pass], frame.timedPassCategories[pass], begin, end)
+            }
+            lastGpuFrameTimeNanos = spans.maxOf { it.endNanos } - spans.minOf { it.beginNanos }
+            PerformanceProfiler.recordGpuFrame(frame.submittedProfilerFrame, frame.submittedAtNanos, spans)
+        }
+    }
 
+    private fun alignUniformStride(physicalDevice: VkPhysicalDevice): Int {
+        val alignment = MemoryStack.stackPush().use { stack ->
+            val properties = VkPhysicalDeviceProperties.malloc(stack)
+            vkGetPhysicalDeviceProperties(physicalDevice, properties)
+            properties.limits().minUniformBufferOffsetAlignment().toInt().coerceAtLeast(1)
+        }
+        return ((UNIFORM_BUFFER_SIZE + alignment - 1) / alignment) * alignment
+    }
+
+    /**
+     * Run deferred releases for every frame the GPU has finished.
+     *
+     * A frame is complete once its slot fence has signalled; the completed serial is
+     * the newest serial below the oldest still-pending slot submission.
+     */
+    private fun collectDeferredDeletions(deviceHandle: VkDevice) {
+        if (deletionQueue.isEmpty()) return
+        var completedSerial = frameSerial
+        for (frame in frames) {
+            if (frame.submittedSerial == 0L) continue
+            if (vkGetFenceStatus(deviceHandle, frame.inFlightFence) != VK_SUCCESS) {
+                completedSerial = min(completedSerial, frame.submittedSerial - 1)
+            }
+        }
+        deletionQueue.collect(completedSerial)
+    }
+
+    private fun destroyDescriptorResources() {
         device?.let { deviceHandle ->
+            frames.forEach { frame ->
+                frame.releaseUniforms(bufferManager)
+                frame.releaseBones(bufferManager)
+                frame.releaseMorphTargets(bufferManager)
+                frame.descriptorSet = VK_NULL_HANDLE
+            }
+
             // Only destroy descriptor pool if we created it (not from gpuContext)
             if (descriptorPool != VK_NULL_HANDLE && ownsDescriptorPool) {
                 vkDestroyDescriptorPool(deviceHandle, descriptorPool, null)
@@ -1143,8 +1499,6 @@ class VulkanRenderer(
                 descriptorSetLayout = VK_NULL_HANDLE
             }
         }
-
-        descriptorSet = VK_NULL_HANDLE
     }
 
     private fun createMaterialTextureResources() {
@@ -1222,16 +1576,16 @@ class VulkanRenderer(
         val indexNeedsUpdate = geometry.index?.needsUpdate == true
         val existing = meshBuffers[mesh.id]
         if (!attributesNeedUpdate && !indexNeedsUpdate && existing != null) {
+            residency?.touch(mesh)
             return existing
         }
 
-        // When updating mesh buffers, remove old entry and destroy it.
-        // We rely on vkQueueWaitIdle at end of frame to ensure safety.
+        // When updating mesh buffers, remove the old entry; in-flight frames may still
+        // read it, so destruction goes through the deferred deletion queue.
         val oldBuffers = meshBuffers.remove(mesh.id)
         if (oldBuffers != null) {
              destroyMeshBuffers(oldBuffers)
         }
-        morphWarningMeshes.remove(mesh.id)
 
         val buildOptions = descriptor.buildGeometryOptions(geometry)
         val geometryBuffer = GeometryBuilder.build(geometry, buildOptions)
@@ -1252,10 +1606,6 @@ class VulkanRenderer(
         val instanceCount =
             if (geometryBuffer.instanceCount > 0) geometryBuffer.instanceCount else 1
 
-        if (geometryBuffer.metadata.hasMorphTargets && morphWarningMeshes.add(mesh.id)) {
-            println("Warning: VulkanRenderer detected morph targets on mesh ${mesh.name}; falling back to base geometry")
-        }
-
         geometry.attributes.values.forEach { it.needsUpdate = false }
         geometry.index?.needsUpdate = false
 
@@ -1269,6 +1619,12 @@ class VulkanRenderer(
             instanceCount = instanceCount
         )
         meshBuffers[mesh.id] = buffers
+        val meshId = mesh.id
+        residency?.register(
+            mesh,
+            MemoryAllocationType.GEOMETRY,
+            vertexBuffers.sumOf { it.size.toLong() } + indexBuffer.size
+        ) { meshBuffers.remove(meshId)?.let(::destroyMeshBuffers) }
         return buffers
     }
 
@@ -1291,7 +1647,14 @@ class VulkanRenderer(
         )
     )
 
+    /**
+     * Schedule [buffers] for destruction once every frame submitted so far has retired.
+     */
     private fun destroyMeshBuffers(buffers: VulkanMeshBuffers) {
+        deletionQueue.enqueue(frameSerial) { releaseMeshBuffers(buffers) }
+    }
+
+    private fun releaseMeshBuffers(buffers: VulkanMeshBuffers) {
         buffers.vertexBuffers.forEach { buffer ->
             try {
                 bufferManager?.destroyBuffer(buffer)
@@ -1307,7 +1670,15 @@ class VulkanRenderer(
         }
     }
 
+    /**
+     * Write one draw's uniform block into the persistently mapped frame buffer.
+     *
+     * @param target Mapped frame uniform buffer
+     * @param offset Byte offset of the draw's slot (a multiple of the aligned stride)
+     */
     private fun updateUniformBuffer(
+        target: ByteBuffer,
+        offset: Int,
         projection: Matrix4,
         view: Matrix4,
         model: Matrix4,
@@ -1319,12 +1690,13 @@ class VulkanRenderer(
         fogParams: FloatArray,
         mainLightDirection: FloatArray,
         mainLightColor: FloatArray,
-        morphInfluences: FloatArray
+        morphWeights: FloatArray,
+        firstBone: Int,
+        boneCount: Int,
+        morphHeaders: FloatArray,
+        morphCount: Int
     ) {
-        val bufferMgr = bufferManager ?: return
-        val buffer = uniformBuffer ?: return
-        val bytes = ByteArray(UNIFORM_BUFFER_SIZE)
-        val byteBuffer = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN)
+        var cursor = offset
 
         fun putMatrix(matrix: Matrix4) {
             val elements = matrix.elements
@@ -1338,16 +1710,26 @@ class VulkanRenderer(
                 } else {
                     elements[i]
                 }
-                byteBuffer.putFloat(value)
+                target.putFloat(cursor, value)
+                cursor += Float.SIZE_BYTES
             }
         }
 
         fun putVec4(array: FloatArray) {
             for (i in 0 until 4) {
-                byteBuffer.putFloat(array.getOrElse(i) { if (i == 3) 1f else 0f })
+                target.putFloat(cursor, array.getOrElse(i) { if (i == 3) 1f else 0f })
+                cursor += Float.SIZE_BYTES
             }
         }
 
+        fun putVec4(x: Float, y: Float) {
+            target.putFloat(cursor, x)
+            target.putFloat(cursor + Float.SIZE_BYTES, y)
+            target.putFloat(cursor + 2 * Float.SIZE_BYTES, 0f)
+            target.putFloat(cursor + 3 * Float.SIZE_BYTES, 0f)
+            cursor += 4 * Float.SIZE_BYTES
+        }
+
         putMatrix(projection)
         putMatrix(view)
         putMatrix(model)
@@ -1359,11 +1741,16 @@ class VulkanRenderer(
         putVec4(fogParams)
         putVec4(mainLightDirection)
         putVec4(mainLightColor)
-        for (i in 0 until MAX_MORPH_TARGETS) {
-            byteBuffer.putFloat(morphInfluences.getOrElse(i) { 0f })
+        for (i in 0 until MorphTargetBuffer.MAX_ACTIVE_TARGETS) {
+            target.putFloat(cursor, morphWeights.getOrElse(i) { 0f })
+            cursor += Float.SIZE_BYTES
         }
-
-        bufferMgr.updateUniformBuffer(buffer, bytes)
+        putVec4(firstBone.toFloat(), boneCount.toFloat())
+        for (i in 0 until MorphTargetBuffer.MAX_ACTIVE_TARGETS) {
+            target.putFloat(cursor, morphHeaders.getOrElse(i) { 0f })
+            cursor += Float.SIZE_BYTES
+        }
+        putVec4(morphCount.toFloat(), 0f)
     }
 
     private data class VulkanMeshBuffers(
@@ -1376,6 +1763,12 @@ class VulkanRenderer(
         val instanceCount: Int
     )
 
+    private class PrewarmedPipeline(
+        val key: PipelineCacheKey,
+        val pipeline: VulkanPipeline,
+        val renderPassGeneration: Int
+    )
+
     private data class MeshDrawInfo(
         val mesh: Mesh,
         val resolved: ResolvedMaterialDescriptor,
@@ -1389,8 +1782,12 @@ class VulkanRenderer(
         private const val COLOR_COMPONENTS = 3
         private val UNIFORM_BUFFER_SIZE = MaterialDescriptorRegistry.uniformBlockSizeBytes()
         private const val MAX_PIPELINE_CACHE_SIZE = 1024 // Increased to avoid eviction crashes
+        private const val PREWARM_SHUTDOWN_TIMEOUT_SECONDS = 5L
+        private const val PIPELINE_CACHE_DIRECTORY_NAME = "vulkan-pipeline-cache"
         private const val MAX_MATERIAL_TEXTURE_SETS = 256
-        private const val MAX_MORPH_TARGETS = 8
+        private const val INITIAL_UNIFORM_SLOTS = 256
+        private const val INITIAL_PALETTE_BONES = 256
+        private const val INITIAL_MORPH_WORDS = 1024
     }
 
     private fun determineClearColor(scene: Scene): Color {
@@ -1427,12 +1824,27 @@ class VulkanRenderer(
     override fun dispose() {
         if (!initialized) return
 
+        prewarmExecutor?.let { executor ->
+            executor.shutdownNow()
+            executor.awaitTermination(PREWARM_SHUTDOWN_TIMEOUT_SECONDS, TimeUnit.SECONDS)
+        }
+        prewarmExecutor = null
+        // A worker that outlived the timeout must not start on handles about to be destroyed
+        retirePrewarmSnapshots()
+
         // Wait for device to finish all operations
         device?.let { vkDeviceWaitIdle(it) }
 
         pipelineCache.values.forEach { it.dispose() }
         pipelineCache.clear()
         activePipelineKey = null
+        drainPrewarmedPipelines()
+        synchronized(prewarmLock) {
+            shaderModules?.dispose()
+            shaderModules = null
+            driverPipelineCache?.dispose()
+            driverPipelineCache = null
+        }
 
         materialTextureManager?.dispose()
         materialTextureManager = null
@@ -1453,14 +1865,27 @@ class VulkanRenderer(
         // Note: Skip explicit mesh buffer destruction - it can cause NVIDIA driver crashes.
         // The buffers will be cleaned up when the device is destroyed by the GPU factory.
         meshBuffers.clear()
+        residency?.clear()
+        morphTargets.clear()
         swapchainFramebuffers = emptyList()
+        imageFences = LongArray(0)
+
+        // Device is idle: releases that were waiting on frame fences are safe now.
+        deletionQueue.flush()
 
         destroyDescriptorResources()
 
+        device?.let { deviceHandle ->
+            frames.forEach { it.dispose(deviceHandle, bufferManager) }
+        }
+        frames = emptyList()
+        currentFrameIndex = 0
+        frameSerial = 0L
+
         swapchainManager?.dispose()
         swapchainManager = null
 
-        renderPassManager = null
+        bufferManager?.dispose()
         bufferManager = null
 
         if (renderPass != VK_NULL_HANDLE && device != null) {
@@ -1487,6 +1912,86 @@ class VulkanRenderer(
         initialized = false
     }
 
+    /**
+     * Compile shader modules and pipelines for [descriptors] on a background thread.
+     *
+     * Each descriptor is warmed for a mesh carrying only its required attributes, with
+     * no texture maps and no environment lighting. Other variants still compile on first
+     * draw, but reuse the cached shader stages and the driver pipeline cache. Pipelines
+     * built here are picked up at the start of the next frame; the driver cache is saved
+     * when the batch finishes.
+     *
+     * Call after [initialize], typically while assets load. A swapchain resize discards
+     * pipelines from batches that are still running.
+     *
+     * @return Future completing with the number of pipelines compiled
+     */
+    fun prewarmPipelines(descriptors: Collection<MaterialDescriptor>): CompletableFuture<Int> {
+        check(initialized) { "Renderer not initialized. Call initialize() first." }
+        val deviceHandle = device ?: return CompletableFuture.completedFuture(0)
+        val extent = swapchainManager?.getExtent() ?: return CompletableFuture.completedFuture(0)
+
+        // Snapshot render-thread state; the worker must not touch it
+        val renderPassHandle = renderPass
+        val generation = renderPassGeneration
+        val knownKeys = pipelineCache.keys.toHashSet()
+        val setLayouts = buildList {
+            add(descriptorSetLayout)
+            if (materialTextureDescriptorSetLayout != VK_NULL_HANDLE && materialTextureManager != null) {
+                add(materialTextureDescriptorSetLayout)
+            }
+        }.toLongArray()
+        val batch = descriptors.toList()
+
+        val executor = prewarmExecutor ?: Executors.newSingleThreadExecutor { task ->
+            Thread(task, "materia-vulkan-pipeline-prewarm").apply { isDaemon = true }
+        }.also { prewarmExecutor = it }
+
+        return CompletableFuture.supplyAsync({
+            val geometry = prewarmGeometry()
+            var compiled = 0
+            for (descriptor in batch) {
+                if (Thread.currentThread().isInterrupted) break
+                try {
+                    val built = GeometryBuilder.build(geometry, descriptor.buildGeometryOptions(geometry))
+                    val vertexLayouts = built.streams.map { it.layout }
+                    val shaderConfig = buildShaderProgramConfig(
+                        material = null,
+                        descriptor = descriptor,
+                        metadata = built.metadata,
+                        vertexLayouts = vertexLayouts,
+                        hasEnvironmentBinding = false
+                    )
+                    val key = createPipelineKey(vertexLayouts, descriptor.renderState, shaderConfig.features)
+                    if (!knownKeys.add(key)) continue
+
+                    var stale = false
+                    val pipeline = synchronized(prewarmLock) {
+                        // The snapshotted handles are destroyed once the generation moves on
+                        stale = generation != renderPassGeneration
+                        if (stale) null else createGraphicsPipeline(
+                            deviceHandle,
+                            renderPassHandle,
+                            extent,
+                            setLayouts,
+                            vertexLayouts,
+                            descriptor.renderState,
+                            shaderConfig
+                        )
+                    }
+                    if (stale) break
+                    if (pipeline == null) continue
+                    prewarmedPipelines.add(PrewarmedPipeline(key, pipeline, generation))
+                    compiled++
+                } catch (e: Exception) {
+                    println("[VulkanRenderer] Pipeline pre-warm failed for '${descriptor.key}': ${e.message}")
+                }
+            }
+            synchronized(prewarmLock) { driverPipelineCache?.save() }
+            compiled
+        }, executor)
+    }
+
     fun requestFrameCapture(outputPath: String) {
         pendingCapture = CaptureRequest(outputPath)
     }
@@ -1823,6 +2328,7 @@ class VulkanRenderer(
 
             // Device features
             val deviceFeatures = VkPhysicalDeviceFeatures.calloc(stack)
+            VulkanCompressedFormats.enableSupportedFeatures(physicalDevice, deviceFeatures)
 
             // T019: Enable swapchain extension for presentation
             val extensions = stack.callocPointer(1)
@@ -1862,20 +2368,6 @@ class VulkanRenderer(
         }
     }
 
-    private fun allocateCommandBuffer(device: VkDevice, commandPool: Long): VkCommandBuffer? {
-        return MemoryStack.stackPush().use { stack ->
-            val allocInfo = VkCommandBufferAllocateInfo.calloc(stack)
-                .sType(VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO)
-                .commandPool(commandPool)
-                .level(VK_COMMAND_BUFFER_LEVEL_PRIMARY)
-                .commandBufferCount(1)
-
-            val pCommandBuffer = stack.callocPointer(1)
-            val result = vkAllocateCommandBuffers(device, allocInfo, pCommandBuffer)
-            if (result != VK_SUCCESS) null else VkCommandBuffer(pCommandBuffer.get(0), device)
-        }
-    }
-
     private fun queryCapabilities(physicalDevice: VkPhysicalDevice): RendererCapabilities {
         return MemoryStack.stackPush().use { stack ->
             val properties = VkPhysicalDeviceProperties.calloc(stack)
@@ -1901,6 +2393,7 @@ class VulkanRenderer(
                 depthTextures = true,
                 floatTextures = true,
                 instancedRendering = true,
+                compressedTextureFormats = VulkanCompressedFormats.supportedCapabilities(physicalDevice),
                 extensions = extensionNames
             )
         }
@@ -2045,8 +2538,8 @@ class VulkanRenderer(
         val usesEnvironmentMaps: Boolean,
         val usesInstancing: Boolean,
         val usesSecondaryUv: Boolean,
-        val morphTargetCount: Int,
-        val usesMorphNormals: Boolean
+        val usesMorphTargets: Boolean,
+        val usesSkinning: Boolean
     )
 
     private data class ShaderProgramConfig(
@@ -2215,13 +2708,8 @@ class VulkanRenderer(
         val tangentBinding = metadata.bindingFor(GeometryAttribute.TANGENT)
         val uvBinding = metadata.bindingFor(GeometryAttribute.UV0)
         val uv2Binding = metadata.bindingFor(GeometryAttribute.UV1)
-        val morphPositionBindings = metadata.bindings
-            .filter { it.attribute == GeometryAttribute.MORPH_POSITION }
-            .sortedBy { it.location }
-        val morphNormalBindings = metadata.bindings
-            .filter { it.attribute == GeometryAttribute.MORPH_NORMAL }
-            .sortedBy { it.location }
-        val morphCount = min(features.morphTargetCount, morphPositionBindings.size)
+        val skinIndexBinding = metadata.bindingFor(GeometryAttribute.SKIN_INDEX)
+        val skinWeightBinding = metadata.bindingFor(GeometryAttribute.SKIN_WEIGHT)
 
         val hasNormalAttr = normalBinding != null
         val hasColorAttr = colorBinding != null
@@ -2231,8 +2719,6 @@ class VulkanRenderer(
 
         val declaredLocations = mutableSetOf(positionBinding.location)
         val instanceAttributeNames = mutableListOf<String>()
-        val morphPositionInputs = mutableListOf<String>()
-        val morphNormalInputs = mutableListOf<String>()
 
         fun declareInput(builder: StringBuilder, location: Int, glslType: String, name: String) {
             if (declaredLocations.add(location)) {
@@ -2258,16 +2744,9 @@ class VulkanRenderer(
             if (hasUv2Attr) {
                 declareInput(this, uv2Binding!!.location, "vec2", "inUV2")
             }
-
-            morphPositionBindings.take(morphCount).forEachIndexed { index, binding ->
-                val attrName = "inMorphPosition$index"
-                declareInput(this, binding.location, "vec3", attrName)
-                morphPositionInputs += attrName
-            }
-            morphNormalBindings.take(morphCount).forEachIndexed { index, binding ->
-                val attrName = "inMorphNormal$index"
-                declareInput(this, binding.location, "vec3", attrName)
-                morphNormalInputs += attrName
+            if (features.usesSkinning) {
+                declareInput(this, skinIndexBinding!!.location, "vec4", "inSkinIndex")
+                declareInput(this, skinWeightBinding!!.location, "vec4", "inSkinWeight")
             }
 
             if (features.usesInstancing) {
@@ -2288,16 +2767,17 @@ class VulkanRenderer(
             }
 
             appendLine()
-            appendLine("layout(set = 0, binding = 0) uniform UniformBufferObject {")
-            appendLine("    mat4 uProjection;")
-            appendLine("    mat4 uView;")
-            appendLine("    mat4 uModel;")
-            appendLine("    vec4 uBaseColor;")
-            appendLine("    vec4 uPbrParams;")
-            appendLine("    vec4 uCameraPosition;")
-            appendLine("    vec4 uMorphInfluences0;")
-            appendLine("    vec4 uMorphInfluences1;")
-            appendLine("} ubo;")
+            appendUniformBlock(this, group = 0, binding = 0)
+            if (features.usesSkinning) {
+                appendLine("layout(std430, set = 0, binding = 1) readonly buffer BonePalette {")
+                appendLine("    mat4 matrices[];")
+                appendLine("} bonePalette;")
+            }
+            if (features.usesMorphTargets) {
+                appendLine("layout(std430, set = 0, binding = 2) readonly buffer MorphTargets {")
+                appendLine("    uint words[];")
+                appendLine("} morphTargets;")
+            }
             appendLine()
 
             appendLine("layout(location = 0) out vec3 vColor;")
@@ -2326,36 +2806,42 @@ class VulkanRenderer(
             } else {
                 appendLine("    mat4 modelMatrix = ubo.uModel;")
             }
+            if (features.usesSkinning) {
+                // Skin in mesh space ahead of the model matrix; morphs below blend in bind pose
+                appendLine("    if (ubo.uSkinning.y > 0.0) {")
+                appendLine("        uint firstBone = uint(ubo.uSkinning.x);")
+                appendLine("        mat4 skinMatrix =")
+                appendLine("            bonePalette.matrices[firstBone + uint(inSkinIndex.x)] * inSkinWeight.x +")
+                appendLine("            bonePalette.matrices[firstBone + uint(inSkinIndex.y)] * inSkinWeight.y +")
+                appendLine("            bonePalette.matrices[firstBone + uint(inSkinIndex.z)] * inSkinWeight.z +")
+                appendLine("            bonePalette.matrices[firstBone + uint(inSkinIndex.w)] * inSkinWeight.w;")
+                appendLine("        modelMatrix = modelMatrix * skinMatrix;")
+                appendLine("    }")
+            }
             appendLine("    vec4 worldPosition;")
             appendLine("    mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));")
-            appendLine(
-                "    vec3 baseNormal = normalize(normalMatrix * ${
-                    if (hasNormalAttr) "inNormal" else "vec3(0.0, 0.0, 1.0)"
-                });"
-            )
-            appendLine("    if (length(baseNormal) < 1e-5) baseNormal = vec3(0.0, 0.0, 1.0);")
             appendLine("    vec3 blendedPosition = inPosition;")
-            appendLine("    vec3 blendedNormal = baseNormal;")
-            if (morphCount > 0) {
-                appendLine("    vec4 morphInfluences0 = ubo.uMorphInfluences0;")
-                appendLine("    vec4 morphInfluences1 = ubo.uMorphInfluences1;")
-                appendLine("    float morphInfluences[$MAX_MORPH_TARGETS];")
-                val component = arrayOf("x", "y", "z", "w")
-                for (i in 0 until MAX_MORPH_TARGETS) {
-                    val source = if (i < 4) "morphInfluences0" else "morphInfluences1"
-                    val comp = component[i % 4]
-                    appendLine("    morphInfluences[$i] = $source.$comp;")
-                }
-                for (index in 0 until morphCount) {
-                    val positionAttr = morphPositionInputs.getOrNull(index) ?: continue
-                    appendLine("    blendedPosition += $positionAttr * morphInfluences[$index];")
-                    val normalAttr = morphNormalInputs.getOrNull(index)
-                    if (normalAttr != null && features.usesMorphNormals) {
-                        appendLine("    blendedNormal += $normalAttr * morphInfluences[$index];")
-                    }
-                }
+            appendLine("    vec3 objectNormal = ${if (hasNormalAttr) "inNormal" else "vec3(0.0, 0.0, 1.0)"};")
+            if (features.usesMorphTargets) {
+                // Only the active targets chosen for this draw; each covers a vertex range
+                appendLine("    uint morphCount = uint(ubo.uMorphParams.x);")
+                appendLine("    for (uint m = 0u; m < morphCount; ++m) {")
+                appendLine("        float weight = m < 4u ? ubo.uMorphInfluences0[m] : ubo.uMorphInfluences1[m - 4u];")
+                appendLine("        uint header = uint(m < 4u ? ubo.uMorphTargets0[m] : ubo.uMorphTargets1[m - 4u]);")
+                appendLine("        uint firstVertex = morphTargets.words[header];")
+                appendLine("        uint vertexIndex = uint(gl_VertexIndex);")
+                appendLine("        if (vertexIndex < firstVertex || vertexIndex >= firstVertex + morphTargets.words[header + 1u]) continue;")
+                appendLine("        bool hasNormals = (morphTargets.words[header + 2u] & ${MorphTargetBuffer.FLAG_NORMALS}u) != 0u;")
+                appendLine("        uint at = header + ${MorphTargetBuffer.HEADER_WORDS}u + (vertexIndex - firstVertex) * (hasNormals ? 4u : 2u);")
+                appendLine("        blendedPosition += vec3(unpackHalf2x16(morphTargets.words[at]), unpackHalf2x16(morphTargets.words[at + 1u]).x) * weight;")
+                appendLine("        if (hasNormals) {")
+                appendLine("            objectNormal += vec3(unpackHalf2x16(morphTargets.words[at + 2u]), unpackHalf2x16(morphTargets.words[at + 3u]).x) * weight;")
+                appendLine("        }")
+                appendLine("    }")
             }
-            appendLine("    vec3 normal = normalize(blendedNormal);")
+            appendLine("    vec3 baseNormal = normalize(normalMatrix * objectNormal);")
+            appendLine("    if (length(baseNormal) < 1e-5) baseNormal = vec3(0.0, 0.0, 1.0);")
+            appendLine("    vec3 normal = baseNormal;")
             if (hasTangentAttr) {
                 appendLine("    vec3 tangent = normalize(normalMatrix * inTangent.xyz);")
                 appendLine("    float handedness = inTangent.w == 0.0 ? 1.0 : inTangent.w;")
@@ -2388,6 +2874,32 @@ class VulkanRenderer(
         }
     }
 
+    /**
+     * The std140 block written by [updateUniformBuffer]; member order must follow the
+     * shared uniform block layout so every field lands at its registry offset.
+     */
+    private fun appendUniformBlock(builder: StringBuilder, group: Int, binding: Int) {
+        builder.appendLine("layout(set = $group, binding = $binding) uniform UniformBufferObject {")
+        builder.appendLine("    mat4 uProjection;")
+        builder.appendLine("    mat4 uView;")
+        builder.appendLine("    mat4 uModel;")
+        builder.appendLine("    vec4 uBaseColor;")
+        builder.appendLine("    vec4 uPbrParams;")
+        builder.appendLine("    vec4 uCameraPosition;")
+        builder.appendLine("    vec4 uAmbientColor;")
+        builder.appendLine("    vec4 uFogColor;")
+        builder.appendLine("    vec4 uFogParams;")
+        builder.appendLine("    vec4 uMainLightDirection;")
+        builder.appendLine("    vec4 uMainLightColor;")
+        builder.appendLine("    vec4 uMorphInfluences0;")
+        builder.appendLine("    vec4 uMorphInfluences1;")
+        builder.appendLine("    vec4 uSkinning;")
+        builder.appendLine("    vec4 uMorphTargets0;")
+        builder.appendLine("    vec4 uMorphTargets1;")
+        builder.appendLine("    vec4 uMorphParams;")
+        builder.appendLine("} ubo;")
+    }
+
     private fun glslTypeForVertex(format: VertexFormat): String = when (format) {
         VertexFormat.FLOAT32 -> "float"
         VertexFormat.FLOAT32X2 -> "vec2"
@@ -2426,16 +2938,7 @@ class VulkanRenderer(
         sb.appendLine("layout(location = 0) out vec4 outColor;")
         sb.appendLine()
         val uniformBlock = descriptor.uniformBlock
-        sb.appendLine("layout(set = ${uniformBlock.group}, binding = ${uniformBlock.binding}) uniform UniformBufferObject {")
-        sb.appendLine("    mat4 uProjection;")
-        sb.appendLine("    mat4 uView;")
-        sb.appendLine("    mat4 uModel;")
-        sb.appendLine("    vec4 uBaseColor;")
-        sb.appendLine("    vec4 uPbrParams;")
-        sb.appendLine("    vec4 uCameraPosition;")
-        sb.appendLine("    vec4 uMorphInfluences0;")
-        sb.appendLine("    vec4 uMorphInfluences1;")
-        sb.appendLine("} ubo;")
+        appendUniformBlock(sb, uniformBlock.group, uniformBlock.binding)
         sb.appendLine()
 
         materialTextureBindingLayout.sortedBy { it.binding }.forEach { binding ->
@@ -2532,8 +3035,88 @@ class VulkanRenderer(
         return sb.toString()
     }
 
+    /**
+     * Build a graphics pipeline for [shaderConfig], sharing shader modules and the
+     * driver pipeline cache. Safe to call from the pre-warm thread.
+     */
+    private fun createGraphicsPipeline(
+        deviceHandle: VkDevice,
+        renderPassHandle: Long,
+        extent: Pair<Int, Int>,
+        descriptorSetLayouts: LongArray,
+        vertexLayouts: List<VertexBufferLayout>,
+        renderState: MaterialRenderState,
+        shaderConfig: ShaderProgramConfig
+    ): VulkanPipeline? {
+        val moduleCache = shaderModules ?: return null
+        val modules = moduleCache.modulesFor(shaderConfig.vertexSource, shaderConfig.fragmentSource)
+        val pipeline = VulkanPipeline(deviceHandle)
+        if (!pipeline.createPipeline(
+                renderPassHandle,
+                extent.first,
+                extent.second,
+                descriptorSetLayouts,
+                vertexLayouts,
+                renderState,
+                modules.vertexModule,
+                modules.fragmentModule,
+                driverPipelineCache?.handle ?: VK_NULL_HANDLE
+            )
+        ) {
+            pipeline.dispose()
+            return null
+        }
+        return pipeline
+    }
+
+    /**
+     * Move pipelines finished by the pre-warm thread into [pipelineCache]. Pipelines
+     * built against a render pass that has since been recreated are destroyed.
+     */
+    private fun adoptPrewarmedPipelines() {
+        while (true) {
+            val prewarmed = prewarmedPipelines.poll() ?: return
+            if (prewarmed.renderPassGeneration != renderPassGeneration ||
+                pipelineCache.containsKey(prewarmed.key)
+            ) {
+                prewarmed.pipeline.dispose()
+            } else {
+                pipelineCache[prewarmed.key] = prewarmed.pipeline
+            }
+        }
+    }
+
+    /**
+     * Invalidate the render pass and layouts that running pre-warm batches snapshotted.
+     * Blocks until a pipeline creation already using them has returned.
+     */
+    private fun retirePrewarmSnapshots() {
+        synchronized(prewarmLock) {
+            renderPassGeneration++
+        }
+    }
+
+    private fun drainPrewarmedPipelines() {
+        while (true) {
+            prewarmedPipelines.poll()?.pipeline?.dispose() ?: return
+        }
+    }
+
+    private fun pipelineCacheDirectory(): File? {
+        if (!config.persistPipelineCache) return null
+        config.pipelineCacheDirectory?.let { return File(it) }
+        val home = System.getProperty("user.home") ?: return null
+        return File(File(home, ".materia"), PIPELINE_CACHE_DIRECTORY_NAME)
+    }
+
+    // One triangle with positions only; the geometry builder fills in every other
+    // attribute a descriptor requires, giving the layout a minimal real mesh would get.
+    private fun prewarmGeometry(): BufferGeometry = BufferGeometry().apply {
+        setAttribute("position", BufferAttribute(FloatArray(9), 3))
+    }
+
     private fun buildShaderProgramConfig(
-        material: Material,
+        material: Material?,
         descriptor: MaterialDescriptor,
         metadata: GeometryMetadata,
         vertexLayouts: List<VertexBufferLayout>,
@@ -2585,9 +3168,6 @@ class VulkanRenderer(
         val brdfPair = bindingPair(environmentBindingLookup, MaterialBindingSource.ENVIRONMENT_BRDF)
         val usesEnvironment = hasEnvironmentBinding && prefilterPair != null && brdfPair != null
 
-        val morphTargetCount = min(metadata.morphTargetCount, MAX_MORPH_TARGETS)
-        val usesMorphNormals =
-            metadata.bindings.any { it.attribute == GeometryAttribute.MORPH_NORMAL }
         val usesSecondaryUv = hasUv2
 
         val features = MaterialPipelineFeatures(
@@ -2599,8 +3179,8 @@ class VulkanRenderer(
             usesEnvironmentMaps = usesEnvironment,
             usesInstancing = metadata.isInstanced,
             usesSecondaryUv = usesSecondaryUv,
-            morphTargetCount = morphTargetCount,
-            usesMorphNormals = usesMorphNormals
+            usesMorphTargets = metadata.hasMorphTargets,
+            usesSkinning = metadata.isSkinned
         )
 
         val vertexSource = composeVertexShader(
@@ -2641,6 +3221,8 @@ class VulkanRenderer(
             vertexBytes + indexBytes
         }
 
+        val memoryStats = bufferManager?.memoryStats()
+
         val iblMetrics = IBLConvolutionProfiler.snapshot()
         val iblCpuMs = iblMetrics.prefilterMs + iblMetrics.irradianceMs
         val statsMipCount = if (lastIblHasRealEnvironment) lastIblMipCount else 0
@@ -2656,7 +3238,13 @@ class VulkanRenderer(
             timestamp = currentTime,
             iblCpuMs = iblCpuMs,
             iblPrefilterMipCount = statsMipCount,
-            iblLastRoughness = statsRoughness
+            iblLastRoughness = statsRoughness,
+            gpuFrameTime = lastGpuFrameTimeNanos / 1_000_000.0,
+            gpuMemoryAllocated = memoryStats?.allocatedBytes ?: 0L,
+            gpuMemoryUsed = memoryStats?.usedBytes ?: 0L,
+            gpuMemoryBlocks = memoryStats?.blockCount ?: 0,
+            gpuSubAllocations = memoryStats?.allocationCount ?: 0,
+            gpuMemoryFragmentation = memoryStats?.fragmentation ?: 0f
         )
 
         if (fpsFrameCount >= 60) {
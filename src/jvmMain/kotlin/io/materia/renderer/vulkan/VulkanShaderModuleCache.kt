@@ -0,0 +1,129 @@
+/**
+ * Shader module cache for the Vulkan renderer.
+ *
+ * Many pipelines share a shader stage (the same material on different render
+ * states, or the same vertex stage under different fragment stages), so GLSL is
+ * compiled to SPIR-V and wrapped in a VkShaderModule once per distinct source.
+ */
+
+package io.materia.renderer.vulkan
+
+import org.lwjgl.BufferUtils
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.util.shaderc.Shaderc
+import org.lwjgl.vulkan.VK12.*
+import org.lwjgl.vulkan.VkDevice
+import org.lwjgl.vulkan.VkShaderModuleCreateInfo
+import java.nio.ByteBuffer
+
+/**
+ * Vertex and fragment modules for one shader program. Owned by [VulkanShaderModuleCache].
+ */
+internal class VulkanShaderModules(
+    val vertexModule: Long,
+    val fragmentModule: Long
+)
+
+/**
+ * Thread-safe map from (stage, GLSL source) to VkShaderModule.
+ *
+ * Compilation runs outside the lock so a background pre-warm never stalls the
+ * render thread on another thread's shaderc call; if two threads race on the same
+ * source, the loser's module is destroyed.
+ */
+internal class VulkanShaderModuleCache(
+    private val device: VkDevice
+) {
+    private data class ModuleKey(val kind: Int, val source: String)
+
+    private val lock = Any()
+    private val modules = HashMap<ModuleKey, Long>()
+
+    /** Number of cached shader modules. */
+    val size: Int
+        get() = synchronized(lock) { modules.size }
+
+    /**
+     * Modules for the program composed from [vertexSource] and [fragmentSource],
+     * compiling whichever stage has not been seen before.
+     *
+     * @throws IllegalStateException if a stage fails to compile or the module cannot be created
+     */
+    fun modulesFor(vertexSource: String, fragmentSource: String): VulkanShaderModules =
+        VulkanShaderModules(
+            vertexModule = moduleFor(Shaderc.shaderc_glsl_vertex_shader, vertexSource, "material.vert"),
+            fragmentModule = moduleFor(Shaderc.shaderc_glsl_fragment_shader, fragmentSource, "material.frag")
+        )
+
+    /**
+     * Destroy every module. Pipelines created from them stay valid.
+     */
+    fun dispose() {
+        synchronized(lock) {
+            modules.values.forEach { vkDestroyShaderModule(device, it, null) }
+            modules.clear()
+        }
+    }
+
+    private fun moduleFor(kind: Int, source: String, name: String): Long {
+        val key = ModuleKey(kind, source)
+        synchronized(lock) {
+            modules[key]?.let { return it }
+        }
+
+        val module = createShaderModule(compileShader(source, kind, name))
+        check(module != VK_NULL_HANDLE) { "Failed to create shader module for $name" }
+
+        synchronized(lock) {
+            val existing = modules[key]
+            if (existing != null) {
+                vkDestroyShaderModule(device, module, null)
+                return existing
+            }
+            modules[key] = module
+            return module
+        }
+    }
+
+    private fun compileShader(source: String, kind: Int, name: String): ByteBuffer {
+        val compiler = Shaderc.shaderc_compiler_initialize()
+        val options = Shaderc.shaderc_compile_options_initialize()
+
+        val result = Shaderc.shaderc_compile_into_spv(compiler, source, kind, name, "main", options)
+        val status = Shaderc.shaderc_result_get_compilation_status(result)
+        if (status != Shaderc.shaderc_compilation_status_success) {
+            val error = Shaderc.shaderc_result_get_error_message(result)
+            Shaderc.shaderc_result_release(result)
+            Shaderc.shaderc_compile_options_release(options)
+            Shaderc.shaderc_compiler_release(compiler)
+            throw IllegalStateException("Shader compilation failed for $name: $error")
+        }
+
+        val length = Shaderc.shaderc_result_get_length(result).toInt()
+        val output = BufferUtils.createByteBuffer(length)
+        output.put(Shaderc.shaderc_result_get_bytes(result))
+        output.flip()
+
+        Shaderc.shaderc_result_release(result)
+        Shaderc.shaderc_compile_options_release(options)
+        Shaderc.shaderc_compiler_release(compiler)
+
+        return output
+    }
+
+    private fun createShaderModule(spirvCode: ByteBuffer): Long {
+        return MemoryStack.stackPush().use { stack ->
+            val createInfo = VkShaderModuleCreateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO)
+                .pCode(spirvCode)
+
+            val pShaderModule = stack.mallocLong(1)
+            val result = vkCreateShaderModule(device, createInfo, null, pShaderModule)
+            if (result != VK_SUCCESS) {
+                VK_NULL_HANDLE
+            } else {
+                pShaderModule[0]
+            }
+        }
+    }
+}
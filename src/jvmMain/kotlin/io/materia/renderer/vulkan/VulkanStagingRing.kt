@@ -0,0 +1,281 @@
+/**
+ * Persistent staging ring for uploads into device-local buffers.
+ *
+ * One host-visible buffer is mapped for the lifetime of the renderer. Uploads are
+ * written into the next free span, copied on the graphics queue, and the span is
+ * recycled once its fence signals — no per-upload staging allocations.
+ */
+
+package io.materia.renderer.vulkan
+
+import org.lwjgl.system.MemoryStack
+import org.lwjgl.system.MemoryUtil
+import org.lwjgl.vulkan.*
+import org.lwjgl.vulkan.VK12.*
+import java.nio.ByteBuffer
+
+/**
+ * Span bookkeeping for a ring buffer of [capacity] bytes.
+ *
+ * Spans are reserved at the head and released from the tail in FIFO order, each
+ * carrying a [T] token (the submission that reads the span).
+ */
+internal class StagingRingSpans<T>(val capacity: Long) {
+
+    private class Span<T>(val start: Long, val end: Long, val token: T)
+
+    private val spans = ArrayDeque<Span<T>>()
+    private var head = 0L
+
+    val inFlightCount: Int
+        get() = spans.size
+
+    /**
+     * Reserve [size] bytes aligned to [alignment] for [token].
+     *
+     * @return start offset, or -1 if the ring has no contiguous room until older spans retire
+     */
+    fun reserve(size: Long, alignment: Long, token: T): Long {
+        require(size in 1..capacity) { "span size must be in 1..$capacity, got $size" }
+
+        val tail = spans.firstOrNull()?.start
+        if (tail == null) {
+            head = 0L
+        }
+        val alignedHead = alignUp(head, alignment)
+
+        val start = when {
+            tail == null -> if (alignedHead + size <= capacity) alignedHead else 0L
+            // Not wrapped: free space is [head, capacity) and [0, tail)
+            head > tail -> when {
+                alignedHead + size <= capacity -> alignedHead
+                size <= tail -> 0L
+                else -> -1L
+            }
+            // Wrapped: free space is [head, tail)
+            else -> if (alignedHead + size <= tail) alignedHead else -1L
+        }
+        if (start < 0) return -1L
+
+        spans.addLast(Span(start, start + size, token))
+        head = start + size
+        return start
+    }
+
+    fun oldestToken(): T? = spans.firstOrNull()?.token
+
+    fun releaseOldest(): T = spans.removeFirst().token
+
+    private fun alignUp(value: Long, alignment: Long): Long =
+        (value + alignment - 1) / alignment * alignment
+}
+
+/**
+ * Vulkan staging ring bound to the renderer's graphics queue.
+ *
+ * Each chunk is copied with its own command buffer and fence; a buffer barrier makes
+ * the copy visible to every later submission on the queue, so callers can use the
+ * destination buffer immediately.
+ */
+class VulkanStagingRing(
+    private val device: VkDevice,
+    private val allocator: VulkanMemoryAllocator,
+    private val commandPool: Long,
+    private val queue: VkQueue,
+    val capacity: Long = DEFAULT_CAPACITY
+) {
+    private class Submission(val commandBuffer: VkCommandBuffer, val fence: Long)
+
+    private val spans = StagingRingSpans<Submission>(capacity)
+    private val freeSubmissions = ArrayDeque<Submission>()
+    private val buffer: Long
+    private val allocation: VulkanAllocation
+
+    /** Total bytes uploaded through the ring. */
+    var uploadedBytes: Long = 0L
+        private set
+
+    init {
+        MemoryStack.stackPush().use { stack ->
+            val bufferInfo = VkBufferCreateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO)
+                .size(capacity)
+                .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+                .sharingMode(VK_SHARING_MODE_EXCLUSIVE)
+
+            val pBuffer = stack.mallocLong(1)
+            val result = vkCreateBuffer(device, bufferInfo, null, pBuffer)
+            check(result == VK_SUCCESS) { "Failed to create staging ring buffer: VkResult=$result" }
+            buffer = pBuffer.get(0)
+
+            val memRequirements = VkMemoryRequirements.malloc(stack)
+            vkGetBufferMemoryRequirements(device, buffer, memRequirements)
+            allocation = allocator.allocate(memRequirements, VulkanMemoryPool.STAGING)
+            vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset)
+        }
+    }
+
+    /**
+     * Upload [size] bytes into [dstBuffer] at [dstOffset].
+     *
+     * Large uploads are split into chunks of at most half the ring. [fill] is called
+     * once per chunk with a mapped view of the chunk and the chunk's byte offset into
+     * the source data.
+     *
+     * @param dstAccessMask Access flags of the destination's first consumer
+     * @param dstStageMask Pipeline stage of the destination's first consumer
+     */
+    fun upload(
+        dstBuffer: Long,
+        dstOffset: Long,
+        size: Long,
+        dstAccessMask: Int,
+        dstStageMask: Int,
+        fill: (target: ByteBuffer, sourceOffset: Int) -> Unit
+    ) {
+        val maxChunk = (capacity / 2) / COPY_ALIGNMENT * COPY_ALIGNMENT
+        var copied = 0L
+        while (copied < size) {
+            val chunk = minOf(size - copied, maxChunk)
+            retireCompleted()
+
+            val submission = acquireSubmission()
+            var ringOffset = spans.reserve(chunk, COPY_ALIGNMENT, submission)
+            while (ringOffset < 0) {
+                retireOldest()
+                ringOffset = spans.reserve(chunk, COPY_ALIGNMENT, submission)
+            }
+
+            val target = MemoryUtil.memByteBuffer(allocation.mappedAddress + ringOffset, chunk.toInt())
+            fill(target, copied.toInt())
+
+            submitCopy(submission, ringOffset, dstBuffer, dstOffset + copied, chunk, dstAccessMask, dstStageMask)
+            copied += chunk
+        }
+        uploadedBytes += size
+    }
+
+    /**
+     * Block until every pending copy has completed.
+     */
+    fun waitIdle() {
+        while (spans.inFlightCount > 0) {
+            retireOldest()
+        }
+    }
+
+    fun dispose() {
+        waitIdle()
+        while (freeSubmissions.isNotEmpty()) {
+            val submission = freeSubmissions.removeFirst()
+            vkDestroyFence(device, submission.fence, null)
+            vkFreeCommandBuffers(device, commandPool, submission.commandBuffer)
+        }
+        vkDestroyBuffer(device, buffer, null)
+        allocator.free(allocation)
+    }
+
+    private fun retireCompleted() {
+        while (true) {
+            val oldest = spans.oldestToken() ?: return
+            if (vkGetFenceStatus(device, oldest.fence) != VK_SUCCESS) return
+            freeSubmissions.addLast(spans.releaseOldest())
+        }
+    }
+
+    private fun retireOldest() {
+        val oldest = spans.oldestToken()
+            ?: throw IllegalStateException("Staging ring has no room and no pending copies")
+        vkWaitForFences(device, oldest.fence, true, Long.MAX_VALUE)
+        freeSubmissions.addLast(spans.releaseOldest())
+    }
+
+    private fun acquireSubmission(): Submission {
+        freeSubmissions.removeFirstOrNull()?.let { return it }
+
+        MemoryStack.stackPush().use { stack ->
+            val allocInfo = VkCommandBufferAllocateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO)
+                .commandPool(commandPool)
+                .level(VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+                .commandBufferCount(1)
+
+            val pCommandBuffer = stack.mallocPointer(1)
+            check(vkAllocateCommandBuffers(device, allocInfo, pCommandBuffer) == VK_SUCCESS) {
+                "Failed to allocate staging command buffer"
+            }
+
+            val fenceInfo = VkFenceCreateInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_FENCE_CREATE_INFO)
+            val pFence = stack.mallocLong(1)
+            check(vkCreateFence(device, fenceInfo, null, pFence) == VK_SUCCESS) {
+                "Failed to create staging fence"
+            }
+
+            return Submission(VkCommandBuffer(pCommandBuffer[0], device), pFence[0])
+        }
+    }
+
+    private fun submitCopy(
+        submission: Submission,
+        ringOffset: Long,
+        dstBuffer: Long,
+        dstOffset: Long,
+        size: Long,
+        dstAccessMask: Int,
+        dstStageMask: Int
+    ) {
+        MemoryStack.stackPush().use { stack ->
+            val commandBuffer = submission.commandBuffer
+            vkResetCommandBuffer(commandBuffer, 0)
+
+            val beginInfo = VkCommandBufferBeginInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO)
+                .flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+            check(vkBeginCommandBuffer(commandBuffer, beginInfo) == VK_SUCCESS) {
+                "Failed to begin staging command buffer"
+            }
+
+            val region = VkBufferCopy.calloc(1, stack)
+                .srcOffset(ringOffset)
+                .dstOffset(dstOffset)
+                .size(size)
+            vkCmdCopyBuffer(commandBuffer, buffer, dstBuffer, region)
+
+            val barrier = VkBufferMemoryBarrier.calloc(1, stack)
+                .sType(VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER)
+                .srcAccessMask(VK_ACCESS_TRANSFER_WRITE_BIT)
+                .dstAccessMask(dstAccessMask)
+                .srcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .dstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .buffer(dstBuffer)
+                .offset(dstOffset)
+                .size(size)
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                dstStageMask,
+                0,
+                null,
+                barrier,
+                null
+            )
+
+            check(vkEndCommandBuffer(commandBuffer) == VK_SUCCESS) { "Failed to record staging copy" }
+
+            val submitInfo = VkSubmitInfo.calloc(stack)
+                .sType(VK_STRUCTURE_TYPE_SUBMIT_INFO)
+                .pCommandBuffers(stack.pointers(commandBuffer.address()))
+
+            vkResetFences(device, submission.fence)
+            check(vkQueueSubmit(queue, submitInfo, submission.fence) == VK_SUCCESS) {
+                "Failed to submit staging copy"
+            }
+        }
+    }
+
+    companion object {
+        const val DEFAULT_CAPACITY = 16L * 1024 * 1024
+        private const val COPY_ALIGNMENT = 16L
+    }
+}
@@ -24,11 +24,14 @@ import org.lwjgl.vulkan.VK12.*
  * @property device Vulkan logical device
  * @property physicalDevice Vulkan physical device
  * @property surface Vulkan surface (window)
+ * @property vsync Present on vertical blank; when false, prefer mailbox or immediate
+ *           presentation so frame rate is not capped by the display
  */
 class VulkanSwapchain(
     private val device: VkDevice,
     private val physicalDevice: VkPhysicalDevice,
-    private val surface: Long // VkSurfaceKHR
+    private val surface: Long, // VkSurfaceKHR
+    private val vsync: Boolean = true
 ) : SwapchainManager {
 
     private var swapchain: Long = VK_NULL_HANDLE
@@ -40,9 +43,9 @@ class VulkanSwapchain(
     private var currentImageIndex: Int = -1
     private var imageFormat: Int = VK_FORMAT_B8G8R8A8_UNORM
 
-    // Synchronization primitives - single pair since we use vkQueueWaitIdle
+    // Fallback acquire semaphore for the SwapchainManager contract. The renderer
+    // passes per-frame semaphores to acquireNextImage(signalSemaphore) instead.
     private var imageAvailableSemaphore: Long = VK_NULL_HANDLE
-    private var renderFinishedSemaphore: Long = VK_NULL_HANDLE
 
     init {
         // Create synchronization objects
@@ -80,8 +83,7 @@ class VulkanSwapchain(
                 val surfaceFormat = chooseSurfaceFormat()
                 imageFormat = surfaceFormat.format
 
-                // Choose present mode (FIFO is always available and provides V-Sync)
-                val presentMode = VK_PRESENT_MODE_FIFO_KHR
+                val presentMode = choosePresentMode()
                 val compositeAlpha = chooseCompositeAlpha(capabilities)
 
                 // Create swapchain
@@ -141,6 +143,27 @@ class VulkanSwapchain(
     /**
      * Choose surface format (prefer B8G8R8A8_UNORM with SRGB_NONLINEAR).
      */
+    /**
+     * Choose the present mode. FIFO is always available and provides V-Sync; without
+     * V-Sync, mailbox avoids tearing and immediate is the fallback.
+     */
+    private fun choosePresentMode(): Int {
+        if (vsync) return VK_PRESENT_MODE_FIFO_KHR
+        MemoryStack.stackPush().use { stack ->
+            val pModeCount = stack.mallocInt(1)
+            vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, pModeCount, null)
+            val modes = stack.mallocInt(pModeCount.get(0))
+            vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, pModeCount, modes)
+
+            val available = (0 until pModeCount.get(0)).map { modes.get(it) }
+            return when {
+                VK_PRESENT_MODE_MAILBOX_KHR in available -> VK_PRESENT_MODE_MAILBOX_KHR
+                VK_PRESENT_MODE_IMMEDIATE_KHR in available -> VK_PRESENT_MODE_IMMEDIATE_KHR
+                else -> VK_PRESENT_MODE_FIFO_KHR
+            }
+        }
+    }
+
     private fun chooseSurfaceFormat(): SurfaceFormatData {
         MemoryStack.stackPush().use { stack ->
             val pFormatCount = stack.mallocInt(1)
@@ -184,29 +207,33 @@ class VulkanSwapchain(
 
             val pSemaphore = stack.mallocLong(1)
 
-            // Image available semaphore
-            var result = vkCreateSemaphore(device, semaphoreInfo, null, pSemaphore)
+            val result = vkCreateSemaphore(device, semaphoreInfo, null, pSemaphore)
             if (result != VK_SUCCESS) {
                 throw SwapchainException("Failed to create imageAvailable semaphore: VkResult=$result")
             }
             imageAvailableSemaphore = pSemaphore.get(0)
-
-            // Render finished semaphore
-            result = vkCreateSemaphore(device, semaphoreInfo, null, pSemaphore)
-            if (result != VK_SUCCESS) {
-                throw SwapchainException("Failed to create renderFinished semaphore: VkResult=$result")
-            }
-            renderFinishedSemaphore = pSemaphore.get(0)
         }
     }
 
     /**
      * Acquire next swapchain image for rendering.
      *
+     * Signals the swapchain's own semaphore; renderers with frames in flight should
+     * use [acquireNextImage] with a per-frame semaphore instead.
+     *
      * @return Swapchain image ready for rendering
      * @throws SwapchainException if acquire fails
      */
-    override fun acquireNextImage(): SwapchainImage {
+    override fun acquireNextImage(): SwapchainImage = acquireNextImage(imageAvailableSemaphore)
+
+    /**
+     * Acquire next swapchain image, signalling [signalSemaphore] once it is available.
+     *
+     * @param signalSemaphore VkSemaphore owned by the caller's frame slot
+     * @return Swapchain image ready for rendering
+     * @throws SwapchainException if acquire fails
+     */
+    fun acquireNextImage(signalSemaphore: Long): SwapchainImage {
         if (swapchain == VK_NULL_HANDLE) {
             throw SwapchainException("Swapchain not created")
         }
@@ -218,7 +245,7 @@ class VulkanSwapchain(
                     device,
                     swapchain,
                     Long.MAX_VALUE, // Timeout (infinite)
-                    imageAvailableSemaphore,
+                    signalSemaphore,
                     VK_NULL_HANDLE,
                     pImageIndex
                 )
@@ -301,9 +328,7 @@ class VulkanSwapchain(
 
     fun getImageFormat(): Int = imageFormat
 
-    fun getImageAvailableSemaphore(): Long = imageAvailableSemaphore
-
-    fun getRenderFinishedSemaphore(): Long = renderFinishedSemaphore
+    fun getImageCount(): Int = swapchainImages.size
 
     fun getFramebuffer(index: Int): VulkanFramebufferData {
         if (framebuffers.isEmpty()) {
@@ -379,11 +404,6 @@ class VulkanSwapchain(
             vkDestroySemaphore(device, imageAvailableSemaphore, null)
             imageAvailableSemaphore = VK_NULL_HANDLE
         }
-        
-        if (renderFinishedSemaphore != VK_NULL_HANDLE) {
-            vkDestroySemaphore(device, renderFinishedSemaphore, null)
-            renderFinishedSemaphore = VK_NULL_HANDLE
-        }
     }
 
     private fun createImageViews() {
@@ -0,0 +1,52 @@
+package io.materia.renderer.vulkan
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class BuddySubAllocatorTest {
+
+    @Test
+    fun allocationsAreRoundedAndAligned() {
+        val allocator = BuddySubAllocator(capacity = 4096, minBlockSize = 256)
+
+        val a = allocator.allocate(100)
+        val b = allocator.allocate(300, alignment = 512)
+
+        assertEquals(0L, a % 256)
+        assertEquals(0L, b % 512)
+        assertEquals(256L + 512L, allocator.usedBytes)
+        assertEquals(2, allocator.allocationCount)
+    }
+
+    @Test
+    fun freeingBuddiesCoalescesBackToOneBlock() {
+        val allocator = BuddySubAllocator(capacity = 1024, minBlockSize = 256)
+        val offsets = List(4) { allocator.allocate(256) }
+
+        assertTrue(offsets.all { it >= 0 })
+        assertEquals(-1L, allocator.allocate(256))
+
+        allocator.free(offsets[0])
+        allocator.free(offsets[2])
+        assertEquals(256L, allocator.largestFreeBlock())
+        assertTrue(allocator.fragmentation() > 0f)
+
+        allocator.free(offsets[1])
+        allocator.free(offsets[3])
+        assertTrue(allocator.isEmpty())
+        assertEquals(1024L, allocator.largestFreeBlock())
+        assertEquals(0f, allocator.fragmentation())
+    }
+
+    @Test
+    fun oversizedRequestsFailAndUnknownOffsetsAreRejected() {
+        val allocator = BuddySubAllocator(capacity = 1024, minBlockSize = 256)
+
+        assertEquals(-1L, allocator.allocate(2048))
+        assertFailsWith<IllegalArgumentException> {
+            allocator.free(512)
+        }
+    }
+}
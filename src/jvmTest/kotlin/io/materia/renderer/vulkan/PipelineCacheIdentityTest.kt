@@ -0,0 +1,57 @@
+package io.materia.renderer.vulkan
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNotEquals
+import kotlin.test.assertTrue
+
+class PipelineCacheIdentityTest {
+
+    private val uuid = ByteArray(16) { it.toByte() }
+    private val identity = PipelineCacheIdentity(0x10DE, 0x2204, 0x0220_0000, uuid)
+
+    private fun header(
+        vendorId: Int = identity.vendorId,
+        deviceId: Int = identity.deviceId,
+        cacheUuid: ByteArray = uuid,
+        version: Int = 1,
+        payload: Int = 64
+    ): ByteArray {
+        val buffer = ByteBuffer.allocate(PipelineCacheIdentity.HEADER_SIZE + payload)
+            .order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putInt(PipelineCacheIdentity.HEADER_SIZE)
+        buffer.putInt(version)
+        buffer.putInt(vendorId)
+        buffer.putInt(deviceId)
+        buffer.put(cacheUuid)
+        return buffer.array()
+    }
+
+    @Test
+    fun acceptsBlobFromSameDevice() {
+        assertTrue(identity.accepts(header()))
+    }
+
+    @Test
+    fun rejectsForeignOrTruncatedBlobs() {
+        assertFalse(identity.accepts(header(vendorId = 0x1002)))
+        assertFalse(identity.accepts(header(deviceId = 0x1234)))
+        assertFalse(identity.accepts(header(cacheUuid = ByteArray(16))))
+        assertFalse(identity.accepts(header(version = 2)))
+        assertFalse(identity.accepts(ByteArray(8)))
+    }
+
+    @Test
+    fun fileNameChangesWithDriverVersion() {
+        val upgraded = PipelineCacheIdentity(identity.vendorId, identity.deviceId, 0x0230_0000, uuid)
+
+        assertNotEquals(identity.fileName(), upgraded.fileName())
+        assertEquals(
+            "pipeline-cache-000010de-00002204-02200000-000102030405060708090a0b0c0d0e0f.bin",
+            identity.fileName()
+        )
+    }
+}
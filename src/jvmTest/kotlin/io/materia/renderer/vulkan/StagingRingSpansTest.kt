@@ -0,0 +1,35 @@
+package io.materia.renderer.vulkan
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+class StagingRingSpansTest {
+
+    @Test
+    fun reservationsWrapOnceTheTailRetires() {
+        val ring = StagingRingSpans<Int>(capacity = 1024)
+
+        assertEquals(0L, ring.reserve(400, 16, 1))
+        assertEquals(400L, ring.reserve(400, 16, 2))
+        // 224 bytes left at the head, nothing free before the tail
+        assertEquals(-1L, ring.reserve(300, 16, 3))
+
+        assertEquals(1, ring.releaseOldest())
+        assertEquals(0L, ring.reserve(300, 16, 3))
+        // Wrapped: only [300, 400) is free
+        assertEquals(-1L, ring.reserve(200, 16, 4))
+        assertEquals(304L, ring.reserve(96, 16, 4))
+        assertEquals(3, ring.inFlightCount)
+    }
+
+    @Test
+    fun emptyRingRestartsAtZero() {
+        val ring = StagingRingSpans<String>(capacity = 256)
+
+        ring.reserve(100, 16, "a")
+        ring.releaseOldest()
+
+        assertEquals(0L, ring.reserve(200, 16, "b"))
+        assertEquals("b", ring.oldestToken())
+    }
+}
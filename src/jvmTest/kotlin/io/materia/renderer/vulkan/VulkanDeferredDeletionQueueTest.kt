@@ -0,0 +1,50 @@
+package io.materia.renderer.vulkan
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class VulkanDeferredDeletionQueueTest {
+
+    @Test
+    fun releasesRunOnlyOnceTheirFrameHasRetired() {
+        val queue = VulkanDeferredDeletionQueue()
+        val released = mutableListOf<String>()
+
+        queue.enqueue(1) { released += "a" }
+        queue.enqueue(2) { released += "b" }
+        queue.enqueue(2) { released += "c" }
+
+        assertEquals(0, queue.collect(0))
+        assertEquals(1, queue.collect(1))
+        assertEquals(listOf("a"), released)
+
+        assertEquals(2, queue.collect(3))
+        assertEquals(listOf("a", "b", "c"), released)
+        assertTrue(queue.isEmpty())
+    }
+
+    @Test
+    fun flushReleasesEverythingAndSurvivesFailingReleases() {
+        val queue = VulkanDeferredDeletionQueue()
+        var releasedCount = 0
+
+        queue.enqueue(5) { throw IllegalStateException("boom") }
+        queue.enqueue(7) { releasedCount++ }
+
+        assertEquals(2, queue.flush())
+        assertEquals(1, releasedCount)
+        assertEquals(0, queue.size)
+    }
+
+    @Test
+    fun outOfOrderSerialsAreRejected() {
+        val queue = VulkanDeferredDeletionQueue()
+        queue.enqueue(4) {}
+
+        assertFailsWith<IllegalArgumentException> {
+            queue.enqueue(3) {}
+        }
+    }
+}